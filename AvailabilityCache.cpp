@@ -0,0 +1,124 @@
+#include "AvailabilityCache.h"
+
+
+/**
+ * @brief Construtor da classe AvailabilityCache.
+ */
+AvailabilityCache::AvailabilityCache(std::chrono::milliseconds ttl, size_t max_entries)
+    : ttl(ttl), max_entries(max_entries), entry_count(0) {}
+
+
+/**
+ * @brief Registra que um peer possui chunks de um arquivo.
+ */
+void AvailabilityCache::record(const std::string& file_name, const std::vector<int>& chunk_ids, const std::string& ip, int port, int transfer_speed) {
+    if (chunk_ids.empty() || max_entries == 0) {
+        return;
+    }
+
+    auto now = std::chrono::steady_clock::now();
+    auto peer = std::make_tuple(ip, port);
+
+    std::lock_guard<std::mutex> cache_lock(cache_mutex);
+
+    // Um par arquivo e peer novo pode precisar de espaço
+    auto file_it = entries.find(file_name);
+    if ((file_it == entries.end() || file_it->second.find(peer) == file_it->second.end()) && entry_count >= max_entries) {
+        evictLocked(now);
+    }
+
+    auto [entry_it, inserted] = entries[file_name].try_emplace(peer);
+    if (inserted) {
+        ++entry_count;
+    }
+
+    // Os chunks se acumulam: um peer não perde chunks, e a validade é renovada a cada anúncio
+    Entry& entry = entry_it->second;
+    entry.transfer_speed = transfer_speed;
+    entry.chunks.insert(chunk_ids.begin(), chunk_ids.end());
+    entry.expires_at = now + ttl;
+}
+
+
+/**
+ * @brief Retorna as entradas válidas de um arquivo, descartando as expiradas.
+ */
+std::vector<std::tuple<std::string, int, int, std::vector<int>>> AvailabilityCache::lookup(const std::string& file_name) {
+    std::vector<std::tuple<std::string, int, int, std::vector<int>>> result;
+    auto now = std::chrono::steady_clock::now();
+
+    std::lock_guard<std::mutex> cache_lock(cache_mutex);
+
+    auto file_it = entries.find(file_name);
+    if (file_it == entries.end()) {
+        return result;
+    }
+
+    for (auto it = file_it->second.begin(); it != file_it->second.end();) {
+        if (it->second.expires_at <= now) {
+            it = file_it->second.erase(it);
+            --entry_count;
+            continue;
+        }
+
+        const auto& [ip, port] = it->first;
+        result.emplace_back(ip, port, it->second.transfer_speed, std::vector<int>(it->second.chunks.begin(), it->second.chunks.end()));
+        ++it;
+    }
+
+    if (file_it->second.empty()) {
+        entries.erase(file_it);
+    }
+
+    return result;
+}
+
+
+/**
+ * @brief Retorna o número atual de entradas, incluindo as expiradas ainda não descartadas.
+ */
+size_t AvailabilityCache::size() {
+    std::lock_guard<std::mutex> cache_lock(cache_mutex);
+    return entry_count;
+}
+
+
+/**
+ * @brief Descarta as entradas expiradas e, se ainda necessário, a atualizada há mais tempo.
+ */
+void AvailabilityCache::evictLocked(std::chrono::steady_clock::time_point now) {
+    std::map<std::tuple<std::string, int>, Entry>* oldest_file = nullptr;
+    std::map<std::tuple<std::string, int>, Entry>::iterator oldest;
+
+    for (auto file_it = entries.begin(); file_it != entries.end();) {
+        auto& peers = file_it->second;
+
+        for (auto it = peers.begin(); it != peers.end();) {
+            if (it->second.expires_at <= now) {
+                it = peers.erase(it);
+                --entry_count;
+            } else {
+                // Todas as entradas têm a mesma validade, então a que expira antes é a atualizada há mais tempo
+                if (oldest_file == nullptr || it->second.expires_at < oldest->second.expires_at) {
+                    oldest_file = &peers;
+                    oldest = it;
+                }
+                ++it;
+            }
+        }
+
+        if (peers.empty()) {
+            // Remove o arquivo cujas entradas expiraram todas
+            file_it = entries.erase(file_it);
+        } else {
+            ++file_it;
+        }
+    }
+
+    if (entry_count >= max_entries && oldest_file != nullptr) {
+        oldest_file->erase(oldest);
+        --entry_count;
+
+        // O mapa vazio do arquivo é removido na próxima limpeza ou consulta
+    }
+}
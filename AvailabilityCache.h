@@ -0,0 +1,90 @@
+#ifndef AVAILABILITYCACHE_H
+#define AVAILABILITYCACHE_H
+
+#include <chrono>
+#include <cstddef>
+#include <map>
+#include <mutex>
+#include <set>
+#include <string>
+#include <tuple>
+#include <vector>
+
+
+/**
+ * @brief Classe que guarda, por tempo limitado, os chunks que outros peers anunciaram possuir.
+ *
+ * As informações de localização do FileManager existem apenas durante o download de um arquivo
+ * e são descartadas quando ele é montado. O cache mantém o que foi aprendido (respostas da
+ * descoberta, resumos agregados que passam pelo peer, buscas na DHT e transferências concluídas)
+ * por arquivo e por peer, para que uma nova busca possa reaproveitá-lo em vez de inundar a rede
+ * novamente. Cada entrada expira ttl após a última atualização e o número de entradas é limitado:
+ * quando o cache está cheio, a entrada atualizada há mais tempo é descartada.
+ */
+class AvailabilityCache {
+private:
+    /**
+     * @brief Estrutura com os chunks conhecidos de um peer para um arquivo.
+     */
+    struct Entry {
+        int transfer_speed;                                     ///< Velocidade de transferência em bytes/segundo anunciada pelo peer.
+        std::set<int> chunks;                                   ///< Chunks do arquivo que o peer possui.
+        std::chrono::steady_clock::time_point expires_at;       ///< Instante a partir do qual a entrada deixa de ser usada.
+    };
+
+    const std::chrono::milliseconds ttl;                                                ///< Validade de uma entrada após a última atualização.
+    const size_t max_entries;                                                           ///< Número máximo de entradas (pares arquivo e peer).
+    std::map<std::string, std::map<std::tuple<std::string, int>, Entry>> entries;      ///< Entradas por arquivo e por peer (IP e porta UDP).
+    size_t entry_count;                                                                 ///< Número atual de entradas.
+    std::mutex cache_mutex;                                                             ///< Mutex para proteger as entradas.
+
+public:
+    /**
+     * @brief Construtor da classe AvailabilityCache.
+     *
+     * @param ttl Validade de uma entrada após a última atualização.
+     * @param max_entries Número máximo de entradas (pares arquivo e peer).
+     */
+    AvailabilityCache(std::chrono::milliseconds ttl, size_t max_entries);
+
+
+    /**
+     * @brief Registra que um peer possui chunks de um arquivo.
+     *
+     * Os chunks são somados aos já conhecidos do peer e a validade da entrada é renovada.
+     *
+     * @param file_name Nome do arquivo.
+     * @param chunk_ids Chunks que o peer possui.
+     * @param ip Endereço IP do peer.
+     * @param port Porta UDP do peer.
+     * @param transfer_speed Velocidade de transferência em bytes/segundo do peer.
+     */
+    void record(const std::string& file_name, const std::vector<int>& chunk_ids, const std::string& ip, int port, int transfer_speed);
+
+
+    /**
+     * @brief Retorna as entradas válidas de um arquivo, descartando as expiradas.
+     *
+     * @param file_name Nome do arquivo.
+     * @return Tuplas com o IP, a porta UDP, a velocidade de transferência e os chunks de cada peer.
+     */
+    std::vector<std::tuple<std::string, int, int, std::vector<int>>> lookup(const std::string& file_name);
+
+
+    /**
+     * @brief Retorna o número atual de entradas, incluindo as expiradas ainda não descartadas.
+     *
+     * @return Número de entradas.
+     */
+    size_t size();
+
+private:
+    /**
+     * @brief Descarta as entradas expiradas e, se ainda necessário, a atualizada há mais tempo. Deve ser chamado com cache_mutex travado.
+     *
+     * @param now Instante atual.
+     */
+    void evictLocked(std::chrono::steady_clock::time_point now);
+};
+
+#endif // AVAILABILITYCACHE_H
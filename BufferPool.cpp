@@ -0,0 +1,249 @@
+#include "BufferPool.h"
+#include "CpuTopology.h"
+#include <algorithm>
+#include <new>
+
+
+/**
+ * @brief Construtor de cópia: compartilha o bloco e conta mais uma referência.
+ */
+Buffer::Buffer(const Buffer& other) noexcept : block(other.block) {
+    if (block != nullptr) {
+        block->references.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+
+/**
+ * @brief Construtor de move: assume a referência do outro buffer, que fica vazio.
+ */
+Buffer::Buffer(Buffer&& other) noexcept : block(other.block) {
+    other.block = nullptr;
+}
+
+
+/**
+ * @brief Atribuição por cópia: solta o bloco atual e compartilha o do outro buffer.
+ */
+Buffer& Buffer::operator=(const Buffer& other) noexcept {
+    if (block != other.block) {
+        release();
+        block = other.block;
+        if (block != nullptr) {
+            block->references.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+    return *this;
+}
+
+
+/**
+ * @brief Atribuição por move: solta o bloco atual e assume a referência do outro buffer.
+ */
+Buffer& Buffer::operator=(Buffer&& other) noexcept {
+    if (this != &other) {
+        release();
+        block = other.block;
+        other.block = nullptr;
+    }
+    return *this;
+}
+
+
+/**
+ * @brief Destrutor: solta a referência ao bloco.
+ */
+Buffer::~Buffer() {
+    release();
+}
+
+
+/**
+ * @brief Solta a referência ao bloco, devolvendo-o ao pool se ela for a última.
+ */
+void Buffer::release() noexcept {
+    if (block == nullptr) {
+        return;
+    }
+
+    // acq_rel: as escritas de quem soltou antes ficam visíveis para quem reaproveita o bloco
+    if (block->references.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        block->pool->recycle(block);
+    }
+    block = nullptr;
+}
+
+
+/**
+ * @brief Altera o número de bytes em uso, limitado à capacidade.
+ */
+void Buffer::resize(size_t size) noexcept {
+    if (block != nullptr) {
+        block->size = std::min(size, block->capacity);
+    }
+}
+
+
+/**
+ * @brief Construtor da classe BufferPool. Cria as classes de tamanho vazias de cada nó NUMA.
+ */
+BufferPool::BufferPool() : nodes(CpuTopology::instance().nodeCount()), acquired(0), allocated(0) {
+    for (auto& classes : nodes) {
+        for (int i = 0; i < BUFFER_POOL_CLASS_COUNT; ++i) {
+            classes[i].max_cached_blocks = std::clamp<size_t>(Constants::BUFFER_POOL_MAX_CACHED_BYTES / classCapacity(i), 1,
+                                                              Constants::BUFFER_POOL_MAX_CACHED_BLOCKS);
+        }
+    }
+}
+
+
+/**
+ * @brief Destrutor da classe BufferPool. Libera os buffers guardados.
+ */
+BufferPool::~BufferPool() {
+    trim();
+}
+
+
+/**
+ * @brief Retorna a instância global do pool.
+ */
+BufferPool& BufferPool::instance() {
+    // Nunca é destruída, pois threads destacadas podem devolver buffers até o fim do processo
+    static BufferPool* pool = new BufferPool();
+    return *pool;
+}
+
+
+/**
+ * @brief Obtém um buffer com pelo menos size bytes de capacidade e size bytes em uso.
+ */
+Buffer BufferPool::acquire(size_t size) {
+    acquired.fetch_add(1, std::memory_order_relaxed);
+
+    int size_class = classFor(size);
+    int node = std::min(CpuTopology::currentNode(), static_cast<int>(nodes.size()) - 1);
+    Buffer::Block* block = nullptr;
+
+    // Reaproveita o último buffer devolvido à classe do nó, que tende a estar no cache do processador
+    if (size_class >= 0) {
+        SizeClass& free_list = nodes[node][size_class];
+        std::lock_guard<std::mutex> lock(free_list.mutex);
+        if (!free_list.free_blocks.empty()) {
+            block = free_list.free_blocks.back();
+            free_list.free_blocks.pop_back();
+        }
+    }
+
+    if (block == nullptr) {
+        // O cabeçalho e os bytes ficam em uma única alocação; os buffers grandes são ligados ao nó da thread
+        size_t capacity = size_class >= 0 ? classCapacity(size_class) : size;
+        void* memory = capacity >= Constants::NUMA_BIND_MIN_BYTES ? CpuTopology::allocateOnNode(sizeof(Buffer::Block) + capacity, node) : nullptr;
+        bool mapped = memory != nullptr;
+        if (!mapped) {
+            memory = ::operator new(sizeof(Buffer::Block) + capacity);
+        }
+        block = static_cast<Buffer::Block*>(memory);
+        new (&block->references) std::atomic<int>(0);
+        block->pool = this;
+        block->capacity = capacity;
+        block->size_class = size_class;
+        block->node = node;
+        block->mapped = mapped;
+        allocated.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    block->references.store(1, std::memory_order_relaxed);
+    block->size = size;
+    return Buffer(block);
+}
+
+
+/**
+ * @brief Recebe um bloco cuja última referência foi solta.
+ */
+void BufferPool::recycle(Buffer::Block* block) noexcept {
+    if (block->size_class >= 0) {
+        SizeClass& free_list = nodes[block->node][block->size_class];
+        std::lock_guard<std::mutex> lock(free_list.mutex);
+        if (free_list.free_blocks.size() < free_list.max_cached_blocks) {
+            free_list.free_blocks.push_back(block);
+            return;
+        }
+    }
+
+    // Classe cheia ou buffer maior que a maior classe: a memória volta ao heap
+    freeBlock(block);
+}
+
+
+/**
+ * @brief Libera todos os buffers guardados.
+ */
+void BufferPool::trim() {
+    for (auto& classes : nodes) {
+        for (SizeClass& free_list : classes) {
+            std::vector<Buffer::Block*> blocks;
+            {
+                std::lock_guard<std::mutex> lock(free_list.mutex);
+                blocks.swap(free_list.free_blocks);
+            }
+            for (Buffer::Block* block : blocks) {
+                freeBlock(block);
+            }
+        }
+    }
+}
+
+
+/**
+ * @brief Retorna os contadores do pool.
+ */
+BufferPoolStats BufferPool::stats() {
+    BufferPoolStats result;
+    result.acquired = acquired.load(std::memory_order_relaxed);
+    result.allocated = allocated.load(std::memory_order_relaxed);
+
+    for (auto& classes : nodes) {
+        for (int i = 0; i < BUFFER_POOL_CLASS_COUNT; ++i) {
+            std::lock_guard<std::mutex> lock(classes[i].mutex);
+            result.cached_blocks += classes[i].free_blocks.size();
+            result.cached_bytes += classes[i].free_blocks.size() * classCapacity(i);
+        }
+    }
+    return result;
+}
+
+
+/**
+ * @brief Libera a memória de um bloco.
+ */
+void BufferPool::freeBlock(Buffer::Block* block) noexcept {
+    if (block->mapped) {
+        CpuTopology::freeOnNode(block, sizeof(Buffer::Block) + block->capacity);
+    } else {
+        ::operator delete(block);
+    }
+}
+
+
+/**
+ * @brief Retorna a classe que comporta size bytes (-1 se nenhuma comporta).
+ */
+int BufferPool::classFor(size_t size) {
+    int size_class = 0;
+    for (size_t capacity = Constants::BUFFER_POOL_MIN_CLASS_BYTES; capacity < size; capacity <<= 1) {
+        if (++size_class >= BUFFER_POOL_CLASS_COUNT) {
+            return -1;
+        }
+    }
+    return size_class;
+}
+
+
+/**
+ * @brief Retorna a capacidade dos buffers de uma classe.
+ */
+size_t BufferPool::classCapacity(int size_class) {
+    return Constants::BUFFER_POOL_MIN_CLASS_BYTES << size_class;
+}
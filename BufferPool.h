@@ -0,0 +1,234 @@
+#ifndef BUFFERPOOL_H
+#define BUFFERPOOL_H
+
+#include "Constants.h"
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string_view>
+#include <vector>
+
+class BufferPool;
+
+
+/**
+ * @brief Estrutura com os contadores de um BufferPool.
+ */
+struct BufferPoolStats {
+    uint64_t acquired = 0;                                  ///< Buffers entregues por acquire.
+    uint64_t allocated = 0;                                 ///< Buffers alocados no heap (os demais foram reaproveitados).
+    uint64_t cached_blocks = 0;                             ///< Buffers guardados para reaproveitamento.
+    uint64_t cached_bytes = 0;                              ///< Soma das capacidades dos buffers guardados.
+};
+
+
+/**
+ * @brief Classe que representa um buffer de bytes obtido de um BufferPool.
+ *
+ * O buffer é compartilhado por contagem de referências: cópias do objeto apontam para os mesmos
+ * bytes, e o último objeto destruído devolve o buffer à sua classe no pool. Nas etapas de
+ * recebimento, processamento e gravação, o buffer deve ser passado por move, sem tocar no contador.
+ */
+class Buffer {
+private:
+    friend class BufferPool;
+
+    /**
+     * @brief Cabeçalho alocado junto com os bytes do buffer.
+     */
+    struct Block {
+        std::atomic<int> references;                        ///< Número de objetos Buffer que apontam para o bloco.
+        BufferPool* pool;                                   ///< Pool que recebe o bloco de volta.
+        size_t capacity;                                    ///< Capacidade em bytes.
+        size_t size;                                        ///< Bytes em uso.
+        int size_class;                                     ///< Classe do bloco no pool (-1: maior que a maior classe, liberado no fim).
+        int node;                                           ///< Nó NUMA da thread que alocou o bloco, cuja lista de livres o recebe de volta.
+        bool mapped;                                        ///< Indica que o bloco foi alocado com CpuTopology::allocateOnNode.
+
+        /**
+         * @brief Retorna os bytes do bloco, logo após o cabeçalho.
+         */
+        char* data() { return reinterpret_cast<char*>(this + 1); }
+    };
+
+    Block* block;                                           ///< Bloco referenciado (nulo: buffer vazio).
+
+    /**
+     * @brief Construtor usado pelo BufferPool, que assume a referência já contada no bloco.
+     */
+    explicit Buffer(Block* block) noexcept : block(block) {}
+
+    /**
+     * @brief Solta a referência ao bloco, devolvendo-o ao pool se ela for a última.
+     */
+    void release() noexcept;
+
+public:
+    /**
+     * @brief Construtor de um buffer vazio, sem bloco.
+     */
+    Buffer() noexcept : block(nullptr) {}
+
+    Buffer(const Buffer& other) noexcept;
+    Buffer(Buffer&& other) noexcept;
+    Buffer& operator=(const Buffer& other) noexcept;
+    Buffer& operator=(Buffer&& other) noexcept;
+    ~Buffer();
+
+
+    /**
+     * @brief Retorna os bytes do buffer (nulo se o buffer está vazio).
+     */
+    char* data() noexcept { return block != nullptr ? block->data() : nullptr; }
+    const char* data() const noexcept { return block != nullptr ? block->data() : nullptr; }
+
+
+    /**
+     * @brief Retorna o número de bytes em uso.
+     */
+    size_t size() const noexcept { return block != nullptr ? block->size : 0; }
+
+
+    /**
+     * @brief Retorna a capacidade em bytes.
+     */
+    size_t capacity() const noexcept { return block != nullptr ? block->capacity : 0; }
+
+
+    /**
+     * @brief Indica se o buffer não tem bytes em uso.
+     */
+    bool empty() const noexcept { return size() == 0; }
+
+
+    /**
+     * @brief Altera o número de bytes em uso, limitado à capacidade.
+     *
+     * @param size Novo número de bytes em uso.
+     */
+    void resize(size_t size) noexcept;
+
+
+    /**
+     * @brief Retorna os bytes em uso como texto, sem cópia.
+     */
+    std::string_view view() const noexcept { return std::string_view(data(), size()); }
+};
+
+
+/// Número de classes do BufferPool, uma por potência de dois entre a menor e a maior capacidade.
+constexpr int BUFFER_POOL_CLASS_COUNT = [] {
+    int count = 1;
+    for (size_t capacity = Constants::BUFFER_POOL_MIN_CLASS_BYTES; capacity < Constants::BUFFER_POOL_MAX_CLASS_BYTES; capacity <<= 1) {
+        ++count;
+    }
+    return count;
+}();
+
+
+/**
+ * @brief Classe que reaproveita os buffers de datagramas e de chunks em classes de tamanho.
+ *
+ * Cada classe guarda buffers de uma potência de dois, de Constants::BUFFER_POOL_MIN_CLASS_BYTES
+ * até Constants::BUFFER_POOL_MAX_CLASS_BYTES. Um pedido recebe um buffer da menor classe que o
+ * comporta; os buffers devolvidos ficam guardados na classe, até Constants::BUFFER_POOL_MAX_CACHED_BYTES
+ * bytes e Constants::BUFFER_POOL_MAX_CACHED_BLOCKS buffers, e os excedentes são liberados. Cada
+ * classe tem o seu mutex, então datagramas e chunks não disputam o mesmo bloqueio.
+ *
+ * Em máquinas NUMA, cada nó tem as suas classes: um buffer volta à lista do nó em que foi alocado
+ * e só é reaproveitado por threads desse nó, e os buffers a partir de Constants::NUMA_BIND_MIN_BYTES
+ * são ligados ao nó da thread que os pediu.
+ */
+class BufferPool {
+private:
+    /**
+     * @brief Estrutura com os buffers guardados de uma classe.
+     */
+    struct SizeClass {
+        std::mutex mutex;                                   ///< Mutex para proteger a lista de buffers livres.
+        std::vector<Buffer::Block*> free_blocks;            ///< Buffers devolvidos, reaproveitados do último para o primeiro.
+        size_t max_cached_blocks = 0;                       ///< Número máximo de buffers guardados na classe.
+    };
+
+    std::vector<std::array<SizeClass, BUFFER_POOL_CLASS_COUNT>> nodes; ///< Classes de tamanho de cada nó NUMA, da menor para a maior.
+    std::atomic<uint64_t> acquired;                         ///< Buffers entregues por acquire.
+    std::atomic<uint64_t> allocated;                        ///< Buffers alocados no heap.
+
+    friend class Buffer;
+
+    /**
+     * @brief Recebe um bloco cuja última referência foi solta.
+     *
+     * @param block Bloco devolvido.
+     */
+    void recycle(Buffer::Block* block) noexcept;
+
+    /**
+     * @brief Libera a memória de um bloco.
+     */
+    static void freeBlock(Buffer::Block* block) noexcept;
+
+    /**
+     * @brief Retorna a classe que comporta size bytes (-1 se nenhuma comporta).
+     */
+    static int classFor(size_t size);
+
+    /**
+     * @brief Retorna a capacidade dos buffers de uma classe.
+     */
+    static size_t classCapacity(int size_class);
+
+public:
+    /**
+     * @brief Construtor da classe BufferPool. Cria as classes de tamanho vazias de cada nó NUMA.
+     */
+    BufferPool();
+
+
+    /**
+     * @brief Destrutor da classe BufferPool. Libera os buffers guardados.
+     *
+     * Os buffers ainda em uso não podem sobreviver ao pool.
+     */
+    ~BufferPool();
+
+    BufferPool(const BufferPool&) = delete;
+    BufferPool& operator=(const BufferPool&) = delete;
+
+
+    /**
+     * @brief Retorna a instância global do pool.
+     *
+     * @return Referência ao pool usado pelos servidores e pelo gravador de chunks.
+     */
+    static BufferPool& instance();
+
+
+    /**
+     * @brief Obtém um buffer com pelo menos size bytes de capacidade e size bytes em uso.
+     *
+     * O conteúdo não é inicializado.
+     *
+     * @param size Número de bytes do buffer.
+     * @return Buffer com uma referência.
+     */
+    Buffer acquire(size_t size);
+
+
+    /**
+     * @brief Libera todos os buffers guardados.
+     */
+    void trim();
+
+
+    /**
+     * @brief Retorna os contadores do pool.
+     *
+     * @return Buffers entregues, alocados e guardados.
+     */
+    BufferPoolStats stats();
+};
+
+#endif // BUFFERPOOL_H
@@ -0,0 +1,60 @@
+#include "ChunkPersister.h"
+
+
+/**
+ * @brief Construtor da classe ChunkPersister.
+ */
+ChunkPersister::ChunkPersister(FileManager& file_manager, WorkStealingExecutor& executor, size_t max_pending_bytes)
+    : file_manager(file_manager), executor(executor), max_pending_bytes(max_pending_bytes), pending_bytes(0) {}
+
+
+/**
+ * @brief Grava o chunk mais antigo da fila.
+ */
+void ChunkPersister::persistNext() {
+    // Cada tarefa corresponde a um chunk da fila, então a fila nunca está vazia aqui
+    PendingChunk item;
+    {
+        std::lock_guard<std::mutex> lock(pending_mutex);
+        item = std::move(pending.front());
+        pending.pop_front();
+    }
+
+    // A gravação é feita fora do mutex; a montagem do arquivo, quando é o último chunk, vira outra tarefa no FileManager
+    file_manager.saveChunk(item.file_name, item.chunk, item.data.data(), item.data.size());
+
+    // O espaço só é liberado depois da gravação, para que o limite valha para os bytes ainda em memória;
+    // o buffer volta ao pool antes, para ser reaproveitado pela conexão que espera o espaço
+    size_t written_bytes = item.data.size();
+    item.data = Buffer();
+    {
+        std::lock_guard<std::mutex> lock(pending_mutex);
+        pending_bytes -= written_bytes;
+    }
+    space_cv.notify_all();
+}
+
+
+/**
+ * @brief Coloca um chunk recebido na fila de gravação.
+ */
+void ChunkPersister::submit(const std::string& file_name, int chunk, Buffer&& data) {
+    std::unique_lock<std::mutex> lock(pending_mutex);
+    space_cv.wait(lock, [this] { return pending_bytes == 0 || pending_bytes < max_pending_bytes; });
+
+    pending_bytes += data.size();
+    pending.push_back({file_name, chunk, std::move(data)});
+    lock.unlock();
+
+    // Os chunks são retirados na ordem de chegada, qualquer que seja a ordem de execução das tarefas
+    executor.submit(TaskPriority::TRANSFER, [this] { persistNext(); });
+}
+
+
+/**
+ * @brief Retorna o número de chunks aguardando gravação.
+ */
+size_t ChunkPersister::pendingChunks() {
+    std::lock_guard<std::mutex> lock(pending_mutex);
+    return pending.size();
+}
@@ -0,0 +1,79 @@
+#ifndef CHUNKPERSISTER_H
+#define CHUNKPERSISTER_H
+
+#include "BufferPool.h"
+#include "FileManager.h"
+#include "WorkStealingExecutor.h"
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <string>
+
+
+/**
+ * @brief Classe que grava em disco, em tarefas do executor compartilhado, os chunks recebidos via TCP.
+ *
+ * A thread que lê a conexão entrega o chunk completo e volta imediatamente ao recv do próximo
+ * chunk, em vez de esperar a escrita do arquivo e a montagem do arquivo final. Cada chunk entregue
+ * gera uma tarefa TaskPriority::TRANSFER, que grava o chunk mais antigo da fila. A fila é limitada
+ * em bytes: quando a gravação não acompanha a rede, quem entrega um novo chunk espera o espaço,
+ * o que segura a leitura da conexão e, por consequência, o envio do outro peer.
+ */
+class ChunkPersister {
+private:
+    /**
+     * @brief Estrutura com um chunk recebido aguardando gravação.
+     */
+    struct PendingChunk {
+        std::string file_name;                                  ///< Nome do arquivo.
+        int chunk;                                              ///< Número do chunk.
+        Buffer data;                                            ///< Conteúdo do chunk, devolvido ao pool após a gravação.
+    };
+
+    FileManager& file_manager;                                  ///< Referência ao gerenciador de arquivos, que salva os chunks.
+    WorkStealingExecutor& executor;                             ///< Executor compartilhado do peer, que executa as gravações.
+    const size_t max_pending_bytes;                             ///< Número de bytes na fila a partir do qual submit espera.
+    std::deque<PendingChunk> pending;                           ///< Chunks aguardando gravação, na ordem de chegada.
+    size_t pending_bytes;                                       ///< Soma dos tamanhos dos chunks na fila.
+    std::mutex pending_mutex;                                   ///< Mutex para proteger a fila.
+    std::condition_variable space_cv;                           ///< Acorda quem espera espaço na fila quando um chunk é gravado.
+
+    /**
+     * @brief Grava o chunk mais antigo da fila (uma tarefa por chunk entregue).
+     */
+    void persistNext();
+
+public:
+    /**
+     * @brief Construtor da classe ChunkPersister.
+     *
+     * @param file_manager Referência ao gerenciador de arquivos do peer.
+     * @param executor Referência ao executor compartilhado do peer.
+     * @param max_pending_bytes Número de bytes na fila a partir do qual submit espera (padrão: Constants::PERSIST_MAX_PENDING_BYTES).
+     */
+    ChunkPersister(FileManager& file_manager, WorkStealingExecutor& executor, size_t max_pending_bytes = Constants::PERSIST_MAX_PENDING_BYTES);
+
+
+    /**
+     * @brief Coloca um chunk recebido na fila de gravação.
+     *
+     * Espera enquanto os chunks ainda não gravados somam max_pending_bytes ou mais. Sem nenhum
+     * chunk pendente, o chunk é sempre aceito, mesmo maior que o limite.
+     *
+     * @param file_name Nome do arquivo.
+     * @param chunk Número do chunk.
+     * @param data Conteúdo do chunk, recebido por move do buffer em que a conexão o leu.
+     */
+    void submit(const std::string& file_name, int chunk, Buffer&& data);
+
+
+    /**
+     * @brief Retorna o número de chunks aguardando gravação.
+     *
+     * @return Tamanho da fila.
+     */
+    size_t pendingChunks();
+};
+
+#endif // CHUNKPERSISTER_H
@@ -0,0 +1,124 @@
+#include "ChunkStore.h"
+#include <algorithm>
+#include <cstring>
+
+
+namespace {
+    // Prefixo dos nomes de conteúdo
+    const std::string_view CONTENT_PREFIX = "sha256:";
+}
+
+
+/**
+ * @brief Função de hash dos resumos.
+ */
+size_t ChunkStore::DigestHash::operator()(const Sha256::Digest& digest) const {
+    size_t value;
+    std::memcpy(&value, digest.data(), sizeof(value));
+    return value;
+}
+
+
+/**
+ * @brief Registra um chunk local e deixa de esperá-lo.
+ */
+void ChunkStore::add(const Sha256::Digest& digest, const ChunkLocation& location) {
+    std::lock_guard<std::mutex> store_lock(store_mutex);
+    held.emplace(digest, location);
+
+    auto it = wanted.find(digest);
+    if (it != wanted.end()) {
+        it->second.erase(std::remove(it->second.begin(), it->second.end(), location), it->second.end());
+        if (it->second.empty()) {
+            wanted.erase(it);
+        }
+    }
+}
+
+
+/**
+ * @brief Procura um chunk local com um conteúdo.
+ */
+bool ChunkStore::find(const Sha256::Digest& digest, ChunkLocation& location) {
+    std::lock_guard<std::mutex> store_lock(store_mutex);
+
+    auto it = held.find(digest);
+    if (it == held.end()) {
+        return false;
+    }
+    location = it->second;
+    return true;
+}
+
+
+/**
+ * @brief Registra que um chunk faltante de um download espera um conteúdo.
+ */
+void ChunkStore::want(const Sha256::Digest& digest, const ChunkLocation& location) {
+    std::lock_guard<std::mutex> store_lock(store_mutex);
+
+    std::vector<ChunkLocation>& locations = wanted[digest];
+    if (std::find(locations.begin(), locations.end(), location) == locations.end()) {
+        locations.push_back(location);
+    }
+}
+
+
+/**
+ * @brief Retorna os chunks faltantes que esperam um conteúdo.
+ */
+std::vector<ChunkLocation> ChunkStore::getWanted(const Sha256::Digest& digest) {
+    std::lock_guard<std::mutex> store_lock(store_mutex);
+
+    auto it = wanted.find(digest);
+    return it != wanted.end() ? it->second : std::vector<ChunkLocation>();
+}
+
+
+/**
+ * @brief Descarta as esperas dos chunks de um arquivo.
+ */
+void ChunkStore::forgetWanted(const std::string& file_name) {
+    std::lock_guard<std::mutex> store_lock(store_mutex);
+
+    for (auto it = wanted.begin(); it != wanted.end();) {
+        auto& locations = it->second;
+        locations.erase(std::remove_if(locations.begin(), locations.end(), [&](const ChunkLocation& location) {
+            return location.file_name == file_name;
+        }), locations.end());
+        it = locations.empty() ? wanted.erase(it) : std::next(it);
+    }
+}
+
+
+/**
+ * @brief Retorna o número de conteúdos com um chunk local.
+ */
+size_t ChunkStore::size() {
+    std::lock_guard<std::mutex> store_lock(store_mutex);
+    return held.size();
+}
+
+
+/**
+ * @brief Monta o nome de conteúdo de um chunk.
+ */
+std::string ChunkStore::contentName(const Sha256::Digest& digest) {
+    return std::string(CONTENT_PREFIX) + Sha256::toHex(digest);
+}
+
+
+/**
+ * @brief Lê o resumo de um nome de conteúdo.
+ */
+bool ChunkStore::parseContentName(std::string_view name, Sha256::Digest& digest) {
+    return isContentName(name) && Sha256::fromHex(name.substr(CONTENT_PREFIX.size()), digest);
+}
+
+
+/**
+ * @brief Indica se um nome é um nome de conteúdo.
+ */
+bool ChunkStore::isContentName(std::string_view name) {
+    return name.substr(0, CONTENT_PREFIX.size()) == CONTENT_PREFIX;
+}
@@ -0,0 +1,122 @@
+#ifndef CHUNKSTORE_H
+#define CHUNKSTORE_H
+
+#include "Sha256.h"
+#include <cstddef>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+
+/**
+ * @brief Estrutura que identifica um chunk pelo arquivo e pelo índice.
+ */
+struct ChunkLocation {
+    std::string file_name;                                  ///< Nome do arquivo.
+    int chunk = 0;                                          ///< Índice do chunk no arquivo.
+
+    bool operator==(const ChunkLocation& other) const { return chunk == other.chunk && file_name == other.file_name; }
+};
+
+
+/**
+ * @brief Classe que indexa os chunks pelo resumo SHA-256 do conteúdo.
+ *
+ * Os arquivos publicados com o p2p-publish trazem no .p2p o resumo de cada chunk. O índice
+ * guarda, para cada resumo, um chunk local com aquele conteúdo (qualquer arquivo) e os chunks
+ * de downloads em andamento que esperam aquele conteúdo. Assim um chunk de um arquivo novo pode
+ * ser copiado de outro arquivo já baixado e um chunk pedido pelo resumo ("sha256:<hex>", o nome
+ * de conteúdo) pode ser encontrado sob qualquer nome.
+ */
+class ChunkStore {
+private:
+    /**
+     * @brief Função de hash dos resumos: os primeiros 8 bytes, já uniformes.
+     */
+    struct DigestHash {
+        size_t operator()(const Sha256::Digest& digest) const;
+    };
+
+    std::unordered_map<Sha256::Digest, ChunkLocation, DigestHash> held;                  ///< Um chunk local para cada conteúdo.
+    std::unordered_map<Sha256::Digest, std::vector<ChunkLocation>, DigestHash> wanted;  ///< Chunks faltantes de downloads em andamento, por conteúdo.
+    std::mutex store_mutex;                                                             ///< Mutex para proteger os dois índices.
+
+public:
+    /**
+     * @brief Registra um chunk local e deixa de esperá-lo.
+     *
+     * O primeiro chunk registrado com um conteúdo é mantido.
+     *
+     * @param digest Resumo do conteúdo.
+     * @param location Arquivo e índice do chunk.
+     */
+    void add(const Sha256::Digest& digest, const ChunkLocation& location);
+
+
+    /**
+     * @brief Procura um chunk local com um conteúdo.
+     *
+     * @param digest Resumo do conteúdo.
+     * @param location Recebe o arquivo e o índice do chunk.
+     * @return true se algum chunk local tem o conteúdo.
+     */
+    bool find(const Sha256::Digest& digest, ChunkLocation& location);
+
+
+    /**
+     * @brief Registra que um chunk faltante de um download espera um conteúdo.
+     *
+     * @param digest Resumo do conteúdo.
+     * @param location Arquivo e índice do chunk faltante.
+     */
+    void want(const Sha256::Digest& digest, const ChunkLocation& location);
+
+
+    /**
+     * @brief Retorna os chunks faltantes que esperam um conteúdo.
+     *
+     * @param digest Resumo do conteúdo.
+     * @return Arquivo e índice de cada chunk.
+     */
+    std::vector<ChunkLocation> getWanted(const Sha256::Digest& digest);
+
+
+    /**
+     * @brief Descarta as esperas dos chunks de um arquivo (download montado ou abandonado).
+     *
+     * @param file_name Nome do arquivo.
+     */
+    void forgetWanted(const std::string& file_name);
+
+
+    /**
+     * @brief Retorna o número de conteúdos com um chunk local.
+     */
+    size_t size();
+
+
+    /**
+     * @brief Monta o nome de conteúdo de um chunk ("sha256:<64 dígitos hexadecimais>"), usado no lugar do nome do arquivo nas mensagens.
+     */
+    static std::string contentName(const Sha256::Digest& digest);
+
+
+    /**
+     * @brief Lê o resumo de um nome de conteúdo.
+     *
+     * @param name Nome recebido em uma mensagem.
+     * @param digest Recebe o resumo.
+     * @return true se o nome é um nome de conteúdo válido.
+     */
+    static bool parseContentName(std::string_view name, Sha256::Digest& digest);
+
+
+    /**
+     * @brief Indica se um nome é um nome de conteúdo, sem validar o resumo.
+     */
+    static bool isContentName(std::string_view name);
+};
+
+#endif // CHUNKSTORE_H
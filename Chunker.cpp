@@ -0,0 +1,130 @@
+#include "Chunker.h"
+#include <algorithm>
+
+
+namespace {
+    /**
+     * @brief Estrutura com os 256 valores pseudoaleatórios do gear hash, um por valor de byte.
+     */
+    struct GearTable {
+        uint64_t values[256];
+
+        GearTable() {
+            // SplitMix64 com semente fixa: todos os peers precisam cortar nos mesmos pontos
+            uint64_t seed = 0x9e3779b97f4a7c15ULL;
+            for (uint64_t& value : values) {
+                seed += 0x9e3779b97f4a7c15ULL;
+                uint64_t z = seed;
+                z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+                z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+                value = z ^ (z >> 31);
+            }
+        }
+    };
+
+
+    /**
+     * @brief Retorna a tabela do gear hash.
+     */
+    const uint64_t* gearTable() {
+        static GearTable* table = new GearTable();
+        return table->values;
+    }
+
+
+    /**
+     * @brief Retorna uma máscara com os 'bits' bits mais altos ligados.
+     */
+    uint64_t highBitsMask(int bits) {
+        bits = std::clamp(bits, 1, 63);
+        return ~uint64_t{0} << (64 - bits);
+    }
+}
+
+
+/**
+ * @brief Construtor da classe Chunker.
+ */
+Chunker::Chunker(ChunkingMode mode, size_t average_size) : mode(mode) {
+    if (mode == ChunkingMode::FIXED) {
+        this->average_size = std::max<size_t>(1, average_size);
+        min_size = max_size = this->average_size;
+        small_mask = large_mask = 0;
+        return;
+    }
+
+    // O CDC usa potências de dois: a probabilidade de corte de uma máscara de b bits é 1 / 2^b
+    int bits = 6;
+    while ((size_t{1} << (bits + 1)) <= average_size && bits < 30) {
+        ++bits;
+    }
+    this->average_size = size_t{1} << bits;
+    min_size = this->average_size / 4;
+    max_size = this->average_size * 8;
+
+    // Normalização de nível 2 do FastCDC
+    small_mask = highBitsMask(bits + 2);
+    large_mask = highBitsMask(bits - 2);
+}
+
+
+/**
+ * @brief Encontra o fim do próximo chunk.
+ */
+size_t Chunker::nextBoundary(const char* data, size_t size, bool end_of_input) const {
+    if (mode == ChunkingMode::FIXED || size <= min_size) {
+        if (size >= max_size) {
+            return max_size;
+        }
+        return end_of_input ? size : 0;
+    }
+
+    const uint64_t* gear = gearTable();
+    const unsigned char* bytes = reinterpret_cast<const unsigned char*>(data);
+    size_t limit = std::min(size, max_size);
+    size_t normal = std::min(average_size, limit);
+    uint64_t hash = 0;
+
+    // Os bytes antes do tamanho mínimo não são examinados: nenhum corte pode ocorrer neles
+    size_t i = min_size;
+    for (; i < normal; ++i) {
+        hash = (hash << 1) + gear[bytes[i]];
+        if ((hash & small_mask) == 0) {
+            return i + 1;
+        }
+    }
+    for (; i < limit; ++i) {
+        hash = (hash << 1) + gear[bytes[i]];
+        if ((hash & large_mask) == 0) {
+            return i + 1;
+        }
+    }
+
+    if (limit == max_size) {
+        return max_size;
+    }
+    return end_of_input ? size : 0;
+}
+
+
+/**
+ * @brief Converte o nome de um modo.
+ */
+bool Chunker::parseMode(const std::string& name, ChunkingMode& mode) {
+    if (name == "fixed") {
+        mode = ChunkingMode::FIXED;
+    } else if (name == "cdc") {
+        mode = ChunkingMode::CDC;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+
+/**
+ * @brief Converte um modo para texto.
+ */
+const char* Chunker::modeToString(ChunkingMode mode) {
+    return mode == ChunkingMode::CDC ? "cdc" : "fixed";
+}
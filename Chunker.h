@@ -0,0 +1,86 @@
+#ifndef CHUNKER_H
+#define CHUNKER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+
+/**
+ * @brief Enumeração dos modos de divisão de um arquivo em chunks.
+ */
+enum class ChunkingMode {
+    FIXED,      ///< Chunks do mesmo tamanho (o último pode ser menor).
+    CDC         ///< Chunks definidos pelo conteúdo (FastCDC): os cortes acompanham os bytes, não as posições.
+};
+
+
+/**
+ * @brief Classe que encontra os pontos de corte dos chunks de um arquivo.
+ *
+ * No modo CDC, um hash rolante (gear hash) percorre os bytes e um corte é feito quando os bits
+ * mais altos do hash são zero. Como o hash só depende dos últimos 64 bytes, uma inserção ou
+ * remoção no arquivo muda apenas os chunks próximos a ela; os demais cortes se repetem e os
+ * chunks mantêm o mesmo conteúdo. Os tamanhos ficam entre average/4 e 8 * average, e a
+ * normalização do FastCDC (máscara mais exigente antes da média e mais branda depois) concentra
+ * os tamanhos perto da média.
+ */
+class Chunker {
+private:
+    ChunkingMode mode;                                      ///< Modo de divisão.
+    size_t min_size;                                        ///< Tamanho mínimo de um chunk (exceto o último).
+    size_t average_size;                                    ///< Tamanho médio (CDC) ou fixo (FIXED) dos chunks.
+    size_t max_size;                                        ///< Tamanho máximo de um chunk.
+    uint64_t small_mask;                                    ///< Máscara usada antes do tamanho médio (mais bits: corte menos provável).
+    uint64_t large_mask;                                    ///< Máscara usada após o tamanho médio (menos bits: corte mais provável).
+
+public:
+    /**
+     * @brief Construtor da classe Chunker.
+     *
+     * @param mode Modo de divisão.
+     * @param average_size Tamanho dos chunks (FIXED) ou tamanho médio desejado (CDC), arredondado para uma potência de dois.
+     */
+    Chunker(ChunkingMode mode, size_t average_size);
+
+
+    /**
+     * @brief Encontra o fim do próximo chunk.
+     *
+     * @param data Bytes a partir do início do chunk.
+     * @param size Número de bytes disponíveis.
+     * @param end_of_input Indica que não há mais bytes além dos disponíveis.
+     * @return Tamanho do chunk, ou 0 se são necessários mais bytes (nunca ocorre com size >= getMaxSize()).
+     */
+    size_t nextBoundary(const char* data, size_t size, bool end_of_input) const;
+
+
+    /**
+     * @brief Retorna o modo de divisão.
+     */
+    ChunkingMode getMode() const { return mode; }
+
+
+    /**
+     * @brief Retorna o tamanho máximo de um chunk, que é o mínimo de bytes a entregar a nextBoundary.
+     */
+    size_t getMaxSize() const { return max_size; }
+
+
+    /**
+     * @brief Converte o nome de um modo ("fixed" ou "cdc").
+     *
+     * @param name Nome do modo.
+     * @param mode Recebe o modo.
+     * @return true se o nome é válido.
+     */
+    static bool parseMode(const std::string& name, ChunkingMode& mode);
+
+
+    /**
+     * @brief Converte um modo para texto.
+     */
+    static const char* modeToString(ChunkingMode mode);
+};
+
+#endif // CHUNKER_H
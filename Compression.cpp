@@ -0,0 +1,514 @@
+#include "Compression.h"
+#include "Constants.h"
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <vector>
+#ifdef HAVE_LZ4
+#include <lz4.h>
+#endif
+#ifdef HAVE_ZSTD
+#include <zstd.h>
+#endif
+
+
+namespace {
+    // Política dos peers criados a seguir
+    std::atomic<CompressionMode> default_mode{CompressionMode::AUTO};
+
+    /**
+     * @brief Retorna o bit de um formato no conjunto anunciado no REQUEST.
+     */
+    uint32_t codecBit(CompressionCodec codec) {
+        return 1u << static_cast<int>(codec);
+    }
+
+#ifndef HAVE_LZ4
+    // Parâmetros do formato de bloco LZ4: correspondências de pelo menos 4 bytes, os últimos 5 bytes
+    // sempre como literais e nenhuma correspondência começando nos últimos 12 bytes
+    const size_t LZ4_MIN_MATCH = 4;
+    const size_t LZ4_LAST_LITERALS = 5;
+    const size_t LZ4_MF_LIMIT = 12;
+    const size_t LZ4_MAX_OFFSET = 65535;
+    const int LZ4_HASH_LOG = 12;
+
+    /**
+     * @brief Lê 4 bytes sem exigir alinhamento.
+     */
+    uint32_t read32(const uint8_t* position) {
+        uint32_t value;
+        std::memcpy(&value, position, sizeof(value));
+        return value;
+    }
+
+    /**
+     * @brief Hash multiplicativo de 4 bytes, com LZ4_HASH_LOG bits.
+     */
+    uint32_t hash32(uint32_t value) {
+        return (value * 2654435761u) >> (32 - LZ4_HASH_LOG);
+    }
+
+    /**
+     * @brief Grava a extensão de um comprimento (bytes 255 seguidos do resto), usada quando o campo do token está cheio.
+     */
+    uint8_t* writeLength(uint8_t* output, size_t length) {
+        for (; length >= 255; length -= 255) {
+            *output++ = 255;
+        }
+        *output++ = static_cast<uint8_t>(length);
+        return output;
+    }
+
+    /**
+     * @brief Grava uma sequência (literais seguidos de uma correspondência opcional) no formato de bloco LZ4.
+     *
+     * @return Posição após a sequência, ou nulo se ela não coube no destino.
+     */
+    uint8_t* writeSequence(uint8_t* output, uint8_t* output_end, const uint8_t* literals, size_t literal_length,
+                           size_t offset, size_t match_length) {
+        // Pior caso: token, extensões dos dois comprimentos, literais e deslocamento
+        size_t needed = 1 + literal_length / 255 + 1 + literal_length + (match_length > 0 ? 2 + match_length / 255 + 1 : 0);
+        if (needed > static_cast<size_t>(output_end - output)) {
+            return nullptr;
+        }
+
+        uint8_t* token = output++;
+        *token = static_cast<uint8_t>(std::min<size_t>(literal_length, 15) << 4);
+        if (literal_length >= 15) {
+            output = writeLength(output, literal_length - 15);
+        }
+        std::memcpy(output, literals, literal_length);
+        output += literal_length;
+
+        if (match_length > 0) {
+            *output++ = static_cast<uint8_t>(offset & 0xFF);
+            *output++ = static_cast<uint8_t>(offset >> 8);
+            size_t length_code = match_length - LZ4_MIN_MATCH;
+            *token |= static_cast<uint8_t>(std::min<size_t>(length_code, 15));
+            if (length_code >= 15) {
+                output = writeLength(output, length_code - 15);
+            }
+        }
+        return output;
+    }
+
+    /**
+     * @brief Comprime no formato de bloco LZ4 (busca gulosa com uma tabela hash das posições de 4 bytes).
+     */
+    size_t lz4Compress(const char* data, size_t size, char* output, size_t capacity) {
+        const uint8_t* input = reinterpret_cast<const uint8_t*>(data);
+        const uint8_t* input_end = input + size;
+        const uint8_t* anchor = input;
+        uint8_t* out = reinterpret_cast<uint8_t*>(output);
+        uint8_t* out_end = out + capacity;
+
+        if (size > LZ4_MF_LIMIT) {
+            // Posição + 1 da última ocorrência de cada hash (0: nenhuma)
+            uint32_t table[1 << LZ4_HASH_LOG] = {0};
+            const uint8_t* match_limit = input_end - LZ4_MF_LIMIT;
+            const uint8_t* position = input;
+
+            while (position < match_limit) {
+                uint32_t sequence = read32(position);
+                uint32_t& entry = table[hash32(sequence)];
+                const uint8_t* candidate = entry > 0 ? input + entry - 1 : nullptr;
+                entry = static_cast<uint32_t>(position - input + 1);
+
+                if (candidate == nullptr || static_cast<size_t>(position - candidate) > LZ4_MAX_OFFSET || read32(candidate) != sequence) {
+                    // Sem correspondência há muitos bytes, o conteúdo é pouco compressível: avança mais rápido, como o LZ4
+                    position += 1 + ((position - anchor) >> 6);
+                    continue;
+                }
+
+                // Estende a correspondência para frente, sem invadir os últimos literais
+                const uint8_t* match_end = position + LZ4_MIN_MATCH;
+                const uint8_t* candidate_end = candidate + LZ4_MIN_MATCH;
+                while (match_end < input_end - LZ4_LAST_LITERALS && *match_end == *candidate_end) {
+                    ++match_end;
+                    ++candidate_end;
+                }
+
+                // E para trás, sobre os literais pendentes
+                while (position > anchor && candidate > input && position[-1] == candidate[-1]) {
+                    --position;
+                    --candidate;
+                }
+
+                out = writeSequence(out, out_end, anchor, position - anchor, position - candidate, match_end - position);
+                if (out == nullptr) {
+                    return 0;
+                }
+                anchor = position = match_end;
+
+                // Registra uma posição dentro da correspondência, que costuma iniciar a próxima
+                if (position - 2 >= input && position < match_limit) {
+                    table[hash32(read32(position - 2))] = static_cast<uint32_t>(position - 2 - input + 1);
+                }
+            }
+        }
+
+        // A última sequência tem só literais
+        out = writeSequence(out, out_end, anchor, input_end - anchor, 0, 0);
+        return out != nullptr ? static_cast<size_t>(out - reinterpret_cast<uint8_t*>(output)) : 0;
+    }
+
+    /**
+     * @brief Lê a extensão de um comprimento.
+     *
+     * @return false se o bloco terminou no meio da extensão.
+     */
+    bool readLength(const uint8_t*& input, const uint8_t* input_end, size_t& length) {
+        uint8_t byte;
+        do {
+            if (input >= input_end) {
+                return false;
+            }
+            byte = *input++;
+            length += byte;
+        } while (byte == 255);
+        return true;
+    }
+
+    /**
+     * @brief Descomprime um bloco LZ4, validando cada comprimento e deslocamento contra os limites.
+     */
+    bool lz4Decompress(const char* data, size_t size, char* output, size_t raw_size) {
+        const uint8_t* input = reinterpret_cast<const uint8_t*>(data);
+        const uint8_t* input_end = input + size;
+        uint8_t* out = reinterpret_cast<uint8_t*>(output);
+        uint8_t* out_begin = out;
+        uint8_t* out_end = out + raw_size;
+
+        while (input < input_end) {
+            uint8_t token = *input++;
+
+            size_t literal_length = token >> 4;
+            if (literal_length == 15 && !readLength(input, input_end, literal_length)) {
+                return false;
+            }
+            if (literal_length > static_cast<size_t>(input_end - input) || literal_length > static_cast<size_t>(out_end - out)) {
+                return false;
+            }
+            std::memcpy(out, input, literal_length);
+            input += literal_length;
+            out += literal_length;
+
+            // A última sequência termina nos literais
+            if (input == input_end) {
+                break;
+            }
+
+            if (input_end - input < 2) {
+                return false;
+            }
+            size_t offset = input[0] | (static_cast<size_t>(input[1]) << 8);
+            input += 2;
+            if (offset == 0 || offset > static_cast<size_t>(out - out_begin)) {
+                return false;
+            }
+
+            size_t match_length = token & 15;
+            if (match_length == 15 && !readLength(input, input_end, match_length)) {
+                return false;
+            }
+            match_length += LZ4_MIN_MATCH;
+            if (match_length > static_cast<size_t>(out_end - out)) {
+                return false;
+            }
+
+            // Com deslocamento menor que o comprimento, a cópia repete os bytes recém-escritos: cada cópia
+            // parte do início da correspondência e dobra de tamanho, sem sobrepor origem e destino
+            const uint8_t* match = out - offset;
+            while (match_length > 0) {
+                size_t step = std::min(static_cast<size_t>(out - match), match_length);
+                std::memcpy(out, match, step);
+                out += step;
+                match_length -= step;
+            }
+        }
+
+        return out == out_end;
+    }
+#endif
+
+#ifdef HAVE_ZSTD
+    /**
+     * @brief Estrutura com os contextos do zstd de uma thread, reaproveitados entre os chunks.
+     */
+    struct ZstdContexts {
+        ZSTD_CCtx* compression = ZSTD_createCCtx();
+        ZSTD_DCtx* decompression = ZSTD_createDCtx();
+
+        ~ZstdContexts() {
+            ZSTD_freeCCtx(compression);
+            ZSTD_freeDCtx(decompression);
+        }
+    };
+
+    thread_local ZstdContexts zstd_contexts;
+#endif
+}
+
+
+/**
+ * @brief Indica se um formato pode ser comprimido e descomprimido por este peer.
+ */
+bool Compression::isAvailable(CompressionCodec codec) {
+    switch (codec) {
+        case CompressionCodec::NONE:    return true;
+        case CompressionCodec::LZ4:     return true;
+#ifdef HAVE_ZSTD
+        case CompressionCodec::ZSTD:    return true;
+#endif
+        default:                        return false;
+    }
+}
+
+
+/**
+ * @brief Retorna os formatos disponíveis.
+ */
+uint32_t Compression::supportedCodecs() {
+    uint32_t codecs = 0;
+    for (CompressionCodec codec : {CompressionCodec::LZ4, CompressionCodec::ZSTD}) {
+        if (isAvailable(codec)) {
+            codecs |= codecBit(codec);
+        }
+    }
+    return codecs;
+}
+
+
+/**
+ * @brief Converte um conjunto de formatos para a lista anunciada no REQUEST.
+ */
+std::string Compression::codecsToString(uint32_t codecs) {
+    std::string text;
+    for (CompressionCodec codec : {CompressionCodec::LZ4, CompressionCodec::ZSTD}) {
+        if ((codecs & codecBit(codec)) != 0) {
+            text += (text.empty() ? "" : ",") + std::string(codecToString(codec));
+        }
+    }
+    return text;
+}
+
+
+/**
+ * @brief Lê a lista de formatos anunciada no REQUEST.
+ */
+uint32_t Compression::parseCodecs(std::string_view text) {
+    uint32_t codecs = 0;
+    while (!text.empty()) {
+        size_t comma = text.find(',');
+        CompressionCodec codec;
+        if (parseCodec(text.substr(0, comma), codec) && codec != CompressionCodec::NONE && isAvailable(codec)) {
+            codecs |= codecBit(codec);
+        }
+        text = comma == std::string_view::npos ? std::string_view() : text.substr(comma + 1);
+    }
+    return codecs;
+}
+
+
+/**
+ * @brief Converte o nome de um formato.
+ */
+bool Compression::parseCodec(std::string_view name, CompressionCodec& codec) {
+    if (name == "none") {
+        codec = CompressionCodec::NONE;
+    } else if (name == "lz4") {
+        codec = CompressionCodec::LZ4;
+    } else if (name == "zstd") {
+        codec = CompressionCodec::ZSTD;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+
+/**
+ * @brief Converte um formato para texto.
+ */
+const char* Compression::codecToString(CompressionCodec codec) {
+    switch (codec) {
+        case CompressionCodec::LZ4:     return "lz4";
+        case CompressionCodec::ZSTD:    return "zstd";
+        default:                        return "none";
+    }
+}
+
+
+/**
+ * @brief Converte o nome de uma política.
+ */
+bool Compression::parseMode(const std::string& name, CompressionMode& mode) {
+    if (name == "off") {
+        mode = CompressionMode::OFF;
+    } else if (name == "auto") {
+        mode = CompressionMode::AUTO;
+    } else if (name == "lz4") {
+        mode = CompressionMode::LZ4;
+    } else if (name == "zstd") {
+        mode = CompressionMode::ZSTD;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+
+/**
+ * @brief Converte uma política para texto.
+ */
+const char* Compression::modeToString(CompressionMode mode) {
+    switch (mode) {
+        case CompressionMode::OFF:      return "off";
+        case CompressionMode::LZ4:      return "lz4";
+        case CompressionMode::ZSTD:     return "zstd";
+        default:                        return "auto";
+    }
+}
+
+
+/**
+ * @brief Define a política usada pelos peers criados a seguir (opção --compression).
+ */
+void Compression::setDefaultMode(CompressionMode mode) {
+    default_mode.store(mode);
+}
+
+
+/**
+ * @brief Retorna a política usada pelos peers criados a seguir.
+ */
+CompressionMode Compression::getDefaultMode() {
+    return default_mode.load();
+}
+
+
+/**
+ * @brief Retorna o tamanho máximo do resultado da compressão de size bytes.
+ */
+size_t Compression::maxCompressedSize(CompressionCodec codec, size_t size) {
+    switch (codec) {
+        case CompressionCodec::LZ4:
+            // Mesmo limite de LZ4_COMPRESSBOUND
+            return size + size / 255 + 16;
+#ifdef HAVE_ZSTD
+        case CompressionCodec::ZSTD:
+            return ZSTD_compressBound(size);
+#endif
+        default:
+            return size;
+    }
+}
+
+
+/**
+ * @brief Comprime um bloco de dados.
+ */
+size_t Compression::compress(CompressionCodec codec, const char* data, size_t size, char* output, size_t capacity) {
+    switch (codec) {
+        case CompressionCodec::LZ4: {
+#ifdef HAVE_LZ4
+            int compressed_size = LZ4_compress_default(data, output, static_cast<int>(size), static_cast<int>(capacity));
+            return compressed_size > 0 ? static_cast<size_t>(compressed_size) : 0;
+#else
+            return lz4Compress(data, size, output, capacity);
+#endif
+        }
+#ifdef HAVE_ZSTD
+        case CompressionCodec::ZSTD: {
+            size_t compressed_size = ZSTD_compressCCtx(zstd_contexts.compression, output, capacity, data, size, Constants::COMPRESSION_ZSTD_LEVEL);
+            return ZSTD_isError(compressed_size) ? 0 : compressed_size;
+        }
+#endif
+        default:
+            return 0;
+    }
+}
+
+
+/**
+ * @brief Descomprime um bloco de dados, validando os limites da entrada e da saída.
+ */
+bool Compression::decompress(CompressionCodec codec, const char* data, size_t size, char* output, size_t raw_size) {
+    switch (codec) {
+        case CompressionCodec::NONE:
+            if (size != raw_size) {
+                return false;
+            }
+            std::memcpy(output, data, size);
+            return true;
+        case CompressionCodec::LZ4: {
+#ifdef HAVE_LZ4
+            int decompressed_size = LZ4_decompress_safe(data, output, static_cast<int>(size), static_cast<int>(raw_size));
+            return decompressed_size >= 0 && static_cast<size_t>(decompressed_size) == raw_size;
+#else
+            return lz4Decompress(data, size, output, raw_size);
+#endif
+        }
+#ifdef HAVE_ZSTD
+        case CompressionCodec::ZSTD: {
+            size_t decompressed_size = ZSTD_decompressDCtx(zstd_contexts.decompression, output, raw_size, data, size);
+            return !ZSTD_isError(decompressed_size) && decompressed_size == raw_size;
+        }
+#endif
+        default:
+            return false;
+    }
+}
+
+
+/**
+ * @brief Estima a razão de compressão de um chunk comprimindo com LZ4 alguns blocos espalhados por ele.
+ */
+double Compression::sampleRatio(const char* data, size_t size) {
+    size_t block_size = std::min(size, Constants::COMPRESSION_SAMPLE_BLOCK_BYTES);
+    if (block_size == 0) {
+        return 1.0;
+    }
+
+    // Blocos igualmente espaçados, do início ao fim do chunk (um bloco só se o chunk é pequeno)
+    int blocks = size >= block_size * Constants::COMPRESSION_SAMPLE_BLOCKS ? Constants::COMPRESSION_SAMPLE_BLOCKS : 1;
+    size_t stride = blocks > 1 ? (size - block_size) / (blocks - 1) : 0;
+
+    thread_local std::vector<char> scratch;
+    scratch.resize(maxCompressedSize(CompressionCodec::LZ4, block_size));
+
+    size_t sampled = 0, compressed = 0;
+    for (int block = 0; block < blocks; ++block) {
+        size_t compressed_size = compress(CompressionCodec::LZ4, data + block * stride, block_size, scratch.data(), scratch.size());
+        sampled += block_size;
+        compressed += compressed_size > 0 ? compressed_size : block_size;
+    }
+    return static_cast<double>(compressed) / static_cast<double>(sampled);
+}
+
+
+/**
+ * @brief Escolhe o formato de um chunk a enviar.
+ */
+CompressionCodec Compression::choose(CompressionMode mode, uint32_t accepted, const char* data, size_t size, double link_bytes_per_second) {
+    if (mode == CompressionMode::OFF || accepted == 0 || size < Constants::COMPRESSION_MIN_CHUNK_BYTES) {
+        return CompressionCodec::NONE;
+    }
+
+    // zstd quando pedido ou quando o enlace é lento o bastante para a razão maior compensar a compressão mais lenta
+    bool zstd_accepted = (accepted & codecBit(CompressionCodec::ZSTD)) != 0 && isAvailable(CompressionCodec::ZSTD);
+    bool lz4_accepted = (accepted & codecBit(CompressionCodec::LZ4)) != 0;
+    CompressionCodec codec = CompressionCodec::NONE;
+    if (zstd_accepted && (mode == CompressionMode::ZSTD ||
+                          (mode == CompressionMode::AUTO && link_bytes_per_second < Constants::COMPRESSION_ZSTD_MAX_LINK_BYTES_PER_SECOND))) {
+        codec = CompressionCodec::ZSTD;
+    } else if (lz4_accepted) {
+        codec = CompressionCodec::LZ4;
+    }
+
+    // Conteúdo já comprimido ou aleatório não encolhe: evita comprimir o chunk inteiro à toa
+    if (codec != CompressionCodec::NONE && sampleRatio(data, size) > Constants::COMPRESSION_MAX_SAMPLED_RATIO) {
+        return CompressionCodec::NONE;
+    }
+    return codec;
+}
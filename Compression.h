@@ -0,0 +1,179 @@
+#ifndef COMPRESSION_H
+#define COMPRESSION_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+
+/**
+ * @brief Enumeração dos formatos de compressão dos chunks enviados via TCP.
+ */
+enum class CompressionCodec {
+    NONE,       ///< Bytes do chunk sem compressão.
+    LZ4,        ///< Bloco LZ4: compressão e descompressão rápidas, razão menor.
+    ZSTD        ///< Quadro zstd: razão maior, compressão mais lenta.
+};
+
+
+/**
+ * @brief Enumeração das políticas de compressão dos chunks enviados.
+ */
+enum class CompressionMode {
+    OFF,        ///< Os chunks seguem sem compressão.
+    AUTO,       ///< zstd em enlaces lentos, LZ4 nos demais.
+    LZ4,        ///< Sempre LZ4.
+    ZSTD        ///< zstd quando disponível nos dois peers; senão LZ4.
+};
+
+
+/**
+ * @brief Classe com a compressão dos chunks na transferência entre peers.
+ *
+ * O peer que pede chunks anuncia no REQUEST os formatos que sabe descomprimir, e o peer que
+ * envia escolhe um deles para cada chunk e o informa na mensagem de controle PUT. Antes de
+ * comprimir um chunk, alguns blocos dele são comprimidos com LZ4; se a amostra não encolhe
+ * abaixo de Constants::COMPRESSION_MAX_SAMPLED_RATIO (conteúdo já comprimido ou aleatório), o
+ * chunk segue sem compressão. O LZ4 usa a liblz4 quando ela está instalada (HAVE_LZ4) e, sem
+ * ela, uma implementação própria do mesmo formato de bloco, então os peers sempre descomprimem
+ * LZ4; o zstd só existe com a libzstd (HAVE_ZSTD).
+ */
+class Compression {
+public:
+    /**
+     * @brief Indica se um formato pode ser comprimido e descomprimido por este peer.
+     */
+    static bool isAvailable(CompressionCodec codec);
+
+
+    /**
+     * @brief Retorna os formatos disponíveis, um bit (1 << codec) para cada formato comprimido.
+     */
+    static uint32_t supportedCodecs();
+
+
+    /**
+     * @brief Converte um conjunto de formatos para a lista anunciada no REQUEST (ex: "lz4,zstd").
+     *
+     * @param codecs Conjunto de formatos, um bit por formato.
+     * @return Nomes separados por vírgula.
+     */
+    static std::string codecsToString(uint32_t codecs);
+
+
+    /**
+     * @brief Lê a lista de formatos anunciada no REQUEST.
+     *
+     * @param text Nomes separados por vírgula; nomes desconhecidos e formatos indisponíveis são ignorados.
+     * @return Conjunto de formatos disponíveis nos dois peers, um bit por formato.
+     */
+    static uint32_t parseCodecs(std::string_view text);
+
+
+    /**
+     * @brief Converte o nome de um formato ("none", "lz4" ou "zstd").
+     *
+     * @param name Nome do formato.
+     * @param codec Recebe o formato.
+     * @return true se o nome é válido.
+     */
+    static bool parseCodec(std::string_view name, CompressionCodec& codec);
+
+
+    /**
+     * @brief Converte um formato para texto.
+     */
+    static const char* codecToString(CompressionCodec codec);
+
+
+    /**
+     * @brief Converte o nome de uma política ("off", "auto", "lz4" ou "zstd").
+     *
+     * @param name Nome da política.
+     * @param mode Recebe a política.
+     * @return true se o nome é válido.
+     */
+    static bool parseMode(const std::string& name, CompressionMode& mode);
+
+
+    /**
+     * @brief Converte uma política para texto.
+     */
+    static const char* modeToString(CompressionMode mode);
+
+
+    /**
+     * @brief Define a política usada pelos peers criados a seguir (opção --compression).
+     *
+     * @param mode Política desejada.
+     */
+    static void setDefaultMode(CompressionMode mode);
+
+
+    /**
+     * @brief Retorna a política usada pelos peers criados a seguir (padrão: AUTO).
+     */
+    static CompressionMode getDefaultMode();
+
+
+    /**
+     * @brief Retorna o tamanho máximo do resultado da compressão de size bytes.
+     *
+     * @param codec Formato comprimido disponível.
+     * @param size Tamanho dos dados originais.
+     * @return Capacidade que garante que compress não falha por falta de espaço.
+     */
+    static size_t maxCompressedSize(CompressionCodec codec, size_t size);
+
+
+    /**
+     * @brief Comprime um bloco de dados.
+     *
+     * @param codec Formato comprimido disponível.
+     * @param data Dados originais.
+     * @param size Tamanho dos dados originais.
+     * @param output Destino do resultado.
+     * @param capacity Capacidade do destino; menor que size para exigir que o resultado encolha.
+     * @return Tamanho do resultado, ou 0 se ele não coube no destino.
+     */
+    static size_t compress(CompressionCodec codec, const char* data, size_t size, char* output, size_t capacity);
+
+
+    /**
+     * @brief Descomprime um bloco de dados, validando os limites da entrada e da saída.
+     *
+     * @param codec Formato do bloco.
+     * @param data Bloco comprimido, recebido de outro peer.
+     * @param size Tamanho do bloco comprimido.
+     * @param output Destino dos dados originais.
+     * @param raw_size Tamanho exato dos dados originais.
+     * @return true se o bloco é válido e tem exatamente raw_size bytes originais.
+     */
+    static bool decompress(CompressionCodec codec, const char* data, size_t size, char* output, size_t raw_size);
+
+
+    /**
+     * @brief Estima a razão de compressão de um chunk comprimindo com LZ4 alguns blocos espalhados por ele.
+     *
+     * @param data Conteúdo do chunk.
+     * @param size Tamanho do chunk.
+     * @return Bytes comprimidos divididos pelos bytes amostrados (próximo de 1 ou acima: incompressível).
+     */
+    static double sampleRatio(const char* data, size_t size);
+
+
+    /**
+     * @brief Escolhe o formato de um chunk a enviar.
+     *
+     * @param mode Política do peer que envia.
+     * @param accepted Formatos anunciados pelo peer que recebe (0: peer sem compressão).
+     * @param data Conteúdo do chunk.
+     * @param size Tamanho do chunk.
+     * @param link_bytes_per_second Velocidade do enlace simulado (infinita quando o envio não é limitado).
+     * @return Formato escolhido, ou NONE para chunks pequenos, incompressíveis ou sem formato em comum.
+     */
+    static CompressionCodec choose(CompressionMode mode, uint32_t accepted, const char* data, size_t size, double link_bytes_per_second);
+};
+
+#endif // COMPRESSION_H
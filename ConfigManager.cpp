@@ -1,130 +1,513 @@
 #include "ConfigManager.h"
+#include <algorithm>
+#include <arpa/inet.h>
+#include <cstring>
+#include <fcntl.h>
 #include <fstream>
-#include <iostream>
-#include <sstream>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 
-/**
- * @brief Carrega as configurações dos peers a partir do arquivo.
- */
-std::map<int, std::tuple<std::string, int, int>> ConfigManager::loadConfig() {
-    std::string file_path = Constants::CONFIG_PATH;
-    std::ifstream file(file_path); // Abre o arquivo para leitura
-    std::map<int, std::tuple<std::string, int, int>> config; // Mapa para armazenar as configurações
+namespace {
+    const char CACHE_MAGIC[8] = {'P', '2', 'P', 'C', 'F', 'G', '\0', '\0'};   ///< Identificador da forma binária.
+    const uint32_t CACHE_VERSION = 1;                                         ///< Versão do formato da forma binária.
+
+
+    /**
+     * @brief Arquivo mapeado em memória somente para leitura.
+     */
+    class MappedFile {
+    public:
+        explicit MappedFile(const std::string& path) {
+            fd = open(path.c_str(), O_RDONLY);
+            if (fd < 0) {
+                return;
+            }
+
+            struct stat file_stat{};
+            if (fstat(fd, &file_stat) < 0) {
+                return;
+            }
+            size = static_cast<size_t>(file_stat.st_size);
+
+            // Arquivos vazios não podem ser mapeados, mas são válidos
+            if (size > 0) {
+                void* mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+                if (mapping == MAP_FAILED) {
+                    return;
+                }
+                data = static_cast<const char*>(mapping);
+                madvise(mapping, size, MADV_SEQUENTIAL);
+            }
+            opened = true;
+        }
+
+        ~MappedFile() {
+            if (data != nullptr) {
+                munmap(const_cast<char*>(data), size);
+            }
+            if (fd >= 0) {
+                close(fd);
+            }
+        }
+
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        bool isOpen() const { return opened; }
+        const char* begin() const { return data; }
+        const char* end() const { return data + size; }
+        size_t length() const { return size; }
+
+    private:
+        int fd = -1;
+        const char* data = nullptr;
+        size_t size = 0;
+        bool opened = false;
+    };
+
+
+    /**
+     * @brief Leitor de linhas no formato "<id>: <campo>, <campo>, ..." sobre um buffer em memória.
+     */
+    class LineScanner {
+    public:
+        LineScanner(const char* begin, const char* end) : position(begin), end(end) {}
+
+        bool done() const { return position >= end; }
+        size_t lineNumber() const { return line_number; }
+
+        // Avança espaços e tabulações, sem passar para a próxima linha
+        void skipBlanks() {
+            while (position < end && (*position == ' ' || *position == '\t')) {
+                ++position;
+            }
+        }
+
+        // Fim da linha atual (ignora o '\r' de arquivos criados no Windows)
+        bool atLineEnd() {
+            skipBlanks();
+            return position >= end || *position == '\n' || *position == '\r';
+        }
+
+        // Descarta o restante da linha atual, incluindo a quebra de linha
+        void nextLine() {
+            const char* newline = static_cast<const char*>(std::memchr(position, '\n', end - position));
+            position = newline != nullptr ? newline + 1 : end;
+            ++line_number;
+        }
+
+        bool expect(char character) {
+            skipBlanks();
+            if (position < end && *position == character) {
+                ++position;
+                return true;
+            }
+            return false;
+        }
+
+        bool parseInt(int32_t& value) {
+            skipBlanks();
+            bool negative = position < end && *position == '-';
+            const char* digits = position + (negative ? 1 : 0);
+
+            int64_t result = 0;
+            const char* cursor = digits;
+            while (cursor < end && *cursor >= '0' && *cursor <= '9' && cursor - digits < 10) {
+                result = result * 10 + (*cursor - '0');
+                ++cursor;
+            }
+
+            // Sem dígitos, mais de 10 dígitos ou fora do intervalo de int32_t
+            if (cursor == digits || (cursor < end && *cursor >= '0' && *cursor <= '9') || result > INT32_MAX) {
+                return false;
+            }
+
+            value = static_cast<int32_t>(negative ? -result : result);
+            position = cursor;
+            return true;
+        }
+
+        // Lê um endereço IPv4 terminado por ',' ou pelo fim da linha
+        bool parseIPv4(uint32_t& address) {
+            skipBlanks();
+            const char* token_begin = position;
+            while (position < end && *position != ',' && *position != '\n' && *position != '\r') {
+                ++position;
+            }
+
+            const char* token_end = position;
+            while (token_end > token_begin && (token_end[-1] == ' ' || token_end[-1] == '\t')) {
+                --token_end;
+            }
+
+            char ip[INET_ADDRSTRLEN] = {0};
+            size_t token_size = token_end - token_begin;
+            if (token_size == 0 || token_size >= sizeof(ip)) {
+                return false;
+            }
+            std::memcpy(ip, token_begin, token_size);
+
+            struct in_addr parsed{};
+            if (inet_pton(AF_INET, ip, &parsed) != 1) {
+                return false;
+            }
+            address = parsed.s_addr;
+            return true;
+        }
+
+    private:
+        const char* position;
+        const char* end;
+        size_t line_number = 1;
+    };
+
+
+    /**
+     * @brief Tamanho e data de modificação de um arquivo de texto, gravados na forma binária.
+     */
+    struct SourceFingerprint {
+        int64_t size = -1;
+        int64_t mtime_ns = -1;
+
+        bool operator==(const SourceFingerprint& other) const {
+            return size == other.size && mtime_ns == other.mtime_ns;
+        }
+    };
+
+
+    /**
+     * @brief Obtém o tamanho e a data de modificação de um arquivo.
+     */
+    SourceFingerprint fingerprintOf(const std::string& path) {
+        SourceFingerprint fingerprint;
+        struct stat file_stat{};
+        if (stat(path.c_str(), &file_stat) == 0) {
+            fingerprint.size = file_stat.st_size;
+            fingerprint.mtime_ns = static_cast<int64_t>(file_stat.st_mtim.tv_sec) * 1000000000 + file_stat.st_mtim.tv_nsec;
+        }
+        return fingerprint;
+    }
+
+
+    /**
+     * @brief Cabeçalho da forma binária. Em seguida vêm os arrays de NetworkConfig, na ordem:
+     * peer_ids, ips, udp_ports, transfer_speeds, neighbor_offsets, neighbor_indices e in_topology.
+     */
+    struct CacheHeader {
+        char magic[8];
+        uint32_t version;
+        uint32_t peer_count;
+        uint32_t neighbor_count;
+        uint32_t reserved;
+        SourceFingerprint config;
+        SourceFingerprint topology;
+    };
+
+
+    /**
+     * @brief Calcula o tamanho total da forma binária.
+     */
+    size_t cacheSize(uint32_t peer_count, uint32_t neighbor_count) {
+        return sizeof(CacheHeader)
+             + peer_count * (sizeof(int32_t) + sizeof(uint32_t) + sizeof(int32_t) + sizeof(int32_t))
+             + (peer_count + 1) * sizeof(uint32_t)
+             + neighbor_count * sizeof(int32_t)
+             + peer_count * sizeof(uint8_t);
+    }
+
+
+    /**
+     * @brief Carrega a forma binária da configuração, se ela corresponder aos arquivos de texto.
+     */
+    bool loadCache(const std::string& cache_path, const SourceFingerprint& config, const SourceFingerprint& topology, NetworkConfig& network) {
+        MappedFile file(cache_path);
+        if (!file.isOpen() || file.length() < sizeof(CacheHeader)) {
+            return false;
+        }
 
-    // Verifica se o arquivo foi aberto corretamente
-    if (!file.is_open()) {
-        logMessage(LogType::ERROR, "Erro ao abrir o arquivo de configuração.");
-        return config; // Retorna um mapa vazio em caso de erro
+        CacheHeader header;
+        std::memcpy(&header, file.begin(), sizeof(header));
+
+        if (std::memcmp(header.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC)) != 0 || header.version != CACHE_VERSION ||
+            !(header.config == config) || !(header.topology == topology) ||
+            file.length() != cacheSize(header.peer_count, header.neighbor_count)) {
+            return false;
+        }
+
+        const char* cursor = file.begin() + sizeof(header);
+        auto read = [&cursor](auto& array, size_t count) {
+            array.resize(count);
+            std::memcpy(array.data(), cursor, count * sizeof(array[0]));
+            cursor += count * sizeof(array[0]);
+        };
+
+        read(network.peer_ids, header.peer_count);
+        read(network.ips, header.peer_count);
+        read(network.udp_ports, header.peer_count);
+        read(network.transfer_speeds, header.peer_count);
+        read(network.neighbor_offsets, header.peer_count + 1);
+        read(network.neighbor_indices, header.neighbor_count);
+        read(network.in_topology, header.peer_count);
+
+        // Confere os limites da topologia, para que um arquivo corrompido não gere acessos inválidos
+        if (network.neighbor_offsets.front() != 0 || network.neighbor_offsets.back() != header.neighbor_count ||
+            !std::is_sorted(network.neighbor_offsets.begin(), network.neighbor_offsets.end())) {
+            return false;
+        }
+        for (int32_t neighbor : network.neighbor_indices) {
+            if (neighbor < 0 || static_cast<uint32_t>(neighbor) >= header.peer_count) {
+                return false;
+            }
+        }
+        return true;
     }
 
-    std::string line;
-    
-    // Lê cada linha do arquivo
-    while (std::getline(file, line)) {
-        std::stringstream ss(line); // Cria um fluxo de string para processamento
-        int peer_id;
-        char colon, comma2; // Variáveis para capturar ':' e ','
-        std::string ip;
-        int udp_port;
-        int speed;
 
-        // Lê o ID do peer e o caractere ':'
-        ss >> peer_id >> colon;
+    /**
+     * @brief Grava a forma binária da configuração em um arquivo temporário e o renomeia.
+     */
+    bool saveCache(const std::string& cache_path, const SourceFingerprint& config, const SourceFingerprint& topology, const NetworkConfig& network) {
+        CacheHeader header{};
+        std::memcpy(header.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC));
+        header.version = CACHE_VERSION;
+        header.peer_count = static_cast<uint32_t>(network.peer_ids.size());
+        header.neighbor_count = static_cast<uint32_t>(network.neighbor_indices.size());
+        header.config = config;
+        header.topology = topology;
 
-        // Captura o IP e ignora a vírgula
-        std::getline(ss, ip, ','); 
-        ip = trim(ip); // Remove espaços em branco do IP
+        // Vários peers podem ser iniciados ao mesmo tempo, então cada um usa seu próprio arquivo temporário
+        std::string temporary_path = cache_path + ".tmp" + std::to_string(getpid());
+        std::ofstream output(temporary_path, std::ios::binary | std::ios::trunc);
+        if (!output.is_open()) {
+            return false;
+        }
+
+        auto write = [&output](const auto& array) {
+            output.write(reinterpret_cast<const char*>(array.data()), array.size() * sizeof(array[0]));
+        };
 
-        // Lê os campos restantes (udp_port e speed)
-        ss >> udp_port >> comma2 >> speed;
+        output.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        write(network.peer_ids);
+        write(network.ips);
+        write(network.udp_ports);
+        write(network.transfer_speeds);
+        write(network.neighbor_offsets);
+        write(network.neighbor_indices);
+        write(network.in_topology);
+        output.close();
 
-        // Armazena os dados no mapa
-        config[peer_id] = std::make_tuple(ip, udp_port, speed);
+        if (!output || std::rename(temporary_path.c_str(), cache_path.c_str()) != 0) {
+            std::remove(temporary_path.c_str());
+            return false;
+        }
+        return true;
     }
+}
+
+
+/**
+ * @brief Busca o índice de um peer pelo seu ID.
+ */
+int NetworkConfig::findPeer(int peer_id) const {
+    auto it = std::lower_bound(peer_ids.begin(), peer_ids.end(), peer_id);
+    return it != peer_ids.end() && *it == peer_id ? static_cast<int>(it - peer_ids.begin()) : -1;
+}
+
+
+/**
+ * @brief Retorna a configuração de um peer.
+ */
+std::tuple<std::string, int, int> NetworkConfig::getPeer(int index) const {
+    char ip[INET_ADDRSTRLEN] = {0};
+    struct in_addr address{};
+    address.s_addr = ips[index];
+    inet_ntop(AF_INET, &address, ip, sizeof(ip));
+
+    return {ip, udp_ports[index], transfer_speeds[index]};
+}
+
 
-    file.close(); // Fecha o arquivo após a leitura
-    return config; // Retorna o mapa de configurações
+/**
+ * @brief Expande os vizinhos de um único peer para IP e porta UDP.
+ */
+std::vector<std::tuple<std::string, int>> NetworkConfig::getNeighbors(int index) const {
+    std::vector<std::tuple<std::string, int>> neighbors;
+    neighbors.reserve(neighbor_offsets[index + 1] - neighbor_offsets[index]);
+
+    for (uint32_t i = neighbor_offsets[index]; i < neighbor_offsets[index + 1]; ++i) {
+        auto [neighbor_ip, neighbor_port, _] = getPeer(neighbor_indices[i]);
+        neighbors.emplace_back(neighbor_ip, neighbor_port);
+    }
+    return neighbors;
 }
 
 
 /**
- * @brief Carrega a topologia da rede a partir do arquivo.
+ * @brief Carrega a configuração e a topologia da rede, usando a forma binária quando válida.
  */
-std::map<int, std::vector<int>> ConfigManager::loadTopology() {
-    std::string file_path = Constants::TOPOLOGY_PATH;
-    std::ifstream file(file_path); // Abre o arquivo para leitura
-    std::map<int, std::vector<int>> topology; // Mapa para armazenar a topologia
+bool ConfigManager::loadNetwork(NetworkConfig& network, const std::string& config_path,
+                                const std::string& topology_path, const std::string& cache_path) {
+    // As datas são obtidas antes da leitura, para que uma alteração durante a leitura invalide a forma binária
+    SourceFingerprint config = fingerprintOf(config_path);
+    SourceFingerprint topology = fingerprintOf(topology_path);
 
-    // Verifica se o arquivo foi aberto corretamente
-    if (!file.is_open()) {
-        logMessage(LogType::ERROR, "Erro ao abrir o arquivo de topologia.");
-        return topology; // Retorna um mapa vazio em caso de erro
+    if (!cache_path.empty() && loadCache(cache_path, config, topology, network)) {
+        LOG_MESSAGE(LogType::INFO, "Configuração carregada da forma binária " + cache_path + ".");
+        return true;
     }
 
-    std::string line;
+    if (!parseConfig(config_path, network) || !parseTopology(topology_path, network)) {
+        return false;
+    }
 
-    // Lê cada linha do arquivo
-    while (std::getline(file, line)) {
-        std::stringstream ss(line); // Cria um fluxo de string para processamento
-        int peer_id;
-        char colon; // Variável para capturar o caractere ':' no formato
+    if (!cache_path.empty() && !saveCache(cache_path, config, topology, network)) {
+        LOG_MESSAGE(LogType::INFO, "Não foi possível gravar a forma binária da configuração em " + cache_path + ".");
+    }
+    return true;
+}
 
-        // Lê o ID do peer e o caractere ':'
-        ss >> peer_id >> colon;
 
-        std::vector<int> neighbors; // Vetor para armazenar os vizinhos
-        std::string neighbor_list;
-        
-        // Lê a lista de vizinhos após o caractere ':'
-        std::getline(ss, neighbor_list);
-        std::stringstream ss_neighbors(neighbor_list); // Fluxo de string para processar os vizinhos
-        std::string neighbor;
-    
-        // Lê cada vizinho separado por vírgula
-        while (std::getline(ss_neighbors, neighbor, ',')) {
-            int neighbor_id = std::stoi(neighbor); // Converte o vizinho para inteiro
-            neighbors.push_back(neighbor_id); // Adiciona ao vetor de vizinhos
+/**
+ * @brief Lê as configurações dos peers a partir do arquivo de texto.
+ */
+bool ConfigManager::parseConfig(const std::string& path, NetworkConfig& network) {
+    MappedFile file(path);
+    if (!file.isOpen()) {
+        LOG_MESSAGE(LogType::ERROR, "Erro ao abrir o arquivo de configuração.");
+        return false;
+    }
+
+    struct PeerEntry {
+        int32_t id;
+        uint32_t ip;
+        int32_t udp_port;
+        int32_t speed;
+    };
+    std::vector<PeerEntry> entries;
+
+    // Lê cada linha no formato "<id>: <ip>, <porta UDP>, <velocidade>"
+    LineScanner scanner(file.begin(), file.end());
+    for (; !scanner.done(); scanner.nextLine()) {
+        if (scanner.atLineEnd()) {
+            continue; // Linha em branco
         }
 
-        topology[peer_id] = neighbors; // Mapeia o peer aos seus vizinhos
+        PeerEntry entry;
+        if (!scanner.parseInt(entry.id) || !scanner.expect(':') || !scanner.parseIPv4(entry.ip) || !scanner.expect(',') ||
+            !scanner.parseInt(entry.udp_port) || !scanner.expect(',') || !scanner.parseInt(entry.speed) || !scanner.atLineEnd()) {
+            LOG_MESSAGE(LogType::ERROR, "Linha " + std::to_string(scanner.lineNumber()) + " do arquivo de configuração ignorada: formato inválido.");
+            continue;
+        }
+        entries.push_back(entry);
+    }
+
+    // Ordena pelo ID; em IDs repetidos prevalece a última linha
+    std::stable_sort(entries.begin(), entries.end(), [](const PeerEntry& a, const PeerEntry& b) { return a.id < b.id; });
+    auto last_of_each_id = std::unique(entries.rbegin(), entries.rend(), [](const PeerEntry& a, const PeerEntry& b) { return a.id == b.id; });
+    entries.erase(entries.begin(), last_of_each_id.base());
+
+    size_t peer_count = entries.size();
+    network.peer_ids.resize(peer_count);
+    network.ips.resize(peer_count);
+    network.udp_ports.resize(peer_count);
+    network.transfer_speeds.resize(peer_count);
+    for (size_t i = 0; i < peer_count; ++i) {
+        network.peer_ids[i] = entries[i].id;
+        network.ips[i] = entries[i].ip;
+        network.udp_ports[i] = entries[i].udp_port;
+        network.transfer_speeds[i] = entries[i].speed;
     }
 
-    file.close(); // Fecha o arquivo após a leitura
-    return topology; // Retorna o mapa de topologia
+    // A topologia é preenchida por parseTopology
+    network.in_topology.assign(peer_count, 0);
+    network.neighbor_offsets.assign(peer_count + 1, 0);
+    network.neighbor_indices.clear();
+    return true;
 }
 
 
 /**
- * @brief Expande a topologia com as informações detalhadas da configuração dos peers.
+ * @brief Lê a topologia da rede a partir do arquivo de texto.
  */
-std::map<int, std::vector<std::tuple<std::string, int>>> ConfigManager::expandTopology(
-    const std::map<int, std::vector<int>>& topology, 
-    const std::map<int, std::tuple<std::string, int, int>>& config) 
-{
-    // Mapa que armazenará a topologia expandida com apenas IP e porta UDP
-    std::map<int, std::vector<std::tuple<std::string, int>>> expanded_topology;
-    
-    // Itera sobre cada peer e seus vizinhos na topologia
-    for (const auto& [peer_id, neighbors] : topology) {
-        // Vetor que armazenará os detalhes dos vizinhos (IP, porta UDP)
-        std::vector<std::tuple<std::string, int>> detailed_neighbors;
-
-        // Itera sobre os vizinhos deste peer
-        for (const int& neighbor_id : neighbors) {
-            // Verifica se o vizinho existe na configuração
-            if (config.find(neighbor_id) != config.end()) {
-                // Extrai o IP e a porta do vizinho a partir da configuração
-                auto [neighbor_ip, neighbor_port, _] = config.at(neighbor_id);
-
-                // Adiciona os detalhes do vizinho (IP, porta UDP) ao vetor
-                detailed_neighbors.emplace_back(neighbor_ip, neighbor_port);
-            }
-        }
-        // Associa a lista de vizinhos detalhados a este peer na topologia expandida
-        expanded_topology[peer_id] = detailed_neighbors;
-    }
-
-    // Retorna a topologia expandida com IP e porta
-    return expanded_topology;
+bool ConfigManager::parseTopology(const std::string& path, NetworkConfig& network) {
+    MappedFile file(path);
+    if (!file.isOpen()) {
+        LOG_MESSAGE(LogType::ERROR, "Erro ao abrir o arquivo de topologia.");
+        return false;
+    }
+
+    size_t peer_count = network.peer_ids.size();
+
+    // Arestas (peer, vizinho) em índices, com a linha de origem para tratar peers repetidos
+    struct Edge {
+        int32_t peer;
+        int32_t neighbor;
+        uint32_t line;
+    };
+    std::vector<Edge> edges;
+    std::vector<uint32_t> line_of_peer(peer_count, 0);
+
+    // Lê cada linha no formato "<id>: <vizinho>, <vizinho>, ..."
+    LineScanner scanner(file.begin(), file.end());
+    for (; !scanner.done(); scanner.nextLine()) {
+        if (scanner.atLineEnd()) {
+            continue; // Linha em branco
+        }
+
+        int32_t peer_id;
+        if (!scanner.parseInt(peer_id) || !scanner.expect(':')) {
+            LOG_MESSAGE(LogType::ERROR, "Linha " + std::to_string(scanner.lineNumber()) + " do arquivo de topologia ignorada: formato inválido.");
+            continue;
+        }
+
+        // Peers ausentes da configuração não podem ser usados
+        int peer = network.findPeer(peer_id);
+        if (peer < 0) {
+            continue;
+        }
+        uint32_t line = static_cast<uint32_t>(scanner.lineNumber());
+        line_of_peer[peer] = line;
+        network.in_topology[peer] = 1;
+
+        // Lista de vizinhos separados por vírgula, possivelmente vazia
+        int32_t neighbor_id;
+        while (scanner.parseInt(neighbor_id)) {
+            int neighbor = network.findPeer(neighbor_id);
+            if (neighbor >= 0) {
+                edges.push_back({peer, neighbor, line});
+            }
+            if (!scanner.expect(',')) {
+                break;
+            }
+        }
+
+        if (!scanner.atLineEnd()) {
+            LOG_MESSAGE(LogType::ERROR, "Linha " + std::to_string(line) + " do arquivo de topologia contém caracteres inválidos após os vizinhos.");
+        }
+    }
+
+    // Monta o CSR: conta os vizinhos de cada peer e distribui as arestas na ordem em que foram lidas.
+    // Se um peer aparece em mais de uma linha, prevalece a última, como nas versões anteriores.
+    network.neighbor_offsets.assign(peer_count + 1, 0);
+    size_t neighbor_count = 0;
+    for (const Edge& edge : edges) {
+        if (edge.line == line_of_peer[edge.peer]) {
+            ++network.neighbor_offsets[edge.peer + 1];
+            ++neighbor_count;
+        }
+    }
+    for (size_t i = 0; i < peer_count; ++i) {
+        network.neighbor_offsets[i + 1] += network.neighbor_offsets[i];
+    }
+
+    network.neighbor_indices.assign(neighbor_count, 0);
+    std::vector<uint32_t> next_position(network.neighbor_offsets.begin(), network.neighbor_offsets.end() - 1);
+    for (const Edge& edge : edges) {
+        if (edge.line == line_of_peer[edge.peer]) {
+            network.neighbor_indices[next_position[edge.peer]++] = edge.neighbor;
+        }
+    }
+    return true;
 }
@@ -2,58 +2,112 @@
 #define CONFIGMANAGER_H
 
 #include "Utils.h"
-#include <map>
+#include <cstdint>
 #include <string>
+#include <tuple>
 #include <vector>
 
 
+/**
+ * @brief Estrutura com a configuração dos peers e a topologia da rede em arrays contíguos.
+ *
+ * Cada peer do config.txt ocupa uma posição (índice) nos arrays, em ordem crescente de ID.
+ * A topologia fica em formato CSR: os vizinhos do peer de índice i são os índices em
+ * neighbor_indices[neighbor_offsets[i]] até neighbor_indices[neighbor_offsets[i + 1] - 1].
+ * Vizinhos ausentes do config.txt são descartados durante a leitura.
+ */
+struct NetworkConfig {
+    std::vector<int32_t> peer_ids;          ///< ID de cada peer, em ordem crescente.
+    std::vector<uint32_t> ips;              ///< Endereço IPv4 de cada peer (ordem de bytes de rede).
+    std::vector<int32_t> udp_ports;         ///< Porta UDP de cada peer.
+    std::vector<int32_t> transfer_speeds;   ///< Velocidade de transferência em bytes/segundo de cada peer.
+    std::vector<uint8_t> in_topology;       ///< 1 se o peer possui uma linha no arquivo de topologia.
+    std::vector<uint32_t> neighbor_offsets; ///< Início da lista de vizinhos de cada peer (peer_ids.size() + 1 posições).
+    std::vector<int32_t> neighbor_indices;  ///< Índices dos vizinhos de todos os peers, concatenados.
+
+
+    /**
+     * @brief Busca o índice de um peer pelo seu ID.
+     *
+     * @param peer_id ID do peer.
+     * @return Índice do peer nos arrays ou -1 se ele não está na configuração.
+     */
+    int findPeer(int peer_id) const;
+
+
+    /**
+     * @brief Retorna a configuração de um peer.
+     *
+     * @param index Índice do peer.
+     * @return Tupla com o IP, a porta UDP e a velocidade de transferência em bytes/segundo.
+     */
+    std::tuple<std::string, int, int> getPeer(int index) const;
+
+
+    /**
+     * @brief Expande os vizinhos de um único peer para IP e porta UDP.
+     *
+     * @param index Índice do peer.
+     * @return Lista de tuplas com o IP e a porta UDP de cada vizinho.
+     */
+    std::vector<std::tuple<std::string, int>> getNeighbors(int index) const;
+};
+
+
 /**
  * @brief Classe responsável por carregar as informações dos arquivos topologia.txt e config.txt.
- * 
+ *
  * Esta classe fornece métodos estáticos para carregar as configurações dos peers e a topologia
  * da rede a partir de arquivos. As configurações incluem informações como IP, porta UDP e
  * velocidade de transferência em bytes/segundo para cada peer, enquanto a topologia fornece
  * informações sobre a sua vizinhança.
+ *
+ * Os arquivos de texto são mapeados em memória e lidos em uma única passada, sem streams nem
+ * mapas ordenados. O resultado é gravado em uma forma binária (Constants::CONFIG_CACHE_PATH),
+ * usada nas próximas inicializações enquanto o tamanho e a data de modificação dos arquivos de
+ * texto não mudarem.
  */
 class ConfigManager {
 public:
     /**
-     * @brief Carrega as configurações dos peers a partir do arquivo.
-     * 
-     * Este método lê um arquivo de configuração e retorna um mapa onde cada chave é o identificador 
-     * de um peer e o valor é uma tupla contendo o IP, porta UDP e velocidade de transferência em bytes/segundo desse peer.
-     * 
-     * @return Mapa com as configurações de cada peer.
+     * @brief Carrega a configuração e a topologia da rede, usando a forma binária quando válida.
+     *
+     * @param network Estrutura que recebe a configuração.
+     * @param config_path Caminho do arquivo de configuração.
+     * @param topology_path Caminho do arquivo de topologia.
+     * @param cache_path Caminho da forma binária (vazio: não usa nem grava a forma binária).
+     * @return true se os dois arquivos foram carregados.
      */
-    static std::map<int, std::tuple<std::string, int, int>> loadConfig();
+    static bool loadNetwork(NetworkConfig& network,
+                            const std::string& config_path = Constants::CONFIG_PATH,
+                            const std::string& topology_path = Constants::TOPOLOGY_PATH,
+                            const std::string& cache_path = Constants::CONFIG_CACHE_PATH);
 
 
     /**
-     * @brief Carrega a topologia da rede a partir do arquivo.
-     * 
-     * Este método lê um arquivo de topologia e constrói um mapa onde cada chave é o identificador 
-     * de um peer e o valor é um vetor contendo os identificadores dos seus vizinhos.
-     * 
-     * @return Mapa com a topologia (vizinhos de cada peer).
+     * @brief Lê as configurações dos peers a partir do arquivo de texto.
+     *
+     * Cada linha tem o formato "<id>: <ip>, <porta UDP>, <velocidade>". Linhas mal formadas são
+     * ignoradas e registradas no log. Preenche os arrays dos peers de network, em ordem de ID.
+     *
+     * @param path Caminho do arquivo de configuração.
+     * @param network Estrutura que recebe os peers.
+     * @return true se o arquivo foi aberto.
      */
-    static std::map<int, std::vector<int>> loadTopology();
+    static bool parseConfig(const std::string& path, NetworkConfig& network);
 
 
     /**
-     * @brief Expande a topologia com as informações detalhadas da configuração dos peers.
-     * 
-     * Este método combina a topologia da rede com as informações de configuração de cada peer, 
-     * criando um mapa que associa cada peer a uma lista de tuplas, onde cada tupla contém o IP 
-     * e a porta de comunicação UDP dos seus vizinhos.
-     * 
-     * @param topology Mapa da topologia da rede.
-     * @param config Mapa de configuração dos peers (IP, porta UDP, velocidade em bytes/segundo).
-     * @return Topologia detalhada com as informações dos peers.
+     * @brief Lê a topologia da rede a partir do arquivo de texto.
+     *
+     * Cada linha tem o formato "<id>: <vizinho>, <vizinho>, ...". Deve ser chamado após
+     * parseConfig, pois os vizinhos são convertidos para os índices dos peers.
+     *
+     * @param path Caminho do arquivo de topologia.
+     * @param network Estrutura com os peers já carregados, que recebe a topologia.
+     * @return true se o arquivo foi aberto.
      */
-    static std::map<int, std::vector<std::tuple<std::string, int>>> expandTopology(
-        const std::map<int, std::vector<int>>& topology, 
-        const std::map<int, std::tuple<std::string, int, int>>& config
-    );
+    static bool parseTopology(const std::string& path, NetworkConfig& network);
 };
 
 #endif // CONFIGMANAGER_H
@@ -9,6 +9,9 @@ namespace Constants {
     const std::string BASE_PATH = "./src/";                         ///< Caminho base onde os arquivos do projeto estão armazenados.
     const std::string CONFIG_PATH = BASE_PATH + "config.txt";       ///< Caminho para o arquivo de configuração.
     const std::string TOPOLOGY_PATH = BASE_PATH + "topologia.txt";  ///< Caminho para o arquivo de topologia.
+    const std::string CONFIG_CACHE_PATH = BASE_PATH + "config.cache"; ///< Caminho da forma binária da configuração e da topologia, regenerada quando os arquivos de texto mudam.
+    const std::string CONTROL_SOCKET_PATH_PREFIX = BASE_PATH + "peer"; ///< Prefixo do caminho do socket de controle do modo daemon (seguido do ID do peer e ".sock").
+    const std::string DOWNLOAD_JOURNAL_FILE_NAME = "downloads.journal"; ///< Nome do diário dos downloads em andamento, no diretório de cada peer.
 
     // Cores para log
     const std::string RESET   = "\033[0m";                          ///< Resetar a cor do texto para branco.
@@ -29,9 +32,75 @@ namespace Constants {
     const int DISCOVERY_MESSAGE_INTERVAL_SECONDS = 1;               ///< Tempo de espera em segundos antes de enviar uma mensagem de descoberta para outro vizinho.
     const int SERVER_STARTUP_DELAY_SECONDS       = 5;               ///< Tempo de espera em segundos para inicialização dos servidores.
     const int RESPONSE_TIMEOUT_SECONDS           = 10;              ///< Tempo limite para receber resposta em segundos.
+    const int TRANSFER_BLOCK_INTERVAL_SECONDS    = 1;               ///< Tempo de espera em segundos entre blocos de transfer_speed bytes, simulando a velocidade de transferência.
     const int WAIT_TIME_FOR_PORTS_RELEASE_SECONDS= 5;               ///< Tempo de espera em segundos para esperar liberação das portas TCP e UDP.
     const int CONTROL_MESSAGE_MAX_SIZE           = 1024;            ///< Tamanho máximo da mensagem de controle.
     const int TCP_MAX_PENDING_CONNECTIONS        = 10;              ///< Número máximo de conexões pendentes na fila de escuta TCP.
+    const int MAX_ACTIVE_DOWNLOADS               = 4;               ///< Número máximo de downloads ativos ao mesmo tempo; os demais aguardam na fila.
+    const int DOWNLOAD_EXECUTOR_THREADS          = 2;               ///< Número de threads do executor das etapas bloqueantes dos downloads.
+    const int SCHEDULER_TICK_MILLISECONDS        = 200;             ///< Intervalo em milissegundos entre as verificações do escalonador de downloads.
+    const int DOWNLOAD_STALL_TIMEOUT_SECONDS     = 120;             ///< Tempo em segundos sem novos chunks após o qual os chunks faltantes são buscados novamente.
+    const int DOWNLOAD_MAX_DISCOVERY_ATTEMPTS    = 3;               ///< Número máximo de rodadas de descoberta por download antes de considerá-lo falho.
+    const int CONTENT_DISCOVERY_MAX_CHUNKS       = 16;              ///< Número máximo de chunks sem detentor buscados pelo nome de conteúdo em cada nova rodada de descoberta de um download.
+    const int LOG_RING_CAPACITY                  = 256;             ///< Capacidade do buffer de mensagens de log de cada thread.
+    const int LOG_WRITER_IDLE_MILLISECONDS       = 5;               ///< Tempo de espera em milissegundos da thread escritora de log quando não há mensagens.
+    const size_t METRICS_MAX_PENDING_TIMERS      = 4096;            ///< Número de intervalos em medição a partir do qual os intervalos expirados são descartados.
+    const int METRICS_TIMER_EXPIRATION_SECONDS   = 600;             ///< Tempo em segundos após o qual um intervalo não encerrado é descartado.
+    const size_t METRICS_MAX_CACHED_LABELS       = 4096;            ///< Número de peers remotos com rótulos de métricas guardados por thread, a partir do qual o cache da thread é descartado.
+    const int METRICS_SNAPSHOT_INTERVAL_SECONDS  = 5;               ///< Intervalo em segundos entre as gravações do snapshot de métricas em arquivo.
+    const int HEARTBEAT_INTERVAL_SECONDS         = 2;               ///< Intervalo em segundos entre os heartbeats enviados aos vizinhos.
+    const int NEIGHBOR_TIMEOUT_SECONDS           = 10;              ///< Tempo em segundos sem mensagens de um vizinho após o qual ele é considerado morto e removido.
+    const int MEMBERSHIP_TARGET_DEGREE           = 4;               ///< Número de vizinhos que o peer procura manter, pedindo novos peers quando está abaixo dele.
+    const int MEMBERSHIP_MAX_DEGREE              = 8;               ///< Número máximo de vizinhos; pedidos de vizinhança acima dele são recusados com LEAVE.
+    const int MEMBERSHIP_PEERS_SAMPLE            = 8;               ///< Número máximo de endereços enviados em uma mensagem PEERS.
+    const size_t MEMBERSHIP_MAX_CANDIDATES       = 32;              ///< Número máximo de peers candidatos a vizinho guardados a partir das mensagens PEERS.
+    const int DHT_BUCKET_SIZE                    = 8;               ///< Número de contatos por k-bucket da DHT e de nós que recebem cada registro (k do Kademlia).
+    const int DHT_LOOKUP_PARALLELISM             = 3;               ///< Número de consultas simultâneas em uma busca iterativa da DHT (alfa do Kademlia).
+    const int DHT_CHUNK_RANGE_SIZE               = 16;              ///< Número de chunks consecutivos agrupados em uma mesma chave da DHT.
+    const int DHT_MAX_RECORDS_PER_KEY            = 32;              ///< Número máximo de detentores guardados para uma mesma chave da DHT.
+    const int DHT_PUBLISH_INTERVAL_SECONDS       = 2;               ///< Intervalo em segundos entre as verificações de chunks novos a publicar na DHT.
+    const int DHT_REPUBLISH_INTERVAL_SECONDS     = 30;              ///< Intervalo em segundos após o qual os registros do peer são publicados novamente na DHT.
+    const int DHT_RECORD_TTL_SECONDS             = 90;              ///< Tempo em segundos após o qual um registro não republicado é descartado.
+    const int DHT_RPC_TIMEOUT_MILLISECONDS       = 1000;            ///< Prazo em milissegundos para a resposta de uma consulta da DHT.
+    const int AVAILABILITY_CACHE_TTL_SECONDS     = 60;              ///< Tempo em segundos após o qual os chunks conhecidos de outro peer deixam de ser reaproveitados.
+    const size_t AVAILABILITY_CACHE_MAX_ENTRIES  = 1024;            ///< Número máximo de pares arquivo e peer guardados no cache de disponibilidade.
+    const size_t RESPONSE_CACHE_MAX_FILES        = 256;             ///< Número máximo de arquivos com a mensagem RESPONSE montada em cache.
+    const int HAVE_INTERVAL_MILLISECONDS         = 500;             ///< Intervalo em milissegundos entre os anúncios HAVE dos chunks recém-salvos.
+    const int HAVE_INTEREST_TTL_SECONDS          = 60;              ///< Tempo em segundos após a última descoberta durante o qual o solicitante recebe anúncios HAVE.
+    const size_t HAVE_MAX_INTERESTS              = 1024;            ///< Número máximo de pares arquivo e peer interessado guardados para os anúncios HAVE.
+    const int UPLOAD_SLOTS                       = 4;               ///< Número de envios de chunks simultâneos (vagas de upload).
+    const int UPLOAD_QUANTUM_BYTES               = 4096;            ///< Crédito em bytes que cada solicitante recebe a cada vez na rodada de envios (deficit round robin).
+    const size_t UPLOAD_MAX_QUEUED_CHUNKS_PER_PEER = 4096;          ///< Número máximo de chunks na fila de envio de um solicitante; os pedidos além dele são recusados.
+    const bool UPLOAD_TIT_FOR_TAT                = true;            ///< Indica se os peers que enviaram chunks ao peer recebem crédito maior na rodada de envios.
+    const int UPLOAD_RECIPROCATION_WEIGHT        = 2;               ///< Multiplicador do crédito dos peers que enviaram chunks ao peer recentemente.
+    const int UPLOAD_RECIPROCATION_WINDOW_SECONDS= 30;              ///< Tempo em segundos após o último chunk recebido de um peer durante o qual ele tem crédito maior.
+    const size_t TRANSFER_READ_AHEAD_CHUNKS      = 4;               ///< Número de chunks lidos do disco antecipadamente enquanto o chunk atual é enviado.
+    const size_t PERSIST_MAX_PENDING_BYTES       = 64 << 20;        ///< Número de bytes de chunks recebidos aguardando gravação a partir do qual a leitura da conexão espera.
+    const size_t TRANSFER_MAX_CHUNK_BYTES        = 64 << 20;        ///< Tamanho máximo em bytes de um chunk recebido sem resumo no .p2p; um PUT maior é recusado.
+    const int TRANSFER_READ_THREADS              = 4;               ///< Número de threads que fazem as leituras antecipadas dos chunks enviados.
+    const size_t COMPRESSION_MIN_CHUNK_BYTES     = 4 << 10;         ///< Tamanho mínimo em bytes de um chunk comprimido na transferência; os menores seguem sem compressão.
+    const int COMPRESSION_SAMPLE_BLOCKS          = 4;               ///< Número de blocos de um chunk comprimidos com LZ4 para estimar a sua razão de compressão.
+    const size_t COMPRESSION_SAMPLE_BLOCK_BYTES  = 4 << 10;         ///< Tamanho em bytes de cada bloco amostrado.
+    const double COMPRESSION_MAX_SAMPLED_RATIO   = 0.9;             ///< Razão de compressão amostrada acima da qual o chunk é considerado incompressível e segue sem compressão.
+    const int COMPRESSION_ZSTD_LEVEL             = 3;               ///< Nível de compressão do zstd (o padrão da libzstd).
+    const double COMPRESSION_ZSTD_MAX_LINK_BYTES_PER_SECOND = 64 << 20; ///< Velocidade de enlace em bytes por segundo abaixo da qual a política auto usa zstd em vez de LZ4.
+    const int DOWNLOAD_JOURNAL_FLUSH_MILLISECONDS= 1000;            ///< Intervalo em milissegundos entre as gravações do diário de downloads, quando ele mudou.
+    const size_t DOWNLOAD_RESUME_MIN_CHUNK_BYTES = 1 << 20;         ///< Tamanho mínimo em bytes de um chunk gravado em partes durante o recebimento, para ser retomado após um reinício.
+    const size_t DOWNLOAD_RESUME_BLOCK_BYTES     = 256 << 10;       ///< Tamanho em bytes dos blocos de um chunk gravados no arquivo parcial (.part) durante o recebimento.
+    const int IO_THREADS                         = 8;               ///< Número padrão de conexões TCP recebidas ao mesmo tempo, cada uma em uma thread do executor compartilhado (--io-threads).
+    const int WORKER_THREADS                     = 4;               ///< Número padrão de threads do executor compartilhado reservadas às mensagens UDP, gravações e montagens (--worker-threads).
+    const size_t NUMA_BIND_MIN_BYTES             = 64 << 10;        ///< Tamanho mínimo em bytes de um buffer do BufferPool ligado ao nó NUMA da thread (mbind) em máquinas com mais de um nó.
+    const size_t IO_BLOCK_SIZE                   = 32 << 10;        ///< Tamanho em bytes dos blocos das leituras e gravações de arquivos pelo IOEngine.
+    const int IO_URING_QUEUE_DEPTH               = 8;               ///< Número de entradas do anel io_uring de cada thread (blocos submetidos por chamada).
+    const size_t BUFFER_POOL_MIN_CLASS_BYTES     = 1 << 10;         ///< Capacidade da menor classe de buffers do BufferPool (datagramas).
+    const size_t BUFFER_POOL_MAX_CLASS_BYTES     = 4 << 20;         ///< Capacidade da maior classe de buffers do BufferPool; buffers maiores não são reaproveitados.
+    const size_t BUFFER_POOL_MAX_CACHED_BYTES    = 32 << 20;        ///< Número máximo de bytes guardados para reaproveitamento em cada classe do BufferPool.
+    const size_t BUFFER_POOL_MAX_CACHED_BLOCKS   = 256;             ///< Número máximo de buffers guardados para reaproveitamento em cada classe do BufferPool.
+    const int ERASURE_MAX_CHUNKS                 = 256;             ///< Número máximo de chunks (dados e paridade) de um arquivo com codificação de apagamento (limite de GF(2^8)).
+    const size_t ERASURE_BLOCK_SIZE              = 64 << 10;        ///< Tamanho em bytes das faixas lidas de cada chunk ao codificar e reconstruir arquivos com codificação de apagamento.
+    const int PUBLISH_DEFAULT_TTL                = 3;               ///< TTL gravado nos arquivos .p2p criados ao publicar um arquivo.
+    const size_t PUBLISH_DEFAULT_CHUNK_SIZE      = 256 << 10;       ///< Tamanho (fixo) ou tamanho médio (CDC) padrão dos chunks gerados pelo p2p-publish.
+    const size_t PUBLISH_MAX_PENDING_BYTES       = 64 << 20;        ///< Número máximo de bytes de chunks lidos e ainda não resumidos e gravados pelo p2p-publish.
 }
 
 #endif // CONSTANTS_H
@@ -0,0 +1,227 @@
+#include "ControlServer.h"
+#include "Metrics.h"
+#include "Peer.h"
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <cstdlib>
+#include <cstring>
+#include <sstream>
+#include <thread>
+
+
+/**
+ * @brief Construtor da classe ControlServer.
+ */
+ControlServer::ControlServer(const std::string& socket_path, Peer& peer)
+    : socket_path(socket_path), server_sockfd(-1), peer(peer) {}
+
+
+/**
+ * @brief Inicia o servidor de controle.
+ */
+void ControlServer::run() {
+    initializeControlSocket();
+
+    while (true) {
+        // Aceita a conexão de um cliente de controle
+        int client_sockfd = accept(server_sockfd, nullptr, nullptr);
+
+        if (client_sockfd >= 0) {
+            // Cria uma thread para tratar o comando sem bloquear novas conexões
+            std::thread(&ControlServer::handleClient, this, client_sockfd).detach();
+        } else {
+            perror("Erro ao aceitar conexão de controle");
+        }
+    }
+}
+
+
+/**
+ * @brief Cria o socket de domínio Unix e o coloca em modo de escuta.
+ */
+void ControlServer::initializeControlSocket() {
+    // Cria um socket de domínio Unix orientado a conexão
+    if ((server_sockfd = socket(AF_UNIX, SOCK_STREAM, 0)) < 0) {
+        perror("Falha ao criar socket de controle");
+        exit(EXIT_FAILURE);
+    }
+
+    // Configura o endereço do socket com o caminho no sistema de arquivos
+    struct sockaddr_un addr{};
+    addr.sun_family = AF_UNIX;
+    std::strncpy(addr.sun_path, socket_path.c_str(), sizeof(addr.sun_path) - 1);
+
+    // Remove um socket que tenha sobrado de uma execução anterior
+    unlink(socket_path.c_str());
+
+    // Associa o socket ao caminho especificado
+    if (bind(server_sockfd, (struct sockaddr*)&addr, sizeof(addr)) < 0) {
+        perror("Erro ao fazer bind no socket de controle");
+        exit(EXIT_FAILURE);
+    }
+
+    // Coloca o socket em modo de escuta
+    if (listen(server_sockfd, Constants::TCP_MAX_PENDING_CONNECTIONS) < 0) {
+        perror("Erro ao escutar no socket de controle");
+        exit(EXIT_FAILURE);
+    }
+
+    LOG_MESSAGE(LogType::INFO, "Servidor de controle inicializado em " + socket_path);
+}
+
+
+/**
+ * @brief Lê o comando enviado por um cliente, executa-o e envia a resposta.
+ */
+void ControlServer::handleClient(int client_sockfd) {
+    std::string command_line;
+    char buffer[Constants::CONTROL_MESSAGE_MAX_SIZE];
+
+    // Lê até encontrar o fim da linha ou até o cliente fechar o lado de escrita
+    while (command_line.find('\n') == std::string::npos && command_line.size() < Constants::CONTROL_MESSAGE_MAX_SIZE) {
+        ssize_t bytes_received = recv(client_sockfd, buffer, sizeof(buffer), 0);
+        if (bytes_received <= 0) {
+            break;
+        }
+        command_line.append(buffer, bytes_received);
+    }
+
+    // Descarta o que vier depois da primeira linha
+    command_line = trim(command_line.substr(0, command_line.find('\n')));
+
+    LOG_MESSAGE(LogType::INFO, "Comando de controle recebido: " + command_line);
+
+    std::string response = processCommand(command_line);
+
+    // Envia a resposta completa ao cliente
+    size_t total_bytes_sent = 0;
+    while (total_bytes_sent < response.size()) {
+        ssize_t bytes_sent = send(client_sockfd, response.c_str() + total_bytes_sent, response.size() - total_bytes_sent, 0);
+        if (bytes_sent <= 0) {
+            perror("Erro ao enviar resposta de controle");
+            break;
+        }
+        total_bytes_sent += bytes_sent;
+    }
+
+    close(client_sockfd);
+
+    // Após anunciar a saída, o peer termina sem destruir os servidores ainda usados pelas outras threads
+    if (command_line == "LEAVE") {
+        unlink(socket_path.c_str());
+        Logger::instance().flush();
+        std::_Exit(EXIT_SUCCESS);
+    }
+}
+
+
+/**
+ * @brief Interpreta e executa uma linha de comando.
+ */
+std::string ControlServer::processCommand(const std::string& command_line) {
+    std::stringstream ss(command_line);
+    std::string command, file_name;
+    int priority = 0;
+    ss >> command >> file_name >> priority;
+
+    if (command == "DOWNLOAD") {
+        if (file_name.empty()) {
+            return "ERROR Uso: DOWNLOAD <file_name> [priority]\n";
+        }
+        if (!peer.submitDownload(file_name, priority)) {
+            return "ERROR Busca de " + file_name + " já está em andamento.\n";
+        }
+        return "OK Download de " + file_name + " registrado.\n";
+    } else if (command == "CANCEL") {
+        if (file_name.empty()) {
+            return "ERROR Uso: CANCEL <file_name>\n";
+        }
+        if (!peer.cancelDownload(file_name)) {
+            return "ERROR Nenhum download em andamento para " + file_name + ".\n";
+        }
+        return "OK Download de " + file_name + " cancelado.\n";
+    } else if (command == "STATUS") {
+        std::stringstream response;
+        auto downloads = peer.getDownloadsStatus();
+
+        response << "OK " << downloads.size() << " download(s)\n";
+        for (const auto& download : downloads) {
+            response << download.file_name << " " << DownloadScheduler::stateToString(download.state) << " "
+                     << download.chunks_available << "/" << download.total_chunks
+                     << " priority=" << download.priority << "\n";
+        }
+        return response.str();
+    } else if (command == "LOG_LEVEL") {
+        // O segundo token é o nível de log
+        LogLevel level;
+        if (!Logger::parseLevel(file_name, level)) {
+            return "ERROR Uso: LOG_LEVEL <error|info|debug|trace>\n";
+        }
+        Logger::instance().setLevel(level);
+        return "OK Nível de log alterado para " + file_name + ".\n";
+    } else if (command == "METRICS") {
+        // Snapshot das métricas em JSON, em uma única linha
+        return "OK " + Metrics::instance().snapshotJSON();
+    } else if (command == "NEIGHBORS") {
+        std::stringstream response;
+        auto neighbors = peer.getNeighbors();
+
+        response << "OK " << neighbors.size() << " vizinho(s)\n";
+        for (const auto& [neighbor_ip, neighbor_port] : neighbors) {
+            response << neighbor_ip << ":" << neighbor_port << "\n";
+        }
+        return response.str();
+    } else if (command == "LEAVE") {
+        peer.leave();
+        return "OK Saída anunciada aos vizinhos. Encerrando o peer.\n";
+    }
+
+    return "ERROR Comando desconhecido: " + command + "\n";
+}
+
+
+/**
+ * @brief Envia um comando para um peer em modo daemon e retorna a resposta.
+ */
+std::string ControlServer::sendCommand(const std::string& socket_path, const std::string& command_line) {
+    int sockfd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (sockfd < 0) {
+        return "ERROR Falha ao criar socket de controle.\n";
+    }
+
+    struct sockaddr_un addr{};
+    addr.sun_family = AF_UNIX;
+    std::strncpy(addr.sun_path, socket_path.c_str(), sizeof(addr.sun_path) - 1);
+
+    if (connect(sockfd, (struct sockaddr*)&addr, sizeof(addr)) < 0) {
+        close(sockfd);
+        return "ERROR Não foi possível conectar ao peer em " + socket_path + ". Verifique se ele está em modo daemon.\n";
+    }
+
+    // Envia o comando terminado em fim de linha
+    std::string message = command_line + "\n";
+    if (send(sockfd, message.c_str(), message.size(), 0) < 0) {
+        close(sockfd);
+        return "ERROR Falha ao enviar o comando.\n";
+    }
+
+    // Lê a resposta até o peer fechar a conexão
+    std::string response;
+    char buffer[Constants::CONTROL_MESSAGE_MAX_SIZE];
+    ssize_t bytes_received;
+    while ((bytes_received = recv(sockfd, buffer, sizeof(buffer), 0)) > 0) {
+        response.append(buffer, bytes_received);
+    }
+
+    close(sockfd);
+    return response;
+}
+
+
+/**
+ * @brief Retorna o caminho do socket de controle de um peer.
+ */
+std::string ControlServer::getSocketPath(int peer_id) {
+    return Constants::CONTROL_SOCKET_PATH_PREFIX + std::to_string(peer_id) + ".sock";
+}
@@ -0,0 +1,98 @@
+#ifndef CONTROLSERVER_H
+#define CONTROLSERVER_H
+
+#include "Utils.h"
+#include <string>
+
+class Peer;
+
+
+/**
+ * @brief Classe responsável pelo socket de controle local do peer em modo daemon.
+ *
+ * Esta classe abre um socket de domínio Unix por onde comandos de texto podem ser
+ * enviados ao peer enquanto ele está em execução. Cada conexão envia uma única linha
+ * de comando e recebe a resposta em texto antes de ser encerrada. Os comandos aceitos são:
+ *
+ *  - DOWNLOAD <file_name> [priority]: registra a busca de um arquivo no escalonador de downloads.
+ *  - CANCEL <file_name>: cancela a busca de um arquivo em andamento.
+ *  - STATUS: lista o estado de todos os downloads conhecidos pelo peer.
+ *  - LOG_LEVEL <level>: altera o nível de log (error, info, debug, trace) em tempo de execução.
+ *  - METRICS: retorna o snapshot das métricas do peer em JSON.
+ *  - NEIGHBORS: lista os vizinhos atuais do peer.
+ *  - LEAVE: anuncia a saída do peer aos vizinhos e encerra o processo após responder.
+ *
+ * Todos os comandos compartilham o FileManager e os servidores UDP e TCP já abertos pelo Peer.
+ */
+class ControlServer {
+private:
+    const std::string socket_path;                          ///< Caminho do socket de domínio Unix no sistema de arquivos.
+    int server_sockfd;                                      ///< Socket de escuta para conexões de controle.
+    Peer& peer;                                             ///< Referência ao peer que executa os comandos recebidos.
+
+public:
+    /**
+     * @brief Construtor da classe ControlServer.
+     *
+     * @param socket_path Caminho do socket de domínio Unix.
+     * @param peer Referência ao peer que executa os comandos.
+     */
+    ControlServer(const std::string& socket_path, Peer& peer);
+
+
+    /**
+     * @brief Inicia o servidor de controle.
+     *
+     * Cria o socket de domínio Unix e entra no loop que aceita conexões de controle,
+     * tratando um comando por conexão.
+     */
+    void run();
+
+
+    /**
+     * @brief Cria o socket de domínio Unix e o coloca em modo de escuta.
+     *
+     * Um socket antigo que tenha ficado no mesmo caminho é removido antes do bind.
+     */
+    void initializeControlSocket();
+
+
+    /**
+     * @brief Lê o comando enviado por um cliente, executa-o e envia a resposta.
+     *
+     * @param client_sockfd Socket do cliente conectado.
+     */
+    void handleClient(int client_sockfd);
+
+
+    /**
+     * @brief Interpreta e executa uma linha de comando.
+     *
+     * @param command_line Linha de comando recebida (ex: "DOWNLOAD image.png").
+     * @return Resposta em texto, iniciada por "OK" ou "ERROR".
+     */
+    std::string processCommand(const std::string& command_line);
+
+
+    /**
+     * @brief Envia um comando para um peer em modo daemon e retorna a resposta.
+     *
+     * Usado pelo modo cliente do executável para falar com um peer já em execução.
+     *
+     * @param socket_path Caminho do socket de controle do peer.
+     * @param command_line Linha de comando a ser enviada.
+     * @return Resposta do peer ou mensagem de erro caso não seja possível conectar.
+     */
+    static std::string sendCommand(const std::string& socket_path, const std::string& command_line);
+
+
+    /**
+     * @brief Retorna o caminho do socket de controle de um peer.
+     *
+     * @param peer_id ID do peer.
+     * @return Caminho do socket de controle.
+     */
+    static std::string getSocketPath(int peer_id);
+};
+
+#endif // CONTROLSERVER_H
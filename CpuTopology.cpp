@@ -0,0 +1,353 @@
+#include "CpuTopology.h"
+#include <linux/mempolicy.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <sstream>
+
+
+namespace {
+    // Diretório com um subdiretório nodeN por nó NUMA, cada um com a lista dos seus núcleos (cpulist)
+    const std::string SYSFS_NODE_PATH = "/sys/devices/system/node/";
+
+    // Modelo de threads dos peers criados a seguir
+    std::mutex default_config_mutex;
+    ThreadingConfig default_config;
+
+    // Índice do nó da thread atual, conhecido quando ela foi fixada nos núcleos de um único nó (-1: desconhecido)
+    thread_local int current_thread_node = -1;
+
+
+    /**
+     * @brief Lê uma lista de núcleos no formato do sysfs (ex: "0-3,8-11").
+     */
+    std::vector<int> parseCpuList(const std::string& text) {
+        std::vector<int> result;
+        std::stringstream ranges(text);
+        std::string range;
+        while (std::getline(ranges, range, ',')) {
+            int first = 0, last = 0;
+            size_t dash_pos = range.find('-');
+            try {
+                first = std::stoi(range.substr(0, dash_pos));
+                last = dash_pos != std::string::npos ? std::stoi(range.substr(dash_pos + 1)) : first;
+            } catch (const std::exception&) {
+                continue;
+            }
+            for (int cpu = first; cpu <= last; ++cpu) {
+                result.push_back(cpu);
+            }
+        }
+        return result;
+    }
+
+
+    /**
+     * @brief Monta o conjunto de núcleos da afinidade de uma thread.
+     */
+    cpu_set_t makeCpuSet(const std::vector<int>& cpus) {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        for (int cpu : cpus) {
+            if (cpu >= 0 && cpu < CPU_SETSIZE) {
+                CPU_SET(cpu, &set);
+            }
+        }
+        return set;
+    }
+}
+
+
+/**
+ * @brief Retorna os núcleos em que uma thread pode executar.
+ */
+std::vector<int> ThreadPlacement::cpusFor(ThreadRole role, int index) const {
+    const std::vector<int>& role_cpus = role == ThreadRole::IO ? io_cpus : worker_cpus;
+    if (pinning == PinningMode::OFF || role_cpus.empty()) {
+        return {};
+    }
+    if (pinning == PinningMode::NUMA) {
+        return role_cpus;
+    }
+    return {role_cpus[static_cast<size_t>(std::max(0, index)) % role_cpus.size()]};
+}
+
+
+/**
+ * @brief Construtor da classe CpuTopology. Lê os núcleos permitidos e os nós NUMA.
+ */
+CpuTopology::CpuTopology() {
+    cpu_set_t allowed;
+    CPU_ZERO(&allowed);
+    if (sched_getaffinity(0, sizeof(allowed), &allowed) != 0) {
+        // Sem a afinidade do processo, considera todos os núcleos ativos
+        CPU_ZERO(&allowed);
+        for (long cpu = 0; cpu < std::min<long>(sysconf(_SC_NPROCESSORS_ONLN), CPU_SETSIZE); ++cpu) {
+            CPU_SET(cpu, &allowed);
+        }
+    }
+
+    // Lê os núcleos de cada nó, na ordem dos números dos nós
+    std::vector<std::pair<int, std::vector<int>>> nodes;
+    std::error_code error;
+    for (const auto& entry : std::filesystem::directory_iterator(SYSFS_NODE_PATH, error)) {
+        std::string name = entry.path().filename().string();
+        if (name.rfind("node", 0) != 0 || name.size() == 4 || !std::all_of(name.begin() + 4, name.end(), ::isdigit)) {
+            continue;
+        }
+
+        std::ifstream cpulist_file(entry.path() / "cpulist");
+        std::string cpulist;
+        std::getline(cpulist_file, cpulist);
+
+        // Só entram os núcleos permitidos ao processo; nós sem nenhum deles são ignorados
+        std::vector<int> allowed_cpus;
+        for (int cpu : parseCpuList(cpulist)) {
+            if (cpu < CPU_SETSIZE && CPU_ISSET(cpu, &allowed)) {
+                allowed_cpus.push_back(cpu);
+            }
+        }
+        if (!allowed_cpus.empty()) {
+            nodes.emplace_back(std::stoi(name.substr(4)), std::move(allowed_cpus));
+        }
+    }
+    std::sort(nodes.begin(), nodes.end());
+
+    // Sem o sysfs, todos os núcleos permitidos formam um único nó
+    if (nodes.empty()) {
+        std::vector<int> allowed_cpus;
+        for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+            if (CPU_ISSET(cpu, &allowed)) {
+                allowed_cpus.push_back(cpu);
+            }
+        }
+        nodes.emplace_back(0, std::move(allowed_cpus));
+    }
+
+    for (auto& [node_id, node_cpu_list] : nodes) {
+        for (int cpu : node_cpu_list) {
+            if (cpu >= static_cast<int>(cpu_nodes.size())) {
+                cpu_nodes.resize(cpu + 1, -1);
+            }
+            cpu_nodes[cpu] = static_cast<int>(node_ids.size());
+            cpus.push_back(cpu);
+        }
+        node_ids.push_back(node_id);
+        node_cpus.push_back(std::move(node_cpu_list));
+    }
+}
+
+
+/**
+ * @brief Retorna a topologia da máquina, lida uma única vez.
+ */
+CpuTopology& CpuTopology::instance() {
+    // Nunca é destruída, pois threads destacadas podem consultá-la até o fim do processo
+    static CpuTopology* topology = new CpuTopology();
+    return *topology;
+}
+
+
+/**
+ * @brief Retorna o número de núcleos permitidos ao processo.
+ */
+int CpuTopology::cpuCount() const {
+    return static_cast<int>(cpus.size());
+}
+
+
+/**
+ * @brief Retorna o número de nós NUMA com núcleos permitidos.
+ */
+int CpuTopology::nodeCount() const {
+    return static_cast<int>(node_ids.size());
+}
+
+
+/**
+ * @brief Retorna o índice do nó de um núcleo.
+ */
+int CpuTopology::nodeOfCpu(int cpu) const {
+    if (cpu < 0 || cpu >= static_cast<int>(cpu_nodes.size()) || cpu_nodes[cpu] < 0) {
+        return 0;
+    }
+    return cpu_nodes[cpu];
+}
+
+
+/**
+ * @brief Distribui as threads de um peer pelos núcleos.
+ */
+ThreadPlacement CpuTopology::place(int peer_index, const ThreadingConfig& config) const {
+    ThreadPlacement placement;
+    placement.pinning = cpus.empty() ? PinningMode::OFF : config.pinning;
+    int io_threads = std::max(1, config.io_threads);
+    int worker_threads = std::max(1, config.worker_threads);
+    peer_index = std::max(0, peer_index);
+
+    if (placement.pinning == PinningMode::CORES) {
+        // Os núcleos estão agrupados por nó, então a faixa de um peer tende a ficar em um único nó
+        size_t first = static_cast<size_t>(peer_index) * static_cast<size_t>(io_threads + worker_threads);
+        for (int i = 0; i < io_threads + worker_threads; ++i) {
+            int cpu = cpus[(first + i) % cpus.size()];
+            (i < io_threads ? placement.io_cpus : placement.worker_cpus).push_back(cpu);
+        }
+        placement.node = nodeOfCpu(placement.io_cpus.front());
+    } else if (placement.pinning == PinningMode::NUMA) {
+        placement.node = peer_index % nodeCount();
+        placement.io_cpus = node_cpus[placement.node];
+        placement.worker_cpus = node_cpus[placement.node];
+    }
+    return placement;
+}
+
+
+/**
+ * @brief Fixa a thread atual em um conjunto de núcleos.
+ */
+bool CpuTopology::pinCurrentThread(const std::vector<int>& cpus) {
+    if (cpus.empty()) {
+        return true;
+    }
+
+    cpu_set_t set = makeCpuSet(cpus);
+    if (sched_setaffinity(0, sizeof(set), &set) != 0) {
+        perror("Erro ao fixar a thread nos núcleos");
+        return false;
+    }
+
+    // Núcleos de um único nó: a thread passa a alocar os buffers nesse nó sem consultar o núcleo atual
+    CpuTopology& topology = instance();
+    int node = topology.nodeOfCpu(cpus.front());
+    bool single_node = std::all_of(cpus.begin(), cpus.end(), [&](int cpu) { return topology.nodeOfCpu(cpu) == node; });
+    current_thread_node = single_node ? node : -1;
+    return true;
+}
+
+
+/**
+ * @brief Fixa uma thread já criada em um conjunto de núcleos.
+ */
+bool CpuTopology::pinThread(std::thread& thread, const std::vector<int>& cpus) {
+    if (cpus.empty() || !thread.joinable()) {
+        return true;
+    }
+
+    cpu_set_t set = makeCpuSet(cpus);
+    int error = pthread_setaffinity_np(thread.native_handle(), sizeof(set), &set);
+    if (error != 0) {
+        errno = error;
+        perror("Erro ao fixar a thread nos núcleos");
+        return false;
+    }
+    return true;
+}
+
+
+/**
+ * @brief Retorna o índice do nó em que a thread atual está executando.
+ */
+int CpuTopology::currentNode() {
+    if (current_thread_node >= 0) {
+        return current_thread_node;
+    }
+
+    // Sem NUMA não há o que consultar; nos demais casos, o núcleo atual indica o nó
+    CpuTopology& topology = instance();
+    if (topology.nodeCount() == 1) {
+        return 0;
+    }
+    return topology.nodeOfCpu(sched_getcpu());
+}
+
+
+/**
+ * @brief Aloca memória ligada a um nó NUMA.
+ */
+void* CpuTopology::allocateOnNode(size_t size, int node) {
+    CpuTopology& topology = instance();
+    if (topology.nodeCount() <= 1 || node < 0 || node >= topology.nodeCount()) {
+        return nullptr;
+    }
+
+    void* memory = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (memory == MAP_FAILED) {
+        return nullptr;
+    }
+
+    // MPOL_PREFERRED: as páginas vêm do nó enquanto ele tiver memória livre, e de outro nó depois disso
+    int node_id = topology.node_ids[node];
+    std::vector<unsigned long> node_mask(static_cast<size_t>(node_id) / (8 * sizeof(unsigned long)) + 1, 0);
+    node_mask[static_cast<size_t>(node_id) / (8 * sizeof(unsigned long))] |= 1UL << (node_id % (8 * sizeof(unsigned long)));
+    if (syscall(SYS_mbind, memory, size, MPOL_PREFERRED, node_mask.data(), node_mask.size() * 8 * sizeof(unsigned long) + 1, 0) != 0) {
+        perror("Erro ao ligar a memória ao nó NUMA");
+    }
+    return memory;
+}
+
+
+/**
+ * @brief Libera a memória obtida de allocateOnNode.
+ */
+void CpuTopology::freeOnNode(void* memory, size_t size) {
+    if (memory != nullptr) {
+        munmap(memory, size);
+    }
+}
+
+
+/**
+ * @brief Converte o nome de uma política de afinidade ("off", "cores" ou "numa").
+ */
+bool CpuTopology::parsePinning(const std::string& name, PinningMode& mode) {
+    if (name == "off") {
+        mode = PinningMode::OFF;
+    } else if (name == "cores") {
+        mode = PinningMode::CORES;
+    } else if (name == "numa") {
+        mode = PinningMode::NUMA;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+
+/**
+ * @brief Converte uma política de afinidade para texto.
+ */
+const char* CpuTopology::pinningToString(PinningMode mode) {
+    switch (mode) {
+        case PinningMode::CORES: return "cores";
+        case PinningMode::NUMA: return "numa";
+        default: return "off";
+    }
+}
+
+
+/**
+ * @brief Define o modelo de threads dos peers criados a seguir.
+ */
+void CpuTopology::setDefaultConfig(const ThreadingConfig& config) {
+    std::lock_guard<std::mutex> lock(default_config_mutex);
+    default_config = config;
+}
+
+
+/**
+ * @brief Retorna o modelo de threads dos peers criados a seguir.
+ */
+ThreadingConfig CpuTopology::getDefaultConfig() {
+    std::lock_guard<std::mutex> lock(default_config_mutex);
+    return default_config;
+}
@@ -0,0 +1,200 @@
+#ifndef CPUTOPOLOGY_H
+#define CPUTOPOLOGY_H
+
+#include "Constants.h"
+#include <cstddef>
+#include <string>
+#include <thread>
+#include <vector>
+
+
+/**
+ * @brief Enumeração das políticas de afinidade das threads do peer.
+ */
+enum class PinningMode {
+    OFF,        ///< As threads não são fixadas; o escalonador do sistema as distribui.
+    CORES,      ///< Cada thread é fixada em um núcleo; peers consecutivos ocupam faixas consecutivas de núcleos.
+    NUMA        ///< As threads de cada peer ficam nos núcleos de um nó NUMA, escolhido pelo ID do peer.
+};
+
+
+/**
+ * @brief Enumeração dos papéis das threads do peer na distribuição pelos núcleos.
+ */
+enum class ThreadRole {
+    IO,         ///< Threads de E/S: sockets UDP e TCP, gravação dos chunks e envios.
+    WORKER      ///< Threads de processamento: mensagens UDP, etapas dos downloads e tarefas periódicas.
+};
+
+
+/**
+ * @brief Estrutura com o modelo de threads dos peers criados a seguir.
+ */
+struct ThreadingConfig {
+    PinningMode pinning = PinningMode::OFF;                 ///< Política de afinidade das threads.
+    int io_threads = Constants::IO_THREADS;                 ///< Número de conexões TCP recebidas ao mesmo tempo no executor compartilhado.
+    int worker_threads = Constants::WORKER_THREADS;         ///< Número de threads do executor compartilhado além das ocupadas pelos recebimentos e envios.
+};
+
+
+/**
+ * @brief Estrutura com os núcleos atribuídos às threads de um peer.
+ */
+struct ThreadPlacement {
+    PinningMode pinning = PinningMode::OFF;                 ///< Política de afinidade das threads.
+    int node = 0;                                           ///< Nó NUMA do peer (índice em CpuTopology), onde ficam os buffers e o estado dos arquivos.
+    std::vector<int> io_cpus;                               ///< Núcleos das threads de E/S.
+    std::vector<int> worker_cpus;                           ///< Núcleos das threads de processamento.
+
+    /**
+     * @brief Retorna os núcleos em que uma thread pode executar.
+     *
+     * @param role Papel da thread.
+     * @param index Índice da thread entre as do mesmo papel (as threads além do número de núcleos voltam ao início).
+     * @return Um núcleo (CORES), os núcleos do nó (NUMA) ou nenhum (OFF: thread não fixada).
+     */
+    std::vector<int> cpusFor(ThreadRole role, int index) const;
+};
+
+
+/**
+ * @brief Classe com a topologia de processadores e memória da máquina e a afinidade das threads.
+ *
+ * Os núcleos permitidos ao processo (sched_getaffinity) são agrupados pelos nós NUMA listados em
+ * /sys/devices/system/node; sem essa informação, todos ficam em um único nó. Uma thread fixada nos
+ * núcleos de um nó tem a sua memória alocada nele na primeira escrita (política padrão do Linux),
+ * e os buffers grandes do BufferPool são ligados ao nó explicitamente (mbind), pois o heap pode
+ * reaproveitar memória de outro nó.
+ */
+class CpuTopology {
+private:
+    std::vector<int> cpus;                                  ///< Núcleos permitidos, agrupados por nó.
+    std::vector<std::vector<int>> node_cpus;                ///< Núcleos permitidos de cada nó, por índice de nó.
+    std::vector<int> node_ids;                              ///< Número do nó no sistema, por índice de nó.
+    std::vector<int> cpu_nodes;                             ///< Índice do nó de cada núcleo, pelo número do núcleo (-1: não permitido).
+
+    /**
+     * @brief Construtor da classe CpuTopology. Lê os núcleos permitidos e os nós NUMA.
+     */
+    CpuTopology();
+
+public:
+    CpuTopology(const CpuTopology&) = delete;
+    CpuTopology& operator=(const CpuTopology&) = delete;
+
+
+    /**
+     * @brief Retorna a topologia da máquina, lida uma única vez.
+     */
+    static CpuTopology& instance();
+
+
+    /**
+     * @brief Retorna o número de núcleos permitidos ao processo.
+     */
+    int cpuCount() const;
+
+
+    /**
+     * @brief Retorna o número de nós NUMA com núcleos permitidos (1 em máquinas sem NUMA).
+     */
+    int nodeCount() const;
+
+
+    /**
+     * @brief Retorna o índice do nó de um núcleo (0 para núcleos desconhecidos).
+     *
+     * @param cpu Número do núcleo.
+     */
+    int nodeOfCpu(int cpu) const;
+
+
+    /**
+     * @brief Distribui as threads de um peer pelos núcleos.
+     *
+     * Com CORES, cada peer ocupa io_threads + worker_threads núcleos consecutivos a partir de
+     * peer_index vezes esse número, voltando ao início quando faltam núcleos; com NUMA, o peer
+     * fica no nó peer_index módulo o número de nós, e as suas threads podem usar qualquer núcleo dele.
+     *
+     * @param peer_index Posição do peer entre os peers da máquina (normalmente o seu ID).
+     * @param config Modelo de threads.
+     * @return Núcleos das threads de E/S e de processamento e nó do peer.
+     */
+    ThreadPlacement place(int peer_index, const ThreadingConfig& config) const;
+
+
+    /**
+     * @brief Fixa a thread atual em um conjunto de núcleos.
+     *
+     * @param cpus Núcleos permitidos (vazio: não altera a afinidade).
+     * @return true se a afinidade foi alterada ou não precisava ser.
+     */
+    static bool pinCurrentThread(const std::vector<int>& cpus);
+
+
+    /**
+     * @brief Fixa uma thread já criada em um conjunto de núcleos.
+     *
+     * @param thread Thread em execução.
+     * @param cpus Núcleos permitidos (vazio: não altera a afinidade).
+     * @return true se a afinidade foi alterada ou não precisava ser.
+     */
+    static bool pinThread(std::thread& thread, const std::vector<int>& cpus);
+
+
+    /**
+     * @brief Retorna o índice do nó em que a thread atual está executando.
+     */
+    static int currentNode();
+
+
+    /**
+     * @brief Aloca memória ligada a um nó NUMA.
+     *
+     * @param size Número de bytes.
+     * @param node Índice do nó.
+     * @return Memória alocada com mmap e ligada ao nó, ou nulo se a máquina tem um único nó ou a alocação falhou.
+     */
+    static void* allocateOnNode(size_t size, int node);
+
+
+    /**
+     * @brief Libera a memória obtida de allocateOnNode.
+     *
+     * @param memory Memória alocada.
+     * @param size Número de bytes pedidos na alocação.
+     */
+    static void freeOnNode(void* memory, size_t size);
+
+
+    /**
+     * @brief Converte o nome de uma política de afinidade ("off", "cores" ou "numa").
+     *
+     * @param name Nome da política.
+     * @param mode Recebe a política.
+     * @return true se o nome é válido.
+     */
+    static bool parsePinning(const std::string& name, PinningMode& mode);
+
+
+    /**
+     * @brief Converte uma política de afinidade para texto.
+     */
+    static const char* pinningToString(PinningMode mode);
+
+
+    /**
+     * @brief Define o modelo de threads dos peers criados a seguir (opções --pin, --io-threads e --worker-threads).
+     *
+     * @param config Modelo de threads desejado.
+     */
+    static void setDefaultConfig(const ThreadingConfig& config);
+
+
+    /**
+     * @brief Retorna o modelo de threads dos peers criados a seguir (padrão: threads não fixadas).
+     */
+    static ThreadingConfig getDefaultConfig();
+};
+
+#endif // CPUTOPOLOGY_H
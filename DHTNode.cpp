@@ -0,0 +1,673 @@
+#include "DHTNode.h"
+#include "Metrics.h"
+#include <algorithm>
+#include <cstdio>
+#include <iterator>
+#include <thread>
+
+
+/**
+ * @brief Construtor da classe DHTNode.
+ */
+DHTNode::DHTNode(const std::string& ip, int port, int peer_id, int transfer_speed, UDPServer& udp_server, FileManager& file_manager,
+                 const TimingConfig& timing)
+    : ip(ip), port(port), peer_id(peer_id), transfer_speed(transfer_speed), node_id(hashId(ip + ":" + std::to_string(port))),
+      udp_server(udp_server), file_manager(file_manager), timing(timing), bootstrapped(false), active(false), next_lookup_id(1) {}
+
+
+/**
+ * @brief Loop principal do nó da DHT.
+ */
+void DHTNode::run() {
+    // Um peer que publica arquivos em modo DHT entra na DHT logo ao iniciar; os demais, no primeiro uso
+    for (const std::string& file_name : file_manager.getLocalFiles()) {
+        if (fileMode(file_name) == DiscoveryMode::DHT) {
+            activate();
+            break;
+        }
+    }
+    {
+        std::unique_lock<std::mutex> lock(dht_mutex);
+        active_cv.wait(lock, [this] { return active; });
+    }
+
+    while (true) {
+        // Os vizinhos são os primeiros contatos da tabela; os demais chegam pelas próprias mensagens da DHT
+        for (const auto& [neighbor_ip, neighbor_port] : udp_server.getUDPNeighbors()) {
+            addContact(neighbor_ip, neighbor_port);
+        }
+
+        // Com poucos contatos, a busca pelo próprio ID preenche a tabela e anuncia o peer aos mais próximos dele
+        if (contactCount() < static_cast<size_t>(Constants::DHT_BUCKET_SIZE)) {
+            std::vector<Record> unused;
+            iterativeLookup(node_id, false, unused);
+        }
+
+        // Descarta os registros que não foram republicados dentro da validade
+        {
+            std::lock_guard<std::mutex> lock(dht_mutex);
+            auto now = std::chrono::steady_clock::now();
+            for (auto it = records.begin(); it != records.end();) {
+                auto& list = it->second;
+                list.erase(std::remove_if(list.begin(), list.end(), [&](const Record& record) { return record.expires <= now; }), list.end());
+                it = list.empty() ? records.erase(it) : std::next(it);
+            }
+        }
+
+        publishLocalRecords();
+
+        {
+            std::lock_guard<std::mutex> lock(dht_mutex);
+            if (!bootstrapped) {
+                bootstrapped = true;
+                bootstrap_cv.notify_all();
+            }
+        }
+
+        std::this_thread::sleep_for(timing.dht_publish_interval);
+    }
+}
+
+
+/**
+ * @brief Ativa o loop de run, se ainda não estiver ativo.
+ */
+void DHTNode::activate() {
+    std::lock_guard<std::mutex> lock(dht_mutex);
+    if (!active) {
+        active = true;
+        active_cv.notify_all();
+    }
+}
+
+
+/**
+ * @brief Busca na DHT os detentores dos chunks que faltam de um arquivo.
+ */
+int DHTNode::findHolders(const std::string& file_name, int total_chunks) {
+    // O primeiro download em modo DHT inicia a entrada do peer na DHT, esperada a seguir
+    activate();
+
+    {
+        std::unique_lock<std::mutex> lock(dht_mutex);
+        bootstrap_cv.wait_for(lock, timing.server_startup_delay, [this] { return bootstrapped; });
+    }
+
+    auto start = std::chrono::steady_clock::now();
+
+    // Só as faixas com chunks faltantes são buscadas
+    std::set<int> ranges;
+    for (int chunk = 0; chunk < total_chunks; ++chunk) {
+        if (!file_manager.hasChunk(file_name, chunk)) {
+            ranges.insert(chunk / Constants::DHT_CHUNK_RANGE_SIZE);
+        }
+    }
+
+    std::set<std::tuple<std::string, int>> holders;
+
+    for (int range : ranges) {
+        uint64_t key = rangeKey(file_name, range);
+
+        // Começa pelos registros que o próprio peer guarda e completa com os da busca iterativa
+        std::vector<Record> found = recordsFor(key);
+        iterativeLookup(key, true, found);
+
+        for (const Record& record : found) {
+            if (record.ip == ip && record.port == port) {
+                continue;
+            }
+
+            // Assim como nas respostas da inundação, só interessam os chunks que o peer não possui
+            std::vector<int> missing_chunks;
+            for (int chunk : record.chunks) {
+                if (chunk >= 0 && chunk < total_chunks && !file_manager.hasChunk(file_name, chunk)) {
+                    missing_chunks.push_back(chunk);
+                }
+            }
+
+            if (!missing_chunks.empty()) {
+                file_manager.storeChunkLocationInfo(file_name, missing_chunks, record.ip, record.port, record.transfer_speed);
+                holders.emplace(record.ip, record.port);
+            }
+        }
+    }
+
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+    Metrics::instance().observe(Histogram::DHT_LOOKUP_MS, static_cast<uint64_t>(elapsed.count()));
+    Metrics::instance().add(Counter::DHT_LOOKUPS, "local=" + std::to_string(peer_id) + ",result=" + (holders.empty() ? "empty" : "found"));
+
+    LOG_MESSAGE(LogType::INFO, "Busca na DHT por " + file_name + " encontrou " + std::to_string(holders.size()) + " detentores em " +
+                std::to_string(ranges.size()) + " faixas (" + std::to_string(elapsed.count()) + " ms).");
+    return static_cast<int>(holders.size());
+}
+
+
+/**
+ * @brief Processa uma mensagem do protocolo da DHT.
+ */
+void DHTNode::processDHTMessage(const DHTMessage& message, const PeerInfo& direct_sender_info) {
+    // Outro peer usa a DHT: este passa a manter a tabela (com os vizinhos) e os registros recebidos
+    activate();
+
+    if (message.type == MessageType::DHT_NODES || message.type == MessageType::DHT_VALUE) {
+        LookupReply reply;
+        reply.responder = std::make_tuple(direct_sender_info.ip, direct_sender_info.port);
+
+        MessageTokenizer body(message.body);
+        for (int i = 0; i < message.record_count; ++i) {
+            Record record;
+            if (!parseRecord(body, record)) {
+                break;
+            }
+            reply.records.push_back(record);
+        }
+
+        std::string_view address, contact_ip;
+        int contact_port;
+        while (body.next(address)) {
+            if (MessageParser::parseAddress(address, contact_ip, contact_port)) {
+                reply.nodes.emplace_back(std::string(contact_ip), contact_port);
+            }
+        }
+
+        addContact(direct_sender_info.ip, direct_sender_info.port);
+
+        // Respostas de buscas já encerradas são descartadas
+        std::lock_guard<std::mutex> lock(lookups_mutex);
+        auto it = lookup_replies.find(message.lookup_id);
+        if (it != lookup_replies.end()) {
+            it->second.push_back(std::move(reply));
+            lookups_cv.notify_all();
+        }
+        return;
+    }
+
+    if (message.type == MessageType::DHT_STORE) {
+        Record record;
+        MessageTokenizer body(message.body);
+        if (!parseRecord(body, record)) {
+            LOG_MESSAGE(LogType::ERROR, "Mensagem DHT_STORE mal formada recebida do Peer " + direct_sender_info.ip + ":" +
+                        std::to_string(direct_sender_info.port));
+            return;
+        }
+
+        addContact(record.ip, record.port);
+        record.expires = std::chrono::steady_clock::now() + timing.dht_record_ttl;
+        storeRecord(message.key, record);
+        return;
+    }
+
+    // DHT_FIND_NODE e DHT_FIND_VALUE trazem a busca, o alvo e o endereço anunciado de quem consulta
+    std::tuple<std::string, int> sender(std::string(message.sender_ip), message.sender_port);
+    addContact(std::get<0>(sender), std::get<1>(sender));
+
+    std::string reply = buildReplyMessage(message.lookup_id, message.key, message.type == MessageType::DHT_FIND_VALUE, sender);
+    udp_server.sendUDPMessage(std::get<0>(sender), std::get<1>(sender), reply);
+}
+
+
+/**
+ * @brief Calcula a chave da DHT de uma faixa de chunks de um arquivo.
+ */
+uint64_t DHTNode::rangeKey(const std::string& file_name, int range) {
+    return hashId(file_name + "#" + std::to_string(range));
+}
+
+
+/**
+ * @brief Calcula o ID de 64 bits de um texto (FNV-1a seguido de uma mistura de bits).
+ */
+uint64_t DHTNode::hashId(const std::string& text) {
+    uint64_t hash = 14695981039346656037ull;
+    for (unsigned char c : text) {
+        hash ^= c;
+        hash *= 1099511628211ull;
+    }
+
+    // Endereços parecidos (mesmo IP, portas vizinhas) geram hashes FNV próximos; a mistura os espalha pelo espaço de IDs
+    hash ^= hash >> 30;
+    hash *= 0xbf58476d1ce4e5b9ull;
+    hash ^= hash >> 27;
+    hash *= 0x94d049bb133111ebull;
+    hash ^= hash >> 31;
+    return hash;
+}
+
+
+/**
+ * @brief Executa uma busca iterativa pelos peers mais próximos de um alvo.
+ */
+std::vector<std::tuple<std::string, int>> DHTNode::iterativeLookup(uint64_t target, bool find_value, std::vector<Record>& found) {
+    struct Candidate {
+        uint64_t distance;
+        std::tuple<std::string, int> address;
+        bool queried;
+        bool responded;
+    };
+
+    std::vector<Candidate> shortlist;
+    auto addCandidate = [&](const std::tuple<std::string, int>& address) {
+        const auto& [candidate_ip, candidate_port] = address;
+        if (candidate_ip == ip && candidate_port == port) {
+            return;
+        }
+        for (const Candidate& candidate : shortlist) {
+            if (candidate.address == address) {
+                return;
+            }
+        }
+        shortlist.push_back({hashId(candidate_ip + ":" + std::to_string(candidate_port)) ^ target, address, false, false});
+    };
+
+    for (const auto& contact : closestContacts(target, Constants::DHT_BUCKET_SIZE)) {
+        addCandidate(contact);
+    }
+
+    uint64_t lookup_id;
+    {
+        std::lock_guard<std::mutex> lock(lookups_mutex);
+        lookup_id = next_lookup_id++;
+        lookup_replies[lookup_id];
+    }
+
+    std::string request = std::string(find_value ? "DHT_FIND_VALUE " : "DHT_FIND_NODE ") + std::to_string(lookup_id) + " " +
+                          formatId(target) + " " + ip + ":" + std::to_string(port);
+    std::map<std::tuple<std::string, int>, std::chrono::steady_clock::time_point> in_flight;
+
+    while (true) {
+        std::sort(shortlist.begin(), shortlist.end(), [](const Candidate& a, const Candidate& b) { return a.distance < b.distance; });
+
+        // Consulta os k candidatos mais próximos ainda não consultados, com no máximo alfa consultas em andamento
+        size_t considered = 0;
+        for (Candidate& candidate : shortlist) {
+            if (in_flight.size() >= static_cast<size_t>(Constants::DHT_LOOKUP_PARALLELISM) ||
+                considered++ >= static_cast<size_t>(Constants::DHT_BUCKET_SIZE)) {
+                break;
+            }
+            if (!candidate.queried) {
+                candidate.queried = true;
+                const auto& [candidate_ip, candidate_port] = candidate.address;
+                udp_server.sendUDPMessage(candidate_ip, candidate_port, request);
+                in_flight[candidate.address] = std::chrono::steady_clock::now() + timing.dht_rpc_timeout;
+            }
+        }
+
+        // Todos os k mais próximos já responderam ou foram descartados: a busca convergiu
+        if (in_flight.empty()) {
+            break;
+        }
+
+        // Espera uma resposta ou o prazo da consulta mais antiga
+        auto deadline = std::min_element(in_flight.begin(), in_flight.end(),
+                                         [](const auto& a, const auto& b) { return a.second < b.second; })->second;
+        std::vector<LookupReply> replies;
+        {
+            std::unique_lock<std::mutex> lock(lookups_mutex);
+            lookups_cv.wait_until(lock, deadline, [&] { return !lookup_replies[lookup_id].empty(); });
+            replies.swap(lookup_replies[lookup_id]);
+        }
+
+        for (LookupReply& reply : replies) {
+            in_flight.erase(reply.responder);
+            for (Candidate& candidate : shortlist) {
+                if (candidate.address == reply.responder) {
+                    candidate.responded = true;
+                }
+            }
+
+            for (const auto& node : reply.nodes) {
+                addCandidate(node);
+            }
+
+            // Registros de um mesmo detentor vindos de peers diferentes são unidos
+            for (const Record& record : reply.records) {
+                auto it = std::find_if(found.begin(), found.end(), [&](const Record& existing) {
+                    return existing.ip == record.ip && existing.port == record.port;
+                });
+                if (it == found.end()) {
+                    found.push_back(record);
+                } else {
+                    std::vector<int> merged;
+                    std::set_union(it->chunks.begin(), it->chunks.end(), record.chunks.begin(), record.chunks.end(), std::back_inserter(merged));
+                    it->chunks = merged;
+                }
+            }
+        }
+
+        // Contatos que não responderam no prazo saem da tabela e da busca
+        auto now = std::chrono::steady_clock::now();
+        for (auto it = in_flight.begin(); it != in_flight.end();) {
+            if (it->second > now) {
+                ++it;
+                continue;
+            }
+            auto address = it->first;
+            it = in_flight.erase(it);
+            removeContact(std::get<0>(address), std::get<1>(address));
+            shortlist.erase(std::remove_if(shortlist.begin(), shortlist.end(),
+                                           [&](const Candidate& candidate) { return candidate.address == address; }),
+                            shortlist.end());
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(lookups_mutex);
+        lookup_replies.erase(lookup_id);
+    }
+
+    std::vector<std::tuple<std::string, int>> closest;
+    for (const Candidate& candidate : shortlist) {
+        if (candidate.responded && closest.size() < static_cast<size_t>(Constants::DHT_BUCKET_SIZE)) {
+            closest.push_back(candidate.address);
+        }
+    }
+    return closest;
+}
+
+
+/**
+ * @brief Publica as faixas de chunks locais dos arquivos em modo DHT que precisam de publicação.
+ */
+void DHTNode::publishLocalRecords() {
+    std::vector<std::tuple<std::string, int, Record>> pending;
+    auto now = std::chrono::steady_clock::now();
+
+    for (const std::string& file_name : file_manager.getLocalFiles()) {
+        if (fileMode(file_name) != DiscoveryMode::DHT) {
+            continue;
+        }
+
+        // Agrupa os chunks locais por faixa (getAvailableChunks retorna os chunks em ordem crescente)
+        std::map<int, std::vector<int>> ranges;
+        for (int chunk : file_manager.getAvailableChunks(file_name)) {
+            ranges[chunk / Constants::DHT_CHUNK_RANGE_SIZE].push_back(chunk);
+        }
+
+        std::lock_guard<std::mutex> lock(dht_mutex);
+        for (const auto& [range, chunks] : ranges) {
+            // Publica faixas com chunks novos ou cuja última publicação está perto de vencer
+            Publication& publication = publications[std::make_tuple(file_name, range)];
+            if (publication.chunks == chunks && now - publication.published < timing.dht_republish_interval) {
+                continue;
+            }
+            publication.chunks = chunks;
+            publication.published = now;
+            pending.emplace_back(file_name, range, Record{ip, port, transfer_speed, chunks, {}});
+        }
+    }
+
+    for (auto& [file_name, range, record] : pending) {
+        uint64_t key = rangeKey(file_name, range);
+        std::vector<Record> unused;
+        auto closest = iterativeLookup(key, false, unused);
+
+        std::string message = "DHT_STORE " + formatId(key) + " " + formatRecord(record);
+        for (const auto& [node_ip, node_port] : closest) {
+            udp_server.sendUDPMessage(node_ip, node_port, message);
+        }
+
+        // O próprio peer também guarda o registro quando está entre os k mais próximos da chave
+        bool among_closest = closest.size() < static_cast<size_t>(Constants::DHT_BUCKET_SIZE) ||
+                             (node_id ^ key) < (hashId(std::get<0>(closest.back()) + ":" + std::to_string(std::get<1>(closest.back()))) ^ key);
+        if (among_closest) {
+            record.expires = std::chrono::steady_clock::now() + timing.dht_record_ttl;
+            storeRecord(key, record);
+        }
+
+        // Sem nenhum contato, a faixa é publicada novamente na próxima verificação
+        if (closest.empty()) {
+            std::lock_guard<std::mutex> lock(dht_mutex);
+            publications[std::make_tuple(file_name, range)].chunks.clear();
+        }
+    }
+}
+
+
+/**
+ * @brief Guarda um registro recebido por DHT_STORE ou publicado pelo próprio peer.
+ */
+void DHTNode::storeRecord(uint64_t key, const Record& record) {
+    std::lock_guard<std::mutex> lock(dht_mutex);
+    std::vector<Record>& list = records[key];
+
+    // Um novo registro do mesmo detentor substitui o anterior
+    for (Record& existing : list) {
+        if (existing.ip == record.ip && existing.port == record.port) {
+            existing = record;
+            return;
+        }
+    }
+
+    if (list.size() < static_cast<size_t>(Constants::DHT_MAX_RECORDS_PER_KEY)) {
+        list.push_back(record);
+    } else {
+        // Lista cheia: substitui o registro mais perto de vencer
+        auto oldest = std::min_element(list.begin(), list.end(), [](const Record& a, const Record& b) { return a.expires < b.expires; });
+        *oldest = record;
+    }
+}
+
+
+/**
+ * @brief Adiciona ou renova um contato na tabela de roteamento.
+ */
+void DHTNode::addContact(const std::string& contact_ip, int contact_port) {
+    uint64_t id = hashId(contact_ip + ":" + std::to_string(contact_port));
+    if (id == node_id) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(dht_mutex);
+    auto now = std::chrono::steady_clock::now();
+    std::vector<Contact>& bucket = buckets[63 - __builtin_clzll(id ^ node_id)];
+
+    // Contato conhecido: passa a ser o mais recente do k-bucket
+    auto it = std::find_if(bucket.begin(), bucket.end(), [&](const Contact& contact) { return contact.id == id; });
+    if (it != bucket.end()) {
+        Contact contact = *it;
+        contact.last_seen = now;
+        bucket.erase(it);
+        bucket.push_back(contact);
+        return;
+    }
+
+    if (bucket.size() < static_cast<size_t>(Constants::DHT_BUCKET_SIZE)) {
+        bucket.push_back({id, contact_ip, contact_port, now});
+    } else if (now - bucket.front().last_seen > timing.neighbor_timeout) {
+        // Os contatos antigos e ativos têm preferência; só um contato inativo dá lugar ao novo
+        bucket.erase(bucket.begin());
+        bucket.push_back({id, contact_ip, contact_port, now});
+    }
+}
+
+
+/**
+ * @brief Remove um contato da tabela de roteamento.
+ */
+void DHTNode::removeContact(const std::string& contact_ip, int contact_port) {
+    uint64_t id = hashId(contact_ip + ":" + std::to_string(contact_port));
+    if (id == node_id) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(dht_mutex);
+    std::vector<Contact>& bucket = buckets[63 - __builtin_clzll(id ^ node_id)];
+    bucket.erase(std::remove_if(bucket.begin(), bucket.end(), [&](const Contact& contact) { return contact.id == id; }), bucket.end());
+}
+
+
+/**
+ * @brief Retorna os contatos da tabela mais próximos de um alvo.
+ */
+std::vector<std::tuple<std::string, int>> DHTNode::closestContacts(uint64_t target, size_t count) {
+    std::vector<const Contact*> contacts;
+
+    std::lock_guard<std::mutex> lock(dht_mutex);
+    for (const auto& bucket : buckets) {
+        for (const Contact& contact : bucket) {
+            contacts.push_back(&contact);
+        }
+    }
+
+    // Ordena só os count primeiros pela distância XOR até o alvo
+    size_t limit = std::min(count, contacts.size());
+    std::partial_sort(contacts.begin(), contacts.begin() + limit, contacts.end(),
+                      [&](const Contact* a, const Contact* b) { return (a->id ^ target) < (b->id ^ target); });
+
+    std::vector<std::tuple<std::string, int>> closest;
+    for (size_t i = 0; i < limit; ++i) {
+        closest.emplace_back(contacts[i]->ip, contacts[i]->port);
+    }
+    return closest;
+}
+
+
+/**
+ * @brief Conta os contatos da tabela de roteamento.
+ */
+size_t DHTNode::contactCount() {
+    std::lock_guard<std::mutex> lock(dht_mutex);
+
+    size_t count = 0;
+    for (const auto& bucket : buckets) {
+        count += bucket.size();
+    }
+    return count;
+}
+
+
+/**
+ * @brief Retorna os registros válidos de uma chave.
+ */
+std::vector<DHTNode::Record> DHTNode::recordsFor(uint64_t key) {
+    std::vector<Record> valid;
+
+    std::lock_guard<std::mutex> lock(dht_mutex);
+    auto it = records.find(key);
+    if (it == records.end()) {
+        return valid;
+    }
+
+    auto now = std::chrono::steady_clock::now();
+    for (const Record& record : it->second) {
+        if (record.expires > now) {
+            valid.push_back(record);
+        }
+    }
+    return valid;
+}
+
+
+/**
+ * @brief Monta a resposta a uma consulta com os registros (opcionais) e os contatos mais próximos.
+ */
+std::string DHTNode::buildReplyMessage(uint64_t lookup_id, uint64_t target, bool find_value, const std::tuple<std::string, int>& excluded) {
+    const size_t max_size = Constants::CONTROL_MESSAGE_MAX_SIZE - 1;
+    // Reserva espaço para k endereços no formato mais longo (" 255.255.255.255:65535")
+    const size_t nodes_reserve = static_cast<size_t>(Constants::DHT_BUCKET_SIZE) * 22;
+
+    std::string message = std::string(find_value ? "DHT_VALUE " : "DHT_NODES ") + std::to_string(lookup_id);
+
+    if (find_value) {
+        std::string values;
+        int record_count = 0;
+        for (const Record& record : recordsFor(target)) {
+            std::string entry = " " + formatRecord(record);
+            // " <n>" ocupa no máximo 4 bytes com até DHT_MAX_RECORDS_PER_KEY registros
+            if (message.size() + 4 + values.size() + entry.size() + nodes_reserve > max_size) {
+                break;
+            }
+            values += entry;
+            ++record_count;
+        }
+        message += " " + std::to_string(record_count) + values;
+    }
+
+    for (const auto& [node_ip, node_port] : closestContacts(target, Constants::DHT_BUCKET_SIZE + 1)) {
+        if (std::make_tuple(node_ip, node_port) == excluded) {
+            continue;
+        }
+        std::string entry = " " + node_ip + ":" + std::to_string(node_port);
+        if (message.size() + entry.size() > max_size) {
+            break;
+        }
+        message += entry;
+    }
+
+    return message;
+}
+
+
+/**
+ * @brief Formata um registro como "ip:porta velocidade chunk,chunk,...".
+ */
+std::string DHTNode::formatRecord(const Record& record) {
+    std::string text = record.ip + ":" + std::to_string(record.port) + " " + std::to_string(record.transfer_speed) + " ";
+    for (size_t i = 0; i < record.chunks.size(); ++i) {
+        if (i > 0) {
+            text += ",";
+        }
+        text += std::to_string(record.chunks[i]);
+    }
+    return text;
+}
+
+
+/**
+ * @brief Lê um registro no formato de formatRecord.
+ */
+bool DHTNode::parseRecord(MessageTokenizer& message, Record& record) {
+    std::string_view holder_ip, chunk_list;
+    int holder_port;
+
+    if (!message.nextAddress(holder_ip, holder_port) || !message.nextNumber(record.transfer_speed) || !message.next(chunk_list)) {
+        return false;
+    }
+    record.ip = std::string(holder_ip);
+    record.port = holder_port;
+
+    // Os chunks são separados por vírgulas; um chunk inválido invalida o registro
+    record.chunks.clear();
+    MessageTokenizer chunks(chunk_list, ',');
+    int chunk;
+    while (chunks.nextNumber(chunk)) {
+        record.chunks.push_back(chunk);
+    }
+    if (!chunks.rest().empty()) {
+        return false;
+    }
+
+    // A união dos registros de um mesmo detentor exige os chunks em ordem
+    std::sort(record.chunks.begin(), record.chunks.end());
+    return !record.chunks.empty();
+}
+
+
+/**
+ * @brief Formata um ID ou chave de 64 bits em hexadecimal.
+ */
+std::string DHTNode::formatId(uint64_t id) {
+    char buffer[17];
+    snprintf(buffer, sizeof(buffer), "%016llx", static_cast<unsigned long long>(id));
+    return buffer;
+}
+
+
+/**
+ * @brief Retorna o modo de descoberta de um arquivo local, lendo o .p2p na primeira consulta.
+ */
+DiscoveryMode DHTNode::fileMode(const std::string& file_name) {
+    {
+        std::lock_guard<std::mutex> lock(dht_mutex);
+        auto it = file_modes.find(file_name);
+        if (it != file_modes.end()) {
+            return it->second;
+        }
+    }
+
+    auto [file_name_returned, total_chunks, initial_ttl, discovery_mode, erasure_scheme] = file_manager.loadMetadata(file_name);
+
+    std::lock_guard<std::mutex> lock(dht_mutex);
+    file_modes[file_name] = discovery_mode;
+    return discovery_mode;
+}
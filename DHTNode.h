@@ -0,0 +1,311 @@
+#ifndef DHTNODE_H
+#define DHTNODE_H
+
+#include "FileManager.h"
+#include "MessageParser.h"
+#include "UDPServer.h"
+#include "Utils.h"
+#include <array>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <set>
+#include <sstream>
+#include <string>
+#include <tuple>
+#include <vector>
+
+
+/**
+ * @brief Classe que implementa um índice distribuído de chunks no estilo Kademlia.
+ *
+ * É uma alternativa à inundação por TTL para os arquivos marcados com "dht" no .p2p. Cada peer
+ * recebe um ID de 64 bits (hash de "ip:porta") e mantém uma tabela de roteamento com um
+ * k-bucket por bit de distância XOR. Os chunks de um arquivo são agrupados em faixas de
+ * Constants::DHT_CHUNK_RANGE_SIZE chunks; a chave de cada faixa é o hash de "arquivo#faixa" e
+ * seus registros (detentor, velocidade e chunks da faixa) ficam nos k peers mais próximos da chave.
+ * Uma busca iterativa consulta até alfa peers por vez, aproximando-se da chave a cada resposta,
+ * e alcança qualquer peer da rede em O(log N) passos. As mensagens trocadas são:
+ *
+ *  - DHT_FIND_NODE <busca> <alvo> <ip:porta>: pede os contatos mais próximos do alvo.
+ *  - DHT_FIND_VALUE <busca> <chave> <ip:porta>: pede os registros da chave e os contatos mais próximos dela.
+ *  - DHT_NODES <busca> <ip:porta> ...: resposta a DHT_FIND_NODE.
+ *  - DHT_VALUE <busca> <n> [<ip:porta> <velocidade> <chunk,chunk,...>]*n <ip:porta> ...: resposta a DHT_FIND_VALUE.
+ *  - DHT_STORE <chave> <ip:porta> <velocidade> <chunk,chunk,...>: publica o remetente como detentor dos chunks.
+ *
+ * Alvos e chaves são escritos em hexadecimal e o endereço das consultas é o anunciado pelo remetente.
+ * A tabela é alimentada pelos vizinhos do UDPServer e por todo peer que envia uma mensagem da DHT;
+ * contatos que não respondem dentro de dht_rpc_timeout são removidos.
+ */
+class DHTNode {
+private:
+    /**
+     * @brief Estrutura com um contato da tabela de roteamento.
+     */
+    struct Contact {
+        uint64_t id;                                                    ///< ID do contato (hash de "ip:porta").
+        std::string ip;                                                 ///< Endereço IP do contato.
+        int port;                                                       ///< Porta UDP do contato.
+        std::chrono::steady_clock::time_point last_seen;                ///< Instante da última mensagem recebida do contato.
+    };
+
+    /**
+     * @brief Estrutura com um registro de detentor de uma faixa de chunks.
+     */
+    struct Record {
+        std::string ip;                                                 ///< Endereço IP do detentor.
+        int port;                                                       ///< Porta UDP do detentor.
+        int transfer_speed;                                             ///< Velocidade de transferência em bytes/segundo do detentor.
+        std::vector<int> chunks;                                        ///< Chunks da faixa que o detentor possui.
+        std::chrono::steady_clock::time_point expires;                  ///< Instante a partir do qual o registro é descartado.
+    };
+
+    /**
+     * @brief Estrutura com uma resposta recebida para uma busca em andamento.
+     */
+    struct LookupReply {
+        std::tuple<std::string, int> responder;                         ///< IP e porta UDP de quem respondeu.
+        std::vector<std::tuple<std::string, int>> nodes;                ///< Contatos mais próximos informados na resposta.
+        std::vector<Record> records;                                    ///< Registros informados na resposta (apenas DHT_VALUE).
+    };
+
+    /**
+     * @brief Estrutura com o estado de publicação de uma faixa de chunks do peer.
+     */
+    struct Publication {
+        std::vector<int> chunks;                                        ///< Chunks publicados na última vez.
+        std::chrono::steady_clock::time_point published;                ///< Instante da última publicação.
+    };
+
+    const std::string ip;                                               ///< Endereço IP do peer atual.
+    const int port;                                                     ///< Porta UDP do peer atual.
+    const int peer_id;                                                  ///< Identificador único (ID) do peer.
+    const int transfer_speed;                                           ///< Velocidade de transferência em bytes/segundo anunciada nos registros.
+    const uint64_t node_id;                                             ///< ID do peer na DHT.
+    UDPServer& udp_server;                                              ///< Referência ao servidor UDP, que envia as mensagens e conhece os vizinhos.
+    FileManager& file_manager;                                          ///< Referência ao gerenciador de arquivos do peer.
+    const TimingConfig timing;                                          ///< Tempos de espera do protocolo.
+
+    std::array<std::vector<Contact>, 64> buckets;                       ///< k-buckets, indexados pelo bit mais significativo da distância; o mais recente fica no fim.
+    std::map<uint64_t, std::vector<Record>> records;                    ///< Registros guardados pelo peer, por chave.
+    std::map<std::string, DiscoveryMode> file_modes;                    ///< Modo de descoberta de cada arquivo local, lido do .p2p uma única vez.
+    std::map<std::tuple<std::string, int>, Publication> publications;   ///< Estado de publicação de cada (arquivo, faixa) do peer.
+    std::mutex dht_mutex;                                               ///< Mutex para proteger a tabela de roteamento, os registros e o estado de publicação.
+    bool bootstrapped;                                                  ///< Indica que a primeira busca pelo próprio ID e a primeira publicação terminaram.
+    bool active;                                                        ///< Indica que o peer usa a DHT e o loop de run já publica e renova a tabela.
+    std::condition_variable active_cv;                                  ///< Sinaliza a ativação do loop de run (usa dht_mutex).
+    std::condition_variable bootstrap_cv;                               ///< Sinaliza o fim da entrada do peer na DHT (usa dht_mutex).
+
+    std::map<uint64_t, std::vector<LookupReply>> lookup_replies;        ///< Respostas recebidas de cada busca em andamento.
+    uint64_t next_lookup_id;                                            ///< Próximo identificador de busca.
+    std::mutex lookups_mutex;                                           ///< Mutex para proteger as respostas das buscas.
+    std::condition_variable lookups_cv;                                 ///< Sinaliza a chegada de uma resposta.
+
+public:
+    /**
+     * @brief Construtor da classe DHTNode.
+     *
+     * @param ip Endereço IP do peer.
+     * @param port Porta UDP do peer.
+     * @param peer_id ID do peer.
+     * @param transfer_speed Velocidade de transferência em bytes/segundo do peer.
+     * @param udp_server Referência ao servidor UDP do peer.
+     * @param file_manager Referência ao gerenciador de arquivos do peer.
+     * @param timing Tempos de espera do protocolo (padrão: valores de Constants.h).
+     */
+    DHTNode(const std::string& ip, int port, int peer_id, int transfer_speed, UDPServer& udp_server, FileManager& file_manager,
+            const TimingConfig& timing = TimingConfig());
+
+
+    /**
+     * @brief Loop principal do nó da DHT.
+     *
+     * A cada dht_publish_interval adiciona os vizinhos à tabela, busca o próprio ID enquanto a
+     * tabela tem menos de k contatos, descarta os registros vencidos e publica as faixas de
+     * chunks dos arquivos em modo DHT que mudaram ou cuja publicação venceu.
+     * Deve ser chamado depois de o socket UDP estar aberto.
+     *
+     * O loop só começa quando o peer usa a DHT (activate): um arquivo local em modo DHT, um
+     * download em modo DHT ou uma consulta de outro peer. Até lá, o peer que usa apenas a
+     * inundação não envia mensagens da DHT.
+     */
+    void run();
+
+
+    /**
+     * @brief Ativa o loop de run, se ainda não estiver ativo.
+     */
+    void activate();
+
+
+    /**
+     * @brief Busca na DHT os detentores dos chunks que faltam de um arquivo.
+     *
+     * Cada faixa com chunks faltantes é buscada com DHT_FIND_VALUE. Os detentores encontrados
+     * são gravados nas informações de localização dos chunks do FileManager, como as respostas
+     * da inundação. Logo após a inicialização, espera (até server_startup_delay) o peer entrar
+     * na DHT, pois uma tabela com apenas os vizinhos não alcança os peers mais próximos da chave.
+     *
+     * @param file_name Nome do arquivo.
+     * @param total_chunks Número total de chunks do arquivo.
+     * @return Número de detentores distintos encontrados para os chunks faltantes.
+     */
+    int findHolders(const std::string& file_name, int total_chunks);
+
+
+    /**
+     * @brief Processa uma mensagem do protocolo da DHT.
+     *
+     * @param message Campos da mensagem, lidos pelo MessageParser (os registros e contatos são lidos aqui).
+     * @param direct_sender_info Informações sobre o peer que enviou diretamente a mensagem (IP e porta UDP).
+     */
+    void processDHTMessage(const DHTMessage& message, const PeerInfo& direct_sender_info);
+
+
+    /**
+     * @brief Calcula a chave da DHT de uma faixa de chunks de um arquivo.
+     *
+     * @param file_name Nome do arquivo.
+     * @param range Índice da faixa (chunk / Constants::DHT_CHUNK_RANGE_SIZE).
+     * @return Chave de 64 bits.
+     */
+    static uint64_t rangeKey(const std::string& file_name, int range);
+
+
+    /**
+     * @brief Calcula o ID de 64 bits de um texto (FNV-1a seguido de uma mistura de bits).
+     *
+     * @param text Texto (ex: "127.0.0.1:6000" ou "image.png#0").
+     * @return ID de 64 bits.
+     */
+    static uint64_t hashId(const std::string& text);
+
+private:
+    /**
+     * @brief Executa uma busca iterativa pelos peers mais próximos de um alvo.
+     *
+     * @param target Alvo da busca (ID de peer ou chave).
+     * @param find_value Indica se a busca usa DHT_FIND_VALUE e coleta registros, em vez de DHT_FIND_NODE.
+     * @param found Recebe os registros encontrados (apenas com find_value).
+     * @return Contatos que responderam, do mais próximo para o mais distante (no máximo k).
+     */
+    std::vector<std::tuple<std::string, int>> iterativeLookup(uint64_t target, bool find_value, std::vector<Record>& found);
+
+
+    /**
+     * @brief Publica as faixas de chunks locais dos arquivos em modo DHT que precisam de publicação.
+     */
+    void publishLocalRecords();
+
+
+    /**
+     * @brief Guarda um registro recebido por DHT_STORE ou publicado pelo próprio peer.
+     *
+     * @param key Chave da faixa.
+     * @param record Registro do detentor.
+     */
+    void storeRecord(uint64_t key, const Record& record);
+
+
+    /**
+     * @brief Adiciona ou renova um contato na tabela de roteamento.
+     *
+     * Um contato já conhecido vai para o fim do seu k-bucket. Um contato novo só entra em um
+     * k-bucket cheio no lugar do contato mais antigo sem mensagens há mais de neighbor_timeout.
+     *
+     * @param contact_ip Endereço IP do contato.
+     * @param contact_port Porta UDP do contato.
+     */
+    void addContact(const std::string& contact_ip, int contact_port);
+
+
+    /**
+     * @brief Remove um contato da tabela de roteamento.
+     *
+     * @param contact_ip Endereço IP do contato.
+     * @param contact_port Porta UDP do contato.
+     */
+    void removeContact(const std::string& contact_ip, int contact_port);
+
+
+    /**
+     * @brief Retorna os contatos da tabela mais próximos de um alvo.
+     *
+     * @param target Alvo (ID de peer ou chave).
+     * @param count Número máximo de contatos.
+     * @return Contatos (IP e porta UDP), do mais próximo para o mais distante.
+     */
+    std::vector<std::tuple<std::string, int>> closestContacts(uint64_t target, size_t count);
+
+
+    /**
+     * @brief Conta os contatos da tabela de roteamento.
+     *
+     * @return Número de contatos.
+     */
+    size_t contactCount();
+
+
+    /**
+     * @brief Retorna os registros válidos de uma chave.
+     *
+     * @param key Chave da faixa.
+     * @return Registros da chave.
+     */
+    std::vector<Record> recordsFor(uint64_t key);
+
+
+    /**
+     * @brief Monta a resposta a uma consulta com os registros (opcionais) e os contatos mais próximos.
+     *
+     * Os itens são adicionados enquanto couberem em Constants::CONTROL_MESSAGE_MAX_SIZE bytes.
+     *
+     * @param lookup_id Identificador da busca.
+     * @param target Alvo ou chave consultada.
+     * @param find_value Indica se a resposta é DHT_VALUE (com registros) ou DHT_NODES.
+     * @param excluded Peer que não deve constar entre os contatos (quem fez a consulta).
+     * @return String contendo a mensagem formatada.
+     */
+    std::string buildReplyMessage(uint64_t lookup_id, uint64_t target, bool find_value, const std::tuple<std::string, int>& excluded);
+
+
+    /**
+     * @brief Formata um registro como "ip:porta velocidade chunk,chunk,...".
+     *
+     * @param record Registro.
+     * @return Registro formatado.
+     */
+    static std::string formatRecord(const Record& record);
+
+
+    /**
+     * @brief Lê um registro no formato de formatRecord.
+     *
+     * @param message Palavras da mensagem, posicionadas no início do registro.
+     * @param record Registro que recebe os valores lidos.
+     * @return true se o registro é válido.
+     */
+    static bool parseRecord(MessageTokenizer& message, Record& record);
+
+
+    /**
+     * @brief Formata um ID ou chave de 64 bits em hexadecimal.
+     *
+     * @param id ID ou chave.
+     * @return Texto com 16 dígitos hexadecimais.
+     */
+    static std::string formatId(uint64_t id);
+
+
+    /**
+     * @brief Retorna o modo de descoberta de um arquivo local, lendo o .p2p na primeira consulta.
+     *
+     * @param file_name Nome do arquivo.
+     * @return Modo de descoberta do arquivo (FLOOD se não houver metadados).
+     */
+    DiscoveryMode fileMode(const std::string& file_name);
+};
+
+#endif // DHTNODE_H
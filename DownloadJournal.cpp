@@ -0,0 +1,270 @@
+#include "DownloadJournal.h"
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <thread>
+
+
+/**
+ * @brief Construtor da classe DownloadJournal.
+ */
+DownloadJournal::DownloadJournal(FileManager& file_manager, const std::string& path, const TimingConfig& timing)
+    : file_manager(file_manager), path(path), timing(timing), dirty(false) {}
+
+
+/**
+ * @brief Lê o diário gravado antes do reinício.
+ */
+std::vector<std::tuple<std::string, int>> DownloadJournal::load() {
+    std::ifstream journal_file(path);
+    if (!journal_file.is_open()) {
+        return {};
+    }
+
+    std::map<std::string, Entry> loaded;
+    std::vector<std::string> order;
+    std::string line;
+    while (std::getline(journal_file, line)) {
+        std::istringstream fields(line);
+        std::string record, file_name;
+        if (!(fields >> record >> file_name)) {
+            continue;
+        }
+
+        // Só valem os registros dos arquivos com a linha "file", que vem antes das demais
+        if (record == "file") {
+            Entry& entry = loaded[file_name];
+            fields >> entry.priority;
+            order.push_back(file_name);
+            continue;
+        }
+        auto it = loaded.find(file_name);
+        if (it == loaded.end()) {
+            continue;
+        }
+
+        int chunk;
+        if (record == "completed") {
+            while (fields >> chunk) {
+                it->second.completed.push_back(chunk);
+            }
+        } else if (record == "partial") {
+            size_t offset = 0;
+            if (fields >> chunk >> offset && offset > 0) {
+                it->second.partial[chunk] = offset;
+            }
+        } else if (record == "holder") {
+            std::string ip;
+            int port = 0, transfer_speed = 0;
+            std::vector<int> chunks;
+            if (fields >> ip >> port >> transfer_speed) {
+                while (fields >> chunk) {
+                    chunks.push_back(chunk);
+                }
+                it->second.holders.emplace_back(ip, port, transfer_speed, std::move(chunks));
+            }
+        }
+    }
+
+    std::vector<std::tuple<std::string, int>> files;
+    for (const std::string& file_name : order) {
+        Entry& entry = loaded[file_name];
+
+        // Um arquivo parcial vale até o menor entre o seu tamanho e o diário; o restante pode não ter sido registrado
+        for (auto it = entry.partial.begin(); it != entry.partial.end();) {
+            std::string partial_path = file_manager.getPartialChunkPath(file_name, it->first);
+            std::error_code error;
+            size_t size = std::filesystem::file_size(partial_path, error);
+            it->second = error ? 0 : std::min(it->second, size);
+            if (it->second == 0 || file_manager.hasChunk(file_name, it->first)) {
+                std::remove(partial_path.c_str());
+                it = entry.partial.erase(it);
+                continue;
+            }
+            std::filesystem::resize_file(partial_path, it->second, error);
+            ++it;
+        }
+
+        // Os detentores gravados voltam ao cache de disponibilidade, consultado na primeira tentativa do download
+        for (const auto& [ip, port, transfer_speed, chunks] : entry.holders) {
+            file_manager.rememberChunkAvailability(file_name, chunks, ip, port, transfer_speed);
+        }
+
+        LOG_MESSAGE(LogType::INFO, "Download de " + file_name + " retomado do diário: " + std::to_string(entry.completed.size()) + " chunks concluídos, " +
+                    std::to_string(entry.partial.size()) + " parciais e " + std::to_string(entry.holders.size()) + " detentores conhecidos.");
+        files.emplace_back(file_name, entry.priority);
+    }
+
+    std::lock_guard<std::mutex> journal_lock(journal_mutex);
+    entries = std::move(loaded);
+    dirty = true;
+    return files;
+}
+
+
+/**
+ * @brief Loop principal, que grava o diário periodicamente.
+ */
+void DownloadJournal::run() {
+    while (true) {
+        std::this_thread::sleep_for(timing.download_journal_flush);
+        flush();
+    }
+}
+
+
+/**
+ * @brief Grava o diário, se houver downloads ou mudanças desde a última gravação.
+ */
+bool DownloadJournal::flush() {
+    std::vector<std::string> file_names;
+    {
+        std::lock_guard<std::mutex> journal_lock(journal_mutex);
+        if (entries.empty() && !dirty) {
+            return true;
+        }
+        for (const auto& [file_name, entry] : entries) {
+            file_names.push_back(file_name);
+        }
+        dirty = false;
+    }
+
+    // Os chunks e os detentores são lidos fora do bloqueio do diário; sem detentores (download ainda
+    // não iniciado ou arquivo já montado), os da gravação anterior são mantidos
+    std::map<std::string, std::tuple<std::vector<int>, std::vector<std::tuple<std::string, int, int, std::vector<int>>>>> progress;
+    for (const std::string& file_name : file_names) {
+        progress[file_name] = {file_manager.getAvailableChunks(file_name), file_manager.getChunkHolders(file_name)};
+    }
+
+    std::ostringstream journal;
+    {
+        std::lock_guard<std::mutex> journal_lock(journal_mutex);
+        for (auto& [file_name, entry] : entries) {
+            auto it = progress.find(file_name);
+            if (it != progress.end()) {
+                entry.completed = std::move(std::get<0>(it->second));
+                if (!std::get<1>(it->second).empty()) {
+                    entry.holders = std::move(std::get<1>(it->second));
+                }
+            }
+
+            journal << "file " << file_name << " " << entry.priority << "\n";
+            journal << "completed " << file_name;
+            for (int chunk : entry.completed) {
+                journal << " " << chunk;
+            }
+            journal << "\n";
+            for (const auto& [chunk, offset] : entry.partial) {
+                journal << "partial " << file_name << " " << chunk << " " << offset << "\n";
+            }
+            for (const auto& [ip, port, transfer_speed, chunks] : entry.holders) {
+                journal << "holder " << file_name << " " << ip << " " << port << " " << transfer_speed;
+                for (int chunk : chunks) {
+                    journal << " " << chunk;
+                }
+                journal << "\n";
+            }
+        }
+    }
+
+    // Sem downloads em andamento, não há o que retomar
+    std::string content = journal.str();
+    if (content.empty()) {
+        std::remove(path.c_str());
+        return true;
+    }
+
+    // Grava em um arquivo temporário e o renomeia, para que um reinício nunca leia o diário pela metade
+    std::string temporary_path = path + ".tmp";
+    {
+        std::ofstream journal_file(temporary_path, std::ios::trunc);
+        journal_file << content;
+        if (!journal_file.flush()) {
+            LOG_MESSAGE(LogType::ERROR, "Erro ao gravar o diário de downloads " + path + ".");
+            return false;
+        }
+    }
+    if (std::rename(temporary_path.c_str(), path.c_str()) != 0) {
+        perror("Erro ao gravar o diário de downloads");
+        return false;
+    }
+    return true;
+}
+
+
+/**
+ * @brief Registra um download em andamento.
+ */
+void DownloadJournal::addFile(const std::string& file_name, int priority) {
+    std::lock_guard<std::mutex> journal_lock(journal_mutex);
+    entries[file_name].priority = priority;
+    dirty = true;
+}
+
+
+/**
+ * @brief Retira um download concluído ou cancelado do diário.
+ */
+void DownloadJournal::removeFile(const std::string& file_name) {
+    std::map<int, size_t> partial;
+    {
+        std::lock_guard<std::mutex> journal_lock(journal_mutex);
+        auto it = entries.find(file_name);
+        if (it == entries.end()) {
+            return;
+        }
+        partial = std::move(it->second.partial);
+        entries.erase(it);
+        dirty = true;
+    }
+
+    // Os bytes dos chunks interrompidos não serão mais retomados
+    for (const auto& [chunk, offset] : partial) {
+        std::remove(file_manager.getPartialChunkPath(file_name, chunk).c_str());
+    }
+}
+
+
+/**
+ * @brief Indica se um arquivo tem um download registrado no diário.
+ */
+bool DownloadJournal::contains(const std::string& file_name) {
+    std::lock_guard<std::mutex> journal_lock(journal_mutex);
+    return entries.count(file_name) > 0;
+}
+
+
+/**
+ * @brief Registra os bytes de um chunk já gravados no seu arquivo parcial.
+ */
+void DownloadJournal::recordPartial(const std::string& file_name, int chunk, size_t offset) {
+    std::lock_guard<std::mutex> journal_lock(journal_mutex);
+    auto it = entries.find(file_name);
+    if (it != entries.end()) {
+        it->second.partial[chunk] = offset;
+        dirty = true;
+    }
+}
+
+
+/**
+ * @brief Descarta o registro de um chunk parcial.
+ */
+void DownloadJournal::clearPartial(const std::string& file_name, int chunk) {
+    std::lock_guard<std::mutex> journal_lock(journal_mutex);
+    auto it = entries.find(file_name);
+    if (it != entries.end() && it->second.partial.erase(chunk) > 0) {
+        dirty = true;
+    }
+}
+
+
+/**
+ * @brief Retorna os bytes já recebidos dos chunks parciais de um arquivo.
+ */
+std::map<int, size_t> DownloadJournal::getPartialOffsets(const std::string& file_name) {
+    std::lock_guard<std::mutex> journal_lock(journal_mutex);
+    auto it = entries.find(file_name);
+    return it != entries.end() ? it->second.partial : std::map<int, size_t>();
+}
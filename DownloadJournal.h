@@ -0,0 +1,146 @@
+#ifndef DOWNLOADJOURNAL_H
+#define DOWNLOADJOURNAL_H
+
+#include "FileManager.h"
+#include "Utils.h"
+#include <cstddef>
+#include <map>
+#include <mutex>
+#include <string>
+#include <tuple>
+#include <vector>
+
+
+/**
+ * @brief Classe que mantém em disco o diário dos downloads em andamento, para retomá-los após um reinício.
+ *
+ * As informações de um download (chunks por peer, chunks pedidos, bytes já recebidos de um chunk) existem
+ * apenas na memória do peer. O diário guarda, para cada arquivo buscado, a prioridade do download, os chunks
+ * concluídos, o número de bytes já gravados no arquivo parcial (.part) de cada chunk interrompido e os
+ * detentores conhecidos dos chunks. Ele é gravado em um arquivo temporário e renomeado, no máximo a cada
+ * TimingConfig::download_journal_flush e apenas quando há downloads ou mudanças.
+ *
+ * Após o reinício, os arquivos do diário voltam ao escalonador com a mesma prioridade, os detentores entram
+ * no cache de disponibilidade (a primeira tentativa dispensa a descoberta quando eles cobrem os chunks
+ * faltantes) e os chunks parciais são pedidos a partir do byte em que pararam ("ranges=" no REQUEST).
+ *
+ * Formato, uma linha por registro:
+ *   file <arquivo> <prioridade>
+ *   completed <arquivo> <chunk>...
+ *   partial <arquivo> <chunk> <bytes>
+ *   holder <arquivo> <ip> <porta UDP> <velocidade> <chunk>...
+ */
+class DownloadJournal {
+private:
+    /**
+     * @brief Estrutura com o estado de um download no diário.
+     */
+    struct Entry {
+        int priority = 0;                                                           ///< Prioridade do download.
+        std::vector<int> completed;                                                 ///< Chunks concluídos na última gravação.
+        std::map<int, size_t> partial;                                              ///< Bytes gravados no arquivo parcial de cada chunk interrompido.
+        std::vector<std::tuple<std::string, int, int, std::vector<int>>> holders;   ///< IP, porta UDP, velocidade e chunks de cada detentor conhecido.
+    };
+
+    FileManager& file_manager;                                                      ///< Referência ao gerenciador de arquivos, que tem os chunks e os detentores.
+    const std::string path;                                                         ///< Caminho do arquivo do diário.
+    const TimingConfig timing;                                                      ///< Tempos de espera do protocolo.
+    std::map<std::string, Entry> entries;                                           ///< Downloads em andamento, por arquivo.
+    bool dirty;                                                                     ///< Indica que o diário mudou desde a última gravação.
+    std::mutex journal_mutex;                                                       ///< Mutex para proteger as entradas.
+
+public:
+    /**
+     * @brief Construtor da classe DownloadJournal.
+     *
+     * @param file_manager Referência ao gerenciador de arquivos do peer.
+     * @param path Caminho do arquivo do diário (normalmente Constants::DOWNLOAD_JOURNAL_FILE_NAME no diretório do peer).
+     * @param timing Tempos de espera do protocolo (padrão: valores de Constants.h).
+     */
+    DownloadJournal(FileManager& file_manager, const std::string& path, const TimingConfig& timing = TimingConfig());
+
+
+    /**
+     * @brief Lê o diário gravado antes do reinício.
+     *
+     * Deve ser chamado depois de FileManager::loadLocalChunks. Os bytes de cada chunk parcial são limitados ao
+     * tamanho do seu arquivo .part, que é truncado no valor do diário; os detentores entram no cache de disponibilidade.
+     *
+     * @return Arquivos a retomar, com a prioridade de cada download.
+     */
+    std::vector<std::tuple<std::string, int>> load();
+
+
+    /**
+     * @brief Loop principal, que grava o diário periodicamente.
+     */
+    void run();
+
+
+    /**
+     * @brief Grava o diário, se houver downloads ou mudanças desde a última gravação.
+     *
+     * Os chunks concluídos e os detentores são lidos do FileManager; sem downloads, o arquivo do diário é removido.
+     *
+     * @return true se o diário foi gravado (ou não precisava ser).
+     */
+    bool flush();
+
+
+    /**
+     * @brief Registra um download em andamento.
+     *
+     * @param file_name Nome do arquivo.
+     * @param priority Prioridade do download.
+     */
+    void addFile(const std::string& file_name, int priority);
+
+
+    /**
+     * @brief Retira um download concluído ou cancelado do diário e remove os arquivos parciais dos seus chunks.
+     *
+     * @param file_name Nome do arquivo.
+     */
+    void removeFile(const std::string& file_name);
+
+
+    /**
+     * @brief Indica se um arquivo tem um download registrado no diário.
+     *
+     * @param file_name Nome do arquivo.
+     * @return true se o arquivo está no diário.
+     */
+    bool contains(const std::string& file_name);
+
+
+    /**
+     * @brief Registra os bytes de um chunk já gravados no seu arquivo parcial.
+     *
+     * Arquivos fora do diário são ignorados.
+     *
+     * @param file_name Nome do arquivo.
+     * @param chunk Número do chunk.
+     * @param offset Número de bytes do início do chunk gravados no arquivo parcial.
+     */
+    void recordPartial(const std::string& file_name, int chunk, size_t offset);
+
+
+    /**
+     * @brief Descarta o registro de um chunk parcial (chunk concluído ou arquivo parcial inválido).
+     *
+     * @param file_name Nome do arquivo.
+     * @param chunk Número do chunk.
+     */
+    void clearPartial(const std::string& file_name, int chunk);
+
+
+    /**
+     * @brief Retorna os bytes já recebidos dos chunks parciais de um arquivo.
+     *
+     * @param file_name Nome do arquivo.
+     * @return Bytes gravados no arquivo parcial de cada chunk interrompido.
+     */
+    std::map<int, size_t> getPartialOffsets(const std::string& file_name);
+};
+
+#endif // DOWNLOADJOURNAL_H
@@ -0,0 +1,526 @@
+#include "DownloadScheduler.h"
+#include "Metrics.h"
+#include <algorithm>
+#include <thread>
+
+
+/**
+ * @brief Construtor da classe DownloadScheduler.
+ */
+DownloadScheduler::DownloadScheduler(const std::string& ip, int udp_port, int peer_id, FileManager& file_manager, UDPServer& udp_server,
+                                     DHTNode& dht, const TimingConfig& timing)
+    : ip(ip), udp_port(udp_port), peer_id(peer_id), file_manager(file_manager), udp_server(udp_server), dht(dht), download_journal(nullptr), timing(timing),
+      next_sequence(0), discovery_round_active(false),
+      executor(Constants::DOWNLOAD_EXECUTOR_THREADS) {}
+
+
+/**
+ * @brief Associa o diário que guarda os downloads registrados até que eles terminem ou sejam cancelados.
+ */
+void DownloadScheduler::setDownloadJournal(DownloadJournal* download_journal) {
+    this->download_journal = download_journal;
+}
+
+
+/**
+ * @brief Fixa as threads do executor das etapas dos downloads nos núcleos de processamento do peer.
+ */
+void DownloadScheduler::setThreadPlacement(const ThreadPlacement& placement) {
+    executor.pin(placement, ThreadRole::WORKER);
+}
+
+
+/**
+ * @brief Loop principal do escalonador, que avança os downloads periodicamente.
+ */
+void DownloadScheduler::run() {
+    while (true) {
+        tick();
+        std::this_thread::sleep_for(timing.scheduler_tick);
+    }
+}
+
+
+/**
+ * @brief Registra o download de um arquivo na fila do escalonador.
+ */
+bool DownloadScheduler::submit(const std::string& file_name, int priority) {
+    std::lock_guard<std::mutex> downloads_lock(downloads_mutex);
+
+    // Não registra novamente um arquivo cujo download ainda está em andamento
+    auto it = downloads.find(file_name);
+    if (it != downloads.end()) {
+        DownloadState state = it->second.state;
+        if (state != DownloadState::COMPLETED && state != DownloadState::CANCELLED && state != DownloadState::FAILED) {
+            return false;
+        }
+        // Uma tarefa antiga ainda pode estar finalizando; espera ela terminar
+        if (it->second.busy) {
+            return false;
+        }
+    }
+
+    Download download;
+    download.priority = priority;
+    download.sequence = next_sequence++;
+    downloads[file_name] = download;
+    if (download_journal != nullptr) {
+        download_journal->addFile(file_name, priority);
+    }
+
+    LOG_MESSAGE(LogType::INFO, "Download de " + file_name + " registrado com prioridade " + std::to_string(priority) + ".");
+    return true;
+}
+
+
+/**
+ * @brief Cancela o download de um arquivo.
+ */
+bool DownloadScheduler::cancel(const std::string& file_name) {
+    std::lock_guard<std::mutex> downloads_lock(downloads_mutex);
+
+    auto it = downloads.find(file_name);
+    if (it == downloads.end()) {
+        return false;
+    }
+
+    // Só é possível cancelar downloads que ainda não terminaram
+    DownloadState state = it->second.state;
+    if (state == DownloadState::COMPLETED || state == DownloadState::CANCELLED || state == DownloadState::FAILED) {
+        return false;
+    }
+
+    it->second.state = DownloadState::CANCELLED;
+    if (download_journal != nullptr) {
+        download_journal->removeFile(file_name);
+    }
+
+    // Deixa de processar respostas para o arquivo e para os seus chunks buscados pelo conteúdo
+    if (state == DownloadState::DISCOVERING || state == DownloadState::WAITING_RESPONSES) {
+        udp_server.finalizeProcessingActive(file_name);
+        for (const std::string& content_name : it->second.content_names) {
+            udp_server.finalizeProcessingActive(content_name);
+        }
+        it->second.content_names.clear();
+    }
+
+    LOG_MESSAGE(LogType::INFO, "Download de " + file_name + " cancelado.");
+    return true;
+}
+
+
+/**
+ * @brief Retorna o estado de todos os downloads conhecidos pelo escalonador.
+ */
+std::vector<DownloadStatus> DownloadScheduler::getStatus() {
+    std::vector<DownloadStatus> status;
+
+    std::lock_guard<std::mutex> downloads_lock(downloads_mutex);
+
+    for (const auto& [file_name, download] : downloads) {
+        int chunks_available = static_cast<int>(file_manager.getAvailableChunks(file_name).size());
+        status.push_back({file_name, download.state, download.priority, chunks_available, download.total_chunks});
+    }
+
+    return status;
+}
+
+
+/**
+ * @brief Verifica se todos os downloads registrados terminaram.
+ */
+bool DownloadScheduler::allFinished() {
+    std::lock_guard<std::mutex> downloads_lock(downloads_mutex);
+
+    for (const auto& [file_name, download] : downloads) {
+        DownloadState state = download.state;
+        if (state != DownloadState::COMPLETED && state != DownloadState::CANCELLED && state != DownloadState::FAILED) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+
+/**
+ * @brief Conta os downloads que ocupam uma vaga de download ativo.
+ */
+int DownloadScheduler::countActiveDownloads() const {
+    int active = 0;
+
+    for (const auto& [file_name, download] : downloads) {
+        if (download.state == DownloadState::DISCOVERING ||
+            download.state == DownloadState::WAITING_RESPONSES ||
+            download.state == DownloadState::REQUESTED) {
+            ++active;
+        }
+    }
+
+    return active;
+}
+
+
+/**
+ * @brief Avança as máquinas de estado de todos os downloads.
+ */
+void DownloadScheduler::tick() {
+    std::lock_guard<std::mutex> downloads_lock(downloads_mutex);
+    auto now = std::chrono::steady_clock::now();
+
+    // Admite os downloads da fila com maior prioridade (e mais antigos) enquanto houver vagas
+    int active = countActiveDownloads();
+    while (active < Constants::MAX_ACTIVE_DOWNLOADS) {
+        auto best = downloads.end();
+        for (auto it = downloads.begin(); it != downloads.end(); ++it) {
+            if (it->second.state != DownloadState::QUEUED || it->second.busy) {
+                continue;
+            }
+            if (best == downloads.end() ||
+                it->second.priority > best->second.priority ||
+                (it->second.priority == best->second.priority && it->second.sequence < best->second.sequence)) {
+                best = it;
+            }
+        }
+
+        if (best == downloads.end()) {
+            break;
+        }
+
+        // O download passa a ocupar uma vaga; os metadados são carregados no executor
+        best->second.state = DownloadState::DISCOVERING;
+        best->second.busy = true;
+        ++active;
+
+        std::string file_name = best->first;
+        executor.submit([this, file_name] { startDownload(file_name); });
+    }
+
+    // Downloads em modo DHT buscam os detentores na DHT sem esperar a rodada de inundação
+    for (auto& [file_name, download] : downloads) {
+        if (download.state == DownloadState::DISCOVERING && !download.busy &&
+            download.discovery_mode == DiscoveryMode::DHT && !download.flood_fallback) {
+            int ttl = download.initial_ttl;
+            if (consultAvailabilityCache(file_name, download, ttl)) {
+                continue;
+            }
+            download.busy = true;
+            download.attempts++;
+            std::string name = file_name;
+            executor.submit([this, name] { runDHTLookup(name); });
+        }
+    }
+
+    // Junta todos os downloads que precisam de descoberta em uma única rodada
+    if (!discovery_round_active) {
+        std::vector<std::tuple<std::string, int, int, DiscoveryMode>> files;
+
+        for (auto& [file_name, download] : downloads) {
+            if (download.state == DownloadState::DISCOVERING && !download.busy &&
+                (download.discovery_mode != DiscoveryMode::DHT || download.flood_fallback)) {
+                // A inundação após uma busca na DHT sem resultado faz parte da mesma tentativa, que já consultou o cache
+                int ttl = download.initial_ttl;
+                if (!download.flood_fallback) {
+                    if (consultAvailabilityCache(file_name, download, ttl)) {
+                        continue;
+                    }
+                    download.attempts++;
+                }
+                download.busy = true;
+                udp_server.initializeProcessingActive(file_name);
+                // Na alternativa à DHT a inundação é a comum, com respostas diretas
+                DiscoveryMode mode = download.flood_fallback ? DiscoveryMode::FLOOD : download.discovery_mode;
+                files.emplace_back(file_name, download.total_chunks, ttl, mode);
+
+                // Nas novas tentativas, os chunks que ninguém oferece pelo nome do arquivo são buscados pelo conteúdo,
+                // que pode estar em peers que o possuem sob outro arquivo
+                if (download.attempts > 1) {
+                    download.content_names = file_manager.getUncoveredContentNames(file_name, Constants::CONTENT_DISCOVERY_MAX_CHUNKS);
+                    for (const std::string& content_name : download.content_names) {
+                        udp_server.initializeProcessingActive(content_name);
+                        files.emplace_back(content_name, 1, ttl, DiscoveryMode::FLOOD);
+                    }
+                }
+            }
+        }
+
+        if (!files.empty()) {
+            discovery_round_active = true;
+            executor.submit([this, files] { runDiscoveryRound(files); });
+        }
+    }
+
+    for (auto& [file_name, download] : downloads) {
+        if (download.busy) {
+            continue;
+        }
+
+        if (download.state == DownloadState::WAITING_RESPONSES && now >= download.deadline) {
+            // Prazo de respostas encerrado, solicita os chunks aos peers selecionados
+            download.busy = true;
+            std::string name = file_name;
+            executor.submit([this, name] { requestChunks(name); });
+        } else if (download.state == DownloadState::REQUESTED) {
+            int chunks_available = static_cast<int>(file_manager.getAvailableChunks(file_name).size());
+
+            if (chunks_available >= download.required_chunks) {
+                // O download só termina depois da montagem do arquivo, que roda em uma tarefa à parte
+                if (file_manager.isAssemblyPending(file_name)) {
+                    continue;
+                }
+                if (file_manager.isAssembled(file_name)) {
+                    download.state = DownloadState::COMPLETED;
+                    if (download_journal != nullptr) {
+                        download_journal->removeFile(file_name);
+                    }
+                    LOG_MESSAGE(LogType::INFO, "Download de " + file_name + " concluído.");
+                } else {
+                    // Com todos os chunks, uma nova descoberta não ajudaria: o download falha e continua no diário,
+                    // para ser retomado (e montado de novo) no próximo início do peer
+                    download.state = DownloadState::FAILED;
+                    LOG_MESSAGE(LogType::ERROR, "Download de " + file_name + " falhou: não foi possível montar o arquivo a partir dos chunks.");
+                }
+            } else if (chunks_available > download.chunks_available) {
+                // Houve progresso, renova o prazo da transferência
+                download.chunks_available = chunks_available;
+                download.deadline = now + timing.download_stall_timeout;
+            } else if (now >= download.deadline) {
+                LOG_MESSAGE(LogType::INFO, "Transferência de " + file_name + " sem progresso. Chunks faltantes serão buscados novamente.");
+                retryOrFail(file_name, download);
+            }
+        }
+    }
+
+    // Atualiza as profundidades das filas do escalonador
+    int queued = 0;
+    for (const auto& [file_name, download] : downloads) {
+        if (download.state == DownloadState::QUEUED) {
+            ++queued;
+        }
+    }
+    Metrics::instance().set(Gauge::DOWNLOADS_QUEUED, peer_id, queued);
+    Metrics::instance().set(Gauge::DOWNLOADS_ACTIVE, peer_id, countActiveDownloads());
+    Metrics::instance().set(Gauge::EXECUTOR_PENDING_TASKS, peer_id, static_cast<int64_t>(executor.pendingTasks()));
+}
+
+
+/**
+ * @brief Carrega os metadados de um arquivo admitido e prepara a descoberta.
+ */
+void DownloadScheduler::startDownload(const std::string& file_name) {
+    // Carrega as informações do arquivo de metadados (nome do arquivo, número total de chunks, TTL inicial, modo de descoberta e codificação)
+    auto [file_name_returned, total_chunks, initial_ttl, discovery_mode, erasure_scheme] = file_manager.loadMetadata(file_name);
+
+    // Verifica se a leitura foi bem-sucedida
+    if (total_chunks == -1 || initial_ttl == -1) {
+        std::lock_guard<std::mutex> downloads_lock(downloads_mutex);
+        downloads[file_name].state = DownloadState::FAILED;
+        downloads[file_name].busy = false;
+        return;
+    }
+
+    // Inicializa a estrutura responsável por armazenar as informações de número total de chunks para um arquivo;
+    // com os resumos do .p2p, os chunks que o peer já possui em outros arquivos são reaproveitados
+    file_manager.initializeFileChunks(file_name, total_chunks, erasure_scheme, file_manager.loadChunkDescriptors(file_name));
+
+    // Inicializa a estrutura responsável por armazenar informações de localização dos chunks
+    file_manager.initializeChunkLocationInfo(file_name);
+
+    // Tenta montar o arquivo com os chunks disponíveis
+    bool assembled = file_manager.assembleFile(file_name);
+
+    std::lock_guard<std::mutex> downloads_lock(downloads_mutex);
+    Download& download = downloads[file_name];
+    download.total_chunks = total_chunks;
+    download.required_chunks = erasure_scheme.enabled() ? erasure_scheme.data_chunks : total_chunks;
+    download.initial_ttl = initial_ttl;
+    download.discovery_mode = discovery_mode;
+    download.busy = false;
+
+    if (download.state == DownloadState::CANCELLED) {
+        return;
+    }
+
+    if (assembled) {
+        download.state = DownloadState::COMPLETED;
+        if (download_journal != nullptr) {
+            download_journal->removeFile(file_name);
+        }
+        LOG_MESSAGE(LogType::INFO, "O peer (" + ip + ":" + std::to_string(udp_port) + ") já possuí todos os chunks para " + file_name + ".");
+    }
+}
+
+
+/**
+ * @brief Executa uma rodada de descoberta compartilhada pelos arquivos informados.
+ */
+void DownloadScheduler::runDiscoveryRound(const std::vector<std::tuple<std::string, int, int, DiscoveryMode>>& files) {
+    // Monta um PeerInfo para o peer original que está enviando a solicitação
+    PeerInfo original_sender_info(ip, udp_port);
+
+    udp_server.sendChunkDiscoveryRound(files, original_sender_info);
+
+    std::lock_guard<std::mutex> downloads_lock(downloads_mutex);
+    auto deadline = std::chrono::steady_clock::now() + timing.response_timeout;
+
+    discovery_round_active = false;
+
+    for (const auto& [file_name, total_chunks, ttl, discovery_mode] : files) {
+        // Os nomes de conteúdo da rodada não são downloads
+        auto it = downloads.find(file_name);
+        if (it == downloads.end()) {
+            continue;
+        }
+        Download& download = it->second;
+        download.busy = false;
+        download.flood_fallback = false; // A próxima tentativa volta a usar a DHT
+
+        // Downloads cancelados durante a rodada não aguardam respostas
+        if (download.state == DownloadState::DISCOVERING) {
+            download.state = DownloadState::WAITING_RESPONSES;
+            download.deadline = deadline;
+        }
+    }
+}
+
+
+/**
+ * @brief Consulta o cache de disponibilidade no início de uma tentativa de descoberta.
+ */
+bool DownloadScheduler::consultAvailabilityCache(const std::string& file_name, Download& download, int& ttl) {
+    // Uma nova tentativa vem de uma transferência sem progresso: as entradas do cache podem estar desatualizadas
+    if (download.attempts > 0) {
+        return false;
+    }
+
+    auto [missing, uncovered] = file_manager.applyCachedChunkLocationInfo(file_name);
+    if (missing == 0 || uncovered == missing) {
+        return false;
+    }
+
+    if (uncovered == 0) {
+        // Todos os chunks faltantes têm detentores conhecidos: os chunks são solicitados no próximo tick
+        download.attempts++;
+        download.state = DownloadState::WAITING_RESPONSES;
+        download.deadline = std::chrono::steady_clock::now();
+        LOG_MESSAGE(LogType::INFO, "Cache de disponibilidade cobre os " + std::to_string(missing) + " chunks faltantes de " + file_name + ". Descoberta dispensada.");
+        return true;
+    }
+
+    // Parte dos chunks já tem detentores conhecidos: a inundação alcança menos saltos
+    ttl = std::min(ttl, std::max(1, (ttl * uncovered + missing - 1) / missing));
+    LOG_MESSAGE(LogType::INFO, "Cache de disponibilidade cobre " + std::to_string(missing - uncovered) + " de " + std::to_string(missing) +
+                " chunks faltantes de " + file_name + ". TTL da descoberta reduzido para " + std::to_string(ttl) + ".");
+    return false;
+}
+
+
+/**
+ * @brief Busca na DHT os detentores dos chunks faltantes de um arquivo em modo DHT.
+ */
+void DownloadScheduler::runDHTLookup(const std::string& file_name) {
+    int total_chunks;
+    {
+        std::lock_guard<std::mutex> downloads_lock(downloads_mutex);
+        total_chunks = downloads[file_name].total_chunks;
+    }
+
+    // Os detentores encontrados são gravados nas informações de localização, como as respostas da inundação
+    int holders = dht.findHolders(file_name, total_chunks);
+
+    std::lock_guard<std::mutex> downloads_lock(downloads_mutex);
+    Download& download = downloads[file_name];
+    download.busy = false;
+
+    // Downloads cancelados durante a busca não seguem adiante
+    if (download.state != DownloadState::DISCOVERING) {
+        return;
+    }
+
+    if (holders > 0) {
+        // Não há respostas a aguardar: os chunks são solicitados no próximo tick
+        download.state = DownloadState::WAITING_RESPONSES;
+        download.deadline = std::chrono::steady_clock::now();
+    } else {
+        LOG_MESSAGE(LogType::INFO, "Nenhum detentor de " + file_name + " encontrado na DHT. Usando a inundação.");
+        download.flood_fallback = true;
+    }
+}
+
+
+/**
+ * @brief Solicita os chunks do arquivo aos peers que responderam à descoberta.
+ */
+void DownloadScheduler::requestChunks(const std::string& file_name) {
+    // Desativa o processamento de respostas para o arquivo após o prazo
+    udp_server.finalizeProcessingActive(file_name);
+
+    {
+        std::lock_guard<std::mutex> downloads_lock(downloads_mutex);
+
+        // As buscas pelo conteúdo terminam junto com a do arquivo
+        for (const std::string& content_name : downloads[file_name].content_names) {
+            udp_server.finalizeProcessingActive(content_name);
+        }
+        downloads[file_name].content_names.clear();
+
+        if (downloads[file_name].state == DownloadState::CANCELLED) {
+            LOG_MESSAGE(LogType::INFO, "Download de " + file_name + " cancelado. Nenhum chunk será solicitado.");
+            downloads[file_name].busy = false;
+            return;
+        }
+    }
+
+    // Envia solicitações de chunks aos peers selecionados
+    int peers_requested = udp_server.sendChunkRequestMessage(file_name);
+    int chunks_available = static_cast<int>(file_manager.getAvailableChunks(file_name).size());
+
+    std::lock_guard<std::mutex> downloads_lock(downloads_mutex);
+    Download& download = downloads[file_name];
+    download.busy = false;
+
+    if (download.state == DownloadState::CANCELLED) {
+        return;
+    }
+
+    if (peers_requested == 0 && chunks_available < download.required_chunks) {
+        LOG_MESSAGE(LogType::INFO, "Nenhum peer respondeu com chunks faltantes de " + file_name + ".");
+        retryOrFail(file_name, download);
+        return;
+    }
+
+    download.state = DownloadState::REQUESTED;
+    download.chunks_available = chunks_available;
+    download.deadline = std::chrono::steady_clock::now() + timing.download_stall_timeout;
+}
+
+
+/**
+ * @brief Decide entre uma nova rodada de descoberta ou a falha do download.
+ */
+void DownloadScheduler::retryOrFail(const std::string& file_name, Download& download) {
+    if (download.attempts < Constants::DOWNLOAD_MAX_DISCOVERY_ATTEMPTS) {
+        // Volta a aguardar a próxima rodada de descoberta compartilhada
+        download.state = DownloadState::DISCOVERING;
+    } else {
+        download.state = DownloadState::FAILED;
+        LOG_MESSAGE(LogType::ERROR, "Download de " + file_name + " falhou após " + std::to_string(download.attempts) + " rodadas de descoberta.");
+    }
+}
+
+
+/**
+ * @brief Converte o estado de um download para texto.
+ */
+std::string DownloadScheduler::stateToString(DownloadState state) {
+    switch (state) {
+        case DownloadState::QUEUED:            return "QUEUED";
+        case DownloadState::DISCOVERING:       return "DISCOVERING";
+        case DownloadState::WAITING_RESPONSES: return "WAITING_RESPONSES";
+        case DownloadState::REQUESTED:         return "REQUESTED";
+        case DownloadState::COMPLETED:         return "COMPLETED";
+        case DownloadState::CANCELLED:         return "CANCELLED";
+        case DownloadState::FAILED:            return "FAILED";
+    }
+    return "UNKNOWN";
+}
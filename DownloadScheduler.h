@@ -0,0 +1,264 @@
+#ifndef DOWNLOADSCHEDULER_H
+#define DOWNLOADSCHEDULER_H
+
+#include "DHTNode.h"
+#include "DownloadJournal.h"
+#include "Executor.h"
+#include "FileManager.h"
+#include "UDPServer.h"
+#include "Utils.h"
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+
+/**
+ * @brief Enumeração para os estados de um download gerenciado pelo escalonador.
+ */
+enum class DownloadState {
+    QUEUED,             ///< Download registrado, aguardando uma vaga entre os downloads ativos.
+    DISCOVERING,        ///< Aguardando a próxima rodada de descoberta ou com a rodada em andamento.
+    WAITING_RESPONSES,  ///< Mensagens de descoberta enviadas, aguardando respostas até o prazo.
+    REQUESTED,          ///< Chunks solicitados aos peers selecionados, aguardando a transferência.
+    COMPLETED,          ///< Arquivo montado com sucesso.
+    CANCELLED,          ///< Download cancelado pelo usuário.
+    FAILED              ///< Falha ao carregar os metadados ou nenhum peer encontrado após as tentativas.
+};
+
+
+/**
+ * @brief Estrutura com o estado de um download, usada para responder ao comando STATUS.
+ */
+struct DownloadStatus {
+    std::string file_name;   ///< Nome do arquivo.
+    DownloadState state;     ///< Estado atual do download.
+    int priority;            ///< Prioridade do download (maior é escalonado primeiro).
+    int chunks_available;    ///< Número de chunks do arquivo que o peer já possui.
+    int total_chunks;        ///< Número total de chunks do arquivo (0 se ainda desconhecido).
+};
+
+
+/**
+ * @brief Classe que escalona os downloads de arquivos do peer.
+ *
+ * Em vez de uma thread bloqueante por arquivo, cada download é uma máquina de estados
+ * (QUEUED -> DISCOVERING -> WAITING_RESPONSES -> REQUESTED -> COMPLETED) avançada por um
+ * loop de escalonamento. As etapas que bloqueiam (carregar metadados, rodada de descoberta,
+ * envio de requisições) são executadas em um Executor com poucas threads.
+ *
+ * O número de downloads ativos é limitado; os demais esperam na fila, ordenados por
+ * prioridade e ordem de chegada. Todos os downloads que precisam de descoberta ao mesmo
+ * tempo compartilham a mesma rodada: cada vizinho recebe as mensagens DISCOVERY de todos
+ * os arquivos de uma vez, respeitando um único intervalo entre vizinhos.
+ *
+ * Antes da primeira tentativa, o cache de disponibilidade do FileManager é consultado: se ele já
+ * cobre todos os chunks faltantes, a descoberta é dispensada; se cobre parte deles, o TTL da
+ * inundação é reduzido na mesma proporção. As novas tentativas, após uma transferência sem
+ * progresso, sempre fazem a descoberta completa, pois as entradas do cache podem estar desatualizadas.
+ *
+ * Arquivos com o modo "dht" no .p2p não entram na rodada: os detentores são buscados na DHT
+ * e, quando nenhum é encontrado, o download participa da próxima rodada de inundação. Arquivos
+ * com o modo "aggregate" participam da rodada com as respostas agregadas no caminho reverso.
+ */
+class DownloadScheduler {
+private:
+    /**
+     * @brief Estrutura interna com o estado completo de um download.
+     */
+    struct Download {
+        DownloadState state = DownloadState::QUEUED;                    ///< Estado atual do download.
+        int priority = 0;                                               ///< Prioridade do download.
+        uint64_t sequence = 0;                                          ///< Ordem de chegada, usada para desempate entre prioridades iguais.
+        int total_chunks = 0;                                           ///< Número total de chunks do arquivo.
+        int required_chunks = 0;                                        ///< Número de chunks que completam o download (k com codificação de apagamento).
+        int initial_ttl = 0;                                            ///< TTL inicial das mensagens de descoberta.
+        int attempts = 0;                                               ///< Número de rodadas de descoberta já realizadas.
+        int chunks_available = 0;                                       ///< Número de chunks locais na última verificação.
+        DiscoveryMode discovery_mode = DiscoveryMode::FLOOD;            ///< Modo de descoberta definido no .p2p.
+        bool flood_fallback = false;                                    ///< Indica que a busca na DHT da tentativa atual falhou e a inundação será usada.
+        bool busy = false;                                              ///< Indica que há uma tarefa do download em execução no executor.
+        std::vector<std::string> content_names;                         ///< Nomes de conteúdo buscados na rodada de descoberta da tentativa atual.
+        std::chrono::steady_clock::time_point deadline;                 ///< Prazo da etapa atual (respostas ou progresso da transferência).
+    };
+
+    const std::string ip;                                               ///< Endereço IP do peer.
+    const int udp_port;                                                 ///< Porta UDP do peer, usada como remetente original das descobertas.
+    const int peer_id;                                                  ///< ID do peer, que separa os medidores nas métricas.
+    FileManager& file_manager;                                          ///< Referência ao gerenciador de arquivos do peer.
+    UDPServer& udp_server;                                              ///< Referência ao servidor UDP do peer.
+    DHTNode& dht;                                                       ///< Referência ao nó da DHT do peer.
+    DownloadJournal* download_journal;                                  ///< Diário dos downloads em andamento, mantido para a retomada após um reinício (nulo: sem diário).
+    const TimingConfig timing;                                          ///< Tempos de espera do protocolo.
+    std::map<std::string, Download> downloads;                          ///< Mapa que associa cada arquivo ao estado do seu download.
+    std::mutex downloads_mutex;                                         ///< Mutex para proteger o acesso ao mapa downloads.
+    uint64_t next_sequence;                                             ///< Próximo número de ordem de chegada.
+    bool discovery_round_active;                                        ///< Indica que há uma rodada de descoberta em andamento.
+    Executor executor;                                                  ///< Executor das etapas bloqueantes dos downloads.
+
+    /**
+     * @brief Conta os downloads que ocupam uma vaga de download ativo.
+     *
+     * Deve ser chamado com downloads_mutex bloqueado.
+     *
+     * @return Número de downloads ativos.
+     */
+    int countActiveDownloads() const;
+
+
+    /**
+     * @brief Avança as máquinas de estado de todos os downloads.
+     *
+     * Admite downloads da fila, inicia rodadas de descoberta compartilhadas, encerra a espera
+     * por respostas vencida e verifica o progresso das transferências.
+     */
+    void tick();
+
+
+    /**
+     * @brief Carrega os metadados de um arquivo admitido e prepara a descoberta.
+     *
+     * @param file_name Nome do arquivo.
+     */
+    void startDownload(const std::string& file_name);
+
+
+    /**
+     * @brief Executa uma rodada de descoberta compartilhada pelos arquivos informados.
+     *
+     * @param files Tuplas com o nome do arquivo, número total de chunks, TTL inicial e modo de descoberta.
+     */
+    void runDiscoveryRound(const std::vector<std::tuple<std::string, int, int, DiscoveryMode>>& files);
+
+
+    /**
+     * @brief Consulta o cache de disponibilidade no início de uma tentativa de descoberta.
+     *
+     * Deve ser chamado com downloads_mutex bloqueado. O cache é usado apenas na primeira tentativa.
+     * Quando ele cobre todos os chunks faltantes, a tentativa é contada e o download passa direto
+     * às requisições.
+     *
+     * @param file_name Nome do arquivo.
+     * @param download Estado do download.
+     * @param ttl TTL da inundação, reduzido na proporção dos chunks faltantes já cobertos pelo cache.
+     * @return true se a descoberta foi dispensada.
+     */
+    bool consultAvailabilityCache(const std::string& file_name, Download& download, int& ttl);
+
+
+    /**
+     * @brief Busca na DHT os detentores dos chunks faltantes de um arquivo em modo DHT.
+     *
+     * Sem nenhum detentor encontrado, o download volta a aguardar a rodada de inundação.
+     *
+     * @param file_name Nome do arquivo.
+     */
+    void runDHTLookup(const std::string& file_name);
+
+
+    /**
+     * @brief Solicita os chunks do arquivo aos peers que responderam à descoberta.
+     *
+     * @param file_name Nome do arquivo.
+     */
+    void requestChunks(const std::string& file_name);
+
+
+    /**
+     * @brief Decide entre uma nova rodada de descoberta ou a falha do download.
+     *
+     * Deve ser chamado com downloads_mutex bloqueado.
+     *
+     * @param file_name Nome do arquivo.
+     * @param download Estado do download.
+     */
+    void retryOrFail(const std::string& file_name, Download& download);
+
+public:
+    /**
+     * @brief Construtor da classe DownloadScheduler.
+     *
+     * @param ip Endereço IP do peer.
+     * @param udp_port Porta UDP do peer.
+     * @param peer_id ID do peer, que separa os medidores dos peers de um mesmo processo.
+     * @param file_manager Referência ao gerenciador de arquivos do peer.
+     * @param udp_server Referência ao servidor UDP do peer.
+     * @param dht Referência ao nó da DHT do peer.
+     * @param timing Tempos de espera do protocolo (padrão: valores de Constants.h).
+     */
+    DownloadScheduler(const std::string& ip, int udp_port, int peer_id, FileManager& file_manager, UDPServer& udp_server, DHTNode& dht,
+                      const TimingConfig& timing = TimingConfig());
+
+
+    /**
+     * @brief Associa o diário que guarda os downloads registrados até que eles terminem ou sejam cancelados.
+     *
+     * Os downloads que falham permanecem no diário e são retomados no próximo início do peer.
+     *
+     * @param download_journal Ponteiro para o diário de downloads do peer.
+     */
+    void setDownloadJournal(DownloadJournal* download_journal);
+
+
+    /**
+     * @brief Fixa as threads do executor das etapas dos downloads nos núcleos de processamento do peer.
+     *
+     * @param placement Núcleos das threads do peer.
+     */
+    void setThreadPlacement(const ThreadPlacement& placement);
+
+
+    /**
+     * @brief Loop principal do escalonador, que avança os downloads periodicamente.
+     */
+    void run();
+
+
+    /**
+     * @brief Registra o download de um arquivo na fila do escalonador.
+     *
+     * Um arquivo cujo download ainda está em andamento não é registrado novamente.
+     *
+     * @param file_name Nome do arquivo que se deseja fazer a busca.
+     * @param priority Prioridade do download (maior é escalonado primeiro).
+     * @return true se o download foi registrado, false se já havia um download em andamento.
+     */
+    bool submit(const std::string& file_name, int priority = 0);
+
+
+    /**
+     * @brief Cancela o download de um arquivo.
+     *
+     * @param file_name Nome do arquivo cujo download será cancelado.
+     * @return true se o download estava em andamento e foi cancelado, false caso contrário.
+     */
+    bool cancel(const std::string& file_name);
+
+
+    /**
+     * @brief Retorna o estado de todos os downloads conhecidos pelo escalonador.
+     *
+     * @return Vetor com o estado de cada download.
+     */
+    std::vector<DownloadStatus> getStatus();
+
+
+    /**
+     * @brief Verifica se todos os downloads registrados terminaram.
+     *
+     * @return true se nenhum download está na fila ou ativo.
+     */
+    bool allFinished();
+
+
+    /**
+     * @brief Converte o estado de um download para texto.
+     *
+     * @param state Estado do download.
+     * @return Nome do estado (ex: "DISCOVERING").
+     */
+    static std::string stateToString(DownloadState state);
+};
+
+#endif // DOWNLOADSCHEDULER_H
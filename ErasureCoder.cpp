@@ -0,0 +1,346 @@
+#include "ErasureCoder.h"
+#include "Constants.h"
+#include <algorithm>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define ERASURE_X86 1
+#endif
+
+
+namespace {
+    // Polinômio irredutível de GF(2^8) (x^8 + x^4 + x^3 + x^2 + 1), o mesmo do Reed–Solomon usual
+    const int GF_POLYNOMIAL = 0x11d;
+
+
+    /**
+     * @brief Estrutura com as tabelas de GF(2^8), montadas uma única vez.
+     */
+    struct GaloisTables {
+        uint8_t exp[512];                                   ///< Potências do gerador, duplicadas para dispensar o módulo 255.
+        uint8_t log[256];                                   ///< Logaritmos na base do gerador (log[0] não é usado).
+        uint8_t mul[256][256];                              ///< Tabela de multiplicação completa (64 KiB).
+        uint8_t low[256][16];                               ///< Produto de cada coeficiente pelos valores 0-15 da metade baixa de um byte.
+        uint8_t high[256][16];                              ///< Produto de cada coeficiente pelos valores 0-15 da metade alta de um byte.
+
+        GaloisTables() {
+            int value = 1;
+            for (int i = 0; i < 255; ++i) {
+                exp[i] = static_cast<uint8_t>(value);
+                exp[i + 255] = static_cast<uint8_t>(value);
+                log[value] = static_cast<uint8_t>(i);
+                value <<= 1;
+                if (value & 0x100) {
+                    value ^= GF_POLYNOMIAL;
+                }
+            }
+            exp[510] = exp[0];
+            exp[511] = exp[1];
+            log[0] = 0;
+
+            for (int a = 0; a < 256; ++a) {
+                for (int b = 0; b < 256; ++b) {
+                    mul[a][b] = (a == 0 || b == 0) ? 0 : exp[log[a] + log[b]];
+                }
+                // Como a multiplicação é linear sobre o XOR, c * x = c * (x & 0x0f) ^ c * (x & 0xf0)
+                for (int nibble = 0; nibble < 16; ++nibble) {
+                    low[a][nibble] = mul[a][nibble];
+                    high[a][nibble] = mul[a][nibble << 4];
+                }
+            }
+        }
+
+        uint8_t multiply(uint8_t a, uint8_t b) const { return mul[a][b]; }
+        uint8_t inverse(uint8_t a) const { return exp[255 - log[a]]; }
+    };
+
+
+    /**
+     * @brief Retorna as tabelas de GF(2^8).
+     */
+    const GaloisTables& tables() {
+        static GaloisTables* galois_tables = new GaloisTables();
+        return *galois_tables;
+    }
+
+
+    /**
+     * @brief Multiplica e acumula um bloco com a tabela completa, um byte por vez.
+     */
+    void multiplyAddScalar(uint8_t coefficient, const uint8_t* source, uint8_t* destination, size_t size) {
+        const uint8_t* row = tables().mul[coefficient];
+        for (size_t i = 0; i < size; ++i) {
+            destination[i] ^= row[source[i]];
+        }
+    }
+
+
+#ifdef ERASURE_X86
+    /**
+     * @brief Multiplica e acumula um bloco consultando as tabelas das metades com pshufb, 16 bytes por vez.
+     */
+    __attribute__((target("ssse3")))
+    void multiplyAddSSSE3(uint8_t coefficient, const uint8_t* source, uint8_t* destination, size_t size) {
+        const __m128i low_table = _mm_loadu_si128(reinterpret_cast<const __m128i*>(tables().low[coefficient]));
+        const __m128i high_table = _mm_loadu_si128(reinterpret_cast<const __m128i*>(tables().high[coefficient]));
+        const __m128i mask = _mm_set1_epi8(0x0f);
+
+        size_t i = 0;
+        for (; i + 16 <= size; i += 16) {
+            __m128i input = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + i));
+            __m128i low_product = _mm_shuffle_epi8(low_table, _mm_and_si128(input, mask));
+            __m128i high_product = _mm_shuffle_epi8(high_table, _mm_and_si128(_mm_srli_epi64(input, 4), mask));
+            __m128i output = _mm_loadu_si128(reinterpret_cast<const __m128i*>(destination + i));
+            output = _mm_xor_si128(output, _mm_xor_si128(low_product, high_product));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(destination + i), output);
+        }
+
+        // Bytes finais que não completam um registrador
+        multiplyAddScalar(coefficient, source + i, destination + i, size - i);
+    }
+
+
+    /**
+     * @brief Multiplica e acumula um bloco consultando as tabelas das metades com vpshufb, 32 bytes por vez.
+     */
+    __attribute__((target("avx2")))
+    void multiplyAddAVX2(uint8_t coefficient, const uint8_t* source, uint8_t* destination, size_t size) {
+        // vpshufb consulta cada metade de 128 bits separadamente, então a tabela é repetida nas duas
+        const __m256i low_table = _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(tables().low[coefficient])));
+        const __m256i high_table = _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(tables().high[coefficient])));
+        const __m256i mask = _mm256_set1_epi8(0x0f);
+
+        size_t i = 0;
+        for (; i + 32 <= size; i += 32) {
+            __m256i input = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(source + i));
+            __m256i low_product = _mm256_shuffle_epi8(low_table, _mm256_and_si256(input, mask));
+            __m256i high_product = _mm256_shuffle_epi8(high_table, _mm256_and_si256(_mm256_srli_epi64(input, 4), mask));
+            __m256i output = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(destination + i));
+            output = _mm256_xor_si256(output, _mm256_xor_si256(low_product, high_product));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(destination + i), output);
+        }
+
+        // Bytes finais que não completam um registrador
+        multiplyAddScalar(coefficient, source + i, destination + i, size - i);
+    }
+#endif
+}
+
+
+/**
+ * @brief Construtor da classe ErasureCoder.
+ */
+ErasureCoder::ErasureCoder(int data_chunks, int total_chunks, GaloisKernel kernel)
+    : data_chunks(data_chunks), total_chunks(total_chunks), kernel(isSupported(kernel) ? kernel : GaloisKernel::SCALAR) {
+    if (!isValid(data_chunks, total_chunks)) {
+        this->data_chunks = 0;
+        this->total_chunks = 0;
+        return;
+    }
+
+    // Linhas de dados: identidade, então os chunks de dados são o próprio arquivo
+    matrix.assign(static_cast<size_t>(total_chunks) * data_chunks, 0);
+    for (int row = 0; row < data_chunks; ++row) {
+        matrix[static_cast<size_t>(row) * data_chunks + row] = 1;
+    }
+
+    // Linhas de paridade: Cauchy 1 / (x_i ^ y_j), com x_i = k + i e y_j = j todos distintos.
+    // Toda submatriz quadrada de uma matriz de Cauchy é inversível, e juntá-la à identidade preserva isso
+    for (int row = data_chunks; row < total_chunks; ++row) {
+        for (int column = 0; column < data_chunks; ++column) {
+            matrix[static_cast<size_t>(row) * data_chunks + column] = tables().inverse(static_cast<uint8_t>(row ^ column));
+        }
+    }
+}
+
+
+/**
+ * @brief Calcula os chunks de paridade a partir dos chunks de dados.
+ */
+void ErasureCoder::encode(const std::vector<const char*>& data, const std::vector<char*>& parity, size_t size) const {
+    if (data.size() != static_cast<size_t>(data_chunks) || parity.size() != static_cast<size_t>(total_chunks - data_chunks)) {
+        return;
+    }
+
+    std::vector<uint8_t> rows(matrix.begin() + static_cast<size_t>(data_chunks) * data_chunks, matrix.end());
+    apply(rows, data, parity, size);
+}
+
+
+/**
+ * @brief Monta a matriz que calcula chunks de dados faltantes a partir de k chunks disponíveis.
+ */
+bool ErasureCoder::decodingMatrix(const std::vector<int>& source_ids, const std::vector<int>& missing_ids, std::vector<uint8_t>& rows) const {
+    const size_t k = static_cast<size_t>(data_chunks);
+    if (k == 0 || source_ids.size() != k) {
+        return false;
+    }
+
+    // Submatriz com as linhas dos chunks disponíveis, ao lado da identidade que recebe a inversa
+    std::vector<uint8_t> sub(k * k), inverse(k * k, 0);
+    for (size_t row = 0; row < k; ++row) {
+        int id = source_ids[row];
+        if (id < 0 || id >= total_chunks) {
+            return false;
+        }
+        std::memcpy(sub.data() + row * k, matrix.data() + static_cast<size_t>(id) * k, k);
+        inverse[row * k + row] = 1;
+    }
+
+    // Gauss-Jordan em GF(2^8): soma e subtração são XOR
+    const GaloisTables& gf = tables();
+    for (size_t column = 0; column < k; ++column) {
+        size_t pivot = column;
+        while (pivot < k && sub[pivot * k + column] == 0) {
+            ++pivot;
+        }
+        if (pivot == k) {
+            return false; // IDs repetidos
+        }
+        if (pivot != column) {
+            std::swap_ranges(sub.begin() + pivot * k, sub.begin() + (pivot + 1) * k, sub.begin() + column * k);
+            std::swap_ranges(inverse.begin() + pivot * k, inverse.begin() + (pivot + 1) * k, inverse.begin() + column * k);
+        }
+
+        uint8_t scale = gf.inverse(sub[column * k + column]);
+        for (size_t j = 0; j < k; ++j) {
+            sub[column * k + j] = gf.multiply(sub[column * k + j], scale);
+            inverse[column * k + j] = gf.multiply(inverse[column * k + j], scale);
+        }
+
+        for (size_t row = 0; row < k; ++row) {
+            uint8_t factor = sub[row * k + column];
+            if (row == column || factor == 0) {
+                continue;
+            }
+            for (size_t j = 0; j < k; ++j) {
+                sub[row * k + j] ^= gf.multiply(factor, sub[column * k + j]);
+                inverse[row * k + j] ^= gf.multiply(factor, inverse[column * k + j]);
+            }
+        }
+    }
+
+    // A linha i da inversa expressa o chunk de dados i em função dos chunks disponíveis
+    rows.clear();
+    rows.reserve(missing_ids.size() * k);
+    for (int id : missing_ids) {
+        if (id < 0 || id >= data_chunks) {
+            return false;
+        }
+        rows.insert(rows.end(), inverse.begin() + static_cast<size_t>(id) * k, inverse.begin() + static_cast<size_t>(id + 1) * k);
+    }
+    return true;
+}
+
+
+/**
+ * @brief Aplica uma matriz de coeficientes aos chunks de origem.
+ */
+void ErasureCoder::apply(const std::vector<uint8_t>& rows, const std::vector<const char*>& sources, const std::vector<char*>& outputs, size_t size) const {
+    if (rows.size() != sources.size() * outputs.size()) {
+        return;
+    }
+
+    // Percorre os chunks em blocos que cabem no cache L1, reaproveitando cada bloco de origem em todas as saídas
+    const size_t block_size = 16 << 10;
+    for (size_t offset = 0; offset < size; offset += block_size) {
+        size_t length = std::min(block_size, size - offset);
+        for (size_t output = 0; output < outputs.size(); ++output) {
+            std::memset(outputs[output] + offset, 0, length);
+            for (size_t source = 0; source < sources.size(); ++source) {
+                uint8_t coefficient = rows[output * sources.size() + source];
+                if (coefficient != 0) {
+                    multiplyAdd(kernel, coefficient, sources[source] + offset, outputs[output] + offset, length);
+                }
+            }
+        }
+    }
+}
+
+
+/**
+ * @brief Indica se um par (k, n) pode ser codificado.
+ */
+bool ErasureCoder::isValid(int data_chunks, int total_chunks) {
+    return data_chunks > 0 && total_chunks >= data_chunks && total_chunks <= Constants::ERASURE_MAX_CHUNKS;
+}
+
+
+/**
+ * @brief Retorna a implementação mais rápida suportada pelo processador.
+ */
+GaloisKernel ErasureCoder::bestKernel() {
+    if (isSupported(GaloisKernel::AVX2)) {
+        return GaloisKernel::AVX2;
+    }
+    if (isSupported(GaloisKernel::SSSE3)) {
+        return GaloisKernel::SSSE3;
+    }
+    return GaloisKernel::SCALAR;
+}
+
+
+/**
+ * @brief Indica se o processador suporta uma implementação.
+ */
+bool ErasureCoder::isSupported(GaloisKernel kernel) {
+    switch (kernel) {
+#ifdef ERASURE_X86
+        case GaloisKernel::AVX2:
+            return __builtin_cpu_supports("avx2");
+        case GaloisKernel::SSSE3:
+            return __builtin_cpu_supports("ssse3");
+#endif
+        case GaloisKernel::SCALAR:
+            return true;
+        default:
+            return false;
+    }
+}
+
+
+/**
+ * @brief Converte uma implementação para texto.
+ */
+const char* ErasureCoder::kernelToString(GaloisKernel kernel) {
+    switch (kernel) {
+        case GaloisKernel::AVX2:
+            return "avx2";
+        case GaloisKernel::SSSE3:
+            return "ssse3";
+        default:
+            return "scalar";
+    }
+}
+
+
+/**
+ * @brief Soma a um bloco o produto de outro bloco por um coeficiente.
+ */
+void ErasureCoder::multiplyAdd(GaloisKernel kernel, uint8_t coefficient, const char* source, char* destination, size_t size) {
+    const uint8_t* input = reinterpret_cast<const uint8_t*>(source);
+    uint8_t* output = reinterpret_cast<uint8_t*>(destination);
+
+    if (coefficient == 0) {
+        return;
+    }
+    if (coefficient == 1) {
+        for (size_t i = 0; i < size; ++i) {
+            output[i] ^= input[i];
+        }
+        return;
+    }
+
+#ifdef ERASURE_X86
+    if (kernel == GaloisKernel::AVX2 && isSupported(kernel)) {
+        multiplyAddAVX2(coefficient, input, output, size);
+        return;
+    }
+    if (kernel == GaloisKernel::SSSE3 && isSupported(kernel)) {
+        multiplyAddSSSE3(coefficient, input, output, size);
+        return;
+    }
+#endif
+    multiplyAddScalar(coefficient, input, output, size);
+}
@@ -0,0 +1,136 @@
+#ifndef ERASURECODER_H
+#define ERASURECODER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+
+/**
+ * @brief Enumeração das implementações da multiplicação em GF(2^8) usadas pelo ErasureCoder.
+ */
+enum class GaloisKernel {
+    SCALAR,     ///< Tabela de multiplicação completa, um byte por vez.
+    SSSE3,      ///< Tabelas de 16 entradas das metades de cada byte, consultadas com pshufb (16 bytes por instrução).
+    AVX2        ///< As mesmas tabelas consultadas com vpshufb (32 bytes por instrução).
+};
+
+
+/**
+ * @brief Estrutura com a codificação de apagamento de um arquivo, lida da linha "erasure" do .p2p.
+ */
+struct ErasureScheme {
+    int data_chunks = 0;                                    ///< Chunks de dados (k); qualquer conjunto de k chunks reconstrói o arquivo (0: sem codificação).
+    uint64_t file_size = 0;                                 ///< Tamanho do arquivo original, sem o preenchimento do último chunk de dados.
+
+    /**
+     * @brief Indica se o arquivo foi publicado com codificação de apagamento.
+     */
+    bool enabled() const { return data_chunks > 0; }
+};
+
+
+/**
+ * @brief Classe que codifica e reconstrói chunks com Reed–Solomon sistemático em GF(2^8).
+ *
+ * Os k chunks de dados são os próprios pedaços do arquivo (chunks 0 a k-1) e os n - k chunks de
+ * paridade são combinações lineares deles, com os coeficientes de uma matriz de Cauchy. Qualquer
+ * submatriz k x k da matriz de codificação é inversível, então quaisquer k dos n chunks
+ * reconstroem os chunks de dados. Todos os chunks têm o mesmo tamanho.
+ *
+ * A multiplicação de um bloco por um coeficiente usa a melhor implementação disponível no
+ * processador (AVX2, SSSE3 ou a tabela completa), escolhida em tempo de execução.
+ */
+class ErasureCoder {
+private:
+    int data_chunks;                                        ///< Número de chunks de dados (k).
+    int total_chunks;                                       ///< Número total de chunks (n).
+    std::vector<uint8_t> matrix;                            ///< Matriz de codificação n x k: identidade nas k primeiras linhas e Cauchy nas demais.
+    GaloisKernel kernel;                                    ///< Implementação da multiplicação usada.
+
+public:
+    /**
+     * @brief Construtor da classe ErasureCoder.
+     *
+     * @param data_chunks Número de chunks de dados (k).
+     * @param total_chunks Número total de chunks (n), com n >= k e n <= Constants::ERASURE_MAX_CHUNKS.
+     * @param kernel Implementação da multiplicação (padrão: a melhor disponível).
+     */
+    ErasureCoder(int data_chunks, int total_chunks, GaloisKernel kernel = bestKernel());
+
+
+    /**
+     * @brief Calcula os chunks de paridade a partir dos chunks de dados.
+     *
+     * @param data Os k chunks de dados.
+     * @param parity Os n - k chunks de paridade, sobrescritos.
+     * @param size Número de bytes de cada chunk.
+     */
+    void encode(const std::vector<const char*>& data, const std::vector<char*>& parity, size_t size) const;
+
+
+    /**
+     * @brief Monta a matriz que calcula chunks de dados faltantes a partir de k chunks disponíveis.
+     *
+     * @param source_ids IDs dos k chunks disponíveis.
+     * @param missing_ids IDs dos chunks de dados a reconstruir.
+     * @param rows Recebe uma linha de k coeficientes por chunk faltante.
+     * @return true se os IDs são válidos.
+     */
+    bool decodingMatrix(const std::vector<int>& source_ids, const std::vector<int>& missing_ids, std::vector<uint8_t>& rows) const;
+
+
+    /**
+     * @brief Aplica uma matriz de coeficientes aos chunks de origem: outputs[i] = soma de rows[i][j] * sources[j].
+     *
+     * @param rows Coeficientes, com sources.size() colunas e outputs.size() linhas.
+     * @param sources Chunks de origem.
+     * @param outputs Chunks calculados, sobrescritos.
+     * @param size Número de bytes de cada chunk.
+     */
+    void apply(const std::vector<uint8_t>& rows, const std::vector<const char*>& sources, const std::vector<char*>& outputs, size_t size) const;
+
+
+    /**
+     * @brief Retorna a implementação da multiplicação usada.
+     */
+    GaloisKernel getKernel() const { return kernel; }
+
+
+    /**
+     * @brief Indica se um par (k, n) pode ser codificado.
+     */
+    static bool isValid(int data_chunks, int total_chunks);
+
+
+    /**
+     * @brief Retorna a implementação mais rápida suportada pelo processador.
+     */
+    static GaloisKernel bestKernel();
+
+
+    /**
+     * @brief Indica se o processador suporta uma implementação.
+     */
+    static bool isSupported(GaloisKernel kernel);
+
+
+    /**
+     * @brief Converte uma implementação para texto.
+     */
+    static const char* kernelToString(GaloisKernel kernel);
+
+
+    /**
+     * @brief Soma a um bloco o produto de outro bloco por um coeficiente: destination ^= coefficient * source.
+     *
+     * @param kernel Implementação usada (as não suportadas recorrem à tabela completa).
+     * @param coefficient Coeficiente em GF(2^8).
+     * @param source Bloco multiplicado.
+     * @param destination Bloco acumulado.
+     * @param size Número de bytes dos blocos.
+     */
+    static void multiplyAdd(GaloisKernel kernel, uint8_t coefficient, const char* source, char* destination, size_t size);
+};
+
+#endif // ERASURECODER_H
@@ -0,0 +1,88 @@
+#include "Executor.h"
+#include <algorithm>
+
+
+/**
+ * @brief Construtor da classe Executor. Cria as threads de execução.
+ */
+Executor::Executor(int num_threads) : stopping(false) {
+    for (int i = 0; i < std::max(1, num_threads); ++i) {
+        workers.emplace_back(&Executor::workerLoop, this);
+    }
+}
+
+
+/**
+ * @brief Destrutor da classe Executor. Executa as tarefas restantes e finaliza as threads.
+ */
+Executor::~Executor() {
+    {
+        std::lock_guard<std::mutex> tasks_lock(tasks_mutex);
+        stopping = true;
+    }
+    tasks_cv.notify_all();
+
+    for (auto& worker : workers) {
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+}
+
+
+/**
+ * @brief Adiciona uma tarefa à fila de execução.
+ */
+void Executor::submit(std::function<void()> task) {
+    {
+        std::lock_guard<std::mutex> tasks_lock(tasks_mutex);
+        tasks.push_back(std::move(task));
+    }
+    tasks_cv.notify_one();
+}
+
+
+/**
+ * @brief Fixa as threads do executor nos núcleos de um papel.
+ */
+void Executor::pin(const ThreadPlacement& placement, ThreadRole role) {
+    for (size_t i = 0; i < workers.size(); ++i) {
+        CpuTopology::pinThread(workers[i], placement.cpusFor(role, static_cast<int>(i)));
+    }
+}
+
+
+/**
+ * @brief Retorna o número de tarefas aguardando execução.
+ */
+size_t Executor::pendingTasks() {
+    std::lock_guard<std::mutex> tasks_lock(tasks_mutex);
+    return tasks.size();
+}
+
+
+/**
+ * @brief Loop executado por cada thread, retirando e executando tarefas da fila.
+ */
+void Executor::workerLoop() {
+    while (true) {
+        std::function<void()> task;
+
+        {
+            std::unique_lock<std::mutex> tasks_lock(tasks_mutex);
+
+            // Espera até haver uma tarefa ou o executor ser finalizado
+            tasks_cv.wait(tasks_lock, [this] { return stopping || !tasks.empty(); });
+
+            // Só termina depois de esvaziar a fila
+            if (tasks.empty()) {
+                return;
+            }
+
+            task = std::move(tasks.front());
+            tasks.pop_front();
+        }
+
+        task();
+    }
+}
@@ -0,0 +1,73 @@
+#ifndef EXECUTOR_H
+#define EXECUTOR_H
+
+#include "CpuTopology.h"
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+
+/**
+ * @brief Classe que executa tarefas em um conjunto fixo de threads.
+ *
+ * Em vez de criar uma thread para cada trabalho, as tarefas são colocadas em uma fila
+ * e executadas, na ordem de chegada, por um número pequeno e fixo de threads. As
+ * threads são criadas no construtor e finalizadas no destrutor, após a fila esvaziar.
+ */
+class Executor {
+private:
+    std::vector<std::thread> workers;                       ///< Threads que executam as tarefas.
+    std::deque<std::function<void()>> tasks;                ///< Fila de tarefas pendentes.
+    std::mutex tasks_mutex;                                 ///< Mutex para proteger o acesso à fila de tarefas.
+    std::condition_variable tasks_cv;                       ///< Variável de condição para acordar as threads quando há tarefas.
+    bool stopping;                                          ///< Indica que o executor está sendo finalizado.
+
+    /**
+     * @brief Loop executado por cada thread, retirando e executando tarefas da fila.
+     */
+    void workerLoop();
+
+public:
+    /**
+     * @brief Construtor da classe Executor. Cria as threads de execução.
+     *
+     * @param num_threads Número de threads do executor (no mínimo 1).
+     */
+    explicit Executor(int num_threads);
+
+
+    /**
+     * @brief Destrutor da classe Executor. Executa as tarefas restantes e finaliza as threads.
+     */
+    ~Executor();
+
+
+    /**
+     * @brief Adiciona uma tarefa à fila de execução.
+     *
+     * @param task Tarefa a ser executada por uma das threads.
+     */
+    void submit(std::function<void()> task);
+
+
+    /**
+     * @brief Fixa as threads do executor nos núcleos de um papel, a i-ésima thread no i-ésimo núcleo.
+     *
+     * @param placement Núcleos das threads do peer.
+     * @param role Papel das threads do executor.
+     */
+    void pin(const ThreadPlacement& placement, ThreadRole role);
+
+
+    /**
+     * @brief Retorna o número de tarefas aguardando execução.
+     *
+     * @return Tamanho da fila de tarefas.
+     */
+    size_t pendingTasks();
+};
+
+#endif // EXECUTOR_H
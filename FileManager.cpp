@@ -1,13 +1,139 @@
 #include "FileManager.h"
+#include "Metrics.h"
+#include "WorkStealingExecutor.h"
+#include <algorithm>
+#include <cstdio>
 #include <filesystem>
 #include <fstream>
 #include <iostream>
+#include <iterator>
+#include <limits>
+#include <string_view>
+#include <thread>
+#include <fcntl.h>
+#include <unistd.h>
+
+
+namespace {
+    /**
+     * @brief Retorna o nome de um modo de descoberta, como escrito no .p2p.
+     */
+    const char* discoveryModeName(DiscoveryMode mode) {
+        switch (mode) {
+            case DiscoveryMode::DHT:
+                return "dht";
+            case DiscoveryMode::AGGREGATE:
+                return "aggregate";
+            default:
+                return "flood";
+        }
+    }
+
+
+    /**
+     * @brief Função de hash de um detentor identificado por IP e porta.
+     */
+    struct HolderHash {
+        size_t operator()(const std::pair<std::string_view, int>& holder) const {
+            return std::hash<std::string_view>()(holder.first) * 31 + static_cast<size_t>(holder.second);
+        }
+    };
+
+
+    /**
+     * @brief Fecha os descritores abertos de uma lista.
+     */
+    void closeAll(const std::vector<int>& fds) {
+        for (int fd : fds) {
+            if (fd >= 0) {
+                close(fd);
+            }
+        }
+    }
+
+
+    /**
+     * @brief Cria um chunk com o conteúdo de outro: um link físico ou, se não for possível, uma cópia.
+     */
+    bool linkOrCopyChunk(const std::string& source_path, const std::string& target_path) {
+        namespace fs = std::filesystem;
+
+        // Criado com outro nome (ignorado por loadLocalChunks) e renomeado: roda sem local_chunks_mutex, então
+        // uma gravação do mesmo chunk pode ocorrer ao mesmo tempo e nenhuma das duas deixa o chunk incompleto
+        std::string temporary_path = target_path + ".link";
+        std::error_code error;
+        fs::remove(temporary_path, error);
+        fs::create_hard_link(source_path, temporary_path, error);
+        if (error) {
+            // Outro sistema de arquivos ou sem suporte a links
+            error.clear();
+            fs::copy_file(source_path, temporary_path, fs::copy_options::overwrite_existing, error);
+        }
+        if (!error) {
+            fs::rename(temporary_path, target_path, error);
+        }
+        if (error) {
+            fs::remove(temporary_path, error);
+            return false;
+        }
+        return true;
+    }
+
+
+    /**
+     * @brief Confere o tamanho e o resumo SHA-256 de um chunk gravado no disco.
+     */
+    bool chunkMatches(const std::string& path, const ChunkDescriptor& descriptor) {
+        std::error_code error;
+        if (std::filesystem::file_size(path, error) != descriptor.size || error) {
+            return false;
+        }
+
+        std::ifstream file(path, std::ios::binary);
+        if (!file.is_open()) {
+            return false;
+        }
+
+        Sha256 sha256;
+        std::vector<char> block(Constants::IO_BLOCK_SIZE);
+        while (file.read(block.data(), block.size()) || file.gcount() > 0) {
+            sha256.update(block.data(), static_cast<size_t>(file.gcount()));
+        }
+        return sha256.finish() == descriptor.digest;
+    }
+}
 
 
 /**
  * @brief Construtor da classe FileManager.
  */
-FileManager::FileManager(const std::string& peer_id) : peer_id(peer_id) {}
+FileManager::FileManager(const std::string& peer_id, const std::string& base_path, const TimingConfig& timing)
+    : peer_id(peer_id), base_path(base_path), availability_cache(timing.availability_cache_ttl, Constants::AVAILABILITY_CACHE_MAX_ENTRIES),
+      io_engine(&IOEngine::blockingEngine()), executor(nullptr) {}
+
+
+/**
+ * @brief Define a função avisada quando saveChunk adiciona um chunk local.
+ */
+void FileManager::setLocalChunksListener(std::function<void(const std::string&, int, const ChunkLocationInfo&)> listener) {
+    local_chunks_listener = std::move(listener);
+}
+
+
+/**
+ * @brief Associa a implementação de E/S usada na gravação dos chunks e na montagem do arquivo final.
+ */
+void FileManager::setIOEngine(IOEngine* io_engine) {
+    this->io_engine = io_engine;
+}
+
+
+/**
+ * @brief Associa o executor que monta os arquivos completos.
+ */
+void FileManager::setExecutor(WorkStealingExecutor* executor) {
+    this->executor = executor;
+}
 
 
 /**
@@ -15,8 +141,7 @@ FileManager::FileManager(const std::string& peer_id) : peer_id(peer_id) {}
  */
 void FileManager::loadLocalChunks() {
     // Setando o diretório dos arquivos
-    directory = Constants::BASE_PATH + peer_id;
-    std::set<std::string> unique_file_names;
+    directory = base_path + peer_id;
 
     namespace fs = std::filesystem;
 
@@ -27,19 +152,25 @@ void FileManager::loadLocalChunks() {
     for (const auto& entry : fs::directory_iterator(directory)) {
         std::string filename = entry.path().filename().string();
 
-        // Formato esperado: <nome>.ch<chunk>
-        size_t pos = filename.find(".ch");
-        if (pos != std::string::npos) {
+        // Formato esperado: <nome>.ch<chunk>; os chunks parciais (.part), as gravações interrompidas (.tmp<thread>) e os links (.link) são ignorados
+        size_t pos = filename.rfind(".ch");
+        if (pos != std::string::npos && pos + 3 < filename.size() && filename.find_first_not_of("0123456789", pos + 3) == std::string::npos) {
             std::string file_name = filename.substr(0, pos);
             int chunk_id = std::stoi(filename.substr(pos + 3));
             local_chunks[file_name].insert(chunk_id);
-
-             unique_file_names.insert(file_name);
         }
     }
 
-    for (const auto& file_name : unique_file_names) {
-        local_chunks_mutex.try_emplace(file_name);
+    // Indexa pelo conteúdo os chunks dos arquivos publicados com os resumos. O índice serve os pedidos pelo
+    // nome de conteúdo e os links de outros arquivos, então só entram os chunks cujo conteúdo confere com o resumo
+    for (const auto& [file_name, chunks] : local_chunks) {
+        std::vector<ChunkDescriptor> descriptors = loadChunkDescriptors(file_name);
+        for (int chunk : chunks) {
+            if (chunk >= 0 && static_cast<size_t>(chunk) < descriptors.size() &&
+                chunkMatches(getChunkPath(file_name, chunk), descriptors[chunk])) {
+                chunk_store.add(descriptors[chunk].digest, {file_name, chunk});
+            }
+        }
     }
 }
 
@@ -47,34 +178,295 @@ void FileManager::loadLocalChunks() {
 /**
  * @brief Carrega os metadados de um arquivo e retorna as informações.
  */ 
-std::tuple<std::string, int, int> FileManager::loadMetadata(const std::string& file_name) {
-    std::string metadata_path = Constants::BASE_PATH + file_name + ".p2p";
+std::tuple<std::string, int, int, DiscoveryMode, ErasureScheme> FileManager::loadMetadata(const std::string& file_name) {
+    std::string metadata_path = base_path + file_name + ".p2p";
     std::ifstream meta_file(metadata_path);
     
     if (!meta_file.is_open()) {
-        logMessage(LogType::ERROR, "Erro ao abrir o arquivo de metadados para " + file_name + ". Verifique se o arquivo de metadados " + file_name + ".p2p se encontra em " + Constants::BASE_PATH);
-        return {"", -1, -1}; // Retorno padrão em caso de erro
+        LOG_MESSAGE(LogType::ERROR, "Erro ao abrir o arquivo de metadados para " + file_name + ". Verifique se o arquivo de metadados " + file_name + ".p2p se encontra em " + base_path);
+        return {"", -1, -1, DiscoveryMode::FLOOD, ErasureScheme()}; // Retorno padrão em caso de erro
     }
 
     std::string file_name_returned;
     int total_chunks;
     int initial_ttl;
+    std::string mode_name, word;
+    ErasureScheme erasure_scheme;
 
     // Lê os dados do arquivo de metadados
     std::getline(meta_file, file_name_returned);
     meta_file >> total_chunks;
     meta_file >> initial_ttl;
+
+    // Linhas opcionais: o modo de descoberta (arquivos antigos usam a inundação), a codificação de apagamento
+    // e os tamanhos e resumos dos chunks, gravados pelo p2p-publish
+    while (meta_file >> word) {
+        if (word == "erasure") {
+            meta_file >> erasure_scheme.data_chunks >> erasure_scheme.file_size;
+        } else if (word == "chunk") {
+            meta_file.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+        } else if (mode_name.empty()) {
+            mode_name = word;
+        }
+    }
     meta_file.close();
 
-    return {file_name_returned, total_chunks, initial_ttl}; // Retorna os valores em uma tupla
+    if (erasure_scheme.enabled() && !ErasureCoder::isValid(erasure_scheme.data_chunks, total_chunks)) {
+        LOG_MESSAGE(LogType::ERROR, "Codificação de apagamento inválida em " + file_name + ".p2p. O arquivo será tratado como não codificado.");
+        erasure_scheme = ErasureScheme();
+    }
+
+    DiscoveryMode discovery_mode = DiscoveryMode::FLOOD;
+    if (mode_name == "dht") {
+        discovery_mode = DiscoveryMode::DHT;
+    } else if (mode_name == "aggregate") {
+        discovery_mode = DiscoveryMode::AGGREGATE;
+    } else if (!mode_name.empty() && mode_name != "flood") {
+        LOG_MESSAGE(LogType::ERROR, "Modo de descoberta desconhecido '" + mode_name + "' em " + file_name + ".p2p. Usando flood.");
+    }
+
+    return {file_name_returned, total_chunks, initial_ttl, discovery_mode, erasure_scheme}; // Retorna os valores em uma tupla
+}
+
+
+/**
+ * @brief Carrega o tamanho e o resumo de cada chunk das linhas "chunk" do .p2p de um arquivo.
+ */
+std::vector<ChunkDescriptor> FileManager::loadChunkDescriptors(const std::string& file_name) {
+    std::ifstream meta_file(base_path + file_name + ".p2p");
+    std::vector<ChunkDescriptor> descriptors;
+    int total_chunks = 0;
+    std::string line;
+
+    // O nome, o número de chunks e o TTL ocupam as três primeiras linhas
+    if (!std::getline(meta_file, line) || !(meta_file >> total_chunks) || total_chunks <= 0) {
+        return descriptors;
+    }
+
+    std::string word;
+    std::vector<bool> present(total_chunks, false);
+    descriptors.resize(total_chunks);
+    while (meta_file >> word) {
+        if (word != "chunk") {
+            continue;
+        }
+        int chunk = -1;
+        ChunkDescriptor descriptor;
+        std::string hex;
+        if (!(meta_file >> chunk >> descriptor.size >> hex) || chunk < 0 || chunk >= total_chunks ||
+            !Sha256::fromHex(hex, descriptor.digest)) {
+            LOG_MESSAGE(LogType::ERROR, "Linha \"chunk\" inválida em " + file_name + ".p2p. Os resumos dos chunks serão ignorados.");
+            return {};
+        }
+        descriptors[chunk] = descriptor;
+        present[chunk] = true;
+    }
+
+    // Sem o resumo de todos os chunks, o arquivo é tratado como um arquivo sem resumos
+    if (std::find(present.begin(), present.end(), false) != present.end()) {
+        return {};
+    }
+    return descriptors;
+}
+
+
+/**
+ * @brief Grava o arquivo de metadados (.p2p) de um arquivo publicado.
+ */
+bool FileManager::saveMetadata(const std::string& file_name, int total_chunks, int initial_ttl, DiscoveryMode discovery_mode,
+                               const ErasureScheme& scheme, const std::vector<ChunkDescriptor>& chunks) {
+    std::string metadata_path = base_path + file_name + ".p2p";
+
+    // Grava em um arquivo temporário e o renomeia, para que um peer nunca leia metadados pela metade
+    std::string temporary_path = metadata_path + ".tmp";
+    {
+        std::ofstream meta_file(temporary_path);
+        meta_file << file_name << "\n" << total_chunks << "\n" << initial_ttl << "\n" << discoveryModeName(discovery_mode) << "\n";
+        if (scheme.enabled()) {
+            meta_file << "erasure " << scheme.data_chunks << " " << scheme.file_size << "\n";
+        }
+        for (size_t chunk = 0; chunk < chunks.size(); ++chunk) {
+            meta_file << "chunk " << chunk << " " << chunks[chunk].size << " " << Sha256::toHex(chunks[chunk].digest) << "\n";
+        }
+        if (!meta_file.flush()) {
+            LOG_MESSAGE(LogType::ERROR, "Erro ao gravar " + metadata_path + ".");
+            return false;
+        }
+    }
+
+    std::error_code error;
+    std::filesystem::rename(temporary_path, metadata_path, error);
+    if (error) {
+        LOG_MESSAGE(LogType::ERROR, "Erro ao gravar " + metadata_path + ": " + error.message());
+        return false;
+    }
+    return true;
 }
 
 
 /**
  * @brief Inicializa o número de chunks de um arquivo.
  */
-void FileManager::initializeFileChunks(const std::string& file_name, int total_chunks) {
-    file_chunks[file_name] = total_chunks;
+void FileManager::initializeFileChunks(const std::string& file_name, int total_chunks, const ErasureScheme& scheme,
+                                       const std::vector<ChunkDescriptor>& descriptors) {
+    {
+        std::lock_guard<std::mutex> file_chunks_lock(file_chunks_mutex);
+        file_chunks[file_name] = total_chunks;
+        if (scheme.enabled()) {
+            erasure_schemes[file_name] = scheme;
+        } else {
+            erasure_schemes.erase(file_name);
+        }
+        if (descriptors.size() == static_cast<size_t>(total_chunks)) {
+            chunk_descriptors[file_name] = descriptors;
+        } else {
+            chunk_descriptors.erase(file_name);
+        }
+    }
+
+    // Fora do bloqueio de file_chunks, que vem depois do de local_chunks
+    reuseStoredChunks(file_name);
+}
+
+
+/**
+ * @brief Retorna o tamanho e o resumo de um chunk, se o .p2p do arquivo os trouxe.
+ */
+bool FileManager::getChunkDescriptor(const std::string& file_name, int chunk, ChunkDescriptor& descriptor) {
+    std::lock_guard<std::mutex> file_chunks_lock(file_chunks_mutex);
+
+    auto it = chunk_descriptors.find(file_name);
+    if (it == chunk_descriptors.end() || chunk < 0 || static_cast<size_t>(chunk) >= it->second.size()) {
+        return false;
+    }
+    descriptor = it->second[chunk];
+    return true;
+}
+
+
+/**
+ * @brief Preenche os chunks faltantes de um arquivo com chunks locais de mesmo conteúdo.
+ */
+void FileManager::reuseStoredChunks(const std::string& file_name) {
+    std::vector<ChunkDescriptor> descriptors;
+    {
+        std::lock_guard<std::mutex> file_chunks_lock(file_chunks_mutex);
+        auto it = chunk_descriptors.find(file_name);
+        if (it == chunk_descriptors.end()) {
+            return;
+        }
+        descriptors = it->second;
+    }
+
+    // Sob o bloqueio, só as consultas: os chunks locais ainda fora do índice e as origens dos faltantes
+    std::vector<int> unindexed;
+    std::vector<std::pair<int, ChunkLocation>> sources;
+    {
+        std::lock_guard<std::mutex> local_chunks_lock(local_chunks_mutex);
+        const std::set<int>& chunks = local_chunks[file_name];
+
+        for (size_t chunk = 0; chunk < descriptors.size(); ++chunk) {
+            ChunkLocation location{file_name, static_cast<int>(chunk)};
+            const Sha256::Digest& digest = descriptors[chunk].digest;
+
+            ChunkLocation source;
+            bool indexed = chunk_store.find(digest, source);
+            if (chunks.count(location.chunk) > 0) {
+                if (indexed) {
+                    chunk_store.add(digest, location);
+                } else {
+                    unindexed.push_back(location.chunk);
+                }
+            } else if (indexed) {
+                // O conteúdo pode estar em outro arquivo ou em outra posição deste
+                sources.emplace_back(location.chunk, source);
+            } else {
+                chunk_store.want(digest, location);
+            }
+        }
+    }
+
+    // A leitura dos resumos e os links e cópias rodam sem o bloqueio, que atrasaria as gravações dos chunks recebidos
+    std::vector<int> verified;
+    for (int chunk : unindexed) {
+        if (chunkMatches(getChunkPath(file_name, chunk), descriptors[chunk])) {
+            verified.push_back(chunk);
+        }
+    }
+    std::vector<int> linked;
+    for (const auto& [chunk, source] : sources) {
+        // A origem é conferida antes do link: o arquivo pode ter mudado no disco depois de indexado
+        if (chunkMatches(getChunkPath(source.file_name, source.chunk), descriptors[chunk]) &&
+            linkOrCopyChunk(getChunkPath(source.file_name, source.chunk), getChunkPath(file_name, chunk))) {
+            linked.push_back(chunk);
+        } else {
+            chunk_store.want(descriptors[chunk].digest, {file_name, chunk});
+        }
+    }
+
+    size_t reused = 0;
+    {
+        std::lock_guard<std::mutex> local_chunks_lock(local_chunks_mutex);
+        std::set<int>& chunks = local_chunks[file_name];
+
+        for (int chunk : verified) {
+            chunk_store.add(descriptors[chunk].digest, {file_name, chunk});
+        }
+        for (int chunk : linked) {
+            chunk_store.add(descriptors[chunk].digest, {file_name, chunk});
+            // Um chunk recebido durante o link já foi registrado e avisado por saveChunk
+            if (!chunks.insert(chunk).second) {
+                continue;
+            }
+            ++reused;
+            if (local_chunks_listener) {
+                local_chunks_listener(file_name, chunk, ChunkLocationInfo());
+            }
+        }
+    }
+
+    if (reused > 0) {
+        Metrics::instance().add(Counter::CHUNKS_DEDUPLICATED, "local=" + peer_id + ",file=" + file_name, reused);
+        LOG_MESSAGE(LogType::INFO, std::to_string(reused) + " de " + std::to_string(descriptors.size()) + " chunks de " + file_name +
+                    " reaproveitados de chunks locais com o mesmo conteúdo.");
+    }
+}
+
+
+/**
+ * @brief Retorna o número total de chunks de um arquivo.
+ */
+int FileManager::getTotalChunks(const std::string& file_name) {
+    std::lock_guard<std::mutex> file_chunks_lock(file_chunks_mutex);
+
+    auto it = file_chunks.find(file_name);
+    return it != file_chunks.end() ? it->second : 0;
+}
+
+
+/**
+ * @brief Retorna a codificação de apagamento de um arquivo.
+ */
+ErasureScheme FileManager::getErasureScheme(const std::string& file_name) {
+    std::lock_guard<std::mutex> file_chunks_lock(file_chunks_mutex);
+
+    auto it = erasure_schemes.find(file_name);
+    return it != erasure_schemes.end() ? it->second : ErasureScheme();
+}
+
+
+/**
+ * @brief Retorna o número de chunks necessários para montar um arquivo.
+ */
+int FileManager::getRequiredChunks(const std::string& file_name) {
+    std::lock_guard<std::mutex> file_chunks_lock(file_chunks_mutex);
+
+    auto scheme_it = erasure_schemes.find(file_name);
+    if (scheme_it != erasure_schemes.end()) {
+        return scheme_it->second.data_chunks;
+    }
+    auto it = file_chunks.find(file_name);
+    return it != file_chunks.end() ? it->second : 0;
 }
 
 
@@ -82,15 +474,14 @@ void FileManager::initializeFileChunks(const std::string& file_name, int total_c
  * @brief Inicializa a estrutura para armazenar informações sobre onde encontrar cada chunk.
  */
 void FileManager::initializeChunkLocationInfo(const std::string& file_name) {
-    int total_chunks = file_chunks[file_name];
+    int total_chunks = getTotalChunks(file_name);
+
+    std::lock_guard<std::mutex> location_lock(chunk_location_info_mutex);
 
     // Verifica se já existe uma entrada para o file_name
     if (chunk_location_info.find(file_name) == chunk_location_info.end()) {
         chunk_location_info[file_name].resize(total_chunks); // Inicializa com vetores vazios para cada chunk
     }
-
-    // Inicializa os mutexes responsáveis por sincronizar o acesso ao mapa da localização dos chunks de um arquivo
-    chunk_location_info_mutex.try_emplace(file_name);
 }
 
 
@@ -98,6 +489,8 @@ void FileManager::initializeChunkLocationInfo(const std::string& file_name) {
  * @brief Limpa as informações de localização dos chunks e remove o mutex associado a um arquivo específico.
  */
 void FileManager::clearChunkLocationInfo(const std::string& file_name) {
+    std::lock_guard<std::mutex> location_lock(chunk_location_info_mutex);
+
     // Verifica se o arquivo existe no mapa
     auto it = chunk_location_info.find(file_name);
     if (it != chunk_location_info.end()) {
@@ -108,12 +501,9 @@ void FileManager::clearChunkLocationInfo(const std::string& file_name) {
         // Apaga a entrada completa do map
         chunk_location_info.erase(it);
     }
-
-    // Remove o mutex associado ao file_name
-    auto mutex_it = chunk_location_info_mutex.find(file_name);
-    if (mutex_it != chunk_location_info_mutex.end()) {
-        chunk_location_info_mutex.erase(mutex_it);
-    }
+    requested_chunks.erase(file_name);
+    content_holders.erase(file_name);
+    chunk_store.forgetWanted(file_name);
 }
 
 
@@ -122,52 +512,116 @@ void FileManager::clearChunkLocationInfo(const std::string& file_name) {
  */
 std::unordered_map<std::string, std::vector<int>> FileManager::selectPeersForChunkDownload(const std::string& file_name) {
     std::unordered_map<std::string, std::vector<int>> chunks_by_peer_map;
-    
-     std::vector<std::vector<ChunkLocationInfo>> chunks_with_peer_info;
 
+    // Os chunks locais são lidos antes de travar as informações de localização (mesma ordem de saveChunk)
+    std::vector<int> available_chunks = getAvailableChunks(file_name);
+    ErasureScheme scheme = getErasureScheme(file_name);
+
+    std::size_t unavailable_chunks = 0;
     {
-        std::lock_guard file_lock(chunk_location_info_mutex[file_name]);
-        chunks_with_peer_info = chunk_location_info.at(file_name);
-    }
-
-    std::size_t total_chunks_in_file = chunks_with_peer_info.size();
-
-    // Itera sobre cada chunk do arquivo
-    for (std::size_t chunk_index = 0; chunk_index < total_chunks_in_file; ++chunk_index) {
-        const auto& available_peers_for_chunk = chunks_with_peer_info[chunk_index];
-
-        // Verifica se há peers disponíveis para o chunk atual
-        if (!available_peers_for_chunk.empty()) {
-            // Copia a lista de peers disponíveis e ordena pela velocidade de transferência (decrescente)
-            auto sorted_peers_by_speed = available_peers_for_chunk;
-            std::sort(sorted_peers_by_speed.begin(), sorted_peers_by_speed.end(), 
-                [](const ChunkLocationInfo& a, const ChunkLocationInfo& b) {
-                    return a.transfer_speed > b.transfer_speed;
-                });
-
-            // Inicializa o peer selecionado como o mais rápido e define a carga mínima como o número de chunks atribuídos a ele
-            ChunkLocationInfo selected_peer = sorted_peers_by_speed[0];
-            std::string selected_peer_key = selected_peer.ip + ":" + std::to_string(selected_peer.port);
-            int min_chunks_assigned = chunks_by_peer_map[selected_peer_key].size();
-
-            // Itera sobre os peers ordenados para encontrar o mais rápido com menos chunks atribuídos
-            for (const auto& peer : sorted_peers_by_speed) {
-                std::string current_peer_key = peer.ip + ":" + std::to_string(peer.port);
-                int chunks_assigned_to_current_peer = chunks_by_peer_map[current_peer_key].size();
-
-                // Se o peer atual tem menos chunks atribuídos, seleciona-o, em caso de empate, mantém a ordem de velocidade
-                if (chunks_assigned_to_current_peer < min_chunks_assigned) {
-                    selected_peer = peer;
-                    selected_peer_key = current_peer_key;
-                    min_chunks_assigned = chunks_assigned_to_current_peer;
+        std::lock_guard location_lock(chunk_location_info_mutex);
+
+        // O arquivo pode já ter sido montado e ter suas informações de localização removidas
+        auto it = chunk_location_info.find(file_name);
+        if (it == chunk_location_info.end()) {
+            return chunks_by_peer_map;
+        }
+
+        // A seleção é feita direto nas listas de detentores, sem copiá-las
+        const auto& chunks_with_peer_info = it->second;
+
+        // Chunks atribuídos a cada detentor, por (IP, porta) apontando para as listas de detentores, válidas sob o bloqueio:
+        // a busca pela carga de um detentor não monta uma string para cada detentor de cada chunk
+        std::unordered_map<std::pair<std::string_view, int>, std::vector<int>, HolderHash> chunks_by_holder;
+        std::size_t total_chunks_in_file = chunks_with_peer_info.size();
+        std::vector<bool> local(total_chunks_in_file, false);
+        for (int chunk : available_chunks) {
+            if (chunk >= 0 && static_cast<std::size_t>(chunk) < total_chunks_in_file) {
+                local[chunk] = true;
+            }
+        }
+
+        // Chunks faltantes a pedir: todos ou, com codificação de apagamento, só os que completam k
+        std::vector<std::size_t> wanted_chunks;
+        for (std::size_t chunk_index = 0; chunk_index < total_chunks_in_file; ++chunk_index) {
+            if (local[chunk_index]) {
+                continue;
+            }
+            if (chunks_with_peer_info[chunk_index].empty()) {
+                unavailable_chunks += !scheme.enabled();
+                continue;
+            }
+            wanted_chunks.push_back(chunk_index);
+        }
+
+        if (scheme.enabled()) {
+            // Qualquer conjunto de k chunks serve: os de detentor mais rápido vêm primeiro e, no empate,
+            // os chunks de dados, que dispensam a reconstrução
+            auto fastest_holder = [&](std::size_t chunk_index) {
+                int fastest = 0;
+                for (const auto& peer : chunks_with_peer_info[chunk_index]) {
+                    fastest = std::max(fastest, peer.transfer_speed);
+                }
+                return fastest;
+            };
+            std::stable_sort(wanted_chunks.begin(), wanted_chunks.end(), [&](std::size_t a, std::size_t b) {
+                return fastest_holder(a) > fastest_holder(b);
+            });
+
+            std::size_t local_count = static_cast<std::size_t>(std::count(local.begin(), local.end(), true));
+            std::size_t needed = static_cast<std::size_t>(scheme.data_chunks) > local_count ? scheme.data_chunks - local_count : 0;
+            unavailable_chunks = needed > wanted_chunks.size() ? needed - wanted_chunks.size() : 0;
+            if (wanted_chunks.size() > needed) {
+                wanted_chunks.resize(needed);
+            }
+            std::sort(wanted_chunks.begin(), wanted_chunks.end());
+        }
+
+        std::map<int, ChunkLocationInfo> selected_peers;
+
+        // Itera sobre cada chunk do arquivo que ainda não foi recebido em uma tentativa anterior
+        for (std::size_t chunk_index : wanted_chunks) {
+            const auto& available_peers_for_chunk = chunks_with_peer_info[chunk_index];
+
+            // Seleciona o peer com menos chunks atribuídos e, em caso de empate, o mais rápido
+            // (o mesmo resultado de ordenar uma cópia da lista por velocidade, sem a cópia e a ordenação)
+            const ChunkLocationInfo* selected_peer = nullptr;
+            std::vector<int>* selected_peer_chunks = nullptr;
+            for (const auto& peer : available_peers_for_chunk) {
+                // As referências aos valores do unordered_map continuam válidas quando ele cresce
+                std::vector<int>& chunks_assigned_to_current_peer = chunks_by_holder[{peer.ip, peer.port}];
+
+                if (selected_peer == nullptr || chunks_assigned_to_current_peer.size() < selected_peer_chunks->size() ||
+                    (chunks_assigned_to_current_peer.size() == selected_peer_chunks->size() && peer.transfer_speed > selected_peer->transfer_speed)) {
+                    selected_peer = &peer;
+                    selected_peer_chunks = &chunks_assigned_to_current_peer;
                 }
             }
 
             // Atribui o chunk ao peer selecionado, adicionando-o ao mapa de chunks para esse peer
-            chunks_by_peer_map[selected_peer_key].push_back(static_cast<int>(chunk_index));
+            selected_peer_chunks->push_back(static_cast<int>(chunk_index));
+            selected_peers[static_cast<int>(chunk_index)] = *selected_peer;
+        }
+
+        // Guarda as escolhas para confirmar no cache os chunks que chegarem
+        requested_chunks[file_name] = std::move(selected_peers);
+
+        // Só os peers escolhidos ganham a chave "ip:porta"; os consultados e não escolhidos para nenhum chunk não recebem REQUEST
+        for (auto& [holder, chunks] : chunks_by_holder) {
+            if (!chunks.empty()) {
+                chunks_by_peer_map.emplace(std::string(holder.first) + ":" + std::to_string(holder.second), std::move(chunks));
+            }
         }
     }
 
+    // Contabiliza as decisões: quantos chunks foram atribuídos a cada peer e quantos ficaram sem peer
+    for (const auto& [peer_key, chunks] : chunks_by_peer_map) {
+        Metrics::instance().add(Counter::SCHEDULER_CHUNKS_ASSIGNED, "local=" + peer_id + ",peer=" + peer_key, chunks.size());
+    }
+    if (unavailable_chunks > 0) {
+        Metrics::instance().add(Counter::SCHEDULER_CHUNKS_UNAVAILABLE, "local=" + peer_id + ",file=" + file_name, unavailable_chunks);
+    }
+
     return chunks_by_peer_map;
 }
 
@@ -176,43 +630,295 @@ std::unordered_map<std::string, std::vector<int>> FileManager::selectPeersForChu
  * @brief Armazena informações recebidas sobre a localização dos chunks.
  */
 void FileManager::storeChunkLocationInfo(const std::string& file_name, const std::vector<int>& chunk_ids, const std::string& ip, int port, int transfer_speed) {
-    // Bloqueia o mutex do arquivo uma vez até o final do escopo desse método
-    std::lock_guard<std::mutex> file_lock(chunk_location_info_mutex[file_name]);
+    // Resposta a um nome de conteúdo: o peer é detentor de todos os chunks faltantes com aquele conteúdo
+    Sha256::Digest digest;
+    if (ChunkStore::parseContentName(file_name, digest)) {
+        std::vector<ChunkLocation> locations = chunk_store.getWanted(digest);
+        std::string peer_key = ip + ":" + std::to_string(port);
+
+        std::lock_guard<std::mutex> location_lock(chunk_location_info_mutex);
+        for (const ChunkLocation& location : locations) {
+            auto it = chunk_location_info.find(location.file_name);
+            if (it != chunk_location_info.end() && static_cast<size_t>(location.chunk) < it->second.size()) {
+                addChunkLocationLocked(it->second[location.chunk], ip, port, transfer_speed);
+                content_holders[location.file_name][location.chunk].insert(peer_key);
+            }
+        }
+        return;
+    }
+
+    // O cache guarda a informação mesmo quando o arquivo não está sendo baixado
+    availability_cache.record(file_name, chunk_ids, ip, port, transfer_speed);
+
+    // Bloqueia o mutex uma vez até o final do escopo desse método
+    std::lock_guard<std::mutex> location_lock(chunk_location_info_mutex);
+
+    // O arquivo pode já ter sido montado e ter suas informações de localização removidas
+    auto it = chunk_location_info.find(file_name);
+    if (it == chunk_location_info.end()) {
+        return;
+    }
 
     // Para cada chunk_id, manipula a lista de peers
     for (const int chunk_id : chunk_ids) {
         // Verifica se o chunk_id está dentro do intervalo
-        if (static_cast<size_t>(chunk_id) < chunk_location_info[file_name].size()) {
-            // Pega referência direta da lista de chunks e verifica se o peer existe
-            auto& chunk_list = chunk_location_info[file_name][chunk_id];
-            bool peer_exists = std::any_of(chunk_list.begin(), chunk_list.end(), 
-                                           [&](const ChunkLocationInfo& cli) {
-                                               return cli.ip == ip && cli.port == port;
-                                           });
-            // Adiciona o peer caso ele não exista
-            if (!peer_exists) {
-                chunk_list.emplace_back(ip, port, transfer_speed);
-            }
+        if (chunk_id >= 0 && static_cast<size_t>(chunk_id) < it->second.size()) {
+            addChunkLocationLocked(it->second[chunk_id], ip, port, transfer_speed);
         } else {
-            logMessage(LogType::ERROR, "chunk_id " + std::to_string(chunk_id) + " está fora do intervalo para o arquivo: " + file_name);
+            LOG_MESSAGE(LogType::ERROR, "chunk_id " + std::to_string(chunk_id) + " está fora do intervalo para o arquivo: " + file_name);
         }
     }
 }
 
 
+/**
+ * @brief Retorna o nome pelo qual um chunk deve ser pedido a um peer.
+ */
+std::string FileManager::getContentName(const std::string& file_name, int chunk, const std::string& peer_key) {
+    {
+        std::lock_guard<std::mutex> location_lock(chunk_location_info_mutex);
+
+        auto file_it = content_holders.find(file_name);
+        if (file_it == content_holders.end()) {
+            return "";
+        }
+        auto chunk_it = file_it->second.find(chunk);
+        if (chunk_it == file_it->second.end() || chunk_it->second.count(peer_key) == 0) {
+            return "";
+        }
+    }
+
+    ChunkDescriptor descriptor;
+    return getChunkDescriptor(file_name, chunk, descriptor) ? ChunkStore::contentName(descriptor.digest) : "";
+}
+
+
+/**
+ * @brief Retorna os nomes de conteúdo dos chunks faltantes de um arquivo que não têm nenhum detentor conhecido.
+ */
+std::vector<std::string> FileManager::getUncoveredContentNames(const std::string& file_name, size_t max_names) {
+    std::vector<std::string> names;
+
+    // Os chunks locais são lidos antes de travar as informações de localização (mesma ordem de saveChunk)
+    std::vector<int> available_chunks = getAvailableChunks(file_name);
+    std::set<int> local(available_chunks.begin(), available_chunks.end());
+
+    std::vector<ChunkDescriptor> descriptors;
+    {
+        std::lock_guard<std::mutex> file_chunks_lock(file_chunks_mutex);
+        auto it = chunk_descriptors.find(file_name);
+        if (it == chunk_descriptors.end()) {
+            return names;
+        }
+        descriptors = it->second;
+    }
+
+    std::lock_guard<std::mutex> location_lock(chunk_location_info_mutex);
+    auto it = chunk_location_info.find(file_name);
+    if (it == chunk_location_info.end()) {
+        return names;
+    }
+
+    for (size_t chunk = 0; chunk < descriptors.size() && chunk < it->second.size() && names.size() < max_names; ++chunk) {
+        if (local.count(static_cast<int>(chunk)) == 0 && it->second[chunk].empty()) {
+            names.push_back(ChunkStore::contentName(descriptors[chunk].digest));
+        }
+    }
+    return names;
+}
+
+
+/**
+ * @brief Copia os detentores conhecidos no cache de disponibilidade para as informações de localização dos chunks.
+ */
+std::tuple<int, int> FileManager::applyCachedChunkLocationInfo(const std::string& file_name) {
+    auto cached_peers = availability_cache.lookup(file_name);
+
+    // Os chunks locais são lidos antes de travar as informações de localização (mesma ordem de saveChunk)
+    std::vector<int> available_chunks = getAvailableChunks(file_name);
+    std::set<int> local(available_chunks.begin(), available_chunks.end());
+    ErasureScheme scheme = getErasureScheme(file_name);
+
+    int missing = 0, uncovered = 0;
+    {
+        std::lock_guard<std::mutex> location_lock(chunk_location_info_mutex);
+
+        auto it = chunk_location_info.find(file_name);
+        if (it == chunk_location_info.end()) {
+            return {0, 0};
+        }
+
+        for (const auto& [ip, port, transfer_speed, chunks] : cached_peers) {
+            for (int chunk : chunks) {
+                if (chunk >= 0 && static_cast<size_t>(chunk) < it->second.size() && local.count(chunk) == 0) {
+                    addChunkLocationLocked(it->second[chunk], ip, port, transfer_speed);
+                }
+            }
+        }
+
+        for (size_t chunk = 0; chunk < it->second.size(); ++chunk) {
+            if (local.count(static_cast<int>(chunk)) == 0) {
+                ++missing;
+                uncovered += it->second[chunk].empty();
+            }
+        }
+
+        // Com codificação de apagamento faltam só os chunks que completam k, de quaisquer detentores
+        if (scheme.enabled()) {
+            int covered = missing - uncovered;
+            missing = std::max(0, scheme.data_chunks - static_cast<int>(local.size()));
+            uncovered = std::max(0, missing - covered);
+        }
+    }
+
+    // Contabiliza o aproveitamento do cache: todos os faltantes cobertos, parte deles ou nenhum
+    if (missing > 0) {
+        const char* result = uncovered == 0 ? "hit" : (uncovered < missing ? "partial" : "miss");
+        Metrics::instance().add(Counter::AVAILABILITY_CACHE_LOOKUPS, "local=" + peer_id + ",result=" + result);
+    }
+
+    return {missing, uncovered};
+}
+
+
+/**
+ * @brief Retorna os detentores conhecidos dos chunks de um arquivo em download.
+ */
+std::vector<std::tuple<std::string, int, int, std::vector<int>>> FileManager::getChunkHolders(const std::string& file_name) {
+    std::map<std::tuple<std::string, int>, std::tuple<int, std::vector<int>>> chunks_by_peer;
+    {
+        std::lock_guard<std::mutex> location_lock(chunk_location_info_mutex);
+
+        auto it = chunk_location_info.find(file_name);
+        if (it == chunk_location_info.end()) {
+            return {};
+        }
+        for (size_t chunk = 0; chunk < it->second.size(); ++chunk) {
+            for (const ChunkLocationInfo& holder : it->second[chunk]) {
+                auto& [transfer_speed, chunks] = chunks_by_peer[std::make_tuple(holder.ip, holder.port)];
+                transfer_speed = holder.transfer_speed;
+                chunks.push_back(static_cast<int>(chunk));
+            }
+        }
+    }
+
+    std::vector<std::tuple<std::string, int, int, std::vector<int>>> holders;
+    for (auto& [peer, info] : chunks_by_peer) {
+        holders.emplace_back(std::get<0>(peer), std::get<1>(peer), std::get<0>(info), std::move(std::get<1>(info)));
+    }
+    return holders;
+}
+
+
+/**
+ * @brief Registra apenas no cache de disponibilidade os chunks que um peer possui.
+ */
+void FileManager::rememberChunkAvailability(const std::string& file_name, const std::vector<int>& chunk_ids, const std::string& ip, int port, int transfer_speed) {
+    availability_cache.record(file_name, chunk_ids, ip, port, transfer_speed);
+}
+
+
+/**
+ * @brief Atribui a um peer que anunciou chunks (HAVE) os faltantes que ainda não foram pedidos a ninguém.
+ */
+std::vector<int> FileManager::claimAnnouncedChunks(const std::string& file_name, const std::vector<int>& chunk_ids, const ChunkLocationInfo& holder) {
+    // Os chunks locais são consultados antes de travar as informações de localização (mesma ordem de saveChunk)
+    std::vector<int> missing_chunks;
+    for (int chunk : chunk_ids) {
+        if (!hasChunk(file_name, chunk)) {
+            missing_chunks.push_back(chunk);
+        }
+    }
+
+    // Com codificação de apagamento, os chunks locais mais os pedidos não precisam passar de k
+    ErasureScheme scheme = getErasureScheme(file_name);
+    size_t local_count = scheme.enabled() ? getAvailableChunks(file_name).size() : 0;
+
+    std::vector<int> claimed_chunks;
+    {
+        std::lock_guard<std::mutex> location_lock(chunk_location_info_mutex);
+
+        // Sem escolhas registradas, o download ainda está na descoberta ou já terminou
+        auto location_it = chunk_location_info.find(file_name);
+        auto requested_it = requested_chunks.find(file_name);
+        if (location_it == chunk_location_info.end() || requested_it == requested_chunks.end()) {
+            return claimed_chunks;
+        }
+
+        for (int chunk : missing_chunks) {
+            if (scheme.enabled() && local_count + requested_it->second.size() >= static_cast<size_t>(scheme.data_chunks)) {
+                break;
+            }
+            if (chunk >= 0 && static_cast<size_t>(chunk) < location_it->second.size() &&
+                requested_it->second.emplace(chunk, holder).second) {
+                claimed_chunks.push_back(chunk);
+            }
+        }
+    }
+
+    if (!claimed_chunks.empty()) {
+        Metrics::instance().add(Counter::SCHEDULER_CHUNKS_ASSIGNED, "local=" + peer_id + ",peer=" + holder.ip + ":" + std::to_string(holder.port),
+                                claimed_chunks.size());
+    }
+    return claimed_chunks;
+}
+
+
+/**
+ * @brief Adiciona um peer à lista de detentores de um chunk, se ele ainda não estiver nela.
+ */
+void FileManager::addChunkLocationLocked(std::vector<ChunkLocationInfo>& chunk_list, const std::string& ip, int port, int transfer_speed) {
+    // Verifica se o peer já existe na lista de detentores
+    bool peer_exists = std::any_of(chunk_list.begin(), chunk_list.end(), 
+                                   [&](const ChunkLocationInfo& cli) {
+                                       return cli.ip == ip && cli.port == port;
+                                   });
+    // Adiciona o peer caso ele não exista
+    if (!peer_exists) {
+        chunk_list.emplace_back(ip, port, transfer_speed);
+    }
+}
+
+
+/**
+ * @brief Retorna os nomes dos arquivos dos quais o peer possui ao menos um chunk.
+ */
+std::vector<std::string> FileManager::getLocalFiles() {
+    std::vector<std::string> files;
+
+    std::lock_guard<std::mutex> local_chunks_lock(local_chunks_mutex);
+    for (const auto& [file_name, chunks] : local_chunks) {
+        if (!chunks.empty()) {
+            files.push_back(file_name);
+        }
+    }
+
+    return files;
+}
+
+
 /**
  * @brief Retorna os chunks disponíveis para um arquivo específico.
  */
 std::vector<int> FileManager::getAvailableChunks(const std::string& file_name) {
     std::vector<int> available_chunks;
 
-    // Bloqueia o mutex do arquivo uma vez até o final do escopo desse método
-    std::lock_guard<std::mutex> file_lock(local_chunks_mutex[file_name]);
+    // Um nome de conteúdo tem um único chunk, presente se o conteúdo está em algum chunk local
+    if (ChunkStore::isContentName(file_name)) {
+        if (hasChunk(file_name, 0)) {
+            available_chunks.push_back(0);
+        }
+        return available_chunks;
+    }
+
+    // Bloqueia o mutex uma vez até o final do escopo desse método
+    std::lock_guard<std::mutex> local_chunks_lock(local_chunks_mutex);
 
     // Verifica se o arquivo está no mapa de chunks locais
-    if (local_chunks.find(file_name) != local_chunks.end()) {
+    auto it = local_chunks.find(file_name);
+    if (it != local_chunks.end()) {
         // Copia os chunks disponíveis para o vetor
-        available_chunks.assign(local_chunks[file_name].begin(), local_chunks[file_name].end());
+        available_chunks.assign(it->second.begin(), it->second.end());
     }
 
     return available_chunks;
@@ -223,20 +929,39 @@ std::vector<int> FileManager::getAvailableChunks(const std::string& file_name) {
  * @brief Retorna o caminho do chunk solicitado.
  */
 std::string FileManager::getChunkPath(const std::string& file_name, int chunk) {
+    // Um nome de conteúdo leva ao chunk local com aquele conteúdo, de qualquer arquivo
+    Sha256::Digest digest;
+    ChunkLocation location;
+    if (ChunkStore::parseContentName(file_name, digest) && chunk == 0 && chunk_store.find(digest, location)) {
+        return getChunkPath(location.file_name, location.chunk);
+    }
     return directory + "/" + file_name + ".ch" + std::to_string(chunk);
 }
 
 
+/**
+ * @brief Retorna o caminho do arquivo parcial de um chunk.
+ */
+std::string FileManager::getPartialChunkPath(const std::string& file_name, int chunk) {
+    return getChunkPath(file_name, chunk) + ".part";
+}
+
+
 /**
  * @brief Verifica se possui um chunk específico de um arquivo.
  */
 bool FileManager::hasChunk(const std::string& file_name, int chunk) {
-    // Bloqueia o mutex do arquivo uma vez até o final do escopo desse método
-    std::lock_guard<std::mutex> file_lock(local_chunks_mutex[file_name]);
+    Sha256::Digest digest;
+    ChunkLocation location;
+    if (ChunkStore::parseContentName(file_name, digest)) {
+        return chunk == 0 && chunk_store.find(digest, location);
+    }
 
-    auto result = local_chunks[file_name].find(chunk) != local_chunks[file_name].end();
+    // Bloqueia o mutex uma vez até o final do escopo desse método
+    std::lock_guard<std::mutex> local_chunks_lock(local_chunks_mutex);
 
-    return result;
+    auto it = local_chunks.find(file_name);
+    return it != local_chunks.end() && it->second.count(chunk) > 0;
 }
 
 
@@ -244,25 +969,92 @@ bool FileManager::hasChunk(const std::string& file_name, int chunk) {
  * @brief Salva um chunk recebido no diretório do peer.
  */
 void FileManager::saveChunk(const std::string& file_name, int chunk, const char* data, size_t size) {
-    // Bloqueia o mutex do arquivo uma vez até o final do escopo desse método
-    std::lock_guard<std::mutex> file_lock(local_chunks_mutex[file_name]);
+    // Chunk pedido pelo conteúdo: vale para todos os chunks faltantes que o esperam, cada um conferido pelo seu resumo
+    Sha256::Digest digest;
+    if (ChunkStore::parseContentName(file_name, digest)) {
+        std::vector<ChunkLocation> locations = chunk_store.getWanted(digest);
+        if (locations.empty()) {
+            LOG_MESSAGE(LogType::INFO, "Nenhum chunk faltante espera o conteúdo " + file_name + ". O chunk recebido foi descartado.");
+        }
+        for (const ChunkLocation& location : locations) {
+            saveChunk(location.file_name, location.chunk, data, size);
+        }
+        return;
+    }
+
+    // Confere o conteúdo antes do bloqueio, para que o resumo não atrase as outras gravações
+    ChunkDescriptor descriptor;
+    bool has_descriptor = getChunkDescriptor(file_name, chunk, descriptor);
+    if (has_descriptor && (size != descriptor.size || Sha256::hash(data, size) != descriptor.digest)) {
+        LOG_MESSAGE(LogType::ERROR, "O chunk " + std::to_string(chunk) + " de " + file_name + " recebido não confere com o resumo do .p2p e foi descartado.");
+        return;
+    }
 
     std::string path = getChunkPath(file_name, chunk);
 
-    std::ofstream outfile(path, std::ios::binary);
-    if (!outfile.is_open()) {
-        logMessage(LogType::ERROR, "Não foi possível criar o arquivo para o chunk " + std::to_string(chunk));
+    // Cria o arquivo do chunk com outro nome e o renomeia: um peer interrompido no meio da gravação não deixa um chunk incompleto.
+    // A gravação roda sem local_chunks_mutex, para que as gravações de outros chunks e as consultas dos chunks locais não esperem
+    // pelo disco; o nome temporário é da thread, pois duas threads podem gravar o mesmo chunk (recebido pelo nome e pelo conteúdo)
+    std::string temporary_path = path + ".tmp" + std::to_string(std::hash<std::thread::id>()(std::this_thread::get_id()));
+    if (!io_engine->writeFile(temporary_path, data, size) || std::rename(temporary_path.c_str(), path.c_str()) != 0) {
+        LOG_MESSAGE(LogType::ERROR, "Não foi possível criar o arquivo para o chunk " + std::to_string(chunk));
+        std::remove(temporary_path.c_str());
         return;
     }
 
-    // Escreve no arquivo                
-    outfile.write(data, size);
+    // Os bytes de uma transferência interrompida deixam de ser necessários
+    std::remove((path + ".part").c_str());
+
+    // O bloqueio cobre só o registro do chunk, o índice de conteúdo, o aviso e o disparo da montagem
+    std::lock_guard<std::mutex> local_chunks_lock(local_chunks_mutex);
+
+    // Armazena o chunk salvo na lista de chunks que possuo
+    bool inserted = local_chunks[file_name].insert(chunk).second;
+    if (has_descriptor) {
+        chunk_store.add(descriptor.digest, {file_name, chunk});
+    }
+
+    // A transferência concluída confirma que o peer escolhido possuía o chunk
+    ChunkLocationInfo sender;
+    bool sent_by_content = false;
+    {
+        std::lock_guard<std::mutex> location_lock(chunk_location_info_mutex);
+        auto requested_it = requested_chunks.find(file_name);
+        if (requested_it != requested_chunks.end()) {
+            auto chunk_it = requested_it->second.find(chunk);
+            if (chunk_it != requested_it->second.end()) {
+                sender = chunk_it->second;
+                requested_it->second.erase(chunk_it);
+            }
+        }
+
+        // Um peer que enviou o chunk pelo nome de conteúdo pode não conhecer o arquivo
+        auto holders_it = content_holders.find(file_name);
+        if (!sender.ip.empty() && holders_it != content_holders.end()) {
+            auto chunk_it = holders_it->second.find(chunk);
+            sent_by_content = chunk_it != holders_it->second.end() &&
+                              chunk_it->second.count(sender.ip + ":" + std::to_string(sender.port)) > 0;
+        }
+    }
+    if (!sender.ip.empty() && !sent_by_content) {
+        availability_cache.record(file_name, {chunk}, sender.ip, sender.port, sender.transfer_speed);
+    }
 
-    // Fecha o arquivo
-    outfile.close();
+    // Avisa quem guarda informações derivadas dos chunks locais
+    if (inserted && local_chunks_listener) {
+        local_chunks_listener(file_name, chunk, sender);
+    }
 
-    local_chunks[file_name].insert(chunk); // Armazena o chunk salvo na lista de chunks que possuo
-    assembleFile(file_name); // Tenta montar o arquivo
+    // Tenta montar o arquivo quando o chunk completa os necessários (com codificação de apagamento,
+    // chunks que chegam depois de k não montam o arquivo de novo)
+    if (inserted && local_chunks[file_name].size() == static_cast<size_t>(getRequiredChunks(file_name))) {
+        if (executor == nullptr) {
+            assembleFileLocked(file_name);
+        } else if (pending_assemblies.insert(file_name).second) {
+            // A montagem (reconstrução e concatenação) sai da tarefa que gravou o chunk e roda com a menor prioridade do executor
+            executor->submit(TaskPriority::ASSEMBLY, [this, file_name] { runAssembly(file_name); });
+        }
+    }
 }
 
 
@@ -270,33 +1062,338 @@ void FileManager::saveChunk(const std::string& file_name, int chunk, const char*
  * @brief Concatena todos os chunks para formar o arquivo completo.
  */
 bool FileManager::assembleFile(const std::string& file_name) {
-    // Sob o bloqueio utilizado em saveChunk
-    int total_chunks = file_chunks[file_name];
-    bool has_all_chunks = local_chunks[file_name].size() == static_cast<size_t>(total_chunks);
+    {
+        // Uma montagem em andamento do mesmo arquivo termina antes, para que as duas não gravem o arquivo ao mesmo tempo
+        std::unique_lock<std::mutex> local_chunks_lock(local_chunks_mutex);
+        assembly_cv.wait(local_chunks_lock, [&] { return pending_assemblies.count(file_name) == 0; });
+        pending_assemblies.insert(file_name);
+    }
+    return runAssembly(file_name);
+}
+
+
+/**
+ * @brief Indica se a montagem de um arquivo foi submetida ao executor e ainda não terminou.
+ */
+bool FileManager::isAssemblyPending(const std::string& file_name) {
+    std::lock_guard<std::mutex> local_chunks_lock(local_chunks_mutex);
+    return pending_assemblies.count(file_name) > 0;
+}
 
-    if (has_all_chunks) {
-        int total_chunks = file_chunks[file_name];
 
-        std::string output_path = directory + "/" + file_name;
-        std::ofstream output_file(output_path, std::ios::binary);
+/**
+ * @brief Indica se a última montagem de um arquivo terminou com sucesso.
+ */
+bool FileManager::isAssembled(const std::string& file_name) {
+    std::lock_guard<std::mutex> local_chunks_lock(local_chunks_mutex);
+    return assembled_files.count(file_name) > 0;
+}
 
-        for (int i = 0; i < total_chunks; ++i) {
-            std::string chunk_path = getChunkPath(file_name, i);
-            std::ifstream chunk_file(chunk_path, std::ios::binary | std::ios::in);
 
-            if (!chunk_file.is_open()) {
-                logMessage(LogType::ERROR, "Erro ao abrir o chunk " + chunk_path);
-                return false;
-            }
+/**
+ * @brief Monta um arquivo registrado em pending_assemblies, com local_chunks_mutex bloqueado só nas leituras e atualizações dos chunks locais.
+ */
+bool FileManager::runAssembly(const std::string& file_name) {
+    AssemblyInput input;
+    {
+        std::lock_guard<std::mutex> local_chunks_lock(local_chunks_mutex);
+        if (!getAssemblyInputLocked(file_name, input)) {
+            pending_assemblies.erase(file_name);
+            assembly_cv.notify_all();
+            return false;
+        }
+    }
+
+    // A reconstrução e a concatenação leem e gravam os arquivos dos chunks sem o bloqueio, então as gravações
+    // e as consultas dos chunks locais seguem durante a montagem
+    std::vector<int> reconstructed;
+    bool assembled = buildFile(file_name, input, reconstructed);
+
+    std::lock_guard<std::mutex> local_chunks_lock(local_chunks_mutex);
+    finishAssemblyLocked(file_name, reconstructed, assembled);
+    pending_assemblies.erase(file_name);
+    assembly_cv.notify_all();
+    return assembled;
+}
+
+
+/**
+ * @brief Monta o arquivo completo se todos os chunks estiverem disponíveis.
+ */
+bool FileManager::assembleFileLocked(const std::string& file_name) {
+    // Sob o bloqueio utilizado em saveChunk, sem o executor
+    AssemblyInput input;
+    if (!getAssemblyInputLocked(file_name, input)) {
+        return false;
+    }
+
+    std::vector<int> reconstructed;
+    bool assembled = buildFile(file_name, input, reconstructed);
+    finishAssemblyLocked(file_name, reconstructed, assembled);
+    return assembled;
+}
+
+
+/**
+ * @brief Copia os chunks locais e a codificação de um arquivo para a montagem.
+ */
+bool FileManager::getAssemblyInputLocked(const std::string& file_name, AssemblyInput& input) {
+    input.total_chunks = getTotalChunks(file_name);
+    input.scheme = getErasureScheme(file_name);
+    input.chunks = local_chunks[file_name];
+    int data_chunks = input.scheme.enabled() ? input.scheme.data_chunks : input.total_chunks;
+    return input.total_chunks > 0 && input.chunks.size() >= static_cast<size_t>(data_chunks);
+}
 
-            output_file << chunk_file.rdbuf();
-            chunk_file.close();
+
+/**
+ * @brief Reconstrói os chunks de dados faltantes e concatena os chunks de dados no arquivo final.
+ */
+bool FileManager::buildFile(const std::string& file_name, const AssemblyInput& input, std::vector<int>& reconstructed) {
+    const ErasureScheme& scheme = input.scheme;
+    int data_chunks = scheme.enabled() ? scheme.data_chunks : input.total_chunks;
+    std::string output_path = directory + "/" + file_name;
+
+    // Com codificação de apagamento, os chunks de dados faltantes são calculados a partir de k chunks quaisquer
+    if (scheme.enabled() && !reconstructDataChunks(file_name, input, reconstructed)) {
+        LOG_MESSAGE(LogType::ERROR, "Erro ao reconstruir os chunks de dados de " + file_name + ".");
+        return false;
+    }
+
+    std::vector<std::string> chunk_paths;
+    for (int i = 0; i < data_chunks; ++i) {
+        chunk_paths.push_back(getChunkPath(file_name, i));
+    }
+
+    if (!io_engine->concatenateFiles(chunk_paths, output_path)) {
+        LOG_MESSAGE(LogType::ERROR, "Erro ao montar o arquivo " + output_path + " a partir dos chunks.");
+        return false;
+    }
+
+    // Remove o preenchimento do último chunk de dados
+    if (scheme.enabled()) {
+        std::error_code error;
+        std::filesystem::resize_file(output_path, scheme.file_size, error);
+        if (error) {
+            LOG_MESSAGE(LogType::ERROR, "Erro ao ajustar o tamanho de " + output_path + ": " + error.message());
+            return false;
+        }
+    }
+    return true;
+}
+
+
+/**
+ * @brief Registra os chunks reconstruídos como locais e conclui a montagem.
+ */
+void FileManager::finishAssemblyLocked(const std::string& file_name, const std::vector<int>& reconstructed, bool assembled) {
+    // Os chunks reconstruídos passam a ser locais e podem ser enviados a outros peers
+    for (int chunk : reconstructed) {
+        if (local_chunks[file_name].insert(chunk).second && local_chunks_listener) {
+            local_chunks_listener(file_name, chunk, ChunkLocationInfo());
         }
+    }
 
-        output_file.close();
+    if (assembled) {
+        assembled_files.insert(file_name);
         displaySuccessMessage(file_name, peer_id);
         clearChunkLocationInfo(file_name);
+    } else {
+        assembled_files.erase(file_name);
+    }
+}
+
+
+/**
+ * @brief Reconstrói os chunks de dados faltantes de um arquivo com codificação de apagamento.
+ */
+bool FileManager::reconstructDataChunks(const std::string& file_name, const AssemblyInput& input, std::vector<int>& reconstructed) {
+    const ErasureScheme& scheme = input.scheme;
+    int total_chunks = input.total_chunks;
+    const std::set<int>& chunks = input.chunks;
+
+    std::vector<int> missing_ids;
+    for (int chunk = 0; chunk < scheme.data_chunks; ++chunk) {
+        if (chunks.count(chunk) == 0) {
+            missing_ids.push_back(chunk);
+        }
+    }
+    if (missing_ids.empty()) {
         return true;
     }
-    return false;
+
+    // Os k primeiros chunks locais (os de dados presentes e os de paridade de menor ID)
+    std::vector<int> source_ids;
+    for (int chunk : chunks) {
+        if (chunk >= 0 && chunk < total_chunks && source_ids.size() < static_cast<size_t>(scheme.data_chunks)) {
+            source_ids.push_back(chunk);
+        }
+    }
+
+    ErasureCoder coder(scheme.data_chunks, total_chunks);
+    std::vector<uint8_t> rows;
+    if (!coder.decodingMatrix(source_ids, missing_ids, rows)) {
+        return false;
+    }
+
+    // Todos os chunks têm o tamanho do primeiro chunk de origem
+    std::error_code error;
+    uint64_t chunk_size = std::filesystem::file_size(getChunkPath(file_name, source_ids.front()), error);
+    if (error) {
+        return false;
+    }
+
+    std::vector<int> source_fds, output_fds;
+    bool ok = true;
+    for (int chunk : source_ids) {
+        source_fds.push_back(open(getChunkPath(file_name, chunk).c_str(), O_RDONLY | O_CLOEXEC));
+        ok = ok && source_fds.back() >= 0;
+    }
+    for (int chunk : missing_ids) {
+        output_fds.push_back(open(getChunkPath(file_name, chunk).c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644));
+        ok = ok && output_fds.back() >= 0;
+    }
+
+    // Decodifica faixa a faixa, com um buffer por chunk de origem e por chunk reconstruído
+    std::vector<std::vector<char>> source_buffers(source_ids.size(), std::vector<char>(Constants::ERASURE_BLOCK_SIZE));
+    std::vector<std::vector<char>> output_buffers(missing_ids.size(), std::vector<char>(Constants::ERASURE_BLOCK_SIZE));
+    std::vector<const char*> sources;
+    std::vector<char*> outputs;
+    for (const auto& buffer : source_buffers) {
+        sources.push_back(buffer.data());
+    }
+    for (auto& buffer : output_buffers) {
+        outputs.push_back(buffer.data());
+    }
+
+    for (uint64_t offset = 0; ok && offset < chunk_size; offset += Constants::ERASURE_BLOCK_SIZE) {
+        size_t length = static_cast<size_t>(std::min<uint64_t>(Constants::ERASURE_BLOCK_SIZE, chunk_size - offset));
+        for (size_t i = 0; ok && i < source_fds.size(); ++i) {
+            ok = io_engine->readAt(source_fds[i], source_buffers[i].data(), length, static_cast<off_t>(offset));
+        }
+        if (!ok) {
+            break;
+        }
+        coder.apply(rows, sources, outputs, length);
+        for (size_t i = 0; ok && i < output_fds.size(); ++i) {
+            ok = io_engine->writeAt(output_fds[i], output_buffers[i].data(), length, static_cast<off_t>(offset));
+        }
+    }
+
+    closeAll(source_fds);
+    closeAll(output_fds);
+    if (!ok) {
+        return false;
+    }
+
+    reconstructed = missing_ids;
+    LOG_MESSAGE(LogType::INFO, "Reconstruídos " + std::to_string(missing_ids.size()) + " chunks de dados de " + file_name +
+                " a partir de " + std::to_string(source_ids.size()) + " chunks (" + ErasureCoder::kernelToString(coder.getKernel()) + ").");
+    return true;
+}
+
+
+/**
+ * @brief Publica um arquivo do diretório do peer com codificação de apagamento.
+ */
+bool FileManager::publishErasureCoded(const std::string& file_name, int data_chunks, int total_chunks) {
+    if (!ErasureCoder::isValid(data_chunks, total_chunks)) {
+        LOG_MESSAGE(LogType::ERROR, "Codificação de apagamento inválida: " + std::to_string(data_chunks) + " de " + std::to_string(total_chunks) + " chunks.");
+        return false;
+    }
+
+    std::string input_path = directory + "/" + file_name;
+    std::error_code error;
+    uint64_t file_size = std::filesystem::file_size(input_path, error);
+    if (error || file_size == 0) {
+        LOG_MESSAGE(LogType::ERROR, "Não foi possível ler o arquivo " + input_path + " para publicá-lo.");
+        return false;
+    }
+
+    // Chunks de dados do mesmo tamanho; o último é completado com zeros
+    uint64_t chunk_size = (file_size + data_chunks - 1) / data_chunks;
+
+    int input_fd = open(input_path.c_str(), O_RDONLY | O_CLOEXEC);
+    std::vector<int> output_fds;
+    bool ok = input_fd >= 0;
+    for (int chunk = 0; chunk < total_chunks; ++chunk) {
+        // Um chunk antigo pode ser um link físico compartilhado com outro arquivo: é substituído, não sobrescrito
+        std::error_code remove_error;
+        std::filesystem::remove(getChunkPath(file_name, chunk), remove_error);
+        output_fds.push_back(open(getChunkPath(file_name, chunk).c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644));
+        ok = ok && output_fds.back() >= 0;
+    }
+
+    ErasureCoder coder(data_chunks, total_chunks);
+    std::vector<std::vector<char>> buffers(total_chunks, std::vector<char>(Constants::ERASURE_BLOCK_SIZE));
+    std::vector<const char*> data;
+    std::vector<char*> parity;
+    for (int chunk = 0; chunk < total_chunks; ++chunk) {
+        if (chunk < data_chunks) {
+            data.push_back(buffers[chunk].data());
+        } else {
+            parity.push_back(buffers[chunk].data());
+        }
+    }
+
+    // Codifica faixa a faixa: a mesma faixa de cada chunk de dados gera a faixa de cada chunk de paridade
+    for (uint64_t offset = 0; ok && offset < chunk_size; offset += Constants::ERASURE_BLOCK_SIZE) {
+        size_t length = static_cast<size_t>(std::min<uint64_t>(Constants::ERASURE_BLOCK_SIZE, chunk_size - offset));
+        for (int chunk = 0; ok && chunk < data_chunks; ++chunk) {
+            uint64_t position = chunk * chunk_size + offset;
+            size_t present = position < file_size ? static_cast<size_t>(std::min<uint64_t>(length, file_size - position)) : 0;
+            ok = present == 0 || io_engine->readAt(input_fd, buffers[chunk].data(), present, static_cast<off_t>(position));
+            std::fill(buffers[chunk].begin() + present, buffers[chunk].begin() + length, 0);
+        }
+        if (!ok) {
+            break;
+        }
+        coder.encode(data, parity, length);
+        for (int chunk = 0; ok && chunk < total_chunks; ++chunk) {
+            ok = io_engine->writeAt(output_fds[chunk], buffers[chunk].data(), length, static_cast<off_t>(offset));
+        }
+    }
+
+    if (input_fd >= 0) {
+        close(input_fd);
+    }
+    closeAll(output_fds);
+    if (!ok) {
+        LOG_MESSAGE(LogType::ERROR, "Erro ao gravar os chunks codificados de " + file_name + ".");
+        return false;
+    }
+
+    // Mantém o TTL e o modo de descoberta de um .p2p existente
+    int initial_ttl = Constants::PUBLISH_DEFAULT_TTL;
+    DiscoveryMode discovery_mode = DiscoveryMode::FLOOD;
+    std::string metadata_path = base_path + file_name + ".p2p";
+    if (std::filesystem::exists(metadata_path)) {
+        auto [file_name_returned, previous_total_chunks, previous_ttl, previous_mode, previous_scheme] = loadMetadata(file_name);
+        if (previous_ttl > 0) {
+            initial_ttl = previous_ttl;
+            discovery_mode = previous_mode;
+        }
+    }
+
+    ErasureScheme scheme;
+    scheme.data_chunks = data_chunks;
+    scheme.file_size = file_size;
+    if (!saveMetadata(file_name, total_chunks, initial_ttl, discovery_mode, scheme)) {
+        return false;
+    }
+
+    initializeFileChunks(file_name, total_chunks, scheme);
+    {
+        std::lock_guard<std::mutex> local_chunks_lock(local_chunks_mutex);
+        for (int chunk = 0; chunk < total_chunks; ++chunk) {
+            // Como em saveChunk: o peer que já serve o arquivo descarta a resposta em cache e anuncia os novos chunks
+            if (local_chunks[file_name].insert(chunk).second && local_chunks_listener) {
+                local_chunks_listener(file_name, chunk, ChunkLocationInfo());
+            }
+        }
+    }
+
+    LOG_MESSAGE(LogType::INFO, "Arquivo " + file_name + " publicado em " + std::to_string(total_chunks) + " chunks de " +
+                std::to_string(chunk_size) + " bytes (qualquer conjunto de " + std::to_string(data_chunks) + " reconstrói o arquivo).");
+    return true;
 }
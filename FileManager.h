@@ -1,7 +1,14 @@
 #ifndef FILEMANAGER_H
 #define FILEMANAGER_H
 
+#include "AvailabilityCache.h"
+#include "ChunkStore.h"
+#include "ErasureCoder.h"
+#include "IOEngine.h"
+#include "Sha256.h"
 #include "Utils.h"
+#include <condition_variable>
+#include <functional>
 #include <map>
 #include <mutex>
 #include <set>
@@ -9,6 +16,8 @@
 #include <unordered_map>
 #include <vector>
 
+class WorkStealingExecutor;
+
 
 /**
  * @brief Estrutura que armazena as informações sobre um peer.
@@ -36,6 +45,25 @@ struct ChunkLocationInfo {
 };
 
 
+/**
+ * @brief Estrutura com o tamanho e o resumo de um chunk, gravados no .p2p pelo p2p-publish.
+ */
+struct ChunkDescriptor {
+    uint64_t size = 0;                                      ///< Tamanho do chunk em bytes.
+    Sha256::Digest digest{};                                ///< Resumo SHA-256 do conteúdo do chunk.
+};
+
+
+/**
+ * @brief Enumeração para o modo de descoberta dos detentores de um arquivo, definido no arquivo .p2p.
+ */
+enum class DiscoveryMode {
+    FLOOD,      ///< Inundação limitada por TTL (mensagens DISCOVERY), o modo padrão.
+    DHT,        ///< Busca na DHT, com a inundação como alternativa quando nenhum detentor é encontrado.
+    AGGREGATE   ///< Inundação com as respostas agregadas ao longo do caminho reverso (ResponseAggregator).
+};
+
+
 /**
  * @brief A classe FileManager é responsável pela gestão dos arquivos e chunks disponíveis para um peer em uma rede P2P.
  * 
@@ -50,18 +78,33 @@ private:
     std::string peer_id;  
     ///< ID do peer.
 
+    std::string base_path;
+    ///< Caminho base onde ficam os metadados (.p2p) e os diretórios dos peers.
+
     std::map<std::string, std::set<int>> local_chunks;
     ///< Mapa que armazena os chunks locais disponíveis para cada arquivo.
     ///< A chave é o nome do arquivo.
     ///< O valor é um conjunto contendo cada ID dos chunks que o peer já possui para aquele arquivo.
 
-    std::map<std::string,std::mutex> local_chunks_mutex;
-    ///< Mutexes para proteger o acesso a local_chunks.
+    std::mutex local_chunks_mutex;
+    ///< Mutex para proteger o acesso a local_chunks. Um único mutex protege também a estrutura do mapa,
+    ///< que recebe novas entradas a partir de várias threads.
 
     std::unordered_map<std::string, int> file_chunks;
     ///< Mapa que armazena o nome do arquivo que o peer quer buscar como chave
     ///< e o número total de chunks que ele possui como valor.
 
+    std::unordered_map<std::string, ErasureScheme> erasure_schemes;
+    ///< Codificação de apagamento dos arquivos publicados com ela (linha "erasure" do .p2p).
+    ///< Protegido por file_chunks_mutex.
+
+    std::unordered_map<std::string, std::vector<ChunkDescriptor>> chunk_descriptors;
+    ///< Tamanho e resumo de cada chunk dos arquivos com as linhas "chunk" no .p2p.
+    ///< Protegido por file_chunks_mutex.
+
+    std::mutex file_chunks_mutex;
+    ///< Mutex para proteger o acesso a file_chunks, erasure_schemes e chunk_descriptors, que podem ser alterados por novos downloads a qualquer momento.
+
     std::unordered_map<std::string, std::vector<std::vector<ChunkLocationInfo>>> chunk_location_info;
     ///< Mapa que armazena informações sobre os peers que possuem cada chunk de um arquivo.
     ///< A chave é o nome do arquivo.
@@ -69,9 +112,148 @@ private:
     ///< Cada índice contém um vetor de ChunkLocationInfo, onde cada ChunkLocationInfo descreve um peer.
     ///< que possui o chunk, incluindo seu IP, porta UDP e velocidade de transferência em bytes/segundo.
 
-    std::unordered_map<std::string, std::mutex> chunk_location_info_mutex;
+    std::unordered_map<std::string, std::map<int, ChunkLocationInfo>> requested_chunks;
+    ///< Peer escolhido por selectPeersForChunkDownload para cada chunk ainda não recebido, por arquivo.
+    ///< Protegido por chunk_location_info_mutex.
+
+    std::unordered_map<std::string, std::map<int, std::set<std::string>>> content_holders;
+    ///< Peers ("ip:port") que responderam pelo nome de conteúdo de cada chunk faltante, por arquivo. Eles podem
+    ///< não conhecer o arquivo, então o chunk é pedido a eles pelo nome de conteúdo.
+    ///< Protegido por chunk_location_info_mutex.
+
+    std::mutex chunk_location_info_mutex;
     ///< Mutex para garantir acesso seguro a chunk_location_info.
 
+    ChunkStore chunk_store;
+    ///< Índice dos chunks locais e dos chunks faltantes pelo resumo do conteúdo, usado para copiar chunks entre
+    ///< arquivos e para atender os pedidos por nome de conteúdo.
+
+    AvailabilityCache availability_cache;
+    ///< Chunks conhecidos de outros peers, mantidos após a montagem do arquivo para serem reaproveitados em novas buscas.
+
+    std::function<void(const std::string&, int, const ChunkLocationInfo&)> local_chunks_listener;
+    ///< Função chamada com o nome do arquivo, o chunk e o peer que o enviou quando saveChunk adiciona um chunk local (vazia: ninguém é avisado).
+
+    IOEngine* io_engine;
+    ///< E/S da gravação dos chunks e da montagem do arquivo final (padrão: IOEngine::blockingEngine()).
+
+    WorkStealingExecutor* executor;
+    ///< Executor compartilhado do peer, que monta os arquivos completos (nulo: montagem na thread que salva o último chunk).
+
+    std::set<std::string> pending_assemblies;
+    ///< Arquivos com a montagem em andamento (submetida ao executor ou em assembleFile). Protegido por local_chunks_mutex.
+
+    std::set<std::string> assembled_files;
+    ///< Arquivos cuja última montagem terminou com sucesso. Protegido por local_chunks_mutex.
+
+    std::condition_variable assembly_cv;
+    ///< Avisa assembleFile quando uma montagem em andamento termina. Usada com local_chunks_mutex.
+
+    /**
+     * @brief Estrutura com a cópia dos dados de um arquivo usados na montagem, tirada sob local_chunks_mutex.
+     */
+    struct AssemblyInput {
+        int total_chunks = 0;           ///< Número total de chunks (n).
+        ErasureScheme scheme;           ///< Codificação do arquivo.
+        std::set<int> chunks;           ///< Chunks locais do arquivo no início da montagem.
+    };
+
+    /**
+     * @brief Adiciona um peer à lista de detentores de um chunk, se ele ainda não estiver nela.
+     *
+     * Deve ser chamado com chunk_location_info_mutex bloqueado.
+     *
+     * @param chunk_list Lista de detentores do chunk.
+     * @param ip Endereço IP do peer.
+     * @param port Porta UDP do peer.
+     * @param transfer_speed Velocidade de transferência em bytes/segundo do peer.
+     */
+    static void addChunkLocationLocked(std::vector<ChunkLocationInfo>& chunk_list, const std::string& ip, int port, int transfer_speed);
+
+    /**
+     * @brief Monta o arquivo completo se todos os chunks estiverem disponíveis.
+     *
+     * Nos arquivos com codificação de apagamento bastam k chunks quaisquer: os chunks de dados
+     * faltantes são reconstruídos antes da concatenação.
+     *
+     * Deve ser chamado com local_chunks_mutex bloqueado (montagem sem o executor).
+     *
+     * @param file_name Nome do arquivo.
+     * @return true se o arquivo foi montado.
+     */
+    bool assembleFileLocked(const std::string& file_name);
+
+    /**
+     * @brief Monta um arquivo registrado em pending_assemblies, com local_chunks_mutex bloqueado só nas leituras e atualizações dos chunks locais.
+     *
+     * A reconstrução e a concatenação rodam sem o bloqueio, a partir de uma cópia dos chunks locais.
+     * Ao final, retira o arquivo de pending_assemblies e avisa assembly_cv.
+     *
+     * @param file_name Nome do arquivo.
+     * @return true se o arquivo foi montado.
+     */
+    bool runAssembly(const std::string& file_name);
+
+    /**
+     * @brief Copia os chunks locais e a codificação de um arquivo para a montagem.
+     *
+     * Deve ser chamado com local_chunks_mutex bloqueado.
+     *
+     * @param file_name Nome do arquivo.
+     * @param input Recebe a cópia.
+     * @return true se há chunks suficientes para montar o arquivo.
+     */
+    bool getAssemblyInputLocked(const std::string& file_name, AssemblyInput& input);
+
+    /**
+     * @brief Reconstrói os chunks de dados faltantes e concatena os chunks de dados no arquivo final.
+     *
+     * Não acessa local_chunks: pode ser chamado sem local_chunks_mutex.
+     *
+     * @param file_name Nome do arquivo.
+     * @param input Cópia dos dados do arquivo tirada por getAssemblyInputLocked.
+     * @param reconstructed Recebe os IDs dos chunks reconstruídos.
+     * @return true se o arquivo foi montado.
+     */
+    bool buildFile(const std::string& file_name, const AssemblyInput& input, std::vector<int>& reconstructed);
+
+    /**
+     * @brief Registra os chunks reconstruídos como locais e conclui a montagem.
+     *
+     * Deve ser chamado com local_chunks_mutex bloqueado.
+     *
+     * @param file_name Nome do arquivo.
+     * @param reconstructed IDs dos chunks reconstruídos por buildFile.
+     * @param assembled Indica se o arquivo foi montado.
+     */
+    void finishAssemblyLocked(const std::string& file_name, const std::vector<int>& reconstructed, bool assembled);
+
+    /**
+     * @brief Reconstrói os chunks de dados faltantes de um arquivo com codificação de apagamento.
+     *
+     * Lê faixas de Constants::ERASURE_BLOCK_SIZE bytes de k chunks locais e grava as faixas
+     * correspondentes dos chunks reconstruídos, sem carregar os chunks inteiros na memória.
+     * Não acessa local_chunks: pode ser chamado sem local_chunks_mutex.
+     *
+     * @param file_name Nome do arquivo.
+     * @param input Cópia dos dados do arquivo tirada por getAssemblyInputLocked.
+     * @param reconstructed Recebe os IDs dos chunks reconstruídos.
+     * @return true se todos os chunks de dados estão disponíveis ao final.
+     */
+    bool reconstructDataChunks(const std::string& file_name, const AssemblyInput& input, std::vector<int>& reconstructed);
+
+    /**
+     * @brief Preenche os chunks faltantes de um arquivo com chunks locais de mesmo conteúdo.
+     *
+     * Cada chunk faltante cujo resumo já está no índice é ligado (link físico, ou cópia quando o link
+     * não é possível) ao chunk local de mesmo conteúdo, de qualquer arquivo, depois de conferir o resumo
+     * da origem. Os demais passam a ser esperados pelo resumo, para que um chunk recebido pelo nome de
+     * conteúdo chegue a eles. As leituras, os links e as cópias rodam sem local_chunks_mutex.
+     *
+     * @param file_name Nome do arquivo.
+     */
+    void reuseStoredChunks(const std::string& file_name);
+
     std::string directory;  
     ///< Diretório responsável pelo armazenamento dos arquivos do peer, incluindo o local onde novos chunks serão salvos.
 
@@ -84,8 +266,43 @@ public:
      * diretório final.
      * 
      * @param peer_id ID do peer.
+     * @param base_path Caminho base dos metadados e dos diretórios dos peers (padrão: Constants::BASE_PATH).
+     * @param timing Tempos de espera do protocolo, dos quais é usada a validade do cache de disponibilidade (padrão: valores de Constants.h).
+     */
+    FileManager(const std::string& peer_id, const std::string& base_path = Constants::BASE_PATH, const TimingConfig& timing = TimingConfig());
+
+
+    /**
+     * @brief Define a função avisada quando saveChunk adiciona um chunk local.
+     * 
+     * Deve ser chamado antes de os servidores iniciarem. A função é chamada com local_chunks_mutex
+     * bloqueado, então não pode chamar métodos do FileManager.
+     * 
+     * @param listener Função que recebe o nome do arquivo cujos chunks locais mudaram, o chunk adicionado e o peer
+     *                 ao qual ele foi pedido (com IP vazio se o chunk não foi pedido por selectPeersForChunkDownload
+     *                 ou claimAnnouncedChunks).
+     */
+    void setLocalChunksListener(std::function<void(const std::string&, int, const ChunkLocationInfo&)> listener);
+
+
+    /**
+     * @brief Associa a implementação de E/S usada na gravação dos chunks e na montagem do arquivo final.
+     * 
+     * Deve ser chamado antes de os servidores iniciarem.
+     * 
+     * @param io_engine Ponteiro para a implementação de E/S do peer.
+     */
+    void setIOEngine(IOEngine* io_engine);
+
+
+    /**
+     * @brief Associa o executor que monta os arquivos completos, fora da tarefa que salva o último chunk.
+     * 
+     * Deve ser chamado antes de os servidores iniciarem.
+     * 
+     * @param executor Ponteiro para o executor compartilhado do peer.
      */
-    FileManager(const std::string& peer_id);
+    void setExecutor(WorkStealingExecutor* executor);
 
 
     /**
@@ -93,7 +310,9 @@ public:
      * 
      * Essa função verifica o diretório do peer e escaneia os arquivos de chunks presentes.
      * A função atualiza a lista de chunks que o peer já possui localmente, facilitando o
-     * gerenciamento e verificação dos chunks disponíveis.
+     * gerenciamento e verificação dos chunks disponíveis. Os chunks dos arquivos cujo .p2p traz os
+     * resumos entram no índice por conteúdo (conferidos pelo tamanho, sem ler os dados). Os chunks
+     * parciais (.part) e as gravações interrompidas (.tmp) não são chunks locais.
      */
     void loadLocalChunks();
 
@@ -101,13 +320,36 @@ public:
     /**
      * @brief Carrega os metadados de um arquivo e retorna as informações.
      * 
-     * Lê um arquivo de metadados específico e extrai o nome do arquivo, o número total de chunks
-     * e o valor inicial de TTL. Retorna essas informações como uma tupla.
+     * Lê um arquivo de metadados específico e extrai o nome do arquivo, o número total de chunks,
+     * o valor inicial de TTL e, opcionalmente, o modo de descoberta ("flood", "dht" ou "aggregate") na quarta
+     * linha e a codificação de apagamento ("erasure <k> <tamanho do arquivo>") em uma linha seguinte. As linhas
+     * "chunk" gravadas pelo p2p-publish são ignoradas.
+     * Retorna essas informações como uma tupla.
      * 
      * @param file_name Nome do arquivo que se deseja fazer a busca para carregar os metadados.
-     * @return Tupla contendo o nome do arquivo, total de chunks e TTL inicial. Retorna {"", -1, -1} se ocorrer um erro ao abrir o arquivo.
+     * @return Tupla contendo o nome do arquivo, total de chunks, TTL inicial, modo de descoberta (padrão: FLOOD)
+     *         e codificação de apagamento (padrão: desativada).
+     *         Retorna {"", -1, -1, FLOOD, {}} se ocorrer um erro ao abrir o arquivo.
+     */
+    std::tuple<std::string, int, int, DiscoveryMode, ErasureScheme> loadMetadata(const std::string& file_name);
+
+
+    /**
+     * @brief Grava o arquivo de metadados (.p2p) de um arquivo publicado.
+     * 
+     * Além das linhas lidas por loadMetadata, grava uma linha "chunk <índice> <tamanho> <sha256>" por
+     * chunk descrito. O arquivo é gravado com outro nome e renomeado ao final.
+     * 
+     * @param file_name Nome do arquivo.
+     * @param total_chunks Número total de chunks.
+     * @param initial_ttl TTL inicial das descobertas.
+     * @param discovery_mode Modo de descoberta.
+     * @param scheme Codificação de apagamento (desativada: sem a linha "erasure").
+     * @param chunks Tamanho e resumo de cada chunk (vazio: sem as linhas "chunk").
+     * @return true se o arquivo foi gravado.
      */
-    std::tuple<std::string, int, int> loadMetadata(const std::string& file_name);
+    bool saveMetadata(const std::string& file_name, int total_chunks, int initial_ttl, DiscoveryMode discovery_mode,
+                      const ErasureScheme& scheme = ErasureScheme(), const std::vector<ChunkDescriptor>& chunks = {});
 
 
     /**
@@ -117,8 +359,52 @@ public:
      * 
      * @param file_name Nome do arquivo que o peer deseja buscar.
      * @param total_chunks Número total de chunks que compõem o arquivo.
+     * Com os resumos dos chunks, os chunks faltantes que o peer já possui em outro arquivo (ou em outra
+     * posição do mesmo) são reaproveitados sem transferência.
+     * 
+     * @param file_name Nome do arquivo que o peer deseja buscar.
+     * @param total_chunks Número total de chunks que compõem o arquivo.
+     * @param scheme Codificação de apagamento do arquivo (padrão: desativada).
+     * @param descriptors Tamanho e resumo de cada chunk (vazio: o arquivo não tem resumos).
+     */
+    void initializeFileChunks(const std::string& file_name, int total_chunks, const ErasureScheme& scheme = ErasureScheme(),
+                              const std::vector<ChunkDescriptor>& descriptors = {});
+
+
+    /**
+     * @brief Carrega o tamanho e o resumo de cada chunk das linhas "chunk" do .p2p de um arquivo.
+     * 
+     * @param file_name Nome do arquivo.
+     * @return Um descritor por chunk, ou vazio se o .p2p não tem as linhas de todos os chunks.
      */
-    void initializeFileChunks(const std::string& file_name, int total_chunks);
+    std::vector<ChunkDescriptor> loadChunkDescriptors(const std::string& file_name);
+
+
+    /**
+     * @brief Retorna o número total de chunks de um arquivo.
+     * 
+     * @param file_name Nome do arquivo.
+     * @return Número total de chunks do arquivo, ou 0 se os metadados do arquivo ainda não foram carregados.
+     */
+    int getTotalChunks(const std::string& file_name);
+
+
+    /**
+     * @brief Retorna a codificação de apagamento de um arquivo.
+     * 
+     * @param file_name Nome do arquivo.
+     * @return Codificação do arquivo (desativada se ele não usa codificação ou seus metadados não foram carregados).
+     */
+    ErasureScheme getErasureScheme(const std::string& file_name);
+
+
+    /**
+     * @brief Retorna o número de chunks necessários para montar um arquivo.
+     * 
+     * @param file_name Nome do arquivo.
+     * @return k nos arquivos com codificação de apagamento; caso contrário, o número total de chunks.
+     */
+    int getRequiredChunks(const std::string& file_name);
 
 
     /**
@@ -137,8 +423,8 @@ public:
      * @brief Limpa as informações de localização dos chunks e remove o mutex associado a um arquivo específico.
      * 
      * Remove o file_name do mapa chunk_location_info e apaga os dados de localização de cada chunk,
-     * garantindo que a memória associada aos vetores internos seja liberada. Em seguida, remove o mutex 
-     * correspondente do mapa chunk_location_info_mutex. É chamado após um assembleFile bem sucedido.
+     * garantindo que a memória associada aos vetores internos seja liberada. É chamado após um assembleFile
+     * bem sucedido. O que foi aprendido continua no cache de disponibilidade.
      * 
      * @param file_name Nome do arquivo cujas informações de localização dos chunks devem ser limpas.
      */
@@ -155,6 +441,13 @@ public:
      * A função prioriza os peers com maior velocidade de transferência e, em caso de empate, atribui o chunk ao peer com menos
      * chunks já alocados, garantindo uma distribuição equilibrada e eficiente. Essa abordagem é independente do tamanho real dos chunks.
      * 
+     * O peer escolhido para cada chunk é guardado, para que o chunk recebido confirme no cache de
+     * disponibilidade que o peer o possuía.
+     * 
+     * Nos arquivos com codificação de apagamento só são pedidos os chunks que faltam para completar k,
+     * escolhidos entre os faltantes pela velocidade do detentor mais rápido de cada um (qualquer
+     * conjunto de k chunks serve, então os mais rápidos de obter são preferidos).
+     * 
      * @param file_name O nome do arquivo para o qual os chunks serão distribuídos entre os peers.
      * @return Um mapa associando cada peer (identificado por "ip:port") a uma lista de chunks que ele deve solicitar.
      */
@@ -166,7 +459,11 @@ public:
      * 
      * Insere as informações de um peer no mapa chunk_location_info.
      * Essas informações incluem o IP, porta UDP e velocidade de transferência em bytes/segundo do peer que possui tais chunks.
-     * A função usa mutexes para garantir que múltiplas threads possam acessar o mapa com segurança.
+     * A função usa mutexes para garantir que múltiplas threads possam acessar o mapa com segurança. As informações
+     * também vão para o cache de disponibilidade, mesmo quando o arquivo não está sendo baixado.
+     * 
+     * Uma resposta a um nome de conteúdo (chunk 0) vale para todos os chunks faltantes que esperam aquele
+     * conteúdo; ela não vai para o cache, já que o peer pode não conhecer os arquivos.
      * 
      * @param file_name O nome do arquivo associado aos chunks.
      * @param chunk_ids Uma lista de IDs dos chunks que o peer que enviou a resposta possui.
@@ -177,11 +474,96 @@ public:
     void storeChunkLocationInfo(const std::string& file_name, const std::vector<int>& chunk_ids, const std::string& ip, int port, int transfer_speed);
 
 
+    /**
+     * @brief Retorna o nome pelo qual um chunk deve ser pedido a um peer.
+     * 
+     * @param file_name Nome do arquivo.
+     * @param chunk Número do chunk.
+     * @param peer_key Peer escolhido para o chunk ("ip:port").
+     * @return O nome de conteúdo do chunk, se o peer respondeu por ele; caso contrário, uma string vazia (o chunk é pedido pelo nome do arquivo).
+     */
+    std::string getContentName(const std::string& file_name, int chunk, const std::string& peer_key);
+
+
+    /**
+     * @brief Retorna o tamanho e o resumo de um chunk, se o .p2p do arquivo os trouxe.
+     *
+     * @param file_name Nome do arquivo.
+     * @param chunk Número do chunk.
+     * @param descriptor Recebe o tamanho e o resumo.
+     * @return true se o chunk tem resumo.
+     */
+    bool getChunkDescriptor(const std::string& file_name, int chunk, ChunkDescriptor& descriptor);
+
+
+    /**
+     * @brief Retorna os nomes de conteúdo dos chunks faltantes de um arquivo que não têm nenhum detentor conhecido.
+     * 
+     * Usados na descoberta pelo conteúdo, que encontra os chunks em peers que os possuem sob outros arquivos.
+     * 
+     * @param file_name Nome do arquivo.
+     * @param max_names Número máximo de nomes retornados.
+     * @return Nomes de conteúdo, na ordem dos chunks (vazio se o arquivo não tem resumos).
+     */
+    std::vector<std::string> getUncoveredContentNames(const std::string& file_name, size_t max_names);
+
+
+    /**
+     * @brief Copia os detentores conhecidos no cache de disponibilidade para as informações de localização dos chunks.
+     * 
+     * Chamado antes de uma tentativa de descoberta, para que ela seja dispensada ou reduzida quando o cache já
+     * cobre os chunks faltantes.
+     * 
+     * @param file_name Nome do arquivo.
+     * @return Tupla com o número de chunks faltantes e quantos deles continuam sem nenhum detentor conhecido.
+     */
+    std::tuple<int, int> applyCachedChunkLocationInfo(const std::string& file_name);
+
+
+    /**
+     * @brief Registra apenas no cache de disponibilidade os chunks que um peer possui.
+     * 
+     * Usado para as informações que passam pelo peer sem serem respostas às suas próprias buscas,
+     * como os resumos agregados repassados no caminho reverso.
+     * 
+     * @param file_name Nome do arquivo.
+     * @param chunk_ids Chunks que o peer possui.
+     * @param ip Endereço IP do peer.
+     * @param port Porta UDP do peer.
+     * @param transfer_speed Velocidade de transferência em bytes/segundo do peer.
+     */
+    void rememberChunkAvailability(const std::string& file_name, const std::vector<int>& chunk_ids, const std::string& ip, int port, int transfer_speed);
+
+
+    /**
+     * @brief Atribui a um peer que anunciou chunks (HAVE) os faltantes que ainda não foram pedidos a ninguém.
+     * 
+     * Só tem efeito depois que selectPeersForChunkDownload escolheu os peers do download, ou seja, na fase
+     * de transferência. Antes dela, os chunks anunciados entram na seleção como as respostas da descoberta.
+     * 
+     * @param file_name Nome do arquivo.
+     * @param chunk_ids Chunks anunciados pelo peer.
+     * @param holder Peer que anunciou os chunks.
+     * @return Chunks atribuídos ao peer, que devem ser pedidos a ele.
+     */
+    std::vector<int> claimAnnouncedChunks(const std::string& file_name, const std::vector<int>& chunk_ids, const ChunkLocationInfo& holder);
+
+
+    /**
+     * @brief Retorna os detentores conhecidos dos chunks de um arquivo em download.
+     * 
+     * @param file_name Nome do arquivo.
+     * @return Tuplas com o IP, a porta UDP, a velocidade de transferência e os chunks de cada peer (vazio fora do download).
+     */
+    std::vector<std::tuple<std::string, int, int, std::vector<int>>> getChunkHolders(const std::string& file_name);
+
+
     /**
      * @brief Retorna os chunks disponíveis para um arquivo específico.
      * 
      * Essa função retorna uma lista de chunks que já estão disponíveis localmente para um determinado arquivo,
      * permitindo que o peer verifique quais partes do arquivo já foram baixadas ou quais ele pode enviar.
+     * Para um nome de conteúdo, retorna o chunk 0 se algum chunk local tem aquele conteúdo.
      * 
      * @param file_name Nome do arquivo.
      * @return Vetor contendo os chunks disponíveis localmente.
@@ -189,11 +571,20 @@ public:
     std::vector<int> getAvailableChunks(const std::string& file_name);
 
 
+    /**
+     * @brief Retorna os nomes dos arquivos dos quais o peer possui ao menos um chunk.
+     * 
+     * @return Vetor com os nomes dos arquivos.
+     */
+    std::vector<std::string> getLocalFiles();
+
+
     /**
      * @brief Retorna o caminho do chunk solicitado.
      * 
      * Retorna o caminho absoluto no sistema de arquivos onde um chunk específico está armazenado.
-     * Isso permite que o chunk seja localizado e transferido, se necessário.
+     * Isso permite que o chunk seja localizado e transferido, se necessário. Um nome de conteúdo
+     * (chunk 0) leva ao chunk local de qualquer arquivo com aquele conteúdo.
      * 
      * @param file_name Nome do arquivo.
      * @param chunk Número do chunk.
@@ -202,11 +593,21 @@ public:
     std::string getChunkPath(const std::string& file_name, int chunk);
 
 
+    /**
+     * @brief Retorna o caminho do arquivo parcial de um chunk, com os bytes recebidos em uma transferência interrompida.
+     * 
+     * @param file_name Nome do arquivo.
+     * @param chunk Número do chunk.
+     * @return Caminho do chunk seguido de ".part".
+     */
+    std::string getPartialChunkPath(const std::string& file_name, int chunk);
+
+
     /**
      * @brief Verifica se possui um chunk específico de um arquivo.
      * 
      * Essa função verifica se o peer já possui um chunk específico de um determinado arquivo
-     * em seu armazenamento local.
+     * em seu armazenamento local, ou se algum chunk local tem o conteúdo de um nome de conteúdo.
      * 
      * @param file_name Nome do arquivo.
      * @param chunk Número do chunk.
@@ -220,6 +621,13 @@ public:
      * 
      * Salva os dados recebidos de um chunk no diretório designado do peer. O chunk é gravado
      * no sistema de arquivos para que o peer possa armazená-lo e acessá-lo mais tarde.
+     * Se o chunk foi solicitado a um peer, a transferência concluída renova a entrada dele no cache de disponibilidade.
+     * 
+     * Quando o .p2p traz o resumo do chunk, os dados com tamanho ou resumo diferentes são descartados. Um
+     * chunk recebido por um nome de conteúdo é salvo em todos os chunks faltantes que esperam aquele conteúdo.
+     * O chunk é gravado em um arquivo temporário e renomeado, para que um reinício nunca encontre um chunk
+     * pela metade, e o arquivo parcial do chunk, se houver, é removido. A gravação roda sem
+     * local_chunks_mutex, que só protege o registro do chunk nos chunks locais.
      * 
      * @param file_name Nome do arquivo.
      * @param chunk Número do chunk.
@@ -238,6 +646,43 @@ public:
      * @return true se conseguiu criar o novo arquivo com base em todos os chunks ou false, do contrário.
      */
     bool assembleFile(const std::string& file_name);
+
+
+    /**
+     * @brief Indica se a montagem de um arquivo foi submetida ao executor e ainda não terminou.
+     * 
+     * @param file_name Nome do arquivo.
+     * @return true entre o chunk que completa o arquivo e o fim da montagem.
+     */
+    bool isAssemblyPending(const std::string& file_name);
+
+
+    /**
+     * @brief Indica se a última montagem de um arquivo terminou com sucesso.
+     *
+     * Uma reconstrução ou concatenação que falhou deixa o arquivo como não montado, para que o
+     * escalonador não conclua o download.
+     *
+     * @param file_name Nome do arquivo.
+     * @return true se o arquivo foi montado.
+     */
+    bool isAssembled(const std::string& file_name);
+
+
+    /**
+     * @brief Publica um arquivo do diretório do peer com codificação de apagamento.
+     * 
+     * Divide o arquivo em k chunks de dados do mesmo tamanho (o último preenchido com zeros), calcula
+     * os n - k chunks de paridade e grava os n chunks no diretório do peer e o .p2p com a linha
+     * "erasure". O arquivo é lido em faixas, sem ser carregado inteiro na memória. O TTL e o modo de
+     * descoberta de um .p2p existente são mantidos.
+     * 
+     * @param file_name Nome do arquivo, que deve estar no diretório do peer.
+     * @param data_chunks Número de chunks de dados (k).
+     * @param total_chunks Número total de chunks (n).
+     * @return true se os chunks e o .p2p foram gravados.
+     */
+    bool publishErasureCoded(const std::string& file_name, int data_chunks, int total_chunks);
 };
 
 #endif // FILEMANAGER_H
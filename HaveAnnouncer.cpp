@@ -0,0 +1,188 @@
+#include "HaveAnnouncer.h"
+#include "Metrics.h"
+#include <algorithm>
+#include <thread>
+
+
+/**
+ * @brief Construtor da classe HaveAnnouncer.
+ */
+HaveAnnouncer::HaveAnnouncer(const std::string& ip, int port, int peer_id, int transfer_speed, UDPServer& udp_server,
+                             FileManager& file_manager, const TimingConfig& timing)
+    : ip(ip), port(port), peer_id(peer_id), transfer_speed(transfer_speed), udp_server(udp_server), file_manager(file_manager),
+      timing(timing), interest_count(0) {}
+
+
+/**
+ * @brief Loop principal, que a cada have_interval envia os chunks pendentes aos interessados.
+ */
+void HaveAnnouncer::run() {
+    while (true) {
+        // Os chunks salvos durante o intervalo formam um único delta por arquivo
+        std::this_thread::sleep_for(timing.have_interval);
+
+        std::vector<std::tuple<std::vector<std::tuple<std::string, int>>, std::vector<std::string>>> pending;
+        {
+            std::lock_guard<std::mutex> lock(have_mutex);
+            expireInterestsLocked(std::chrono::steady_clock::now());
+
+            for (auto& [file_name, chunks] : pending_chunks) {
+                auto interest_it = interests.find(file_name);
+                if (interest_it == interests.end()) {
+                    continue;
+                }
+
+                std::vector<std::tuple<std::string, int>> recipients;
+                for (const auto& [peer, expires_at] : interest_it->second) {
+                    recipients.push_back(peer);
+                }
+
+                std::sort(chunks.begin(), chunks.end());
+                chunks.erase(std::unique(chunks.begin(), chunks.end()), chunks.end());
+                pending.emplace_back(std::move(recipients), buildHaveMessages(file_name, chunks));
+            }
+            pending_chunks.clear();
+        }
+
+        // Os envios são feitos fora do mutex para não atrasar o salvamento dos chunks
+        for (const auto& [recipients, messages] : pending) {
+            for (const auto& [recipient_ip, recipient_port] : recipients) {
+                for (const std::string& message : messages) {
+                    udp_server.sendUDPMessage(recipient_ip, recipient_port, message);
+                }
+            }
+        }
+    }
+}
+
+
+/**
+ * @brief Registra o solicitante de uma descoberta como interessado no arquivo.
+ */
+void HaveAnnouncer::registerInterest(const std::string& file_name, const PeerInfo& requester_info) {
+    if (requester_info.ip == ip && requester_info.port == port) {
+        return;
+    }
+
+    auto now = std::chrono::steady_clock::now();
+    auto peer = std::make_tuple(requester_info.ip, requester_info.port);
+
+    std::lock_guard<std::mutex> lock(have_mutex);
+
+    // Um interesse novo pode precisar de espaço
+    auto file_it = interests.find(file_name);
+    if (file_it == interests.end() || file_it->second.find(peer) == file_it->second.end()) {
+        if (interest_count >= Constants::HAVE_MAX_INTERESTS) {
+            expireInterestsLocked(now);
+            if (interest_count >= Constants::HAVE_MAX_INTERESTS) {
+                return;
+            }
+        }
+        ++interest_count;
+    }
+
+    interests[file_name][peer] = now + timing.have_interest_ttl;
+}
+
+
+/**
+ * @brief Acumula um chunk recém-salvo para o próximo anúncio.
+ */
+void HaveAnnouncer::chunkAdded(const std::string& file_name, int chunk) {
+    std::lock_guard<std::mutex> lock(have_mutex);
+    if (interests.find(file_name) != interests.end()) {
+        pending_chunks[file_name].push_back(chunk);
+    }
+}
+
+
+/**
+ * @brief Processa uma mensagem HAVE recebida de outro peer.
+ */
+void HaveAnnouncer::processHaveMessage(const HaveMessage& message, const PeerInfo& direct_sender_info) {
+    if (message.chunks.empty() || (direct_sender_info.ip == ip && direct_sender_info.port == port)) {
+        return;
+    }
+
+    std::string file_name(message.file_name);
+    int speed = message.transfer_speed;
+    std::vector<int> chunks(message.chunks.begin(), message.chunks.end());
+
+    // O anunciante passa a ser um detentor conhecido, mesmo fora da janela de respostas
+    file_manager.storeChunkLocationInfo(file_name, chunks, direct_sender_info.ip, direct_sender_info.port, speed);
+
+    LOG_MESSAGE(LogType::RESPONSE_RECEIVED,
+                "Recebido anúncio HAVE do Peer " + direct_sender_info.ip + ":" + std::to_string(direct_sender_info.port) +
+                " para o arquivo '" + file_name + "' com " + std::to_string(chunks.size()) + " chunks.");
+
+    // Os chunks que nenhum peer recebeu a tarefa de enviar são pedidos ao anunciante sem esperar outra descoberta
+    std::vector<int> claimed = file_manager.claimAnnouncedChunks(file_name, chunks,
+                                                                 ChunkLocationInfo(direct_sender_info.ip, direct_sender_info.port, speed));
+    if (claimed.empty()) {
+        return;
+    }
+
+    Metrics::instance().add(Counter::HAVE_CHUNKS_REQUESTED, Metrics::peerLabel(peer_id, direct_sender_info.ip, direct_sender_info.port), claimed.size());
+    for (int claimed_chunk : claimed) {
+        Metrics::instance().startTimer(peer_id, file_name, claimed_chunk);
+    }
+
+    std::string request_message = udp_server.buildChunkRequestMessage(file_name, claimed);
+    if (udp_server.sendUDPMessage(direct_sender_info.ip, direct_sender_info.port, request_message) < 0) {
+        perror("Erro ao enviar mensagem UDP REQUEST de chunks anunciados");
+    } else {
+        LOG_MESSAGE(LogType::REQUEST_SENT, "Mensagem REQUEST enviada para " + direct_sender_info.ip + ":" + std::to_string(direct_sender_info.port) + " após anúncio HAVE -> " + request_message);
+    }
+}
+
+
+/**
+ * @brief Descarta os interesses expirados.
+ */
+void HaveAnnouncer::expireInterestsLocked(std::chrono::steady_clock::time_point now) {
+    for (auto file_it = interests.begin(); file_it != interests.end();) {
+        auto& peers = file_it->second;
+        for (auto it = peers.begin(); it != peers.end();) {
+            if (it->second <= now) {
+                it = peers.erase(it);
+                --interest_count;
+            } else {
+                ++it;
+            }
+        }
+
+        if (peers.empty()) {
+            // Sem interessados, os chunks pendentes do arquivo não têm para quem ir
+            pending_chunks.erase(file_it->first);
+            file_it = interests.erase(file_it);
+        } else {
+            ++file_it;
+        }
+    }
+}
+
+
+/**
+ * @brief Monta as mensagens HAVE de um arquivo.
+ */
+std::vector<std::string> HaveAnnouncer::buildHaveMessages(const std::string& file_name, const std::vector<int>& chunks) const {
+    std::vector<std::string> messages;
+    const std::string header = "HAVE " + file_name + " " + std::to_string(transfer_speed);
+    std::string message = header;
+
+    for (int chunk : chunks) {
+        std::string item = " " + std::to_string(chunk);
+
+        // Um chunk que não cabe na mensagem atual inicia a próxima
+        if (message.size() + item.size() > static_cast<size_t>(Constants::CONTROL_MESSAGE_MAX_SIZE - 1) && message.size() > header.size()) {
+            messages.push_back(message);
+            message = header;
+        }
+        message += item;
+    }
+
+    if (message.size() > header.size()) {
+        messages.push_back(message);
+    }
+    return messages;
+}
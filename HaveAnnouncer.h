@@ -0,0 +1,128 @@
+#ifndef HAVEANNOUNCER_H
+#define HAVEANNOUNCER_H
+
+#include "FileManager.h"
+#include "MessageParser.h"
+#include "UDPServer.h"
+#include "Utils.h"
+#include <chrono>
+#include <cstddef>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <tuple>
+#include <vector>
+
+
+/**
+ * @brief Classe que anuncia aos peers interessados os chunks recebidos durante um download.
+ *
+ * Um peer só responde a uma descoberta com os chunks que possui naquele momento, então um chunk
+ * salvo depois que a janela de respostas do solicitante fechou não seria usado por ele. Cada
+ * DISCOVERY recebida registra o solicitante como interessado no arquivo por have_interest_ttl.
+ * Os chunks salvos por saveChunk se acumulam e, a cada have_interval, o delta é enviado aos
+ * interessados:
+ *
+ *  - HAVE <arquivo> <velocidade> <chunk> <chunk> ...
+ *
+ * Quem recebe guarda o anunciante nas informações de localização dos chunks e, se o download
+ * já está na fase de transferência, pede na hora os chunks anunciados que ainda não foram
+ * atribuídos a nenhum peer, sem esperar uma nova rodada de descoberta.
+ */
+class HaveAnnouncer {
+private:
+    const std::string ip;                                               ///< Endereço IP do peer atual.
+    const int port;                                                     ///< Porta UDP do peer atual.
+    const int peer_id;                                                  ///< Identificador único (ID) do peer.
+    const int transfer_speed;                                           ///< Velocidade de transferência em bytes/segundo anunciada nas mensagens HAVE.
+    UDPServer& udp_server;                                              ///< Referência ao servidor UDP do peer.
+    FileManager& file_manager;                                          ///< Referência ao gerenciador de arquivos do peer.
+    const TimingConfig timing;                                          ///< Tempos de espera do protocolo.
+    std::map<std::string, std::map<std::tuple<std::string, int>, std::chrono::steady_clock::time_point>> interests;
+    ///< Peers interessados em cada arquivo (IP e porta UDP) e o instante em que o interesse expira.
+    size_t interest_count;                                              ///< Número atual de pares arquivo e peer interessado.
+    std::map<std::string, std::vector<int>> pending_chunks;             ///< Chunks salvos desde o último anúncio, por arquivo.
+    std::mutex have_mutex;                                              ///< Mutex para proteger os interesses e os chunks pendentes.
+
+public:
+    /**
+     * @brief Construtor da classe HaveAnnouncer.
+     *
+     * @param ip Endereço IP do peer.
+     * @param port Porta UDP do peer.
+     * @param peer_id ID do peer.
+     * @param transfer_speed Velocidade de transferência em bytes/segundo do peer.
+     * @param udp_server Referência ao servidor UDP do peer.
+     * @param file_manager Referência ao gerenciador de arquivos do peer.
+     * @param timing Tempos de espera do protocolo (padrão: valores de Constants.h).
+     */
+    HaveAnnouncer(const std::string& ip, int port, int peer_id, int transfer_speed, UDPServer& udp_server,
+                  FileManager& file_manager, const TimingConfig& timing = TimingConfig());
+
+
+    /**
+     * @brief Loop principal, que a cada have_interval envia os chunks pendentes aos interessados.
+     */
+    void run();
+
+
+    /**
+     * @brief Registra o solicitante de uma descoberta como interessado no arquivo.
+     *
+     * Um interesse repetido apenas renova a validade. Com Constants::HAVE_MAX_INTERESTS pares
+     * registrados, os expirados são descartados e, se ainda não houver espaço, o novo é ignorado.
+     *
+     * @param file_name Nome do arquivo buscado.
+     * @param requester_info Peer que originou a descoberta (IP e porta UDP).
+     */
+    void registerInterest(const std::string& file_name, const PeerInfo& requester_info);
+
+
+    /**
+     * @brief Acumula um chunk recém-salvo para o próximo anúncio.
+     *
+     * Chamado pelo FileManager com local_chunks_mutex bloqueado. O chunk só é guardado se
+     * algum peer tem interesse no arquivo.
+     *
+     * @param file_name Nome do arquivo.
+     * @param chunk Chunk salvo.
+     */
+    void chunkAdded(const std::string& file_name, int chunk);
+
+
+    /**
+     * @brief Processa uma mensagem HAVE recebida de outro peer.
+     *
+     * Os chunks anunciados vão para as informações de localização (e para o cache de
+     * disponibilidade). Os faltantes que ainda não foram atribuídos a nenhum peer na fase de
+     * transferência são pedidos ao anunciante com uma mensagem REQUEST.
+     *
+     * @param message Campos da mensagem, lidos pelo MessageParser.
+     * @param direct_sender_info Informações sobre o peer que enviou a mensagem (IP e porta UDP).
+     */
+    void processHaveMessage(const HaveMessage& message, const PeerInfo& direct_sender_info);
+
+private:
+    /**
+     * @brief Descarta os interesses expirados. Deve ser chamado com have_mutex bloqueado.
+     *
+     * @param now Instante atual.
+     */
+    void expireInterestsLocked(std::chrono::steady_clock::time_point now);
+
+
+    /**
+     * @brief Monta as mensagens HAVE de um arquivo.
+     *
+     * Os chunks são divididos em quantas mensagens forem necessárias para respeitar
+     * Constants::CONTROL_MESSAGE_MAX_SIZE bytes.
+     *
+     * @param file_name Nome do arquivo.
+     * @param chunks Chunks a anunciar, em ordem crescente.
+     * @return Mensagens formatadas.
+     */
+    std::vector<std::string> buildHaveMessages(const std::string& file_name, const std::vector<int>& chunks) const;
+};
+
+#endif // HAVEANNOUNCER_H
@@ -0,0 +1,732 @@
+#include "IOEngine.h"
+#include "Constants.h"
+#include "Utils.h"
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <fcntl.h>
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+
+namespace {
+    /**
+     * @brief Classe com o anel io_uring de uma thread: as filas mapeadas e os buffers registrados.
+     */
+    class Ring {
+    private:
+        int ring_fd;                        ///< Descritor do anel (-1 se a criação falhou).
+        void* sq_ptr;                       ///< Região mapeada da fila de submissão.
+        size_t sq_ring_size;                ///< Tamanho da região da fila de submissão.
+        void* cq_ptr;                       ///< Região mapeada da fila de conclusão (igual a sq_ptr com IORING_FEAT_SINGLE_MMAP).
+        size_t cq_ring_size;                ///< Tamanho da região da fila de conclusão.
+        io_uring_sqe* sqes;                 ///< Vetor de entradas de submissão.
+        size_t sqes_size;                   ///< Tamanho do vetor de entradas de submissão.
+        unsigned* sq_head;                  ///< Cabeça da fila de submissão (avançada pelo kernel).
+        unsigned* sq_tail;                  ///< Cauda da fila de submissão (avançada pela thread).
+        unsigned* sq_mask;                  ///< Máscara dos índices da fila de submissão.
+        unsigned* sq_array;                 ///< Índices das entradas submetidas.
+        unsigned sq_entries;                ///< Número de entradas da fila de submissão.
+        unsigned local_tail;                ///< Cauda com as entradas preparadas e ainda não publicadas.
+        unsigned* cq_head;                  ///< Cabeça da fila de conclusão (avançada pela thread).
+        unsigned* cq_tail;                  ///< Cauda da fila de conclusão (avançada pelo kernel).
+        unsigned* cq_mask;                  ///< Máscara dos índices da fila de conclusão.
+        io_uring_cqe* cqes;                 ///< Vetor de entradas de conclusão.
+        char* buffer_pool;                  ///< Buffers registrados, um bloco por entrada da fila.
+        bool registration_attempted;        ///< Indica que o registro dos buffers já foi tentado.
+        bool buffers_registered;            ///< Indica que os buffers foram aceitos pelo kernel.
+
+        /**
+         * @brief Chama io_uring_enter.
+         */
+        int enter(unsigned to_submit, unsigned min_complete, unsigned flags) {
+            return static_cast<int>(syscall(__NR_io_uring_enter, ring_fd, to_submit, min_complete, flags, nullptr, 0));
+        }
+
+    public:
+        /**
+         * @brief Cria o anel e mapeia as suas filas.
+         */
+        Ring()
+            : ring_fd(-1), sq_ptr(MAP_FAILED), sq_ring_size(0), cq_ptr(MAP_FAILED), cq_ring_size(0), sqes(nullptr), sqes_size(0),
+              local_tail(0), buffer_pool(nullptr), registration_attempted(false), buffers_registered(false) {
+            io_uring_params params;
+            std::memset(&params, 0, sizeof(params));
+
+            int fd = static_cast<int>(syscall(__NR_io_uring_setup, Constants::IO_URING_QUEUE_DEPTH, &params));
+            if (fd < 0) {
+                return;
+            }
+
+            sq_ring_size = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+            cq_ring_size = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+            bool single_mmap = params.features & IORING_FEAT_SINGLE_MMAP;
+            if (single_mmap) {
+                sq_ring_size = cq_ring_size = std::max(sq_ring_size, cq_ring_size);
+            }
+
+            sq_ptr = mmap(nullptr, sq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+            if (sq_ptr != MAP_FAILED) {
+                cq_ptr = single_mmap ? sq_ptr : mmap(nullptr, cq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_CQ_RING);
+            }
+            sqes_size = params.sq_entries * sizeof(io_uring_sqe);
+            void* sqes_ptr = cq_ptr == MAP_FAILED ? MAP_FAILED
+                                                  : mmap(nullptr, sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES);
+
+            if (sqes_ptr == MAP_FAILED) {
+                if (cq_ptr != MAP_FAILED && cq_ptr != sq_ptr) {
+                    munmap(cq_ptr, cq_ring_size);
+                }
+                if (sq_ptr != MAP_FAILED) {
+                    munmap(sq_ptr, sq_ring_size);
+                }
+                sq_ptr = cq_ptr = MAP_FAILED;
+                close(fd);
+                return;
+            }
+
+            char* sq = static_cast<char*>(sq_ptr);
+            char* cq = static_cast<char*>(cq_ptr);
+            sq_head = reinterpret_cast<unsigned*>(sq + params.sq_off.head);
+            sq_tail = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+            sq_mask = reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+            sq_array = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+            sq_entries = params.sq_entries;
+            cq_head = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+            cq_tail = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+            cq_mask = reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+            cqes = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+            sqes = static_cast<io_uring_sqe*>(sqes_ptr);
+            local_tail = *sq_tail;
+            ring_fd = fd;
+        }
+
+        /**
+         * @brief Fecha o anel e libera as regiões mapeadas e os buffers.
+         */
+        ~Ring() {
+            if (ring_fd < 0) {
+                return;
+            }
+            close(ring_fd);
+            munmap(sqes, sqes_size);
+            if (cq_ptr != sq_ptr) {
+                munmap(cq_ptr, cq_ring_size);
+            }
+            munmap(sq_ptr, sq_ring_size);
+            if (buffer_pool != nullptr) {
+                munmap(buffer_pool, static_cast<size_t>(Constants::IO_URING_QUEUE_DEPTH) * Constants::IO_BLOCK_SIZE);
+            }
+        }
+
+        Ring(const Ring&) = delete;
+        Ring& operator=(const Ring&) = delete;
+
+        /**
+         * @brief Indica se o anel foi criado.
+         */
+        bool valid() const {
+            return ring_fd >= 0;
+        }
+
+        /**
+         * @brief Registra os buffers do anel na primeira chamada e indica se eles podem ser usados.
+         */
+        bool registerBuffers() {
+            if (registration_attempted) {
+                return buffers_registered;
+            }
+            registration_attempted = true;
+
+            size_t pool_size = static_cast<size_t>(Constants::IO_URING_QUEUE_DEPTH) * Constants::IO_BLOCK_SIZE;
+            void* pool = mmap(nullptr, pool_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (pool == MAP_FAILED) {
+                return false;
+            }
+            buffer_pool = static_cast<char*>(pool);
+
+            std::vector<iovec> iovecs(Constants::IO_URING_QUEUE_DEPTH);
+            for (int i = 0; i < Constants::IO_URING_QUEUE_DEPTH; ++i) {
+                iovecs[i].iov_base = buffer_pool + static_cast<size_t>(i) * Constants::IO_BLOCK_SIZE;
+                iovecs[i].iov_len = Constants::IO_BLOCK_SIZE;
+            }
+
+            // O registro fixa as páginas uma única vez, em vez de a cada operação
+            buffers_registered = syscall(__NR_io_uring_register, ring_fd, IORING_REGISTER_BUFFERS, iovecs.data(), iovecs.size()) == 0;
+            return buffers_registered;
+        }
+
+        /**
+         * @brief Retorna o buffer registrado de uma entrada da fila.
+         */
+        char* buffer(unsigned index) {
+            return buffer_pool + static_cast<size_t>(index) * Constants::IO_BLOCK_SIZE;
+        }
+
+        /**
+         * @brief Retorna uma entrada de submissão zerada, ou nulo se a fila estiver cheia.
+         */
+        io_uring_sqe* nextSqe() {
+            unsigned head = __atomic_load_n(sq_head, __ATOMIC_ACQUIRE);
+            if (local_tail - head >= sq_entries) {
+                return nullptr;
+            }
+
+            unsigned index = local_tail & *sq_mask;
+            sq_array[index] = index;
+            ++local_tail;
+
+            io_uring_sqe* sqe = &sqes[index];
+            std::memset(sqe, 0, sizeof(*sqe));
+            return sqe;
+        }
+
+        /**
+         * @brief Publica as entradas preparadas e as submete, esperando até wait_nr conclusões na mesma chamada.
+         */
+        bool submitAndWait(unsigned to_submit, unsigned wait_nr) {
+            __atomic_store_n(sq_tail, local_tail, __ATOMIC_RELEASE);
+
+            while (to_submit > 0) {
+                int submitted = enter(to_submit, wait_nr, IORING_ENTER_GETEVENTS);
+                if (submitted < 0) {
+                    if (errno == EINTR) {
+                        continue;
+                    }
+                    return false;
+                }
+                to_submit -= std::min(to_submit, static_cast<unsigned>(submitted));
+            }
+            return true;
+        }
+
+        /**
+         * @brief Retira a próxima conclusão, esperando por ela se necessário.
+         */
+        bool waitCqe(io_uring_cqe& cqe) {
+            while (true) {
+                unsigned head = *cq_head;
+                if (head != __atomic_load_n(cq_tail, __ATOMIC_ACQUIRE)) {
+                    cqe = cqes[head & *cq_mask];
+                    __atomic_store_n(cq_head, head + 1, __ATOMIC_RELEASE);
+                    return true;
+                }
+
+                if (enter(0, 1, IORING_ENTER_GETEVENTS) < 0 && errno != EINTR) {
+                    return false;
+                }
+            }
+        }
+    };
+
+    thread_local std::unique_ptr<Ring> thread_ring;     ///< Anel da thread atual, criado na primeira operação.
+    thread_local bool thread_ring_failed = false;       ///< Indica que o anel da thread não pôde ser criado.
+    std::atomic<IOBackend> default_backend{IOBackend::BLOCKING};   ///< Implementação dos peers criados a seguir (--io).
+
+    /**
+     * @brief Retorna o anel da thread atual, criando-o na primeira chamada (nulo se o kernel recusar).
+     */
+    Ring* threadRing() {
+        if (!thread_ring && !thread_ring_failed) {
+            thread_ring = std::make_unique<Ring>();
+            if (!thread_ring->valid()) {
+                thread_ring.reset();
+                thread_ring_failed = true;
+            }
+        }
+        return thread_ring.get();
+    }
+
+    /**
+     * @brief Descarta o anel da thread após um erro do kernel; a próxima operação cria outro.
+     */
+    void discardThreadRing() {
+        thread_ring.reset();
+    }
+}
+
+
+/**
+ * @brief Lê um arquivo inteiro.
+ */
+bool IOEngine::readFile(const std::string& path, std::vector<char>& data) {
+    int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return false;
+    }
+
+    struct stat file_stat;
+    bool ok = fstat(fd, &file_stat) == 0;
+    if (ok) {
+        data.resize(static_cast<size_t>(file_stat.st_size));
+        ok = readAt(fd, data.data(), data.size(), 0);
+    }
+
+    close(fd);
+    return ok;
+}
+
+
+/**
+ * @brief Lê um arquivo inteiro para um buffer do BufferPool global.
+ */
+bool IOEngine::readFile(const std::string& path, Buffer& data) {
+    int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return false;
+    }
+
+    struct stat file_stat;
+    bool ok = fstat(fd, &file_stat) == 0;
+    if (ok) {
+        data = BufferPool::instance().acquire(static_cast<size_t>(file_stat.st_size));
+        ok = readAt(fd, data.data(), data.size(), 0);
+    }
+
+    close(fd);
+    return ok;
+}
+
+
+/**
+ * @brief Cria (ou substitui) um arquivo com o conteúdo informado.
+ */
+bool IOEngine::writeFile(const std::string& path, const char* data, size_t size) {
+    int fd = open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        return false;
+    }
+
+    bool ok = writeAt(fd, data, size, 0);
+    close(fd);
+    return ok;
+}
+
+
+/**
+ * @brief Concatena arquivos, na ordem informada, em um novo arquivo.
+ */
+bool IOEngine::concatenateFiles(const std::vector<std::string>& input_paths, const std::string& output_path) {
+    int output_fd = open(output_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (output_fd < 0) {
+        return false;
+    }
+
+    // O mesmo buffer é reaproveitado por todos os arquivos de entrada
+    std::vector<char> buffer;
+    off_t offset = 0;
+    bool ok = true;
+    for (const std::string& input_path : input_paths) {
+        if (!readFile(input_path, buffer) || !writeAt(output_fd, buffer.data(), buffer.size(), offset)) {
+            ok = false;
+            break;
+        }
+        offset += static_cast<off_t>(buffer.size());
+    }
+
+    close(output_fd);
+    return ok;
+}
+
+
+/**
+ * @brief Cria a implementação de E/S pedida.
+ */
+std::unique_ptr<IOEngine> IOEngine::create(IOBackend backend) {
+    if (backend != IOBackend::BLOCKING) {
+        if (UringIOEngine::isAvailable()) {
+            return std::make_unique<UringIOEngine>();
+        }
+        if (backend == IOBackend::URING) {
+            LOG_MESSAGE(LogType::ERROR, "io_uring indisponível neste kernel. A E/S bloqueante será usada.");
+        }
+    }
+    return std::make_unique<BlockingIOEngine>();
+}
+
+
+/**
+ * @brief Retorna a implementação bloqueante compartilhada, usada quando nenhuma outra foi associada.
+ */
+IOEngine& IOEngine::blockingEngine() {
+    static BlockingIOEngine engine;
+    return engine;
+}
+
+
+/**
+ * @brief Define a implementação usada pelos peers criados a seguir (opção --io).
+ */
+void IOEngine::setDefaultBackend(IOBackend backend) {
+    default_backend.store(backend);
+}
+
+
+/**
+ * @brief Retorna a implementação usada pelos peers criados a seguir.
+ */
+IOBackend IOEngine::getDefaultBackend() {
+    return default_backend.load();
+}
+
+
+/**
+ * @brief Converte o nome de uma implementação (auto, blocking ou uring).
+ */
+bool IOEngine::parseBackend(const std::string& name, IOBackend& backend) {
+    if (name == "auto") {
+        backend = IOBackend::AUTO;
+    } else if (name == "blocking") {
+        backend = IOBackend::BLOCKING;
+    } else if (name == "uring") {
+        backend = IOBackend::URING;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+
+/**
+ * @brief Converte uma implementação para texto.
+ */
+const char* IOEngine::backendToString(IOBackend backend) {
+    switch (backend) {
+        case IOBackend::AUTO:       return "auto";
+        case IOBackend::BLOCKING:   return "blocking";
+        case IOBackend::URING:      return "uring";
+        default:                    return "unknown";
+    }
+}
+
+
+/**
+ * @brief Retorna a implementação efetivamente usada.
+ */
+IOBackend BlockingIOEngine::backend() const {
+    return IOBackend::BLOCKING;
+}
+
+
+/**
+ * @brief Lê exatamente size bytes de um arquivo a partir de offset.
+ */
+bool BlockingIOEngine::readAt(int fd, char* data, size_t size, off_t offset) {
+    size_t total = 0;
+    while (total < size) {
+        ssize_t bytes = pread(fd, data + total, size - total, offset + static_cast<off_t>(total));
+        if (bytes < 0 && errno == EINTR) {
+            continue;
+        }
+        if (bytes <= 0) {
+            return false;
+        }
+        total += static_cast<size_t>(bytes);
+    }
+    return true;
+}
+
+
+/**
+ * @brief Grava exatamente size bytes em um arquivo a partir de offset.
+ */
+bool BlockingIOEngine::writeAt(int fd, const char* data, size_t size, off_t offset) {
+    size_t total = 0;
+    while (total < size) {
+        ssize_t bytes = pwrite(fd, data + total, size - total, offset + static_cast<off_t>(total));
+        if (bytes < 0 && errno == EINTR) {
+            continue;
+        }
+        if (bytes <= 0) {
+            return false;
+        }
+        total += static_cast<size_t>(bytes);
+    }
+    return true;
+}
+
+
+/**
+ * @brief Envia por completo, em ordem, uma sequência de buffers por um socket.
+ */
+bool BlockingIOEngine::sendAll(int sockfd, const std::vector<std::tuple<const char*, size_t>>& buffers) {
+    for (const auto& [data, size] : buffers) {
+        size_t total = 0;
+        while (total < size) {
+            ssize_t bytes = send(sockfd, data + total, size - total, 0);
+            if (bytes < 0 && errno == EINTR) {
+                continue;
+            }
+            if (bytes <= 0) {
+                return false;
+            }
+            total += static_cast<size_t>(bytes);
+        }
+    }
+    return true;
+}
+
+
+/**
+ * @brief Recebe exatamente size bytes de um socket.
+ */
+bool BlockingIOEngine::recvAll(int sockfd, char* data, size_t size) {
+    size_t total = 0;
+    while (total < size) {
+        ssize_t bytes = recv(sockfd, data + total, size - total, 0);
+        if (bytes < 0 && errno == EINTR) {
+            continue;
+        }
+        if (bytes <= 0) {
+            return false;
+        }
+        total += static_cast<size_t>(bytes);
+    }
+    return true;
+}
+
+
+/**
+ * @brief Retorna a implementação efetivamente usada.
+ */
+IOBackend UringIOEngine::backend() const {
+    return IOBackend::URING;
+}
+
+
+/**
+ * @brief Verifica se o kernel permite criar um anel io_uring.
+ */
+bool UringIOEngine::isAvailable() {
+    // Resultado calculado uma vez: o io_uring pode estar desabilitado (io_uring_disabled) ou bloqueado por seccomp
+    static const bool available = [] {
+        io_uring_params params;
+        std::memset(&params, 0, sizeof(params));
+        int fd = static_cast<int>(syscall(__NR_io_uring_setup, 1, &params));
+        if (fd < 0) {
+            return false;
+        }
+        close(fd);
+        return true;
+    }();
+    return available;
+}
+
+
+/**
+ * @brief Lê exatamente size bytes de um arquivo a partir de offset.
+ */
+bool UringIOEngine::readAt(int fd, char* data, size_t size, off_t offset) {
+    return transferBlocks(fd, data, size, offset, false);
+}
+
+
+/**
+ * @brief Grava exatamente size bytes em um arquivo a partir de offset.
+ */
+bool UringIOEngine::writeAt(int fd, const char* data, size_t size, off_t offset) {
+    // O buffer só é lido nas gravações
+    return transferBlocks(fd, const_cast<char*>(data), size, offset, true);
+}
+
+
+/**
+ * @brief Lê ou grava blocos de um arquivo em lotes pelo anel da thread.
+ */
+bool UringIOEngine::transferBlocks(int fd, char* data, size_t size, off_t offset, bool write) {
+    Ring* ring = threadRing();
+    if (ring == nullptr) {
+        return write ? fallback.writeAt(fd, data, size, offset) : fallback.readAt(fd, data, size, offset);
+    }
+
+    const size_t block_size = Constants::IO_BLOCK_SIZE;
+    const bool fixed = ring->registerBuffers();
+    std::vector<size_t> lengths(Constants::IO_URING_QUEUE_DEPTH);
+    size_t position = 0;
+
+    while (position < size) {
+        // Prepara um lote com até IO_URING_QUEUE_DEPTH blocos consecutivos
+        size_t batch_start = position;
+        unsigned count = 0;
+        while (count < static_cast<unsigned>(Constants::IO_URING_QUEUE_DEPTH) && position < size) {
+            io_uring_sqe* sqe = ring->nextSqe();
+            if (sqe == nullptr) {
+                break;
+            }
+
+            size_t length = std::min(block_size, size - position);
+            sqe->fd = fd;
+            sqe->off = static_cast<uint64_t>(offset) + position;
+            sqe->len = static_cast<uint32_t>(length);
+            sqe->user_data = count;
+            if (fixed) {
+                char* buffer = ring->buffer(count);
+                if (write) {
+                    std::memcpy(buffer, data + position, length);
+                }
+                sqe->opcode = write ? IORING_OP_WRITE_FIXED : IORING_OP_READ_FIXED;
+                sqe->addr = reinterpret_cast<uint64_t>(buffer);
+                sqe->buf_index = static_cast<uint16_t>(count);
+            } else {
+                sqe->opcode = write ? IORING_OP_WRITE : IORING_OP_READ;
+                sqe->addr = reinterpret_cast<uint64_t>(data + position);
+            }
+
+            lengths[count] = length;
+            position += length;
+            ++count;
+        }
+
+        // Um único io_uring_enter submete o lote e espera as conclusões
+        if (count == 0 || !ring->submitAndWait(count, count)) {
+            discardThreadRing();
+            return false;
+        }
+
+        bool ok = true;
+        for (unsigned completed = 0; completed < count; ++completed) {
+            io_uring_cqe cqe;
+            if (!ring->waitCqe(cqe)) {
+                discardThreadRing();
+                return false;
+            }
+
+            unsigned index = static_cast<unsigned>(cqe.user_data);
+            size_t block_position = batch_start + static_cast<size_t>(index) * block_size;
+            if (cqe.res < 0) {
+                errno = -cqe.res;
+                ok = false;
+                continue;
+            }
+
+            size_t done = static_cast<size_t>(cqe.res);
+            if (!write && fixed) {
+                std::memcpy(data + block_position, ring->buffer(index), done);
+            }
+
+            // Bloco parcial: o restante é transferido com as chamadas bloqueantes
+            if (done < lengths[index]) {
+                size_t remaining_position = block_position + done;
+                off_t remaining_offset = offset + static_cast<off_t>(remaining_position);
+                ok = ok && (write ? fallback.writeAt(fd, data + remaining_position, lengths[index] - done, remaining_offset)
+                                  : fallback.readAt(fd, data + remaining_position, lengths[index] - done, remaining_offset));
+            }
+        }
+
+        if (!ok) {
+            return false;
+        }
+    }
+    return true;
+}
+
+
+/**
+ * @brief Envia por completo, em ordem, uma sequência de buffers por um socket.
+ */
+bool UringIOEngine::sendAll(int sockfd, const std::vector<std::tuple<const char*, size_t>>& buffers) {
+    Ring* ring = threadRing();
+    if (ring == nullptr || buffers.empty() || buffers.size() > static_cast<size_t>(Constants::IO_URING_QUEUE_DEPTH)) {
+        return fallback.sendAll(sockfd, buffers);
+    }
+
+    // Os envios são encadeados: o kernel os executa em ordem, e uma falha cancela os seguintes
+    unsigned count = 0;
+    for (const auto& [data, size] : buffers) {
+        io_uring_sqe* sqe = ring->nextSqe();
+        if (sqe == nullptr) {
+            break;
+        }
+        sqe->opcode = IORING_OP_SEND;
+        sqe->fd = sockfd;
+        sqe->addr = reinterpret_cast<uint64_t>(data);
+        sqe->len = static_cast<uint32_t>(size);
+        sqe->msg_flags = MSG_WAITALL;
+        sqe->user_data = count;
+        if (count + 1 < buffers.size()) {
+            sqe->flags = IOSQE_IO_LINK;
+        }
+        ++count;
+    }
+
+    if (count != buffers.size() || !ring->submitAndWait(count, count)) {
+        discardThreadRing();
+        return false;
+    }
+
+    std::vector<int> results(count, 0);
+    for (unsigned completed = 0; completed < count; ++completed) {
+        io_uring_cqe cqe;
+        if (!ring->waitCqe(cqe)) {
+            discardThreadRing();
+            return false;
+        }
+        results[cqe.user_data] = cqe.res;
+    }
+
+    // O primeiro envio incompleto (parcial ou cancelado pela corrente) e os seguintes são completados com send
+    for (unsigned i = 0; i < count; ++i) {
+        const auto& [data, size] = buffers[i];
+        if (results[i] >= 0 && static_cast<size_t>(results[i]) == size) {
+            continue;
+        }
+        if (results[i] < 0 && results[i] != -ECANCELED) {
+            errno = -results[i];
+            return false;
+        }
+
+        size_t done = results[i] > 0 ? static_cast<size_t>(results[i]) : 0;
+        std::vector<std::tuple<const char*, size_t>> remaining = {{data + done, size - done}};
+        remaining.insert(remaining.end(), buffers.begin() + i + 1, buffers.end());
+        return fallback.sendAll(sockfd, remaining);
+    }
+    return true;
+}
+
+
+/**
+ * @brief Recebe exatamente size bytes de um socket.
+ */
+bool UringIOEngine::recvAll(int sockfd, char* data, size_t size) {
+    Ring* ring = threadRing();
+    if (ring == nullptr) {
+        return fallback.recvAll(sockfd, data, size);
+    }
+
+    size_t total = 0;
+    while (total < size) {
+        io_uring_sqe* sqe = ring->nextSqe();
+        if (sqe == nullptr) {
+            discardThreadRing();
+            return false;
+        }
+        sqe->opcode = IORING_OP_RECV;
+        sqe->fd = sockfd;
+        sqe->addr = reinterpret_cast<uint64_t>(data + total);
+        sqe->len = static_cast<uint32_t>(size - total);
+        sqe->msg_flags = MSG_WAITALL;
+
+        io_uring_cqe cqe;
+        if (!ring->submitAndWait(1, 1) || !ring->waitCqe(cqe)) {
+            discardThreadRing();
+            return false;
+        }
+
+        // Zero indica que a conexão foi fechada antes do fim
+        if (cqe.res <= 0) {
+            if (cqe.res < 0) {
+                errno = -cqe.res;
+            }
+            return false;
+        }
+        total += static_cast<size_t>(cqe.res);
+    }
+    return true;
+}
@@ -0,0 +1,240 @@
+#ifndef IOENGINE_H
+#define IOENGINE_H
+
+#include "BufferPool.h"
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <sys/types.h>
+#include <tuple>
+#include <vector>
+
+
+/**
+ * @brief Enumeração das implementações de E/S dos chunks.
+ */
+enum class IOBackend {
+    AUTO,           ///< io_uring quando o kernel permite, senão chamadas bloqueantes.
+    BLOCKING,       ///< Chamadas bloqueantes (pread, pwrite, send e recv).
+    URING           ///< Operações em lote pelo io_uring, com buffers registrados.
+};
+
+
+/**
+ * @brief Classe base das implementações de E/S dos chunks em arquivos e sockets.
+ *
+ * Concentra as leituras e gravações dos chunks (TCPServer e FileManager), a montagem do arquivo
+ * final e o envio e recebimento dos chunks pelas conexões TCP. As operações de arquivo são
+ * divididas em blocos de Constants::IO_BLOCK_SIZE bytes, que a implementação pode submeter em
+ * lote. A implementação é escolhida em tempo de execução por create; quando o io_uring não está
+ * disponível, a implementação bloqueante é usada.
+ */
+class IOEngine {
+public:
+    virtual ~IOEngine() = default;
+
+
+    /**
+     * @brief Retorna a implementação efetivamente usada.
+     *
+     * @return IOBackend::BLOCKING ou IOBackend::URING.
+     */
+    virtual IOBackend backend() const = 0;
+
+
+    /**
+     * @brief Lê exatamente size bytes de um arquivo a partir de offset.
+     *
+     * @param fd Descritor do arquivo.
+     * @param data Buffer de destino.
+     * @param size Número de bytes.
+     * @param offset Posição inicial no arquivo.
+     * @return true se todos os bytes foram lidos.
+     */
+    virtual bool readAt(int fd, char* data, size_t size, off_t offset) = 0;
+
+
+    /**
+     * @brief Grava exatamente size bytes em um arquivo a partir de offset.
+     *
+     * @param fd Descritor do arquivo.
+     * @param data Bytes a gravar.
+     * @param size Número de bytes.
+     * @param offset Posição inicial no arquivo.
+     * @return true se todos os bytes foram gravados.
+     */
+    virtual bool writeAt(int fd, const char* data, size_t size, off_t offset) = 0;
+
+
+    /**
+     * @brief Envia por completo, em ordem, uma sequência de buffers por um socket.
+     *
+     * @param sockfd Socket conectado.
+     * @param buffers Ponteiro e tamanho de cada buffer.
+     * @return true se todos os bytes foram enviados.
+     */
+    virtual bool sendAll(int sockfd, const std::vector<std::tuple<const char*, size_t>>& buffers) = 0;
+
+
+    /**
+     * @brief Recebe exatamente size bytes de um socket.
+     *
+     * @param sockfd Socket conectado.
+     * @param data Buffer de destino.
+     * @param size Número de bytes.
+     * @return true se todos os bytes foram recebidos (false em erro ou conexão fechada).
+     */
+    virtual bool recvAll(int sockfd, char* data, size_t size) = 0;
+
+
+    /**
+     * @brief Lê um arquivo inteiro.
+     *
+     * @param path Caminho do arquivo.
+     * @param data Vetor que recebe o conteúdo.
+     * @return true se o arquivo foi aberto e lido por completo.
+     */
+    bool readFile(const std::string& path, std::vector<char>& data);
+
+
+    /**
+     * @brief Lê um arquivo inteiro para um buffer do BufferPool global.
+     *
+     * @param path Caminho do arquivo.
+     * @param data Buffer que recebe o conteúdo (substituído por um buffer do tamanho do arquivo).
+     * @return true se o arquivo foi aberto e lido por completo.
+     */
+    bool readFile(const std::string& path, Buffer& data);
+
+
+    /**
+     * @brief Cria (ou substitui) um arquivo com o conteúdo informado.
+     *
+     * @param path Caminho do arquivo.
+     * @param data Conteúdo.
+     * @param size Número de bytes.
+     * @return true se o arquivo foi gravado por completo.
+     */
+    bool writeFile(const std::string& path, const char* data, size_t size);
+
+
+    /**
+     * @brief Concatena arquivos, na ordem informada, em um novo arquivo.
+     *
+     * @param input_paths Caminhos dos arquivos de entrada.
+     * @param output_path Caminho do arquivo de saída.
+     * @return true se todos os arquivos foram lidos e gravados.
+     */
+    bool concatenateFiles(const std::vector<std::string>& input_paths, const std::string& output_path);
+
+
+    /**
+     * @brief Cria a implementação de E/S pedida.
+     *
+     * @param backend Implementação desejada; URING e AUTO usam a bloqueante quando o io_uring não está disponível.
+     * @return Implementação criada.
+     */
+    static std::unique_ptr<IOEngine> create(IOBackend backend);
+
+
+    /**
+     * @brief Retorna a implementação bloqueante compartilhada, usada quando nenhuma outra foi associada.
+     *
+     * @return Referência à implementação bloqueante.
+     */
+    static IOEngine& blockingEngine();
+
+
+    /**
+     * @brief Define a implementação usada pelos peers criados a seguir (opção --io).
+     *
+     * @param backend Implementação desejada.
+     */
+    static void setDefaultBackend(IOBackend backend);
+
+
+    /**
+     * @brief Retorna a implementação usada pelos peers criados a seguir.
+     *
+     * @return Implementação definida por setDefaultBackend (padrão: BLOCKING, a mais rápida com os arquivos em cache nas medições do p2p-bench).
+     */
+    static IOBackend getDefaultBackend();
+
+
+    /**
+     * @brief Converte o nome de uma implementação (auto, blocking ou uring).
+     *
+     * @param name Nome da implementação.
+     * @param backend Implementação correspondente.
+     * @return true se o nome é válido.
+     */
+    static bool parseBackend(const std::string& name, IOBackend& backend);
+
+
+    /**
+     * @brief Converte uma implementação para texto.
+     *
+     * @param backend Implementação.
+     * @return Nome da implementação.
+     */
+    static const char* backendToString(IOBackend backend);
+};
+
+
+/**
+ * @brief Implementação bloqueante, com pread, pwrite, send e recv.
+ */
+class BlockingIOEngine : public IOEngine {
+public:
+    IOBackend backend() const override;
+    bool readAt(int fd, char* data, size_t size, off_t offset) override;
+    bool writeAt(int fd, const char* data, size_t size, off_t offset) override;
+    bool sendAll(int sockfd, const std::vector<std::tuple<const char*, size_t>>& buffers) override;
+    bool recvAll(int sockfd, char* data, size_t size) override;
+};
+
+
+/**
+ * @brief Implementação com io_uring, acessado diretamente pelas chamadas de sistema (sem liburing).
+ *
+ * Cada thread usa o seu próprio anel, criado na primeira operação e fechado quando a thread
+ * termina, para que as threads não disputem a fila de submissão. As operações de arquivo
+ * submetem até Constants::IO_URING_QUEUE_DEPTH blocos em uma única chamada io_uring_enter e
+ * usam buffers registrados no anel (READ_FIXED e WRITE_FIXED); se o registro for recusado, os
+ * blocos são lidos e gravados direto na memória do chamador. Os buffers de um envio seguem
+ * encadeados (IOSQE_IO_LINK), em uma única submissão. Um resultado parcial é completado com
+ * as chamadas bloqueantes.
+ */
+class UringIOEngine : public IOEngine {
+public:
+    IOBackend backend() const override;
+    bool readAt(int fd, char* data, size_t size, off_t offset) override;
+    bool writeAt(int fd, const char* data, size_t size, off_t offset) override;
+    bool sendAll(int sockfd, const std::vector<std::tuple<const char*, size_t>>& buffers) override;
+    bool recvAll(int sockfd, char* data, size_t size) override;
+
+
+    /**
+     * @brief Verifica se o kernel permite criar um anel io_uring.
+     *
+     * @return true se o io_uring está disponível.
+     */
+    static bool isAvailable();
+
+private:
+    BlockingIOEngine fallback;                              ///< Completa os resultados parciais e substitui o anel quando ele não pode ser criado.
+
+    /**
+     * @brief Lê ou grava blocos de um arquivo em lotes pelo anel da thread.
+     *
+     * @param fd Descritor do arquivo.
+     * @param data Buffer do chamador.
+     * @param size Número de bytes.
+     * @param offset Posição inicial no arquivo.
+     * @param write true para gravar, false para ler.
+     * @return true se todos os bytes foram transferidos.
+     */
+    bool transferBlocks(int fd, char* data, size_t size, off_t offset, bool write);
+};
+
+#endif // IOENGINE_H
@@ -0,0 +1,449 @@
+#include "Logger.h"
+#include "Constants.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+
+
+namespace {
+    /**
+     * @brief Estrutura que guarda o buffer de log da thread atual e o marca como órfão quando a thread termina.
+     */
+    struct ThreadRingHolder {
+        std::shared_ptr<LogRing> ring;  ///< Buffer da thread.
+        uint32_t thread_id = 0;         ///< Identificador sequencial da thread.
+
+        ~ThreadRingHolder() {
+            if (ring) {
+                ring->orphaned.store(true, std::memory_order_release);
+            }
+        }
+    };
+
+    thread_local ThreadRingHolder thread_ring_holder;   ///< Buffer de log da thread atual.
+    std::atomic<uint32_t> next_thread_id{1};            ///< Próximo identificador sequencial de thread.
+}
+
+
+std::atomic<int> Logger::level{static_cast<int>(LogLevel::TRACE)};
+
+
+/**
+ * @brief Construtor da classe LogRing.
+ */
+LogRing::LogRing(size_t capacity)
+    : slots([capacity] { size_t size = 1; while (size < capacity) size <<= 1; return size; }()),
+      mask(slots.size() - 1), head(0), tail(0), orphaned(false) {}
+
+
+/**
+ * @brief Insere uma mensagem no buffer.
+ */
+bool LogRing::push(LogRecord&& record) {
+    size_t current_head = head.load(std::memory_order_relaxed);
+
+    // Buffer cheio: a thread escritora ainda não retirou as mensagens mais antigas
+    if (current_head - tail.load(std::memory_order_acquire) >= slots.size()) {
+        return false;
+    }
+
+    slots[current_head & mask] = std::move(record);
+    head.store(current_head + 1, std::memory_order_release);
+    return true;
+}
+
+
+/**
+ * @brief Retira a mensagem mais antiga do buffer.
+ */
+bool LogRing::pop(LogRecord& record) {
+    size_t current_tail = tail.load(std::memory_order_relaxed);
+
+    // Buffer vazio
+    if (current_tail == head.load(std::memory_order_acquire)) {
+        return false;
+    }
+
+    record = std::move(slots[current_tail & mask]);
+    tail.store(current_tail + 1, std::memory_order_release);
+    return true;
+}
+
+
+/**
+ * @brief Verifica se o buffer está vazio.
+ */
+bool LogRing::empty() const {
+    return tail.load(std::memory_order_acquire) == head.load(std::memory_order_acquire);
+}
+
+
+/**
+ * @brief Construtor da classe Logger. Inicia a thread escritora.
+ */
+Logger::Logger()
+    : format(static_cast<int>(LogFormat::TEXT)), rings_version(0), output(stdout), running(true) {
+    writer_thread = std::thread(&Logger::writerLoop, this);
+    writer_thread.detach();
+}
+
+
+/**
+ * @brief Retorna a instância única do Logger.
+ */
+Logger& Logger::instance() {
+    static Logger* logger = [] {
+        Logger* created = new Logger();
+
+        // Escreve as mensagens pendentes quando o programa terminar
+        std::atexit([] { Logger::instance().shutdown(); });
+        return created;
+    }();
+
+    return *logger;
+}
+
+
+/**
+ * @brief Retorna o nível de log mínimo em que um tipo de mensagem é exibido.
+ */
+LogLevel Logger::levelOf(LogType type) {
+    switch (type) {
+        case LogType::ERROR:
+            return LogLevel::ERROR;
+        case LogType::INFO:
+        case LogType::SUCCESS:
+            return LogLevel::INFO;
+        case LogType::CHUNK_SENT:
+        case LogType::CHUNK_RECEIVED:
+            return LogLevel::TRACE;
+        default:
+            return LogLevel::DEBUG;
+    }
+}
+
+
+/**
+ * @brief Retorna o buffer da thread atual, registrando-o na primeira chamada.
+ */
+LogRing& Logger::threadRing() {
+    if (!thread_ring_holder.ring) {
+        std::lock_guard<std::mutex> rings_lock(rings_mutex);
+
+        // Reaproveita o buffer de uma thread que já terminou e cujas mensagens já foram escritas
+        for (const auto& ring : rings) {
+            if (ring->orphaned.load(std::memory_order_acquire) && ring->empty()) {
+                ring->orphaned.store(false, std::memory_order_release);
+                thread_ring_holder.ring = ring;
+                break;
+            }
+        }
+
+        // Nenhum buffer livre, cria um novo e avisa a thread escritora
+        if (!thread_ring_holder.ring) {
+            thread_ring_holder.ring = std::make_shared<LogRing>(Constants::LOG_RING_CAPACITY);
+            rings.push_back(thread_ring_holder.ring);
+            rings_version.fetch_add(1, std::memory_order_release);
+        }
+
+        thread_ring_holder.thread_id = next_thread_id.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    return *thread_ring_holder.ring;
+}
+
+
+/**
+ * @brief Enfileira uma mensagem no buffer da thread atual.
+ */
+void Logger::log(LogType type, std::string message, bool banner) {
+    LogRing& ring = threadRing();
+
+    LogRecord record;
+    record.timestamp_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    record.thread_id = thread_ring_holder.thread_id;
+    record.type = type;
+    record.banner = banner;
+    record.message = std::move(message);
+
+    // Com o buffer cheio, cede a vez até a thread escritora liberar espaço
+    // (ou escreve as mensagens diretamente, caso ela já tenha sido encerrada)
+    while (!ring.push(std::move(record))) {
+        if (!running.load(std::memory_order_acquire)) {
+            flush();
+        }
+        std::this_thread::yield();
+    }
+}
+
+
+/**
+ * @brief Loop da thread escritora.
+ */
+void Logger::writerLoop() {
+    std::vector<std::shared_ptr<LogRing>> rings_snapshot;
+    uint64_t seen_version = 0;
+
+    while (running.load(std::memory_order_acquire)) {
+        // Atualiza a cópia da lista de buffers somente quando uma nova thread se registrou
+        uint64_t current_version = rings_version.load(std::memory_order_acquire);
+        if (current_version != seen_version) {
+            std::lock_guard<std::mutex> rings_lock(rings_mutex);
+            rings_snapshot = rings;
+            seen_version = current_version;
+        }
+
+        size_t written;
+        {
+            std::lock_guard<std::mutex> output_lock(output_mutex);
+
+            // A saída do programa já escreveu as mensagens pendentes
+            if (!running.load(std::memory_order_acquire)) {
+                return;
+            }
+            written = drain(rings_snapshot);
+        }
+
+        // Sem mensagens pendentes, espera um pouco antes de verificar novamente
+        if (written == 0) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(Constants::LOG_WRITER_IDLE_MILLISECONDS));
+        }
+    }
+}
+
+
+/**
+ * @brief Esvazia todos os buffers e escreve as mensagens no destino.
+ */
+size_t Logger::drain(std::vector<std::shared_ptr<LogRing>>& rings_snapshot) {
+    // Nunca é destruído: o atexit registrado em instance() ainda esvazia os buffers depois dos destrutores estáticos
+    static std::vector<LogRecord>* batch_storage = new std::vector<LogRecord>();
+    std::vector<LogRecord>& batch = *batch_storage;
+    batch.clear();
+
+    LogRecord record;
+    for (const auto& ring : rings_snapshot) {
+        while (ring->pop(record)) {
+            batch.push_back(std::move(record));
+        }
+    }
+
+    if (batch.empty()) {
+        return 0;
+    }
+
+    // Cada buffer já está em ordem; intercala as mensagens das threads pelo instante em que foram geradas
+    std::stable_sort(batch.begin(), batch.end(), [](const LogRecord& a, const LogRecord& b) {
+        return a.timestamp_ns < b.timestamp_ns;
+    });
+
+    for (const auto& batch_record : batch) {
+        write(batch_record);
+    }
+
+    // Um único flush por lote
+    std::fflush(output);
+    return batch.size();
+}
+
+
+/**
+ * @brief Escreve uma mensagem no destino, de acordo com o formato atual.
+ */
+void Logger::write(const LogRecord& record) {
+    LogFormat current_format = static_cast<LogFormat>(format.load(std::memory_order_relaxed));
+
+    if (current_format == LogFormat::BINARY) {
+        // Registro: timestamp (8 bytes), thread (4 bytes), tipo (1 byte), tamanho (4 bytes) e mensagem
+        uint8_t type = static_cast<uint8_t>(record.type);
+        uint32_t length = static_cast<uint32_t>(record.message.size());
+        std::fwrite(&record.timestamp_ns, sizeof(record.timestamp_ns), 1, output);
+        std::fwrite(&record.thread_id, sizeof(record.thread_id), 1, output);
+        std::fwrite(&type, sizeof(type), 1, output);
+        std::fwrite(&length, sizeof(length), 1, output);
+        std::fwrite(record.message.data(), 1, length, output);
+        return;
+    }
+
+    if (current_format == LogFormat::JSON) {
+        std::string escaped;
+        escaped.reserve(record.message.size());
+        for (char c : record.message) {
+            switch (c) {
+                case '"':  escaped += "\\\""; break;
+                case '\\': escaped += "\\\\"; break;
+                case '\n': escaped += "\\n";  break;
+                case '\t': escaped += "\\t";  break;
+                default:
+                    if (static_cast<unsigned char>(c) < 0x20) {
+                        char code[8];
+                        std::snprintf(code, sizeof(code), "\\u%04x", c);
+                        escaped += code;
+                    } else {
+                        escaped += c;
+                    }
+            }
+        }
+        std::fprintf(output, "{\"timestamp_ns\":%llu,\"thread\":%u,\"type\":\"%s\",\"message\":\"%s\"}\n",
+                     static_cast<unsigned long long>(record.timestamp_ns), record.thread_id,
+                     typeName(record.type), escaped.c_str());
+        return;
+    }
+
+    if (record.banner) {
+        // Definição das cores
+        const std::string colors[] = {
+            Constants::RED,
+            Constants::YELLOW,
+            Constants::GREEN,
+            Constants::BLUE,
+            Constants::MAGENTA,
+        };
+        size_t width = record.message.length() + 8;
+        std::string border(width, '#');
+        std::string inner(width - 6, ' ');
+
+        // Exibe as bordas coloridas (superior)
+        for (int i = 0; i < 3; ++i) {
+            std::fprintf(output, "%s%s%s\n", colors[i].c_str(), border.c_str(), Constants::RESET.c_str());
+        }
+
+        // Moldura interna, mensagem central em branco e moldura interna inferior
+        std::fprintf(output, "%s###%s%s%s###%s\n", colors[3].c_str(), colors[4].c_str(), inner.c_str(), colors[3].c_str(), Constants::RESET.c_str());
+        std::fprintf(output, "%s### %s%s%s ###%s\n", colors[3].c_str(), Constants::RESET.c_str(), record.message.c_str(), colors[3].c_str(), Constants::RESET.c_str());
+        std::fprintf(output, "%s###%s%s%s###%s\n", colors[3].c_str(), colors[4].c_str(), inner.c_str(), colors[3].c_str(), Constants::RESET.c_str());
+
+        // Exibe as bordas coloridas (inferior)
+        for (int i = 0; i < 3; ++i) {
+            std::fprintf(output, "%s%s%s\n", colors[i].c_str(), border.c_str(), Constants::RESET.c_str());
+        }
+        return;
+    }
+
+    const std::string* color;
+    switch (record.type) {
+        case LogType::DISCOVERY_RECEIVED: color = &Constants::YELLOW;  break;
+        case LogType::DISCOVERY_SENT:     color = &Constants::MAGENTA; break;
+        case LogType::RESPONSE_RECEIVED:  color = &Constants::CYAN;    break;
+        case LogType::RESPONSE_SENT:      color = &Constants::GRAY;    break;
+        case LogType::REQUEST_RECEIVED:   color = &Constants::ORANGE;  break;
+        case LogType::REQUEST_SENT:       color = &Constants::PINK;    break;
+        case LogType::CHUNK_RECEIVED:     color = &Constants::GOLD;    break;
+        case LogType::CHUNK_SENT:         color = &Constants::AQUA;    break;
+        case LogType::SUCCESS:            color = &Constants::GREEN;   break;
+        case LogType::INFO:               color = &Constants::BLUE;    break;
+        case LogType::ERROR:              color = &Constants::RED;     break;
+        default:                          color = &Constants::ORANGE;  break;
+    }
+
+    std::fprintf(output, "%s[%s] %s%s\n", color->c_str(), typeName(record.type), record.message.c_str(), Constants::RESET.c_str());
+}
+
+
+/**
+ * @brief Escreve imediatamente todas as mensagens pendentes.
+ */
+void Logger::flush() {
+    std::vector<std::shared_ptr<LogRing>> rings_snapshot;
+    {
+        std::lock_guard<std::mutex> rings_lock(rings_mutex);
+        rings_snapshot = rings;
+    }
+
+    std::lock_guard<std::mutex> output_lock(output_mutex);
+    drain(rings_snapshot);
+    std::fflush(output);
+}
+
+
+/**
+ * @brief Escreve as mensagens pendentes e encerra a thread escritora. Chamado na saída do programa.
+ */
+void Logger::shutdown() {
+    flush();
+
+    std::lock_guard<std::mutex> output_lock(output_mutex);
+    running.store(false, std::memory_order_release);
+}
+
+
+/**
+ * @brief Define o nível de log.
+ */
+void Logger::setLevel(LogLevel new_level) {
+    level.store(static_cast<int>(new_level), std::memory_order_relaxed);
+}
+
+
+/**
+ * @brief Define o formato de saída.
+ */
+void Logger::setFormat(LogFormat new_format) {
+    format.store(static_cast<int>(new_format), std::memory_order_relaxed);
+}
+
+
+/**
+ * @brief Define o arquivo de destino das mensagens.
+ */
+bool Logger::setOutputFile(const std::string& path) {
+    FILE* file = std::fopen(path.c_str(), "ab");
+    if (file == nullptr) {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> output_lock(output_mutex);
+    std::fflush(output);
+    if (output != stdout) {
+        std::fclose(output);
+    }
+    output = file;
+    return true;
+}
+
+
+/**
+ * @brief Converte o nome de um nível de log (error, info, debug, trace).
+ */
+bool Logger::parseLevel(const std::string& name, LogLevel& parsed_level) {
+    if (name == "error")      parsed_level = LogLevel::ERROR;
+    else if (name == "info")  parsed_level = LogLevel::INFO;
+    else if (name == "debug") parsed_level = LogLevel::DEBUG;
+    else if (name == "trace") parsed_level = LogLevel::TRACE;
+    else return false;
+    return true;
+}
+
+
+/**
+ * @brief Converte o nome de um formato de log (text, json, binary).
+ */
+bool Logger::parseFormat(const std::string& name, LogFormat& parsed_format) {
+    if (name == "text")        parsed_format = LogFormat::TEXT;
+    else if (name == "json")   parsed_format = LogFormat::JSON;
+    else if (name == "binary") parsed_format = LogFormat::BINARY;
+    else return false;
+    return true;
+}
+
+
+/**
+ * @brief Retorna o nome de um tipo de mensagem (ex: "DISCOVERY_SENT").
+ */
+const char* Logger::typeName(LogType type) {
+    switch (type) {
+        case LogType::ERROR:              return "ERROR";
+        case LogType::INFO:               return "INFO";
+        case LogType::DISCOVERY_RECEIVED: return "DISCOVERY_RECEIVED";
+        case LogType::DISCOVERY_SENT:     return "DISCOVERY_SENT";
+        case LogType::REQUEST_RECEIVED:   return "REQUEST_RECEIVED";
+        case LogType::REQUEST_SENT:       return "REQUEST_SENT";
+        case LogType::RESPONSE_RECEIVED:  return "RESPONSE_RECEIVED";
+        case LogType::RESPONSE_SENT:      return "RESPONSE_SENT";
+        case LogType::CHUNK_SENT:         return "CHUNK_SENT";
+        case LogType::CHUNK_RECEIVED:     return "CHUNK_RECEIVED";
+        case LogType::SUCCESS:            return "SUCCESS";
+        default:                          return "OTHER";
+    }
+}
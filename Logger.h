@@ -0,0 +1,282 @@
+#ifndef LOGGER_H
+#define LOGGER_H
+
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+
+/**
+ * @brief Enumeração para os tipos de mensagens de log
+ */
+enum class LogType {
+    ERROR,
+    INFO,
+    DISCOVERY_RECEIVED,
+    DISCOVERY_SENT,
+    REQUEST_RECEIVED,
+    REQUEST_SENT,
+    RESPONSE_RECEIVED,
+    RESPONSE_SENT,
+    CHUNK_SENT,
+    CHUNK_RECEIVED,
+    SUCCESS,
+    OTHER
+};
+
+
+/**
+ * @brief Enumeração para os níveis de log. Um nível habilita também todos os anteriores.
+ */
+enum class LogLevel {
+    ERROR = 0,      ///< Apenas erros.
+    INFO  = 1,      ///< Erros, informações gerais e sucessos.
+    DEBUG = 2,      ///< Inclui as mensagens de controle (DISCOVERY, RESPONSE, REQUEST).
+    TRACE = 3       ///< Inclui o progresso de cada bloco de chunk enviado e recebido.
+};
+
+
+/**
+ * @brief Enumeração para os formatos de saída do log.
+ */
+enum class LogFormat {
+    TEXT,           ///< Texto colorido para o terminal.
+    JSON,           ///< Um objeto JSON por linha.
+    BINARY          ///< Registros binários de tamanho variável (timestamp, thread, tipo, tamanho, mensagem).
+};
+
+
+/**
+ * @brief Estrutura que armazena uma mensagem de log até ela ser escrita.
+ */
+struct LogRecord {
+    uint64_t timestamp_ns = 0;  ///< Instante em que a mensagem foi gerada, em nanossegundos desde a época Unix.
+    uint32_t thread_id = 0;     ///< Identificador da thread que gerou a mensagem.
+    LogType type = LogType::OTHER; ///< Tipo da mensagem.
+    bool banner = false;        ///< Indica que a mensagem deve ser exibida em destaque (moldura) no formato texto.
+    std::string message;        ///< Texto da mensagem.
+};
+
+
+/**
+ * @brief Buffer circular de mensagens de log de uma única thread.
+ *
+ * Apenas a thread dona escreve (push) e apenas a thread escritora do Logger lê (pop),
+ * então o acesso é coordenado somente com índices atômicos, sem mutex.
+ */
+class LogRing {
+private:
+    std::vector<LogRecord> slots;       ///< Posições do buffer circular (capacidade potência de 2).
+    const size_t mask;                  ///< Máscara para converter índices em posições.
+    std::atomic<size_t> head;           ///< Próxima posição a ser escrita pela thread dona.
+    std::atomic<size_t> tail;           ///< Próxima posição a ser lida pela thread escritora.
+
+public:
+    std::atomic<bool> orphaned;         ///< Indica que a thread dona terminou e o buffer pode ser descartado após esvaziar.
+
+    /**
+     * @brief Construtor da classe LogRing.
+     *
+     * @param capacity Capacidade do buffer (arredondada para a próxima potência de 2).
+     */
+    explicit LogRing(size_t capacity);
+
+
+    /**
+     * @brief Insere uma mensagem no buffer.
+     *
+     * @param record Mensagem a ser inserida.
+     * @return true se havia espaço, false se o buffer está cheio.
+     */
+    bool push(LogRecord&& record);
+
+
+    /**
+     * @brief Retira a mensagem mais antiga do buffer.
+     *
+     * @param record Destino da mensagem retirada.
+     * @return true se havia mensagem, false se o buffer está vazio.
+     */
+    bool pop(LogRecord& record);
+
+
+    /**
+     * @brief Verifica se o buffer está vazio.
+     *
+     * @return true se não há mensagens pendentes.
+     */
+    bool empty() const;
+};
+
+
+/**
+ * @brief Classe responsável pela escrita assíncrona das mensagens de log.
+ *
+ * Cada thread escreve suas mensagens em um LogRing próprio, sem disputar mutex com as
+ * demais. Uma thread escritora em segundo plano esvazia periodicamente todos os buffers,
+ * ordena as mensagens pelo instante em que foram geradas e escreve o lote de uma vez,
+ * com um único flush por lote. O nível de log é verificado antes de montar a mensagem
+ * (macro LOG_MESSAGE), de modo que mensagens desabilitadas não custam formatação.
+ */
+class Logger {
+private:
+    static std::atomic<int> level;                          ///< Nível de log atual.
+    std::atomic<int> format;                                ///< Formato de saída atual.
+    std::vector<std::shared_ptr<LogRing>> rings;            ///< Buffers de todas as threads que já geraram mensagens.
+    std::mutex rings_mutex;                                 ///< Mutex para proteger a lista de buffers (usado apenas no registro de novas threads).
+    std::atomic<uint64_t> rings_version;                    ///< Versão da lista de buffers, incrementada a cada registro.
+    std::mutex output_mutex;                                ///< Mutex para proteger a saída (thread escritora e flush final).
+    FILE* output;                                           ///< Destino das mensagens (stdout por padrão).
+    std::atomic<bool> running;                              ///< Indica que a thread escritora está ativa.
+    std::thread writer_thread;                              ///< Thread escritora em segundo plano.
+
+    /**
+     * @brief Construtor da classe Logger. Inicia a thread escritora.
+     */
+    Logger();
+
+
+    /**
+     * @brief Retorna o buffer da thread atual, registrando-o na primeira chamada.
+     *
+     * @return Referência ao buffer da thread atual.
+     */
+    LogRing& threadRing();
+
+
+    /**
+     * @brief Loop da thread escritora.
+     */
+    void writerLoop();
+
+
+    /**
+     * @brief Esvazia todos os buffers e escreve as mensagens no destino.
+     *
+     * @param rings_snapshot Cópia da lista de buffers a ser esvaziada.
+     * @return Número de mensagens escritas.
+     */
+    size_t drain(std::vector<std::shared_ptr<LogRing>>& rings_snapshot);
+
+
+    /**
+     * @brief Escreve uma mensagem no destino, de acordo com o formato atual.
+     *
+     * @param record Mensagem a ser escrita.
+     */
+    void write(const LogRecord& record);
+
+
+    /**
+     * @brief Escreve as mensagens pendentes e encerra a thread escritora. Chamado na saída do programa.
+     */
+    void shutdown();
+
+public:
+    /**
+     * @brief Retorna a instância única do Logger.
+     *
+     * A instância nunca é destruída, pois threads destacadas podem gerar mensagens até o
+     * fim do processo. As mensagens pendentes são escritas por flush() na saída do programa.
+     *
+     * @return Referência ao Logger.
+     */
+    static Logger& instance();
+
+
+    /**
+     * @brief Verifica se mensagens de um tipo estão habilitadas no nível atual.
+     *
+     * @param type Tipo da mensagem.
+     * @return true se a mensagem deve ser gerada.
+     */
+    static bool isEnabled(LogType type) {
+        return static_cast<int>(levelOf(type)) <= level.load(std::memory_order_relaxed);
+    }
+
+
+    /**
+     * @brief Retorna o nível de log mínimo em que um tipo de mensagem é exibido.
+     *
+     * @param type Tipo da mensagem.
+     * @return Nível de log do tipo.
+     */
+    static LogLevel levelOf(LogType type);
+
+
+    /**
+     * @brief Enfileira uma mensagem no buffer da thread atual.
+     *
+     * @param type Tipo da mensagem.
+     * @param message Texto da mensagem.
+     * @param banner Indica que a mensagem deve ser exibida em destaque.
+     */
+    void log(LogType type, std::string message, bool banner = false);
+
+
+    /**
+     * @brief Escreve imediatamente todas as mensagens pendentes.
+     */
+    void flush();
+
+
+    /**
+     * @brief Define o nível de log.
+     *
+     * @param new_level Novo nível de log.
+     */
+    void setLevel(LogLevel new_level);
+
+
+    /**
+     * @brief Define o formato de saída.
+     *
+     * @param new_format Novo formato de saída.
+     */
+    void setFormat(LogFormat new_format);
+
+
+    /**
+     * @brief Define o arquivo de destino das mensagens.
+     *
+     * @param path Caminho do arquivo (aberto em modo de acréscimo).
+     * @return true se o arquivo foi aberto, false caso contrário.
+     */
+    bool setOutputFile(const std::string& path);
+
+
+    /**
+     * @brief Converte o nome de um nível de log (error, info, debug, trace).
+     *
+     * @param name Nome do nível.
+     * @param parsed_level Nível convertido.
+     * @return true se o nome é válido.
+     */
+    static bool parseLevel(const std::string& name, LogLevel& parsed_level);
+
+
+    /**
+     * @brief Converte o nome de um formato de log (text, json, binary).
+     *
+     * @param name Nome do formato.
+     * @param parsed_format Formato convertido.
+     * @return true se o nome é válido.
+     */
+    static bool parseFormat(const std::string& name, LogFormat& parsed_format);
+
+
+    /**
+     * @brief Retorna o nome de um tipo de mensagem (ex: "DISCOVERY_SENT").
+     *
+     * @param type Tipo da mensagem.
+     * @return Nome do tipo.
+     */
+    static const char* typeName(LogType type);
+};
+
+#endif // LOGGER_H
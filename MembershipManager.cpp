@@ -0,0 +1,318 @@
+#include "MembershipManager.h"
+#include "Metrics.h"
+#include <algorithm>
+#include <iterator>
+#include <thread>
+
+
+/**
+ * @brief Construtor da classe MembershipManager.
+ */
+MembershipManager::MembershipManager(const std::string& ip, int port, int peer_id, UDPServer& udp_server, const TimingConfig& timing)
+    : ip(ip), port(port), peer_id(peer_id), udp_server(udp_server), timing(timing), bootstrap_port(0),
+      rng(static_cast<uint32_t>(peer_id) * 2654435761u + static_cast<uint32_t>(port)) {}
+
+
+/**
+ * @brief Define os vizinhos iniciais, lidos do topologia.txt.
+ */
+void MembershipManager::setInitialNeighbors(const std::vector<std::tuple<std::string, int>>& neighbors) {
+    std::lock_guard<std::mutex> lock(membership_mutex);
+
+    for (const auto& neighbor : neighbors) {
+        addNeighborLocked(neighbor, "topology");
+    }
+}
+
+
+/**
+ * @brief Define o peer de bootstrap usado para entrar na rede.
+ */
+void MembershipManager::setBootstrapPeer(const std::string& bootstrap_ip, int bootstrap_port) {
+    std::lock_guard<std::mutex> lock(membership_mutex);
+    this->bootstrap_ip = bootstrap_ip;
+    this->bootstrap_port = bootstrap_port;
+}
+
+
+/**
+ * @brief Loop principal do gerenciador de vizinhança.
+ */
+void MembershipManager::run() {
+    while (true) {
+        std::vector<std::tuple<std::string, int>> neighbors;
+        std::tuple<std::string, int> peers_source;
+        std::string peers_request;
+
+        {
+            std::lock_guard<std::mutex> lock(membership_mutex);
+            auto now = std::chrono::steady_clock::now();
+
+            // Remove os vizinhos dos quais nenhuma mensagem chegou dentro do prazo
+            for (auto it = last_seen.begin(); it != last_seen.end();) {
+                auto neighbor = it->first;
+                bool expired = now - it->second > timing.neighbor_timeout;
+                ++it; // Avança antes da remoção, que invalida o iterador do vizinho
+                if (expired) {
+                    removeNeighborLocked(neighbor, "timeout");
+                }
+            }
+
+            // Completa a vizinhança com candidatos sorteados; os que não responderem expiram pelo mesmo prazo
+            connectCandidatesLocked();
+
+            // Ainda abaixo do grau alvo: entra pelo bootstrap se estiver isolado ou pede endereços a um vizinho sorteado
+            if (last_seen.size() < static_cast<size_t>(Constants::MEMBERSHIP_TARGET_DEGREE)) {
+                if (last_seen.empty() && !bootstrap_ip.empty()) {
+                    peers_source = std::make_tuple(bootstrap_ip, bootstrap_port);
+                    peers_request = buildMembershipMessage("JOIN");
+                } else if (!last_seen.empty()) {
+                    peers_source = std::next(last_seen.begin(), rng() % last_seen.size())->first;
+                    peers_request = buildMembershipMessage("GET_PEERS");
+                }
+            }
+
+            for (const auto& entry : last_seen) {
+                neighbors.push_back(entry.first);
+            }
+        }
+
+        // Os envios são feitos fora do mutex para não atrasar o processamento das mensagens recebidas
+        std::string heartbeat = buildMembershipMessage("HEARTBEAT");
+        for (const auto& [neighbor_ip, neighbor_port] : neighbors) {
+            if (udp_server.sendUDPMessage(neighbor_ip, neighbor_port, heartbeat) < 0) {
+                perror("Erro ao enviar heartbeat");
+            }
+        }
+
+        if (!peers_request.empty()) {
+            const auto& [source_ip, source_port] = peers_source;
+            LOG_MESSAGE(LogType::OTHER, "Vizinhança abaixo do grau alvo (" + std::to_string(neighbors.size()) + "). Enviando " +
+                        peers_request + " para Peer " + source_ip + ":" + std::to_string(source_port));
+            udp_server.sendUDPMessage(source_ip, source_port, peers_request);
+        }
+
+        std::this_thread::sleep_for(timing.heartbeat_interval);
+    }
+}
+
+
+/**
+ * @brief Anuncia a saída do peer a todos os vizinhos com mensagens LEAVE.
+ */
+void MembershipManager::leave() {
+    std::string message = buildMembershipMessage("LEAVE");
+
+    for (const auto& [neighbor_ip, neighbor_port] : getNeighbors()) {
+        udp_server.sendUDPMessage(neighbor_ip, neighbor_port, message);
+    }
+
+    LOG_MESSAGE(LogType::INFO, "Saída da rede anunciada aos vizinhos.");
+}
+
+
+/**
+ * @brief Registra que uma mensagem de um vizinho foi recebida.
+ */
+void MembershipManager::markAlive(const PeerInfo& direct_sender_info) {
+    std::lock_guard<std::mutex> lock(membership_mutex);
+
+    auto it = last_seen.find(std::make_tuple(direct_sender_info.ip, direct_sender_info.port));
+    if (it != last_seen.end()) {
+        it->second = std::chrono::steady_clock::now();
+    }
+}
+
+
+/**
+ * @brief Processa uma mensagem do protocolo de vizinhança.
+ */
+void MembershipManager::processMembershipMessage(const MembershipMessage& message, const PeerInfo& direct_sender_info) {
+    if (message.type == MessageType::PEERS) {
+        std::vector<std::tuple<std::string, int>> new_neighbors;
+        {
+            // Guarda como candidatos os endereços que ainda não são vizinhos
+            std::lock_guard<std::mutex> lock(membership_mutex);
+            MessageTokenizer peers(message.peers);
+            std::string_view address, address_ip;
+            int address_port;
+            while (peers.next(address)) {
+                if (!MessageParser::parseAddress(address, address_ip, address_port)) {
+                    continue;
+                }
+                std::tuple<std::string, int> candidate(std::string(address_ip), address_port);
+                if (!isSelf(candidate) && !last_seen.count(candidate) && candidates.size() < Constants::MEMBERSHIP_MAX_CANDIDATES) {
+                    candidates.insert(candidate);
+                }
+            }
+
+            // Liga-se aos candidatos imediatamente, sem esperar o próximo heartbeat, para que um peer recém-chegado
+            // já tenha vizinhos na primeira rodada de descoberta
+            new_neighbors = connectCandidatesLocked();
+        }
+
+        std::string heartbeat = buildMembershipMessage("HEARTBEAT");
+        for (const auto& [neighbor_ip, neighbor_port] : new_neighbors) {
+            udp_server.sendUDPMessage(neighbor_ip, neighbor_port, heartbeat);
+        }
+        return;
+    }
+
+    // As demais mensagens trazem o endereço anunciado do remetente, já validado pelo MessageParser
+    std::tuple<std::string, int> sender(std::string(message.sender_ip), message.sender_port);
+    if (isSelf(sender)) {
+        return;
+    }
+
+    std::string reply;
+
+    if (message.type == MessageType::HEARTBEAT) {
+        std::lock_guard<std::mutex> lock(membership_mutex);
+
+        auto it = last_seen.find(sender);
+        if (it != last_seen.end()) {
+            it->second = std::chrono::steady_clock::now();
+        } else if (last_seen.size() < static_cast<size_t>(Constants::MEMBERSHIP_MAX_DEGREE)) {
+            // Um peer que nos considera vizinho é aceito enquanto houver vaga, mantendo os enlaces simétricos
+            candidates.erase(sender);
+            addNeighborLocked(sender, "heartbeat");
+        } else {
+            // Sem vaga: a recusa faz o remetente nos remover da sua vizinhança
+            reply = buildMembershipMessage("LEAVE");
+        }
+    } else if (message.type == MessageType::JOIN) {
+        bool accepted;
+        {
+            std::lock_guard<std::mutex> lock(membership_mutex);
+            accepted = last_seen.count(sender) ||
+                       (last_seen.size() < static_cast<size_t>(Constants::MEMBERSHIP_MAX_DEGREE) && addNeighborLocked(sender, "join"));
+        }
+
+        // O bootstrap só se inclui na amostra quando aceitou o novo peer como vizinho
+        reply = buildPeersMessage(sender, accepted);
+    } else if (message.type == MessageType::GET_PEERS) {
+        reply = buildPeersMessage(sender, false);
+    } else if (message.type == MessageType::LEAVE) {
+        std::lock_guard<std::mutex> lock(membership_mutex);
+        candidates.erase(sender);
+        removeNeighborLocked(sender, "leave");
+    }
+
+    if (!reply.empty()) {
+        udp_server.sendUDPMessage(std::get<0>(sender), std::get<1>(sender), reply);
+    }
+}
+
+
+/**
+ * @brief Retorna os vizinhos atuais.
+ */
+std::vector<std::tuple<std::string, int>> MembershipManager::getNeighbors() {
+    std::lock_guard<std::mutex> lock(membership_mutex);
+
+    std::vector<std::tuple<std::string, int>> neighbors;
+    for (const auto& entry : last_seen) {
+        neighbors.push_back(entry.first);
+    }
+    return neighbors;
+}
+
+
+/**
+ * @brief Monta uma mensagem de vizinhança com o endereço anunciado do peer.
+ */
+std::string MembershipManager::buildMembershipMessage(const std::string& command) const {
+    return command + " " + ip + ":" + std::to_string(port);
+}
+
+
+/**
+ * @brief Monta a mensagem PEERS com uma amostra dos vizinhos atuais.
+ */
+std::string MembershipManager::buildPeersMessage(const std::tuple<std::string, int>& excluded, bool include_self) {
+    std::lock_guard<std::mutex> lock(membership_mutex);
+
+    std::vector<std::tuple<std::string, int>> sample;
+    for (const auto& entry : last_seen) {
+        if (entry.first != excluded) {
+            sample.push_back(entry.first);
+        }
+    }
+
+    // Sorteia a amostra para que os pedidos de vários peers não se concentrem nos mesmos vizinhos
+    std::shuffle(sample.begin(), sample.end(), rng);
+    if (sample.size() > static_cast<size_t>(Constants::MEMBERSHIP_PEERS_SAMPLE)) {
+        sample.resize(Constants::MEMBERSHIP_PEERS_SAMPLE);
+    }
+
+    std::string message = "PEERS";
+    if (include_self) {
+        message += " " + ip + ":" + std::to_string(port);
+    }
+    for (const auto& [neighbor_ip, neighbor_port] : sample) {
+        message += " " + neighbor_ip + ":" + std::to_string(neighbor_port);
+    }
+    return message;
+}
+
+
+/**
+ * @brief Liga o peer a candidatos sorteados até atingir o grau alvo.
+ */
+std::vector<std::tuple<std::string, int>> MembershipManager::connectCandidatesLocked() {
+    std::vector<std::tuple<std::string, int>> new_neighbors;
+
+    while (last_seen.size() < static_cast<size_t>(Constants::MEMBERSHIP_TARGET_DEGREE) && !candidates.empty()) {
+        auto it = std::next(candidates.begin(), rng() % candidates.size());
+        auto candidate = *it;
+        candidates.erase(it);
+        if (addNeighborLocked(candidate, "candidate")) {
+            new_neighbors.push_back(candidate);
+        }
+    }
+    return new_neighbors;
+}
+
+
+/**
+ * @brief Adiciona um vizinho à vizinhança e à lista de envio.
+ */
+bool MembershipManager::addNeighborLocked(const std::tuple<std::string, int>& neighbor, const std::string& origin) {
+    if (isSelf(neighbor) || !last_seen.emplace(neighbor, std::chrono::steady_clock::now()).second) {
+        return false;
+    }
+
+    const auto& [neighbor_ip, neighbor_port] = neighbor;
+    udp_server.addUDPNeighbor(neighbor_ip, neighbor_port);
+
+    Metrics::instance().add(Counter::NEIGHBORS_ADDED, "local=" + std::to_string(peer_id) + ",origin=" + origin);
+    LOG_MESSAGE(LogType::INFO, "Vizinho " + neighbor_ip + ":" + std::to_string(neighbor_port) + " adicionado (" + origin +
+                "). Vizinhos: " + std::to_string(last_seen.size()));
+    return true;
+}
+
+
+/**
+ * @brief Remove um vizinho da vizinhança e da lista de envio.
+ */
+bool MembershipManager::removeNeighborLocked(const std::tuple<std::string, int>& neighbor, const std::string& reason) {
+    if (last_seen.erase(neighbor) == 0) {
+        return false;
+    }
+
+    const auto& [neighbor_ip, neighbor_port] = neighbor;
+    udp_server.removeUDPNeighbor(neighbor_ip, neighbor_port);
+
+    Metrics::instance().add(Counter::NEIGHBORS_REMOVED, "local=" + std::to_string(peer_id) + ",reason=" + reason);
+    LOG_MESSAGE(LogType::INFO, "Vizinho " + neighbor_ip + ":" + std::to_string(neighbor_port) + " removido (" + reason +
+                "). Vizinhos: " + std::to_string(last_seen.size()));
+    return true;
+}
+
+
+/**
+ * @brief Verifica se um endereço é o do próprio peer.
+ */
+bool MembershipManager::isSelf(const std::tuple<std::string, int>& peer) const {
+    return std::get<0>(peer) == ip && std::get<1>(peer) == port;
+}
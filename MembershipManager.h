@@ -0,0 +1,185 @@
+#ifndef MEMBERSHIPMANAGER_H
+#define MEMBERSHIPMANAGER_H
+
+#include "MessageParser.h"
+#include "UDPServer.h"
+#include "Utils.h"
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <random>
+#include <set>
+#include <sstream>
+#include <string>
+#include <tuple>
+#include <vector>
+
+
+/**
+ * @brief Classe responsável por manter a vizinhança do peer em tempo de execução.
+ *
+ * Os vizinhos iniciais vêm do topologia.txt, mas a lista deixa de ser estática: cada vizinho
+ * recebe um HEARTBEAT a cada heartbeat_interval e é removido da lista de envio do UDPServer
+ * quando nenhuma mensagem dele chega por neighbor_timeout. Quando o peer está abaixo de
+ * Constants::MEMBERSHIP_TARGET_DEGREE vizinhos, ele pede novos endereços a um vizinho ou ao
+ * peer de bootstrap e se liga aos candidatos recebidos. As mensagens trocadas são:
+ *
+ *  - HEARTBEAT <ip:porta>: mantém o enlace vivo; um peer desconhecido é aceito como vizinho se houver vaga.
+ *  - JOIN <ip:porta>: entrada na rede pelo peer de bootstrap, que responde com PEERS e aceita o novo peer se houver vaga.
+ *  - GET_PEERS <ip:porta>: pede endereços de outros peers para completar a vizinhança.
+ *  - PEERS <ip:porta> <ip:porta> ...: amostra dos vizinhos de quem responde (precedida do próprio endereço quando um JOIN é aceito).
+ *  - LEAVE <ip:porta>: saída da rede ou recusa de um pedido de vizinhança; o remetente é removido.
+ *
+ * Os endereços nas mensagens são o IP e a porta UDP anunciados pelo remetente, os mesmos
+ * usados na lista de vizinhos.
+ */
+class MembershipManager {
+private:
+    const std::string ip;                                                           ///< Endereço IP do peer atual.
+    const int port;                                                                 ///< Porta UDP do peer atual.
+    const int peer_id;                                                              ///< Identificador único (ID) do peer.
+    UDPServer& udp_server;                                                          ///< Referência ao servidor UDP, que envia as mensagens e guarda a lista de envio.
+    const TimingConfig timing;                                                      ///< Tempos de espera do protocolo.
+    std::map<std::tuple<std::string, int>, std::chrono::steady_clock::time_point> last_seen;   ///< Vizinhos atuais e o instante da última mensagem recebida de cada um.
+    std::set<std::tuple<std::string, int>> candidates;                              ///< Peers conhecidos pelas mensagens PEERS que ainda não são vizinhos.
+    std::string bootstrap_ip;                                                       ///< Endereço IP do peer de bootstrap (vazio: sem bootstrap).
+    int bootstrap_port;                                                             ///< Porta UDP do peer de bootstrap.
+    std::mt19937 rng;                                                               ///< Gerador usado para sortear o vizinho consultado e a amostra enviada em PEERS.
+    std::mutex membership_mutex;                                                    ///< Mutex para proteger a vizinhança, os candidatos e o gerador.
+
+public:
+    /**
+     * @brief Construtor da classe MembershipManager.
+     *
+     * @param ip Endereço IP do peer.
+     * @param port Porta UDP do peer.
+     * @param peer_id ID do peer.
+     * @param udp_server Referência ao servidor UDP do peer.
+     * @param timing Tempos de espera do protocolo (padrão: valores de Constants.h).
+     */
+    MembershipManager(const std::string& ip, int port, int peer_id, UDPServer& udp_server,
+                      const TimingConfig& timing = TimingConfig());
+
+
+    /**
+     * @brief Define os vizinhos iniciais, lidos do topologia.txt.
+     *
+     * Os vizinhos são adicionados à lista de envio do UDPServer e passam a ser monitorados
+     * como qualquer outro vizinho.
+     *
+     * @param neighbors Vizinhos do peer (IP e Porta UDP).
+     */
+    void setInitialNeighbors(const std::vector<std::tuple<std::string, int>>& neighbors);
+
+
+    /**
+     * @brief Define o peer de bootstrap usado para entrar na rede.
+     *
+     * @param bootstrap_ip Endereço IP do peer de bootstrap.
+     * @param bootstrap_port Porta UDP do peer de bootstrap.
+     */
+    void setBootstrapPeer(const std::string& bootstrap_ip, int bootstrap_port);
+
+
+    /**
+     * @brief Loop principal do gerenciador de vizinhança.
+     *
+     * A cada heartbeat_interval remove os vizinhos sem mensagens recentes, completa a vizinhança
+     * até o grau alvo e envia os heartbeats. Deve ser chamado depois de o socket UDP estar aberto.
+     */
+    void run();
+
+
+    /**
+     * @brief Anuncia a saída do peer a todos os vizinhos com mensagens LEAVE.
+     */
+    void leave();
+
+
+    /**
+     * @brief Registra que uma mensagem de um vizinho foi recebida.
+     *
+     * Remetentes que não são vizinhos são ignorados.
+     *
+     * @param direct_sender_info Informações sobre o peer que enviou diretamente a mensagem (IP e porta UDP).
+     */
+    void markAlive(const PeerInfo& direct_sender_info);
+
+
+    /**
+     * @brief Processa uma mensagem do protocolo de vizinhança.
+     *
+     * @param message Campos da mensagem, lidos pelo MessageParser.
+     * @param direct_sender_info Informações sobre o peer que enviou diretamente a mensagem (IP e porta UDP).
+     */
+    void processMembershipMessage(const MembershipMessage& message, const PeerInfo& direct_sender_info);
+
+
+    /**
+     * @brief Retorna os vizinhos atuais.
+     *
+     * @return Vizinhos do peer (IP e Porta UDP).
+     */
+    std::vector<std::tuple<std::string, int>> getNeighbors();
+
+
+    /**
+     * @brief Monta uma mensagem de vizinhança com o endereço anunciado do peer.
+     *
+     * @param command Comando da mensagem (HEARTBEAT, JOIN, GET_PEERS ou LEAVE).
+     * @return String contendo a mensagem formatada (ex: "HEARTBEAT 127.0.0.1:6000").
+     */
+    std::string buildMembershipMessage(const std::string& command) const;
+
+
+    /**
+     * @brief Monta a mensagem PEERS com uma amostra dos vizinhos atuais.
+     *
+     * @param excluded Peer que não deve constar na amostra (normalmente quem pediu a lista).
+     * @param include_self Indica se o endereço do próprio peer abre a lista (resposta a um JOIN aceito).
+     * @return String contendo a mensagem PEERS formatada.
+     */
+    std::string buildPeersMessage(const std::tuple<std::string, int>& excluded, bool include_self);
+
+private:
+    /**
+     * @brief Liga o peer a candidatos sorteados até atingir o grau alvo. Deve ser chamado com membership_mutex travado.
+     *
+     * Os candidatos escolhidos entram na vizinhança à espera da confirmação por heartbeat; os que
+     * não responderem expiram por neighbor_timeout e os que estiverem cheios respondem com LEAVE.
+     *
+     * @return Vizinhos adicionados, que devem receber um HEARTBEAT.
+     */
+    std::vector<std::tuple<std::string, int>> connectCandidatesLocked();
+
+
+    /**
+     * @brief Adiciona um vizinho à vizinhança e à lista de envio. Deve ser chamado com membership_mutex travado.
+     *
+     * @param neighbor IP e porta UDP do vizinho.
+     * @param origin Origem do vizinho, usada no log e nas métricas (ex: "heartbeat", "join").
+     * @return true se o vizinho foi adicionado.
+     */
+    bool addNeighborLocked(const std::tuple<std::string, int>& neighbor, const std::string& origin);
+
+
+    /**
+     * @brief Remove um vizinho da vizinhança e da lista de envio. Deve ser chamado com membership_mutex travado.
+     *
+     * @param neighbor IP e porta UDP do vizinho.
+     * @param reason Motivo da remoção, usado no log e nas métricas (ex: "timeout", "leave").
+     * @return true se o vizinho estava na vizinhança.
+     */
+    bool removeNeighborLocked(const std::tuple<std::string, int>& neighbor, const std::string& reason);
+
+
+    /**
+     * @brief Verifica se um endereço é o do próprio peer.
+     *
+     * @param peer IP e porta UDP.
+     * @return true se o endereço é o do peer atual.
+     */
+    bool isSelf(const std::tuple<std::string, int>& peer) const;
+};
+
+#endif // MEMBERSHIPMANAGER_H
@@ -0,0 +1,294 @@
+#include "MessageParser.h"
+#include <utility>
+
+
+namespace {
+    // Comandos do protocolo, com os mais frequentes primeiro
+    const std::pair<std::string_view, MessageType> COMMANDS[] = {
+        {"DISCOVERY", MessageType::DISCOVERY},
+        {"RESPONSE", MessageType::RESPONSE},
+        {"REQUEST", MessageType::REQUEST},
+        {"HEARTBEAT", MessageType::HEARTBEAT},
+        {"HAVE", MessageType::HAVE},
+        {"AGGREGATE", MessageType::AGGREGATE},
+        {"JOIN", MessageType::JOIN},
+        {"GET_PEERS", MessageType::GET_PEERS},
+        {"PEERS", MessageType::PEERS},
+        {"LEAVE", MessageType::LEAVE},
+        {"DHT_FIND_NODE", MessageType::DHT_FIND_NODE},
+        {"DHT_FIND_VALUE", MessageType::DHT_FIND_VALUE},
+        {"DHT_NODES", MessageType::DHT_NODES},
+        {"DHT_VALUE", MessageType::DHT_VALUE},
+        {"DHT_STORE", MessageType::DHT_STORE},
+    };
+
+    // Prefixo da lista de formatos de compressão de uma mensagem REQUEST
+    const std::string_view CODECS_PREFIX = "codecs=";
+
+    // Prefixo das faixas dos chunks retomados de uma mensagem REQUEST
+    const std::string_view RANGES_PREFIX = "ranges=";
+}
+
+
+/**
+ * @brief Lê a próxima palavra.
+ */
+bool MessageTokenizer::next(std::string_view& token) {
+    while (position < text.size() && isSeparator(text[position])) {
+        ++position;
+    }
+    if (position >= text.size()) {
+        return false;
+    }
+
+    size_t start = position;
+    while (position < text.size() && !isSeparator(text[position])) {
+        ++position;
+    }
+    token = text.substr(start, position - start);
+    return true;
+}
+
+
+/**
+ * @brief Lê a próxima palavra como um endereço "ip:porta".
+ */
+bool MessageTokenizer::nextAddress(std::string_view& address_ip, int& address_port) {
+    size_t saved_position = position;
+    std::string_view address;
+    if (!next(address) || !MessageParser::parseAddress(address, address_ip, address_port)) {
+        position = saved_position;
+        return false;
+    }
+    return true;
+}
+
+
+/**
+ * @brief Retorna o texto ainda não lido, sem os separadores iniciais.
+ */
+std::string_view MessageTokenizer::rest() const {
+    size_t start = position;
+    while (start < text.size() && isSeparator(text[start])) {
+        ++start;
+    }
+    return text.substr(start);
+}
+
+
+/**
+ * @brief Retorna o número de chunks da lista.
+ */
+size_t ChunkList::size() const {
+    size_t count = 0;
+    for (auto it = begin(); it != end(); ++it) {
+        ++count;
+    }
+    return count;
+}
+
+
+/**
+ * @brief Identifica o comando de uma mensagem.
+ */
+MessageType MessageParser::parseType(std::string_view command) {
+    for (const auto& [name, type] : COMMANDS) {
+        if (command == name) {
+            return type;
+        }
+    }
+    return MessageType::UNKNOWN;
+}
+
+
+/**
+ * @brief Indica se um tipo pertence ao protocolo de vizinhança.
+ */
+bool MessageParser::isMembershipType(MessageType type) {
+    return type == MessageType::HEARTBEAT || type == MessageType::JOIN || type == MessageType::GET_PEERS ||
+           type == MessageType::PEERS || type == MessageType::LEAVE;
+}
+
+
+/**
+ * @brief Indica se um tipo pertence ao protocolo da DHT.
+ */
+bool MessageParser::isDHTType(MessageType type) {
+    return type == MessageType::DHT_FIND_NODE || type == MessageType::DHT_FIND_VALUE || type == MessageType::DHT_NODES ||
+           type == MessageType::DHT_VALUE || type == MessageType::DHT_STORE;
+}
+
+
+/**
+ * @brief Separa um endereço "ip:porta".
+ */
+bool MessageParser::parseAddress(std::string_view address, std::string_view& address_ip, int& address_port) {
+    size_t colon_pos = address.find(':');
+    if (colon_pos == std::string_view::npos || colon_pos == 0) {
+        return false;
+    }
+
+    MessageTokenizer port_token(address.substr(colon_pos + 1));
+    int parsed_port = 0;
+    if (!port_token.nextNumber(parsed_port) || parsed_port <= 0) {
+        return false;
+    }
+
+    address_ip = address.substr(0, colon_pos);
+    address_port = parsed_port;
+    return true;
+}
+
+
+/**
+ * @brief Lê os campos de uma mensagem DISCOVERY.
+ */
+bool MessageParser::parseDiscovery(MessageTokenizer& message, DiscoveryMessage& discovery) {
+    if (!message.next(discovery.file_name) || !message.nextNumber(discovery.total_chunks) || !message.nextNumber(discovery.ttl) ||
+        !message.nextAddress(discovery.requester_ip, discovery.requester_port)) {
+        return false;
+    }
+
+    // O identificador de busca e a janela só existem nas buscas agregadas
+    if (!message.nextNumber(discovery.search_id) || !message.nextNumber(discovery.window_ms)) {
+        discovery.search_id = 0;
+        discovery.window_ms = 0;
+    }
+    return true;
+}
+
+
+/**
+ * @brief Lê os campos de uma mensagem RESPONSE.
+ */
+bool MessageParser::parseResponse(MessageTokenizer& message, ResponseMessage& response) {
+    if (!message.next(response.file_name) || !message.nextNumber(response.transfer_speed)) {
+        return false;
+    }
+    response.chunks = ChunkList(message.rest());
+    return true;
+}
+
+
+/**
+ * @brief Lê os campos de uma mensagem REQUEST.
+ */
+bool MessageParser::parseRequest(MessageTokenizer& message, RequestMessage& request) {
+    if (!message.next(request.file_name) || !message.nextNumber(request.tcp_port)) {
+        return false;
+    }
+    std::string_view rest = message.rest();
+    request.chunks = ChunkList(rest);
+
+    // Os formatos de compressão vêm após os chunks ("codecs=lz4,zstd"), onde os peers antigos encerram a lista
+    size_t codecs_position = rest.find(CODECS_PREFIX);
+    if (codecs_position != std::string_view::npos) {
+        MessageTokenizer codecs(rest.substr(codecs_position + CODECS_PREFIX.size()));
+        codecs.next(request.codecs);
+    }
+
+    // As faixas dos chunks interrompidos ("ranges=3:1048576"), ignoradas pelos peers que enviam sempre o chunk inteiro
+    size_t ranges_position = rest.find(RANGES_PREFIX);
+    if (ranges_position != std::string_view::npos) {
+        MessageTokenizer ranges(rest.substr(ranges_position + RANGES_PREFIX.size()));
+        ranges.next(request.ranges);
+    }
+    return true;
+}
+
+
+/**
+ * @brief Lê as faixas de uma mensagem REQUEST.
+ */
+std::map<int, size_t> MessageParser::parseRanges(std::string_view ranges) {
+    std::map<int, size_t> offsets;
+    MessageTokenizer list(ranges, ',');
+    std::string_view range;
+    while (list.next(range)) {
+        MessageTokenizer fields(range, ':');
+        int chunk = 0;
+        size_t offset = 0;
+        if (fields.nextNumber(chunk) && fields.nextNumber(offset) && chunk >= 0 && offset > 0) {
+            offsets[chunk] = offset;
+        }
+    }
+    return offsets;
+}
+
+
+/**
+ * @brief Lê os campos de uma mensagem HAVE.
+ */
+bool MessageParser::parseHave(MessageTokenizer& message, HaveMessage& have) {
+    if (!message.next(have.file_name) || !message.nextNumber(have.transfer_speed)) {
+        return false;
+    }
+    have.chunks = ChunkList(message.rest());
+    return true;
+}
+
+
+/**
+ * @brief Lê os campos de uma mensagem AGGREGATE.
+ */
+bool MessageParser::parseAggregate(std::string_view text, MessageTokenizer& message, AggregateMessage& aggregate) {
+    if (!message.next(aggregate.file_name) || !message.nextNumber(aggregate.search_id)) {
+        return false;
+    }
+    aggregate.text = text;
+    aggregate.holders = message.rest();
+    return true;
+}
+
+
+/**
+ * @brief Lê os campos de uma mensagem do protocolo de vizinhança.
+ */
+bool MessageParser::parseMembership(MessageType type, MessageTokenizer& message, MembershipMessage& membership) {
+    membership.type = type;
+
+    // PEERS traz a lista de endereços, que é filtrada pelo MembershipManager
+    if (type == MessageType::PEERS) {
+        membership.peers = message.rest();
+        return true;
+    }
+
+    // As demais mensagens trazem o endereço anunciado do remetente
+    return message.nextAddress(membership.sender_ip, membership.sender_port);
+}
+
+
+/**
+ * @brief Lê os campos fixos de uma mensagem da DHT.
+ */
+bool MessageParser::parseDHT(MessageType type, MessageTokenizer& message, DHTMessage& dht) {
+    dht.type = type;
+
+    switch (type) {
+        case MessageType::DHT_NODES:
+            if (!message.nextNumber(dht.lookup_id)) {
+                return false;
+            }
+            break;
+        case MessageType::DHT_VALUE:
+            if (!message.nextNumber(dht.lookup_id) || !message.nextNumber(dht.record_count)) {
+                return false;
+            }
+            break;
+        case MessageType::DHT_STORE:
+            if (!message.nextNumber(dht.key, 16)) {
+                return false;
+            }
+            break;
+        case MessageType::DHT_FIND_NODE:
+        case MessageType::DHT_FIND_VALUE:
+            // A busca, o alvo e o endereço anunciado de quem consulta
+            return message.nextNumber(dht.lookup_id) && message.nextNumber(dht.key, 16) &&
+                   message.nextAddress(dht.sender_ip, dht.sender_port);
+        default:
+            return false;
+    }
+
+    dht.body = message.rest();
+    return true;
+}
@@ -0,0 +1,375 @@
+#ifndef MESSAGEPARSER_H
+#define MESSAGEPARSER_H
+
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <map>
+#include <string_view>
+
+
+/**
+ * @brief Enumeração dos comandos das mensagens UDP, identificados pela primeira palavra.
+ */
+enum class MessageType {
+    DISCOVERY,
+    RESPONSE,
+    REQUEST,
+    AGGREGATE,
+    HAVE,
+    HEARTBEAT,
+    JOIN,
+    GET_PEERS,
+    PEERS,
+    LEAVE,
+    DHT_FIND_NODE,
+    DHT_FIND_VALUE,
+    DHT_NODES,
+    DHT_VALUE,
+    DHT_STORE,
+    UNKNOWN
+};
+
+
+/**
+ * @brief Classe que separa as palavras de uma mensagem sem copiá-las.
+ *
+ * As palavras são std::string_view que apontam para o texto original, então só valem enquanto
+ * o buffer da mensagem existir. Os números são convertidos com std::from_chars, sem locale e sem
+ * alocação; uma palavra que não é um número inteiro válido não é consumida.
+ */
+class MessageTokenizer {
+private:
+    std::string_view text;                                  ///< Texto da mensagem.
+    size_t position;                                        ///< Posição da próxima palavra.
+    char separator;                                         ///< Separador das palavras (' ' também aceita tabulações e quebras de linha).
+
+    /**
+     * @brief Indica se um caractere separa as palavras.
+     */
+    bool isSeparator(char c) const {
+        return separator == ' ' ? (c == ' ' || c == '\t' || c == '\n' || c == '\r') : c == separator;
+    }
+
+public:
+    /**
+     * @brief Construtor da classe MessageTokenizer.
+     *
+     * @param text Texto da mensagem (não é copiado).
+     * @param separator Separador das palavras (ex: ',' para as listas de chunks da DHT).
+     */
+    explicit MessageTokenizer(std::string_view text, char separator = ' ') : text(text), position(0), separator(separator) {}
+
+
+    /**
+     * @brief Lê a próxima palavra.
+     *
+     * @param token Recebe a palavra, apontando para o texto da mensagem.
+     * @return true se havia uma palavra.
+     */
+    bool next(std::string_view& token);
+
+
+    /**
+     * @brief Lê a próxima palavra como um número inteiro.
+     *
+     * @param value Recebe o número.
+     * @param base Base do número (16 para os IDs da DHT).
+     * @return true se a palavra é um número válido; caso contrário, ela não é consumida.
+     */
+    template <typename Integer>
+    bool nextNumber(Integer& value, int base = 10);
+
+
+    /**
+     * @brief Lê a próxima palavra como um endereço "ip:porta".
+     *
+     * @param address_ip Recebe o IP, apontando para o texto da mensagem.
+     * @param address_port Recebe a porta.
+     * @return true se a palavra é um endereço válido; caso contrário, ela não é consumida.
+     */
+    bool nextAddress(std::string_view& address_ip, int& address_port);
+
+
+    /**
+     * @brief Retorna o texto ainda não lido, sem os separadores iniciais.
+     */
+    std::string_view rest() const;
+};
+
+
+/**
+ * @brief Classe que percorre uma lista de chunks de uma mensagem sem copiá-la.
+ *
+ * A lista termina na primeira palavra que não é um número, como a leitura com operator>> fazia.
+ */
+class ChunkList {
+private:
+    std::string_view text;                                  ///< Texto da lista.
+    char separator;                                         ///< Separador dos chunks.
+
+public:
+    /**
+     * @brief Iterador de entrada sobre os chunks da lista.
+     */
+    class Iterator {
+    private:
+        MessageTokenizer tokenizer;                         ///< Palavras ainda não lidas.
+        int chunk;                                          ///< Chunk atual.
+        bool valid;                                         ///< Indica se o iterador aponta para um chunk (false: fim).
+
+    public:
+        using iterator_category = std::input_iterator_tag;
+        using value_type = int;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const int*;
+        using reference = const int&;
+
+        /**
+         * @brief Construtor do iterador de fim.
+         */
+        Iterator() : tokenizer(std::string_view()), chunk(0), valid(false) {}
+
+        /**
+         * @brief Construtor do iterador de início, que já lê o primeiro chunk.
+         */
+        Iterator(std::string_view text, char separator) : tokenizer(text, separator), chunk(0), valid(true) { ++*this; }
+
+        const int& operator*() const { return chunk; }
+        Iterator& operator++() { valid = tokenizer.nextNumber(chunk); return *this; }
+        // Como em todo iterador de entrada, só a comparação com o fim é significativa
+        bool operator==(const Iterator& other) const { return valid == other.valid; }
+        bool operator!=(const Iterator& other) const { return !(*this == other); }
+    };
+
+    /**
+     * @brief Construtor da classe ChunkList.
+     *
+     * @param text Texto da lista (não é copiado).
+     * @param separator Separador dos chunks.
+     */
+    explicit ChunkList(std::string_view text = std::string_view(), char separator = ' ') : text(text), separator(separator) {}
+
+    Iterator begin() const { return Iterator(text, separator); }
+    Iterator end() const { return Iterator(); }
+
+    /**
+     * @brief Indica se a lista não tem nenhum chunk.
+     */
+    bool empty() const { return begin() == end(); }
+
+    /**
+     * @brief Retorna o número de chunks da lista.
+     */
+    size_t size() const;
+};
+
+
+/**
+ * @brief Estrutura com os campos de uma mensagem DISCOVERY.
+ */
+struct DiscoveryMessage {
+    std::string_view file_name;                             ///< Nome do arquivo buscado.
+    int total_chunks = 0;                                   ///< Número total de chunks do arquivo.
+    int ttl = 0;                                            ///< Saltos restantes.
+    std::string_view requester_ip;                          ///< IP do peer que iniciou a busca.
+    int requester_port = 0;                                 ///< Porta UDP do peer que iniciou a busca.
+    uint64_t search_id = 0;                                 ///< Identificador da busca agregada (0: busca por inundação).
+    int64_t window_ms = 0;                                  ///< Janela de agregação em milissegundos.
+};
+
+
+/**
+ * @brief Estrutura com os campos de uma mensagem RESPONSE.
+ */
+struct ResponseMessage {
+    std::string_view file_name;                             ///< Nome do arquivo.
+    int transfer_speed = 0;                                 ///< Velocidade de envio do peer que respondeu.
+    ChunkList chunks;                                       ///< Chunks que o peer possui.
+};
+
+
+/**
+ * @brief Estrutura com os campos de uma mensagem REQUEST.
+ */
+struct RequestMessage {
+    std::string_view file_name;                             ///< Nome do arquivo.
+    int tcp_port = 0;                                       ///< Porta TCP que recebe os chunks.
+    ChunkList chunks;                                       ///< Chunks pedidos.
+    std::string_view codecs;                                ///< Formatos de compressão que o solicitante descomprime ("lz4,zstd"; vazio: nenhum).
+    std::string_view ranges;                                ///< Bytes já recebidos dos chunks interrompidos ("3:1048576,7:262144"; vazio: chunks inteiros).
+};
+
+
+/**
+ * @brief Estrutura com os campos de uma mensagem HAVE.
+ */
+struct HaveMessage {
+    std::string_view file_name;                             ///< Nome do arquivo.
+    int transfer_speed = 0;                                 ///< Velocidade de envio do anunciante.
+    ChunkList chunks;                                       ///< Chunks salvos desde o último anúncio.
+};
+
+
+/**
+ * @brief Estrutura com os campos de uma mensagem AGGREGATE.
+ */
+struct AggregateMessage {
+    std::string_view text;                                  ///< Mensagem completa, repassada ao peer anterior sem ser remontada.
+    std::string_view file_name;                             ///< Nome do arquivo.
+    uint64_t search_id = 0;                                 ///< Identificador da busca.
+    std::string_view holders;                               ///< Detentores no formato "ip:porta velocidade bitmap ...".
+};
+
+
+/**
+ * @brief Estrutura com os campos de uma mensagem do protocolo de vizinhança.
+ */
+struct MembershipMessage {
+    MessageType type = MessageType::UNKNOWN;                ///< HEARTBEAT, JOIN, GET_PEERS, PEERS ou LEAVE.
+    std::string_view sender_ip;                             ///< IP anunciado do remetente (exceto PEERS).
+    int sender_port = 0;                                    ///< Porta UDP anunciada do remetente (exceto PEERS).
+    std::string_view peers;                                 ///< Endereços "ip:porta" da mensagem PEERS.
+};
+
+
+/**
+ * @brief Estrutura com os campos de uma mensagem da DHT.
+ */
+struct DHTMessage {
+    MessageType type = MessageType::UNKNOWN;                ///< DHT_FIND_NODE, DHT_FIND_VALUE, DHT_NODES, DHT_VALUE ou DHT_STORE.
+    uint64_t lookup_id = 0;                                 ///< Identificador da busca (exceto DHT_STORE).
+    uint64_t key = 0;                                       ///< Alvo da consulta (DHT_FIND_*) ou chave do registro (DHT_STORE).
+    std::string_view sender_ip;                             ///< IP anunciado de quem consulta (DHT_FIND_*).
+    int sender_port = 0;                                    ///< Porta UDP anunciada de quem consulta (DHT_FIND_*).
+    int record_count = 0;                                   ///< Número de registros (DHT_VALUE).
+    std::string_view body;                                  ///< Registros e contatos (DHT_NODES, DHT_VALUE) ou o registro (DHT_STORE).
+};
+
+
+/**
+ * @brief Classe com as funções que interpretam as mensagens UDP recebidas.
+ *
+ * Cada função preenche a estrutura da mensagem a partir do texto após o comando, sem cópias nem
+ * alocações; as estruturas apontam para o buffer do datagrama e só valem enquanto ele existir.
+ */
+class MessageParser {
+public:
+    /**
+     * @brief Identifica o comando de uma mensagem.
+     *
+     * @param command Primeira palavra da mensagem.
+     * @return Tipo da mensagem (UNKNOWN para comandos desconhecidos).
+     */
+    static MessageType parseType(std::string_view command);
+
+
+    /**
+     * @brief Indica se um tipo pertence ao protocolo de vizinhança.
+     */
+    static bool isMembershipType(MessageType type);
+
+
+    /**
+     * @brief Indica se um tipo pertence ao protocolo da DHT.
+     */
+    static bool isDHTType(MessageType type);
+
+
+    /**
+     * @brief Separa um endereço "ip:porta".
+     *
+     * @param address Endereço no formato "ip:porta".
+     * @param address_ip Recebe o IP, apontando para o texto do endereço.
+     * @param address_port Recebe a porta.
+     * @return true se o endereço tem IP e porta positiva.
+     */
+    static bool parseAddress(std::string_view address, std::string_view& address_ip, int& address_port);
+
+
+    /**
+     * @brief Lê os campos de uma mensagem DISCOVERY (o identificador de busca e a janela são opcionais).
+     *
+     * @param message Palavras após o comando.
+     * @param discovery Estrutura que recebe os campos.
+     * @return true se a mensagem é válida.
+     */
+    static bool parseDiscovery(MessageTokenizer& message, DiscoveryMessage& discovery);
+
+
+    /**
+     * @brief Lê os campos de uma mensagem RESPONSE.
+     */
+    static bool parseResponse(MessageTokenizer& message, ResponseMessage& response);
+
+
+    /**
+     * @brief Lê os campos de uma mensagem REQUEST.
+     */
+    static bool parseRequest(MessageTokenizer& message, RequestMessage& request);
+
+
+    /**
+     * @brief Lê as faixas de uma mensagem REQUEST ("chunk:bytes" separados por vírgula).
+     *
+     * @param ranges Texto das faixas; as inválidas são ignoradas.
+     * @return Byte inicial de cada chunk pedido a partir do meio.
+     */
+    static std::map<int, size_t> parseRanges(std::string_view ranges);
+
+
+    /**
+     * @brief Lê os campos de uma mensagem HAVE.
+     */
+    static bool parseHave(MessageTokenizer& message, HaveMessage& have);
+
+
+    /**
+     * @brief Lê os campos de uma mensagem AGGREGATE.
+     *
+     * @param text Mensagem completa, guardada para o repasse.
+     * @param message Palavras após o comando.
+     * @param aggregate Estrutura que recebe os campos.
+     * @return true se o cabeçalho é válido (os detentores são lidos pelo ResponseAggregator).
+     */
+    static bool parseAggregate(std::string_view text, MessageTokenizer& message, AggregateMessage& aggregate);
+
+
+    /**
+     * @brief Lê os campos de uma mensagem do protocolo de vizinhança.
+     */
+    static bool parseMembership(MessageType type, MessageTokenizer& message, MembershipMessage& membership);
+
+
+    /**
+     * @brief Lê os campos fixos de uma mensagem da DHT (os registros e contatos são lidos pelo DHTNode).
+     */
+    static bool parseDHT(MessageType type, MessageTokenizer& message, DHTMessage& dht);
+};
+
+
+/**
+ * @brief Lê a próxima palavra como um número inteiro.
+ */
+template <typename Integer>
+bool MessageTokenizer::nextNumber(Integer& value, int base) {
+    size_t saved_position = position;
+    std::string_view token;
+    if (!next(token)) {
+        return false;
+    }
+
+    // A palavra inteira precisa ser o número: "12abc" não é aceita
+    Integer parsed;
+    auto [end, error] = std::from_chars(token.data(), token.data() + token.size(), parsed, base);
+    if (error != std::errc() || end != token.data() + token.size()) {
+        position = saved_position;
+        return false;
+    }
+
+    value = parsed;
+    return true;
+}
+
+#endif // MESSAGEPARSER_H
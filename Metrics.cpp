@@ -0,0 +1,457 @@
+#include "Metrics.h"
+#include "Constants.h"
+#include <cstdio>
+#include <sstream>
+#include <thread>
+
+
+namespace {
+    /**
+     * @brief Estrutura que guarda o fragmento de métricas da thread atual e o incorpora ao acumulado quando a thread termina.
+     */
+    struct ThreadShardHolder {
+        std::shared_ptr<Metrics::Shard> shard;  ///< Fragmento da thread.
+
+        ~ThreadShardHolder() {
+            if (shard) {
+                Metrics::instance().retireShard(shard);
+            }
+        }
+    };
+
+    thread_local ThreadShardHolder thread_shard_holder;    ///< Fragmento de métricas da thread atual.
+
+
+    /**
+     * @brief Estrutura com os rótulos de um peer remoto visto por um peer local.
+     */
+    struct PeerLabels {
+        std::string peer;                                           ///< "local=<id>,peer=<ip>:<porta>".
+        std::map<std::string, std::string, std::less<>> messages;   ///< "local=<id>,type=<tipo>,peer=<ip>:<porta>", por tipo.
+    };
+
+    /// Rótulos montados pela thread atual, por ID do peer local, IP e porta do peer remoto. Como o rótulo só
+    /// depende da chave, o cache é por thread (sem mutex) e vale para qualquer peer do processo.
+    thread_local std::map<std::tuple<int, std::string, int>, PeerLabels, std::less<>> thread_peer_labels;
+
+
+    /**
+     * @brief Retorna os rótulos de um peer remoto na thread atual, montando o rótulo do peer na primeira vez.
+     */
+    PeerLabels& peerLabels(int peer_id, const std::string& ip, int port) {
+        auto it = thread_peer_labels.find(std::forward_as_tuple(peer_id, ip, port));
+        if (it != thread_peer_labels.end()) {
+            return it->second;
+        }
+
+        // Limita a memória da thread quando ela conversa com muitos peers (ex: simulações grandes)
+        if (thread_peer_labels.size() >= Constants::METRICS_MAX_CACHED_LABELS) {
+            thread_peer_labels.clear();
+        }
+        PeerLabels& labels = thread_peer_labels[std::make_tuple(peer_id, ip, port)];
+        labels.peer = "local=" + std::to_string(peer_id) + ",peer=" + ip + ":" + std::to_string(port);
+        return labels;
+    }
+
+
+    /**
+     * @brief Incrementa um valor atômico que só é escrito pela thread atual.
+     *
+     * Como cada fragmento tem um único escritor, basta ler e escrever com ordem relaxada,
+     * evitando a instrução atômica de leitura-modificação-escrita.
+     */
+    inline void bump(std::atomic<uint64_t>& value, uint64_t amount) {
+        value.store(value.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+    }
+
+
+    /**
+     * @brief Escapa aspas, barras invertidas e caracteres de controle para uso em strings JSON.
+     */
+    std::string escapeJSON(const std::string& text) {
+        std::string escaped;
+        escaped.reserve(text.size());
+        for (char c : text) {
+            if (c == '"' || c == '\\') {
+                escaped += '\\';
+                escaped += c;
+            } else if (static_cast<unsigned char>(c) < 0x20) {
+                char code[8];
+                std::snprintf(code, sizeof(code), "\\u%04x", c);
+                escaped += code;
+            } else {
+                escaped += c;
+            }
+        }
+        return escaped;
+    }
+}
+
+
+// Limites superiores das faixas em milissegundos (a última faixa, implícita, é +Inf)
+const std::array<uint64_t, Metrics::BUCKET_COUNT - 1> Metrics::BUCKET_BOUNDS = {
+    1, 2, 5, 10, 20, 50, 100, 200, 500, 1000, 2000, 5000, 10000, 20000, 50000, 100000, 300000
+};
+
+
+/**
+ * @brief Retorna a instância única do registro de métricas.
+ */
+Metrics& Metrics::instance() {
+    // Nunca é destruída, pois threads destacadas podem atualizar métricas até o fim do processo
+    static Metrics* metrics = new Metrics();
+    return *metrics;
+}
+
+
+/**
+ * @brief Retorna o fragmento da thread atual, registrando-o na primeira chamada.
+ */
+Metrics::Shard& Metrics::threadShard() {
+    if (!thread_shard_holder.shard) {
+        thread_shard_holder.shard = std::make_shared<Shard>();
+
+        std::lock_guard<std::mutex> shards_lock(shards_mutex);
+        shards.push_back(thread_shard_holder.shard);
+    }
+    return *thread_shard_holder.shard;
+}
+
+
+/**
+ * @brief Soma os valores de um fragmento em outro.
+ */
+void Metrics::mergeShard(Shard& destination, Shard& source) {
+    for (size_t i = 0; i < COUNTER_COUNT; ++i) {
+        destination.counters[i] += source.counters[i].load(std::memory_order_relaxed);
+    }
+
+    for (size_t h = 0; h < HISTOGRAM_COUNT; ++h) {
+        for (size_t b = 0; b < BUCKET_COUNT; ++b) {
+            destination.buckets[h][b] += source.buckets[h][b].load(std::memory_order_relaxed);
+        }
+        destination.sums[h] += source.sums[h].load(std::memory_order_relaxed);
+    }
+
+    std::lock_guard<std::mutex> source_lock(source.labeled_mutex);
+    std::lock_guard<std::mutex> destination_lock(destination.labeled_mutex);
+    for (size_t i = 0; i < COUNTER_COUNT; ++i) {
+        for (const auto& [label, value] : source.labeled[i]) {
+            destination.labeled[i][label] += value;
+        }
+    }
+}
+
+
+/**
+ * @brief Incorpora ao fragmento acumulado os valores de uma thread que terminou.
+ */
+void Metrics::retireShard(const std::shared_ptr<Shard>& shard) {
+    std::lock_guard<std::mutex> shards_lock(shards_mutex);
+
+    mergeShard(retired, *shard);
+
+    // Remove o fragmento da lista de threads em execução
+    for (auto it = shards.begin(); it != shards.end(); ++it) {
+        if (*it == shard) {
+            shards.erase(it);
+            break;
+        }
+    }
+}
+
+
+/**
+ * @brief Incrementa um contador.
+ */
+void Metrics::add(Counter counter, uint64_t value) {
+    bump(threadShard().counters[static_cast<size_t>(counter)], value);
+}
+
+
+/**
+ * @brief Incrementa um contador, contabilizando também o valor em um rótulo.
+ */
+void Metrics::add(Counter counter, const std::string& label, uint64_t value) {
+    Shard& shard = threadShard();
+    bump(shard.counters[static_cast<size_t>(counter)], value);
+
+    // O mutex do fragmento só é disputado quando um snapshot está sendo montado
+    std::lock_guard<std::mutex> labeled_lock(shard.labeled_mutex);
+    shard.labeled[static_cast<size_t>(counter)][label] += value;
+}
+
+
+/**
+ * @brief Define o valor de um medidor de um peer local.
+ */
+void Metrics::set(Gauge gauge, int peer_id, int64_t value) {
+    std::lock_guard<std::mutex> gauges_lock(gauges_mutex);
+    gauges[static_cast<size_t>(gauge)][peer_id] = value;
+}
+
+
+/**
+ * @brief Registra um valor em um histograma.
+ */
+void Metrics::observe(Histogram histogram, uint64_t value) {
+    Shard& shard = threadShard();
+    size_t h = static_cast<size_t>(histogram);
+
+    // Encontra a primeira faixa cujo limite superior comporta o valor
+    size_t bucket = 0;
+    while (bucket < BUCKET_BOUNDS.size() && value > BUCKET_BOUNDS[bucket]) {
+        ++bucket;
+    }
+
+    bump(shard.buckets[h][bucket], 1);
+    bump(shard.sums[h], value);
+}
+
+
+/**
+ * @brief Inicia a medição de um intervalo de um peer local.
+ */
+void Metrics::startTimer(int peer_id, const std::string& file_name, int chunk) {
+    auto now = std::chrono::steady_clock::now();
+    std::lock_guard<std::mutex> timers_lock(timers_mutex);
+
+    // Descarta intervalos antigos que nunca foram encerrados (ex: chunks que nunca chegaram)
+    if (timers.size() >= Constants::METRICS_MAX_PENDING_TIMERS) {
+        auto expiration = now - std::chrono::seconds(Constants::METRICS_TIMER_EXPIRATION_SECONDS);
+        for (auto it = timers.begin(); it != timers.end();) {
+            it = it->second < expiration ? timers.erase(it) : std::next(it);
+        }
+    }
+
+    // A chave só é copiada quando o intervalo ainda não está em medição
+    auto key = std::forward_as_tuple(peer_id, file_name, chunk);
+    if (timers.find(key) == timers.end()) {
+        timers.emplace(key, now);
+    }
+}
+
+
+/**
+ * @brief Encerra a medição de um intervalo e registra a duração no histograma.
+ */
+void Metrics::stopTimer(Histogram histogram, int peer_id, const std::string& file_name, int chunk) {
+    std::chrono::steady_clock::time_point start;
+    {
+        std::lock_guard<std::mutex> timers_lock(timers_mutex);
+        auto it = timers.find(std::forward_as_tuple(peer_id, file_name, chunk));
+        if (it == timers.end()) {
+            return;
+        }
+        start = it->second;
+        timers.erase(it);
+    }
+
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    observe(histogram, std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count());
+}
+
+
+/**
+ * @brief Retorna o rótulo de um peer remoto visto por um peer local.
+ */
+const std::string& Metrics::peerLabel(int peer_id, const std::string& ip, int port) {
+    return peerLabels(peer_id, ip, port).peer;
+}
+
+
+/**
+ * @brief Retorna o rótulo de uma mensagem trocada com um peer remoto.
+ */
+const std::string& Metrics::messageLabel(int peer_id, std::string_view type, const std::string& ip, int port) {
+    PeerLabels& labels = peerLabels(peer_id, ip, port);
+
+    auto it = labels.messages.find(type);
+    if (it == labels.messages.end()) {
+        std::string label = "local=" + std::to_string(peer_id) + ",type=" + std::string(type) + ",peer=" + ip + ":" + std::to_string(port);
+        it = labels.messages.emplace(std::string(type), std::move(label)).first;
+    }
+    return it->second;
+}
+
+
+/**
+ * @brief Soma os fragmentos de todas as threads e retorna os valores de um contador por rótulo.
+ */
+std::unordered_map<std::string, uint64_t> Metrics::labeledValues(Counter counter) {
+    std::unordered_map<std::string, uint64_t> values;
+    size_t index = static_cast<size_t>(counter);
+
+    std::lock_guard<std::mutex> shards_lock(shards_mutex);
+    {
+        std::lock_guard<std::mutex> retired_lock(retired.labeled_mutex);
+        values = retired.labeled[index];
+    }
+    for (const auto& shard : shards) {
+        std::lock_guard<std::mutex> labeled_lock(shard->labeled_mutex);
+        for (const auto& [label, value] : shard->labeled[index]) {
+            values[label] += value;
+        }
+    }
+
+    return values;
+}
+
+
+/**
+ * @brief Soma os fragmentos de todas as threads e retorna o snapshot em JSON.
+ */
+std::string Metrics::snapshotJSON() {
+    Shard total;
+    {
+        std::lock_guard<std::mutex> shards_lock(shards_mutex);
+        mergeShard(total, retired);
+        for (const auto& shard : shards) {
+            mergeShard(total, *shard);
+        }
+    }
+
+    std::stringstream json;
+    auto timestamp_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    json << "{\"timestamp_ns\":" << timestamp_ns;
+
+    // Contadores com o total e os valores por rótulo
+    json << ",\"counters\":{";
+    for (size_t i = 0; i < COUNTER_COUNT; ++i) {
+        json << (i ? "," : "") << "\"" << counterName(static_cast<Counter>(i)) << "\":{\"total\":"
+             << total.counters[i].load() << ",\"labels\":{";
+        bool first = true;
+        for (const auto& [label, value] : total.labeled[i]) {
+            json << (first ? "" : ",") << "\"" << escapeJSON(label) << "\":" << value;
+            first = false;
+        }
+        json << "}}";
+    }
+    json << "}";
+
+    // Medidores com a soma e os valores por peer local, no formato dos contadores
+    json << ",\"gauges\":{";
+    {
+        std::lock_guard<std::mutex> gauges_lock(gauges_mutex);
+        for (size_t i = 0; i < GAUGE_COUNT; ++i) {
+            int64_t sum = 0;
+            for (const auto& [peer_id, value] : gauges[i]) {
+                sum += value;
+            }
+            json << (i ? "," : "") << "\"" << gaugeName(static_cast<Gauge>(i)) << "\":{\"total\":" << sum << ",\"labels\":{";
+            bool first = true;
+            for (const auto& [peer_id, value] : gauges[i]) {
+                json << (first ? "" : ",") << "\"local=" << peer_id << "\":" << value;
+                first = false;
+            }
+            json << "}}";
+        }
+    }
+    json << "}";
+
+    // Histogramas com contagem, soma e contagem por faixa (não cumulativa)
+    json << ",\"histograms\":{";
+    for (size_t h = 0; h < HISTOGRAM_COUNT; ++h) {
+        uint64_t count = 0;
+        for (const auto& bucket : total.buckets[h]) {
+            count += bucket.load();
+        }
+
+        json << (h ? "," : "") << "\"" << histogramName(static_cast<Histogram>(h)) << "\":{\"count\":" << count
+             << ",\"sum\":" << total.sums[h].load() << ",\"buckets\":{";
+        for (size_t b = 0; b < BUCKET_COUNT; ++b) {
+            json << (b ? "," : "") << "\"";
+            if (b < BUCKET_BOUNDS.size()) {
+                json << BUCKET_BOUNDS[b];
+            } else {
+                json << "+Inf";
+            }
+            json << "\":" << total.buckets[h][b].load();
+        }
+        json << "}}";
+    }
+    json << "}}\n";
+
+    return json.str();
+}
+
+
+/**
+ * @brief Grava periodicamente o snapshot das métricas em um arquivo.
+ */
+void Metrics::runSnapshotWriter(const std::string& path, int interval_seconds) {
+    std::string temporary_path = path + ".tmp";
+
+    while (true) {
+        std::this_thread::sleep_for(std::chrono::seconds(interval_seconds));
+
+        FILE* file = std::fopen(temporary_path.c_str(), "w");
+        if (!file) {
+            perror("Erro ao gravar snapshot de métricas");
+            continue;
+        }
+
+        std::string snapshot = snapshotJSON();
+        std::fwrite(snapshot.data(), 1, snapshot.size(), file);
+        std::fclose(file);
+
+        // Substitui o snapshot anterior de forma atômica
+        std::rename(temporary_path.c_str(), path.c_str());
+    }
+}
+
+
+/**
+ * @brief Retorna o nome de um contador.
+ */
+const char* Metrics::counterName(Counter counter) {
+    switch (counter) {
+        case Counter::MESSAGES_IN:                  return "messages_in";
+        case Counter::MESSAGES_OUT:                 return "messages_out";
+        case Counter::BYTES_SENT:                   return "bytes_sent";
+        case Counter::BYTES_RECEIVED:               return "bytes_received";
+        case Counter::CHUNKS_SENT:                  return "chunks_sent";
+        case Counter::CHUNKS_RECEIVED:              return "chunks_received";
+        case Counter::SCHEDULER_CHUNKS_ASSIGNED:    return "scheduler_chunks_assigned";
+        case Counter::SCHEDULER_CHUNKS_UNAVAILABLE: return "scheduler_chunks_unavailable";
+        case Counter::NEIGHBORS_ADDED:              return "neighbors_added";
+        case Counter::NEIGHBORS_REMOVED:            return "neighbors_removed";
+        case Counter::DHT_LOOKUPS:                  return "dht_lookups";
+        case Counter::AVAILABILITY_CACHE_LOOKUPS:   return "availability_cache_lookups";
+        case Counter::HAVE_CHUNKS_REQUESTED:        return "have_chunks_requested";
+        case Counter::UPLOAD_CHUNKS_CHOKED:         return "upload_chunks_choked";
+        case Counter::CHUNKS_DEDUPLICATED:          return "chunks_deduplicated";
+        case Counter::CHUNKS_COMPRESSED:            return "chunks_compressed";
+        case Counter::COMPRESSION_BYTES_SAVED:      return "compression_bytes_saved";
+        case Counter::CHUNKS_RESUMED:               return "chunks_resumed";
+        case Counter::RESUME_BYTES_SAVED:           return "resume_bytes_saved";
+        default:                                    return "unknown";
+    }
+}
+
+
+/**
+ * @brief Retorna o nome de um medidor.
+ */
+const char* Metrics::gaugeName(Gauge gauge) {
+    switch (gauge) {
+        case Gauge::DOWNLOADS_QUEUED:       return "downloads_queued";
+        case Gauge::DOWNLOADS_ACTIVE:       return "downloads_active";
+        case Gauge::EXECUTOR_PENDING_TASKS: return "executor_pending_tasks";
+        default:                            return "unknown";
+    }
+}
+
+
+/**
+ * @brief Retorna o nome de um histograma.
+ */
+const char* Metrics::histogramName(Histogram histogram) {
+    switch (histogram) {
+        case Histogram::DISCOVERY_TO_FIRST_RESPONSE_MS: return "discovery_to_first_response_ms";
+        case Histogram::REQUEST_TO_CHUNK_COMPLETE_MS:   return "request_to_chunk_complete_ms";
+        case Histogram::DHT_LOOKUP_MS:                  return "dht_lookup_ms";
+        default:                                        return "unknown";
+    }
+}
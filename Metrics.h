@@ -0,0 +1,290 @@
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+
+/**
+ * @brief Enumeração dos contadores mantidos pelo registro de métricas.
+ */
+enum class Counter {
+    MESSAGES_IN,                    ///< Mensagens UDP recebidas (rótulos: tipo e peer remetente).
+    MESSAGES_OUT,                   ///< Mensagens UDP enviadas (rótulos: tipo e peer destinatário).
+    BYTES_SENT,                     ///< Bytes de chunks enviados via TCP (rótulos: arquivo e peer destinatário).
+    BYTES_RECEIVED,                 ///< Bytes de chunks recebidos via TCP (rótulos: arquivo e peer remetente).
+    CHUNKS_SENT,                    ///< Chunks enviados por completo via TCP (rótulo: arquivo).
+    CHUNKS_RECEIVED,                ///< Chunks recebidos por completo via TCP (rótulo: arquivo).
+    SCHEDULER_CHUNKS_ASSIGNED,      ///< Chunks atribuídos a um peer por selectPeersForChunkDownload (rótulo: peer escolhido).
+    SCHEDULER_CHUNKS_UNAVAILABLE,   ///< Chunks sem nenhum peer conhecido em selectPeersForChunkDownload (rótulo: arquivo).
+    NEIGHBORS_ADDED,                ///< Vizinhos adicionados pelo gerenciador de vizinhança (rótulo: origem).
+    NEIGHBORS_REMOVED,              ///< Vizinhos removidos pelo gerenciador de vizinhança (rótulo: motivo).
+    DHT_LOOKUPS,                    ///< Buscas de detentores na DHT (rótulo: resultado, found ou empty).
+    AVAILABILITY_CACHE_LOOKUPS,     ///< Consultas ao cache de disponibilidade antes de uma descoberta (rótulo: resultado, hit, partial ou miss).
+    HAVE_CHUNKS_REQUESTED,          ///< Chunks pedidos logo após um anúncio HAVE, sem nova descoberta (rótulo: peer anunciante).
+    UPLOAD_CHUNKS_CHOKED,           ///< Chunks pedidos recusados porque a fila de envio do solicitante estava cheia (rótulo: peer solicitante).
+    CHUNKS_DEDUPLICATED,            ///< Chunks faltantes preenchidos com um chunk local de mesmo conteúdo, sem transferência (rótulo: arquivo).
+    CHUNKS_COMPRESSED,              ///< Chunks enviados comprimidos via TCP (rótulo: formato).
+    COMPRESSION_BYTES_SAVED,        ///< Bytes a menos enviados via TCP pela compressão dos chunks (rótulo: formato).
+    CHUNKS_RESUMED,                 ///< Chunks recebidos a partir do byte em que uma transferência anterior parou.
+    RESUME_BYTES_SAVED,             ///< Bytes dos chunks retomados que não precisaram ser recebidos de novo.
+    COUNT                           ///< Número de contadores (não é um contador).
+};
+
+
+/**
+ * @brief Enumeração dos medidores (valores instantâneos) mantidos pelo registro de métricas.
+ */
+enum class Gauge {
+    DOWNLOADS_QUEUED,               ///< Downloads aguardando uma vaga no escalonador.
+    DOWNLOADS_ACTIVE,               ///< Downloads ativos no escalonador.
+    EXECUTOR_PENDING_TASKS,         ///< Tarefas aguardando execução no executor do escalonador.
+    COUNT                           ///< Número de medidores (não é um medidor).
+};
+
+
+/**
+ * @brief Enumeração dos histogramas de latência mantidos pelo registro de métricas.
+ */
+enum class Histogram {
+    DISCOVERY_TO_FIRST_RESPONSE_MS, ///< Tempo entre o início da rodada de descoberta e a primeira resposta para o arquivo.
+    REQUEST_TO_CHUNK_COMPLETE_MS,   ///< Tempo entre o envio do REQUEST e o recebimento completo do chunk.
+    DHT_LOOKUP_MS,                  ///< Duração de uma busca de detentores de um arquivo na DHT.
+    COUNT                           ///< Número de histogramas (não é um histograma).
+};
+
+
+/**
+ * @brief Classe responsável pelo registro de métricas do peer.
+ *
+ * Contadores e histogramas são mantidos em fragmentos por thread: cada thread só escreve
+ * no próprio fragmento, sem disputar cache ou mutex com as demais, e os valores são somados
+ * apenas na leitura (snapshot). Fragmentos de threads que terminaram são incorporados a um
+ * fragmento acumulado. Medidores guardam o último valor definido por cada peer local.
+ *
+ * O registro é único no processo. Como vários peers podem compartilhar o mesmo processo
+ * (simulação), os rótulos começam pelo ID do peer local ("local=<id>"), e os medidores e
+ * os intervalos em medição são separados pelo ID do peer local. Os rótulos por peer remoto
+ * usados a cada mensagem são montados uma única vez por thread (peerLabel e messageLabel).
+ *
+ * O snapshot pode ser obtido pelo comando METRICS do socket de controle ou gravado
+ * periodicamente em um arquivo JSON.
+ */
+class Metrics {
+public:
+    static constexpr size_t COUNTER_COUNT = static_cast<size_t>(Counter::COUNT);       ///< Número de contadores.
+    static constexpr size_t GAUGE_COUNT = static_cast<size_t>(Gauge::COUNT);           ///< Número de medidores.
+    static constexpr size_t HISTOGRAM_COUNT = static_cast<size_t>(Histogram::COUNT);   ///< Número de histogramas.
+    static constexpr size_t BUCKET_COUNT = 18;                                         ///< Número de faixas de cada histograma (a última é +Inf).
+    static const std::array<uint64_t, BUCKET_COUNT - 1> BUCKET_BOUNDS;                 ///< Limites superiores das faixas dos histogramas.
+
+    /**
+     * @brief Estrutura com os valores de um fragmento de métricas de uma thread.
+     */
+    struct Shard {
+        std::array<std::atomic<uint64_t>, COUNTER_COUNT> counters{};                            ///< Totais de cada contador.
+        std::array<std::array<std::atomic<uint64_t>, BUCKET_COUNT>, HISTOGRAM_COUNT> buckets{};  ///< Contagem por faixa de cada histograma.
+        std::array<std::atomic<uint64_t>, HISTOGRAM_COUNT> sums{};                              ///< Soma dos valores observados em cada histograma.
+        std::array<std::unordered_map<std::string, uint64_t>, COUNTER_COUNT> labeled;           ///< Valores de cada contador por rótulo.
+        std::mutex labeled_mutex;                                                               ///< Mutex dos contadores rotulados (disputado só na leitura).
+    };
+
+private:
+    std::vector<std::shared_ptr<Shard>> shards;             ///< Fragmentos das threads em execução.
+    Shard retired;                                          ///< Valores acumulados dos fragmentos de threads que terminaram.
+    std::mutex shards_mutex;                                ///< Mutex para proteger a lista de fragmentos e o fragmento acumulado.
+    std::array<std::map<int, int64_t>, GAUGE_COUNT> gauges; ///< Valores atuais dos medidores, por ID do peer local.
+    std::mutex gauges_mutex;                                ///< Mutex para proteger os medidores.
+    std::map<std::tuple<int, std::string, int>, std::chrono::steady_clock::time_point, std::less<>> timers;
+    ///< Instantes iniciais dos intervalos em medição, por ID do peer local, arquivo e chunk.
+    std::mutex timers_mutex;                                ///< Mutex para proteger o mapa de intervalos.
+
+    /**
+     * @brief Construtor da classe Metrics.
+     */
+    Metrics() = default;
+
+
+    /**
+     * @brief Retorna o fragmento da thread atual, registrando-o na primeira chamada.
+     *
+     * @return Referência ao fragmento da thread atual.
+     */
+    Shard& threadShard();
+
+
+    /**
+     * @brief Soma os valores de um fragmento em outro.
+     *
+     * @param destination Fragmento que recebe a soma.
+     * @param source Fragmento somado.
+     */
+    static void mergeShard(Shard& destination, Shard& source);
+
+public:
+    /**
+     * @brief Retorna a instância única do registro de métricas.
+     *
+     * @return Referência ao registro de métricas.
+     */
+    static Metrics& instance();
+
+
+    /**
+     * @brief Incorpora ao fragmento acumulado os valores de uma thread que terminou.
+     *
+     * @param shard Fragmento da thread.
+     */
+    void retireShard(const std::shared_ptr<Shard>& shard);
+
+
+    /**
+     * @brief Incrementa um contador.
+     *
+     * @param counter Contador a ser incrementado.
+     * @param value Valor a ser somado.
+     */
+    void add(Counter counter, uint64_t value = 1);
+
+
+    /**
+     * @brief Incrementa um contador, contabilizando também o valor em um rótulo.
+     *
+     * @param counter Contador a ser incrementado.
+     * @param label Rótulo no formato "chave=valor,chave=valor" (ex: "local=0,type=DISCOVERY,peer=127.0.0.1:6001").
+     * @param value Valor a ser somado.
+     */
+    void add(Counter counter, const std::string& label, uint64_t value = 1);
+
+
+    /**
+     * @brief Define o valor de um medidor de um peer local.
+     *
+     * @param gauge Medidor.
+     * @param peer_id ID do peer local.
+     * @param value Novo valor.
+     */
+    void set(Gauge gauge, int peer_id, int64_t value);
+
+
+    /**
+     * @brief Registra um valor em um histograma.
+     *
+     * @param histogram Histograma.
+     * @param value Valor observado.
+     */
+    void observe(Histogram histogram, uint64_t value);
+
+
+    /**
+     * @brief Inicia a medição de um intervalo de um peer local.
+     *
+     * Se já houver uma medição em andamento com a mesma chave, ela é mantida.
+     *
+     * @param peer_id ID do peer local.
+     * @param file_name Nome do arquivo (ou nome de conteúdo).
+     * @param chunk Chunk esperado, ou -1 para um intervalo do arquivo todo (ex: descoberta).
+     */
+    void startTimer(int peer_id, const std::string& file_name, int chunk = -1);
+
+
+    /**
+     * @brief Encerra a medição de um intervalo e registra a duração em milissegundos no histograma.
+     *
+     * Não faz nada se não houver medição em andamento com a chave, de modo que apenas o
+     * primeiro evento após startTimer é contabilizado.
+     *
+     * @param histogram Histograma que recebe a duração.
+     * @param peer_id ID do peer local.
+     * @param file_name Nome do arquivo (ou nome de conteúdo).
+     * @param chunk Chunk esperado, ou -1 para um intervalo do arquivo todo.
+     */
+    void stopTimer(Histogram histogram, int peer_id, const std::string& file_name, int chunk = -1);
+
+
+    /**
+     * @brief Retorna o rótulo de um peer remoto visto por um peer local ("local=<id>,peer=<ip>:<porta>").
+     *
+     * O rótulo é montado na primeira chamada de cada thread e reaproveitado nas seguintes.
+     *
+     * @param peer_id ID do peer local.
+     * @param ip Endereço IP do peer remoto.
+     * @param port Porta UDP do peer remoto.
+     * @return Rótulo, válido até o fim da thread ou a próxima chamada que descarte o cache (Constants::METRICS_MAX_CACHED_LABELS).
+     */
+    static const std::string& peerLabel(int peer_id, const std::string& ip, int port);
+
+
+    /**
+     * @brief Retorna o rótulo de uma mensagem trocada com um peer remoto ("local=<id>,type=<tipo>,peer=<ip>:<porta>").
+     *
+     * Como peerLabel, é montado uma única vez por thread.
+     *
+     * @param peer_id ID do peer local.
+     * @param type Tipo da mensagem (primeira palavra).
+     * @param ip Endereço IP do peer remoto.
+     * @param port Porta UDP do peer remoto.
+     * @return Rótulo, com a mesma validade do de peerLabel.
+     */
+    static const std::string& messageLabel(int peer_id, std::string_view type, const std::string& ip, int port);
+
+
+    /**
+     * @brief Soma os fragmentos de todas as threads e retorna os valores de um contador por rótulo.
+     *
+     * @param counter Contador.
+     * @return Mapa de rótulo para valor.
+     */
+    std::unordered_map<std::string, uint64_t> labeledValues(Counter counter);
+
+
+    /**
+     * @brief Soma os fragmentos de todas as threads e retorna o snapshot em JSON.
+     *
+     * @return Snapshot das métricas em JSON.
+     */
+    std::string snapshotJSON();
+
+
+    /**
+     * @brief Grava periodicamente o snapshot das métricas em um arquivo.
+     *
+     * A gravação é feita em um arquivo temporário renomeado em seguida, para que leitores
+     * nunca vejam um snapshot incompleto. Não retorna.
+     *
+     * @param path Caminho do arquivo de snapshot.
+     * @param interval_seconds Intervalo entre gravações em segundos.
+     */
+    void runSnapshotWriter(const std::string& path, int interval_seconds);
+
+
+    /**
+     * @brief Retorna o nome de um contador (ex: "messages_in").
+     */
+    static const char* counterName(Counter counter);
+
+
+    /**
+     * @brief Retorna o nome de um medidor (ex: "downloads_active").
+     */
+    static const char* gaugeName(Gauge gauge);
+
+
+    /**
+     * @brief Retorna o nome de um histograma (ex: "request_to_chunk_complete_ms").
+     */
+    static const char* histogramName(Histogram histogram);
+};
+
+#endif // METRICS_H
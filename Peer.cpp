@@ -1,104 +1,188 @@
 #include "Peer.h"
+#include <algorithm>
 #include <thread>
 #include <iostream>
 #include <fstream>
 
+
+namespace {
+    /**
+     * @brief Retorna o número de threads do executor compartilhado do peer.
+     *
+     * As tarefas longas ocupam no máximo io_threads threads (recebimentos) e Constants::UPLOAD_SLOTS (envios),
+     * então sempre restam worker_threads threads para as mensagens de controle, as gravações e as montagens.
+     */
+    int sharedExecutorThreads() {
+        ThreadingConfig threading = CpuTopology::getDefaultConfig();
+        return std::max(1, threading.worker_threads) + std::max(1, threading.io_threads) + Constants::UPLOAD_SLOTS;
+    }
+}
+
 /**
  * @brief Construtor da classe Peer. Também inicializa os servidores UDP e TCP e o gerenciador de arquivos.
  */
-Peer::Peer(int id, const std::string& ip, int udp_port, int tcp_port, int transfer_speed, const std::vector<std::tuple<std::string, int>> neighbors)
-    : id(id), ip(ip), udp_port(udp_port), tcp_port(tcp_port), transfer_speed(transfer_speed), neighbors(neighbors),
-      file_manager(std::to_string(id)),
-      tcp_server(ip, tcp_port, id, transfer_speed, file_manager),
-      udp_server(ip, udp_port, tcp_port, id, transfer_speed, file_manager, tcp_server) {}
+Peer::Peer(int id, const std::string& ip, int udp_port, int tcp_port, int transfer_speed, const std::vector<std::tuple<std::string, int>> neighbors,
+           const std::string& base_path, const TimingConfig& timing)
+    : id(id), ip(ip), udp_port(udp_port), tcp_port(tcp_port), transfer_speed(transfer_speed), neighbors(neighbors), timing(timing),
+      placement(CpuTopology::instance().place(id, CpuTopology::getDefaultConfig())),
+      executor(sharedExecutorThreads()),
+      io_engine(IOEngine::create(IOEngine::getDefaultBackend())),
+      file_manager(std::to_string(id), base_path, timing),
+      chunk_persister(file_manager, executor),
+      download_journal(file_manager, base_path + std::to_string(id) + "/" + Constants::DOWNLOAD_JOURNAL_FILE_NAME, timing),
+      tcp_server(ip, tcp_port, id, transfer_speed, file_manager, executor, timing),
+      udp_server(ip, udp_port, tcp_port, id, transfer_speed, file_manager, tcp_server, executor, timing),
+      upload_scheduler(id, tcp_server, file_manager, executor),
+      membership(ip, udp_port, id, udp_server, timing),
+      dht(ip, udp_port, id, transfer_speed, udp_server, file_manager, timing),
+      aggregator(ip, udp_port, id, transfer_speed, udp_server, file_manager, timing),
+      have_announcer(ip, udp_port, id, transfer_speed, udp_server, file_manager, timing),
+      download_scheduler(ip, udp_port, id, file_manager, udp_server, dht, timing),
+      control_server(ControlServer::getSocketPath(id), *this) {}
 
 
 /**
  * @brief Inicia os servidores TCP e UDP.
  */
-void Peer::start(const std::vector<std::string>& file_names) {
-    // Inicializa os vizinhos na lista do servidor UDP
-    udp_server.setUDPNeighbors(neighbors);
+void Peer::start(const std::vector<std::string>& file_names, bool daemon_mode) {
+    // A thread que inicia o peer também é fixada, para que o estado dos arquivos carregado a seguir fique no nó do peer
+    CpuTopology::pinCurrentThread(placement.cpusFor(ThreadRole::WORKER, 0));
+    ThreadingConfig threading = CpuTopology::getDefaultConfig();
+    executor.pin(placement);
+    tcp_server.setThreadPlacement(placement);
+    download_scheduler.setThreadPlacement(placement);
+    LOG_MESSAGE(LogType::INFO, "Threads: executor compartilhado com " + std::to_string(executor.threadCount()) + " (até " +
+                std::to_string(threading.io_threads) + " recebimentos e " + std::to_string(Constants::UPLOAD_SLOTS) + " envios ao mesmo tempo), afinidade " +
+                CpuTopology::pinningToString(placement.pinning) + " (nó " + std::to_string(placement.node) + ").");
+
+    // A gravação, a leitura e a transferência dos chunks passam pela E/S escolhida (--io)
+    file_manager.setIOEngine(io_engine.get());
+    tcp_server.setIOEngine(io_engine.get());
+    LOG_MESSAGE(LogType::INFO, std::string("E/S dos chunks: ") + IOEngine::backendToString(io_engine->backend()));
+
+    // Inicializa os vizinhos da topologia, que passam a ser monitorados pelo gerenciador de vizinhança
+    tcp_server.setChunkPersister(&chunk_persister);
+    file_manager.setExecutor(&executor);
+    udp_server.setMembershipManager(&membership);
+    udp_server.setDHTNode(&dht);
+    udp_server.setResponseAggregator(&aggregator);
+    udp_server.setHaveAnnouncer(&have_announcer);
+    udp_server.setUploadScheduler(&upload_scheduler);
+    udp_server.setDownloadJournal(&download_journal);
+    tcp_server.setDownloadJournal(&download_journal);
+    download_scheduler.setDownloadJournal(&download_journal);
+    file_manager.setLocalChunksListener([this](const std::string& file_name, int chunk, const ChunkLocationInfo& sender) {
+        // A resposta em cache deixa de valer, o chunk entra no próximo anúncio HAVE e o remetente ganha crédito nos envios
+        udp_server.invalidateChunkResponse(file_name);
+        have_announcer.chunkAdded(file_name, chunk);
+        upload_scheduler.recordReceived(sender);
+    });
+    membership.setInitialNeighbors(neighbors);
 
     // Carrega os chunks locais do peer
     file_manager.loadLocalChunks();
 
+    // Lê o diário dos downloads interrompidos pelo último encerramento do peer (chunks parciais e detentores conhecidos)
+    auto journaled_files = download_journal.load();
+
+    // Inicia a gravação periódica do diário de downloads em uma thread separada
+    std::thread journal_thread = startThread(ThreadRole::WORKER, 0, [this] { download_journal.run(); });
+
     // Inicia o servidor TCP em uma thread separada
-    std::thread tcp_thread(&TCPServer::run, &tcp_server);
+    std::thread tcp_thread = startThread(ThreadRole::IO, 0, [this] { tcp_server.run(); });
+
+    // Inicia o envio dos resumos agregados em uma thread separada (antes do UDP, que registra as buscas)
+    std::thread aggregator_thread = startThread(ThreadRole::WORKER, 0, [this] { aggregator.run(); });
+
+    // Inicia os anúncios HAVE dos chunks recebidos em uma thread separada
+    std::thread have_thread = startThread(ThreadRole::WORKER, 0, [this] { have_announcer.run(); });
 
-    // Inicia o servidor UDP em uma thread separada
-    std::thread udp_thread(&UDPServer::run, &udp_server);
+    // Inicia o servidor UDP em uma thread separada, e a propagação cadenciada das descobertas em outra
+    std::thread udp_thread = startThread(ThreadRole::IO, 0, [this] { udp_server.run(); });
+    std::thread pacer_thread = startThread(ThreadRole::IO, 1, [this] { udp_server.runPacer(); });
 
     // Espera para dar tempo de inicializar todos os servidores dos outros peers
-    std::this_thread::sleep_for(std::chrono::seconds(Constants::SERVER_STARTUP_DELAY_SECONDS));
+    std::this_thread::sleep_for(timing.server_startup_delay);
 
-    // Threads para busca de cada arquivo
-    std::vector<std::thread> threads;
+    // Inicia os heartbeats e a manutenção da vizinhança em uma thread separada (o socket UDP já está aberto)
+    std::thread membership_thread = startThread(ThreadRole::WORKER, 0, [this] { membership.run(); });
 
-    // Cria uma thread para cada file_name chamando Peer::searchFile e adiciona ao vetor
+    // Inicia a manutenção da tabela de roteamento e a publicação dos chunks na DHT em uma thread separada (parada até o primeiro uso da DHT)
+    std::thread dht_thread = startThread(ThreadRole::WORKER, 0, [this] { dht.run(); });
+
+    // Retoma os downloads do diário, com a prioridade de antes, e registra os arquivos passados na linha de comando como downloads iniciais
+    for (const auto& [file_name, priority] : journaled_files) {
+        submitDownload(file_name, priority);
+    }
     for (const auto& file_name : file_names) {
-        threads.emplace_back(&Peer::searchFile, this, file_name);
+        submitDownload(file_name);
     }
 
-    // Aguarda todas as threads de busca terminarem (join)
-    for (auto& th : threads) {
-        if (th.joinable()) {
-            th.join();
-        }
+    // Inicia o escalonador de downloads em uma thread separada
+    std::thread scheduler_thread = startThread(ThreadRole::WORKER, 0, [this] { download_scheduler.run(); });
+
+    if (daemon_mode) {
+        // Inicia o servidor de controle em uma thread separada
+        std::thread control_thread = startThread(ThreadRole::WORKER, 0, [this] { control_server.run(); });
+        control_thread.join();
     }
 
-    // Espera a finalização das thread do servidor TCP e UDP
+    // Espera a finalização das threads do escalonador, da DHT, da vizinhança, do agregador, dos anúncios, do diário, da propagação e dos servidores TCP e UDP
+    scheduler_thread.join();
+    dht_thread.join();
+    membership_thread.join();
+    aggregator_thread.join();
+    have_thread.join();
+    journal_thread.join();
     tcp_thread.join();
+    pacer_thread.join();
     udp_thread.join();
 }
 
 
 /**
- * @brief Inicia a busca por chunks de um arquivo na rede.
+ * @brief Registra o download de um arquivo no escalonador de downloads.
+ */
+bool Peer::submitDownload(const std::string& file_name, int priority) {
+    return download_scheduler.submit(file_name, priority);
+}
+
+
+/**
+ * @brief Cancela o download de um arquivo.
  */
-void Peer::searchFile(const std::string& file_name) {
-    // Carrega as informações do arquivo de metadados (nome do arquivo, número total de chunks, e TTL inicial)
-    auto [file_name_returned, total_chunks, initial_ttl] = file_manager.loadMetadata(file_name);
+bool Peer::cancelDownload(const std::string& file_name) {
+    return download_scheduler.cancel(file_name);
+}
 
-    // Verifica se a leitura foi bem-sucedida
-    if (total_chunks != -1 && initial_ttl != -1) {
-       // Inicializa a estrutura responsável por armazenar as informações de número total de chunks para um arquivo
-        file_manager.initializeFileChunks(file_name_returned, total_chunks);
 
-        // Inicializa a estrutura responsável por armazenar informações de localização dos chunks
-        file_manager.initializeChunkLocationInfo(file_name_returned);
+/**
+ * @brief Retorna o estado de todos os downloads conhecidos pelo peer.
+ */
+std::vector<DownloadStatus> Peer::getDownloadsStatus() {
+    return download_scheduler.getStatus();
+}
+
 
-        // Começa a descoberta dos chunks
-        discoverAndRequestChunks(file_name_returned, total_chunks, initial_ttl);
-    }
+/**
+ * @brief Define o peer de bootstrap usado para entrar na rede quando o peer não tem vizinhos.
+ */
+void Peer::setBootstrapPeer(const std::string& bootstrap_ip, int bootstrap_port) {
+    membership.setBootstrapPeer(bootstrap_ip, bootstrap_port);
 }
 
 
 /**
- * @brief Inicia o processo de descoberta e solicitação de chunks.
+ * @brief Retorna os vizinhos atuais do peer.
  */
-void Peer::discoverAndRequestChunks(const std::string& file_name, int total_chunks, int initial_ttl) {
-    // Monta um PeerInfo para o peer original que está enviando a solicitação
-    PeerInfo original_sender_info(ip, udp_port);
-
-    // Inicializa como verdadeiro a variável que indica que é permitido processar respostas
-    // das mensagens de descoberta de chunks para o arquivo file_name
-    udp_server.initializeProcessingActive(file_name);
-
-    // Tenta montar o arquivo com os chunks disponíveis
-    bool assembler = file_manager.assembleFile(file_name);
-
-    // Se não conseguir montar o arquivo, envia uma solicitação de descoberta e espera por respostas
-    if (!assembler) {
-        // Envia a mensagem de descoberta para seus vizinhos
-        udp_server.sendChunkDiscoveryMessage(file_name, total_chunks, initial_ttl, original_sender_info);
-
-        // Espera por respostas
-        udp_server.waitForResponses(file_name);
-    
-        // Envia solicitações de chunks aos peers selecionados
-        udp_server.sendChunkRequestMessage(file_name);
-    } else {
-        logMessage(LogType::INFO, "O peer " + std::to_string(id) + " (" + ip + ":" + std::to_string(udp_port) + ") já possuí todos os chunks para " + file_name + ".");
-    }
+std::vector<std::tuple<std::string, int>> Peer::getNeighbors() {
+    return membership.getNeighbors();
+}
+
+
+/**
+ * @brief Anuncia aos vizinhos a saída do peer da rede.
+ */
+void Peer::leave() {
+    membership.leave();
 }
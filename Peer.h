@@ -1,13 +1,27 @@
 #ifndef PEER_H
 #define PEER_H
 
+#include "ChunkPersister.h"
 #include "ConfigManager.h"
+#include "ControlServer.h"
+#include "CpuTopology.h"
+#include "DHTNode.h"
+#include "DownloadJournal.h"
+#include "DownloadScheduler.h"
 #include "FileManager.h"
+#include "HaveAnnouncer.h"
+#include "IOEngine.h"
+#include "MembershipManager.h"
+#include "ResponseAggregator.h"
 #include "TCPServer.h"
 #include "UDPServer.h"
+#include "UploadScheduler.h"
 #include "Utils.h"
+#include "WorkStealingExecutor.h"
 #include <map>
+#include <memory>
 #include <string>
+#include <thread>
 #include <vector>
 
 
@@ -26,10 +40,39 @@ private:
     const int udp_port;                                                 ///< Porta UDP usada para descoberta de chunks de um arquivo.
     const int tcp_port;                                                 ///< Porta TCP usada para transferência de chunks de um arquivo.
     const int transfer_speed;                                           ///< Capacidade de transferência de dados do peer em bytes/segundo.
-    const std::vector<std::tuple<std::string, int>> neighbors;          ///< Lista de vizinhos diretos do peer, incluindo seus IPs e portas UDP.
+    const std::vector<std::tuple<std::string, int>> neighbors;          ///< Vizinhos iniciais do peer (topologia.txt), incluindo seus IPs e portas UDP.
+    const TimingConfig timing;                                          ///< Tempos de espera do protocolo.
+    const ThreadPlacement placement;                                    ///< Núcleos das threads de E/S e de processamento do peer (CpuTopology::getDefaultConfig() na criação).
+    WorkStealingExecutor executor;                                      ///< Executor compartilhado das mensagens UDP, dos recebimentos e gravações, dos envios e das montagens.
+    std::unique_ptr<IOEngine> io_engine;                                ///< E/S dos chunks em disco e nas conexões TCP (escolhida por IOEngine::getDefaultBackend()).
     FileManager file_manager;                                           ///< Gerenciador responsável por lidar com os arquivos e chunks do peer.
+    ChunkPersister chunk_persister;                                     ///< Gravador dos chunks recebidos via TCP, fora das tarefas das conexões.
+    DownloadJournal download_journal;                                   ///< Diário dos downloads em andamento, lido no início para retomá-los após um reinício.
     TCPServer tcp_server;                                               ///< Servidor TCP usado para transferir chunks de arquivos entre peers.
     UDPServer udp_server;                                               ///< Servidor UDP usado para descoberta de chunks de arquivos na rede P2P.
+    UploadScheduler upload_scheduler;                                   ///< Escalonador dos envios de chunks, com vagas limitadas e fila justa entre os solicitantes.
+    MembershipManager membership;                                       ///< Gerenciador da vizinhança (heartbeats, entrada e saída de vizinhos).
+    DHTNode dht;                                                        ///< Nó da DHT usado na descoberta dos arquivos em modo DHT.
+    ResponseAggregator aggregator;                                      ///< Agregador das respostas das descobertas no modo aggregate.
+    HaveAnnouncer have_announcer;                                       ///< Anunciante dos chunks recebidos aos peers que buscam o mesmo arquivo.
+    DownloadScheduler download_scheduler;                               ///< Escalonador responsável pela descoberta e solicitação de chunks dos arquivos buscados.
+    ControlServer control_server;                                       ///< Servidor de controle local usado no modo daemon.
+
+    /**
+     * @brief Cria uma thread do peer fixada nos núcleos do seu papel.
+     *
+     * @param role Papel da thread.
+     * @param index Índice da thread entre as do mesmo papel.
+     * @param function Função executada pela thread.
+     * @return Thread criada.
+     */
+    template <typename Function>
+    std::thread startThread(ThreadRole role, int index, Function function) {
+        return std::thread([cpus = placement.cpusFor(role, index), function] {
+            CpuTopology::pinCurrentThread(cpus);
+            function();
+        });
+    }
 
 public:
     /**
@@ -44,10 +87,14 @@ public:
      * @param tcp_port Porta TCP para transferência de chunks de um arquivo.
      * @param transfer_speed Capacidade de transferência em bytes/segundo.
      * @param neighbors Informações dos vizinhos do peer (IP, porta UDP).
+     * @param base_path Caminho base dos metadados e dos diretórios dos peers (padrão: Constants::BASE_PATH).
+     * @param timing Tempos de espera do protocolo (padrão: valores de Constants.h).
      */
     Peer(int id, const std::string& ip, int udp_port, 
          int tcp_port, int transfer_speed, 
-         const std::vector<std::tuple<std::string, int>> neighbors);
+         const std::vector<std::tuple<std::string, int>> neighbors,
+         const std::string& base_path = Constants::BASE_PATH,
+         const TimingConfig& timing = TimingConfig());
 
 
     /**
@@ -55,36 +102,72 @@ public:
      * 
      * Ativa e inicia os servidores TCP e UDP, permitindo que o peer se comunique 
      * na rede P2P para descoberta e transferência de chunks. Dá início a descoberta
-     * de chunks de um arquivo.
+     * de chunks de um arquivo. Os downloads interrompidos por um reinício, lidos do diário
+     * de downloads, são retomados junto com os arquivos informados. Em modo daemon, também
+     * inicia o servidor de controle local e permanece em execução aguardando novos comandos.
      * 
      * @param file_names Nomes dos arquivos que se deseja fazer a busca.
+     * @param daemon_mode Indica se o peer deve permanecer residente aceitando comandos pelo socket de controle.
      */
-    void start(const std::vector<std::string>& file_names);
+    void start(const std::vector<std::string>& file_names, bool daemon_mode = false);
 
 
     /**
-     * @brief Inicia a busca por chunks de um arquivo na rede.
+     * @brief Registra o download de um arquivo no escalonador de downloads.
      * 
-     * Busca chunks de um arquivo específico na rede P2P baseado no arquivo de metadados (.p2p).
-     * Utiliza o servidor UDP para descobrir peers que possuem os chunks do arquivo.
+     * Usado pelo modo daemon para iniciar buscas sem reiniciar o processo. Um arquivo que
+     * já está com a busca em andamento não é registrado novamente.
      * 
      * @param file_name Nome do arquivo que se deseja fazer a busca.
+     * @param priority Prioridade do download (maior é escalonado primeiro).
+     * @return true se o download foi registrado, false se já havia uma busca em andamento.
      */
-    void searchFile(const std::string& file_name);
+    bool submitDownload(const std::string& file_name, int priority = 0);
 
 
     /**
-     * @brief Inicia o processo de descoberta e solicitação de chunks.
+     * @brief Cancela o download de um arquivo.
      * 
-     * Este método envia uma mensagem de descoberta de chunks para encontrar peers 
-     * que possuam chunks de um arquivo específico. Em seguida, aguarda 
-     * pelas respostas e solicita os chunks disponíveis.
+     * A busca é interrompida na próxima etapa do escalonador (descoberta, espera por respostas
+     * ou solicitação de chunks) e as respostas para o arquivo deixam de ser processadas.
+     * 
+     * @param file_name Nome do arquivo cujo download será cancelado.
+     * @return true se o download estava em andamento e foi cancelado, false caso contrário.
+     */
+    bool cancelDownload(const std::string& file_name);
+
+
+    /**
+     * @brief Retorna o estado de todos os downloads conhecidos pelo peer.
      * 
-     * @param file_name Nome do arquivo cujos chunks estão sendo solicitados.
-     * @param total_chunks Número total de chunks do arquivo.
-     * @param initial_ttl Valor inicial do TTL (time-to-Live) da mensagem de descoberta.
+     * @return Vetor com o estado de cada download.
+     */
+    std::vector<DownloadStatus> getDownloadsStatus();
+
+
+    /**
+     * @brief Define o peer de bootstrap usado para entrar na rede quando o peer não tem vizinhos.
+     * 
+     * Deve ser chamado antes de start.
+     * 
+     * @param bootstrap_ip Endereço IP do peer de bootstrap.
+     * @param bootstrap_port Porta UDP do peer de bootstrap.
+     */
+    void setBootstrapPeer(const std::string& bootstrap_ip, int bootstrap_port);
+
+
+    /**
+     * @brief Retorna os vizinhos atuais do peer.
+     * 
+     * @return Vizinhos do peer (IP e Porta UDP).
+     */
+    std::vector<std::tuple<std::string, int>> getNeighbors();
+
+
+    /**
+     * @brief Anuncia aos vizinhos a saída do peer da rede.
      */
-    void discoverAndRequestChunks(const std::string& file_name, int total_chunks, int initial_ttl);
+    void leave();
 };
 
 #endif // PEER_H
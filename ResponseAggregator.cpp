@@ -0,0 +1,275 @@
+#include "ResponseAggregator.h"
+#include "Metrics.h"
+#include <algorithm>
+
+
+/**
+ * @brief Construtor da classe ResponseAggregator.
+ */
+ResponseAggregator::ResponseAggregator(const std::string& ip, int port, int peer_id, int transfer_speed, UDPServer& udp_server,
+                                       FileManager& file_manager, const TimingConfig& timing)
+    : ip(ip), port(port), peer_id(peer_id), transfer_speed(transfer_speed), udp_server(udp_server), file_manager(file_manager),
+      timing(timing), aggregations_changed(false) {}
+
+
+/**
+ * @brief Loop principal do agregador, que envia os resumos cujo prazo venceu.
+ */
+void ResponseAggregator::run() {
+    while (true) {
+        std::vector<std::tuple<std::tuple<std::string, int>, std::vector<std::string>>> pending;
+        std::unique_lock<std::mutex> lock(aggregations_mutex);
+
+        auto now = std::chrono::steady_clock::now();
+        auto next_deadline = now + timing.response_timeout;
+
+        for (auto it = aggregations.begin(); it != aggregations.end();) {
+            Aggregation& aggregation = it->second;
+
+            if (aggregation.deadline > now) {
+                next_deadline = std::min(next_deadline, aggregation.deadline);
+                ++it;
+            } else if (!aggregation.flushed) {
+                // Prazo vencido: o resumo segue para o peer anterior e o estado é mantido para as cópias atrasadas
+                pending.emplace_back(aggregation.upstream, buildAggregateMessages(it->first, aggregation));
+                aggregation.flushed = true;
+                aggregation.holders.clear();
+                aggregation.deadline = now + timing.response_timeout;
+                next_deadline = std::min(next_deadline, aggregation.deadline);
+                ++it;
+            } else {
+                it = aggregations.erase(it);
+            }
+        }
+
+        // Os envios são feitos fora do mutex para não atrasar o processamento das mensagens recebidas
+        lock.unlock();
+        for (const auto& [upstream, messages] : pending) {
+            const auto& [upstream_ip, upstream_port] = upstream;
+            for (const std::string& message : messages) {
+                udp_server.sendUDPMessage(upstream_ip, upstream_port, message);
+            }
+        }
+        lock.lock();
+
+        // Espera o próximo prazo ou o registro de uma nova busca, que pode ter um prazo mais curto
+        aggregations_cv.wait_until(lock, next_deadline, [this] { return aggregations_changed; });
+        aggregations_changed = false;
+    }
+}
+
+
+/**
+ * @brief Registra uma busca em agregação recebida em uma mensagem DISCOVERY.
+ */
+bool ResponseAggregator::beginAggregation(uint64_t search_id, const std::string& file_name, int total_chunks, int ttl,
+                                          std::chrono::milliseconds window, const PeerInfo& upstream_info) {
+    if (total_chunks <= 0) {
+        return false;
+    }
+
+    // Os chunks locais entram no resumo como os de qualquer outro detentor
+    std::vector<bool> local_bitmap(total_chunks, false);
+    bool has_chunks = false;
+    for (int chunk : file_manager.getAvailableChunks(file_name)) {
+        if (chunk >= 0 && chunk < total_chunks) {
+            local_bitmap[chunk] = true;
+            has_chunks = true;
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(aggregations_mutex);
+
+    // Cópias da mesma busca chegam por outros caminhos da inundação e são descartadas
+    auto [it, inserted] = aggregations.try_emplace(search_id);
+    if (!inserted) {
+        return false;
+    }
+
+    Aggregation& aggregation = it->second;
+    aggregation.file_name = file_name;
+    aggregation.total_chunks = total_chunks;
+    aggregation.upstream = std::make_tuple(upstream_info.ip, upstream_info.port);
+    aggregation.deadline = std::chrono::steady_clock::now() + ttl * window;
+    aggregation.flushed = false;
+    if (has_chunks) {
+        aggregation.holders[std::make_tuple(ip, port)] = std::make_tuple(transfer_speed, local_bitmap);
+    }
+
+    aggregations_changed = true;
+    aggregations_cv.notify_one();
+    return true;
+}
+
+
+/**
+ * @brief Processa uma mensagem AGGREGATE recebida de um peer seguinte no caminho.
+ */
+void ResponseAggregator::processAggregateMessage(const AggregateMessage& message, const PeerInfo& direct_sender_info) {
+    std::string file_name(message.file_name);
+    uint64_t search_id = message.search_id;
+    std::vector<std::tuple<std::string, int, int, std::vector<bool>>> entries;
+
+    // Cada detentor ocupa três palavras: "ip:porta velocidade bitmap"
+    MessageTokenizer holders(message.holders);
+    std::string_view address, holder_ip, bitmap_text;
+    int holder_port, speed;
+    while (holders.next(address)) {
+        std::vector<bool> bitmap;
+        if (!MessageParser::parseAddress(address, holder_ip, holder_port) || !holders.nextNumber(speed) ||
+            !holders.next(bitmap_text) || !decodeBitmap(bitmap_text, bitmap)) {
+            LOG_MESSAGE(LogType::ERROR, "Mensagem AGGREGATE mal formada recebida do Peer " + direct_sender_info.ip + ":" +
+                        std::to_string(direct_sender_info.port));
+            return;
+        }
+        entries.emplace_back(std::string(holder_ip), holder_port, speed, std::move(bitmap));
+    }
+
+    // Os detentores que passam pelo peer ficam no cache de disponibilidade para as suas próximas buscas
+    for (const auto& [holder_ip, holder_port, holder_speed, bitmap] : entries) {
+        if (holder_ip == ip && holder_port == port) {
+            continue;
+        }
+        std::vector<int> chunks;
+        for (int chunk = 0; chunk < static_cast<int>(bitmap.size()); ++chunk) {
+            if (bitmap[chunk]) {
+                chunks.push_back(chunk);
+            }
+        }
+        file_manager.rememberChunkAvailability(file_name, chunks, holder_ip, holder_port, holder_speed);
+    }
+
+    std::tuple<std::string, int> upstream;
+    {
+        std::lock_guard<std::mutex> lock(aggregations_mutex);
+
+        auto it = aggregations.find(search_id);
+        if (it != aggregations.end() && !it->second.flushed) {
+            // Dentro do prazo: une os bitmaps de cada detentor ao resumo local
+            Aggregation& aggregation = it->second;
+            for (const auto& [holder_ip, holder_port, holder_speed, bitmap] : entries) {
+                auto& [stored_speed, stored_bitmap] = aggregation.holders[std::make_tuple(holder_ip, holder_port)];
+                stored_speed = holder_speed;
+                stored_bitmap.resize(aggregation.total_chunks, false);
+                for (size_t chunk = 0; chunk < bitmap.size() && chunk < stored_bitmap.size(); ++chunk) {
+                    if (bitmap[chunk]) {
+                        stored_bitmap[chunk] = true;
+                    }
+                }
+            }
+            return;
+        }
+
+        if (it != aggregations.end()) {
+            upstream = it->second.upstream;
+        }
+    }
+
+    // Resumo atrasado: o resumo local já foi enviado, então este segue direto para o peer anterior
+    if (!std::get<0>(upstream).empty()) {
+        udp_server.sendUDPMessage(std::get<0>(upstream), std::get<1>(upstream), std::string(message.text));
+        return;
+    }
+
+    // Sem estado da busca: o peer é o solicitante e grava os detentores como as respostas RESPONSE
+    if (!udp_server.isProcessingActive(file_name)) {
+        LOG_MESSAGE(LogType::OTHER, "Mensagem AGGREGATE recebida para " + file_name + ", mas o processamento está desativado.");
+        return;
+    }
+
+    Metrics::instance().stopTimer(Histogram::DISCOVERY_TO_FIRST_RESPONSE_MS, peer_id, file_name);
+
+    int total_chunks = file_manager.getTotalChunks(file_name);
+    for (const auto& [holder_ip, holder_port, holder_speed, bitmap] : entries) {
+        if (holder_ip == ip && holder_port == port) {
+            continue;
+        }
+
+        std::vector<int> chunks_received;
+        for (int chunk = 0; chunk < static_cast<int>(bitmap.size()) && chunk < total_chunks; ++chunk) {
+            if (bitmap[chunk] && !file_manager.hasChunk(file_name, chunk)) {
+                chunks_received.push_back(chunk);
+            }
+        }
+
+        if (!chunks_received.empty()) {
+            file_manager.storeChunkLocationInfo(file_name, chunks_received, holder_ip, holder_port, holder_speed);
+            LOG_MESSAGE(LogType::RESPONSE_RECEIVED,
+                        "Recebido resumo agregado via Peer " + direct_sender_info.ip + ":" + std::to_string(direct_sender_info.port) +
+                        " para o arquivo '" + file_name + "': Peer " + holder_ip + ":" + std::to_string(holder_port) + " possui " +
+                        std::to_string(chunks_received.size()) + " chunks faltantes.");
+        }
+    }
+}
+
+
+/**
+ * @brief Escreve um bitmap de chunks em hexadecimal.
+ */
+std::string ResponseAggregator::encodeBitmap(const std::vector<bool>& bitmap) {
+    static const char digits[] = "0123456789abcdef";
+    std::string text((bitmap.size() + 3) / 4, '0');
+
+    for (size_t chunk = 0; chunk < bitmap.size(); ++chunk) {
+        if (bitmap[chunk]) {
+            size_t digit = chunk / 4;
+            int value = (text[digit] <= '9' ? text[digit] - '0' : text[digit] - 'a' + 10) | (1 << (chunk % 4));
+            text[digit] = digits[value];
+        }
+    }
+    return text;
+}
+
+
+/**
+ * @brief Lê um bitmap de chunks escrito por encodeBitmap.
+ */
+bool ResponseAggregator::decodeBitmap(std::string_view text, std::vector<bool>& bitmap) {
+    bitmap.assign(text.size() * 4, false);
+
+    for (size_t digit = 0; digit < text.size(); ++digit) {
+        char c = text[digit];
+        int value;
+        if (c >= '0' && c <= '9') {
+            value = c - '0';
+        } else if (c >= 'a' && c <= 'f') {
+            value = c - 'a' + 10;
+        } else {
+            return false;
+        }
+
+        for (int bit = 0; bit < 4; ++bit) {
+            bitmap[digit * 4 + bit] = (value >> bit) & 1;
+        }
+    }
+    return !text.empty();
+}
+
+
+/**
+ * @brief Monta as mensagens AGGREGATE do resumo de uma busca.
+ */
+std::vector<std::string> ResponseAggregator::buildAggregateMessages(uint64_t search_id, const Aggregation& aggregation) {
+    std::vector<std::string> messages;
+    const std::string header = "AGGREGATE " + aggregation.file_name + " " + std::to_string(search_id);
+    std::string message = header;
+
+    for (const auto& [holder, entry] : aggregation.holders) {
+        const auto& [holder_ip, holder_port] = holder;
+        const auto& [holder_speed, bitmap] = entry;
+
+        std::string item = " " + holder_ip + ":" + std::to_string(holder_port) + " " + std::to_string(holder_speed) + " " + encodeBitmap(bitmap);
+
+        // Um detentor que não cabe na mensagem atual inicia a próxima
+        if (message.size() + item.size() > static_cast<size_t>(Constants::CONTROL_MESSAGE_MAX_SIZE - 1) && message.size() > header.size()) {
+            messages.push_back(message);
+            message = header;
+        }
+        message += item;
+    }
+
+    if (message.size() > header.size()) {
+        messages.push_back(message);
+    }
+    return messages;
+}
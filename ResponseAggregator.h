@@ -0,0 +1,147 @@
+#ifndef RESPONSEAGGREGATOR_H
+#define RESPONSEAGGREGATOR_H
+
+#include "FileManager.h"
+#include "MessageParser.h"
+#include "UDPServer.h"
+#include "Utils.h"
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <tuple>
+#include <vector>
+
+
+/**
+ * @brief Classe que agrega as respostas de uma descoberta ao longo do caminho reverso da inundação.
+ *
+ * Para os arquivos com o modo "aggregate" no .p2p, a mensagem DISCOVERY leva um identificador de
+ * busca e a janela por salto escolhida pelo solicitante. Em vez de cada peer alcançado responder
+ * diretamente ao solicitante, cada peer guarda quem lhe entregou a descoberta (o peer anterior no
+ * caminho), ignora as cópias repetidas da mesma busca e, durante ttl * janela, junta os próprios
+ * chunks e os resumos recebidos dos peers seguintes em um bitmap por detentor. Ao fim do prazo,
+ * envia um único resumo ao peer anterior:
+ *
+ *  - AGGREGATE <arquivo> <busca> <ip:porta> <velocidade> <bitmap> ...
+ *
+ * O bitmap é escrito em hexadecimal, quatro chunks por dígito (o chunk i é o bit i % 4 do dígito
+ * i / 4). Como o TTL diminui a cada salto, os peers mais distantes encerram primeiro e os resumos
+ * chegam a tempo de serem unidos. Um resumo que chega depois do envio segue direto para o peer
+ * anterior, e o solicitante grava os detentores recebidos como as respostas RESPONSE.
+ */
+class ResponseAggregator {
+private:
+    /**
+     * @brief Estrutura com o estado de uma busca em agregação no peer.
+     */
+    struct Aggregation {
+        std::string file_name;                                                          ///< Nome do arquivo buscado.
+        int total_chunks;                                                               ///< Número total de chunks do arquivo.
+        std::tuple<std::string, int> upstream;                                          ///< Peer anterior no caminho, que recebe o resumo (IP e porta UDP).
+        std::map<std::tuple<std::string, int>, std::tuple<int, std::vector<bool>>> holders;  ///< Velocidade e bitmap de chunks de cada detentor.
+        std::chrono::steady_clock::time_point deadline;                                 ///< Prazo do envio do resumo ou, após o envio, do descarte do estado.
+        bool flushed;                                                                   ///< Indica que o resumo já foi enviado.
+    };
+
+    const std::string ip;                                               ///< Endereço IP do peer atual.
+    const int port;                                                     ///< Porta UDP do peer atual.
+    const int peer_id;                                                  ///< Identificador único (ID) do peer.
+    const int transfer_speed;                                           ///< Velocidade de transferência em bytes/segundo anunciada nos resumos.
+    UDPServer& udp_server;                                              ///< Referência ao servidor UDP do peer.
+    FileManager& file_manager;                                          ///< Referência ao gerenciador de arquivos do peer.
+    const TimingConfig timing;                                          ///< Tempos de espera do protocolo.
+    std::map<uint64_t, Aggregation> aggregations;                       ///< Buscas em agregação, por identificador de busca.
+    bool aggregations_changed;                                          ///< Indica que uma busca foi registrada desde a última verificação dos prazos.
+    std::mutex aggregations_mutex;                                      ///< Mutex para proteger as buscas em agregação.
+    std::condition_variable aggregations_cv;                            ///< Acorda o loop de envio quando uma nova busca é registrada.
+
+public:
+    /**
+     * @brief Construtor da classe ResponseAggregator.
+     *
+     * @param ip Endereço IP do peer.
+     * @param port Porta UDP do peer.
+     * @param peer_id ID do peer.
+     * @param transfer_speed Velocidade de transferência em bytes/segundo do peer.
+     * @param udp_server Referência ao servidor UDP do peer.
+     * @param file_manager Referência ao gerenciador de arquivos do peer.
+     * @param timing Tempos de espera do protocolo (padrão: valores de Constants.h).
+     */
+    ResponseAggregator(const std::string& ip, int port, int peer_id, int transfer_speed, UDPServer& udp_server,
+                       FileManager& file_manager, const TimingConfig& timing = TimingConfig());
+
+
+    /**
+     * @brief Loop principal do agregador, que envia os resumos cujo prazo venceu.
+     *
+     * O estado de uma busca é mantido por response_timeout após o envio, para que as cópias
+     * atrasadas da descoberta continuem sendo ignoradas e os resumos atrasados sejam repassados.
+     */
+    void run();
+
+
+    /**
+     * @brief Registra uma busca em agregação recebida em uma mensagem DISCOVERY.
+     *
+     * @param search_id Identificador da busca.
+     * @param file_name Nome do arquivo buscado.
+     * @param total_chunks Número total de chunks do arquivo.
+     * @param ttl TTL recebido na mensagem, que define o prazo do resumo (ttl * janela).
+     * @param window Janela por salto escolhida pelo solicitante.
+     * @param upstream_info Peer que entregou a descoberta, que receberá o resumo.
+     * @return true se a busca é nova e a descoberta deve ser propagada, false para uma cópia repetida.
+     */
+    bool beginAggregation(uint64_t search_id, const std::string& file_name, int total_chunks, int ttl,
+                          std::chrono::milliseconds window, const PeerInfo& upstream_info);
+
+
+    /**
+     * @brief Processa uma mensagem AGGREGATE recebida de um peer seguinte no caminho.
+     *
+     * O resumo é unido ao da busca se o prazo ainda não venceu, repassado ao peer anterior se o
+     * resumo local já foi enviado, ou gravado nas informações de localização dos chunks quando
+     * o peer é o solicitante. Em todos os casos, os detentores vão para o cache de disponibilidade.
+     *
+     * @param message Campos da mensagem, lidos pelo MessageParser (os detentores são lidos aqui).
+     * @param direct_sender_info Informações sobre o peer que enviou diretamente a mensagem (IP e porta UDP).
+     */
+    void processAggregateMessage(const AggregateMessage& message, const PeerInfo& direct_sender_info);
+
+
+    /**
+     * @brief Escreve um bitmap de chunks em hexadecimal (o chunk i é o bit i % 4 do dígito i / 4).
+     *
+     * @param bitmap Bitmap de chunks.
+     * @return Texto hexadecimal com um dígito para cada quatro chunks.
+     */
+    static std::string encodeBitmap(const std::vector<bool>& bitmap);
+
+
+    /**
+     * @brief Lê um bitmap de chunks escrito por encodeBitmap.
+     *
+     * @param text Texto hexadecimal.
+     * @param bitmap Bitmap que recebe os chunks (com quatro posições por dígito).
+     * @return true se o texto é válido.
+     */
+    static bool decodeBitmap(std::string_view text, std::vector<bool>& bitmap);
+
+private:
+    /**
+     * @brief Monta as mensagens AGGREGATE do resumo de uma busca.
+     *
+     * Os detentores são divididos em quantas mensagens forem necessárias para respeitar
+     * Constants::CONTROL_MESSAGE_MAX_SIZE bytes.
+     *
+     * @param search_id Identificador da busca.
+     * @param aggregation Estado da busca.
+     * @return Mensagens formatadas (vazio se nenhum detentor foi encontrado).
+     */
+    static std::vector<std::string> buildAggregateMessages(uint64_t search_id, const Aggregation& aggregation);
+};
+
+#endif // RESPONSEAGGREGATOR_H
@@ -0,0 +1,196 @@
+#include "Sha256.h"
+#include <algorithm>
+#include <cstring>
+
+
+namespace {
+    // Constantes das 64 rodadas: partes fracionárias das raízes cúbicas dos 64 primeiros primos
+    const uint32_t ROUND_CONSTANTS[64] = {
+        0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+        0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+        0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+        0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+        0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+        0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+        0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+        0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+    };
+
+
+    /**
+     * @brief Rotação de 32 bits para a direita.
+     */
+    inline uint32_t rotateRight(uint32_t value, int bits) {
+        return (value >> bits) | (value << (32 - bits));
+    }
+}
+
+
+/**
+ * @brief Construtor da classe Sha256.
+ */
+Sha256::Sha256()
+    : state{0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19}, length(0), block_size(0) {}
+
+
+/**
+ * @brief Processa um bloco completo de 64 bytes.
+ */
+void Sha256::transform(const uint8_t* data) {
+    uint32_t w[64];
+    for (int i = 0; i < 16; ++i) {
+        w[i] = (static_cast<uint32_t>(data[4 * i]) << 24) | (static_cast<uint32_t>(data[4 * i + 1]) << 16) |
+               (static_cast<uint32_t>(data[4 * i + 2]) << 8) | static_cast<uint32_t>(data[4 * i + 3]);
+    }
+    for (int i = 16; i < 64; ++i) {
+        uint32_t s0 = rotateRight(w[i - 15], 7) ^ rotateRight(w[i - 15], 18) ^ (w[i - 15] >> 3);
+        uint32_t s1 = rotateRight(w[i - 2], 17) ^ rotateRight(w[i - 2], 19) ^ (w[i - 2] >> 10);
+        w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+    }
+
+    uint32_t a = state[0], b = state[1], c = state[2], d = state[3];
+    uint32_t e = state[4], f = state[5], g = state[6], h = state[7];
+    for (int i = 0; i < 64; ++i) {
+        uint32_t s1 = rotateRight(e, 6) ^ rotateRight(e, 11) ^ rotateRight(e, 25);
+        uint32_t choice = (e & f) ^ (~e & g);
+        uint32_t temp1 = h + s1 + choice + ROUND_CONSTANTS[i] + w[i];
+        uint32_t s0 = rotateRight(a, 2) ^ rotateRight(a, 13) ^ rotateRight(a, 22);
+        uint32_t majority = (a & b) ^ (a & c) ^ (b & c);
+        uint32_t temp2 = s0 + majority;
+
+        h = g;
+        g = f;
+        f = e;
+        e = d + temp1;
+        d = c;
+        c = b;
+        b = a;
+        a = temp1 + temp2;
+    }
+
+    state[0] += a;
+    state[1] += b;
+    state[2] += c;
+    state[3] += d;
+    state[4] += e;
+    state[5] += f;
+    state[6] += g;
+    state[7] += h;
+}
+
+
+/**
+ * @brief Acrescenta bytes ao resumo.
+ */
+void Sha256::update(const char* data, size_t size) {
+    const uint8_t* bytes = reinterpret_cast<const uint8_t*>(data);
+    length += size;
+
+    // Completa o bloco pendente antes de processar os blocos inteiros direto da entrada
+    if (block_size > 0) {
+        size_t copied = std::min(size, sizeof(block) - block_size);
+        std::memcpy(block + block_size, bytes, copied);
+        block_size += copied;
+        bytes += copied;
+        size -= copied;
+        if (block_size < sizeof(block)) {
+            return;
+        }
+        transform(block);
+        block_size = 0;
+    }
+
+    for (; size >= sizeof(block); bytes += sizeof(block), size -= sizeof(block)) {
+        transform(bytes);
+    }
+
+    std::memcpy(block, bytes, size);
+    block_size = size;
+}
+
+
+/**
+ * @brief Conclui o resumo com o preenchimento final.
+ */
+Sha256::Digest Sha256::finish() {
+    uint64_t bit_length = length * 8;
+
+    // Preenchimento: o bit 1, zeros até 56 bytes no último bloco e o tamanho em bits (big-endian)
+    static const char PADDING[64] = {static_cast<char>(0x80)};
+    size_t padding = block_size < 56 ? 56 - block_size : 120 - block_size;
+    update(PADDING, padding);
+
+    char encoded_length[8];
+    for (int i = 0; i < 8; ++i) {
+        encoded_length[i] = static_cast<char>(bit_length >> (56 - 8 * i));
+    }
+    update(encoded_length, sizeof(encoded_length));
+
+    Digest digest;
+    for (int i = 0; i < 8; ++i) {
+        digest[4 * i] = static_cast<uint8_t>(state[i] >> 24);
+        digest[4 * i + 1] = static_cast<uint8_t>(state[i] >> 16);
+        digest[4 * i + 2] = static_cast<uint8_t>(state[i] >> 8);
+        digest[4 * i + 3] = static_cast<uint8_t>(state[i]);
+    }
+    return digest;
+}
+
+
+/**
+ * @brief Calcula o resumo de um bloco de bytes.
+ */
+Sha256::Digest Sha256::hash(const char* data, size_t size) {
+    Sha256 sha;
+    sha.update(data, size);
+    return sha.finish();
+}
+
+
+/**
+ * @brief Converte um resumo para 64 dígitos hexadecimais.
+ */
+std::string Sha256::toHex(const Digest& digest) {
+    static const char DIGITS[] = "0123456789abcdef";
+
+    std::string text(digest.size() * 2, '0');
+    for (size_t i = 0; i < digest.size(); ++i) {
+        text[2 * i] = DIGITS[digest[i] >> 4];
+        text[2 * i + 1] = DIGITS[digest[i] & 0x0f];
+    }
+    return text;
+}
+
+
+/**
+ * @brief Lê um resumo de 64 dígitos hexadecimais.
+ */
+bool Sha256::fromHex(std::string_view text, Digest& digest) {
+    if (text.size() != digest.size() * 2) {
+        return false;
+    }
+
+    auto nibble = [](char c) {
+        if (c >= '0' && c <= '9') {
+            return c - '0';
+        }
+        if (c >= 'a' && c <= 'f') {
+            return c - 'a' + 10;
+        }
+        if (c >= 'A' && c <= 'F') {
+            return c - 'A' + 10;
+        }
+        return -1;
+    };
+
+    Digest parsed;
+    for (size_t i = 0; i < parsed.size(); ++i) {
+        int high = nibble(text[2 * i]), low = nibble(text[2 * i + 1]);
+        if (high < 0 || low < 0) {
+            return false;
+        }
+        parsed[i] = static_cast<uint8_t>((high << 4) | low);
+    }
+    digest = parsed;
+    return true;
+}
@@ -0,0 +1,78 @@
+#ifndef SHA256_H
+#define SHA256_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+
+/**
+ * @brief Classe que calcula o resumo SHA-256 (FIPS 180-4) de uma sequência de bytes.
+ *
+ * Usada para identificar o conteúdo dos chunks no .p2p. Os bytes podem ser entregues em
+ * partes com update; o resumo é obtido uma única vez com finish.
+ */
+class Sha256 {
+public:
+    using Digest = std::array<uint8_t, 32>;                 ///< Resumo de 256 bits.
+
+private:
+    uint32_t state[8];                                      ///< Estado intermediário (H0 a H7).
+    uint64_t length;                                        ///< Número de bytes recebidos.
+    uint8_t block[64];                                      ///< Bytes do bloco ainda incompleto.
+    size_t block_size;                                      ///< Número de bytes em block.
+
+    /**
+     * @brief Processa um bloco completo de 64 bytes.
+     */
+    void transform(const uint8_t* data);
+
+public:
+    /**
+     * @brief Construtor da classe Sha256, com o estado inicial do algoritmo.
+     */
+    Sha256();
+
+
+    /**
+     * @brief Acrescenta bytes ao resumo.
+     *
+     * @param data Bytes.
+     * @param size Número de bytes.
+     */
+    void update(const char* data, size_t size);
+
+
+    /**
+     * @brief Conclui o resumo com o preenchimento final.
+     *
+     * @return Resumo dos bytes recebidos.
+     */
+    Digest finish();
+
+
+    /**
+     * @brief Calcula o resumo de um bloco de bytes.
+     */
+    static Digest hash(const char* data, size_t size);
+
+
+    /**
+     * @brief Converte um resumo para 64 dígitos hexadecimais.
+     */
+    static std::string toHex(const Digest& digest);
+
+
+    /**
+     * @brief Lê um resumo de 64 dígitos hexadecimais.
+     *
+     * @param text Texto com o resumo.
+     * @param digest Recebe o resumo.
+     * @return true se o texto tem exatamente 64 dígitos hexadecimais.
+     */
+    static bool fromHex(std::string_view text, Digest& digest);
+};
+
+#endif // SHA256_H
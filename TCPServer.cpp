@@ -1,20 +1,33 @@
 #include "TCPServer.h"
+#include "ChunkPersister.h"
+#include "DownloadJournal.h"
+#include "Metrics.h"
+#include <fcntl.h>
 #include <sys/socket.h>
+#include <sys/stat.h>
 #include <netinet/in.h>
 #include <unistd.h>
+#include <algorithm>
+#include <cstdio>
 #include <cstring>
 #include <iostream>
 #include <thread>
 #include <chrono>
 #include <arpa/inet.h>
 #include <sstream>
-#include <fstream>
+#include <deque>
+#include <future>
+#include <limits>
+#include <memory>
 
 /**
  * @brief Construtor da classe TCPServer.
  */
-TCPServer::TCPServer(const std::string& ip, int port, int peer_id, int transfer_speed, FileManager& file_manager)
-    : ip(ip), port(port), peer_id(peer_id), transfer_speed(transfer_speed), file_manager(file_manager) {
+TCPServer::TCPServer(const std::string& ip, int port, int peer_id, int transfer_speed, FileManager& file_manager, WorkStealingExecutor& executor,
+                     const TimingConfig& timing)
+    : ip(ip), port(port), peer_id(peer_id), transfer_speed(transfer_speed), file_manager(file_manager), executor(executor), chunk_persister(nullptr),
+      io_engine(&IOEngine::blockingEngine()), download_journal(nullptr), read_executor(Constants::TRANSFER_READ_THREADS), timing(timing),
+      compression_mode(Compression::getDefaultMode()), max_receives(std::max(1, CpuTopology::getDefaultConfig().io_threads)), active_receives(0) {
     
     // Cria um socket TCP IPv4 (SOCK_STREAM) especificando explicitamente o protocolo TCP (IPPROTO_TCP)
     // Nota: SOCK_STREAM já indica o uso de TCP, mas IPPROTO_TCP é passado para maior clareza e compatibilidade
@@ -36,7 +49,39 @@ TCPServer::TCPServer(const std::string& ip, int port, int peer_id, int transfer_
         exit(EXIT_FAILURE);
     }
 
-    logMessage(LogType::INFO, "Servidor TCP inicializado em " + ip + ":" + std::to_string(port));
+    LOG_MESSAGE(LogType::INFO, "Servidor TCP inicializado em " + ip + ":" + std::to_string(port));
+}
+
+
+/**
+ * @brief Associa o gravador que salva os chunks recebidos fora da thread da conexão.
+ */
+void TCPServer::setChunkPersister(ChunkPersister* chunk_persister) {
+    this->chunk_persister = chunk_persister;
+}
+
+
+/**
+ * @brief Associa a implementação de E/S usada na leitura, no envio e no recebimento dos chunks.
+ */
+void TCPServer::setIOEngine(IOEngine* io_engine) {
+    this->io_engine = io_engine;
+}
+
+
+/**
+ * @brief Associa o diário dos downloads, que registra os bytes dos chunks grandes gravados no arquivo parcial durante o recebimento.
+ */
+void TCPServer::setDownloadJournal(DownloadJournal* download_journal) {
+    this->download_journal = download_journal;
+}
+
+
+/**
+ * @brief Fixa as threads de leitura antecipada nos núcleos de E/S do peer.
+ */
+void TCPServer::setThreadPlacement(const ThreadPlacement& placement) {
+    read_executor.pin(placement, ThreadRole::IO);
 }
 
 
@@ -53,8 +98,15 @@ void TCPServer::run() {
         int client_sockfd = accept(server_sockfd, (struct sockaddr*)&client_addr, &addr_len);
 
         if (client_sockfd >= 0) {
-            // Cria uma thread para lidar com o recebimento dos chunks
-            std::thread(&TCPServer::receiveChunks, this, client_sockfd).detach();
+            // Entrega a conexão a uma tarefa de recebimento; além de max_receives, as conexões esperam na fila,
+            // e o remetente fica bloqueado no envio até que uma tarefa termine
+            std::lock_guard<std::mutex> receive_lock(receive_mutex);
+            if (active_receives < max_receives) {
+                ++active_receives;
+                executor.submit(TaskPriority::TRANSFER, [this, client_sockfd] { receiveConnection(client_sockfd); });
+            } else {
+                waiting_connections.push_back(client_sockfd);
+            }
         } else {
             perror("Erro ao aceitar conexão TCP");
         }
@@ -62,6 +114,24 @@ void TCPServer::run() {
 }
 
 
+/**
+ * @brief Tarefa de recebimento: recebe os chunks de uma conexão e, se houver conexões aguardando, submete a próxima.
+ */
+void TCPServer::receiveConnection(int client_sockfd) {
+    receiveChunks(client_sockfd);
+
+    // A próxima conexão vira uma nova tarefa, para que as tarefas de maior prioridade passem à frente entre duas conexões
+    std::lock_guard<std::mutex> receive_lock(receive_mutex);
+    if (waiting_connections.empty()) {
+        --active_receives;
+        return;
+    }
+    int next_sockfd = waiting_connections.front();
+    waiting_connections.pop_front();
+    executor.submit(TaskPriority::TRANSFER, [this, next_sockfd] { receiveConnection(next_sockfd); });
+}
+
+
 /**
  * @brief Recebe chunks enviados por um peer e ao receber todos, monta o arquivo final.
  */
@@ -85,8 +155,8 @@ void TCPServer::receiveChunks(int client_sockfd) {
 
         // Recebe a mensagem de controle em pedaços
         do {
-            // Recebe os dados
-            control_message_size = recv(client_sockfd, control_message_buffer, Constants::CONTROL_MESSAGE_MAX_SIZE, 0);
+            // Recebe os dados, sem avançar sobre os bytes do chunk que vem em seguida
+            control_message_size = recv(client_sockfd, control_message_buffer, Constants::CONTROL_MESSAGE_MAX_SIZE - control_message_total_bytes_received, 0);
 
             // Verifica se houve erro ou o cliente fechou a conexão
             if (control_message_size < 0) {
@@ -94,7 +164,7 @@ void TCPServer::receiveChunks(int client_sockfd) {
                 close(client_sockfd);
                 return;
             } else if (control_message_size == 0) {
-                logMessage(LogType::INFO, "Conexão fechada pelo cliente.");
+                LOG_MESSAGE(LogType::INFO, "Conexão fechada pelo cliente.");
                 close(client_sockfd);
                 return;
             }
@@ -104,74 +174,120 @@ void TCPServer::receiveChunks(int client_sockfd) {
                 control_message.append(control_message_buffer, control_message_size);
                 control_message_total_bytes_received += control_message_size;
             
-                logMessage(LogType::INFO, "Recebido " + std::to_string(control_message_size) + " bytes da mensagem de controle de " + client_ip + ":" + std::to_string(client_port) + " (" + std::to_string(control_message_total_bytes_received) + "/" + std::to_string(Constants::CONTROL_MESSAGE_MAX_SIZE) + " bytes).");
+                LOG_MESSAGE(LogType::CHUNK_RECEIVED, "Recebido " + std::to_string(control_message_size) + " bytes da mensagem de controle de " + client_ip + ":" + std::to_string(client_port) + " (" + std::to_string(control_message_total_bytes_received) + "/" + std::to_string(Constants::CONTROL_MESSAGE_MAX_SIZE) + " bytes).");
             }
 
         } while (control_message_total_bytes_received < Constants::CONTROL_MESSAGE_MAX_SIZE); // Continua recebendo até que a mensagem de controle esteja completa
 
-        logMessage(LogType::INFO, "Mensagem de controle '" + control_message + "' recebida de " + client_ip + ":" + std::to_string(client_port));
+        LOG_MESSAGE(LogType::INFO, "Mensagem de controle '" + control_message + "' recebida de " + client_ip + ":" + std::to_string(client_port));
         
-        // Transforma a string da mensagem de controle em um stream para extração
-        std::stringstream control_message_stream(control_message);
+        // Transforma a string da mensagem de controle em um stream para extração, até os nulos do preenchimento
+        std::stringstream control_message_stream(control_message.c_str());
 
         // Variáveis para armazenar os valores da mensagem de controle
-        std::string command, file_name;
-        int chunk_id, transfer_speed;
-        size_t chunk_size;
+        std::string command, file_name, codec_name = "none";
+        int chunk_id = 0, transfer_speed = 0;
+        size_t chunk_size = 0, raw_size = 0, offset = 0;
 
-        // Extrai os valores da mensagem de controle
-        control_message_stream >> command >> file_name >> chunk_id >> transfer_speed >> chunk_size;
+        // Extrai os valores da mensagem de controle; o formato e o tamanho original só vêm nos chunks comprimidos
+        // ou retomados, e o byte inicial só nos retomados
+        control_message_stream >> command >> file_name >> chunk_id >> transfer_speed >> chunk_size >> codec_name >> raw_size >> offset;
 
         // Verifica se o comando é "PUT", que indica recebimento de chunk de arquivo
         if (command == "PUT") {
-            // Cria um buffer para armazenar o chunk completo
-            char chunk_buffer[chunk_size] = {0};
-
-            // Quantidade de quantos bytes do chunk foram recebidos
-            size_t chunk_total_bytes_received = 0;
-
-            // Continua recebendo o chunk até alcançar o tamanho esperado
-            while (chunk_total_bytes_received < chunk_size) {
-                // Quantidade de bytes realmente recebido no recv
-                ssize_t chunk_bytes_received = 0;
-
-                // Buffer temporário para armazenar os dados recebidos
-                char chunk_temp_buffer[transfer_speed] = {0};
-
-                // Recebe os dados do chunk
-                chunk_bytes_received = recv(client_sockfd, chunk_temp_buffer, transfer_speed, 0);
-
-                // Verifica se houve erro ou o cliente fechou a conexão
-                if (chunk_bytes_received < 0) {
-                    perror("Erro ao receber o chunk.");
-                    close(client_sockfd);
-                    return;
-                } else if (chunk_bytes_received == 0) {
-                    logMessage(LogType::INFO, "Conexão fechada pelo cliente.");
-                    close(client_sockfd);
-                    return;
-                }
+            // Sem compressão, os bytes enviados são os próprios bytes do chunk
+            bool compressed = codec_name != Compression::codecToString(CompressionCodec::NONE);
+            if (!compressed) {
+                raw_size = chunk_size;
+            }
+
+            // Os tamanhos do cabeçalho definem os buffers alocados, então são conferidos antes: o chunk (início retomado
+            // mais bytes enviados) não passa do tamanho do resumo do .p2p, ou do limite geral, e os bytes comprimidos não
+            // passam do pior caso do formato. Um cabeçalho inválido encerra a conexão, pois não se sabe quantos bytes pular
+            CompressionCodec codec = CompressionCodec::NONE;
+            ChunkDescriptor descriptor;
+            size_t max_chunk_size = file_manager.getChunkDescriptor(file_name, chunk_id, descriptor) ? descriptor.size : Constants::TRANSFER_MAX_CHUNK_BYTES;
+            bool valid_codec = !compressed || (Compression::parseCodec(codec_name, codec) && Compression::isAvailable(codec));
+            if (!valid_codec || offset > max_chunk_size || raw_size > max_chunk_size - offset ||
+                (compressed && chunk_size > Compression::maxCompressedSize(codec, raw_size))) {
+                LOG_MESSAGE(LogType::ERROR, "PUT inválido do chunk " + std::to_string(chunk_id) + " de " + client_ip + ":" + std::to_string(client_port) + " (formato " +
+                            codec_name + ", " + std::to_string(chunk_size) + " bytes enviados, " + std::to_string(raw_size) + " bytes do chunk, início " +
+                            std::to_string(offset) + "). A conexão foi encerrada.");
+                close(client_sockfd);
+                return;
+            }
 
-                if (chunk_bytes_received > 0) {
-                    // Copia os dados recebidos para o buffer principal do chunk
-                    std::memcpy(chunk_buffer + chunk_total_bytes_received, chunk_temp_buffer, chunk_bytes_received);
+            // Obtém do pool um buffer para o chunk completo, que depois segue para a gravação sem cópia; em um chunk
+            // retomado, os offset primeiros bytes vêm do arquivo parcial gravado pela conexão interrompida
+            Buffer chunk_buffer = BufferPool::instance().acquire(offset + raw_size);
+            bool prefix_read = offset == 0 || readPartialPrefix(file_name, chunk_id, chunk_buffer.data(), offset);
+
+            // Recebe o chunk inteiro, sem avançar sobre a mensagem de controle do próximo chunk: os bytes comprimidos em
+            // um buffer próprio, os demais direto no buffer do chunk
+            Buffer compressed_buffer;
+            bool received;
+            if (compressed) {
+                compressed_buffer = BufferPool::instance().acquire(chunk_size);
+                received = io_engine->recvAll(client_sockfd, compressed_buffer.data(), chunk_size);
+            } else {
+                // Os chunks grandes de um download do diário são gravados em blocos no arquivo parcial enquanto chegam
+                bool resumable = prefix_read && download_journal != nullptr && offset + raw_size >= Constants::DOWNLOAD_RESUME_MIN_CHUNK_BYTES &&
+                                 download_journal->contains(file_name);
+                received = receivePlainChunk(client_sockfd, file_name, chunk_id, chunk_buffer.data(), offset, chunk_size, resumable);
+            }
 
-                    // Atualiza o total de bytes recebidos
-                    chunk_total_bytes_received += chunk_bytes_received;
+            if (!received) {
+                LOG_MESSAGE(LogType::ERROR, "Erro ao receber o chunk " + std::to_string(chunk_id) + " de " + client_ip + ":" + std::to_string(client_port) + ": " + std::strerror(errno));
+                close(client_sockfd);
+                return;
+            }
+
+            LOG_MESSAGE(LogType::CHUNK_RECEIVED, "Recebido " + std::to_string(chunk_size) + " bytes do chunk " + std::to_string(chunk_id) + " de " + client_ip + ":" + std::to_string(client_port) + ".");
+
+            // A porta de origem da conexão é efêmera, então ela não é usada como rótulo
+            Metrics::instance().add(Counter::BYTES_RECEIVED, "local=" + std::to_string(peer_id) + ",file=" + file_name, chunk_size);
+
+            // Sem o início do chunk, os bytes recebidos não o completam: o chunk é pedido inteiro mais tarde
+            if (!prefix_read) {
+                LOG_MESSAGE(LogType::ERROR, "Os " + std::to_string(offset) + " bytes iniciais do chunk " + std::to_string(chunk_id) + " de " + file_name +
+                            " não estão no arquivo parcial. O chunk foi descartado e será pedido inteiro.");
+                if (download_journal != nullptr) {
+                    download_journal->clearPartial(file_name, chunk_id);
+                }
+                std::remove(file_manager.getPartialChunkPath(file_name, chunk_id).c_str());
+                continue;
+            }
 
-                    logMessage(LogType::CHUNK_RECEIVED, "Recebido " + std::to_string(chunk_bytes_received) + " bytes do chunk " + std::to_string(chunk_id) + " de " + client_ip + ":" + std::to_string(client_port) + " (" + std::to_string(chunk_total_bytes_received) + "/" + std::to_string(chunk_size) + " bytes).");
+            // Descomprime o chunk para o buffer do tamanho original (formato já conferido); um chunk inválido é descartado e pedido de novo mais tarde
+            if (compressed) {
+                if (!Compression::decompress(codec, compressed_buffer.data(), chunk_size, chunk_buffer.data() + offset, raw_size)) {
+                    LOG_MESSAGE(LogType::ERROR, "Erro ao descomprimir (" + codec_name + ") o chunk " + std::to_string(chunk_id) + " de " + client_ip + ":" + std::to_string(client_port) + ".");
+                    continue;
                 }
             }
 
-            // Verifica se todos os bytes esperados foram recebidos
-            if (chunk_total_bytes_received >= chunk_size) {
-                logMessage(LogType::SUCCESS, "SUCESSO AO RECEBER O CHUNK " + std::to_string(chunk_id) + " DO ARQUIVO " + file_name + " de " + client_ip + ":" + std::to_string(client_port));
+            // O chunk está completo: o registro do arquivo parcial deixa de valer, e o arquivo é removido ao salvar o chunk
+            if (download_journal != nullptr) {
+                download_journal->clearPartial(file_name, chunk_id);
+            }
+            if (offset > 0) {
+                std::string labels = "local=" + std::to_string(peer_id);
+                Metrics::instance().add(Counter::CHUNKS_RESUMED, labels);
+                Metrics::instance().add(Counter::RESUME_BYTES_SAVED, labels, offset);
+                LOG_MESSAGE(LogType::INFO, "Chunk " + std::to_string(chunk_id) + " de " + file_name + " retomado a partir do byte " + std::to_string(offset) + ".");
+            }
+
+            LOG_MESSAGE(LogType::SUCCESS, "SUCESSO AO RECEBER O CHUNK " + std::to_string(chunk_id) + " DO ARQUIVO " + file_name + " de " + client_ip + ":" + std::to_string(client_port));
 
-                // Salva o chunk localmente
-                file_manager.saveChunk(file_name, chunk_id, chunk_buffer, chunk_size);
+            // Salva o chunk localmente; com o gravador, a conexão volta ao recv do próximo chunk sem esperar o disco
+            if (chunk_persister != nullptr) {
+                chunk_persister->submit(file_name, chunk_id, std::move(chunk_buffer));
             } else {
-                logMessage(LogType::ERROR, "Falha ao receber o chunk " + std::to_string(chunk_id) + " de " + client_ip + ":" + std::to_string(client_port) + ". Bytes esperados: " + std::to_string(chunk_size) + ", recebidos: " + std::to_string(chunk_total_bytes_received));
+                file_manager.saveChunk(file_name, chunk_id, chunk_buffer.data(), chunk_buffer.size());
             }
+
+            Metrics::instance().add(Counter::CHUNKS_RECEIVED, "local=" + std::to_string(peer_id) + ",file=" + file_name);
+            Metrics::instance().stopTimer(Histogram::REQUEST_TO_CHUNK_COMPLETE_MS, peer_id, file_name, chunk_id);
         }
     }
 
@@ -183,7 +299,8 @@ void TCPServer::receiveChunks(int client_sockfd) {
 /**
  * @brief Transfere chunks para o peer solicitante.
  */
-void TCPServer::sendChunks(const std::string& file_name, const std::vector<int>& chunks, const PeerInfo& destination_info) {
+void TCPServer::sendChunks(const std::string& file_name, const std::vector<int>& chunks, const PeerInfo& destination_info, uint32_t accepted_codecs,
+                           const std::map<int, size_t>& offsets) {
     // Cria um novo socket para a conexão
     int new_sockfd = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
     if (new_sockfd < 0) {
@@ -201,38 +318,55 @@ void TCPServer::sendChunks(const std::string& file_name, const std::vector<int>&
         return;
     }
 
+    // Leituras antecipadas em andamento, na ordem dos chunks, e o índice do próximo chunk a ler
+    std::deque<std::future<OutgoingChunk>> read_ahead;
+    size_t next_read = 0;
+
+    // Mantém a janela de leituras antecipadas cheia; as leituras e as compressões rodam nas threads fixas de read_executor
+    auto fillReadAhead = [&]() {
+        while (read_ahead.size() < Constants::TRANSFER_READ_AHEAD_CHUNKS && next_read < chunks.size()) {
+            auto offset_it = offsets.find(chunks[next_read]);
+            size_t offset = offset_it != offsets.end() ? offset_it->second : 0;
+            auto read_task = std::make_shared<std::packaged_task<OutgoingChunk()>>(
+                [this, chunk_path = file_manager.getChunkPath(file_name, chunks[next_read]), accepted_codecs, offset] {
+                    return prepareChunk(chunk_path, accepted_codecs, offset);
+                });
+            read_ahead.push_back(read_task->get_future());
+            read_executor.submit([read_task] { (*read_task)(); });
+            ++next_read;
+        }
+    };
+
     // Itera sobre os chunks e envia um a um
     for (int chunk : chunks) {
-        // Obtém o caminho do chunk
-        std::string chunk_path = file_manager.getChunkPath(file_name, chunk);
+        fillReadAhead();
+
+        // Obtém o conteúdo do chunk, normalmente já lido enquanto o anterior era enviado
+        auto [chunk_found, file_buffer, codec, raw_size, offset] = read_ahead.front().get();
+        read_ahead.pop_front();
+
+        // Inicia a leitura de mais um chunk antes de ocupar a conexão com o atual
+        fillReadAhead();
 
-        // Abre o arquivo em modo binário, somente leitura e posiciona o cursor no final para obter o tamanho
-        std::ifstream chunk_file(chunk_path, std::ios::binary | std::ios::ate | std::ios::in);
-        
         // Verifica se o arquivo foi encontrado/aberto
-        if (!chunk_file.is_open()) {
-            logMessage(LogType::ERROR, "Chunk " + std::to_string(chunk) + " não encontrado.");
+        if (!chunk_found) {
+            LOG_MESSAGE(LogType::ERROR, "Chunk " + std::to_string(chunk) + " não encontrado.");
             continue;  // Pula para o próximo chunk
         }
 
-        // Obtém o tamanho do chunk
-        size_t chunk_size = chunk_file.tellg();
+        // Obtém o tamanho do chunk, como enviado (comprimido ou não)
+        size_t chunk_size = file_buffer.size();
 
-        // Volta para o início do arquivo
-        chunk_file.seekg(0);
-        
-        // Cria um buffer em memória para armazenar todos os bytes do arquivo
-        char file_buffer[chunk_size] = {0};
-        
-        // Lê o arquivo inteiro para o buffer
-        chunk_file.read(file_buffer, chunk_size);
-
-        // Fecha o arquivo após a leitura
-        chunk_file.close();
-
-        // Cria a mensagem de controle
+        // Cria a mensagem de controle; um chunk comprimido ou retomado traz também o formato e o tamanho original,
+        // e um chunk retomado, o byte inicial
         std::stringstream ss;
         ss << "PUT " << file_name << " " << chunk << " " << transfer_speed << " " << chunk_size;
+        if (codec != CompressionCodec::NONE || offset > 0) {
+            ss << " " << Compression::codecToString(codec) << " " << raw_size;
+        }
+        if (offset > 0) {
+            ss << " " << offset;
+        }
         
         // transforma a stringstream em string
         std::string control_message = ss.str();
@@ -252,6 +386,22 @@ void TCPServer::sendChunks(const std::string& file_name, const std::vector<int>&
         // Variável para armazenar o número total de bytes enviado
         size_t total_bytes_sent = 0;
 
+        // Sem limite de velocidade, a mensagem de controle e o chunk seguem juntos em uma única submissão
+        if (timing.transfer_block_interval.count() == 0) {
+            if (!io_engine->sendAll(new_sockfd, {{control_message_buffer, Constants::CONTROL_MESSAGE_MAX_SIZE}, {file_buffer.data(), chunk_size}})) {
+                LOG_MESSAGE(LogType::ERROR, "Erro ao enviar o chunk " + std::to_string(chunk) + " para " + destination_info.ip + ":" + std::to_string(destination_info.port) + ": " + std::strerror(errno));
+                break;
+            }
+
+            Metrics::instance().add(Counter::BYTES_SENT,
+                                    "local=" + std::to_string(peer_id) + ",file=" + file_name + ",peer=" + destination_info.ip + ":" + std::to_string(destination_info.port),
+                                    chunk_size);
+            Metrics::instance().add(Counter::CHUNKS_SENT, "local=" + std::to_string(peer_id) + ",file=" + file_name);
+
+            LOG_MESSAGE(LogType::SUCCESS, "SUCESSO AO ENVIAR O CHUNK " + std::to_string(chunk) + " DO ARQUIVO " + file_name + " para " + destination_info.ip + ":" + std::to_string(destination_info.port));
+            continue;
+        }
+
         // Variável para armazenar o número de bytes a ser enviado
         size_t bytes_to_send = 0;
 
@@ -273,16 +423,16 @@ void TCPServer::sendChunks(const std::string& file_name, const std::vector<int>&
                 perror("Erro ao enviar o bloco da mensagem de controle.");
                 break;
             } else if (bytes_sent == 0) {
-                logMessage(LogType::INFO, "Conexão fechada pelo cliente.");
+                LOG_MESSAGE(LogType::INFO, "Conexão fechada pelo cliente.");
                 break;
             }
 
             total_bytes_sent += bytes_sent;
 
-            logMessage(LogType::INFO, "Enviado " + std::to_string(bytes_sent) + " bytes da mensagem de controle para " + destination_info.ip + ":" + std::to_string(destination_info.port) + " (" + std::to_string(total_bytes_sent) + "/" + std::to_string(Constants::CONTROL_MESSAGE_MAX_SIZE) + " bytes).");
+            LOG_MESSAGE(LogType::CHUNK_SENT, "Enviado " + std::to_string(bytes_sent) + " bytes da mensagem de controle para " + destination_info.ip + ":" + std::to_string(destination_info.port) + " (" + std::to_string(total_bytes_sent) + "/" + std::to_string(Constants::CONTROL_MESSAGE_MAX_SIZE) + " bytes).");
 
             // Simula a velocidade de transferência (bytes/segundo)
-            std::this_thread::sleep_for(std::chrono::seconds(1));
+            std::this_thread::sleep_for(timing.transfer_block_interval);
         }
 
         total_bytes_sent = 0;;
@@ -296,26 +446,33 @@ void TCPServer::sendChunks(const std::string& file_name, const std::vector<int>&
             bytes_to_send = std::min(static_cast<size_t>(transfer_speed), chunk_size - total_bytes_sent);
 
             // Envia os bytes da estrutura em memória (file_buffer)
-            bytes_sent = send(new_sockfd, file_buffer + total_bytes_sent, bytes_to_send, 0);
+            bytes_sent = send(new_sockfd, file_buffer.data() + total_bytes_sent, bytes_to_send, 0);
 
             // Verifica se houve erro ou o cliente fechou a conexão
             if (bytes_sent < 0) {
                 perror("Erro ao enviar o chunk.");
                 break;
             } else if (bytes_sent == 0) {
-                logMessage(LogType::INFO, "Conexão fechada pelo cliente.");
+                LOG_MESSAGE(LogType::INFO, "Conexão fechada pelo cliente.");
                 break;
             }
 
             total_bytes_sent += bytes_sent;
 
-            logMessage(LogType::CHUNK_SENT, "Enviado " + std::to_string(bytes_sent) + " bytes do chunk " + std::to_string(chunk) + " do arquivo " + file_name + " para " + destination_info.ip + ":" + std::to_string(destination_info.port) + " (" + std::to_string(total_bytes_sent) + "/" + std::to_string(chunk_size) + " bytes).");
+            LOG_MESSAGE(LogType::CHUNK_SENT, "Enviado " + std::to_string(bytes_sent) + " bytes do chunk " + std::to_string(chunk) + " do arquivo " + file_name + " para " + destination_info.ip + ":" + std::to_string(destination_info.port) + " (" + std::to_string(total_bytes_sent) + "/" + std::to_string(chunk_size) + " bytes).");
 
             // Simula a velocidade de transferência em bytes por segundo
-            std::this_thread::sleep_for(std::chrono::seconds(1));
+            std::this_thread::sleep_for(timing.transfer_block_interval);
         }
 
-        logMessage(LogType::SUCCESS, "SUCESSO AO ENVIAR O CHUNK " + std::to_string(chunk) + " DO ARQUIVO " + file_name + " para " + destination_info.ip + ":" + std::to_string(destination_info.port));
+        Metrics::instance().add(Counter::BYTES_SENT,
+                                "local=" + std::to_string(peer_id) + ",file=" + file_name + ",peer=" + destination_info.ip + ":" + std::to_string(destination_info.port),
+                                total_bytes_sent);
+        if (total_bytes_sent >= chunk_size) {
+            Metrics::instance().add(Counter::CHUNKS_SENT, "local=" + std::to_string(peer_id) + ",file=" + file_name);
+        }
+
+        LOG_MESSAGE(LogType::SUCCESS, "SUCESSO AO ENVIAR O CHUNK " + std::to_string(chunk) + " DO ARQUIVO " + file_name + " para " + destination_info.ip + ":" + std::to_string(destination_info.port));
     }
 
     // Fecha o socket após enviar todos os chunks
@@ -323,6 +480,144 @@ void TCPServer::sendChunks(const std::string& file_name, const std::vector<int>&
 }
 
 
+/**
+ * @brief Lê o conteúdo de um chunk do disco.
+ */
+std::tuple<bool, Buffer> TCPServer::readChunkFile(const std::string& chunk_path, size_t& offset) {
+    // Lê o arquivo inteiro para um buffer do pool, do tamanho do chunk; ele volta ao pool depois do envio
+    Buffer file_buffer;
+    if (offset == 0) {
+        if (!io_engine->readFile(chunk_path, file_buffer)) {
+            return {false, {}};
+        }
+        return {true, std::move(file_buffer)};
+    }
+
+    // Chunk retomado: só os bytes a partir de offset; um offset além do fim do chunk faz o envio do chunk inteiro
+    int fd = open(chunk_path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return {false, {}};
+    }
+    struct stat file_stat;
+    bool ok = fstat(fd, &file_stat) == 0;
+    if (ok) {
+        size_t size = static_cast<size_t>(file_stat.st_size);
+        if (offset >= size) {
+            offset = 0;
+        }
+        file_buffer = BufferPool::instance().acquire(size - offset);
+        ok = io_engine->readAt(fd, file_buffer.data(), file_buffer.size(), static_cast<off_t>(offset));
+    }
+    close(fd);
+
+    return {ok, std::move(file_buffer)};
+}
+
+
+/**
+ * @brief Lê um chunk do disco e o comprime quando a política e o conteúdo permitem.
+ */
+TCPServer::OutgoingChunk TCPServer::prepareChunk(const std::string& chunk_path, uint32_t accepted_codecs, size_t offset) {
+    OutgoingChunk outgoing;
+    outgoing.offset = offset;
+    std::tie(outgoing.found, outgoing.data) = readChunkFile(chunk_path, outgoing.offset);
+    outgoing.raw_size = outgoing.data.size();
+    if (!outgoing.found) {
+        return outgoing;
+    }
+
+    CompressionCodec codec = Compression::choose(compression_mode, accepted_codecs, outgoing.data.data(), outgoing.raw_size, linkBytesPerSecond());
+    if (codec == CompressionCodec::NONE) {
+        return outgoing;
+    }
+
+    // O resultado precisa ser menor que o chunk; caso contrário o chunk segue sem compressão
+    Buffer compressed = BufferPool::instance().acquire(outgoing.raw_size);
+    size_t compressed_size = Compression::compress(codec, outgoing.data.data(), outgoing.raw_size, compressed.data(), outgoing.raw_size - 1);
+    if (compressed_size == 0) {
+        return outgoing;
+    }
+    compressed.resize(compressed_size);
+    outgoing.data = std::move(compressed);
+    outgoing.codec = codec;
+
+    std::string labels = "local=" + std::to_string(peer_id) + ",codec=" + Compression::codecToString(codec);
+    Metrics::instance().add(Counter::CHUNKS_COMPRESSED, labels);
+    Metrics::instance().add(Counter::COMPRESSION_BYTES_SAVED, labels, outgoing.raw_size - compressed_size);
+    return outgoing;
+}
+
+
+/**
+ * @brief Lê do arquivo parcial de um chunk os bytes recebidos antes da conexão atual.
+ */
+bool TCPServer::readPartialPrefix(const std::string& file_name, int chunk_id, char* data, size_t offset) {
+    int fd = open(file_manager.getPartialChunkPath(file_name, chunk_id).c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return false;
+    }
+
+    struct stat file_stat;
+    bool ok = fstat(fd, &file_stat) == 0 && static_cast<size_t>(file_stat.st_size) >= offset && io_engine->readAt(fd, data, offset, 0);
+    close(fd);
+    return ok;
+}
+
+
+/**
+ * @brief Recebe os bytes de um chunk sem compressão, gravando-os em blocos no arquivo parcial quando ele pode ser retomado.
+ */
+bool TCPServer::receivePlainChunk(int client_sockfd, const std::string& file_name, int chunk_id, char* data, size_t offset, size_t size, bool resumable) {
+    if (!resumable) {
+        return io_engine->recvAll(client_sockfd, data + offset, size);
+    }
+
+    // O arquivo parcial passa a ter exatamente o prefixo já usado; bytes além dele, não registrados no diário, são descartados
+    std::string partial_path = file_manager.getPartialChunkPath(file_name, chunk_id);
+    int partial_fd = open(partial_path.c_str(), O_WRONLY | O_CREAT | O_CLOEXEC, 0644);
+    if (partial_fd < 0 || ftruncate(partial_fd, static_cast<off_t>(offset)) != 0) {
+        perror("Erro ao abrir o arquivo parcial do chunk");
+        if (partial_fd >= 0) {
+            close(partial_fd);
+        }
+        return io_engine->recvAll(client_sockfd, data + offset, size);
+    }
+
+    // Cada bloco entra no diário depois de gravado; após uma falha de gravação, os blocos seguintes ficam só na memória
+    bool partial_ok = true;
+    for (size_t received = 0; received < size;) {
+        size_t block = std::min(Constants::DOWNLOAD_RESUME_BLOCK_BYTES, size - received);
+        char* block_data = data + offset + received;
+        if (!io_engine->recvAll(client_sockfd, block_data, block)) {
+            int recv_errno = errno;
+            close(partial_fd);
+            errno = recv_errno;
+            return false;
+        }
+        received += block;
+
+        partial_ok = partial_ok && io_engine->writeAt(partial_fd, block_data, block, static_cast<off_t>(offset + received - block));
+        if (partial_ok) {
+            download_journal->recordPartial(file_name, chunk_id, offset + received);
+        }
+    }
+
+    close(partial_fd);
+    return true;
+}
+
+
+/**
+ * @brief Retorna a velocidade de envio em bytes por segundo.
+ */
+double TCPServer::linkBytesPerSecond() const {
+    if (timing.transfer_block_interval.count() == 0) {
+        return std::numeric_limits<double>::infinity();
+    }
+    return transfer_speed / std::chrono::duration<double>(timing.transfer_block_interval).count();
+}
+
+
 /**
  * @brief Obtém o endereço IP e a porta TCP do cliente conectado via socket.
  */
@@ -1,9 +1,21 @@
 #ifndef TCPSERVER_H
 #define TCPSERVER_H
 
+#include "Compression.h"
+#include "Executor.h"
 #include "FileManager.h"
+#include "IOEngine.h"
 #include "Utils.h"
+#include "WorkStealingExecutor.h"
+#include <deque>
+#include <map>
+#include <mutex>
 #include <string>
+#include <tuple>
+#include <vector>
+
+class ChunkPersister;
+class DownloadJournal;
 
 
 /**
@@ -29,12 +41,34 @@ struct PeerInfo {
  */
 class TCPServer {
 private:
+    /**
+     * @brief Estrutura com um chunk lido do disco e pronto para o envio.
+     */
+    struct OutgoingChunk {
+        bool found = false;                                 ///< Indica se o chunk foi lido.
+        Buffer data;                                        ///< Bytes enviados, comprimidos ou não.
+        CompressionCodec codec = CompressionCodec::NONE;    ///< Formato dos bytes enviados.
+        size_t raw_size = 0;                                ///< Tamanho sem compressão dos bytes enviados.
+        size_t offset = 0;                                  ///< Byte do chunk a partir do qual ele é enviado (chunk retomado).
+    };
+
     const std::string ip;                                   ///< Endereço IP do peer.
     const int port;                                         ///< Porta TCP para transferência.
     const int peer_id;                                      ///< Identificador único (ID) do peer.
     const int transfer_speed;                               ///< Capacidade de transferência em bytes por segundo.
     int server_sockfd;                                      ///< Socket TCP para aceitar conexões.
     FileManager& file_manager;                              ///< Referência ao gerenciador de arquivos.
+    WorkStealingExecutor& executor;                         ///< Executor compartilhado do peer, que recebe os chunks das conexões aceitas.
+    ChunkPersister* chunk_persister;                        ///< Gravador dos chunks recebidos em outra thread (nulo: os chunks são salvos na thread da conexão).
+    IOEngine* io_engine;                                    ///< E/S dos chunks em disco e nas conexões (padrão: IOEngine::blockingEngine()).
+    DownloadJournal* download_journal;                      ///< Diário dos downloads, com os bytes gravados dos chunks recebidos em partes (nulo: chunks recebidos só na memória).
+    Executor read_executor;                                 ///< Threads das leituras antecipadas de sendChunks, que mantêm o seu anel de E/S entre os envios.
+    const TimingConfig timing;                              ///< Tempos de espera do protocolo.
+    const CompressionMode compression_mode;                 ///< Política de compressão dos chunks enviados (Compression::getDefaultMode() na criação).
+    const int max_receives;                                 ///< Número máximo de conexões recebidas ao mesmo tempo no executor (ThreadingConfig::io_threads).
+    int active_receives;                                    ///< Número de tarefas de recebimento submetidas e não concluídas.
+    std::deque<int> waiting_connections;                    ///< Conexões aceitas aguardando uma tarefa de recebimento, na ordem de chegada.
+    std::mutex receive_mutex;                               ///< Mutex para proteger as tarefas de recebimento e as conexões aguardando.
 
 public:
     /**
@@ -49,16 +83,52 @@ public:
      * @param peer_id ID do peer na rede P2P.
      * @param transfer_speed Capacidade de transferência em bytes por segundo.
      * @param file_manager Referência ao gerenciador de arquivos para acessar os chunks disponíveis.
+     * @param executor Referência ao executor compartilhado do peer.
+     * @param timing Tempos de espera do protocolo (padrão: valores de Constants.h).
+     */
+    TCPServer(const std::string& ip, int port, int peer_id, int transfer_speed, FileManager& file_manager, WorkStealingExecutor& executor,
+              const TimingConfig& timing = TimingConfig());
+
+
+    /**
+     * @brief Associa o gravador que salva os chunks recebidos fora da thread da conexão.
+     * 
+     * @param chunk_persister Ponteiro para o gravador de chunks do peer.
+     */
+    void setChunkPersister(ChunkPersister* chunk_persister);
+
+
+    /**
+     * @brief Associa a implementação de E/S usada na leitura, no envio e no recebimento dos chunks.
+     * 
+     * @param io_engine Ponteiro para a implementação de E/S do peer.
      */
-    TCPServer(const std::string& ip, int port, int peer_id, int transfer_speed, FileManager& file_manager);
+    void setIOEngine(IOEngine* io_engine);
+
+
+    /**
+     * @brief Associa o diário dos downloads, que registra os bytes dos chunks grandes gravados no arquivo parcial durante o recebimento.
+     * 
+     * @param download_journal Ponteiro para o diário de downloads do peer.
+     */
+    void setDownloadJournal(DownloadJournal* download_journal);
+
+
+    /**
+     * @brief Fixa as threads de leitura antecipada nos núcleos de E/S do peer.
+     * 
+     * @param placement Núcleos das threads do peer.
+     */
+    void setThreadPlacement(const ThreadPlacement& placement);
 
 
     /**
      * @brief Inicia o servidor TCP para aceitar conexões.
      * 
      * Este método cria um socket TCP e aguarda conexões de peers que desejam
-     * transferir chunks. As transferências para cada conexão são gerenciadas
-     * em threads separadas para permitir múltiplas transferências simultâneas.
+     * transferir chunks. Cada conexão é recebida em uma tarefa TaskPriority::TRANSFER
+     * do executor compartilhado; as conexões além de max_receives aguardam a
+     * conclusão de uma delas, pois o recebimento ocupa a thread até o fim da conexão.
      */
     void run();
 
@@ -67,7 +137,11 @@ public:
      * @brief Recebe chunks enviados por um peer e ao receber todos, monta o arquivo final.
      * 
      * Este método recebe dados de um chunk de um cliente que está conectado ao servidor.
-     * Ele armazena o chunk no diretório designado do peer.
+     * Ele armazena o chunk no diretório designado do peer. Um chunk comprimido traz na
+     * mensagem de controle o formato e o tamanho original, e é descomprimido antes de ser salvo.
+     * Um chunk retomado traz também o byte inicial; os bytes anteriores vêm do arquivo parcial.
+     * Os chunks grandes sem compressão de um download do diário são gravados em blocos no arquivo
+     * parcial enquanto chegam, para que uma conexão interrompida ou um reinício não os percam.
      * 
      * @param client_sockfd Socket do cliente conectado.
      */
@@ -79,13 +153,19 @@ public:
      * 
      * Este método é responsável por enviar chunks específicos de um arquivo para um peer
      * que solicitou via mensagem REQUEST. Os chunks são recuperados do gerenciador de
-     * arquivos e então enviados.
+     * arquivos e então enviados, todos na mesma conexão. Enquanto um chunk é enviado, os
+     * próximos Constants::TRANSFER_READ_AHEAD_CHUNKS já são lidos do disco e, conforme a
+     * política de compressão, comprimidos em paralelo. Os chunks interrompidos no solicitante
+     * seguem a partir do byte pedido.
      * 
      * @param file_name Nome do arquivo cujos chunks estão sendo solicitados.
      * @param chunks Lista com os IDs dos chunks que devem ser transferidos.
      * @param destination_info Informações sobre o peer que está solicitando os chunks, incluindo seu endereço IP e porta UDP (Porta TCP = Porta UDP + 1000).
+     * @param accepted_codecs Formatos de compressão anunciados pelo solicitante (padrão: nenhum, os chunks seguem sem compressão).
+     * @param offsets Byte inicial de cada chunk interrompido no solicitante (padrão: nenhum, os chunks seguem inteiros).
      */
-    void sendChunks(const std::string& file_name, const std::vector<int>& chunks, const PeerInfo& destination_info);
+    void sendChunks(const std::string& file_name, const std::vector<int>& chunks, const PeerInfo& destination_info, uint32_t accepted_codecs = 0,
+                    const std::map<int, size_t>& offsets = {});
 
 
     /**
@@ -99,6 +179,68 @@ public:
      * @return Tupla contendo o endereço IP (string) e a porta TCP (int).
      */
     std::tuple<std::string, int> getClientAddressInfo(int client_sockfd);
+
+private:
+    /**
+     * @brief Tarefa de recebimento: recebe os chunks de uma conexão e, se houver conexões aguardando, submete a próxima.
+     * 
+     * @param client_sockfd Socket do cliente conectado.
+     */
+    void receiveConnection(int client_sockfd);
+
+
+    /**
+     * @brief Lê o conteúdo de um chunk do disco.
+     * 
+     * @param chunk_path Caminho do chunk.
+     * @param offset Byte inicial da leitura; zerado quando não está antes do fim do chunk.
+     * @return Tupla indicando se o chunk foi lido e o seu conteúdo a partir de offset, em um buffer do BufferPool.
+     */
+    std::tuple<bool, Buffer> readChunkFile(const std::string& chunk_path, size_t& offset);
+
+
+    /**
+     * @brief Lê um chunk do disco e o comprime quando a política e o conteúdo permitem.
+     * 
+     * @param chunk_path Caminho do chunk.
+     * @param accepted_codecs Formatos de compressão anunciados pelo solicitante.
+     * @param offset Byte a partir do qual o chunk é enviado (0: chunk inteiro).
+     * @return Chunk pronto para o envio.
+     */
+    OutgoingChunk prepareChunk(const std::string& chunk_path, uint32_t accepted_codecs, size_t offset);
+
+
+    /**
+     * @brief Lê do arquivo parcial de um chunk os bytes recebidos antes da conexão atual.
+     * 
+     * @param file_name Nome do arquivo.
+     * @param chunk_id Número do chunk.
+     * @param data Destino dos bytes.
+     * @param offset Número de bytes a ler do início do arquivo parcial.
+     * @return true se o arquivo parcial tem ao menos offset bytes e eles foram lidos.
+     */
+    bool readPartialPrefix(const std::string& file_name, int chunk_id, char* data, size_t offset);
+
+
+    /**
+     * @brief Recebe os bytes de um chunk sem compressão, gravando-os em blocos no arquivo parcial quando ele pode ser retomado.
+     * 
+     * @param client_sockfd Socket do cliente conectado.
+     * @param file_name Nome do arquivo.
+     * @param chunk_id Número do chunk.
+     * @param data Buffer do chunk completo, com os offset primeiros bytes já preenchidos.
+     * @param offset Byte do chunk em que começam os bytes enviados.
+     * @param size Número de bytes enviados.
+     * @param resumable Indica se os blocos recebidos são gravados no arquivo parcial e registrados no diário.
+     * @return true se todos os bytes foram recebidos.
+     */
+    bool receivePlainChunk(int client_sockfd, const std::string& file_name, int chunk_id, char* data, size_t offset, size_t size, bool resumable);
+
+
+    /**
+     * @brief Retorna a velocidade de envio em bytes por segundo (infinita quando o envio não é limitado).
+     */
+    double linkBytesPerSecond() const;
 };
 
 #endif // TCPSERVER_H
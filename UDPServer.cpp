@@ -1,4 +1,12 @@
 #include "UDPServer.h"
+#include "Compression.h"
+#include "DHTNode.h"
+#include "DownloadJournal.h"
+#include "HaveAnnouncer.h"
+#include "MembershipManager.h"
+#include "Metrics.h"
+#include "ResponseAggregator.h"
+#include "UploadScheduler.h"
 #include <sys/socket.h>
 #include <netinet/in.h>
 #include <unistd.h>
@@ -13,35 +21,76 @@
 /**
  * @brief Construtor da classe UDPServer.
  */
-UDPServer::UDPServer(const std::string& ip, int port, int tcp_port, int peer_id, int transfer_speed, FileManager& file_manager, TCPServer& tcp_server)
-    : ip(ip), port(port), tcp_port(tcp_port), peer_id(peer_id), transfer_speed(transfer_speed), file_manager(file_manager), tcp_server(tcp_server) {}
+UDPServer::UDPServer(const std::string& ip, int port, int tcp_port, int peer_id, int transfer_speed, FileManager& file_manager, TCPServer& tcp_server,
+                     WorkStealingExecutor& executor, const TimingConfig& timing)
+    : ip(ip), port(port), tcp_port(tcp_port), peer_id(peer_id), transfer_speed(transfer_speed), membership(nullptr), dht(nullptr), aggregator(nullptr), have_announcer(nullptr), upload_scheduler(nullptr),
+      download_journal(nullptr),
+      next_search_id(std::hash<std::string>{}(ip + ":" + std::to_string(port)) ^ static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count())),
+      file_manager(file_manager), tcp_server(tcp_server), timing(timing), executor(executor) {}
 
 
 /**
  * @brief Inicia o servidor UDP, permitindo que o peer receba e envie mensagens.
  */
 void UDPServer::run() {
-    char buffer[Constants::CONTROL_MESSAGE_MAX_SIZE];
     struct sockaddr_in sender_addr{};
     socklen_t addr_len = sizeof(sender_addr);
 
     initializeUDPSocket();
 
     while (true) {
+        // Obtém do pool o buffer do datagrama, que segue para a tarefa de processamento
+        Buffer datagram = BufferPool::instance().acquire(Constants::CONTROL_MESSAGE_MAX_SIZE);
+
         // Recebe a mensagem UDP
-        ssize_t bytes_received = recvfrom(sockfd, buffer, Constants::CONTROL_MESSAGE_MAX_SIZE, 0,
+        // Reserva o último byte do buffer, como no limite das mensagens montadas pelo peer
+        ssize_t bytes_received = recvfrom(sockfd, datagram.data(), Constants::CONTROL_MESSAGE_MAX_SIZE - 1, 0,
                                  (struct sockaddr*)&sender_addr, &addr_len);
         if (bytes_received > 0) {
-            buffer[bytes_received] = '\0';
-            std::string message(buffer);
+            // A mensagem termina no primeiro byte nulo, se houver (find retorna npos quando não há)
+            std::string_view received(datagram.data(), static_cast<size_t>(bytes_received));
+            datagram.resize(std::min(received.size(), received.find('\0')));
 
             auto [direct_sender_ip, direct_sender_port] = getSenderAddressInfo(sender_addr);
 
             // Cria uma instância de PeerInfo para armazenar o IP e a porta UDP do remetente
             PeerInfo direct_sender_info(std::string(direct_sender_ip), direct_sender_port);
 
-            // Cria uma nova thread para processar a mensagem recebida
-            std::thread(&UDPServer::processMessage, this, message, direct_sender_info).detach();
+            // Entrega a mensagem recebida ao executor compartilhado, onde as mensagens de controle passam à frente das demais tarefas
+            executor.submit(TaskPriority::CONTROL, [this, datagram = std::move(datagram), direct_sender_info] {
+                processMessage(datagram.view(), direct_sender_info);
+            });
+        }
+    }
+}
+
+
+/**
+ * @brief Loop da thread que envia as mensagens de descoberta propagadas no horário marcado.
+ */
+void UDPServer::runPacer() {
+    while (true) {
+        PacedMessage paced;
+        {
+            std::unique_lock<std::mutex> paced_lock(paced_mutex);
+
+            // Espera até haver uma mensagem e chegar o seu horário (uma mensagem nova acorda a thread, pois pode ser mais próxima)
+            paced_cv.wait(paced_lock, [this] { return !paced_messages.empty(); });
+            if (std::chrono::steady_clock::now() < paced_messages.top().send_at) {
+                paced_cv.wait_until(paced_lock, paced_messages.top().send_at);
+                continue;
+            }
+            paced = paced_messages.top();
+            paced_messages.pop();
+        }
+
+        ssize_t bytes_sent = sendUDPMessage(paced.neighbor_ip, paced.neighbor_port, paced.message);
+        if (bytes_sent < 0) {
+            perror("Erro ao enviar mensagem UDP");
+        } else {
+            LOG_MESSAGE(LogType::DISCOVERY_SENT,
+                       "Mensagem de descoberta enviada para Peer " + paced.neighbor_ip + ":" + std::to_string(paced.neighbor_port) +
+                       " -> " + paced.message);
         }
     }
 }
@@ -77,7 +126,7 @@ void UDPServer::initializeUDPSocket() {
         exit(EXIT_FAILURE);
     }
 
-    logMessage(LogType::INFO, "Servidor UDP inicializado em " + ip + ":" + std::to_string(port));
+    LOG_MESSAGE(LogType::INFO, "Servidor UDP inicializado em " + ip + ":" + std::to_string(port));
 }
 
 
@@ -90,6 +139,29 @@ void UDPServer::initializeProcessingActive(std::string file_name) {
 }
 
 
+/**
+ * @brief Indica se as respostas para um arquivo estão sendo processadas.
+ */
+bool UDPServer::isProcessingActive(const std::string& file_name) {
+    std::lock_guard<std::mutex> file_lock(processing_mutex);
+    auto it = processing_active_map.find(file_name);
+    return it != processing_active_map.end() && it->second;
+}
+
+
+/**
+ * @brief Encerra o recebimento de respostas para chunks de um arquivo específico.
+ */
+void UDPServer::finalizeProcessingActive(const std::string& file_name) {
+    {
+        std::lock_guard<std::mutex> file_lock(processing_mutex);
+        processing_active_map[file_name] = false;
+    }
+
+    LOG_MESSAGE(LogType::INFO, "Processamento de mensagens RESPONSE desativado para o arquivo: " + file_name);
+}
+
+
 /**
  * @brief Função que envia uma mensagem UDP.
  */
@@ -101,6 +173,12 @@ ssize_t UDPServer::sendUDPMessage(const std::string& ip, int port, const std::st
     ssize_t bytes_sent = sendto(sockfd, message.c_str(), message.size(), 0,
                                 (struct sockaddr*)&peer_addr, sizeof(peer_addr));
 
+    // Contabiliza a mensagem pelo tipo (primeira palavra) e pelo destinatário
+    if (bytes_sent >= 0) {
+        std::string_view type(message.data(), std::min(message.find(' '), message.size()));
+        Metrics::instance().add(Counter::MESSAGES_OUT, Metrics::messageLabel(peer_id, type, ip, port));
+    }
+
     return bytes_sent; // Retorna o número de bytes enviados ou indicador de erro
 }
 
@@ -113,8 +191,98 @@ void UDPServer::setUDPNeighbors(const std::vector<std::tuple<std::string, int>>&
         std::string neighbor_ip = std::get<0>(neighbor);
         int neighbor_port = std::get<1>(neighbor);
 
-        udpNeighbors.emplace_back(neighbor_ip, neighbor_port);
+        addUDPNeighbor(neighbor_ip, neighbor_port);
+    }
+}
+
+
+/**
+ * @brief Adiciona um vizinho à lista usada no envio das mensagens de descoberta.
+ */
+bool UDPServer::addUDPNeighbor(const std::string& neighbor_ip, int neighbor_port) {
+    std::lock_guard<std::mutex> lock(neighbors_mutex);
+
+    // Evita vizinhos repetidos, que receberiam cada mensagem de descoberta mais de uma vez
+    auto neighbor = std::make_tuple(neighbor_ip, neighbor_port);
+    if (std::find(udpNeighbors.begin(), udpNeighbors.end(), neighbor) != udpNeighbors.end()) {
+        return false;
     }
+
+    udpNeighbors.push_back(neighbor);
+    return true;
+}
+
+
+/**
+ * @brief Remove um vizinho da lista usada no envio das mensagens de descoberta.
+ */
+bool UDPServer::removeUDPNeighbor(const std::string& neighbor_ip, int neighbor_port) {
+    std::lock_guard<std::mutex> lock(neighbors_mutex);
+
+    auto it = std::find(udpNeighbors.begin(), udpNeighbors.end(), std::make_tuple(neighbor_ip, neighbor_port));
+    if (it == udpNeighbors.end()) {
+        return false;
+    }
+
+    udpNeighbors.erase(it);
+    return true;
+}
+
+
+/**
+ * @brief Retorna uma cópia da lista de vizinhos atual.
+ */
+std::vector<std::tuple<std::string, int>> UDPServer::getUDPNeighbors() {
+    std::lock_guard<std::mutex> lock(neighbors_mutex);
+    return udpNeighbors;
+}
+
+
+/**
+ * @brief Associa o gerenciador de vizinhança que tratará as mensagens de membership.
+ */
+void UDPServer::setMembershipManager(MembershipManager* membership) {
+    this->membership = membership;
+}
+
+
+/**
+ * @brief Associa o nó da DHT que tratará as mensagens DHT_*.
+ */
+void UDPServer::setDHTNode(DHTNode* dht) {
+    this->dht = dht;
+}
+
+
+/**
+ * @brief Associa o agregador que tratará as descobertas com identificador de busca e as mensagens AGGREGATE.
+ */
+void UDPServer::setResponseAggregator(ResponseAggregator* aggregator) {
+    this->aggregator = aggregator;
+}
+
+
+/**
+ * @brief Associa o anunciante que registra os solicitantes das descobertas e trata as mensagens HAVE.
+ */
+void UDPServer::setHaveAnnouncer(HaveAnnouncer* have_announcer) {
+    this->have_announcer = have_announcer;
+}
+
+
+/**
+ * @brief Associa o escalonador que recebe os chunks pedidos em mensagens REQUEST.
+ */
+void UDPServer::setUploadScheduler(UploadScheduler* upload_scheduler) {
+    this->upload_scheduler = upload_scheduler;
+}
+
+
+/**
+ * @brief Associa o diário dos downloads, consultado para pedir os chunks interrompidos a partir do byte em que pararam.
+ */
+void UDPServer::setDownloadJournal(DownloadJournal* download_journal) {
+    this->download_journal = download_journal;
 }
 
 
@@ -139,23 +307,63 @@ std::tuple<std::string, int> UDPServer::getSenderAddressInfo(const sockaddr_in&
 /**
  * @brief Envia uma mensagem de descoberta (DISCOVERY) para todos os vizinhos.
  */
-void UDPServer::sendChunkDiscoveryMessage(const std::string& file_name, int total_chunks, int ttl, const PeerInfo& chunk_requester_info) {
-    std::string message = buildChunkDiscoveryMessage(file_name, total_chunks, ttl, chunk_requester_info);
+void UDPServer::sendChunkDiscoveryMessage(const std::string& file_name, int total_chunks, int ttl, const PeerInfo& chunk_requester_info,
+                                          uint64_t search_id, std::chrono::milliseconds aggregation_window) {
+    std::string message = buildChunkDiscoveryMessage(file_name, total_chunks, ttl, chunk_requester_info, search_id, aggregation_window);
+
+    // Professor pediu para dar um tempo quando for enviar as mensagens de descoberta: cada vizinho recebe a
+    // mensagem um intervalo depois do anterior, enviada pela thread de runPacer sem ocupar a de processamento
+    auto neighbors = getUDPNeighbors();
+    auto send_at = std::chrono::steady_clock::now();
+    {
+        std::lock_guard<std::mutex> paced_lock(paced_mutex);
+        for (const auto& [neighbor_ip, neighbor_port] : neighbors) {
+            paced_messages.push({send_at, neighbor_ip, neighbor_port, message});
+            send_at += timing.discovery_message_interval;
+        }
+    }
+    paced_cv.notify_one();
+}
 
-    for (const auto& [neighbor_ip, neighbor_port] : udpNeighbors) {
-        // Usa a função sendUDPMessage para enviar a mensagem
-        ssize_t bytes_sent = sendUDPMessage(neighbor_ip, neighbor_port, message);
 
-        if (bytes_sent < 0) {
-            perror("Erro ao enviar mensagem UDP");
-        } else {
-            logMessage(LogType::DISCOVERY_SENT,
-                       "Mensagem de descoberta enviada para Peer " + neighbor_ip + ":" + std::to_string(neighbor_port) +
-                       " -> " + message);
+/**
+ * @brief Envia, em uma única rodada, mensagens de descoberta (DISCOVERY) de vários arquivos para todos os vizinhos.
+ */
+void UDPServer::sendChunkDiscoveryRound(const std::vector<std::tuple<std::string, int, int, DiscoveryMode>>& files, const PeerInfo& chunk_requester_info) {
+    std::vector<std::string> messages;
+
+    for (const auto& [file_name, total_chunks, ttl, discovery_mode] : files) {
+        // Inicia a medição do tempo até a primeira resposta de cada arquivo
+        Metrics::instance().startTimer(peer_id, file_name);
+
+        // A mesma mensagem vai para todos os vizinhos, para que as cópias da busca sejam reconhecidas
+        uint64_t search_id = 0;
+        std::chrono::milliseconds aggregation_window(0);
+        if (discovery_mode == DiscoveryMode::AGGREGATE) {
+            do {
+                search_id = next_search_id++;
+            } while (search_id == 0);
+            aggregation_window = std::max(std::chrono::milliseconds(1), timing.response_timeout / (ttl + 1));
         }
-        
-        // Professor pediu para dar um tempo quando for enviar as mensagens de descoberta
-        std::this_thread::sleep_for(std::chrono::seconds(Constants::DISCOVERY_MESSAGE_INTERVAL_SECONDS));
+        messages.push_back(buildChunkDiscoveryMessage(file_name, total_chunks, ttl, chunk_requester_info, search_id, aggregation_window));
+    }
+
+    for (const auto& [neighbor_ip, neighbor_port] : getUDPNeighbors()) {
+        // Envia para o vizinho as mensagens de todos os arquivos da rodada
+        for (const std::string& message : messages) {
+            ssize_t bytes_sent = sendUDPMessage(neighbor_ip, neighbor_port, message);
+
+            if (bytes_sent < 0) {
+                perror("Erro ao enviar mensagem UDP");
+            } else {
+                LOG_MESSAGE(LogType::DISCOVERY_SENT,
+                           "Mensagem de descoberta enviada para Peer " + neighbor_ip + ":" + std::to_string(neighbor_port) +
+                           " -> " + message);
+            }
+        }
+
+        // O intervalo entre vizinhos é respeitado uma única vez para toda a rodada
+        std::this_thread::sleep_for(timing.discovery_message_interval);
     }
 }
 
@@ -164,48 +372,136 @@ void UDPServer::sendChunkDiscoveryMessage(const std::string& file_name, int tota
  * @brief Envia uma resposta (RESPONSE) contendo os chunks disponíveis para um arquivo.
  */
 void UDPServer::sendChunkResponseMessage(const std::string& file_name, const PeerInfo& chunk_requester_info) {
-    std::vector<int> chunks_available = file_manager.getAvailableChunks(file_name);
-
-    if (!chunks_available.empty()) {
-        std::string response_message = buildChunkResponseMessage(file_name, chunks_available);
+    std::shared_ptr<const std::string> response_message = getChunkResponseMessage(file_name);
 
+    if (!response_message->empty()) {
         // Usa a função sendUDPMessage para enviar a mensagem
-        ssize_t bytes_sent = sendUDPMessage(chunk_requester_info.ip, chunk_requester_info.port, response_message);
+        ssize_t bytes_sent = sendUDPMessage(chunk_requester_info.ip, chunk_requester_info.port, *response_message);
 
         if (bytes_sent < 0) {
             perror("Erro ao enviar resposta UDP com chunks disponíveis.");
             return;
         }
 
-        std::stringstream chunks_ss;
-        for (const int& chunk : chunks_available) {
-            chunks_ss << chunk << " ";
-        }
-
-        logMessage(LogType::RESPONSE_SENT,
+        LOG_MESSAGE(LogType::RESPONSE_SENT,
                    "Enviada resposta para o Peer " + chunk_requester_info.ip + ":" + std::to_string(chunk_requester_info.port) +
-                   " com chunks disponíveis do arquivo '" + file_name + "': " + chunks_ss.str());
+                   " com chunks disponíveis do arquivo '" + file_name + "': " + *response_message);
     } else {
-        logMessage(LogType::INFO, "Nenhum chunk disponível para o arquivo '" + file_name + "'");
+        LOG_MESSAGE(LogType::INFO, "Nenhum chunk disponível para o arquivo '" + file_name + "'");
     }    
 }
 
 
+/**
+ * @brief Retorna a mensagem RESPONSE de um arquivo, montando-a apenas se os chunks locais mudaram.
+ */
+std::shared_ptr<const std::string> UDPServer::getChunkResponseMessage(const std::string& file_name) {
+    uint64_t generation = 0;
+    bool cacheable = false;
+
+    // Os nomes de conteúdo não passam pelo cache: são muitos e nenhum aviso de chunks locais os invalida
+    if (ChunkStore::isContentName(file_name)) {
+        std::vector<int> chunks_available = file_manager.getAvailableChunks(file_name);
+        return std::make_shared<const std::string>(chunks_available.empty() ? std::string() : buildChunkResponseMessage(file_name, chunks_available));
+    }
+
+    {
+        // Caminho comum: a mensagem já montada é compartilhada entre as threads sem cópia
+        std::shared_lock<std::shared_mutex> read_lock(response_cache_mutex);
+        auto it = response_cache.find(file_name);
+        if (it != response_cache.end() && it->second.message) {
+            return it->second.message;
+        }
+    }
+
+    {
+        // Registra a geração atual antes de ler os chunks, para não guardar uma montagem anterior a um novo chunk
+        std::unique_lock<std::shared_mutex> write_lock(response_cache_mutex);
+        auto it = response_cache.find(file_name);
+        if (it == response_cache.end() && response_cache.size() < Constants::RESPONSE_CACHE_MAX_FILES) {
+            it = response_cache.emplace(file_name, CachedResponse()).first;
+        }
+        if (it != response_cache.end()) {
+            if (it->second.message) {
+                return it->second.message;
+            }
+            generation = it->second.generation;
+            cacheable = true;
+        }
+    }
+
+    std::vector<int> chunks_available = file_manager.getAvailableChunks(file_name);
+    auto message = std::make_shared<const std::string>(chunks_available.empty() ? std::string() : buildChunkResponseMessage(file_name, chunks_available));
+
+    if (cacheable) {
+        std::unique_lock<std::shared_mutex> write_lock(response_cache_mutex);
+        auto it = response_cache.find(file_name);
+        if (it != response_cache.end() && chunks_available.empty()) {
+            // Resposta vazia não fica em cache: as buscas por arquivos que o peer não tem ocupariam as vagas
+            // dos arquivos servidos, e o primeiro chunk local do arquivo não dependeria de um aviso para aparecer
+            if (!it->second.message) {
+                response_cache.erase(it);
+            }
+        } else if (it != response_cache.end() && it->second.generation == generation) {
+            it->second.message = message;
+        }
+    }
+
+    return message;
+}
+
+
+/**
+ * @brief Descarta a mensagem RESPONSE em cache de um arquivo cujos chunks locais mudaram.
+ */
+void UDPServer::invalidateChunkResponse(const std::string& file_name) {
+    std::unique_lock<std::shared_mutex> write_lock(response_cache_mutex);
+
+    auto it = response_cache.find(file_name);
+    if (it != response_cache.end()) {
+        it->second.generation++;
+        it->second.message.reset();
+    }
+}
+
+
 /**
  * @brief Envia uma mensagem (REQUEST) para pedir chunks específicos de um arquivo.
  */
-void UDPServer::sendChunkRequestMessage(const std::string& file_name) {
+int UDPServer::sendChunkRequestMessage(const std::string& file_name) {
     // Seleciona qual chunk pegar de qual peer
     auto chunks_by_peer = file_manager.selectPeersForChunkDownload(file_name);
+    int peers_requested = 0;
+
+    // Os chunks interrompidos (antes de um reinício ou em outra conexão) são pedidos a partir do byte em que pararam
+    std::map<int, size_t> offsets;
+    if (download_journal != nullptr) {
+        offsets = download_journal->getPartialOffsets(file_name);
+    }
 
     // Itera sobre cada peer e seus chunks
-    for (const auto& [peer_ip_port, chunks] : chunks_by_peer) {
+    for (const auto& [peer_ip_port, peer_chunks] : chunks_by_peer) {
+        // Os chunks encontrados pelo conteúdo são pedidos pelo nome de conteúdo, um REQUEST para cada
+        std::vector<int> chunks;
+        std::vector<std::string> request_messages;
+        for (int chunk : peer_chunks) {
+            std::string content_name = file_manager.getContentName(file_name, chunk, peer_ip_port);
+            if (content_name.empty()) {
+                chunks.push_back(chunk);
+            } else {
+                request_messages.push_back(buildChunkRequestMessage(content_name, {0}));
+                Metrics::instance().startTimer(peer_id, content_name, 0);
+            }
+        }
+
         // Monta a mensagem de requisição (REQUEST) para os chunks específicos
-        std::string request_message = buildChunkRequestMessage(file_name, chunks);
+        if (!chunks.empty()) {
+            request_messages.push_back(buildChunkRequestMessage(file_name, chunks, offsets));
+        }
 
         // Extrai a porta e o IP da string "iP:port"
         std::string peer_ip;
-        int peer_port;
+        int peer_port = 0;
 
         // Encontra a posição do ":" para separar o IP da porta
         std::size_t colon_pos = peer_ip_port.find(':');
@@ -214,25 +510,42 @@ void UDPServer::sendChunkRequestMessage(const std::string& file_name) {
             peer_port = std::stoi(peer_ip_port.substr(colon_pos + 1)); // Converte a porta para int
         }
 
-        // Envia a mensagem REQUEST via UDP para o peer (IP e porta)
-        ssize_t bytes_sent = sendUDPMessage(peer_ip, peer_port, request_message);
+        // Inicia a medição do tempo até o recebimento completo de cada chunk pedido
+        for (const int& chunk : chunks) {
+            Metrics::instance().startTimer(peer_id, file_name, chunk);
+        }
 
-        if (bytes_sent < 0) {
-            perror("Erro ao enviar mensagem UDP REQUEST de chunks");
-        } else {
-            logMessage(LogType::REQUEST_SENT, "Mensagem REQUEST enviada para " + peer_ip_port +
-                       " -> " + request_message);
+        // Envia as mensagens REQUEST via UDP para o peer (IP e porta)
+        bool requested = false;
+        for (const std::string& request_message : request_messages) {
+            ssize_t bytes_sent = sendUDPMessage(peer_ip, peer_port, request_message);
+
+            if (bytes_sent < 0) {
+                perror("Erro ao enviar mensagem UDP REQUEST de chunks");
+            } else {
+                requested = true;
+                LOG_MESSAGE(LogType::REQUEST_SENT, "Mensagem REQUEST enviada para " + peer_ip_port +
+                           " -> " + request_message);
+            }
         }
+        peers_requested += requested;
     }
+
+    return peers_requested;
 }
 
 
 /**
  * @brief Monta a mensagem de descoberta (DISCOVERY) de um arquivo para envio.
  */
-std::string UDPServer::buildChunkDiscoveryMessage(const std::string& file_name, int total_chunks, int ttl, const PeerInfo& chunk_requester_info) const {
+std::string UDPServer::buildChunkDiscoveryMessage(const std::string& file_name, int total_chunks, int ttl, const PeerInfo& chunk_requester_info,
+                                                  uint64_t search_id, std::chrono::milliseconds aggregation_window) const {
     std::stringstream ss;
     ss << "DISCOVERY " << file_name << " " << total_chunks << " " << ttl << " " << chunk_requester_info.ip << ":" << chunk_requester_info.port;
+    if (search_id != 0) {
+        // Campos opcionais da agregação, ignorados pelos peers que não os conhecem
+        ss << " " << search_id << " " << aggregation_window.count();
+    }
     return ss.str();
 }
 
@@ -255,7 +568,8 @@ std::string UDPServer::buildChunkResponseMessage(const std::string& file_name, c
 /**
  * @brief Monta a mensagem de requisição (REQUEST) para pedir chunks específicos de um arquivo.
  */
-std::string UDPServer::buildChunkRequestMessage(const std::string& file_name, const std::vector<int>& chunks) const {
+std::string UDPServer::buildChunkRequestMessage(const std::string& file_name, const std::vector<int>& chunks,
+                                                const std::map<int, size_t>& offsets) const {
     std::stringstream ss;
     ss << "REQUEST " << file_name << " " << tcp_port << " ";
     
@@ -263,6 +577,20 @@ std::string UDPServer::buildChunkRequestMessage(const std::string& file_name, co
         ss << chunk << " ";
     }
 
+    // Formatos de compressão aceitos nos chunks enviados via TCP, ignorados pelos peers sem compressão
+    static const std::string codecs = Compression::codecsToString(Compression::supportedCodecs());
+    ss << "codecs=" << codecs;
+
+    // Faixas dos chunks interrompidos, ignoradas pelos peers que enviam sempre o chunk inteiro
+    const char* separator = " ranges=";
+    for (int chunk : chunks) {
+        auto it = offsets.find(chunk);
+        if (it != offsets.end()) {
+            ss << separator << chunk << ":" << it->second;
+            separator = ",";
+        }
+    }
+
     return ss.str();
 }
 
@@ -270,32 +598,84 @@ std::string UDPServer::buildChunkRequestMessage(const std::string& file_name, co
 /**
  * @brief Processa uma mensagem recebida de outro peer.
  */
-void UDPServer::processMessage(const std::string& message, const PeerInfo& direct_sender_info) {
-    std::stringstream ss(message);
-    std::string command, file_name;
-    ss >> command;
+void UDPServer::processMessage(std::string_view message, const PeerInfo& direct_sender_info) {
+    MessageTokenizer tokens(message);
+    std::string_view command;
+    tokens.next(command);
+    MessageType type = MessageParser::parseType(command);
 
-    if (command == "DISCOVERY") {
-         processChunkDiscoveryMessage(ss, direct_sender_info);
-    } else if (command == "RESPONSE") {
-        {
-            std::streampos pos_before_file_name = ss.tellg(); // Salva a posição antes de ler o file_name
-            ss >> file_name;
+    Metrics::instance().add(Counter::MESSAGES_IN, Metrics::messageLabel(peer_id, command, direct_sender_info.ip, direct_sender_info.port));
+
+    // Qualquer mensagem recebida de um vizinho comprova que ele está vivo, mesmo que um heartbeat se perca
+    if (membership != nullptr) {
+        membership->markAlive(direct_sender_info);
+    }
+
+    // Os campos apontam para o buffer do datagrama, que existe até o fim do processamento
+    bool parsed = true;
+
+    if (type == MessageType::DISCOVERY) {
+        DiscoveryMessage discovery;
+        parsed = MessageParser::parseDiscovery(tokens, discovery);
+        if (parsed) {
+            processChunkDiscoveryMessage(discovery, direct_sender_info);
+        }
+    } else if (type == MessageType::RESPONSE) {
+        ResponseMessage response;
+        parsed = MessageParser::parseResponse(tokens, response);
+        if (parsed) {
+            // A busca heterogênea do mapa evita montar uma std::string só para a consulta
             std::lock_guard<std::mutex> file_lock(processing_mutex);
-            if (processing_active_map[file_name]) {
-                ss.clear(); // Limpa qualquer flag de erro no stream
-                ss.seekg(pos_before_file_name); // Volta para a posição antes de ler o file_name
-                processChunkResponseMessage(ss, direct_sender_info);
+            auto it = processing_active_map.find(response.file_name);
+            if (it != processing_active_map.end() && it->second) {
+                processChunkResponseMessage(response, direct_sender_info);
             } else {
-                logMessage(LogType::OTHER, "Mensagem RESPONSE recebida para " + file_name + ", mas o processamento está desativado.");
+                LOG_MESSAGE(LogType::OTHER, "Mensagem RESPONSE recebida para " + std::string(response.file_name) + ", mas o processamento está desativado.");
             }
         }
     }
-    else if (command == "REQUEST") {
-        processChunkRequestMessage(ss, direct_sender_info);
+    else if (type == MessageType::REQUEST) {
+        RequestMessage request;
+        parsed = MessageParser::parseRequest(tokens, request);
+        if (parsed) {
+            processChunkRequestMessage(request, direct_sender_info);
+        }
+    }
+    else if (MessageParser::isMembershipType(type)) {
+        MembershipMessage membership_message;
+        parsed = MessageParser::parseMembership(type, tokens, membership_message);
+        if (parsed && membership != nullptr) {
+            membership->processMembershipMessage(membership_message, direct_sender_info);
+        }
+    }
+    else if (type == MessageType::AGGREGATE) {
+        AggregateMessage aggregate;
+        parsed = MessageParser::parseAggregate(message, tokens, aggregate);
+        if (parsed && aggregator != nullptr) {
+            aggregator->processAggregateMessage(aggregate, direct_sender_info);
+        }
+    }
+    else if (type == MessageType::HAVE) {
+        HaveMessage have;
+        parsed = MessageParser::parseHave(tokens, have);
+        if (parsed && have_announcer != nullptr) {
+            have_announcer->processHaveMessage(have, direct_sender_info);
+        }
+    }
+    else if (MessageParser::isDHTType(type)) {
+        DHTMessage dht_message;
+        parsed = MessageParser::parseDHT(type, tokens, dht_message);
+        if (parsed && dht != nullptr) {
+            dht->processDHTMessage(dht_message, direct_sender_info);
+        }
     }
     else {
-        logMessage(LogType::ERROR, "Comando desconhecido recebido: " + command);
+        LOG_MESSAGE(LogType::ERROR, "Comando desconhecido recebido: " + std::string(command));
+    }
+
+    if (!parsed) {
+        LOG_MESSAGE(LogType::ERROR, "Mensagem " + std::string(command) + " mal formada recebida do Peer " + direct_sender_info.ip + ":" +
+                    std::to_string(direct_sender_info.port));
     }
 }
 
@@ -303,36 +683,46 @@ void UDPServer::processMessage(const std::string& message, const PeerInfo& direc
 /**
  * @brief Processa uma mensagem de descoberta (DISCOVERY) recebida de outro peer.
  */
-void UDPServer::processChunkDiscoveryMessage(std::stringstream& message, const PeerInfo& direct_sender_info) {
-    std::string file_name, chunk_requester_ip_port, chunk_requester_ip;
-    int total_chunks, ttl, chunk_requester_port;
-    size_t colon_pos;
-
-    // Extrai os dados da mensagem DISCOVERY
-    message >> file_name >> total_chunks >> ttl >> chunk_requester_ip_port;
-
-    // Separa o IP e a porta do peer original
-    colon_pos = chunk_requester_ip_port.find(':');
-    chunk_requester_ip = chunk_requester_ip_port.substr(0, colon_pos);
-    chunk_requester_port = std::stoi(chunk_requester_ip_port.substr(colon_pos + 1));
-
+void UDPServer::processChunkDiscoveryMessage(const DiscoveryMessage& discovery, const PeerInfo& direct_sender_info) {
     // Só manda mensagem de descoberta de mensagens que não foi o próprio peer que enviou
-    if (chunk_requester_ip != ip || chunk_requester_port != port) {
-        logMessage(LogType::DISCOVERY_RECEIVED,
-                "Recebido pedido de descoberta do arquivo '" + file_name + "' com TTL " + std::to_string(ttl) +
-                " do Peer " + direct_sender_info.ip + ":" + std::to_string(direct_sender_info.port) +
-                ". Resposta será enviada para o Peer " + chunk_requester_ip + ":" + std::to_string(chunk_requester_port));
+    if (discovery.requester_ip == ip && discovery.requester_port == port) {
+        return;
+    }
 
-        // Monta um Peer Info do solicitante dos chunks do arquivo
-        PeerInfo chunk_requester_info(std::string(chunk_requester_ip), chunk_requester_port);
+    // Os campos usados além desta função são copiados do buffer do datagrama
+    std::string file_name(discovery.file_name);
+    int total_chunks = discovery.total_chunks;
+    int ttl = discovery.ttl;
+    uint64_t search_id = discovery.search_id;
+    std::chrono::milliseconds aggregation_window(discovery.window_ms);
+
+    // Monta um Peer Info do solicitante dos chunks do arquivo
+    PeerInfo chunk_requester_info(std::string(discovery.requester_ip), discovery.requester_port);
+
+    LOG_MESSAGE(LogType::DISCOVERY_RECEIVED,
+            "Recebido pedido de descoberta do arquivo '" + file_name + "' com TTL " + std::to_string(ttl) +
+            " do Peer " + direct_sender_info.ip + ":" + std::to_string(direct_sender_info.port) +
+            ". Resposta será enviada para o Peer " + chunk_requester_info.ip + ":" + std::to_string(chunk_requester_info.port));
+
+    // O solicitante passa a receber os anúncios HAVE dos chunks que este peer salvar depois da resposta
+    // (os anúncios usam o nome do arquivo, então as buscas por conteúdo não registram interesse)
+    if (have_announcer != nullptr && !ChunkStore::isContentName(file_name)) {
+        have_announcer->registerInterest(file_name, chunk_requester_info);
+    }
 
+    if (search_id != 0 && aggregator != nullptr) {
+        // Busca agregada: a resposta segue pelo caminho reverso e as cópias repetidas não são propagadas
+        if (!aggregator->beginAggregation(search_id, file_name, total_chunks, ttl, aggregation_window, direct_sender_info)) {
+            return;
+        }
+    } else {
         // Verifica se possui chunks do arquivo e envia a resposta
         sendChunkResponseMessage(file_name, chunk_requester_info);
+    }
 
-        // Propaga a mensagem para os vizinhos se o TTL for maior que zero
-        if (ttl > 0) {
-            sendChunkDiscoveryMessage(file_name, total_chunks, ttl - 1, chunk_requester_info);
-        }
+    // Propaga a mensagem para os vizinhos se o TTL for maior que zero
+    if (ttl > 0) {
+        sendChunkDiscoveryMessage(file_name, total_chunks, ttl - 1, chunk_requester_info, search_id, aggregation_window);
     }
 }
 
@@ -340,16 +730,14 @@ void UDPServer::processChunkDiscoveryMessage(std::stringstream& message, const P
 /**
  * @brief Processa uma mensagem de resposta (RESPONSE) recebida de outro peer.
  */
-void UDPServer::processChunkResponseMessage(std::stringstream& message, const PeerInfo& direct_sender_info) {
-    std::string file_name;
-    int transfer_speed;
+void UDPServer::processChunkResponseMessage(const ResponseMessage& response, const PeerInfo& direct_sender_info) {
+    std::string file_name(response.file_name);
     std::vector<int> chunks_received;
 
-    // Extrai o nome do arquivo e os chunks disponíveis
-    message >> file_name >> transfer_speed;
+    // Só a primeira resposta após a rodada de descoberta é contabilizada
+    Metrics::instance().stopTimer(Histogram::DISCOVERY_TO_FIRST_RESPONSE_MS, peer_id, file_name);
 
-    int chunk;
-    while (message >> chunk) {
+    for (int chunk : response.chunks) {
         // Só adiciona no map chunk_location_info os chunks que eu não possuo
         bool has_chunk = file_manager.hasChunk(file_name, chunk);
         if (!has_chunk) {
@@ -358,36 +746,29 @@ void UDPServer::processChunkResponseMessage(std::stringstream& message, const Pe
     }
 
     if (chunks_received.size() > 0) {
-        std::stringstream chunks_ss;
-
+        std::string chunks_str;
         for (const int& chunk : chunks_received) {
-            chunks_ss << chunk << " ";
+            chunks_str += std::to_string(chunk) + " ";
         }
 
         // Armazena as respostas recebidas no mapa
-        file_manager.storeChunkLocationInfo(file_name, chunks_received, direct_sender_info.ip, direct_sender_info.port, transfer_speed);
+        file_manager.storeChunkLocationInfo(file_name, chunks_received, direct_sender_info.ip, direct_sender_info.port, response.transfer_speed);
 
-        logMessage(LogType::RESPONSE_RECEIVED,
+        LOG_MESSAGE(LogType::RESPONSE_RECEIVED,
                "Recebida resposta do Peer " + direct_sender_info.ip + ":" + std::to_string(direct_sender_info.port) +
-               " para o arquivo '" + file_name + "'. Chunks disponíveis: " + chunks_ss.str());
+               " para o arquivo '" + file_name + "'. Chunks disponíveis: " + chunks_str);
     }
 }
 
 /**
  * @brief Processa uma mensagem de requisição (REQUEST) recebida de outro peer.
  */
-void UDPServer::processChunkRequestMessage(std::stringstream& message, const PeerInfo& direct_sender_info) {
-    std::string file_name;
-    std::vector<int> requested_chunks;
-    int tcp_port, chunk_id;
-
-    // Extrai o nome do arquivo e porta TCP
-    message >> file_name >> tcp_port;
-
-    // Extrai os IDs dos chunks solicitados
-    while (message >> chunk_id) {
-        requested_chunks.push_back(chunk_id);
-    }
+void UDPServer::processChunkRequestMessage(const RequestMessage& request, const PeerInfo& direct_sender_info) {
+    std::string file_name(request.file_name);
+    std::vector<int> requested_chunks(request.chunks.begin(), request.chunks.end());
+    int tcp_port = request.tcp_port;
+    uint32_t accepted_codecs = Compression::parseCodecs(request.codecs);
+    std::map<int, size_t> offsets = MessageParser::parseRanges(request.ranges);
 
     // Cria uma string com todos os chunks solicitados
     std::string chunks_str;
@@ -395,14 +776,20 @@ void UDPServer::processChunkRequestMessage(std::stringstream& message, const Pee
         chunks_str += std::to_string(chunk) + " ";
     }
 
-    logMessage(LogType::REQUEST_RECEIVED,
+    LOG_MESSAGE(LogType::REQUEST_RECEIVED,
                "Recebida requisição de chunks do Peer " + direct_sender_info.ip + ":" + std::to_string(direct_sender_info.port) +
                " para o arquivo '" + file_name + "'. Chunks solicitados: " + chunks_str);
 
+    // Os chunks entram na fila justa do escalonador de envios, que os transfere via TCP em uma das vagas
+    if (upload_scheduler != nullptr) {
+        upload_scheduler->enqueue(file_name, requested_chunks, direct_sender_info, tcp_port, accepted_codecs, offsets);
+        return;
+    }
+
     PeerInfo direct_sender_info_tcp = PeerInfo(direct_sender_info.ip, tcp_port);
 
     // Envia os chunks via TCP
-    tcp_server.sendChunks(file_name, requested_chunks, direct_sender_info_tcp);
+    tcp_server.sendChunks(file_name, requested_chunks, direct_sender_info_tcp, accepted_codecs, offsets);
 }
 
 
@@ -410,12 +797,7 @@ void UDPServer::processChunkRequestMessage(std::stringstream& message, const Pee
  * @brief  Espera por um tempo determinado pelas respostas e então desativa o processamento de respostas para o arquivo.
  */
 void UDPServer::waitForResponses(const std::string& file_name) {
-    std::this_thread::sleep_for(std::chrono::seconds(Constants::RESPONSE_TIMEOUT_SECONDS)); // Aguarda o tempo de resposta
-
-    {
-        std::lock_guard<std::mutex> file_lock(processing_mutex);
-        processing_active_map[file_name] = false; // Desativa o processamento para o file_name após o timeout
-    }
+    std::this_thread::sleep_for(timing.response_timeout); // Aguarda o tempo de resposta
 
-    logMessage(LogType::INFO, "Processamento de mensagens RESPONSE desativado para o arquivo: " + file_name);
+    finalizeProcessingActive(file_name); // Desativa o processamento para o file_name após o timeout
 }
@@ -1,16 +1,34 @@
 #ifndef UDPSERVER_H
 #define UDPSERVER_H
 
+#include "BufferPool.h"
 #include "FileManager.h"
+#include "MessageParser.h"
 #include "TCPServer.h"
 #include "Utils.h"
+#include "WorkStealingExecutor.h"
 #include <string>
+#include <string_view>
 #include <map>
 #include <vector>
 #include <set>
 #include <tuple>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <queue>
+#include <cstdint>
 #include <unordered_map>
+#include <memory>
 #include <mutex>
+#include <shared_mutex>
+
+class DHTNode;
+class DownloadJournal;
+class HaveAnnouncer;
+class MembershipManager;
+class ResponseAggregator;
+class UploadScheduler;
 
 /**
  * @brief Classe responsável por gerenciar a comunicação UDP para descoberta de chunks de um arquivo em uma rede P2P.
@@ -29,10 +47,50 @@ private:
     const int transfer_speed;                               ///< Velocidade de transferência de dados em bytes/segundo.
     int sockfd;                                             ///< Descriptor do socket UDP utilizado para a comunicação.
     std::vector<std::tuple<std::string, int>> udpNeighbors; ///< Lista contendo os vizinhos diretos do peer (endereços IP e portas UDP).
-    std::map<std::string, bool> processing_active_map;      ///< Mapa para controlar o estado de processamento de cada arquivo. Mapeia file_name para processing_active.
+    std::mutex neighbors_mutex;                             ///< Mutex para proteger o acesso à lista de vizinhos, alterada em tempo de execução pelo MembershipManager.
+    MembershipManager* membership;                          ///< Gerenciador de vizinhança que trata as mensagens de membership (nulo: vizinhança estática).
+    DHTNode* dht;                                           ///< Nó da DHT que trata as mensagens DHT_* (nulo: mensagens da DHT descartadas).
+    ResponseAggregator* aggregator;                         ///< Agregador das respostas no caminho reverso (nulo: descobertas agregadas são respondidas diretamente).
+    HaveAnnouncer* have_announcer;                          ///< Anunciante dos chunks recebidos aos solicitantes das descobertas (nulo: mensagens HAVE descartadas).
+    UploadScheduler* upload_scheduler;                      ///< Escalonador dos envios de chunks pedidos (nulo: os chunks são enviados na thread da mensagem).
+    DownloadJournal* download_journal;                      ///< Diário dos downloads, com os bytes já recebidos dos chunks interrompidos (nulo: chunks sempre pedidos inteiros).
+    std::atomic<uint64_t> next_search_id;                   ///< Próximo identificador das buscas com respostas agregadas.
+    std::map<std::string, bool, std::less<>> processing_active_map; ///< Mapa para controlar o estado de processamento de cada arquivo. Mapeia file_name para processing_active.
     std::mutex processing_mutex;                            ///< Mutex para proteger o acesso ao processing_active_map.
+
+    /**
+     * @brief Estrutura com a mensagem RESPONSE já montada de um arquivo.
+     */
+    struct CachedResponse {
+        uint64_t generation = 0;                            ///< Número de invalidações do arquivo, usado para descartar montagens concorrentes a um novo chunk.
+        std::shared_ptr<const std::string> message;         ///< Mensagem montada (vazia: o peer não possui chunks; nula: precisa ser montada).
+    };
+
+    std::unordered_map<std::string, CachedResponse> response_cache; ///< Mensagens RESPONSE montadas, por arquivo.
+    std::shared_mutex response_cache_mutex;                 ///< Mutex para proteger o response_cache (leituras compartilhadas no envio das respostas).
+
+    /**
+     * @brief Estrutura com uma mensagem de descoberta propagada, enviada a um vizinho a partir de um horário.
+     */
+    struct PacedMessage {
+        std::chrono::steady_clock::time_point send_at;      ///< Horário a partir do qual a mensagem é enviada.
+        std::string neighbor_ip;                            ///< Endereço IP do vizinho.
+        int neighbor_port;                                  ///< Porta UDP do vizinho.
+        std::string message;                                ///< Mensagem DISCOVERY montada.
+
+        /**
+         * @brief Ordena as mensagens pelo horário de envio (a fila de prioridade entrega primeiro a mais próxima).
+         */
+        bool operator>(const PacedMessage& other) const { return send_at > other.send_at; }
+    };
+
+    std::priority_queue<PacedMessage, std::vector<PacedMessage>, std::greater<PacedMessage>> paced_messages; ///< Mensagens propagadas aguardando o horário de envio.
+    std::mutex paced_mutex;                                 ///< Mutex para proteger a fila de mensagens propagadas.
+    std::condition_variable paced_cv;                       ///< Variável de condição para acordar a thread de envio quando há uma mensagem mais próxima.
     FileManager& file_manager;                              ///< Referência ao gerenciador de chunks de um arquivo.
     TCPServer& tcp_server;                                  ///< Referência ao servidor TCP.
+    const TimingConfig timing;                              ///< Tempos de espera do protocolo.
+    WorkStealingExecutor& executor;                         ///< Executor compartilhado do peer, que processa as mensagens recebidas com a maior prioridade.
 
 public:
     /**
@@ -49,8 +107,11 @@ public:
      * @param transfer_speed Velocidade de transferência de dados em bytes/segundo do peer.
      * @param file_manager Referência ao gerenciador de arquivos do peer.
      * @param tcp_server Referência ao servidor TCP do peer.
+     * @param executor Referência ao executor compartilhado do peer.
+     * @param timing Tempos de espera do protocolo (padrão: valores de Constants.h).
      */
-    UDPServer(const std::string& ip, int port, int tcp_port, int peer_id, int transfer_speed, FileManager& file_manager, TCPServer& tcp_server);
+    UDPServer(const std::string& ip, int port, int tcp_port, int peer_id, int transfer_speed, FileManager& file_manager, TCPServer& tcp_server,
+              WorkStealingExecutor& executor, const TimingConfig& timing = TimingConfig());
 
 
     /**
@@ -62,6 +123,14 @@ public:
     void run();
 
 
+    /**
+     * @brief Loop da thread que envia as mensagens de descoberta propagadas no horário marcado.
+     * 
+     * Assim, o intervalo entre os vizinhos na propagação não ocupa as threads de processamento.
+     */
+    void runPacer();
+
+
     /**
      * @brief Função para criar e configurar o socket UDP.
      * 
@@ -85,6 +154,17 @@ public:
     void initializeProcessingActive(std::string file_name);
 
 
+    /**
+     * @brief Encerra o recebimento de respostas para chunks de um arquivo específico.
+     * 
+     * Após a chamada, respostas que chegarem para o arquivo identificado por file_name
+     * são descartadas.
+     * 
+     * @param file_name O nome do arquivo para o qual as respostas deixarão de ser processadas.
+     */
+    void finalizeProcessingActive(const std::string& file_name);
+
+
     /**
      * @brief Função que envia uma mensagem UDP.
      * 
@@ -109,6 +189,95 @@ public:
     void setUDPNeighbors(const std::vector<std::tuple<std::string, int>>& neighbors);
 
 
+    /**
+     * @brief Adiciona um vizinho à lista usada no envio das mensagens de descoberta.
+     * 
+     * @param neighbor_ip Endereço IP do vizinho.
+     * @param neighbor_port Porta UDP do vizinho.
+     * @return true se o vizinho foi adicionado, false se ele já estava na lista.
+     */
+    bool addUDPNeighbor(const std::string& neighbor_ip, int neighbor_port);
+
+
+    /**
+     * @brief Remove um vizinho da lista usada no envio das mensagens de descoberta.
+     * 
+     * @param neighbor_ip Endereço IP do vizinho.
+     * @param neighbor_port Porta UDP do vizinho.
+     * @return true se o vizinho estava na lista e foi removido.
+     */
+    bool removeUDPNeighbor(const std::string& neighbor_ip, int neighbor_port);
+
+
+    /**
+     * @brief Retorna uma cópia da lista de vizinhos atual.
+     * 
+     * A cópia permite percorrer os vizinhos sem manter o mutex durante os envios.
+     * 
+     * @return Vizinhos do peer (IP e Porta UDP).
+     */
+    std::vector<std::tuple<std::string, int>> getUDPNeighbors();
+
+
+    /**
+     * @brief Associa o gerenciador de vizinhança que tratará as mensagens HEARTBEAT, JOIN, GET_PEERS, PEERS e LEAVE.
+     * 
+     * Sem um gerenciador associado, essas mensagens são descartadas e a vizinhança é a definida por setUDPNeighbors.
+     * 
+     * @param membership Ponteiro para o gerenciador de vizinhança do peer.
+     */
+    void setMembershipManager(MembershipManager* membership);
+
+
+    /**
+     * @brief Associa o nó da DHT que tratará as mensagens DHT_FIND_NODE, DHT_FIND_VALUE, DHT_NODES, DHT_VALUE e DHT_STORE.
+     * 
+     * @param dht Ponteiro para o nó da DHT do peer.
+     */
+    void setDHTNode(DHTNode* dht);
+
+
+    /**
+     * @brief Associa o agregador que tratará as descobertas com identificador de busca e as mensagens AGGREGATE.
+     * 
+     * @param aggregator Ponteiro para o agregador de respostas do peer.
+     */
+    void setResponseAggregator(ResponseAggregator* aggregator);
+
+
+    /**
+     * @brief Associa o anunciante que registra os solicitantes das descobertas e trata as mensagens HAVE.
+     * 
+     * @param have_announcer Ponteiro para o anunciante de chunks do peer.
+     */
+    void setHaveAnnouncer(HaveAnnouncer* have_announcer);
+
+
+    /**
+     * @brief Associa o escalonador que recebe os chunks pedidos em mensagens REQUEST.
+     * 
+     * @param upload_scheduler Ponteiro para o escalonador de envios do peer.
+     */
+    void setUploadScheduler(UploadScheduler* upload_scheduler);
+
+
+    /**
+     * @brief Associa o diário dos downloads, consultado para pedir os chunks interrompidos a partir do byte em que pararam.
+     * 
+     * @param download_journal Ponteiro para o diário de downloads do peer.
+     */
+    void setDownloadJournal(DownloadJournal* download_journal);
+
+
+    /**
+     * @brief Indica se as respostas para um arquivo estão sendo processadas.
+     * 
+     * @param file_name Nome do arquivo.
+     * @return true entre initializeProcessingActive e finalizeProcessingActive.
+     */
+    bool isProcessingActive(const std::string& file_name);
+
+
     /**
      * @brief Obtém o endereço IP e a porta UDP do peer a partir de uma estrutura sockaddr_in.
      * 
@@ -125,20 +294,40 @@ public:
      * @brief Envia uma mensagem de descoberta (DISCOVERY) para todos os vizinhos.
      * 
      * Essa mensagem será usada para solicitar a localização de um arquivo específico na rede.
+     * A função não espera: o primeiro vizinho recebe a mensagem logo e os demais, um
+     * discovery_message_interval depois do anterior, pela thread de runPacer.
      * 
      * @param file_name Nome do arquivo que o peer deseja localizar.
      * @param total_chunks Número total de chunks que compõem o arquivo.
      * @param ttl Time-to-live para limitar o alcance do flooding.
      * @param chunk_requester_info Informações sobre o peer que solicitou os chunks do arquivo, como seu endereço IP e porta UDP.
+     * @param search_id Identificador da busca com respostas agregadas (0: cada peer responde diretamente).
+     * @param aggregation_window Janela por salto da agregação, repassada sem alteração.
      */
-    void sendChunkDiscoveryMessage(const std::string& file_name, int total_chunks, int ttl, const PeerInfo& chunk_requester_info);
+    void sendChunkDiscoveryMessage(const std::string& file_name, int total_chunks, int ttl, const PeerInfo& chunk_requester_info,
+                                   uint64_t search_id = 0, std::chrono::milliseconds aggregation_window = std::chrono::milliseconds(0));
+
+
+    /**
+     * @brief Envia, em uma única rodada, mensagens de descoberta (DISCOVERY) de vários arquivos para todos os vizinhos.
+     * 
+     * Cada vizinho recebe de uma vez as mensagens de todos os arquivos, e o intervalo entre
+     * vizinhos é respeitado apenas uma vez por rodada, em vez de uma vez por arquivo. Os arquivos
+     * no modo AGGREGATE recebem um identificador de busca novo e a janela por salto
+     * response_timeout / (ttl + 1), para que os resumos do caminho reverso cheguem dentro do prazo.
+     * 
+     * @param files Tuplas com o nome do arquivo, número total de chunks, TTL inicial e modo de descoberta.
+     * @param chunk_requester_info Informações sobre o peer que solicitou os chunks, como seu endereço IP e porta UDP.
+     */
+    void sendChunkDiscoveryRound(const std::vector<std::tuple<std::string, int, int, DiscoveryMode>>& files, const PeerInfo& chunk_requester_info);
     
 
     /**
      * @brief Envia uma resposta (RESPONSE) contendo os chunks disponíveis para um arquivo.
      * 
      * Após receber uma solicitação de descoberta, essa função envia uma resposta 
-     * para o peer solicitante informando quais chunks estão disponíveis.
+     * para o peer solicitante informando quais chunks estão disponíveis. A mensagem vem
+     * de getChunkResponseMessage, então uma resposta repetida é um único sendto.
      * 
      * @param file_name Nome do arquivo solicitado.
      * @param chunk_requester_info Informações sobre o peer que solicitou os chunks do arquivo, como seu endereço IP e porta UDP.
@@ -146,15 +335,42 @@ public:
     void sendChunkResponseMessage(const std::string& file_name, const PeerInfo& chunk_requester_info);
 
 
+    /**
+     * @brief Retorna a mensagem RESPONSE de um arquivo, montando-a apenas se os chunks locais mudaram.
+     * 
+     * As mensagens ficam em cache por arquivo até invalidateChunkResponse. Quando o cache já
+     * tem Constants::RESPONSE_CACHE_MAX_FILES arquivos, a mensagem de um arquivo novo é montada
+     * sem ser guardada. As respostas vazias (arquivos sem chunks locais) nunca são guardadas.
+     * 
+     * @param file_name Nome do arquivo.
+     * @return Mensagem RESPONSE montada, ou string vazia se o peer não possui chunks do arquivo.
+     */
+    std::shared_ptr<const std::string> getChunkResponseMessage(const std::string& file_name);
+
+
+    /**
+     * @brief Descarta a mensagem RESPONSE em cache de um arquivo cujos chunks locais mudaram.
+     * 
+     * Chamado pelo FileManager quando um chunk local é adicionado (saveChunk, reaproveitamento,
+     * reconstrução ou publicação com codificação de apagamento).
+     * 
+     * @param file_name Nome do arquivo.
+     */
+    void invalidateChunkResponse(const std::string& file_name);
+
+
     /**
      * @brief Envia uma mensagem (REQUEST) para pedir chunks específicos de um arquivo.
      * 
      * Esta função percorre o mapa gerenciado por FileManager que contém os peers selecionados
-     * para enviar cada chunk, e envia uma mensagem fazendo a solicitação a eles.
+     * para enviar cada chunk, e envia uma mensagem fazendo a solicitação a eles. Os chunks que um peer
+     * possui sob outro arquivo (respostas a nomes de conteúdo) são pedidos em um REQUEST por chunk, com
+     * o nome de conteúdo no lugar do nome do arquivo.
      * 
      * @param file_name O nome do arquivo cujos chunks estão sendo solicitados.
+     * @return Número de peers para os quais uma mensagem REQUEST foi enviada.
      */
-    void sendChunkRequestMessage(const std::string& file_name);
+    int sendChunkRequestMessage(const std::string& file_name);
 
 
     /**
@@ -167,9 +383,12 @@ public:
      * @param total_chunks Número total de chunks do arquivo.
      * @param ttl Time-to-live da mensagem DISCOVERY.
      * @param chunk_requester_info Informações sobre o peer que solicitou os chunks do arquivo, como seu endereço IP e porta UDP.
+     * @param search_id Identificador da busca com respostas agregadas (0: campo omitido).
+     * @param aggregation_window Janela por salto da agregação (usada apenas com search_id).
      * @return String contendo a mensagem DISCOVERY formatada.
      */
-    std::string buildChunkDiscoveryMessage(const std::string& file_name, int total_chunks, int ttl, const PeerInfo& chunk_requester_info) const;
+    std::string buildChunkDiscoveryMessage(const std::string& file_name, int total_chunks, int ttl, const PeerInfo& chunk_requester_info,
+                                           uint64_t search_id = 0, std::chrono::milliseconds aggregation_window = std::chrono::milliseconds(0)) const;
 
 
     /**
@@ -188,13 +407,17 @@ public:
     /**
      * @brief Monta a mensagem de requisição (REQUEST) para pedir chunks específicos de um arquivo.
      * 
-     * Esta função cria a mensagem solicitando chunks a um peer.
+     * Esta função cria a mensagem solicitando chunks a um peer. Após os chunks, a mensagem
+     * anuncia os formatos de compressão que o peer descomprime ("codecs=lz4,zstd") e, para os
+     * chunks interrompidos, o byte a partir do qual eles devem ser enviados ("ranges=3:1048576").
      * 
      * @param file_name O nome do arquivo cujos chunks estão sendo solicitados.
      * @param chunks Lista de IDs dos chunks que estão sendo solicitados.
+     * @param offsets Bytes já recebidos de cada chunk interrompido (padrão: nenhum).
      * @return A string contendo a mensagem REQUEST montada.
      */
-    std::string buildChunkRequestMessage(const std::string& file_name, const std::vector<int>& chunks) const;
+    std::string buildChunkRequestMessage(const std::string& file_name, const std::vector<int>& chunks,
+                                         const std::map<int, size_t>& offsets = {}) const;
 
 
     /**
@@ -202,11 +425,13 @@ public:
      * 
      * A mensagem recebida será analisada e processada em uma nova thread para 
      * melhorar o desempenho e permitir a recepção simultânea de várias mensagens.
+     * O comando e os campos são lidos pelo MessageParser sem cópias, e cada tratador
+     * recebe a estrutura já interpretada da sua mensagem.
      * 
-     * @param message A mensagem recebida.
+     * @param message A mensagem recebida (no servidor, os bytes do datagrama no buffer do pool, sem cópia).
      * @param direct_sender_info Informações sobre o peer que enviou diretamente a mensagem, incluindo seu endereço IP e porta UDP.
      */
-    void processMessage(const std::string& message, const PeerInfo& direct_sender_info);
+    void processMessage(std::string_view message, const PeerInfo& direct_sender_info);
 
 
     /**
@@ -216,12 +441,13 @@ public:
      * por peers que estão buscando um arquivo na rede. A função extrai as informações 
      * da mensagem, verifica se o peer atual possui os chunks do arquivo solicitado e, 
      * caso positivo, envia uma resposta. Caso o TTL (Time-to-Live) ainda esteja válido, 
-     * a mensagem é propagada para os vizinhos.
+     * a mensagem é propagada para os vizinhos. Descobertas com identificador de busca são
+     * entregues ao ResponseAggregator, que responde pelo caminho reverso e descarta as cópias repetidas.
      * 
-     * @param message Stream com os dados da mensagem DISCOVERY.
+     * @param discovery Campos da mensagem DISCOVERY.
      * @param direct_sender_info Informações sobre o peer que enviou diretamente a mensagem, incluindo seu endereço IP e porta UDP.
      */
-    void processChunkDiscoveryMessage(std::stringstream& message, const PeerInfo& direct_sender_info);
+    void processChunkDiscoveryMessage(const DiscoveryMessage& discovery, const PeerInfo& direct_sender_info);
 
 
     /**
@@ -231,10 +457,10 @@ public:
      * uma solicitação de descoberta de arquivo. Ela extrai as informações do peer que 
      * enviou a resposta positiva a sua mensagem de descoberta.
      * 
-     * @param message Stream com os dados da mensagem RESPONSE.
+     * @param response Campos da mensagem RESPONSE.
      * @param direct_sender_info Informações sobre o peer que enviou diretamente a mensagem, incluindo seu endereço IP e porta UDP.
      */
-    void processChunkResponseMessage(std::stringstream& message, const PeerInfo& direct_sender_info);
+    void processChunkResponseMessage(const ResponseMessage& response, const PeerInfo& direct_sender_info);
 
 
     /**
@@ -243,10 +469,10 @@ public:
      * Este método analisa a mensagem de requisição de chunks e inicia a transferência
      * dos chunks solicitados usando o servidor TCP associado.
      * 
-     * @param message Stream com os dados da mensagem de requisição.
+     * @param request Campos da mensagem de requisição.
      * @param direct_sender_info Informações sobre o peer que enviou a requisição, incluindo seu endereço IP e porta UDP.
      */
-    void processChunkRequestMessage(std::stringstream& message, const PeerInfo& direct_sender_info);
+    void processChunkRequestMessage(const RequestMessage& request, const PeerInfo& direct_sender_info);
 
 
     /**
@@ -0,0 +1,194 @@
+#include "UploadScheduler.h"
+#include "Metrics.h"
+#include <algorithm>
+#include <filesystem>
+
+
+/**
+ * @brief Construtor da classe UploadScheduler.
+ */
+UploadScheduler::UploadScheduler(int peer_id, TCPServer& tcp_server, FileManager& file_manager, WorkStealingExecutor& executor, int slots,
+                                 bool tit_for_tat)
+    : peer_id(peer_id), tcp_server(tcp_server), file_manager(file_manager), executor(executor), slots(std::max(1, slots)),
+      tit_for_tat(tit_for_tat), active_slots(0), starting_slots(0) {}
+
+
+/**
+ * @brief Coloca na fila do solicitante os chunks pedidos em uma mensagem REQUEST.
+ */
+size_t UploadScheduler::enqueue(const std::string& file_name, const std::vector<int>& chunks, const PeerInfo& requester_info, int tcp_port,
+                                uint32_t codecs, const std::map<int, size_t>& offsets) {
+    // Os tamanhos são lidos antes de travar o mutex, pois dependem do sistema de arquivos
+    std::vector<UploadJob> jobs;
+    for (int chunk : chunks) {
+        std::error_code error;
+        auto size = std::filesystem::file_size(file_manager.getChunkPath(file_name, chunk), error);
+
+        // Um chunk inexistente segue com tamanho zero e é relatado por sendChunks; uma faixa além do fim do chunk é ignorada
+        auto it = offsets.find(chunk);
+        size_t offset = it != offsets.end() && !error && it->second < size ? it->second : 0;
+        jobs.push_back({file_name, chunk, error ? 0 : static_cast<int64_t>(size - offset), offset});
+    }
+
+    auto key = std::make_tuple(requester_info.ip, requester_info.port);
+    size_t accepted = 0, choked = 0;
+    {
+        std::lock_guard<std::mutex> lock(upload_mutex);
+
+        Requester& requester = requesters[key];
+        bool was_idle = requester.jobs.empty() && !requester.active;
+        requester.tcp_port = tcp_port;
+        requester.codecs = codecs;
+
+        for (UploadJob& job : jobs) {
+            if (requester.queued.count(std::make_tuple(job.file_name, job.chunk)) > 0) {
+                continue;
+            }
+            if (requester.jobs.size() >= Constants::UPLOAD_MAX_QUEUED_CHUNKS_PER_PEER) {
+                ++choked;
+                continue;
+            }
+            requester.queued.emplace(job.file_name, job.chunk);
+            requester.jobs.push_back(std::move(job));
+            ++accepted;
+        }
+
+        if (requester.jobs.empty() && !requester.active) {
+            // Nada a enviar (pedido só com repetidos ou recusados): o solicitante não entra na rodada
+            requesters.erase(key);
+        } else if (was_idle && accepted > 0) {
+            // Solicitante novo na rodada, começa sem crédito
+            requester.deficit = 0;
+            round.push_back(key);
+            dispatchLocked();
+        }
+    }
+
+    if (choked > 0) {
+        Metrics::instance().add(Counter::UPLOAD_CHUNKS_CHOKED, Metrics::peerLabel(peer_id, requester_info.ip, requester_info.port), choked);
+        LOG_MESSAGE(LogType::INFO, std::to_string(choked) + " chunks de " + file_name + " pedidos pelo Peer " + requester_info.ip + ":" +
+                    std::to_string(requester_info.port) + " recusados: fila de envio cheia.");
+    }
+
+    return accepted;
+}
+
+
+/**
+ * @brief Registra o recebimento de um chunk enviado por um peer, para o tit-for-tat.
+ */
+void UploadScheduler::recordReceived(const ChunkLocationInfo& sender) {
+    if (!tit_for_tat || sender.ip.empty()) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(upload_mutex);
+    last_received[std::make_tuple(sender.ip, sender.port)] = std::chrono::steady_clock::now();
+}
+
+
+/**
+ * @brief Retorna o número de chunks aguardando envio.
+ */
+size_t UploadScheduler::queuedChunks() {
+    std::lock_guard<std::mutex> lock(upload_mutex);
+
+    size_t total = 0;
+    for (const auto& [key, requester] : requesters) {
+        total += requester.jobs.size();
+    }
+    return total;
+}
+
+
+/**
+ * @brief Ocupa as vagas livres com tarefas de envio enquanto houver solicitantes na rodada.
+ */
+void UploadScheduler::dispatchLocked() {
+    // Cada tarefa atende um solicitante, então não há mais tarefas a caminho que solicitantes aguardando na rodada
+    while (active_slots < slots && static_cast<size_t>(starting_slots) < round.size()) {
+        ++active_slots;
+        ++starting_slots;
+        executor.submit(TaskPriority::UPLOAD, [this] { runSlot(); });
+    }
+}
+
+
+/**
+ * @brief Tarefa de uma vaga de envio: atende o próximo solicitante da rodada com uma rajada e libera a vaga.
+ */
+void UploadScheduler::runSlot() {
+    std::unique_lock<std::mutex> lock(upload_mutex);
+    --starting_slots;
+
+    while (!round.empty()) {
+        auto key = round.front();
+        round.pop_front();
+        Requester& requester = requesters[key];
+
+        // Deficit round robin: o crédito se acumula até cobrir o próximo chunk
+        requester.deficit += quantumLocked(key, std::chrono::steady_clock::now());
+
+        // Os chunks do mesmo arquivo que cabem no crédito seguem juntos em uma conexão
+        std::string file_name = requester.jobs.front().file_name;
+        std::vector<int> burst;
+        std::map<int, size_t> burst_offsets;
+        while (!requester.jobs.empty() && requester.jobs.front().file_name == file_name && requester.jobs.front().size <= requester.deficit) {
+            const UploadJob& job = requester.jobs.front();
+            requester.deficit -= job.size;
+            burst.push_back(job.chunk);
+            if (job.offset > 0) {
+                burst_offsets[job.chunk] = job.offset;
+            }
+            requester.queued.erase(std::make_tuple(job.file_name, job.chunk));
+            requester.jobs.pop_front();
+        }
+
+        if (burst.empty()) {
+            // Crédito insuficiente para o próximo chunk: o solicitante volta ao fim da rodada
+            round.push_back(key);
+            continue;
+        }
+
+        requester.active = true;
+        PeerInfo destination_info(std::get<0>(key), requester.tcp_port);
+        uint32_t codecs = requester.codecs;
+
+        // A transferência é feita fora do mutex, para que as outras vagas e os novos pedidos sigam
+        lock.unlock();
+        tcp_server.sendChunks(file_name, burst, destination_info, codecs, burst_offsets);
+        lock.lock();
+
+        // A referência continua válida: um solicitante ativo não é removido por enqueue
+        requester.active = false;
+        if (requester.jobs.empty()) {
+            // Fila vazia: o crédito restante não é guardado (deficit round robin)
+            requesters.erase(key);
+        } else {
+            round.push_back(key);
+        }
+        break;
+    }
+
+    // Uma rajada por tarefa: a vaga é liberada e volta a ser ocupada por uma nova tarefa se a rodada não está vazia
+    --active_slots;
+    dispatchLocked();
+}
+
+
+/**
+ * @brief Retorna o crédito que um solicitante recebe a cada vez na rodada.
+ */
+int64_t UploadScheduler::quantumLocked(const std::tuple<std::string, int>& requester, std::chrono::steady_clock::time_point now) {
+    if (tit_for_tat) {
+        auto it = last_received.find(requester);
+        if (it != last_received.end()) {
+            if (now - it->second <= std::chrono::seconds(Constants::UPLOAD_RECIPROCATION_WINDOW_SECONDS)) {
+                return static_cast<int64_t>(Constants::UPLOAD_QUANTUM_BYTES) * Constants::UPLOAD_RECIPROCATION_WEIGHT;
+            }
+            // Reciprocidade antiga não conta mais
+            last_received.erase(it);
+        }
+    }
+    return Constants::UPLOAD_QUANTUM_BYTES;
+}
@@ -0,0 +1,142 @@
+#ifndef UPLOADSCHEDULER_H
+#define UPLOADSCHEDULER_H
+
+#include "FileManager.h"
+#include "TCPServer.h"
+#include "Utils.h"
+#include "WorkStealingExecutor.h"
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <set>
+#include <string>
+#include <tuple>
+#include <vector>
+
+
+/**
+ * @brief Classe que controla os envios de chunks com um número limitado de vagas e uma fila justa entre os solicitantes.
+ *
+ * Os chunks pedidos em mensagens REQUEST entram na fila do solicitante (identificado pelo IP e
+ * pela porta UDP) em vez de serem enviados na thread que processou a mensagem. Cada vaga de
+ * envio ocupada é uma tarefa TaskPriority::UPLOAD do executor compartilhado, que escolhe o próximo
+ * solicitante por deficit round robin: a cada vez, o solicitante recebe Constants::UPLOAD_QUANTUM_BYTES
+ * de crédito e envia, em uma conexão, os chunks do mesmo arquivo que cabem no crédito acumulado.
+ * A tarefa termina após uma rajada e, se a rodada não está vazia, submete a próxima, então as
+ * tarefas de maior prioridade passam à frente entre duas rajadas. Um solicitante ocupa no máximo
+ * uma vaga por vez, então um pedido de milhares de chunks não impede o atendimento dos demais.
+ *
+ * Com o tit-for-tat habilitado, os peers dos quais o peer recebeu chunks nos últimos
+ * Constants::UPLOAD_RECIPROCATION_WINDOW_SECONDS segundos recebem Constants::UPLOAD_RECIPROCATION_WEIGHT
+ * vezes o crédito. Os chunks pedidos além de Constants::UPLOAD_MAX_QUEUED_CHUNKS_PER_PEER na fila
+ * de um solicitante são recusados (choke) e voltam a ser pedidos após a transferência sem progresso.
+ */
+class UploadScheduler {
+private:
+    /**
+     * @brief Estrutura com um chunk aguardando envio.
+     */
+    struct UploadJob {
+        std::string file_name;                                          ///< Nome do arquivo.
+        int chunk;                                                      ///< Número do chunk.
+        int64_t size;                                                   ///< Bytes a enviar (o chunk a partir de offset), descontados do crédito do solicitante.
+        size_t offset;                                                  ///< Byte inicial do envio (0: chunk inteiro; senão, chunk interrompido no solicitante).
+    };
+
+    /**
+     * @brief Estrutura com a fila e o crédito de um solicitante.
+     */
+    struct Requester {
+        int tcp_port = 0;                                               ///< Porta TCP do solicitante, que recebe os chunks.
+        uint32_t codecs = 0;                                            ///< Formatos de compressão anunciados no último pedido do solicitante.
+        std::deque<UploadJob> jobs;                                     ///< Chunks aguardando envio, na ordem dos pedidos.
+        std::set<std::tuple<std::string, int>> queued;                  ///< Arquivo e chunk de cada item da fila, para ignorar pedidos repetidos.
+        int64_t deficit = 0;                                            ///< Crédito acumulado em bytes (deficit round robin).
+        bool active = false;                                            ///< Indica que uma vaga está enviando chunks ao solicitante.
+    };
+
+    const int peer_id;                                                  ///< Identificador único (ID) do peer.
+    TCPServer& tcp_server;                                              ///< Referência ao servidor TCP, que transfere os chunks.
+    FileManager& file_manager;                                          ///< Referência ao gerenciador de arquivos do peer.
+    WorkStealingExecutor& executor;                                     ///< Executor compartilhado do peer, que executa as rajadas de envio.
+    const int slots;                                                    ///< Número de vagas (envios simultâneos).
+    const bool tit_for_tat;                                             ///< Indica se os peers que enviam chunks ao peer recebem crédito maior.
+    std::map<std::tuple<std::string, int>, Requester> requesters;       ///< Solicitantes com chunks pendentes, por IP e porta UDP.
+    std::deque<std::tuple<std::string, int>> round;                     ///< Ordem da rodada entre os solicitantes com chunks pendentes e sem vaga.
+    std::map<std::tuple<std::string, int>, std::chrono::steady_clock::time_point> last_received;
+    ///< Instante do último chunk recebido de cada peer (IP e porta UDP), usado pelo tit-for-tat.
+    int active_slots;                                                   ///< Número de vagas ocupadas (tarefas de envio submetidas e não concluídas).
+    int starting_slots;                                                 ///< Número de tarefas de envio submetidas que ainda não escolheram um solicitante.
+    std::mutex upload_mutex;                                            ///< Mutex para proteger as filas, a rodada, as vagas e os chunks recebidos.
+
+    /**
+     * @brief Ocupa as vagas livres com tarefas de envio enquanto houver solicitantes na rodada. Deve ser chamado com upload_mutex bloqueado.
+     */
+    void dispatchLocked();
+
+
+    /**
+     * @brief Tarefa de uma vaga de envio: atende o próximo solicitante da rodada com uma rajada e libera a vaga.
+     */
+    void runSlot();
+
+
+    /**
+     * @brief Retorna o crédito que um solicitante recebe a cada vez na rodada. Deve ser chamado com upload_mutex bloqueado.
+     *
+     * @param requester Solicitante (IP e porta UDP).
+     * @param now Instante atual.
+     * @return Crédito em bytes.
+     */
+    int64_t quantumLocked(const std::tuple<std::string, int>& requester, std::chrono::steady_clock::time_point now);
+
+public:
+    /**
+     * @brief Construtor da classe UploadScheduler.
+     *
+     * @param peer_id ID do peer.
+     * @param tcp_server Referência ao servidor TCP do peer.
+     * @param file_manager Referência ao gerenciador de arquivos do peer.
+     * @param executor Referência ao executor compartilhado do peer.
+     * @param slots Número de vagas de envio (padrão: Constants::UPLOAD_SLOTS, no mínimo 1).
+     * @param tit_for_tat Indica se os peers que enviam chunks ao peer recebem crédito maior (padrão: Constants::UPLOAD_TIT_FOR_TAT).
+     */
+    UploadScheduler(int peer_id, TCPServer& tcp_server, FileManager& file_manager, WorkStealingExecutor& executor,
+                    int slots = Constants::UPLOAD_SLOTS, bool tit_for_tat = Constants::UPLOAD_TIT_FOR_TAT);
+
+
+    /**
+     * @brief Coloca na fila do solicitante os chunks pedidos em uma mensagem REQUEST.
+     *
+     * @param file_name Nome do arquivo.
+     * @param chunks Chunks pedidos.
+     * @param requester_info Peer que enviou o pedido (IP e porta UDP).
+     * @param tcp_port Porta TCP do solicitante, que receberá os chunks.
+     * @param codecs Formatos de compressão que o solicitante descomprime (padrão: nenhum).
+     * @param offsets Byte inicial de cada chunk interrompido no solicitante (padrão: nenhum, os chunks seguem inteiros).
+     * @return Número de chunks colocados na fila (os repetidos e os recusados não são contados).
+     */
+    size_t enqueue(const std::string& file_name, const std::vector<int>& chunks, const PeerInfo& requester_info, int tcp_port,
+                   uint32_t codecs = 0, const std::map<int, size_t>& offsets = {});
+
+
+    /**
+     * @brief Registra o recebimento de um chunk enviado por um peer, para o tit-for-tat.
+     *
+     * @param sender Peer que enviou o chunk (IP e porta UDP).
+     */
+    void recordReceived(const ChunkLocationInfo& sender);
+
+
+    /**
+     * @brief Retorna o número de chunks aguardando envio.
+     *
+     * @return Soma das filas de todos os solicitantes.
+     */
+    size_t queuedChunks();
+};
+
+#endif // UPLOADSCHEDULER_H
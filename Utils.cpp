@@ -1,65 +1,29 @@
 #include "Utils.h"
-#include <mutex>
 #include <arpa/inet.h>
 #include <cstring>
 
 
-//< Mutex para proteger a saída do console
-std::mutex cout_mutex;
-
-
 /**
  * @brief Remove espaços em branco ao redor de uma string.
  */
 std::string trim(const std::string& str) {
-    return std::regex_replace(str, std::regex("^\\s+|\\s+$"), "");
+    const char* whitespace = " \t\n\r\f\v";
+
+    size_t begin = str.find_first_not_of(whitespace);
+    if (begin == std::string::npos) {
+        return "";
+    }
+
+    size_t end = str.find_last_not_of(whitespace);
+    return str.substr(begin, end - begin + 1);
 }
 
 
 /**
- * @brief Formata e exibe mensagens de log de forma consistente, com cores.
+ * @brief Enfileira uma mensagem de log para ser escrita de forma assíncrona pelo Logger.
  */
 void logMessage(LogType type, const std::string& message) {
-    std::lock_guard<std::mutex> message_lock(cout_mutex); // Bloqueia o acesso à saída do console
-    switch (type) {
-        case LogType::DISCOVERY_RECEIVED:
-            std::cout << Constants::YELLOW << "[DISCOVERY_RECEIVED] " << message;
-            break;
-        case LogType::DISCOVERY_SENT:
-            std::cout << Constants::MAGENTA << "[DISCOVERY_SENT] " << message;
-            break;
-        case LogType::RESPONSE_RECEIVED:
-            std::cout << Constants::CYAN << "[RESPONSE_RECEIVED] " << message;
-            break;
-        case LogType::RESPONSE_SENT:
-            std::cout << Constants::GRAY << "[RESPONSE_SENT] " << message;
-            break;
-        case LogType::REQUEST_RECEIVED:
-            std::cout << Constants::ORANGE << "[REQUEST_RECEIVED] " << message;
-            break;
-        case LogType::REQUEST_SENT:
-            std::cout << Constants::PINK << "[REQUEST_SENT] " << message;
-            break;
-        case LogType::CHUNK_RECEIVED:
-            std::cout << Constants::GOLD << "[CHUNK_RECEIVED] " << message;
-            break;
-        case LogType::CHUNK_SENT:
-            std::cout << Constants::AQUA << "[CHUNK_SENT] " << message;
-            break;
-        case LogType::SUCCESS:
-            std::cout << Constants::GREEN << "[SUCCESS] " << message;
-            break;
-        case LogType::INFO:
-            std::cout << Constants::BLUE << "[INFO] " << message;
-            break;
-        case LogType::ERROR:
-            std::cout << Constants::RED << "[ERROR] " << message;
-            break;
-        default:
-            std::cout << Constants::ORANGE << "[OTHER] " << message;
-            break;
-    }
-    std::cout << Constants::RESET << std::endl; // Reseta a cor do texto e finaliza a linha
+    Logger::instance().log(type, message);
 }
 
 
@@ -67,40 +31,12 @@ void logMessage(LogType type, const std::string& message) {
  * @brief Exibe uma mensagem de sucesso.
  */
 void displaySuccessMessage(const std::string& file_name, const std::string& peer_id) {
-    std::lock_guard<std::mutex> message_lock(cout_mutex); // Bloqueia o acesso à saída do console
-    
-    // Definição das cores
-    std::string colors[] = {
-        Constants::RED,
-        Constants::YELLOW,
-        Constants::GREEN,
-        Constants::BLUE,
-        Constants::MAGENTA,
-        Constants::RED,
-    };
-
-    // Mensagem central em branco
-    std::string message = "Arquivo " + file_name + " montado com sucesso no Peer " + peer_id + "!";
-    int width = message.length() + 8;
-
-    // Exibe as bordas coloridas (superior)
-    for (int i = 0; i < 3; ++i) {
-        std::cout << colors[i] << std::string(width, '#') << Constants::RESET << "\n";
+    if (!Logger::isEnabled(LogType::SUCCESS)) {
+        return;
     }
 
-    // Moldura interna (superior)
-    std::cout << colors[3] << "###" << colors[4] << std::string(width - 6, ' ') << colors[3] << "###" << Constants::RESET << "\n";
-
-    // Mensagem central em branco
-    std::cout << colors[3] << "### " << Constants::RESET << message << colors[3] << " ###" << Constants::RESET << "\n";
-
-    // Moldura interna (inferior)
-    std::cout << colors[3] << "###" << colors[4] << std::string(width - 6, ' ') << colors[3] << "###" << Constants::RESET << "\n";
-
-    // Exibe as bordas coloridas (inferior)
-    for (int i = 0; i < 3; ++i) {
-        std::cout << colors[i] << std::string(width, '#') << Constants::RESET << "\n";
-    }
+    // A moldura colorida é desenhada pelo Logger no formato texto
+    Logger::instance().log(LogType::SUCCESS, "Arquivo " + file_name + " montado com sucesso no Peer " + peer_id + "!", true);
 }
 
 
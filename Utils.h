@@ -2,27 +2,36 @@
 #define UTILS_H
 
 #include "Constants.h"
+#include "Logger.h"
+#include <chrono>
 #include <iostream>
-#include <regex>
 #include <string>
 
 
 /**
- * @brief Enumeração para os tipos de mensagens de log
+ * @brief Estrutura com os tempos de espera do protocolo.
+ *
+ * Os valores padrão são os de Constants.h, pensados para peers executados em terminais
+ * separados. A simulação com vários peers em um único processo os reduz para medir a vazão
+ * sem as esperas fixas.
  */
-enum class LogType {
-    ERROR,
-    INFO,
-    DISCOVERY_RECEIVED,
-    DISCOVERY_SENT,
-    REQUEST_RECEIVED,
-    REQUEST_SENT,
-    RESPONSE_RECEIVED,
-    RESPONSE_SENT,
-    CHUNK_SENT,
-    CHUNK_RECEIVED,
-    SUCCESS,
-    OTHER
+struct TimingConfig {
+    std::chrono::milliseconds server_startup_delay{std::chrono::seconds(Constants::SERVER_STARTUP_DELAY_SECONDS)};               ///< Espera para os servidores dos outros peers iniciarem.
+    std::chrono::milliseconds discovery_message_interval{std::chrono::seconds(Constants::DISCOVERY_MESSAGE_INTERVAL_SECONDS)};   ///< Espera entre mensagens de descoberta para vizinhos diferentes.
+    std::chrono::milliseconds response_timeout{std::chrono::seconds(Constants::RESPONSE_TIMEOUT_SECONDS)};                       ///< Prazo para receber as respostas de uma rodada de descoberta.
+    std::chrono::milliseconds transfer_block_interval{std::chrono::seconds(Constants::TRANSFER_BLOCK_INTERVAL_SECONDS)};         ///< Espera entre blocos de transfer_speed bytes enviados via TCP.
+    std::chrono::milliseconds scheduler_tick{Constants::SCHEDULER_TICK_MILLISECONDS};                                           ///< Intervalo entre as verificações do escalonador de downloads.
+    std::chrono::milliseconds download_stall_timeout{std::chrono::seconds(Constants::DOWNLOAD_STALL_TIMEOUT_SECONDS)};           ///< Tempo sem novos chunks após o qual os faltantes são buscados novamente.
+    std::chrono::milliseconds heartbeat_interval{std::chrono::seconds(Constants::HEARTBEAT_INTERVAL_SECONDS)};                   ///< Intervalo entre os heartbeats e as verificações de vizinhança.
+    std::chrono::milliseconds neighbor_timeout{std::chrono::seconds(Constants::NEIGHBOR_TIMEOUT_SECONDS)};                       ///< Tempo sem mensagens de um vizinho após o qual ele é removido.
+    std::chrono::milliseconds dht_publish_interval{std::chrono::seconds(Constants::DHT_PUBLISH_INTERVAL_SECONDS)};               ///< Intervalo entre as verificações de chunks novos a publicar na DHT.
+    std::chrono::milliseconds dht_republish_interval{std::chrono::seconds(Constants::DHT_REPUBLISH_INTERVAL_SECONDS)};           ///< Intervalo após o qual os registros do peer são publicados novamente.
+    std::chrono::milliseconds dht_record_ttl{std::chrono::seconds(Constants::DHT_RECORD_TTL_SECONDS)};                           ///< Validade de um registro recebido por DHT_STORE.
+    std::chrono::milliseconds dht_rpc_timeout{Constants::DHT_RPC_TIMEOUT_MILLISECONDS};                                         ///< Prazo para a resposta de uma consulta da DHT.
+    std::chrono::milliseconds availability_cache_ttl{std::chrono::seconds(Constants::AVAILABILITY_CACHE_TTL_SECONDS)};           ///< Validade dos chunks conhecidos de outro peer no cache de disponibilidade.
+    std::chrono::milliseconds have_interval{Constants::HAVE_INTERVAL_MILLISECONDS};                                             ///< Intervalo entre os anúncios HAVE dos chunks recém-salvos.
+    std::chrono::milliseconds have_interest_ttl{std::chrono::seconds(Constants::HAVE_INTEREST_TTL_SECONDS)};                     ///< Tempo após a última descoberta durante o qual o solicitante recebe anúncios HAVE.
+    std::chrono::milliseconds download_journal_flush{Constants::DOWNLOAD_JOURNAL_FLUSH_MILLISECONDS};                           ///< Intervalo entre as gravações do diário de downloads.
 };
 
 
@@ -36,13 +45,27 @@ std::string trim(const std::string& str);
 
 
 /**
- * @brief Formata e exibe mensagens de log de forma consistente, com cores.
+ * @brief Enfileira uma mensagem de log para ser escrita de forma assíncrona pelo Logger.
  * 
  * @param type Tipo da mensagem.
  * @param message A mensagem a ser exibida no log.
  */
 void logMessage(LogType type, const std::string& message);
 
+
+/**
+ * @brief Gera uma mensagem de log apenas se o tipo estiver habilitado no nível atual.
+ * 
+ * A expressão da mensagem só é avaliada (e a string só é montada) quando o tipo está
+ * habilitado, evitando o custo de formatação de mensagens que seriam descartadas.
+ */
+#define LOG_MESSAGE(type, message)                  \
+    do {                                            \
+        if (Logger::isEnabled(type)) {              \
+            logMessage((type), (message));          \
+        }                                           \
+    } while (0)
+
 /**
  * @brief Exibe uma mensagem de sucesso.
  * 
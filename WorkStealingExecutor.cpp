@@ -0,0 +1,172 @@
+#include "WorkStealingExecutor.h"
+#include <algorithm>
+
+
+namespace {
+    // Executor e índice da thread atual, quando ela é uma das threads de um executor (nulo: thread externa)
+    thread_local const WorkStealingExecutor* current_executor = nullptr;
+    thread_local size_t current_index = 0;
+}
+
+
+/**
+ * @brief Construtor da classe WorkStealingExecutor. Cria as threads de execução.
+ */
+WorkStealingExecutor::WorkStealingExecutor(int num_threads) : pending(0), stopping(false) {
+    // As filas são criadas antes das threads, pois qualquer thread pode roubar das demais
+    for (int i = 0; i < std::max(1, num_threads); ++i) {
+        worker_queues.push_back(std::make_unique<WorkerQueues>());
+    }
+    for (size_t i = 0; i < worker_queues.size(); ++i) {
+        workers.emplace_back(&WorkStealingExecutor::workerLoop, this, i);
+    }
+}
+
+
+/**
+ * @brief Destrutor da classe WorkStealingExecutor. Executa as tarefas restantes e finaliza as threads.
+ */
+WorkStealingExecutor::~WorkStealingExecutor() {
+    {
+        std::lock_guard<std::mutex> idle_lock(idle_mutex);
+        stopping = true;
+    }
+    idle_cv.notify_all();
+
+    for (auto& worker : workers) {
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+}
+
+
+/**
+ * @brief Adiciona uma tarefa ao executor.
+ */
+void WorkStealingExecutor::submit(TaskPriority priority, std::function<void()> task) {
+    size_t level = static_cast<size_t>(priority);
+
+    if (current_executor == this) {
+        // Tarefa criada por outra tarefa: fica na fila da thread, que a executa em seguida se ninguém a roubar
+        WorkerQueues& queues = *worker_queues[current_index];
+        std::lock_guard<std::mutex> queues_lock(queues.mutex);
+        queues.tasks[level].push_back(std::move(task));
+    } else {
+        std::lock_guard<std::mutex> global_lock(global_mutex);
+        global_tasks[level].push_back(std::move(task));
+    }
+
+    // O contador sobe depois da tarefa entrar na fila, e o aviso passa pelo mutex da espera para não se perder
+    pending.fetch_add(1);
+    {
+        std::lock_guard<std::mutex> idle_lock(idle_mutex);
+    }
+    idle_cv.notify_one();
+}
+
+
+/**
+ * @brief Fixa as threads do executor nos núcleos do peer.
+ */
+void WorkStealingExecutor::pin(const ThreadPlacement& placement) {
+    size_t worker_cores = placement.worker_cpus.size();
+    size_t cores = worker_cores + placement.io_cpus.size();
+
+    for (size_t i = 0; i < workers.size(); ++i) {
+        size_t core = cores > 0 ? i % cores : 0;
+        if (core < worker_cores) {
+            CpuTopology::pinThread(workers[i], placement.cpusFor(ThreadRole::WORKER, static_cast<int>(core)));
+        } else {
+            CpuTopology::pinThread(workers[i], placement.cpusFor(ThreadRole::IO, static_cast<int>(core - worker_cores)));
+        }
+    }
+}
+
+
+/**
+ * @brief Retorna o número de threads do executor.
+ */
+size_t WorkStealingExecutor::threadCount() const {
+    return workers.size();
+}
+
+
+/**
+ * @brief Retorna o número de tarefas aguardando execução.
+ */
+size_t WorkStealingExecutor::pendingTasks() const {
+    return pending.load();
+}
+
+
+/**
+ * @brief Loop executado por cada thread, retirando e executando as tarefas de maior prioridade.
+ */
+void WorkStealingExecutor::workerLoop(size_t index) {
+    current_executor = this;
+    current_index = index;
+
+    while (true) {
+        std::function<void()> task;
+        if (takeTask(index, task)) {
+            task();
+            continue;
+        }
+
+        // Espera até haver uma tarefa em alguma fila ou o executor ser finalizado (só termina depois de esvaziar as filas)
+        std::unique_lock<std::mutex> idle_lock(idle_mutex);
+        if (stopping && pending.load() == 0) {
+            return;
+        }
+        idle_cv.wait(idle_lock, [this] { return stopping || pending.load() > 0; });
+    }
+}
+
+
+/**
+ * @brief Retira a próxima tarefa a executar: da fila da thread, da fila global ou roubada de outra thread.
+ */
+bool WorkStealingExecutor::takeTask(size_t index, std::function<void()>& task) {
+    if (pending.load() == 0) {
+        return false;
+    }
+
+    for (size_t level = 0; level < PRIORITY_COUNT; ++level) {
+        // Fila da própria thread, pelo fim: a tarefa mais recente
+        {
+            WorkerQueues& queues = *worker_queues[index];
+            std::lock_guard<std::mutex> queues_lock(queues.mutex);
+            if (!queues.tasks[level].empty()) {
+                task = std::move(queues.tasks[level].back());
+                queues.tasks[level].pop_back();
+                pending.fetch_sub(1);
+                return true;
+            }
+        }
+
+        // Fila global, na ordem de chegada
+        {
+            std::lock_guard<std::mutex> global_lock(global_mutex);
+            if (!global_tasks[level].empty()) {
+                task = std::move(global_tasks[level].front());
+                global_tasks[level].pop_front();
+                pending.fetch_sub(1);
+                return true;
+            }
+        }
+
+        // Filas das outras threads, pelo início: a tarefa mais antiga, a partir da thread seguinte para espalhar os roubos
+        for (size_t offset = 1; offset < worker_queues.size(); ++offset) {
+            WorkerQueues& victim = *worker_queues[(index + offset) % worker_queues.size()];
+            std::lock_guard<std::mutex> victim_lock(victim.mutex);
+            if (!victim.tasks[level].empty()) {
+                task = std::move(victim.tasks[level].front());
+                victim.tasks[level].pop_front();
+                pending.fetch_sub(1);
+                return true;
+            }
+        }
+    }
+    return false;
+}
@@ -0,0 +1,135 @@
+#ifndef WORKSTEALINGEXECUTOR_H
+#define WORKSTEALINGEXECUTOR_H
+
+#include "CpuTopology.h"
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+
+/**
+ * @brief Enumeração das prioridades das tarefas do executor compartilhado, da maior para a menor.
+ */
+enum class TaskPriority {
+    CONTROL,        ///< Mensagens de controle recebidas via UDP.
+    TRANSFER,       ///< Recebimento dos chunks das conexões TCP e gravação dos chunks recebidos.
+    UPLOAD,         ///< Envio dos chunks pedidos (uma rajada do UploadScheduler por tarefa).
+    ASSEMBLY,       ///< Montagem dos arquivos completos.
+    COUNT           ///< Número de prioridades (não é uma prioridade).
+};
+
+
+/**
+ * @brief Classe que executa as tarefas dos subsistemas do peer em um conjunto fixo de threads, com prioridades e roubo de tarefas.
+ *
+ * Cada thread tem uma fila de tarefas por prioridade. As tarefas criadas por uma tarefa em execução
+ * entram na fila da própria thread, que as retira pelo fim (a mais recente, ainda quente no cache);
+ * as demais entram em uma fila global por prioridade. Uma thread sem tarefas na sua fila busca na
+ * fila global e depois rouba pelo início (a mais antiga) das filas das outras threads. A busca
+ * percorre as prioridades da maior para a menor: uma tarefa de menor prioridade só é executada
+ * quando não há nenhuma de maior prioridade em fila, em nenhuma thread. As tarefas em execução
+ * não são interrompidas, então quem submete tarefas longas (conexões TCP, envios) limita quantas
+ * delas ocupam o executor ao mesmo tempo.
+ */
+class WorkStealingExecutor {
+private:
+    static constexpr size_t PRIORITY_COUNT = static_cast<size_t>(TaskPriority::COUNT); ///< Número de prioridades.
+
+    /**
+     * @brief Estrutura com as filas de uma thread do executor.
+     */
+    struct WorkerQueues {
+        std::array<std::deque<std::function<void()>>, PRIORITY_COUNT> tasks;    ///< Tarefas criadas pela thread, por prioridade.
+        std::mutex mutex;                                                       ///< Mutex para proteger as filas (a thread e os ladrões).
+    };
+
+    std::vector<std::unique_ptr<WorkerQueues>> worker_queues;                   ///< Filas de cada thread, pelo índice da thread.
+    std::array<std::deque<std::function<void()>>, PRIORITY_COUNT> global_tasks; ///< Tarefas submetidas de fora do executor, por prioridade.
+    std::mutex global_mutex;                                                    ///< Mutex para proteger as filas globais.
+    std::atomic<size_t> pending;                                                ///< Número de tarefas em fila, em todas as filas.
+    std::mutex idle_mutex;                                                      ///< Mutex da espera das threads sem tarefas.
+    std::condition_variable idle_cv;                                            ///< Acorda uma thread quando uma tarefa entra em fila.
+    bool stopping;                                                              ///< Indica que o executor está sendo finalizado.
+    std::vector<std::thread> workers;                                           ///< Threads que executam as tarefas.
+
+    /**
+     * @brief Loop executado por cada thread, retirando e executando as tarefas de maior prioridade.
+     *
+     * @param index Índice da thread.
+     */
+    void workerLoop(size_t index);
+
+
+    /**
+     * @brief Retira a próxima tarefa a executar: da fila da thread, da fila global ou roubada de outra thread.
+     *
+     * @param index Índice da thread.
+     * @param task Recebe a tarefa.
+     * @return true se havia uma tarefa em fila.
+     */
+    bool takeTask(size_t index, std::function<void()>& task);
+
+public:
+    /**
+     * @brief Construtor da classe WorkStealingExecutor. Cria as threads de execução.
+     *
+     * @param num_threads Número de threads do executor (no mínimo 1).
+     */
+    explicit WorkStealingExecutor(int num_threads);
+
+
+    /**
+     * @brief Destrutor da classe WorkStealingExecutor. Executa as tarefas restantes e finaliza as threads.
+     */
+    ~WorkStealingExecutor();
+
+
+    WorkStealingExecutor(const WorkStealingExecutor&) = delete;
+    WorkStealingExecutor& operator=(const WorkStealingExecutor&) = delete;
+
+
+    /**
+     * @brief Adiciona uma tarefa ao executor.
+     *
+     * Chamado por uma tarefa em execução, coloca a nova tarefa na fila da mesma thread; chamado
+     * de outra thread, na fila global.
+     *
+     * @param priority Prioridade da tarefa.
+     * @param task Tarefa a ser executada por uma das threads.
+     */
+    void submit(TaskPriority priority, std::function<void()> task);
+
+
+    /**
+     * @brief Fixa as threads do executor nos núcleos do peer.
+     *
+     * As threads executam tarefas de processamento e de E/S: ocupam os núcleos de processamento
+     * e depois os de E/S, voltando ao início quando há mais threads que núcleos.
+     *
+     * @param placement Núcleos das threads do peer.
+     */
+    void pin(const ThreadPlacement& placement);
+
+
+    /**
+     * @brief Retorna o número de threads do executor.
+     */
+    size_t threadCount() const;
+
+
+    /**
+     * @brief Retorna o número de tarefas aguardando execução.
+     *
+     * @return Soma das filas de todas as threads e das filas globais.
+     */
+    size_t pendingTasks() const;
+};
+
+#endif // WORKSTEALINGEXECUTOR_H
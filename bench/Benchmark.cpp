@@ -0,0 +1,159 @@
+#include "Benchmark.h"
+#include "Logger.h"
+#include <filesystem>
+#include <fstream>
+#include <atomic>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <sstream>
+#include <unistd.h>
+
+
+namespace {
+    std::atomic<uint64_t> allocation_count{0};      ///< Alocações feitas pelo operator new global.
+}
+
+
+/**
+ * @brief Substitui o operator new global para contar as alocações.
+ */
+void* operator new(std::size_t size) {
+    allocation_count.fetch_add(1, std::memory_order_relaxed);
+    if (void* pointer = std::malloc(size != 0 ? size : 1)) {
+        return pointer;
+    }
+    throw std::bad_alloc();
+}
+
+
+/**
+ * @brief Substitui o operator delete global, par do operator new acima.
+ */
+void operator delete(void* pointer) noexcept {
+    std::free(pointer);
+}
+
+
+/**
+ * @brief Substitui o operator delete global com tamanho, par do operator new acima.
+ */
+void operator delete(void* pointer, std::size_t) noexcept {
+    std::free(pointer);
+}
+
+
+/**
+ * @brief Retorna o número de alocações feitas pelo operator new global desde o início do processo.
+ */
+uint64_t allocationCount() {
+    return allocation_count.load(std::memory_order_relaxed);
+}
+
+
+/**
+ * @brief Registra o resultado de um benchmark medido externamente.
+ */
+BenchmarkResult& BenchmarkSuite::record(const std::string& name, std::vector<std::pair<std::string, double>> parameters,
+                                        uint64_t iterations, std::chrono::nanoseconds elapsed) {
+    BenchmarkResult result;
+    result.name = name;
+    result.parameters = std::move(parameters);
+    result.iterations = iterations;
+    result.elapsed_ns = static_cast<double>(elapsed.count());
+    results.push_back(std::move(result));
+
+    // Progresso em stderr para não misturar com o relatório
+    const BenchmarkResult& last = results.back();
+    std::cerr << last.name;
+    for (const auto& [key, value] : last.parameters) {
+        std::cerr << " " << key << "=" << value;
+    }
+    std::cerr << ": " << last.elapsed_ns / last.iterations << " ns/op\n";
+
+    return results.back();
+}
+
+
+/**
+ * @brief Gera o relatório com todos os resultados em JSON.
+ */
+std::string BenchmarkSuite::toJSON() const {
+    std::stringstream json;
+    json.precision(6);
+    json << std::fixed;
+
+    json << "{\n  \"benchmarks\": [\n";
+    for (size_t i = 0; i < results.size(); ++i) {
+        const BenchmarkResult& result = results[i];
+        double ns_per_op = result.elapsed_ns / result.iterations;
+
+        json << "    {\"name\": \"" << result.name << "\", \"parameters\": {";
+        for (size_t p = 0; p < result.parameters.size(); ++p) {
+            json << (p ? ", " : "") << "\"" << result.parameters[p].first << "\": "
+                 << std::defaultfloat << result.parameters[p].second << std::fixed;
+        }
+        json << "}, \"iterations\": " << result.iterations
+             << ", \"ns_per_op\": " << ns_per_op
+             << ", \"ops_per_sec\": " << 1e9 / ns_per_op;
+        if (result.bytes_per_operation > 0) {
+            json << ", \"bytes_per_sec\": " << result.bytes_per_operation * 1e9 / ns_per_op;
+        }
+        if (result.allocations >= 0) {
+            json << ", \"allocs_per_op\": " << static_cast<double>(result.allocations) / result.iterations;
+        }
+        json << "}" << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    json << "  ]\n}\n";
+
+    return json.str();
+}
+
+
+int main(int argc, char* argv[]) {
+    // Só erros são exibidos, para que o log não interfira nas medições
+    Logger::instance().setLevel(LogLevel::ERROR);
+
+    // Tempo mínimo de medição de cada benchmark em milissegundos
+    int min_time_ms = 200;
+    std::string output_path;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg.rfind("--min-time-ms=", 0) == 0) {
+            min_time_ms = std::stoi(arg.substr(14));
+        } else {
+            output_path = arg;
+        }
+    }
+
+    // Diretório temporário para os chunks gerados pelos benchmarks
+    std::string work_directory = (std::filesystem::temp_directory_path() / ("p2p-bench-" + std::to_string(getpid()))).string() + "/";
+    std::filesystem::create_directories(work_directory);
+
+    BenchmarkSuite suite{std::chrono::milliseconds(min_time_ms)};
+    runMessageBenchmarks(suite, work_directory);
+    runParserBenchmarks(suite);
+    runFileManagerBenchmarks(suite, work_directory);
+    runConfigBenchmarks(suite, work_directory);
+    runIOBenchmarks(suite, work_directory);
+    runBufferPoolBenchmarks(suite);
+    runErasureBenchmarks(suite);
+    runChunkingBenchmarks(suite);
+    runCompressionBenchmarks(suite);
+    runExecutorBenchmarks(suite);
+
+    std::filesystem::remove_all(work_directory);
+
+    // Escreve o relatório no arquivo informado ou na saída padrão
+    std::string report = suite.toJSON();
+    if (output_path.empty()) {
+        std::cout << report;
+    } else {
+        std::ofstream output(output_path);
+        output << report;
+        std::cerr << "Resultados gravados em " << output_path << "\n";
+    }
+
+    return 0;
+}
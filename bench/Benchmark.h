@@ -0,0 +1,191 @@
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+
+/**
+ * @brief Estrutura que armazena o resultado de um micro-benchmark.
+ */
+struct BenchmarkResult {
+    std::string name;                                       ///< Nome do benchmark (ex: "selectPeersForChunkDownload").
+    std::vector<std::pair<std::string, double>> parameters; ///< Parâmetros da execução (ex: chunks=1000, holders=10).
+    uint64_t iterations = 0;                                ///< Número de operações medidas.
+    double elapsed_ns = 0;                                  ///< Tempo total das operações em nanossegundos.
+    uint64_t bytes_per_operation = 0;                       ///< Bytes processados por operação (0 se não se aplica).
+    int64_t allocations = -1;                               ///< Alocações no heap durante a medição, em todas as threads (-1: não medido).
+};
+
+
+/**
+ * @brief Retorna o número de alocações feitas pelo operator new global desde o início do processo.
+ *
+ * O p2p-bench substitui o operator new para contar as alocações de todas as threads.
+ */
+uint64_t allocationCount();
+
+
+/**
+ * @brief Impede que o compilador descarte um valor calculado apenas para o benchmark.
+ *
+ * @param value Valor que deve ser considerado usado.
+ */
+template <typename T>
+inline void doNotOptimize(const T& value) {
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+
+/**
+ * @brief Classe que executa os micro-benchmarks e gera o relatório em JSON.
+ *
+ * Cada benchmark é repetido em lotes crescentes até somar o tempo mínimo de medição,
+ * de modo que operações rápidas e lentas tenham a mesma precisão relativa.
+ */
+class BenchmarkSuite {
+private:
+    std::vector<BenchmarkResult> results;                   ///< Resultados na ordem de execução.
+    const std::chrono::nanoseconds min_time;                ///< Tempo mínimo de medição de cada benchmark.
+
+public:
+    /**
+     * @brief Construtor da classe BenchmarkSuite.
+     *
+     * @param min_time Tempo mínimo de medição de cada benchmark.
+     */
+    explicit BenchmarkSuite(std::chrono::nanoseconds min_time) : min_time(min_time) {}
+
+
+    /**
+     * @brief Mede uma operação repetindo-a até atingir o tempo mínimo.
+     *
+     * @param name Nome do benchmark.
+     * @param parameters Parâmetros da execução.
+     * @param operation Operação medida, chamada uma vez por iteração.
+     * @return Referência ao resultado registrado.
+     */
+    template <typename Operation>
+    BenchmarkResult& run(const std::string& name, std::vector<std::pair<std::string, double>> parameters, Operation operation) {
+        uint64_t batch = 1;
+        uint64_t iterations = 0;
+        std::chrono::nanoseconds elapsed(0);
+        uint64_t allocations_before = allocationCount();
+
+        while (elapsed < min_time) {
+            auto start = std::chrono::steady_clock::now();
+            for (uint64_t i = 0; i < batch; ++i) {
+                operation();
+            }
+            elapsed += std::chrono::steady_clock::now() - start;
+            iterations += batch;
+            batch *= 2;
+        }
+
+        uint64_t allocations = allocationCount() - allocations_before;
+        BenchmarkResult& result = record(name, std::move(parameters), iterations, elapsed);
+        result.allocations = static_cast<int64_t>(allocations);
+        return result;
+    }
+
+
+    /**
+     * @brief Registra o resultado de um benchmark medido externamente (ex: várias threads).
+     *
+     * @param name Nome do benchmark.
+     * @param parameters Parâmetros da execução.
+     * @param iterations Número de operações medidas.
+     * @param elapsed Tempo total de parede das operações.
+     * @return Referência ao resultado registrado.
+     */
+    BenchmarkResult& record(const std::string& name, std::vector<std::pair<std::string, double>> parameters,
+                            uint64_t iterations, std::chrono::nanoseconds elapsed);
+
+
+    /**
+     * @brief Retorna o tempo mínimo de medição de cada benchmark.
+     */
+    std::chrono::nanoseconds getMinTime() const { return min_time; }
+
+
+    /**
+     * @brief Gera o relatório com todos os resultados em JSON.
+     *
+     * @return Relatório em JSON.
+     */
+    std::string toJSON() const;
+};
+
+
+/**
+ * @brief Executa os benchmarks de montagem e interpretação das mensagens UDP.
+ *
+ * @param suite Conjunto de resultados.
+ * @param work_directory Diretório temporário para os chunks locais das respostas.
+ */
+void runMessageBenchmarks(BenchmarkSuite& suite, const std::string& work_directory);
+
+
+/**
+ * @brief Executa os benchmarks de interpretação das mensagens UDP (stringstream e MessageParser), com a vazão em bytes.
+ */
+void runParserBenchmarks(BenchmarkSuite& suite);
+
+
+/**
+ * @brief Executa os benchmarks do FileManager (contenção, seleção de peers e montagem de arquivos).
+ *
+ * @param work_directory Diretório temporário para os chunks gerados.
+ */
+void runFileManagerBenchmarks(BenchmarkSuite& suite, const std::string& work_directory);
+
+
+/**
+ * @brief Executa os benchmarks de carregamento da configuração e da topologia (texto e forma binária).
+ *
+ * @param work_directory Diretório temporário para os arquivos gerados.
+ */
+void runConfigBenchmarks(BenchmarkSuite& suite, const std::string& work_directory);
+
+
+/**
+ * @brief Executa os benchmarks da E/S dos chunks (streams, IOEngine bloqueante e io_uring).
+ *
+ * @param work_directory Diretório temporário para os chunks gerados.
+ */
+void runIOBenchmarks(BenchmarkSuite& suite, const std::string& work_directory);
+
+
+/**
+ * @brief Executa os benchmarks do BufferPool (datagramas e buffers de chunks) contra as alocações anteriores.
+ */
+void runBufferPoolBenchmarks(BenchmarkSuite& suite);
+
+
+/**
+ * @brief Executa os benchmarks da codificação de apagamento (multiplicação em GF(2^8), codificação e reconstrução) em cada implementação suportada.
+ */
+void runErasureBenchmarks(BenchmarkSuite& suite);
+
+
+/**
+ * @brief Executa os benchmarks da divisão em chunks (tamanho fixo e CDC) e do SHA-256 usados pelo p2p-publish.
+ */
+void runChunkingBenchmarks(BenchmarkSuite& suite);
+
+
+/**
+ * @brief Executa os benchmarks da compressão dos chunks (LZ4 e zstd, em texto, binário e bytes aleatórios) e da escolha adaptativa do formato.
+ */
+void runCompressionBenchmarks(BenchmarkSuite& suite);
+
+
+/**
+ * @brief Executa os benchmarks do executor compartilhado (espera das mensagens de controle e fan-out) contra o executor com fila única.
+ */
+void runExecutorBenchmarks(BenchmarkSuite& suite);
+
+#endif // BENCHMARK_H
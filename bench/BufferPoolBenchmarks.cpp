@@ -0,0 +1,83 @@
+#include "Benchmark.h"
+#include "BufferPool.h"
+#include "Constants.h"
+#include <cstring>
+#include <deque>
+#include <string>
+#include <vector>
+
+
+namespace {
+    // Datagrama DISCOVERY típico, recebido e entregue à thread de processamento
+    const char DATAGRAM[] = "DISCOVERY 1234567890 127.0.0.1 6000 image.png 4";
+
+    // Tamanhos de chunk dos buffers de recebimento e gravação
+    const size_t CHUNK_SIZES[] = {16 << 10, 256 << 10};
+
+    // Chunks em trânsito entre a conexão e a gravação, como na fila do ChunkPersister
+    const size_t PIPELINE_DEPTH = 8;
+
+
+    /**
+     * @brief Acrescenta aos parâmetros de um resultado os buffers alocados pelo pool durante a medição.
+     */
+    void recordPoolAllocations(BenchmarkResult& result, const BufferPoolStats& before, const BufferPoolStats& after) {
+        result.parameters.emplace_back("pool_acquired", static_cast<double>(after.acquired - before.acquired));
+        result.parameters.emplace_back("pool_allocated", static_cast<double>(after.allocated - before.allocated));
+    }
+}
+
+
+/**
+ * @brief Executa os benchmarks do BufferPool nos caminhos dos datagramas e dos chunks.
+ */
+void runBufferPoolBenchmarks(BenchmarkSuite& suite) {
+    BufferPool pool;
+
+    // Caminho anterior: buffer na pilha, cópia para std::string e nova cópia para a thread de processamento
+    suite.run("datagramBufferString", {}, [&] {
+        char buffer[Constants::CONTROL_MESSAGE_MAX_SIZE];
+        std::memcpy(buffer, DATAGRAM, sizeof(DATAGRAM));
+        std::string message(buffer);
+        std::string handed_off = message;
+        doNotOptimize(handed_off.data());
+    });
+
+    // Buffer do pool recebido e entregue por move
+    BufferPoolStats before = pool.stats();
+    BenchmarkResult& datagram_result = suite.run("datagramBufferPool", {}, [&] {
+        Buffer datagram = pool.acquire(Constants::CONTROL_MESSAGE_MAX_SIZE);
+        std::memcpy(datagram.data(), DATAGRAM, sizeof(DATAGRAM));
+        datagram.resize(sizeof(DATAGRAM) - 1);
+        Buffer handed_off = std::move(datagram);
+        doNotOptimize(handed_off.view().data());
+    });
+    recordPoolAllocations(datagram_result, before, pool.stats());
+
+    for (size_t chunk_size : CHUNK_SIZES) {
+        // Caminho anterior: um std::vector por chunk, zerado na criação e liberado após a gravação
+        std::deque<std::vector<char>> vector_pipeline;
+        suite.run("chunkBufferVector", {{"chunk_size", static_cast<double>(chunk_size)}}, [&] {
+            std::vector<char> chunk(chunk_size);
+            chunk[0] = 1;
+            vector_pipeline.push_back(std::move(chunk));
+            if (vector_pipeline.size() > PIPELINE_DEPTH) {
+                vector_pipeline.pop_front();
+            }
+        }).bytes_per_operation = chunk_size;
+
+        // Buffer do pool por chunk, devolvido à classe após a gravação
+        std::deque<Buffer> pool_pipeline;
+        before = pool.stats();
+        BenchmarkResult& chunk_result = suite.run("chunkBufferPool", {{"chunk_size", static_cast<double>(chunk_size)}}, [&] {
+            Buffer chunk = pool.acquire(chunk_size);
+            chunk.data()[0] = 1;
+            pool_pipeline.push_back(std::move(chunk));
+            if (pool_pipeline.size() > PIPELINE_DEPTH) {
+                pool_pipeline.pop_front();
+            }
+        });
+        chunk_result.bytes_per_operation = chunk_size;
+        recordPoolAllocations(chunk_result, before, pool.stats());
+    }
+}
@@ -0,0 +1,53 @@
+#include "Benchmark.h"
+#include "Chunker.h"
+#include "Sha256.h"
+#include <random>
+#include <vector>
+
+
+namespace {
+    // Tamanho dos chunks resumidos, o padrão do p2p-publish
+    const size_t CHUNK_SIZE = 256 << 10;
+
+    // Bytes percorridos em cada divisão, o bastante para algumas dezenas de chunks de 256 KiB
+    const size_t INPUT_SIZE = 16 << 20;
+
+
+    /**
+     * @brief Divide a entrada inteira e retorna o número de chunks.
+     */
+    size_t countChunks(const Chunker& chunker, const std::vector<char>& input) {
+        size_t count = 0;
+        for (size_t offset = 0; offset < input.size(); ++count) {
+            offset += chunker.nextBoundary(input.data() + offset, input.size() - offset, true);
+        }
+        return count;
+    }
+}
+
+
+/**
+ * @brief Executa os benchmarks da divisão em chunks e do SHA-256 usados pelo p2p-publish.
+ */
+void runChunkingBenchmarks(BenchmarkSuite& suite) {
+    // Conteúdo aleatório: os cortes do CDC ficam distribuídos como em arquivos comprimidos
+    std::vector<char> input(INPUT_SIZE);
+    std::mt19937_64 rng(42);
+    for (char& byte : input) {
+        byte = static_cast<char>(rng());
+    }
+
+    suite.run("sha256Chunk", {{"chunk_bytes", CHUNK_SIZE}}, [&] {
+        doNotOptimize(Sha256::hash(input.data(), CHUNK_SIZE));
+    }).bytes_per_operation = CHUNK_SIZE;
+
+    Chunker fixed(ChunkingMode::FIXED, CHUNK_SIZE);
+    suite.run("chunkerFixed", {{"input_bytes", INPUT_SIZE}, {"chunk_bytes", CHUNK_SIZE}}, [&] {
+        doNotOptimize(countChunks(fixed, input));
+    }).bytes_per_operation = INPUT_SIZE;
+
+    Chunker cdc(ChunkingMode::CDC, CHUNK_SIZE);
+    suite.run("chunkerCDC", {{"input_bytes", INPUT_SIZE}, {"average_bytes", CHUNK_SIZE}}, [&] {
+        doNotOptimize(countChunks(cdc, input));
+    }).bytes_per_operation = INPUT_SIZE;
+}
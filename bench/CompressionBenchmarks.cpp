@@ -0,0 +1,117 @@
+#include "Benchmark.h"
+#include "Compression.h"
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+
+namespace {
+    // Tamanho dos chunks comprimidos, o padrão do p2p-publish
+    const size_t CHUNK_SIZE = 256 << 10;
+
+    // Formatos medidos, nos que o peer tem disponíveis
+    const CompressionCodec CODECS[] = {CompressionCodec::LZ4, CompressionCodec::ZSTD};
+
+
+    /**
+     * @brief Gera linhas de log como as do Logger: horário, nível, peer e mensagens de um vocabulário pequeno.
+     */
+    std::vector<char> textContent(std::mt19937_64& rng) {
+        const char* levels[] = {"INFO", "DEBUG", "SUCCESS", "ERROR"};
+        const char* messages[] = {"Recebido chunk do arquivo video.mp4 de 127.0.0.1:", "Enviada mensagem DISCOVERY para 10.0.0.",
+                                  "Mensagem de controle PUT recebida de 192.168.1.", "Chunk salvo em ./src/3/video.mp4.ch"};
+        std::string text;
+        for (uint64_t line = 0; text.size() < CHUNK_SIZE; ++line) {
+            text += "2026-10-18 12:" + std::to_string(10 + line / 6000 % 50) + ":" + std::to_string(10 + line / 100 % 50) + "." +
+                    std::to_string(100 + rng() % 900) + " [" + levels[rng() % 4] + "] Peer " + std::to_string(rng() % 64) + ": " +
+                    messages[rng() % 4] + std::to_string(rng() % 10000) + "\n";
+        }
+        return std::vector<char>(text.begin(), text.begin() + CHUNK_SIZE);
+    }
+
+
+    /**
+     * @brief Gera registros binários de tamanho fixo com campos que variam pouco, como uma tabela ou série temporal.
+     */
+    std::vector<char> binaryContent(std::mt19937_64& rng) {
+        struct Record {
+            uint64_t timestamp;
+            uint32_t sensor;
+            int32_t value;
+            float reading;
+            uint32_t flags;
+        };
+
+        std::vector<char> data(CHUNK_SIZE);
+        Record record{1760000000000ull, 0, 0, 20.0f, 0};
+        for (size_t offset = 0; offset + sizeof(Record) <= data.size(); offset += sizeof(Record)) {
+            record.timestamp += 10 + rng() % 5;
+            record.sensor = static_cast<uint32_t>(rng() % 16);
+            record.value += static_cast<int32_t>(rng() % 7) - 3;
+            record.reading += static_cast<float>(static_cast<int>(rng() % 11) - 5) / 100.0f;
+            record.flags = rng() % 32 == 0 ? 1 : 0;
+            std::memcpy(data.data() + offset, &record, sizeof(Record));
+        }
+        return data;
+    }
+
+
+    /**
+     * @brief Gera bytes aleatórios, como os de um arquivo já comprimido.
+     */
+    std::vector<char> randomContent(std::mt19937_64& rng) {
+        std::vector<char> data(CHUNK_SIZE);
+        for (char& byte : data) {
+            byte = static_cast<char>(rng());
+        }
+        return data;
+    }
+
+
+    /**
+     * @brief Retorna o nome de um benchmark com o formato e o conteúdo (ex: compressLz4Text).
+     */
+    std::string codecBenchmarkName(const std::string& name, CompressionCodec codec, const std::string& content) {
+        return name + (codec == CompressionCodec::ZSTD ? "Zstd" : "Lz4") + content;
+    }
+}
+
+
+/**
+ * @brief Executa os benchmarks da compressão dos chunks em cada formato disponível e da escolha adaptativa do formato.
+ */
+void runCompressionBenchmarks(BenchmarkSuite& suite) {
+    std::mt19937_64 rng(42);
+    const std::pair<std::string, std::vector<char>> contents[] = {
+        {"Text", textContent(rng)},
+        {"Binary", binaryContent(rng)},
+        {"Random", randomContent(rng)},
+    };
+
+    for (const auto& [content_name, input] : contents) {
+        for (CompressionCodec codec : CODECS) {
+            if (!Compression::isAvailable(codec)) {
+                continue;
+            }
+
+            std::vector<char> compressed(Compression::maxCompressedSize(codec, input.size()));
+            size_t compressed_size = Compression::compress(codec, input.data(), input.size(), compressed.data(), compressed.size());
+            double ratio = static_cast<double>(compressed_size) / static_cast<double>(input.size());
+
+            suite.run(codecBenchmarkName("compress", codec, content_name), {{"chunk_bytes", CHUNK_SIZE}, {"ratio", ratio}}, [&] {
+                doNotOptimize(Compression::compress(codec, input.data(), input.size(), compressed.data(), compressed.size()));
+            }).bytes_per_operation = CHUNK_SIZE;
+
+            std::vector<char> output(input.size());
+            suite.run(codecBenchmarkName("decompress", codec, content_name), {{"chunk_bytes", CHUNK_SIZE}, {"ratio", ratio}}, [&] {
+                doNotOptimize(Compression::decompress(codec, compressed.data(), compressed_size, output.data(), output.size()));
+            }).bytes_per_operation = CHUNK_SIZE;
+        }
+
+        // Escolha do formato de um chunk, com a amostragem que dispensa a compressão do conteúdo incompressível
+        suite.run("compressionChoose" + content_name, {{"chunk_bytes", CHUNK_SIZE}}, [&] {
+            doNotOptimize(Compression::choose(CompressionMode::AUTO, Compression::supportedCodecs(), input.data(), input.size(), 1e9));
+        }).bytes_per_operation = CHUNK_SIZE;
+    }
+}
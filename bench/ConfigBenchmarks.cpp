@@ -0,0 +1,66 @@
+#include "Benchmark.h"
+#include "ConfigManager.h"
+#include <filesystem>
+#include <fstream>
+
+
+namespace {
+    // Número de vizinhos de cada peer nas topologias geradas
+    const int GENERATED_DEGREE = 8;
+
+
+    /**
+     * @brief Gera config.txt e topologia.txt com peer_count peers, cada um ligado aos GENERATED_DEGREE seguintes.
+     */
+    size_t generateNetworkFiles(const std::string& config_path, const std::string& topology_path, int peer_count) {
+        std::ofstream config(config_path);
+        std::ofstream topology(topology_path);
+
+        for (int peer = 0; peer < peer_count; ++peer) {
+            config << peer << ": 10." << (peer >> 16) << "." << ((peer >> 8) & 0xFF) << "." << (peer & 0xFF)
+                   << ", " << 6000 + peer % 50000 << ", " << 200 + peer % 800 << "\n";
+
+            topology << peer << ":";
+            for (int offset = 1; offset <= GENERATED_DEGREE; ++offset) {
+                topology << (offset > 1 ? ", " : " ") << (peer + offset) % peer_count;
+            }
+            topology << "\n";
+        }
+
+        return static_cast<size_t>(config.tellp() + topology.tellp());
+    }
+}
+
+
+/**
+ * @brief Executa os benchmarks de carregamento da configuração e da topologia.
+ */
+void runConfigBenchmarks(BenchmarkSuite& suite, const std::string& work_directory) {
+    for (int peer_count : {100, 10000}) {
+        std::string prefix = work_directory + "network" + std::to_string(peer_count);
+        std::string config_path = prefix + ".config.txt";
+        std::string topology_path = prefix + ".topologia.txt";
+        std::string cache_path = prefix + ".cache";
+        size_t text_bytes = generateNetworkFiles(config_path, topology_path, peer_count);
+
+        // Leitura dos arquivos de texto, sem a forma binária
+        BenchmarkResult& parse_result = suite.run("parseNetwork", {{"peers", peer_count}, {"degree", GENERATED_DEGREE}}, [&] {
+            NetworkConfig network;
+            doNotOptimize(ConfigManager::loadNetwork(network, config_path, topology_path, ""));
+        });
+        parse_result.bytes_per_operation = text_bytes;
+
+        // Leitura da forma binária gravada na primeira carga
+        NetworkConfig first_load;
+        ConfigManager::loadNetwork(first_load, config_path, topology_path, cache_path);
+        suite.run("loadNetworkCached", {{"peers", peer_count}, {"degree", GENERATED_DEGREE}}, [&] {
+            NetworkConfig network;
+            doNotOptimize(ConfigManager::loadNetwork(network, config_path, topology_path, cache_path));
+        });
+
+        // Expansão da vizinhança do peer local, feita uma vez na inicialização
+        suite.run("getNeighbors", {{"peers", peer_count}, {"degree", GENERATED_DEGREE}}, [&] {
+            doNotOptimize(first_load.getNeighbors(first_load.findPeer(peer_count / 2)));
+        });
+    }
+}
@@ -0,0 +1,107 @@
+#include "Benchmark.h"
+#include "ErasureCoder.h"
+#include <iostream>
+#include <string>
+#include <vector>
+
+
+namespace {
+    // Bloco das multiplicações isoladas, o tamanho das faixas lidas pelo FileManager
+    const size_t BLOCK_SIZE = 64 << 10;
+
+    // Esquema medido: 10 chunks de dados e 4 de paridade (40% de redundância)
+    const int DATA_CHUNKS = 10;
+    const int TOTAL_CHUNKS = 14;
+
+    // Tamanho de cada chunk nas medições de codificação e reconstrução
+    const size_t CHUNK_SIZE = 256 << 10;
+
+    // Implementações medidas, nas que o processador suporta
+    const GaloisKernel KERNELS[] = {GaloisKernel::SCALAR, GaloisKernel::SSSE3, GaloisKernel::AVX2};
+
+
+    /**
+     * @brief Retorna o nome de um benchmark com o sufixo da implementação (ex: erasureEncodeAVX2).
+     */
+    std::string kernelBenchmarkName(const std::string& name, GaloisKernel kernel) {
+        switch (kernel) {
+            case GaloisKernel::AVX2:
+                return name + "AVX2";
+            case GaloisKernel::SSSE3:
+                return name + "SSSE3";
+            default:
+                return name + "Scalar";
+        }
+    }
+}
+
+
+/**
+ * @brief Executa os benchmarks da codificação de apagamento em cada implementação suportada.
+ */
+void runErasureBenchmarks(BenchmarkSuite& suite) {
+    std::vector<std::vector<char>> chunks(TOTAL_CHUNKS, std::vector<char>(CHUNK_SIZE));
+    for (int chunk = 0; chunk < DATA_CHUNKS; ++chunk) {
+        for (size_t i = 0; i < CHUNK_SIZE; ++i) {
+            chunks[chunk][i] = static_cast<char>((chunk * 131 + i * 7) & 0xFF);
+        }
+    }
+
+    std::vector<const char*> data;
+    std::vector<char*> parity;
+    for (int chunk = 0; chunk < TOTAL_CHUNKS; ++chunk) {
+        if (chunk < DATA_CHUNKS) {
+            data.push_back(chunks[chunk].data());
+        } else {
+            parity.push_back(chunks[chunk].data());
+        }
+    }
+
+    // Reconstrução com os 4 primeiros chunks de dados perdidos: 6 de dados e os 4 de paridade
+    std::vector<int> missing_ids = {0, 1, 2, 3};
+    std::vector<int> source_ids;
+    std::vector<const char*> sources;
+    for (int chunk = 4; chunk < TOTAL_CHUNKS; ++chunk) {
+        source_ids.push_back(chunk);
+        sources.push_back(chunks[chunk].data());
+    }
+    std::vector<std::vector<char>> rebuilt(missing_ids.size(), std::vector<char>(CHUNK_SIZE));
+    std::vector<char*> outputs;
+    for (auto& buffer : rebuilt) {
+        outputs.push_back(buffer.data());
+    }
+
+    for (GaloisKernel kernel : KERNELS) {
+        if (!ErasureCoder::isSupported(kernel)) {
+            continue;
+        }
+
+        // Multiplicação de um bloco por um coeficiente, o laço interno da codificação
+        suite.run(kernelBenchmarkName("galoisMultiplyAdd", kernel), {{"block_bytes", BLOCK_SIZE}}, [&] {
+            ErasureCoder::multiplyAdd(kernel, 0x8e, chunks[0].data(), chunks[TOTAL_CHUNKS - 1].data(), BLOCK_SIZE);
+            doNotOptimize(chunks[TOTAL_CHUNKS - 1][0]);
+        }).bytes_per_operation = BLOCK_SIZE;
+
+        // Codificação: a vazão conta os bytes de dados lidos
+        ErasureCoder coder(DATA_CHUNKS, TOTAL_CHUNKS, kernel);
+        suite.run(kernelBenchmarkName("erasureEncode", kernel), {{"data_chunks", DATA_CHUNKS}, {"total_chunks", TOTAL_CHUNKS}, {"chunk_bytes", CHUNK_SIZE}}, [&] {
+            coder.encode(data, parity, CHUNK_SIZE);
+            doNotOptimize(parity[0][0]);
+        }).bytes_per_operation = DATA_CHUNKS * CHUNK_SIZE;
+
+        // Reconstrução: inversão da submatriz e cálculo dos chunks de dados perdidos
+        suite.run(kernelBenchmarkName("erasureDecode", kernel), {{"data_chunks", DATA_CHUNKS}, {"missing", missing_ids.size()}, {"chunk_bytes", CHUNK_SIZE}}, [&] {
+            std::vector<uint8_t> rows;
+            coder.decodingMatrix(source_ids, missing_ids, rows);
+            coder.apply(rows, sources, outputs, CHUNK_SIZE);
+            doNotOptimize(outputs[0][0]);
+        }).bytes_per_operation = DATA_CHUNKS * CHUNK_SIZE;
+    }
+
+    // Confere a reconstrução da última implementação medida
+    for (size_t i = 0; i < missing_ids.size(); ++i) {
+        if (rebuilt[i] != chunks[missing_ids[i]]) {
+            std::cerr << "Aviso: chunk " << missing_ids[i] << " reconstruído difere do original.\n";
+        }
+    }
+}
@@ -0,0 +1,131 @@
+#include "Benchmark.h"
+#include "Executor.h"
+#include "WorkStealingExecutor.h"
+#include <atomic>
+#include <thread>
+
+
+namespace {
+    // Threads dos executores comparados
+    const int EXECUTOR_THREADS = 4;
+
+    // Tarefas de fundo (envios, montagens) em fila quando chega a mensagem de controle
+    const int BACKLOG_TASKS = 64;
+
+    // Duração de cada tarefa de fundo
+    const std::chrono::microseconds BACKLOG_TASK_DURATION(20);
+
+    // Tarefas criadas por uma tarefa no benchmark de fan-out (ex: gravações dos chunks de uma conexão)
+    const int FAN_OUT_TASKS = 256;
+
+
+    /**
+     * @brief Ocupa a thread pelo tempo de uma tarefa de fundo.
+     */
+    void spinFor(std::chrono::microseconds duration) {
+        auto until = std::chrono::steady_clock::now() + duration;
+        while (std::chrono::steady_clock::now() < until) {
+        }
+    }
+
+
+    /**
+     * @brief Espera um contador atingir um valor, cedendo a thread aos executores.
+     */
+    void waitFor(const std::atomic<int>& counter, int value) {
+        while (counter.load() < value) {
+            std::this_thread::yield();
+        }
+    }
+
+
+    /**
+     * @brief Mede o tempo entre a submissão de uma mensagem de controle e o início da sua execução, com tarefas de fundo em fila.
+     *
+     * @param min_time Tempo mínimo de medição.
+     * @param submit Submete uma tarefa; o primeiro argumento indica se ela é a mensagem de controle.
+     * @return Soma das esperas e número de mensagens medidas.
+     */
+    template <typename Submit>
+    std::pair<std::chrono::nanoseconds, uint64_t> measureControlWait(std::chrono::nanoseconds min_time, Submit submit) {
+        std::chrono::nanoseconds waited(0);
+        uint64_t rounds = 0;
+        auto deadline = std::chrono::steady_clock::now() + min_time;
+
+        while (std::chrono::steady_clock::now() < deadline) {
+            std::atomic<int> done(0);
+            std::atomic<int64_t> started_at(0);
+            for (int i = 0; i < BACKLOG_TASKS; ++i) {
+                submit(false, [&done] {
+                    spinFor(BACKLOG_TASK_DURATION);
+                    done.fetch_add(1);
+                });
+            }
+
+            auto submitted_at = std::chrono::steady_clock::now();
+            submit(true, [&done, &started_at] {
+                started_at.store(std::chrono::steady_clock::now().time_since_epoch().count());
+                done.fetch_add(1);
+            });
+
+            // A rodada só termina com as tarefas de fundo concluídas, para que a próxima comece com os executores vazios
+            waitFor(done, BACKLOG_TASKS + 1);
+            waited += std::chrono::steady_clock::time_point(std::chrono::steady_clock::duration(started_at.load())) - submitted_at;
+            ++rounds;
+        }
+        return {waited, rounds};
+    }
+}
+
+
+/**
+ * @brief Executa os benchmarks do executor compartilhado contra o executor com fila única.
+ */
+void runExecutorBenchmarks(BenchmarkSuite& suite) {
+    std::vector<std::pair<std::string, double>> control_parameters = {
+        {"threads", EXECUTOR_THREADS}, {"backlog", BACKLOG_TASKS}, {"task_us", static_cast<double>(BACKLOG_TASK_DURATION.count())}};
+
+    // Fila única: a mensagem de controle espera todas as tarefas de fundo que chegaram antes
+    {
+        Executor executor(EXECUTOR_THREADS);
+        auto [waited, rounds] = measureControlWait(suite.getMinTime(), [&](bool, std::function<void()> task) {
+            executor.submit(std::move(task));
+        });
+        suite.record("controlWaitFifo", control_parameters, rounds, waited);
+    }
+
+    // Prioridades: a mensagem de controle passa à frente das tarefas de fundo ainda em fila
+    {
+        WorkStealingExecutor executor(EXECUTOR_THREADS);
+        auto [waited, rounds] = measureControlWait(suite.getMinTime(), [&](bool control, std::function<void()> task) {
+            executor.submit(control ? TaskPriority::CONTROL : TaskPriority::UPLOAD, std::move(task));
+        });
+        suite.record("controlWaitWorkStealing", control_parameters, rounds, waited);
+    }
+
+    // Fan-out: uma tarefa cria as demais, na fila única ou na fila da própria thread (roubadas pelas outras)
+    {
+        Executor executor(EXECUTOR_THREADS);
+        suite.run("fanOutFifo", {{"threads", EXECUTOR_THREADS}, {"tasks", FAN_OUT_TASKS}}, [&] {
+            std::atomic<int> done(0);
+            executor.submit([&] {
+                for (int i = 0; i < FAN_OUT_TASKS; ++i) {
+                    executor.submit([&done] { done.fetch_add(1); });
+                }
+            });
+            waitFor(done, FAN_OUT_TASKS);
+        });
+    }
+    {
+        WorkStealingExecutor executor(EXECUTOR_THREADS);
+        suite.run("fanOutWorkStealing", {{"threads", EXECUTOR_THREADS}, {"tasks", FAN_OUT_TASKS}}, [&] {
+            std::atomic<int> done(0);
+            executor.submit(TaskPriority::TRANSFER, [&] {
+                for (int i = 0; i < FAN_OUT_TASKS; ++i) {
+                    executor.submit(TaskPriority::TRANSFER, [&done] { done.fetch_add(1); });
+                }
+            });
+            waitFor(done, FAN_OUT_TASKS);
+        });
+    }
+}
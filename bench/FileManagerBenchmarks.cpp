@@ -0,0 +1,129 @@
+#include "Benchmark.h"
+#include "FileManager.h"
+#include <filesystem>
+#include <fstream>
+#include <thread>
+
+
+namespace {
+    // Número máximo de entradas de localização por cenário de selectPeersForChunkDownload.
+    // Com 100k chunks e 1k holders a replicação completa teria 1e8 entradas, então o número
+    // de holders por chunk é limitado e informado no parâmetro "replicas".
+    const size_t MAX_LOCATION_ENTRIES = 200000;
+
+    // Número de operações de cada thread nos benchmarks de contenção
+    const uint64_t CONTENTION_OPERATIONS_PER_THREAD = 200000;
+
+
+    /**
+     * @brief Cria chunks de conteúdo arbitrário no diretório de um peer.
+     */
+    void createChunks(const std::string& directory, const std::string& file_name, int chunk_count, size_t chunk_size) {
+        std::filesystem::create_directories(directory);
+        std::string data(chunk_size, 'x');
+
+        for (int chunk = 0; chunk < chunk_count; ++chunk) {
+            std::ofstream chunk_file(directory + "/" + file_name + ".ch" + std::to_string(chunk), std::ios::binary);
+            chunk_file.write(data.data(), data.size());
+        }
+    }
+
+
+    /**
+     * @brief Executa uma operação em várias threads ao mesmo tempo e registra a vazão total.
+     */
+    template <typename Operation>
+    void runConcurrent(BenchmarkSuite& suite, const std::string& name, int thread_count, Operation operation) {
+        std::vector<std::thread> threads;
+        auto start = std::chrono::steady_clock::now();
+
+        for (int t = 0; t < thread_count; ++t) {
+            threads.emplace_back([&operation, t] {
+                for (uint64_t i = 0; i < CONTENTION_OPERATIONS_PER_THREAD; ++i) {
+                    operation(t, i);
+                }
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+
+        auto elapsed = std::chrono::steady_clock::now() - start;
+        suite.record(name, {{"threads", thread_count}}, CONTENTION_OPERATIONS_PER_THREAD * thread_count,
+                     std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed));
+    }
+}
+
+
+/**
+ * @brief Executa os benchmarks do FileManager.
+ */
+void runFileManagerBenchmarks(BenchmarkSuite& suite, const std::string& work_directory) {
+    // Contenção: várias threads consultando e atualizando o mesmo arquivo
+    {
+        const int chunk_count = 1000;
+        createChunks(work_directory + "contention", "shared.bin", chunk_count / 2, 1);
+
+        FileManager file_manager("contention", work_directory);
+        file_manager.loadLocalChunks();
+        file_manager.initializeFileChunks("shared.bin", chunk_count);
+        file_manager.initializeChunkLocationInfo("shared.bin");
+
+        for (int thread_count : {1, 4}) {
+            runConcurrent(suite, "hasChunk", thread_count, [&](int, uint64_t i) {
+                doNotOptimize(file_manager.hasChunk("shared.bin", static_cast<int>(i % chunk_count)));
+            });
+            runConcurrent(suite, "getAvailableChunks", thread_count, [&](int, uint64_t) {
+                doNotOptimize(file_manager.getAvailableChunks("shared.bin"));
+            });
+            runConcurrent(suite, "storeChunkLocationInfo", thread_count, [&](int t, uint64_t i) {
+                // Cada thread representa um peer respondendo com um chunk por vez
+                file_manager.storeChunkLocationInfo("shared.bin", {static_cast<int>(i % chunk_count)}, "127.0.0.1", 6000 + t, 1024);
+            });
+        }
+    }
+
+    // Seleção de peers com diferentes números de chunks e de holders
+    for (int chunk_count : {10, 1000, 100000}) {
+        for (int holder_count : {10, 1000}) {
+            size_t replicas = std::min<size_t>(holder_count, std::max<size_t>(1, MAX_LOCATION_ENTRIES / chunk_count));
+            std::string file_name = "select.bin";
+
+            FileManager file_manager("select");
+            file_manager.initializeFileChunks(file_name, chunk_count);
+            file_manager.initializeChunkLocationInfo(file_name);
+
+            // Distribui as réplicas de cada chunk entre os holders
+            std::vector<std::vector<int>> chunks_by_holder(holder_count);
+            for (int chunk = 0; chunk < chunk_count; ++chunk) {
+                for (size_t replica = 0; replica < replicas; ++replica) {
+                    chunks_by_holder[(chunk * 7 + replica) % holder_count].push_back(chunk);
+                }
+            }
+            for (int holder = 0; holder < holder_count; ++holder) {
+                file_manager.storeChunkLocationInfo(file_name, chunks_by_holder[holder], "10.0." + std::to_string(holder / 256) + "." + std::to_string(holder % 256),
+                                                    6000, 1000 + (holder * 37) % 5000);
+            }
+
+            suite.run("selectPeersForChunkDownload",
+                      {{"chunks", chunk_count}, {"holders", holder_count}, {"replicas", static_cast<double>(replicas)}}, [&] {
+                doNotOptimize(file_manager.selectPeersForChunkDownload(file_name));
+            });
+        }
+    }
+
+    // Montagem do arquivo completo a partir dos chunks em disco
+    for (auto [chunk_count, chunk_size] : {std::pair<int, size_t>{1024, 4096}, std::pair<int, size_t>{64, 65536}}) {
+        std::string peer_id = "assemble" + std::to_string(chunk_count);
+        createChunks(work_directory + peer_id, "assembled.bin", chunk_count, chunk_size);
+
+        FileManager file_manager(peer_id, work_directory);
+        file_manager.loadLocalChunks();
+        file_manager.initializeFileChunks("assembled.bin", chunk_count);
+
+        BenchmarkResult& result = suite.run("assembleFile", {{"chunks", chunk_count}, {"chunk_size", static_cast<double>(chunk_size)}}, [&] {
+            doNotOptimize(file_manager.assembleFile("assembled.bin"));
+        });
+        result.bytes_per_operation = chunk_count * chunk_size;
+    }
+}
@@ -0,0 +1,177 @@
+#include "Benchmark.h"
+#include "Constants.h"
+#include "IOEngine.h"
+#include <fstream>
+#include <sys/socket.h>
+#include <thread>
+#include <unistd.h>
+
+
+namespace {
+    // Tamanhos de chunk medidos nas leituras, gravações e envios
+    const size_t CHUNK_SIZES[] = {16 << 10, 256 << 10, 4 << 20};
+
+    // Número de chunks concatenados na montagem do arquivo
+    const int ASSEMBLED_CHUNKS = 64;
+
+
+    /**
+     * @brief Lê um chunk como o TCPServer fazia antes do IOEngine (ifstream).
+     */
+    bool readWithStream(const std::string& path, std::vector<char>& data) {
+        std::ifstream file(path, std::ios::binary | std::ios::ate | std::ios::in);
+        if (!file.is_open()) {
+            return false;
+        }
+        data.resize(static_cast<size_t>(file.tellg()));
+        file.seekg(0);
+        file.read(data.data(), data.size());
+        return true;
+    }
+
+
+    /**
+     * @brief Grava um chunk como o FileManager fazia antes do IOEngine (ofstream).
+     */
+    bool writeWithStream(const std::string& path, const std::vector<char>& data) {
+        std::ofstream file(path, std::ios::binary);
+        if (!file.is_open()) {
+            return false;
+        }
+        file.write(data.data(), data.size());
+        return true;
+    }
+
+
+    /**
+     * @brief Concatena os chunks como o FileManager fazia antes do IOEngine (rdbuf).
+     */
+    bool concatenateWithStream(const std::vector<std::string>& input_paths, const std::string& output_path) {
+        std::ofstream output(output_path, std::ios::binary);
+        for (const std::string& input_path : input_paths) {
+            std::ifstream input(input_path, std::ios::binary);
+            if (!input.is_open()) {
+                return false;
+            }
+            output << input.rdbuf();
+        }
+        return true;
+    }
+
+
+    /**
+     * @brief Envia a mensagem de controle e o chunk com um send por vez, como o TCPServer fazia antes do IOEngine.
+     */
+    bool sendWithLoop(int sockfd, const char* control, const std::vector<char>& chunk) {
+        std::vector<std::tuple<const char*, size_t>> buffers = {{control, Constants::CONTROL_MESSAGE_MAX_SIZE}, {chunk.data(), chunk.size()}};
+        for (const auto& [data, size] : buffers) {
+            size_t total = 0;
+            while (total < size) {
+                ssize_t sent = send(sockfd, data + total, size - total, 0);
+                if (sent <= 0) {
+                    return false;
+                }
+                total += static_cast<size_t>(sent);
+            }
+        }
+        return true;
+    }
+
+
+    /**
+     * @brief Retorna as implementações de E/S disponíveis, com o sufixo usado no nome dos benchmarks.
+     */
+    std::vector<std::pair<std::string, std::unique_ptr<IOEngine>>> availableEngines() {
+        std::vector<std::pair<std::string, std::unique_ptr<IOEngine>>> engines;
+        engines.emplace_back("Blocking", IOEngine::create(IOBackend::BLOCKING));
+        if (UringIOEngine::isAvailable()) {
+            engines.emplace_back("Uring", IOEngine::create(IOBackend::URING));
+        }
+        return engines;
+    }
+}
+
+
+/**
+ * @brief Executa os benchmarks da E/S dos chunks.
+ */
+void runIOBenchmarks(BenchmarkSuite& suite, const std::string& work_directory) {
+    auto engines = availableEngines();
+
+    for (size_t chunk_size : CHUNK_SIZES) {
+        std::vector<char> chunk(chunk_size);
+        for (size_t i = 0; i < chunk_size; ++i) {
+            chunk[i] = static_cast<char>(i * 31);
+        }
+        std::string chunk_path = work_directory + "io_chunk" + std::to_string(chunk_size);
+        writeWithStream(chunk_path, chunk);
+        std::vector<std::pair<std::string, double>> parameters = {{"chunk_size", static_cast<double>(chunk_size)}};
+
+        // Leitura de um chunk inteiro, como em sendChunks
+        std::vector<char> buffer;
+        suite.run("readChunkStream", parameters, [&] {
+            doNotOptimize(readWithStream(chunk_path, buffer));
+        }).bytes_per_operation = chunk_size;
+        for (auto& [suffix, engine] : engines) {
+            suite.run("readChunk" + suffix, parameters, [&] {
+                doNotOptimize(engine->readFile(chunk_path, buffer));
+            }).bytes_per_operation = chunk_size;
+        }
+
+        // Gravação de um chunk recebido, como em saveChunk
+        std::string written_path = chunk_path + ".written";
+        suite.run("writeChunkStream", parameters, [&] {
+            doNotOptimize(writeWithStream(written_path, chunk));
+        }).bytes_per_operation = chunk_size;
+        for (auto& [suffix, engine] : engines) {
+            suite.run("writeChunk" + suffix, parameters, [&] {
+                doNotOptimize(engine->writeFile(written_path, chunk.data(), chunk.size()));
+            }).bytes_per_operation = chunk_size;
+        }
+
+        // Envio da mensagem de controle e do chunk por um socket local, esvaziado por outra thread
+        int sockets[2];
+        if (socketpair(AF_UNIX, SOCK_STREAM, 0, sockets) == 0) {
+            std::thread drain([receiver = sockets[1]] {
+                std::vector<char> sink(1 << 20);
+                while (recv(receiver, sink.data(), sink.size(), 0) > 0) {
+                }
+            });
+
+            char control[Constants::CONTROL_MESSAGE_MAX_SIZE] = {0};
+            suite.run("sendChunkLoop", parameters, [&] {
+                doNotOptimize(sendWithLoop(sockets[0], control, chunk));
+            }).bytes_per_operation = chunk_size + Constants::CONTROL_MESSAGE_MAX_SIZE;
+            for (auto& [suffix, engine] : engines) {
+                suite.run("sendChunk" + suffix, parameters, [&] {
+                    doNotOptimize(engine->sendAll(sockets[0], {{control, Constants::CONTROL_MESSAGE_MAX_SIZE}, {chunk.data(), chunk.size()}}));
+                }).bytes_per_operation = chunk_size + Constants::CONTROL_MESSAGE_MAX_SIZE;
+            }
+
+            shutdown(sockets[0], SHUT_WR);
+            drain.join();
+            close(sockets[0]);
+            close(sockets[1]);
+        }
+    }
+
+    // Montagem de um arquivo a partir dos chunks, como em assembleFileLocked
+    const size_t assembled_chunk_size = 64 << 10;
+    std::vector<char> chunk(assembled_chunk_size, 'a');
+    std::vector<std::string> chunk_paths;
+    for (int i = 0; i < ASSEMBLED_CHUNKS; ++i) {
+        chunk_paths.push_back(work_directory + "io_assembled.ch" + std::to_string(i));
+        writeWithStream(chunk_paths.back(), chunk);
+    }
+    std::string output_path = work_directory + "io_assembled";
+    std::vector<std::pair<std::string, double>> parameters = {{"chunks", ASSEMBLED_CHUNKS}, {"chunk_size", static_cast<double>(assembled_chunk_size)}};
+
+    suite.run("concatenateChunksStream", parameters, [&] {
+        doNotOptimize(concatenateWithStream(chunk_paths, output_path));
+    }).bytes_per_operation = ASSEMBLED_CHUNKS * assembled_chunk_size;
+    for (auto& [suffix, engine] : engines) {
+        suite.run("concatenateChunks" + suffix, parameters, [&] {
+            doNotOptimize(engine->concatenateFiles(chunk_paths, output_path));
+        }).bytes_per_operation = ASSEMBLED_CHUNKS * assembled_chunk_size;
+    }
+}
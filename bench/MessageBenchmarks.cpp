@@ -0,0 +1,73 @@
+#include "Benchmark.h"
+#include "FileManager.h"
+#include "TCPServer.h"
+#include "UDPServer.h"
+#include <numeric>
+
+
+/**
+ * @brief Executa os benchmarks de montagem e interpretação das mensagens UDP.
+ */
+void runMessageBenchmarks(BenchmarkSuite& suite, const std::string& work_directory) {
+    // Os servidores não são iniciados: apenas a montagem e a interpretação são medidas
+    FileManager file_manager("bench", work_directory);
+    file_manager.loadLocalChunks();
+    WorkStealingExecutor executor(1);
+    TCPServer tcp_server("127.0.0.1", 0, 0, 1024, file_manager, executor);
+    UDPServer udp_server("127.0.0.1", 0, 0, 0, 1024, file_manager, tcp_server, executor);
+    PeerInfo requester("127.0.0.1", 6000);
+
+    suite.run("buildChunkDiscoveryMessage", {}, [&] {
+        doNotOptimize(udp_server.buildChunkDiscoveryMessage("image.png", 1000, 3, requester));
+    });
+
+    for (int chunk_count : {10, 1000}) {
+        std::vector<int> chunks(chunk_count);
+        std::iota(chunks.begin(), chunks.end(), 0);
+
+        suite.run("buildChunkResponseMessage", {{"chunks", chunk_count}}, [&] {
+            doNotOptimize(udp_server.buildChunkResponseMessage("image.png", chunks));
+        });
+        suite.run("buildChunkRequestMessage", {{"chunks", chunk_count}}, [&] {
+            doNotOptimize(udp_server.buildChunkRequestMessage("image.png", chunks));
+        });
+    }
+
+    // Resposta a uma DISCOVERY de um arquivo que o peer possui: montada a cada vez (após uma invalidação) ou vinda do cache
+    for (int chunk_count : {10, 1000}) {
+        std::string file_name = "held" + std::to_string(chunk_count) + ".bin";
+        for (int chunk = 0; chunk < chunk_count; ++chunk) {
+            file_manager.saveChunk(file_name, chunk, "x", 1);
+        }
+
+        suite.run("getChunkResponseMessage", {{"chunks", chunk_count}, {"cached", 0}}, [&] {
+            udp_server.invalidateChunkResponse(file_name);
+            doNotOptimize(udp_server.getChunkResponseMessage(file_name));
+        });
+        suite.run("getChunkResponseMessage", {{"chunks", chunk_count}, {"cached", 1}}, [&] {
+            doNotOptimize(udp_server.getChunkResponseMessage(file_name));
+        });
+    }
+
+    // DISCOVERY de um arquivo que o peer não possui e com TTL zero: só interpretação, sem envio
+    std::string discovery = udp_server.buildChunkDiscoveryMessage("unknown.bin", 1000, 0, requester);
+    suite.run("processMessage.DISCOVERY", {}, [&] {
+        udp_server.processMessage(discovery, requester);
+    });
+
+    // RESPONSE de um arquivo em busca: interpretação e registro da localização dos chunks
+    for (int chunk_count : {10, 1000}) {
+        std::string file_name = "response" + std::to_string(chunk_count) + ".bin";
+        file_manager.initializeFileChunks(file_name, chunk_count);
+        file_manager.initializeChunkLocationInfo(file_name);
+        udp_server.initializeProcessingActive(file_name);
+
+        std::vector<int> chunks(chunk_count);
+        std::iota(chunks.begin(), chunks.end(), 0);
+        std::string response = udp_server.buildChunkResponseMessage(file_name, chunks);
+
+        suite.run("processMessage.RESPONSE", {{"chunks", chunk_count}}, [&] {
+            udp_server.processMessage(response, requester);
+        });
+    }
+}
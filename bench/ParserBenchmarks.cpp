@@ -0,0 +1,163 @@
+#include "Benchmark.h"
+#include "MessageParser.h"
+#include <sstream>
+#include <string>
+#include <vector>
+
+
+namespace {
+    // Número de detentores das mensagens AGGREGATE medidas
+    const int AGGREGATE_HOLDERS = 20;
+
+
+    /**
+     * @brief Interpreta uma mensagem DISCOVERY como o UDPServer fazia antes do MessageParser (stringstream e substr).
+     */
+    int parseDiscoveryWithStream(const std::string& message) {
+        std::stringstream ss{message};
+        std::string command, file_name, requester_ip_port;
+        int total_chunks, ttl;
+        uint64_t search_id = 0;
+        int64_t window_ms = 0;
+
+        ss >> command >> file_name >> total_chunks >> ttl >> requester_ip_port;
+        if (!(ss >> search_id >> window_ms)) {
+            search_id = 0;
+        }
+        size_t colon_pos = requester_ip_port.find(':');
+        std::string requester_ip = requester_ip_port.substr(0, colon_pos);
+        int requester_port = std::stoi(requester_ip_port.substr(colon_pos + 1));
+        return requester_port + ttl + static_cast<int>(requester_ip.size() + file_name.size() + search_id);
+    }
+
+
+    /**
+     * @brief Interpreta uma mensagem DISCOVERY com o MessageParser.
+     */
+    int parseDiscoveryWithTokenizer(std::string_view message) {
+        MessageTokenizer tokens(message);
+        std::string_view command;
+        DiscoveryMessage discovery;
+        tokens.next(command);
+        if (MessageParser::parseType(command) != MessageType::DISCOVERY || !MessageParser::parseDiscovery(tokens, discovery)) {
+            return -1;
+        }
+        return discovery.requester_port + discovery.ttl + static_cast<int>(discovery.requester_ip.size() + discovery.file_name.size() + discovery.search_id);
+    }
+
+
+    /**
+     * @brief Interpreta uma mensagem RESPONSE como o UDPServer fazia antes do MessageParser, lendo os chunks para um vetor.
+     */
+    int parseResponseWithStream(const std::string& message) {
+        std::stringstream ss{message};
+        std::string command, file_name;
+        int transfer_speed, chunk;
+        std::vector<int> chunks;
+
+        ss >> command >> file_name >> transfer_speed;
+        while (ss >> chunk) {
+            chunks.push_back(chunk);
+        }
+        return transfer_speed + static_cast<int>(chunks.size());
+    }
+
+
+    /**
+     * @brief Interpreta uma mensagem RESPONSE com o MessageParser, percorrendo os chunks sem copiá-los.
+     */
+    int parseResponseWithTokenizer(std::string_view message) {
+        MessageTokenizer tokens(message);
+        std::string_view command;
+        ResponseMessage response;
+        tokens.next(command);
+        if (MessageParser::parseType(command) != MessageType::RESPONSE || !MessageParser::parseResponse(tokens, response)) {
+            return -1;
+        }
+        int count = 0;
+        for (int chunk : response.chunks) {
+            count += chunk >= 0;
+        }
+        return response.transfer_speed + count;
+    }
+
+
+    /**
+     * @brief Interpreta os detentores de uma mensagem AGGREGATE como o ResponseAggregator fazia antes do MessageParser.
+     */
+    int parseAggregateWithStream(const std::string& message) {
+        std::stringstream ss{message};
+        std::string command, file_name, address, bitmap_text;
+        uint64_t search_id = 0;
+        int speed, holders = 0;
+
+        ss >> command >> file_name >> search_id;
+        while (ss >> address >> speed >> bitmap_text) {
+            size_t colon_pos = address.find(':');
+            std::string holder_ip = address.substr(0, colon_pos);
+            holders += !holder_ip.empty() && std::atoi(address.c_str() + colon_pos + 1) > 0 && !bitmap_text.empty();
+        }
+        return holders;
+    }
+
+
+    /**
+     * @brief Interpreta os detentores de uma mensagem AGGREGATE com o MessageParser.
+     */
+    int parseAggregateWithTokenizer(std::string_view message) {
+        MessageTokenizer tokens(message);
+        std::string_view command, address, holder_ip, bitmap_text;
+        AggregateMessage aggregate;
+        int holder_port, speed, holders = 0;
+
+        tokens.next(command);
+        if (MessageParser::parseType(command) != MessageType::AGGREGATE || !MessageParser::parseAggregate(message, tokens, aggregate)) {
+            return -1;
+        }
+        MessageTokenizer entries(aggregate.holders);
+        while (entries.next(address) && MessageParser::parseAddress(address, holder_ip, holder_port) &&
+               entries.nextNumber(speed) && entries.next(bitmap_text)) {
+            holders += !holder_ip.empty() && holder_port > 0 && !bitmap_text.empty();
+        }
+        return holders;
+    }
+}
+
+
+/**
+ * @brief Executa os benchmarks de interpretação das mensagens UDP (stringstream contra o MessageParser).
+ */
+void runParserBenchmarks(BenchmarkSuite& suite) {
+    const std::string discovery = "DISCOVERY image.png 1000 3 127.0.0.1:6000 1234567890 250";
+    suite.run("parseDiscoveryStream", {}, [&] {
+        doNotOptimize(parseDiscoveryWithStream(discovery));
+    }).bytes_per_operation = discovery.size();
+    suite.run("parseDiscoveryTokenizer", {}, [&] {
+        doNotOptimize(parseDiscoveryWithTokenizer(discovery));
+    }).bytes_per_operation = discovery.size();
+
+    for (int chunk_count : {10, 1000}) {
+        std::string response = "RESPONSE image.png 1024 ";
+        for (int chunk = 0; chunk < chunk_count; ++chunk) {
+            response += std::to_string(chunk) + " ";
+        }
+
+        suite.run("parseResponseStream", {{"chunks", chunk_count}}, [&] {
+            doNotOptimize(parseResponseWithStream(response));
+        }).bytes_per_operation = response.size();
+        suite.run("parseResponseTokenizer", {{"chunks", chunk_count}}, [&] {
+            doNotOptimize(parseResponseWithTokenizer(response));
+        }).bytes_per_operation = response.size();
+    }
+
+    std::string aggregate = "AGGREGATE image.png 1234567890";
+    for (int holder = 0; holder < AGGREGATE_HOLDERS; ++holder) {
+        aggregate += " 127.0.0.1:" + std::to_string(6000 + holder) + " 1024 ffffffffffffffffffffffffffffffff";
+    }
+    suite.run("parseAggregateStream", {{"holders", AGGREGATE_HOLDERS}}, [&] {
+        doNotOptimize(parseAggregateWithStream(aggregate));
+    }).bytes_per_operation = aggregate.size();
+    suite.run("parseAggregateTokenizer", {{"holders", AGGREGATE_HOLDERS}}, [&] {
+        doNotOptimize(parseAggregateWithTokenizer(aggregate));
+    }).bytes_per_operation = aggregate.size();
+}
@@ -1,4 +1,8 @@
+#include "Compression.h"
 #include "ConfigManager.h"
+#include "ControlServer.h"
+#include "CpuTopology.h"
+#include "Metrics.h"
 #include "Peer.h"
 #include "Utils.h"
 #include <iostream>
@@ -7,66 +11,213 @@
 
 int main(int argc, char* argv[]) {
     if (argc < 3) {
-        logMessage(LogType::ERROR, "Uso: " + std::string(argv[0]) + " <peer_id> <file_name_1> <file_name_2> ...");
+        LOG_MESSAGE(LogType::ERROR, "Uso: " + std::string(argv[0]) + " <peer_id> [--daemon] [--log-level=error|info|debug|trace] [--log-format=text|json|binary] [--log-file=<path>] [--metrics-file=<path>] [--io=auto|blocking|uring] [--compression=off|auto|lz4|zstd] [--pin=off|cores|numa] [--io-threads=<n>] [--worker-threads=<n>] [--bootstrap=<ip>:<porta UDP>] [--address=<ip>:<porta UDP> --speed=<bytes/s>] [--erasure=<k>:<n>] <file_name_1> <file_name_2> ...");
+        LOG_MESSAGE(LogType::ERROR, "     " + std::string(argv[0]) + " <peer_id> --control <DOWNLOAD <file_name> [priority] | CANCEL <file_name> | STATUS | METRICS | NEIGHBORS | LEAVE>");
         return 1;
     }
 
+    // Modo cliente: envia um comando ao peer em modo daemon e termina
+    if (std::string(argv[2]) == "--control") {
+        std::string command_line;
+        for (int i = 3; i < argc; ++i) {
+            command_line += (i > 3 ? " " : "") + std::string(argv[i]);
+        }
+
+        std::string response = ControlServer::sendCommand(ControlServer::getSocketPath(std::stoi(argv[1])), command_line);
+        std::cout << response;
+        return response.rfind("OK", 0) == 0 ? 0 : 1;
+    }
+
     // Limpa o terminal antes de iniciar o programa
     system("clear");
 
-    // Configuração para flush automático após cada operação de saída
-    std::cout.setf(std::ios::unitbuf);
-
     // Identifica o Peer
     int peer_id = std::stoi(argv[1]);
 
+    // Verifica se o peer deve permanecer residente aceitando comandos
+    bool daemon_mode = false;
+
+    // Arquivo onde o snapshot das métricas é gravado periodicamente (vazio: desabilitado)
+    std::string metrics_file;
+
+    // Peer de bootstrap usado para entrar na rede sem uma linha no topologia.txt (vazio: desabilitado)
+    std::string bootstrap_address;
+
+    // Endereço e velocidade informados na linha de comando, para peers ausentes do config.txt
+    std::string own_address;
+    int own_speed = 0;
+
+    // Codificação de apagamento com que os arquivos informados são publicados antes do início (0: nenhum arquivo é publicado)
+    int erasure_data_chunks = 0, erasure_total_chunks = 0;
+
+    // Modelo de threads: afinidade e número de threads de E/S e de processamento
+    ThreadingConfig threading = CpuTopology::getDefaultConfig();
+
     // Pega o nome dos arquivos
     std::vector<std::string> file_names;
     for (int i = 2; i < argc; ++i) {
-        file_names.push_back(argv[i]);
+        std::string arg = argv[i];
+
+        if (arg == "--daemon") {
+            daemon_mode = true;
+        } else if (arg.rfind("--log-level=", 0) == 0) {
+            // Nível de log: error, info, debug ou trace
+            LogLevel level;
+            if (!Logger::parseLevel(arg.substr(12), level)) {
+                LOG_MESSAGE(LogType::ERROR, "Nível de log inválido: " + arg.substr(12));
+                return 1;
+            }
+            Logger::instance().setLevel(level);
+        } else if (arg.rfind("--log-format=", 0) == 0) {
+            // Formato de log: text, json ou binary
+            LogFormat format;
+            if (!Logger::parseFormat(arg.substr(13), format)) {
+                LOG_MESSAGE(LogType::ERROR, "Formato de log inválido: " + arg.substr(13));
+                return 1;
+            }
+            Logger::instance().setFormat(format);
+        } else if (arg.rfind("--log-file=", 0) == 0) {
+            // Arquivo de destino do log (padrão: saída padrão)
+            if (!Logger::instance().setOutputFile(arg.substr(11))) {
+                LOG_MESSAGE(LogType::ERROR, "Não foi possível abrir o arquivo de log " + arg.substr(11));
+                return 1;
+            }
+        } else if (arg.rfind("--metrics-file=", 0) == 0) {
+            metrics_file = arg.substr(15);
+        } else if (arg.rfind("--io=", 0) == 0) {
+            // E/S dos chunks: blocking (padrão), uring ou auto (io_uring quando disponível)
+            IOBackend backend;
+            if (!IOEngine::parseBackend(arg.substr(5), backend)) {
+                LOG_MESSAGE(LogType::ERROR, "E/S inválida: " + arg.substr(5));
+                return 1;
+            }
+            IOEngine::setDefaultBackend(backend);
+        } else if (arg.rfind("--compression=", 0) == 0) {
+            // Compressão dos chunks enviados: auto (padrão), off, lz4 ou zstd
+            CompressionMode mode;
+            if (!Compression::parseMode(arg.substr(14), mode)) {
+                LOG_MESSAGE(LogType::ERROR, "Compressão inválida: " + arg.substr(14));
+                return 1;
+            }
+            Compression::setDefaultMode(mode);
+        } else if (arg.rfind("--pin=", 0) == 0) {
+            // Afinidade das threads: off (padrão), cores (um núcleo por thread) ou numa (núcleos de um nó)
+            if (!CpuTopology::parsePinning(arg.substr(6), threading.pinning)) {
+                LOG_MESSAGE(LogType::ERROR, "Afinidade inválida: " + arg.substr(6));
+                return 1;
+            }
+        } else if (arg.rfind("--io-threads=", 0) == 0) {
+            threading.io_threads = std::atoi(arg.c_str() + 13);
+        } else if (arg.rfind("--worker-threads=", 0) == 0) {
+            threading.worker_threads = std::atoi(arg.c_str() + 17);
+        } else if (arg.rfind("--bootstrap=", 0) == 0) {
+            bootstrap_address = arg.substr(12);
+        } else if (arg.rfind("--address=", 0) == 0) {
+            own_address = arg.substr(10);
+        } else if (arg.rfind("--speed=", 0) == 0) {
+            own_speed = std::stoi(arg.substr(8));
+        } else if (arg.rfind("--erasure=", 0) == 0) {
+            // Publica os arquivos em n chunks dos quais quaisquer k reconstroem o arquivo
+            size_t colon_pos = arg.find(':', 10);
+            if (colon_pos != std::string::npos) {
+                erasure_data_chunks = std::atoi(arg.c_str() + 10);
+                erasure_total_chunks = std::atoi(arg.c_str() + colon_pos + 1);
+            }
+            if (!ErasureCoder::isValid(erasure_data_chunks, erasure_total_chunks)) {
+                LOG_MESSAGE(LogType::ERROR, "Codificação de apagamento inválida: " + arg.substr(10) + ". Use k:n com 0 < k <= n <= " +
+                            std::to_string(Constants::ERASURE_MAX_CHUNKS) + ".");
+                return 1;
+            }
+        } else {
+            file_names.push_back(arg);
+        }
     }
 
-    logMessage(LogType::INFO, "Peer " + std::to_string(peer_id) + " inicializado.");
-    
-    // Carrega as configurações
-    auto config = ConfigManager::loadConfig();
+    if (threading.io_threads < 1 || threading.worker_threads < 1) {
+        LOG_MESSAGE(LogType::ERROR, "O número de threads de E/S e de processamento deve ser positivo.");
+        return 1;
+    }
+    CpuTopology::setDefaultConfig(threading);
 
-    // Verifica se o peer_id está na configuração
-    if (config.find(peer_id) == config.end()) {
-        logMessage(LogType::ERROR, "Peer " + std::to_string(peer_id) + " não encontrado nas configurações.");
+    LOG_MESSAGE(LogType::INFO, "Peer " + std::to_string(peer_id) + " inicializado.");
+    
+    // Carrega as configurações e a topologia (da forma binária, quando ela corresponde aos arquivos de texto)
+    NetworkConfig network;
+    bool network_loaded = ConfigManager::loadNetwork(network);
+    if (!network_loaded && own_address.empty()) {
         return 1;
     }
 
-    // Obtém as configurações do peer
-    auto [ip, udp_port, speed] = config[peer_id];
+    // Verifica se o peer_id está na configuração ou se o endereço foi informado na linha de comando
+    int peer_index = network_loaded ? network.findPeer(peer_id) : -1;
+    std::string ip;
+    int udp_port, speed;
+    if (peer_index >= 0) {
+        // Obtém as configurações do peer
+        std::tie(ip, udp_port, speed) = network.getPeer(peer_index);
+    } else if (!own_address.empty() && own_speed > 0 && own_address.find(':') != std::string::npos) {
+        ip = own_address.substr(0, own_address.find(':'));
+        udp_port = std::stoi(own_address.substr(own_address.find(':') + 1));
+        speed = own_speed;
+    } else {
+        LOG_MESSAGE(LogType::ERROR, "Peer " + std::to_string(peer_id) + " não encontrado nas configurações. Informe --address e --speed.");
+        return 1;
+    }
     int tcp_port = udp_port + 1000; // Exemplo: porta TCP é a UDP + 1000
 
     // Mata os processos nas portas que serão utilizadas para comunicação TCP e UDP
     system(("lsof -ti :" + std::to_string(tcp_port) + "," + std::to_string(udp_port) + " | xargs -r kill -9 2>/dev/null").c_str());
-    logMessage(LogType::INFO, "Liberando porta TCP: " + std::to_string(tcp_port) + " e porta UDP: " + std::to_string(udp_port) + "...");
+    LOG_MESSAGE(LogType::INFO, "Liberando porta TCP: " + std::to_string(tcp_port) + " e porta UDP: " + std::to_string(udp_port) + "...");
     // Pequeno atraso para esperar a liberação das portas
     std::this_thread::sleep_for(std::chrono::seconds(Constants::WAIT_TIME_FOR_PORTS_RELEASE_SECONDS));
-    
-    // Carrega a topologia
-    auto topology = ConfigManager::loadTopology();
 
-    // Verifica se o peer_id está na configuração
-    if (topology.find(peer_id) == topology.end()) {
-        logMessage(LogType::ERROR, "Peer " + std::to_string(peer_id) + " não encontrado na topologia.");
+    // Sem linha na topologia, o peer só pode entrar na rede pelo bootstrap
+    bool in_topology = peer_index >= 0 && network.in_topology[peer_index];
+    if (!in_topology && bootstrap_address.empty()) {
+        LOG_MESSAGE(LogType::ERROR, "Peer " + std::to_string(peer_id) + " não encontrado na topologia. Informe um peer com --bootstrap.");
         return 1;
     }
 
-    //  Expande ela para incluir informações dos vizinhos do peer
-    auto expand_topology = ConfigManager::expandTopology(topology, config);
-
-    // Pega os vizinhos do peer
-    auto neighbors = expand_topology[peer_id];
+    // Expande somente a vizinhança do peer para incluir IP e porta dos vizinhos
+    std::vector<std::tuple<std::string, int>> neighbors;
+    if (in_topology) {
+        neighbors = network.getNeighbors(peer_index);
+    }
     
+    // Publica os arquivos com codificação de apagamento antes de o peer carregar os chunks locais
+    if (erasure_data_chunks > 0) {
+        FileManager publisher(std::to_string(peer_id));
+        publisher.loadLocalChunks();
+        for (const std::string& file_name : file_names) {
+            if (!publisher.publishErasureCoded(file_name, erasure_data_chunks, erasure_total_chunks)) {
+                return 1;
+            }
+        }
+
+        // Os arquivos publicados já estão completos no peer, que apenas os serve: não são registrados como downloads
+        file_names.clear();
+    }
+
     // Cria o peer
     Peer peer(peer_id, ip, udp_port, tcp_port, speed, neighbors);
 
+    // Usa o bootstrap para entrar na rede quando o peer não tiver vizinhos
+    if (!bootstrap_address.empty()) {
+        size_t colon_pos = bootstrap_address.find(':');
+        if (colon_pos == std::string::npos) {
+            LOG_MESSAGE(LogType::ERROR, "Endereço de bootstrap inválido: " + bootstrap_address);
+            return 1;
+        }
+        peer.setBootstrapPeer(bootstrap_address.substr(0, colon_pos), std::stoi(bootstrap_address.substr(colon_pos + 1)));
+    }
+
+    // Grava o snapshot das métricas periodicamente, se solicitado
+    if (!metrics_file.empty()) {
+        std::thread(&Metrics::runSnapshotWriter, &Metrics::instance(), metrics_file, Constants::METRICS_SNAPSHOT_INTERVAL_SECONDS).detach();
+    }
+
     // Inicia o peer com os nomes dos arquivos que deseja buscar
-    peer.start(file_names);
+    peer.start(file_names, daemon_mode);
 
     return 0;
 }
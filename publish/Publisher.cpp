@@ -0,0 +1,154 @@
+#include "Publisher.h"
+#include "BufferPool.h"
+#include "Executor.h"
+#include "IOEngine.h"
+#include "Logger.h"
+#include "Sha256.h"
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <fcntl.h>
+#include <filesystem>
+#include <mutex>
+#include <sys/stat.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+
+/**
+ * @brief Construtor da classe Publisher.
+ */
+Publisher::Publisher(const std::string& peer_id, const std::string& base_path, const PublishOptions& options)
+    : peer_id(peer_id), base_path(base_path), options(options) {}
+
+
+/**
+ * @brief Publica um arquivo no diretório do peer.
+ */
+bool Publisher::publish(const std::string& input_path) {
+    std::string file_name = std::filesystem::path(input_path).filename().string();
+
+    int input_fd = open(input_path.c_str(), O_RDONLY | O_CLOEXEC);
+    struct stat input_stat;
+    if (input_fd < 0 || fstat(input_fd, &input_stat) != 0 || input_stat.st_size == 0) {
+        LOG_MESSAGE(LogType::ERROR, "Não foi possível ler o arquivo " + input_path + " para publicá-lo.");
+        if (input_fd >= 0) {
+            close(input_fd);
+        }
+        return false;
+    }
+    uint64_t file_size = static_cast<uint64_t>(input_stat.st_size);
+
+    // Cria o diretório do peer, se necessário, e define o caminho dos chunks
+    FileManager file_manager(peer_id, base_path);
+    file_manager.loadLocalChunks();
+
+    // A leitura é sequencial e sem concorrência: as chamadas bloqueantes são suficientes
+    IOEngine& io_engine = IOEngine::blockingEngine();
+    Chunker chunker(options.chunking, options.chunk_size);
+    int num_threads = options.threads > 0 ? options.threads : static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+
+    // Estado compartilhado com as tarefas, protegido por state_mutex
+    std::mutex state_mutex;
+    std::condition_variable state_cv;
+    std::vector<ChunkDescriptor> chunks;
+    size_t pending_bytes = 0;
+    size_t pending_tasks = 0;
+    bool failed = false;
+
+    auto start = std::chrono::steady_clock::now();
+
+    // Janela com o dobro do tamanho máximo de um chunk: sempre há um chunk inteiro à frente do início
+    std::vector<char> window(2 * chunker.getMaxSize());
+    size_t window_begin = 0;
+    size_t window_end = 0;
+    uint64_t read_offset = 0;
+    bool read_ok = true;
+
+    {
+        Executor executor(num_threads);
+
+        while (read_ok) {
+            // Completa a janela quando resta menos de um chunk máximo e o arquivo ainda não acabou
+            if (window_end - window_begin < chunker.getMaxSize() && read_offset < file_size) {
+                std::memmove(window.data(), window.data() + window_begin, window_end - window_begin);
+                window_end -= window_begin;
+                window_begin = 0;
+
+                size_t length = static_cast<size_t>(std::min<uint64_t>(window.size() - window_end, file_size - read_offset));
+                read_ok = io_engine.readAt(input_fd, window.data() + window_end, length, static_cast<off_t>(read_offset));
+                if (!read_ok) {
+                    break;
+                }
+                window_end += length;
+                read_offset += length;
+            }
+            if (window_begin == window_end) {
+                break;
+            }
+
+            size_t chunk_size = chunker.nextBoundary(window.data() + window_begin, window_end - window_begin, read_offset == file_size);
+            Buffer buffer = BufferPool::instance().acquire(chunk_size);
+            std::memcpy(buffer.data(), window.data() + window_begin, chunk_size);
+            window_begin += chunk_size;
+
+            int chunk;
+            {
+                // Limita a memória: espera as tarefas liberarem espaço (um chunk sozinho sempre é aceito)
+                std::unique_lock<std::mutex> state_lock(state_mutex);
+                state_cv.wait(state_lock, [&] { return pending_bytes == 0 || pending_bytes + chunk_size <= Constants::PUBLISH_MAX_PENDING_BYTES; });
+                if (failed) {
+                    break;
+                }
+                chunk = static_cast<int>(chunks.size());
+                chunks.emplace_back();
+                pending_bytes += chunk_size;
+                ++pending_tasks;
+            }
+
+            std::string chunk_path = file_manager.getChunkPath(file_name, chunk);
+            executor.submit([&, buffer = std::move(buffer), chunk_path = std::move(chunk_path), chunk]() {
+                Sha256::Digest digest = Sha256::hash(buffer.data(), buffer.size());
+
+                // Um chunk antigo pode ser um link físico compartilhado com outro arquivo: é substituído, não sobrescrito
+                std::error_code remove_error;
+                std::filesystem::remove(chunk_path, remove_error);
+                bool written = io_engine.writeFile(chunk_path, buffer.data(), buffer.size());
+
+                std::lock_guard<std::mutex> state_lock(state_mutex);
+                chunks[chunk].size = buffer.size();
+                chunks[chunk].digest = digest;
+                failed = failed || !written;
+                pending_bytes -= buffer.size();
+                --pending_tasks;
+                state_cv.notify_all();
+            });
+        }
+
+        std::unique_lock<std::mutex> state_lock(state_mutex);
+        state_cv.wait(state_lock, [&] { return pending_tasks == 0; });
+    }
+    close(input_fd);
+
+    if (!read_ok || failed) {
+        LOG_MESSAGE(LogType::ERROR, "Erro ao " + std::string(!read_ok ? "ler " + input_path : "gravar os chunks de " + file_name) + ".");
+        return false;
+    }
+
+    // Remove chunks de uma publicação anterior maior, que não pertencem mais ao arquivo
+    int total_chunks = static_cast<int>(chunks.size());
+    std::error_code error;
+    for (int chunk = total_chunks; std::filesystem::remove(file_manager.getChunkPath(file_name, chunk), error); ++chunk) {
+    }
+
+    if (!file_manager.saveMetadata(file_name, total_chunks, options.ttl, options.discovery_mode, ErasureScheme(), chunks)) {
+        return false;
+    }
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    LOG_MESSAGE(LogType::INFO, "Arquivo " + file_name + " publicado em " + std::to_string(total_chunks) + " chunks (" +
+                Chunker::modeToString(options.chunking) + ", " + std::to_string(file_size) + " bytes, " +
+                std::to_string(static_cast<int>(file_size / 1e6 / std::max(seconds, 1e-9))) + " MB/s com " + std::to_string(num_threads) + " threads).");
+    return true;
+}
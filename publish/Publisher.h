@@ -0,0 +1,60 @@
+#ifndef PUBLISHER_H
+#define PUBLISHER_H
+
+#include "Chunker.h"
+#include "Constants.h"
+#include "FileManager.h"
+#include <string>
+
+
+/**
+ * @brief Estrutura com as opções de publicação de um arquivo.
+ */
+struct PublishOptions {
+    ChunkingMode chunking = ChunkingMode::FIXED;                    ///< Modo de divisão em chunks.
+    size_t chunk_size = Constants::PUBLISH_DEFAULT_CHUNK_SIZE;      ///< Tamanho (FIXED) ou tamanho médio (CDC) dos chunks.
+    int threads = 0;                                                ///< Threads que resumem e gravam os chunks (0: uma por núcleo).
+    int ttl = Constants::PUBLISH_DEFAULT_TTL;                       ///< TTL inicial das descobertas, gravado no .p2p.
+    DiscoveryMode discovery_mode = DiscoveryMode::FLOOD;            ///< Modo de descoberta gravado no .p2p.
+};
+
+
+/**
+ * @brief Classe que divide um arquivo em chunks no diretório de um peer e gera o seu .p2p.
+ *
+ * O arquivo é lido sequencialmente em uma janela de tamanho fixo; cada chunk encontrado pelo
+ * Chunker é copiado para um buffer do BufferPool e entregue a um Executor, cujas threads
+ * calculam o SHA-256 e gravam o chunk em paralelo. A leitura espera enquanto os chunks
+ * pendentes somam Constants::PUBLISH_MAX_PENDING_BYTES, de modo que a memória usada não
+ * depende do tamanho do arquivo.
+ */
+class Publisher {
+private:
+    std::string peer_id;                                    ///< ID do peer cujo diretório recebe os chunks.
+    std::string base_path;                                  ///< Caminho base dos metadados e dos diretórios dos peers.
+    PublishOptions options;                                 ///< Opções de publicação.
+
+public:
+    /**
+     * @brief Construtor da classe Publisher.
+     *
+     * @param peer_id ID do peer cujo diretório recebe os chunks.
+     * @param base_path Caminho base dos metadados e dos diretórios dos peers (padrão: Constants::BASE_PATH).
+     * @param options Opções de publicação.
+     */
+    Publisher(const std::string& peer_id, const std::string& base_path = Constants::BASE_PATH, const PublishOptions& options = PublishOptions());
+
+
+    /**
+     * @brief Publica um arquivo: grava os seus chunks no diretório do peer e o .p2p com o tamanho e o resumo de cada chunk.
+     *
+     * O nome publicado é o nome do arquivo, sem o diretório. Chunks antigos do mesmo nome além
+     * do novo número de chunks são removidos.
+     *
+     * @param input_path Caminho do arquivo a publicar.
+     * @return true se todos os chunks e o .p2p foram gravados.
+     */
+    bool publish(const std::string& input_path);
+};
+
+#endif // PUBLISHER_H
@@ -0,0 +1,75 @@
+#include "Publisher.h"
+#include "Logger.h"
+#include <iostream>
+
+
+namespace {
+    /**
+     * @brief Exibe as opções da ferramenta de publicação.
+     */
+    void printUsage(const char* program) {
+        std::cerr << "Uso: " << program << " <peer_id> <arquivo> [opções]\n"
+                  << "  --chunking=M                fixed | cdc, divisão em chunks de tamanho fixo ou definidos pelo conteúdo (padrão fixed)\n"
+                  << "  --chunk-size=B              bytes por chunk, ou tamanho médio em cdc (padrão " << Constants::PUBLISH_DEFAULT_CHUNK_SIZE << ")\n"
+                  << "  --threads=N                 threads que resumem e gravam os chunks (padrão: uma por núcleo)\n"
+                  << "  --ttl=T                     TTL das descobertas gravado no .p2p (padrão " << Constants::PUBLISH_DEFAULT_TTL << ")\n"
+                  << "  --discovery=M               flood | dht | aggregate, modo de descoberta gravado no .p2p (padrão flood)\n"
+                  << "  --log-level=L               error | info | debug | trace (padrão info)\n";
+    }
+}
+
+
+int main(int argc, char* argv[]) {
+    if (argc < 3) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    std::string peer_id = argv[1];
+    std::string input_path = argv[2];
+    PublishOptions options;
+    Logger::instance().setLevel(LogLevel::INFO);
+
+    for (int i = 3; i < argc; ++i) {
+        std::string arg = argv[i];
+        size_t equals = arg.find('=');
+        std::string key = arg.substr(0, equals);
+        std::string value = equals == std::string::npos ? "" : arg.substr(equals + 1);
+
+        bool valid = true;
+        if (key == "--chunking") valid = Chunker::parseMode(value, options.chunking);
+        else if (key == "--chunk-size") options.chunk_size = std::stoul(value);
+        else if (key == "--threads") options.threads = std::stoi(value);
+        else if (key == "--ttl") options.ttl = std::stoi(value);
+        else if (key == "--discovery") {
+            if (value == "flood") options.discovery_mode = DiscoveryMode::FLOOD;
+            else if (value == "dht") options.discovery_mode = DiscoveryMode::DHT;
+            else if (value == "aggregate") options.discovery_mode = DiscoveryMode::AGGREGATE;
+            else valid = false;
+        }
+        else if (key == "--log-level") {
+            LogLevel level;
+            valid = Logger::parseLevel(value, level);
+            if (valid) {
+                Logger::instance().setLevel(level);
+            }
+        }
+        else valid = false;
+
+        if (!valid) {
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+
+    if (options.chunk_size < 1 || options.ttl < 1) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    Publisher publisher(peer_id, Constants::BASE_PATH, options);
+    bool published = publisher.publish(input_path);
+
+    Logger::instance().flush();
+    return published ? 0 : 1;
+}
@@ -0,0 +1,642 @@
+#include "Simulation.h"
+#include "DownloadJournal.h"
+#include "ErasureCoder.h"
+#include "Metrics.h"
+#include "Peer.h"
+#include "Sha256.h"
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <numeric>
+#include <queue>
+#include <set>
+#include <sstream>
+#include <thread>
+#include <arpa/inet.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+
+namespace {
+    const std::string LOOPBACK_IP = "127.0.0.1";            ///< Endereço de todos os peers simulados.
+    const std::string FILE_NAME = "sim.bin";                ///< Nome do arquivo distribuído na simulação.
+    const std::string PREVIOUS_FILE_NAME = "sim.v0.bin";    ///< Versão anterior do arquivo, mantida pelos peers pares com dedup.
+    const int POLL_INTERVAL_MILLISECONDS = 20;              ///< Intervalo entre as verificações de conclusão dos downloads.
+
+
+    /**
+     * @brief Adiciona uma aresta não direcionada à topologia, se ela ainda não existir.
+     */
+    bool addEdge(Topology& topology, int a, int b) {
+        if (a == b || std::find(topology[a].begin(), topology[a].end(), b) != topology[a].end()) {
+            return false;
+        }
+        topology[a].push_back(b);
+        topology[b].push_back(a);
+        return true;
+    }
+
+
+    /**
+     * @brief Gera o conteúdo de um chunk, diferente para cada ID, para a verificação do arquivo montado.
+     */
+    std::string chunkContent(const SimulationConfig& config, int chunk) {
+        std::string data(config.chunk_size, '\0');
+        if (config.content == "random") {
+            // Bytes aleatórios, que a compressão não consegue reduzir
+            std::mt19937_64 rng(config.seed * 1000003ull + chunk);
+            for (char& byte : data) {
+                byte = static_cast<char>(rng());
+            }
+            return data;
+        }
+        for (size_t i = 0; i < config.chunk_size; ++i) {
+            data[i] = static_cast<char>((chunk * 131 + i) & 0xFF);
+        }
+        return data;
+    }
+
+
+    /**
+     * @brief Grava o .p2p de um arquivo da simulação, com os resumos dos chunks quando informados.
+     */
+    void writeMetadata(const std::string& path, const std::string& file_name, const SimulationConfig& config,
+                       const std::vector<std::string>& digested_contents) {
+        std::ofstream metadata(path);
+        metadata << file_name << "\n" << config.chunks + config.parity << "\n" << config.ttl << "\n" << config.discovery << "\n";
+        if (config.parity > 0) {
+            metadata << "erasure " << config.chunks << " " << config.chunks * config.chunk_size << "\n";
+        }
+        for (size_t chunk = 0; chunk < digested_contents.size(); ++chunk) {
+            const std::string& content = digested_contents[chunk];
+            metadata << "chunk " << chunk << " " << content.size() << " " << Sha256::toHex(Sha256::hash(content.data(), content.size())) << "\n";
+        }
+    }
+
+
+    /**
+     * @brief Gera o conteúdo de todos os chunks: os de dados e, com codificação de apagamento, os de paridade.
+     */
+    std::vector<std::string> buildChunkContents(const SimulationConfig& config) {
+        std::vector<std::string> contents;
+        for (int chunk = 0; chunk < config.chunks + config.parity; ++chunk) {
+            contents.push_back(chunk < config.chunks ? chunkContent(config, chunk) : std::string(config.chunk_size, '\0'));
+        }
+
+        if (config.parity > 0) {
+            std::vector<const char*> data;
+            std::vector<char*> parity;
+            for (int chunk = 0; chunk < config.chunks + config.parity; ++chunk) {
+                if (chunk < config.chunks) {
+                    data.push_back(contents[chunk].data());
+                } else {
+                    parity.push_back(contents[chunk].data());
+                }
+            }
+            ErasureCoder(config.chunks, config.chunks + config.parity).encode(data, parity, config.chunk_size);
+        }
+        return contents;
+    }
+
+
+    /**
+     * @brief Soma os valores de um contador por peer local, a partir do rótulo "local=<id>,...".
+     */
+    std::vector<uint64_t> sumByLocalPeer(Counter counter, int peers) {
+        std::vector<uint64_t> totals(peers, 0);
+
+        for (const auto& [label, value] : Metrics::instance().labeledValues(counter)) {
+            if (label.rfind("local=", 0) != 0) {
+                continue;
+            }
+            int peer_id = std::stoi(label.substr(6, label.find(',') - 6));
+            if (peer_id >= 0 && peer_id < peers) {
+                totals[peer_id] += value;
+            }
+        }
+
+        return totals;
+    }
+
+
+    /**
+     * @brief Soma os valores de um contador por tipo de mensagem, a partir do rótulo "...,type=<tipo>,...".
+     */
+    std::map<std::string, uint64_t> sumByMessageType(Counter counter) {
+        std::map<std::string, uint64_t> totals;
+
+        for (const auto& [label, value] : Metrics::instance().labeledValues(counter)) {
+            size_t type_pos = label.find("type=");
+            if (type_pos == std::string::npos) {
+                continue;
+            }
+            type_pos += 5;
+            totals[label.substr(type_pos, label.find(',', type_pos) - type_pos)] += value;
+        }
+
+        return totals;
+    }
+
+
+    /**
+     * @brief Retorna o percentil de um vetor ordenado (método do valor mais próximo).
+     */
+    double percentile(const std::vector<double>& sorted_values, double fraction) {
+        if (sorted_values.empty()) {
+            return 0;
+        }
+        size_t index = static_cast<size_t>(fraction * (sorted_values.size() - 1) + 0.5);
+        return sorted_values[std::min(index, sorted_values.size() - 1)];
+    }
+}
+
+
+/**
+ * @brief Gera uma topologia em anel.
+ */
+Topology buildRingTopology(int peers, int degree) {
+    Topology topology(peers);
+    int reach = std::max(1, degree / 2);
+
+    for (int peer = 0; peer < peers; ++peer) {
+        for (int offset = 1; offset <= reach; ++offset) {
+            addEdge(topology, peer, (peer + offset) % peers);
+        }
+    }
+
+    return topology;
+}
+
+
+/**
+ * @brief Gera uma topologia aleatória em que todos os peers têm o mesmo grau.
+ */
+Topology buildRandomRegularTopology(int peers, int degree, std::mt19937& rng) {
+    degree = std::min(degree, peers - 1);
+    const int max_attempts = 100;
+
+    for (int attempt = 0; attempt < max_attempts; ++attempt) {
+        // Cada peer contribui com degree pontas de aresta
+        std::vector<int> stubs;
+        for (int peer = 0; peer < peers; ++peer) {
+            stubs.insert(stubs.end(), degree, peer);
+        }
+        std::shuffle(stubs.begin(), stubs.end(), rng);
+
+        Topology topology(peers);
+        bool failed = false;
+
+        for (size_t i = 0; i + 1 < stubs.size() && !failed; i += 2) {
+            // Troca a segunda ponta por outra ainda não pareada até formar uma aresta válida
+            int swaps = 0;
+            while (!addEdge(topology, stubs[i], stubs[i + 1])) {
+                if (i + 2 >= stubs.size() || ++swaps > 50) {
+                    failed = true;
+                    break;
+                }
+                std::uniform_int_distribution<size_t> pick(i + 2, stubs.size() - 1);
+                std::swap(stubs[i + 1], stubs[pick(rng)]);
+            }
+        }
+
+        if (!failed) {
+            return topology;
+        }
+    }
+
+    // Sem sucesso (grafo pequeno ou grau alto demais), recorre ao anel
+    return buildRingTopology(peers, degree);
+}
+
+
+/**
+ * @brief Gera uma topologia com distribuição de graus em lei de potência (Barabási–Albert).
+ */
+Topology buildPowerLawTopology(int peers, int degree, std::mt19937& rng) {
+    Topology topology(peers);
+    int edges_per_peer = std::max(1, degree / 2);
+
+    // Cada peer aparece nesta lista uma vez por aresta, de modo que o sorteio é proporcional ao grau
+    std::vector<int> endpoints;
+
+    // Núcleo inicial totalmente conectado
+    int core = std::min(peers, edges_per_peer + 1);
+    for (int a = 0; a < core; ++a) {
+        for (int b = a + 1; b < core; ++b) {
+            addEdge(topology, a, b);
+            endpoints.push_back(a);
+            endpoints.push_back(b);
+        }
+    }
+
+    for (int peer = core; peer < peers; ++peer) {
+        std::set<int> targets;
+        while (static_cast<int>(targets.size()) < std::min(edges_per_peer, peer)) {
+            std::uniform_int_distribution<size_t> pick(0, endpoints.size() - 1);
+            targets.insert(endpoints.empty() ? 0 : endpoints[pick(rng)]);
+        }
+
+        for (int target : targets) {
+            addEdge(topology, peer, target);
+            endpoints.push_back(peer);
+            endpoints.push_back(target);
+        }
+    }
+
+    return topology;
+}
+
+
+/**
+ * @brief Verifica se todos os peers da topologia estão conectados.
+ */
+bool isConnected(const Topology& topology) {
+    if (topology.empty()) {
+        return true;
+    }
+
+    std::vector<bool> visited(topology.size(), false);
+    std::queue<int> pending;
+    pending.push(0);
+    visited[0] = true;
+    size_t reached = 1;
+
+    while (!pending.empty()) {
+        int peer = pending.front();
+        pending.pop();
+        for (int neighbor : topology[peer]) {
+            if (!visited[neighbor]) {
+                visited[neighbor] = true;
+                ++reached;
+                pending.push(neighbor);
+            }
+        }
+    }
+
+    return reached == topology.size();
+}
+
+
+/**
+ * @brief Sorteia quais chunks cada peer possui no início da simulação.
+ */
+std::vector<std::vector<int>> buildChunkDistribution(const SimulationConfig& config, std::mt19937& rng) {
+    std::vector<std::vector<int>> chunks_by_peer(config.peers);
+    int total_chunks = config.chunks + config.parity;
+    std::vector<int> all_chunks(total_chunks);
+    std::iota(all_chunks.begin(), all_chunks.end(), 0);
+
+    std::vector<int> order(config.peers);
+    std::iota(order.begin(), order.end(), 0);
+    std::shuffle(order.begin(), order.end(), rng);
+
+    if (config.distribution == "scattered") {
+        // Cada chunk é colocado em 'replicas' peers distintos sorteados
+        int replicas = std::min(config.replicas, config.peers);
+        for (int chunk = 0; chunk < total_chunks; ++chunk) {
+            std::shuffle(order.begin(), order.end(), rng);
+            for (int r = 0; r < replicas; ++r) {
+                chunks_by_peer[order[r]].push_back(chunk);
+            }
+        }
+        for (auto& chunks : chunks_by_peer) {
+            std::sort(chunks.begin(), chunks.end());
+        }
+    } else {
+        // single: um seeder; full: 'seeders' peers sorteados com o arquivo completo
+        int seeders = config.distribution == "full" ? std::min(config.seeders, config.peers) : 1;
+        for (int s = 0; s < seeders; ++s) {
+            chunks_by_peer[order[s]] = all_chunks;
+        }
+    }
+
+    return chunks_by_peer;
+}
+
+
+/**
+ * @brief Reserva portas efêmeras livres no loopback.
+ */
+std::vector<int> reserveLoopbackPorts(int count, int socket_type) {
+    std::vector<int> ports;
+    std::vector<int> sockets;
+
+    for (int i = 0; i < count; ++i) {
+        int sockfd = socket(AF_INET, socket_type, 0);
+        struct sockaddr_in addr = createSockAddr(LOOPBACK_IP, 0);
+
+        if (sockfd < 0 || bind(sockfd, (struct sockaddr*)&addr, sizeof(addr)) < 0) {
+            perror("Erro ao reservar porta efêmera");
+            exit(EXIT_FAILURE);
+        }
+
+        // A porta 0 faz o sistema escolher uma porta livre, obtida com getsockname
+        socklen_t addr_len = sizeof(addr);
+        getsockname(sockfd, (struct sockaddr*)&addr, &addr_len);
+        ports.push_back(ntohs(addr.sin_port));
+        sockets.push_back(sockfd);
+    }
+
+    for (int sockfd : sockets) {
+        close(sockfd);
+    }
+
+    return ports;
+}
+
+
+/**
+ * @brief Executa um cenário completo e retorna o relatório em JSON.
+ */
+std::string runSimulation(const SimulationConfig& config, const std::string& work_directory) {
+    namespace fs = std::filesystem;
+    std::mt19937 rng(config.seed);
+
+    // Os servidores TCP dos peers criados a seguir usam a política de compressão e o modelo de threads do cenário
+    Compression::setDefaultMode(config.compression);
+    CpuTopology::setDefaultConfig(config.threading);
+
+    // Topologia e distribuição inicial dos chunks; os joiners ficam fora da topologia inicial
+    int topology_peers = config.peers - config.joiners;
+    Topology topology;
+    if (config.topology == "random-regular") {
+        topology = buildRandomRegularTopology(topology_peers, config.degree, rng);
+    } else if (config.topology == "power-law") {
+        topology = buildPowerLawTopology(topology_peers, config.degree, rng);
+    } else {
+        topology = buildRingTopology(topology_peers, config.degree);
+    }
+    topology.resize(config.peers);
+    auto chunks_by_peer = buildChunkDistribution(config, rng);
+
+    std::vector<std::string> chunk_contents = buildChunkContents(config);
+
+    // Versão anterior: os chunks sorteados como em comum têm o mesmo conteúdo; os demais, um conteúdo que o arquivo novo não tem
+    std::vector<std::string> previous_contents;
+    if (config.dedup > 0) {
+        std::vector<int> order(config.chunks);
+        std::iota(order.begin(), order.end(), 0);
+        std::shuffle(order.begin(), order.end(), rng);
+        std::set<int> shared(order.begin(), order.begin() + config.chunks * config.dedup / 100);
+
+        for (int chunk = 0; chunk < config.chunks; ++chunk) {
+            std::string content = chunk_contents[chunk];
+            if (shared.count(chunk) == 0) {
+                for (char& byte : content) {
+                    byte = static_cast<char>(byte ^ 0x5A);
+                }
+            }
+            previous_contents.push_back(content);
+        }
+
+        // Os chunks em comum só existem na versão anterior
+        for (auto& chunks : chunks_by_peer) {
+            chunks.erase(std::remove_if(chunks.begin(), chunks.end(), [&](int chunk) { return shared.count(chunk) > 0; }), chunks.end());
+        }
+    }
+
+    // Metadados do arquivo (com os resumos dos chunks quando há versão anterior) e chunks iniciais de cada peer
+    fs::create_directories(work_directory);
+    writeMetadata(work_directory + FILE_NAME + ".p2p", FILE_NAME, config, config.dedup > 0 ? chunk_contents : std::vector<std::string>());
+    if (config.dedup > 0) {
+        writeMetadata(work_directory + PREVIOUS_FILE_NAME + ".p2p", PREVIOUS_FILE_NAME, config, previous_contents);
+    }
+    for (int peer = 0; peer < config.peers; ++peer) {
+        std::string directory = work_directory + std::to_string(peer);
+        fs::create_directories(directory);
+        for (int chunk : chunks_by_peer[peer]) {
+            std::ofstream chunk_file(directory + "/" + FILE_NAME + ".ch" + std::to_string(chunk), std::ios::binary);
+            chunk_file << chunk_contents[chunk];
+        }
+        for (size_t chunk = 0; peer % 2 == 0 && chunk < previous_contents.size(); ++chunk) {
+            std::ofstream chunk_file(directory + "/" + PREVIOUS_FILE_NAME + ".ch" + std::to_string(chunk), std::ios::binary);
+            chunk_file << previous_contents[chunk];
+        }
+    }
+
+    // Leechers: peers sem chunks suficientes para montar o arquivo (k com codificação de apagamento), limitados a 'leechers' sorteados
+    std::vector<int> leechers;
+    for (int peer = 0; peer < config.peers; ++peer) {
+        if (static_cast<int>(chunks_by_peer[peer].size()) < config.chunks) {
+            leechers.push_back(peer);
+        }
+    }
+    if (config.leechers >= 0 && config.leechers < static_cast<int>(leechers.size())) {
+        std::shuffle(leechers.begin(), leechers.end(), rng);
+        leechers.resize(config.leechers);
+        std::sort(leechers.begin(), leechers.end());
+    }
+
+    // Download interrompido: o início de cada chunk faltante está no arquivo parcial e no diário, como antes de um reinício
+    size_t resumed_bytes = config.chunk_size * config.resume / 100;
+    for (int peer : config.resume > 0 ? leechers : std::vector<int>()) {
+        FileManager file_manager(std::to_string(peer), work_directory, config.timing);
+        file_manager.loadLocalChunks();
+        DownloadJournal journal(file_manager, work_directory + std::to_string(peer) + "/" + Constants::DOWNLOAD_JOURNAL_FILE_NAME, config.timing);
+        journal.addFile(FILE_NAME, 0);
+
+        std::set<int> held(chunks_by_peer[peer].begin(), chunks_by_peer[peer].end());
+        for (int chunk = 0; resumed_bytes > 0 && chunk < config.chunks + config.parity; ++chunk) {
+            if (held.count(chunk) == 0) {
+                std::ofstream partial_file(file_manager.getPartialChunkPath(FILE_NAME, chunk), std::ios::binary);
+                partial_file << chunk_contents[chunk].substr(0, resumed_bytes);
+                journal.recordPartial(FILE_NAME, chunk, resumed_bytes);
+            }
+        }
+        journal.flush();
+    }
+
+    // Portas efêmeras para os servidores UDP e TCP
+    std::vector<int> udp_ports = reserveLoopbackPorts(config.peers, SOCK_DGRAM);
+    std::vector<int> tcp_ports = reserveLoopbackPorts(config.peers, SOCK_STREAM);
+
+    // Os peers nunca são destruídos: threads destacadas dos servidores continuam usando-os até o fim do processo
+    std::vector<Peer*> peers;
+    for (int peer = 0; peer < config.peers; ++peer) {
+        std::vector<std::tuple<std::string, int>> neighbors;
+        for (int neighbor : topology[peer]) {
+            neighbors.emplace_back(LOOPBACK_IP, udp_ports[neighbor]);
+        }
+        peers.push_back(new Peer(peer, LOOPBACK_IP, udp_ports[peer], tcp_ports[peer], config.transfer_speed,
+                                 neighbors, work_directory, config.timing));
+
+        // Os joiners entram na rede pelo peer 0
+        if (peer >= topology_peers) {
+            peers.back()->setBootstrapPeer(LOOPBACK_IP, udp_ports[0]);
+        }
+    }
+    for (Peer* peer : peers) {
+        std::thread([peer] { peer->start({}); }).detach();
+    }
+
+    // Aguarda os servidores iniciarem (e o aquecimento da rede) e registra os downloads dos leechers, espaçados por stagger_ms
+    std::this_thread::sleep_for(config.timing.server_startup_delay + std::chrono::milliseconds(100 + config.warmup_ms));
+    auto start_time = std::chrono::steady_clock::now();
+    std::vector<std::chrono::steady_clock::time_point> submit_time(config.peers, start_time);
+    size_t submitted = 0;
+
+    // Acompanha o estado dos downloads até todos terminarem ou o tempo limite
+    std::vector<double> completion_ms(config.peers, -1);
+    std::vector<std::string> final_state(config.peers, "");
+    auto deadline = start_time + std::chrono::seconds(config.timeout_seconds) + std::chrono::milliseconds(config.stagger_ms) * leechers.size();
+    size_t finished = 0;
+
+    while (finished < leechers.size() && std::chrono::steady_clock::now() < deadline) {
+        // Registra os downloads cujo horário chegou; o tempo de conclusão conta a partir do registro
+        auto now = std::chrono::steady_clock::now();
+        while (submitted < leechers.size() && now >= start_time + std::chrono::milliseconds(config.stagger_ms) * submitted) {
+            submit_time[leechers[submitted]] = now;
+            peers[leechers[submitted]]->submitDownload(FILE_NAME);
+            ++submitted;
+        }
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(POLL_INTERVAL_MILLISECONDS));
+
+        for (int peer : leechers) {
+            if (!final_state[peer].empty()) {
+                continue;
+            }
+            for (const auto& status : peers[peer]->getDownloadsStatus()) {
+                if (status.state == DownloadState::COMPLETED || status.state == DownloadState::FAILED) {
+                    final_state[peer] = DownloadScheduler::stateToString(status.state);
+                    completion_ms[peer] = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - submit_time[peer]).count();
+                    ++finished;
+                }
+            }
+        }
+    }
+    double wall_time_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start_time).count();
+
+    // Confere o conteúdo dos arquivos montados
+    std::string expected_content;
+    for (int chunk = 0; chunk < config.chunks; ++chunk) {
+        expected_content += chunk_contents[chunk];
+    }
+    std::vector<bool> verified(config.peers, false);
+    int verified_count = 0;
+    for (int peer : leechers) {
+        std::ifstream assembled(work_directory + std::to_string(peer) + "/" + FILE_NAME, std::ios::binary);
+        std::stringstream content;
+        content << assembled.rdbuf();
+        verified[peer] = assembled.is_open() && content.str() == expected_content;
+        verified_count += verified[peer];
+    }
+
+    // Métricas por peer, a partir dos rótulos local=<id>
+    auto messages_in = sumByLocalPeer(Counter::MESSAGES_IN, config.peers);
+    auto messages_out = sumByLocalPeer(Counter::MESSAGES_OUT, config.peers);
+    auto bytes_sent = sumByLocalPeer(Counter::BYTES_SENT, config.peers);
+    auto bytes_received = sumByLocalPeer(Counter::BYTES_RECEIVED, config.peers);
+    auto chunks_sent = sumByLocalPeer(Counter::CHUNKS_SENT, config.peers);
+    auto chunks_received = sumByLocalPeer(Counter::CHUNKS_RECEIVED, config.peers);
+    auto chunks_deduplicated = sumByLocalPeer(Counter::CHUNKS_DEDUPLICATED, config.peers);
+    auto chunks_compressed = sumByLocalPeer(Counter::CHUNKS_COMPRESSED, config.peers);
+    auto compression_bytes_saved = sumByLocalPeer(Counter::COMPRESSION_BYTES_SAVED, config.peers);
+    auto chunks_resumed = sumByLocalPeer(Counter::CHUNKS_RESUMED, config.peers);
+    auto resume_bytes_saved = sumByLocalPeer(Counter::RESUME_BYTES_SAVED, config.peers);
+    auto messages_by_type = sumByMessageType(Counter::MESSAGES_OUT);
+
+    // Resultados das buscas na DHT, a partir do rótulo "...,result=<found|empty>"
+    uint64_t dht_found = 0, dht_empty = 0;
+    for (const auto& [label, value] : Metrics::instance().labeledValues(Counter::DHT_LOOKUPS)) {
+        (label.find("result=found") != std::string::npos ? dht_found : dht_empty) += value;
+    }
+
+    // Aproveitamento do cache de disponibilidade, a partir do rótulo "...,result=<hit|partial|miss>"
+    std::map<std::string, uint64_t> cache_lookups = {{"hit", 0}, {"partial", 0}, {"miss", 0}};
+    for (const auto& [label, value] : Metrics::instance().labeledValues(Counter::AVAILABILITY_CACHE_LOOKUPS)) {
+        size_t result_pos = label.find("result=");
+        if (result_pos != std::string::npos) {
+            cache_lookups[label.substr(result_pos + 7)] += value;
+        }
+    }
+
+    // Chunks pedidos logo após um anúncio HAVE, sem esperar nova descoberta
+    uint64_t have_chunks_requested = 0;
+    for (const auto& [label, value] : Metrics::instance().labeledValues(Counter::HAVE_CHUNKS_REQUESTED)) {
+        have_chunks_requested += value;
+    }
+
+    std::vector<double> completed_times;
+    int completed = 0, failed = 0;
+    for (int peer : leechers) {
+        if (final_state[peer] == "COMPLETED") {
+            ++completed;
+            completed_times.push_back(completion_ms[peer]);
+        } else if (final_state[peer] == "FAILED") {
+            ++failed;
+        }
+    }
+    std::sort(completed_times.begin(), completed_times.end());
+
+    std::set<int> leecher_set(leechers.begin(), leechers.end());
+    std::stringstream json;
+    json << "{\n  \"config\": {\"peers\": " << config.peers << ", \"topology\": \"" << config.topology << "\", \"degree\": " << config.degree
+         << ", \"joiners\": " << config.joiners
+         << ", \"connected\": " << (isConnected(Topology(topology.begin(), topology.begin() + topology_peers)) ? "true" : "false")
+         << ", \"chunks\": " << config.chunks << ", \"chunk_size\": " << config.chunk_size
+         << ", \"distribution\": \"" << config.distribution << "\", \"seeders\": " << config.seeders << ", \"replicas\": " << config.replicas
+         << ", \"parity\": " << config.parity << ", \"dedup\": " << config.dedup << ", \"resume\": " << config.resume
+         << ", \"content\": \"" << config.content << "\""
+         << ", \"leechers\": " << leechers.size() << ", \"ttl\": " << config.ttl << ", \"discovery\": \"" << config.discovery << "\""
+         << ", \"transfer_speed\": " << config.transfer_speed << ", \"compression\": \"" << Compression::modeToString(config.compression) << "\""
+         << ", \"pin\": \"" << CpuTopology::pinningToString(config.threading.pinning) << "\", \"io_threads\": " << config.threading.io_threads
+         << ", \"worker_threads\": " << config.threading.worker_threads
+         << ", \"warmup_ms\": " << config.warmup_ms << ", \"stagger_ms\": " << config.stagger_ms << ", \"seed\": " << config.seed << "},\n";
+
+    uint64_t total_messages = std::accumulate(messages_out.begin(), messages_out.end(), uint64_t{0});
+    uint64_t total_bytes = std::accumulate(bytes_sent.begin(), bytes_sent.end(), uint64_t{0});
+    double mean = completed_times.empty() ? 0 : std::accumulate(completed_times.begin(), completed_times.end(), 0.0) / completed_times.size();
+
+    json << "  \"summary\": {\"completed\": " << completed << ", \"failed\": " << failed
+         << ", \"timed_out\": " << leechers.size() - completed - failed << ", \"verified\": " << verified_count
+         << ", \"wall_time_ms\": " << wall_time_ms
+         << ", \"time_to_complete_ms\": {\"min\": " << (completed_times.empty() ? 0 : completed_times.front())
+         << ", \"mean\": " << mean << ", \"p50\": " << percentile(completed_times, 0.5)
+         << ", \"p95\": " << percentile(completed_times, 0.95)
+         << ", \"max\": " << (completed_times.empty() ? 0 : completed_times.back()) << "}"
+         << ", \"messages_total\": " << total_messages << ", \"messages_by_type\": {";
+    for (auto it = messages_by_type.begin(); it != messages_by_type.end(); ++it) {
+        json << (it == messages_by_type.begin() ? "" : ", ") << "\"" << it->first << "\": " << it->second;
+    }
+    json << "}, \"dht_lookups\": {\"found\": " << dht_found << ", \"empty\": " << dht_empty << "}"
+         << ", \"availability_cache\": {\"hit\": " << cache_lookups["hit"] << ", \"partial\": " << cache_lookups["partial"]
+         << ", \"miss\": " << cache_lookups["miss"] << "}"
+         << ", \"have_chunks_requested\": " << have_chunks_requested
+         << ", \"chunks_deduplicated\": " << std::accumulate(chunks_deduplicated.begin(), chunks_deduplicated.end(), uint64_t{0})
+         << ", \"chunks_compressed\": " << std::accumulate(chunks_compressed.begin(), chunks_compressed.end(), uint64_t{0})
+         << ", \"compression_bytes_saved\": " << std::accumulate(compression_bytes_saved.begin(), compression_bytes_saved.end(), uint64_t{0})
+         << ", \"chunks_resumed\": " << std::accumulate(chunks_resumed.begin(), chunks_resumed.end(), uint64_t{0})
+         << ", \"resume_bytes_saved\": " << std::accumulate(resume_bytes_saved.begin(), resume_bytes_saved.end(), uint64_t{0})
+         << ", \"bytes_total\": " << total_bytes << "},\n";
+
+    json << "  \"peers\": [\n";
+    for (int peer = 0; peer < config.peers; ++peer) {
+        const char* role = leecher_set.count(peer) ? "leecher" : (chunks_by_peer[peer].empty() ? "idle" : "seeder");
+
+        json << "    {\"id\": " << peer << ", \"role\": \"" << role << "\", \"degree\": " << topology[peer].size()
+             << ", \"final_degree\": " << peers[peer]->getNeighbors().size()
+             << ", \"initial_chunks\": " << chunks_by_peer[peer].size();
+        if (leecher_set.count(peer)) {
+            json << ", \"state\": \"" << (final_state[peer].empty() ? "TIMEOUT" : final_state[peer]) << "\""
+                 << ", \"time_to_complete_ms\": ";
+            if (final_state[peer] == "COMPLETED") {
+                json << completion_ms[peer];
+            } else {
+                json << "null";
+            }
+            json << ", \"verified\": " << (verified[peer] ? "true" : "false");
+        }
+        json << ", \"messages_in\": " << messages_in[peer] << ", \"messages_out\": " << messages_out[peer]
+             << ", \"bytes_sent\": " << bytes_sent[peer] << ", \"bytes_received\": " << bytes_received[peer]
+             << ", \"chunks_sent\": " << chunks_sent[peer] << ", \"chunks_received\": " << chunks_received[peer]
+             << ", \"chunks_deduplicated\": " << chunks_deduplicated[peer]
+             << ", \"chunks_compressed\": " << chunks_compressed[peer]
+             << ", \"chunks_resumed\": " << chunks_resumed[peer]
+             << "}" << (peer + 1 < config.peers ? "," : "") << "\n";
+    }
+    json << "  ]\n}\n";
+
+    return json.str();
+}
@@ -0,0 +1,141 @@
+#ifndef SIMULATION_H
+#define SIMULATION_H
+
+#include "Compression.h"
+#include "CpuTopology.h"
+#include "Utils.h"
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+
+/**
+ * @brief Lista de adjacência da topologia: cada posição contém os IDs dos vizinhos do peer.
+ */
+using Topology = std::vector<std::vector<int>>;
+
+
+/**
+ * @brief Estrutura com os parâmetros de um cenário de simulação.
+ */
+struct SimulationConfig {
+    int peers = 20;                             ///< Número de peers no processo.
+    std::string topology = "ring";              ///< Topologia: ring, random-regular ou power-law.
+    int degree = 4;                             ///< Grau da topologia (em power-law, o dobro das arestas de cada novo peer).
+    int chunks = 32;                            ///< Número de chunks do arquivo.
+    size_t chunk_size = 16384;                  ///< Tamanho de cada chunk em bytes.
+    std::string distribution = "single";        ///< Distribuição inicial: single, full ou scattered.
+    int seeders = 1;                            ///< Número de peers com o arquivo completo (distribuição full).
+    int replicas = 2;                           ///< Número de cópias de cada chunk (distribuição scattered).
+    int parity = 0;                             ///< Chunks de paridade da codificação de apagamento (0: arquivo sem codificação).
+    std::string content = "pattern";            ///< Conteúdo dos chunks: pattern (sequências de bytes, compressível) ou random (incompressível).
+    int dedup = 0;                              ///< Porcentagem dos chunks que também estão em uma versão anterior do arquivo, mantida inteira pelos peers pares (0: sem versão anterior).
+    int resume = 0;                             ///< Porcentagem de cada chunk faltante que os leechers já têm no arquivo parcial de um download interrompido, registrado no diário (0: download novo).
+    int leechers = -1;                          ///< Número de peers que buscam o arquivo (-1: todos que não o possuem completo).
+    int joiners = 0;                            ///< Últimos peers, fora da topologia inicial, que entram na rede pelo peer 0 como bootstrap.
+    int ttl = 4;                                ///< TTL inicial das mensagens de descoberta.
+    std::string discovery = "flood";            ///< Modo de descoberta gravado no .p2p: flood, dht ou aggregate.
+    int transfer_speed = 65536;                 ///< Tamanho em bytes de cada bloco enviado via TCP.
+    CompressionMode compression = CompressionMode::AUTO;  ///< Política de compressão dos chunks enviados pelos peers.
+    ThreadingConfig threading;                  ///< Afinidade e número de threads de E/S e de processamento de cada peer.
+    TimingConfig timing;                        ///< Tempos de espera do protocolo usados pelos peers simulados.
+    int warmup_ms = 0;                          ///< Espera extra antes de registrar os downloads, para a vizinhança e a DHT se formarem.
+    int stagger_ms = 0;                         ///< Intervalo entre os registros dos downloads de leechers consecutivos (0: todos ao mesmo tempo).
+    int timeout_seconds = 120;                  ///< Tempo máximo de espera pela conclusão dos downloads.
+    uint32_t seed = 1;                          ///< Semente do gerador de números aleatórios.
+};
+
+
+/**
+ * @brief Gera uma topologia em anel, ligando cada peer aos degree/2 peers mais próximos de cada lado.
+ *
+ * @param peers Número de peers.
+ * @param degree Grau desejado.
+ * @return Lista de adjacência.
+ */
+Topology buildRingTopology(int peers, int degree);
+
+
+/**
+ * @brief Gera uma topologia aleatória em que todos os peers têm o mesmo grau.
+ *
+ * Usa o modelo de pareamento: as pontas de aresta são embaralhadas e pareadas, trocando
+ * pontas que formariam laços ou arestas repetidas.
+ *
+ * @param peers Número de peers.
+ * @param degree Grau de cada peer.
+ * @param rng Gerador de números aleatórios.
+ * @return Lista de adjacência.
+ */
+Topology buildRandomRegularTopology(int peers, int degree, std::mt19937& rng);
+
+
+/**
+ * @brief Gera uma topologia com distribuição de graus em lei de potência (Barabási–Albert).
+ *
+ * Cada novo peer se liga a degree/2 peers existentes, escolhidos com probabilidade
+ * proporcional ao grau atual.
+ *
+ * @param peers Número de peers.
+ * @param degree Grau médio desejado.
+ * @param rng Gerador de números aleatórios.
+ * @return Lista de adjacência.
+ */
+Topology buildPowerLawTopology(int peers, int degree, std::mt19937& rng);
+
+
+/**
+ * @brief Verifica se todos os peers da topologia estão conectados.
+ *
+ * @param topology Lista de adjacência.
+ * @return true se a topologia é conexa.
+ */
+bool isConnected(const Topology& topology);
+
+
+/**
+ * @brief Sorteia quais chunks cada peer possui no início da simulação.
+ *
+ * Com codificação de apagamento, os chunks de paridade são distribuídos como os de dados.
+ *
+ * @param config Parâmetros do cenário.
+ * @param rng Gerador de números aleatórios.
+ * @return Para cada peer, a lista dos chunks que ele possui.
+ */
+std::vector<std::vector<int>> buildChunkDistribution(const SimulationConfig& config, std::mt19937& rng);
+
+
+/**
+ * @brief Reserva portas efêmeras livres no loopback.
+ *
+ * Os sockets de reserva ficam abertos até todas as portas serem obtidas, para que o sistema
+ * não devolva a mesma porta duas vezes, e são fechados antes de os peers fazerem o bind.
+ *
+ * @param count Número de portas.
+ * @param socket_type SOCK_DGRAM ou SOCK_STREAM.
+ * @return Portas reservadas.
+ */
+std::vector<int> reserveLoopbackPorts(int count, int socket_type);
+
+
+/**
+ * @brief Executa um cenário completo e retorna o relatório em JSON.
+ *
+ * Cria os diretórios e chunks iniciais, inicia todos os peers no processo, registra o
+ * download do arquivo nos leechers e aguarda a conclusão ou o tempo limite. Com dedup, os
+ * chunks em comum com a versão anterior não são distribuídos: os leechers os obtêm dos chunks
+ * locais da versão anterior ou, pelo nome de conteúdo, dos peers que a possuem. Os joiners
+ * começam sem vizinhos e formam a sua vizinhança a partir do bootstrap. Com resume, os leechers
+ * começam como após um reinício no meio do download: o diário de downloads registra o arquivo e
+ * o início de cada chunk faltante, gravado no arquivo parcial, e os chunks são pedidos a partir
+ * dali; o download é retomado pelo próprio peer ao iniciar. Os peers
+ * continuam em execução ao final, pois suas threads não têm ponto de parada.
+ *
+ * @param config Parâmetros do cenário.
+ * @param work_directory Diretório de trabalho (terminado em '/').
+ * @return Relatório em JSON.
+ */
+std::string runSimulation(const SimulationConfig& config, const std::string& work_directory);
+
+#endif // SIMULATION_H
@@ -0,0 +1,187 @@
+#include "ErasureCoder.h"
+#include "IOEngine.h"
+#include "Simulation.h"
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sys/resource.h>
+#include <unistd.h>
+
+
+namespace {
+    /**
+     * @brief Exibe as opções do simulador.
+     */
+    void printUsage(const char* program) {
+        std::cerr << "Uso: " << program << " [opções]\n"
+                  << "  --peers=N                   número de peers (padrão 20)\n"
+                  << "  --topology=T                ring | random-regular | power-law (padrão ring)\n"
+                  << "  --degree=D                  grau da topologia (padrão 4)\n"
+                  << "  --chunks=C                  chunks do arquivo (padrão 32)\n"
+                  << "  --chunk-size=B              bytes por chunk (padrão 16384)\n"
+                  << "  --distribution=D            single | full | scattered (padrão single)\n"
+                  << "  --seeders=S                 peers com o arquivo completo em full (padrão 1)\n"
+                  << "  --replicas=R                cópias de cada chunk em scattered (padrão 2)\n"
+                  << "  --parity=P                  chunks de paridade da codificação de apagamento (padrão 0)\n"
+                  << "  --content=C                 pattern | random, conteúdo dos chunks, compressível ou não (padrão pattern)\n"
+                  << "  --dedup=P                   porcentagem dos chunks em comum com uma versão anterior mantida pelos peers pares (padrão 0)\n"
+                  << "  --resume=P                  porcentagem de cada chunk faltante já recebida antes de um reinício dos leechers (padrão 0)\n"
+                  << "  --leechers=L                peers que buscam o arquivo (padrão: todos sem o arquivo completo)\n"
+                  << "  --joiners=J                 últimos peers fora da topologia, que entram pelo peer 0 (padrão 0)\n"
+                  << "  --ttl=T                     TTL das descobertas (padrão 4)\n"
+                  << "  --discovery=M               flood | dht | aggregate, modo de descoberta do arquivo (padrão flood)\n"
+                  << "  --speed=B                   bytes por bloco enviado via TCP (padrão 65536)\n"
+                  << "  --block-interval-ms=MS      espera entre blocos TCP (padrão 0)\n"
+                  << "  --discovery-interval-ms=MS  espera entre descobertas para vizinhos (padrão 0)\n"
+                  << "  --response-timeout-ms=MS    prazo das respostas de descoberta (padrão 500)\n"
+                  << "  --tick-ms=MS                intervalo do escalonador de downloads (padrão 20)\n"
+                  << "  --stall-timeout-ms=MS       tempo sem progresso antes de buscar os chunks faltantes (padrão 2000)\n"
+                  << "  --startup-delay-ms=MS       espera pela inicialização dos servidores (padrão 500)\n"
+                  << "  --heartbeat-ms=MS           intervalo entre heartbeats aos vizinhos (padrão 200)\n"
+                  << "  --neighbor-timeout-ms=MS    tempo sem mensagens antes de remover um vizinho (padrão 2000)\n"
+                  << "  --dht-rpc-timeout-ms=MS     prazo das consultas da DHT (padrão 300)\n"
+                  << "  --warmup-ms=MS              espera antes de registrar os downloads, para a DHT publicar os chunks (padrão 0)\n"
+                  << "  --stagger-ms=MS             intervalo entre os registros dos downloads de leechers consecutivos (padrão 0)\n"
+                  << "  --cache-ttl-ms=MS           validade das entradas do cache de disponibilidade (padrão 60000)\n"
+                  << "  --have-interval-ms=MS       intervalo entre os anúncios HAVE dos chunks recebidos (padrão 100)\n"
+                  << "  --io=E                      auto | blocking | uring, E/S dos chunks (padrão blocking)\n"
+                  << "  --compression=M             off | auto | lz4 | zstd, compressão dos chunks enviados (padrão auto)\n"
+                  << "  --pin=A                     off | cores | numa, afinidade das threads de cada peer (padrão off)\n"
+                  << "  --io-threads=N              conexões TCP recebidas ao mesmo tempo em cada peer (padrão 8)\n"
+                  << "  --worker-threads=N          threads do executor de cada peer além dos recebimentos e envios (padrão 4)\n"
+                  << "  --timeout=S                 tempo máximo da simulação em segundos (padrão 120)\n"
+                  << "  --seed=N                    semente aleatória (padrão 1)\n"
+                  << "  --output=PATH               arquivo do relatório JSON (padrão: saída padrão)\n";
+    }
+}
+
+
+int main(int argc, char* argv[]) {
+    SimulationConfig config;
+    std::string output_path;
+
+    // Tempos reduzidos: os peers compartilham o processo e não precisam das esperas dos terminais separados
+    config.timing.server_startup_delay = std::chrono::milliseconds(500);
+    config.timing.discovery_message_interval = std::chrono::milliseconds(0);
+    config.timing.response_timeout = std::chrono::milliseconds(500);
+    config.timing.transfer_block_interval = std::chrono::milliseconds(0);
+    config.timing.scheduler_tick = std::chrono::milliseconds(20);
+    config.timing.download_stall_timeout = std::chrono::milliseconds(2000);
+    config.timing.heartbeat_interval = std::chrono::milliseconds(200);
+    config.timing.neighbor_timeout = std::chrono::milliseconds(2000);
+    config.timing.dht_publish_interval = std::chrono::milliseconds(200);
+    config.timing.dht_republish_interval = std::chrono::milliseconds(5000);
+    config.timing.dht_record_ttl = std::chrono::milliseconds(15000);
+    config.timing.dht_rpc_timeout = std::chrono::milliseconds(300);
+    config.timing.have_interval = std::chrono::milliseconds(100);
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        size_t equals = arg.find('=');
+        std::string key = arg.substr(0, equals);
+        std::string value = equals == std::string::npos ? "" : arg.substr(equals + 1);
+
+        if (key == "--peers") config.peers = std::stoi(value);
+        else if (key == "--topology") config.topology = value;
+        else if (key == "--degree") config.degree = std::stoi(value);
+        else if (key == "--chunks") config.chunks = std::stoi(value);
+        else if (key == "--chunk-size") config.chunk_size = std::stoul(value);
+        else if (key == "--distribution") config.distribution = value;
+        else if (key == "--seeders") config.seeders = std::stoi(value);
+        else if (key == "--replicas") config.replicas = std::stoi(value);
+        else if (key == "--parity") config.parity = std::stoi(value);
+        else if (key == "--content") config.content = value;
+        else if (key == "--dedup") config.dedup = std::stoi(value);
+        else if (key == "--resume") config.resume = std::stoi(value);
+        else if (key == "--leechers") config.leechers = std::stoi(value);
+        else if (key == "--joiners") config.joiners = std::stoi(value);
+        else if (key == "--ttl") config.ttl = std::stoi(value);
+        else if (key == "--discovery") config.discovery = value;
+        else if (key == "--speed") config.transfer_speed = std::stoi(value);
+        else if (key == "--block-interval-ms") config.timing.transfer_block_interval = std::chrono::milliseconds(std::stoi(value));
+        else if (key == "--discovery-interval-ms") config.timing.discovery_message_interval = std::chrono::milliseconds(std::stoi(value));
+        else if (key == "--response-timeout-ms") config.timing.response_timeout = std::chrono::milliseconds(std::stoi(value));
+        else if (key == "--tick-ms") config.timing.scheduler_tick = std::chrono::milliseconds(std::stoi(value));
+        else if (key == "--stall-timeout-ms") config.timing.download_stall_timeout = std::chrono::milliseconds(std::stoi(value));
+        else if (key == "--startup-delay-ms") config.timing.server_startup_delay = std::chrono::milliseconds(std::stoi(value));
+        else if (key == "--heartbeat-ms") config.timing.heartbeat_interval = std::chrono::milliseconds(std::stoi(value));
+        else if (key == "--neighbor-timeout-ms") config.timing.neighbor_timeout = std::chrono::milliseconds(std::stoi(value));
+        else if (key == "--dht-rpc-timeout-ms") config.timing.dht_rpc_timeout = std::chrono::milliseconds(std::stoi(value));
+        else if (key == "--warmup-ms") config.warmup_ms = std::stoi(value);
+        else if (key == "--stagger-ms") config.stagger_ms = std::stoi(value);
+        else if (key == "--cache-ttl-ms") config.timing.availability_cache_ttl = std::chrono::milliseconds(std::stoi(value));
+        else if (key == "--have-interval-ms") config.timing.have_interval = std::chrono::milliseconds(std::stoi(value));
+        else if (key == "--io") {
+            IOBackend backend;
+            if (!IOEngine::parseBackend(value, backend)) {
+                printUsage(argv[0]);
+                return 1;
+            }
+            IOEngine::setDefaultBackend(backend);
+        }
+        else if (key == "--compression") {
+            if (!Compression::parseMode(value, config.compression)) {
+                printUsage(argv[0]);
+                return 1;
+            }
+        }
+        else if (key == "--pin") {
+            if (!CpuTopology::parsePinning(value, config.threading.pinning)) {
+                printUsage(argv[0]);
+                return 1;
+            }
+        }
+        else if (key == "--io-threads") config.threading.io_threads = std::stoi(value);
+        else if (key == "--worker-threads") config.threading.worker_threads = std::stoi(value);
+        else if (key == "--timeout") config.timeout_seconds = std::stoi(value);
+        else if (key == "--seed") config.seed = static_cast<uint32_t>(std::stoul(value));
+        else if (key == "--output") output_path = value;
+        else {
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+
+    if (config.peers < 2 || config.chunks < 1 || config.chunk_size < 1 || config.joiners < 0 || config.peers - config.joiners < 2 || config.stagger_ms < 0 ||
+        config.parity < 0 || (config.parity > 0 && !ErasureCoder::isValid(config.chunks, config.chunks + config.parity)) ||
+        config.dedup < 0 || config.dedup > 100 || (config.dedup > 0 && config.parity > 0) || config.resume < 0 || config.resume >= 100 ||
+        config.threading.io_threads < 1 || config.threading.worker_threads < 1 ||
+        (config.content != "pattern" && config.content != "random") ||
+        (config.discovery != "flood" && config.discovery != "dht" && config.discovery != "aggregate")) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    // As mensagens RESPONSE listam todos os chunks em um datagrama de CONTROL_MESSAGE_MAX_SIZE bytes
+    if (config.chunks > 200) {
+        std::cerr << "Aviso: com mais de 200 chunks as mensagens RESPONSE podem exceder "
+                  << Constants::CONTROL_MESSAGE_MAX_SIZE << " bytes e ser truncadas.\n";
+    }
+
+    // Centenas de peers abrem mais descritores que o limite padrão
+    struct rlimit limit;
+    if (getrlimit(RLIMIT_NOFILE, &limit) == 0) {
+        limit.rlim_cur = limit.rlim_max;
+        setrlimit(RLIMIT_NOFILE, &limit);
+    }
+
+    // Só erros são exibidos, para que o log não interfira nas medições
+    Logger::instance().setLevel(LogLevel::ERROR);
+
+    std::string work_directory = (std::filesystem::temp_directory_path() / ("p2p-sim-" + std::to_string(getpid()))).string() + "/";
+    std::string report = runSimulation(config, work_directory);
+    std::filesystem::remove_all(work_directory);
+
+    if (output_path.empty()) {
+        std::cout << report;
+    } else {
+        std::ofstream output(output_path);
+        output << report;
+        std::cerr << "Resultados gravados em " << output_path << "\n";
+    }
+
+    // Os peers seguem em execução em threads destacadas; o processo termina sem destruí-los
+    Logger::instance().flush();
+    std::cout.flush();
+    std::_Exit(EXIT_SUCCESS);
+}